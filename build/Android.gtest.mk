@@ -24,16 +24,20 @@ include art/build/Android.common_path.mk
 GTEST_DEX_DIRECTORIES := \
   AbstractMethod \
   AllFields \
+  AsmInterpreter \
   ExceptionHandle \
   GetMethodSignature \
   Interfaces \
   Main \
+  MethodInlining \
   MyClass \
   MyClassNatives \
   Nested \
   NonStaticLeafMethods \
   ProtoCompare \
   ProtoCompare2 \
+  ReusedOat \
+  ReusedOat2 \
   StaticLeafMethods \
   Statics \
   StaticsFromCode \
@@ -47,11 +51,14 @@ $(foreach dir,$(GTEST_DEX_DIRECTORIES), $(eval $(call build-art-test-dex,art-gte
 
 # Dex file dependencies for each gtest.
 ART_GTEST_class_linker_test_DEX_DEPS := Interfaces MyClass Nested Statics StaticsFromCode
-ART_GTEST_compiler_driver_test_DEX_DEPS := AbstractMethod
+ART_GTEST_compiler_driver_test_DEX_DEPS := AbstractMethod Interfaces StaticsFromCode
 ART_GTEST_dex_file_test_DEX_DEPS := GetMethodSignature
 ART_GTEST_exception_test_DEX_DEPS := ExceptionHandle
+ART_GTEST_interpreter_asm_test_DEX_DEPS := AsmInterpreter
 ART_GTEST_jni_compiler_test_DEX_DEPS := MyClassNatives
 ART_GTEST_jni_internal_test_DEX_DEPS := AllFields StaticLeafMethods
+ART_GTEST_mir_optimization_test_DEX_DEPS := MethodInlining
+ART_GTEST_oat_test_DEX_DEPS := ReusedOat ReusedOat2
 ART_GTEST_object_test_DEX_DEPS := ProtoCompare ProtoCompare2 StaticsFromCode XandY
 ART_GTEST_proxy_test_DEX_DEPS := Interfaces
 ART_GTEST_reflection_test_DEX_DEPS := Main NonStaticLeafMethods StaticLeafMethods
@@ -82,7 +89,9 @@ RUNTIME_GTEST_COMMON_SRC_FILES := \
   runtime/base/unix_file/null_file_test.cc \
   runtime/base/unix_file/random_access_file_utils_test.cc \
   runtime/base/unix_file/string_file_test.cc \
+  runtime/binary_profile_test.cc \
   runtime/class_linker_test.cc \
+  runtime/class_table_test.cc \
   runtime/dex_file_test.cc \
   runtime/dex_file_verifier_test.cc \
   runtime/dex_instruction_visitor_test.cc \
@@ -92,6 +101,9 @@ RUNTIME_GTEST_COMMON_SRC_FILES := \
   runtime/entrypoints_order_test.cc \
   runtime/exception_test.cc \
   runtime/gc/accounting/space_bitmap_test.cc \
+  runtime/gc/accounting/work_stealing_deque_test.cc \
+  runtime/gc/collector/concurrent_copying_test.cc \
+  runtime/gc/collector/semi_space_test.cc \
   runtime/gc/heap_test.cc \
   runtime/gc/space/dlmalloc_space_base_test.cc \
   runtime/gc/space/dlmalloc_space_static_test.cc \
@@ -100,12 +112,18 @@ RUNTIME_GTEST_COMMON_SRC_FILES := \
   runtime/gc/space/rosalloc_space_static_test.cc \
   runtime/gc/space/rosalloc_space_random_test.cc \
   runtime/gc/space/large_object_space_test.cc \
+  runtime/gc/space/region_space_test.cc \
   runtime/gtest_test.cc \
   runtime/handle_scope_test.cc \
+  runtime/hprof/hprof_test.cc \
   runtime/indenter_test.cc \
   runtime/indirect_reference_table_test.cc \
   runtime/instruction_set_test.cc \
   runtime/intern_table_test.cc \
+  runtime/interpreter/inline_cache_test.cc \
+  runtime/interpreter/interpreter_asm_test.cc \
+  runtime/jit/jit_code_cache_test.cc \
+  runtime/jit/jit_test.cc \
   runtime/leb128_test.cc \
   runtime/mem_map_test.cc \
   runtime/mirror/dex_cache_test.cc \
@@ -114,6 +132,7 @@ RUNTIME_GTEST_COMMON_SRC_FILES := \
   runtime/monitor_test.cc \
   runtime/parsed_options_test.cc \
   runtime/reference_table_test.cc \
+  runtime/root_hash_table_test.cc \
   runtime/thread_pool_test.cc \
   runtime/transaction_test.cc \
   runtime/utils_test.cc \
@@ -135,9 +154,13 @@ COMPILER_GTEST_COMMON_SRC_FILES := \
   compiler/jni/jni_compiler_test.cc \
   compiler/oat_test.cc \
   compiler/optimizing/codegen_test.cc \
+  compiler/optimizing/constant_folding_test.cc \
+  compiler/optimizing/dead_code_elimination_test.cc \
   compiler/optimizing/dominator_test.cc \
   compiler/optimizing/find_loops_test.cc \
   compiler/optimizing/graph_test.cc \
+  compiler/optimizing/gvn_test.cc \
+  compiler/optimizing/inliner_test.cc \
   compiler/optimizing/linearize_test.cc \
   compiler/optimizing/liveness_test.cc \
   compiler/optimizing/live_interval_test.cc \
@@ -492,6 +515,7 @@ ART_GTEST_elf_writer_test_HOST_DEPS :=
 ART_GTEST_elf_writer_test_TARGET_DEPS :=
 ART_GTEST_jni_compiler_test_DEX_DEPS :=
 ART_GTEST_jni_internal_test_DEX_DEPS :=
+ART_GTEST_oat_test_DEX_DEPS :=
 ART_GTEST_object_test_DEX_DEPS :=
 ART_GTEST_proxy_test_DEX_DEPS :=
 ART_GTEST_reflection_test_DEX_DEPS :=
@@ -131,6 +131,12 @@ static InstructionSetFeatures ParseFeatureList(std::string str) {
     } else if (feature == "nodiv") {
       // Turn off support for divide instruction.
       result.SetHasDivideInstruction(false);
+    } else if (feature == "sse4.1") {
+      // Supports SSE4.1 (x86 and x86-64 only).
+      result.SetHasSse4_1(true);
+    } else if (feature == "nosse4.1") {
+      // Turn off support for SSE4.1.
+      result.SetHasSse4_1(false);
     } else {
       LOG(FATAL) << "Unknown instruction set feature: '" << feature << "'";
     }
@@ -172,15 +178,15 @@ void CommonCompilerTest::MakeExecutable(mirror::ArtMethod* method) {
                                                             method->GetDexMethodIndex()));
   }
   if (compiled_method != nullptr) {
-    const std::vector<uint8_t>* code = compiled_method->GetQuickCode();
+    ArrayRef<const uint8_t> code = compiled_method->GetQuickCode();
     const void* code_ptr;
-    if (code != nullptr) {
-      uint32_t code_size = code->size();
+    if (!code.empty()) {
+      uint32_t code_size = code.size();
       CHECK_NE(0u, code_size);
-      const std::vector<uint8_t>& vmap_table = compiled_method->GetVmapTable();
+      ArrayRef<const uint8_t> vmap_table = compiled_method->GetVmapTable();
       uint32_t vmap_table_offset = vmap_table.empty() ? 0u
           : sizeof(OatQuickMethodHeader) + vmap_table.size();
-      const std::vector<uint8_t>& mapping_table = compiled_method->GetMappingTable();
+      ArrayRef<const uint8_t> mapping_table = compiled_method->GetMappingTable();
       uint32_t mapping_table_offset = mapping_table.empty() ? 0u
           : sizeof(OatQuickMethodHeader) + vmap_table.size() + mapping_table.size();
       OatQuickMethodHeader method_header(mapping_table_offset, vmap_table_offset,
@@ -199,14 +205,14 @@ void CommonCompilerTest::MakeExecutable(mirror::ArtMethod* method) {
       chunk->insert(chunk->begin(), vmap_table.begin(), vmap_table.end());
       chunk->insert(chunk->begin(), mapping_table.begin(), mapping_table.end());
       chunk->insert(chunk->begin(), padding, 0);
-      chunk->insert(chunk->end(), code->begin(), code->end());
+      chunk->insert(chunk->end(), code.begin(), code.end());
       CHECK_EQ(padding + size, chunk->size());
       code_ptr = &(*chunk)[code_offset];
     } else {
       code = compiled_method->GetPortableCode();
-      code_ptr = &(*code)[0];
+      code_ptr = code.data();
     }
-    MakeExecutable(code_ptr, code->size());
+    MakeExecutable(code_ptr, code.size());
     const void* method_code = CompiledMethod::CodePointer(code_ptr,
                                                           compiled_method->GetInstructionSet());
     LOG(INFO) << "MakeExecutable " << PrettyMethod(method) << " code=" << method_code;
@@ -21,15 +21,14 @@ namespace art {
 
 CompiledCode::CompiledCode(CompilerDriver* compiler_driver, InstructionSet instruction_set,
                            const std::vector<uint8_t>& quick_code)
-    : compiler_driver_(compiler_driver), instruction_set_(instruction_set),
-      portable_code_(nullptr), quick_code_(nullptr) {
+    : compiler_driver_(compiler_driver), instruction_set_(instruction_set) {
   SetCode(&quick_code, nullptr);
 }
 
 CompiledCode::CompiledCode(CompilerDriver* compiler_driver, InstructionSet instruction_set,
                            const std::string& elf_object, const std::string& symbol)
     : compiler_driver_(compiler_driver), instruction_set_(instruction_set),
-      portable_code_(nullptr), quick_code_(nullptr), symbol_(symbol) {
+      symbol_(symbol) {
   CHECK_NE(elf_object.size(), 0U);
   CHECK_NE(symbol.size(), 0U);
   std::vector<uint8_t> temp_code(elf_object.size());
@@ -56,25 +55,25 @@ void CompiledCode::SetCode(const std::vector<uint8_t>* quick_code,
 }
 
 bool CompiledCode::operator==(const CompiledCode& rhs) const {
-  if (quick_code_ != nullptr) {
-    if (rhs.quick_code_ == nullptr) {
+  if (!quick_code_.empty()) {
+    if (rhs.quick_code_.empty()) {
       return false;
-    } else if (quick_code_->size() != rhs.quick_code_->size()) {
+    } else if (quick_code_.size() != rhs.quick_code_.size()) {
       return false;
     } else {
-      return std::equal(quick_code_->begin(), quick_code_->end(), rhs.quick_code_->begin());
+      return std::equal(quick_code_.begin(), quick_code_.end(), rhs.quick_code_.begin());
     }
-  } else if (portable_code_ != nullptr) {
-    if (rhs.portable_code_ == nullptr) {
+  } else if (!portable_code_.empty()) {
+    if (rhs.portable_code_.empty()) {
       return false;
-    } else if (portable_code_->size() != rhs.portable_code_->size()) {
+    } else if (portable_code_.size() != rhs.portable_code_.size()) {
       return false;
     } else {
-      return std::equal(portable_code_->begin(), portable_code_->end(),
-                        rhs.portable_code_->begin());
+      return std::equal(portable_code_.begin(), portable_code_.end(),
+                        rhs.portable_code_.begin());
     }
   }
-  return (rhs.quick_code_ == nullptr) && (rhs.portable_code_ == nullptr);
+  return rhs.quick_code_.empty() && rhs.portable_code_.empty();
 }
 
 uint32_t CompiledCode::AlignCode(uint32_t offset) const {
@@ -172,7 +171,7 @@ CompiledMethod::CompiledMethod(CompilerDriver* driver,
       mapping_table_(driver->DeduplicateMappingTable(std::vector<uint8_t>())),
       vmap_table_(driver->DeduplicateVMapTable(std::vector<uint8_t>())),
       gc_map_(driver->DeduplicateGCMap(std::vector<uint8_t>())),
-      cfi_info_(nullptr) {
+      cfi_info_() {
 }
 
 // Constructs a CompiledMethod for the Portable compiler.
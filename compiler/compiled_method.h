@@ -23,6 +23,7 @@
 
 #include "instruction_set.h"
 #include "utils.h"
+#include "utils/array_ref.h"
 
 namespace llvm {
   class Function;
@@ -46,11 +47,13 @@ class CompiledCode {
     return instruction_set_;
   }
 
-  const std::vector<uint8_t>* GetPortableCode() const {
+  // Empty unless compiled by the portable backend.
+  ArrayRef<const uint8_t> GetPortableCode() const {
     return portable_code_;
   }
 
-  const std::vector<uint8_t>* GetQuickCode() const {
+  // Empty unless compiled by a quick backend.
+  ArrayRef<const uint8_t> GetQuickCode() const {
     return quick_code_;
   }
 
@@ -84,11 +87,11 @@ class CompiledCode {
 
   const InstructionSet instruction_set_;
 
-  // The ELF image for portable.
-  std::vector<uint8_t>* portable_code_;
+  // The ELF image for portable, owned by the CompilerDriver.
+  ArrayRef<const uint8_t> portable_code_;
 
-  // Used to store the PIC code for Quick.
-  std::vector<uint8_t>* quick_code_;
+  // Used to store the PIC code for Quick, owned by the CompilerDriver.
+  ArrayRef<const uint8_t> quick_code_;
 
   // Used for the Portable ELF symbol name.
   const std::string symbol_;
@@ -144,22 +147,24 @@ class CompiledMethod : public CompiledCode {
     return fp_spill_mask_;
   }
 
-  const std::vector<uint8_t>& GetMappingTable() const {
-    DCHECK(mapping_table_ != nullptr);
-    return *mapping_table_;
+  // The tables are deduplicated, equal tables share the same data() pointer.
+  ArrayRef<const uint8_t> GetMappingTable() const {
+    DCHECK(mapping_table_.data() != nullptr);
+    return mapping_table_;
   }
 
-  const std::vector<uint8_t>& GetVmapTable() const {
-    DCHECK(vmap_table_ != nullptr);
-    return *vmap_table_;
+  ArrayRef<const uint8_t> GetVmapTable() const {
+    DCHECK(vmap_table_.data() != nullptr);
+    return vmap_table_;
   }
 
-  const std::vector<uint8_t>& GetGcMap() const {
-    DCHECK(gc_map_ != nullptr);
-    return *gc_map_;
+  ArrayRef<const uint8_t> GetGcMap() const {
+    DCHECK(gc_map_.data() != nullptr);
+    return gc_map_;
   }
 
-  const std::vector<uint8_t>* GetCFIInfo() const {
+  // Empty if there is no call frame information.
+  ArrayRef<const uint8_t> GetCFIInfo() const {
     return cfi_info_;
   }
 
@@ -172,14 +177,14 @@ class CompiledMethod : public CompiledCode {
   const uint32_t fp_spill_mask_;
   // For quick code, a uleb128 encoded map from native PC offset to dex PC aswell as dex PC to
   // native PC offset. Size prefixed.
-  std::vector<uint8_t>* mapping_table_;
+  ArrayRef<const uint8_t> mapping_table_;
   // For quick code, a uleb128 encoded map from GPR/FPR register to dex register. Size prefixed.
-  std::vector<uint8_t>* vmap_table_;
+  ArrayRef<const uint8_t> vmap_table_;
   // For quick code, a map keyed by native PC indices to bitmaps describing what dalvik registers
   // are live. For portable code, the key is a dalvik PC.
-  std::vector<uint8_t>* gc_map_;
+  ArrayRef<const uint8_t> gc_map_;
   // For quick code, a FDE entry for the debug_frame section.
-  std::vector<uint8_t>* cfi_info_;
+  ArrayRef<const uint8_t> cfi_info_;
 };
 
 }  // namespace art
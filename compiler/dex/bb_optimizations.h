@@ -115,6 +115,30 @@ class SpecialMethodInliner : public PassME {
   }
 };
 
+/**
+ * @class MethodInliner
+ * @brief Splice the code of small static, private and final callees into the caller.
+ */
+class MethodInliner : public PassME {
+ public:
+  MethodInliner() : PassME("MethodInliner", kNoNodes, "1_post_inlining_cfg") {
+  }
+
+  bool Gate(const PassDataHolder* data) const OVERRIDE {
+    DCHECK(data != nullptr);
+    CompilationUnit* cUnit = down_cast<const PassMEDataHolder*>(data)->c_unit;
+    DCHECK(cUnit != nullptr);
+    return cUnit->mir_graph->InlineCallsGate();
+  }
+
+  void Start(PassDataHolder* data) const OVERRIDE {
+    DCHECK(data != nullptr);
+    CompilationUnit* cUnit = down_cast<PassMEDataHolder*>(data)->c_unit;
+    DCHECK(cUnit != nullptr);
+    cUnit->mir_graph->InlineCalls();
+  }
+};
+
 /**
  * @class CodeLayout
  * @brief Perform the code layout pass.
@@ -235,6 +259,78 @@ class GlobalValueNumberingPass : public PassME {
   }
 };
 
+/**
+ * @class RangeCheckElimination
+ * @brief Remove array range checks on induction variables bounded by the array length.
+ */
+class RangeCheckElimination : public PassME {
+ public:
+  RangeCheckElimination() : PassME("RangeCheckElimination", kNoNodes) {
+  }
+
+  bool Gate(const PassDataHolder* data) const OVERRIDE {
+    DCHECK(data != nullptr);
+    CompilationUnit* cUnit = down_cast<const PassMEDataHolder*>(data)->c_unit;
+    DCHECK(cUnit != nullptr);
+    return cUnit->mir_graph->EliminateRangeChecksGate();
+  }
+
+  void Start(PassDataHolder* data) const OVERRIDE {
+    DCHECK(data != nullptr);
+    CompilationUnit* cUnit = down_cast<PassMEDataHolder*>(data)->c_unit;
+    DCHECK(cUnit != nullptr);
+    cUnit->mir_graph->EliminateRangeChecks();
+  }
+};
+
+/**
+ * @class LoopInvariantCodeMotion
+ * @brief Hoist loop invariant array-length and final field loads into loop pre-headers.
+ */
+class LoopInvariantCodeMotion : public PassME {
+ public:
+  LoopInvariantCodeMotion() : PassME("LICM", kNoNodes, "4_post_licm_cfg") {
+  }
+
+  bool Gate(const PassDataHolder* data) const OVERRIDE {
+    DCHECK(data != nullptr);
+    CompilationUnit* cUnit = down_cast<const PassMEDataHolder*>(data)->c_unit;
+    DCHECK(cUnit != nullptr);
+    return cUnit->mir_graph->HoistLoopInvariantsGate();
+  }
+
+  void Start(PassDataHolder* data) const OVERRIDE {
+    DCHECK(data != nullptr);
+    CompilationUnit* cUnit = down_cast<PassMEDataHolder*>(data)->c_unit;
+    DCHECK(cUnit != nullptr);
+    cUnit->mir_graph->HoistLoopInvariants();
+  }
+};
+
+/**
+ * @class LoopVectorization
+ * @brief Rewrite simple counted array loops to use the packed vector extended MIRs.
+ */
+class LoopVectorization : public PassME {
+ public:
+  LoopVectorization() : PassME("LoopVectorization", kNoNodes, "4_post_vectorization_cfg") {
+  }
+
+  bool Gate(const PassDataHolder* data) const OVERRIDE {
+    DCHECK(data != nullptr);
+    CompilationUnit* cUnit = down_cast<const PassMEDataHolder*>(data)->c_unit;
+    DCHECK(cUnit != nullptr);
+    return cUnit->mir_graph->VectorizeLoopsGate();
+  }
+
+  void Start(PassDataHolder* data) const OVERRIDE {
+    DCHECK(data != nullptr);
+    CompilationUnit* cUnit = down_cast<PassMEDataHolder*>(data)->c_unit;
+    DCHECK(cUnit != nullptr);
+    cUnit->mir_graph->VectorizeLoops();
+  }
+};
+
 /**
  * @class BBCombine
  * @brief Perform the basic block combination pass.
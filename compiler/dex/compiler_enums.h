@@ -228,6 +228,22 @@ enum ExtendedMIROpcode {
   // @note: All currently reserved vector registers are returned to the temporary pool.
   kMirOpReturnVectorRegisters,
 
+  // @brief Load a 128-bit vector from consecutive array elements starting at an index.
+  // vA: destination vector register
+  // vB: array VR (not vector register)
+  // vC: index VR (not vector register)
+  // arg[0]: TypeSize
+  // @note: No null or range checks are performed; the caller must have proven them redundant.
+  kMirOpPackedArrayGet,
+
+  // @brief Store a 128-bit vector into consecutive array elements starting at an index.
+  // vA: source vector register
+  // vB: array VR (not vector register)
+  // vC: index VR (not vector register)
+  // arg[0]: TypeSize
+  // @note: No null or range checks are performed; the caller must have proven them redundant.
+  kMirOpPackedArrayPut,
+
   kMirOpLast,
 };
 
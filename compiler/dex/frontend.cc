@@ -56,6 +56,10 @@ static uint32_t kCompilerOptimizerDisableFlags = 0 |  // Disable specific optimi
   // (1 << kPromoteCompilerTemps) |
   // (1 << kSuppressExceptionEdges) |
   // (1 << kSuppressMethodInlining) |
+  // (1 << kLoopVectorization) |
+  // (1 << kRangeCheckElimination) |
+  // (1 << kLoopInvariantCodeMotion) |
+  // (1 << kGeneralMethodInlining) |
   0;
 
 static uint32_t kCompilerDebugFlags = 0 |     // Enable debug/testing modes
@@ -730,7 +734,7 @@ static CompiledMethod* CompileMethod(CompilerDriver& driver,
   /* For non-leaf methods check if we should skip compilation when the profiler is enabled. */
   if (cu.compiler_driver->ProfilePresent()
       && !cu.mir_graph->MethodIsLeaf()
-      && cu.mir_graph->SkipCompilationByName(method_name)) {
+      && cu.mir_graph->SkipCompilationByProfile()) {
     return nullptr;
   }
 
@@ -744,6 +748,7 @@ static CompiledMethod* CompileMethod(CompilerDriver& driver,
 
   /* Reassociate sreg names with original Dalvik vreg names. */
   cu.mir_graph->RemapRegLocations();
+  cu.mir_graph->MapInlinedVRegsToCompilerTemps();
 
   /* Free Arenas from the cu.arena_stack for reuse by the cu.arena in the codegen. */
   if (cu.enable_debug & (1 << kDebugShowMemoryUsage)) {
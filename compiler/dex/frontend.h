@@ -55,6 +55,10 @@ enum opt_control_vector {
   kBranchFusing,
   kSuppressExceptionEdges,
   kSuppressMethodInlining,
+  kLoopVectorization,
+  kRangeCheckElimination,
+  kLoopInvariantCodeMotion,
+  kGeneralMethodInlining,
 };
 
 // Force code generation paths for testing.
@@ -1296,8 +1296,8 @@ void MIRGraph::DoCacheMethodLoweringInfo() {
                                  method_lowering_infos_.GetRawStorage(), count);
 }
 
-bool MIRGraph::SkipCompilationByName(const std::string& methodname) {
-  return cu_->compiler_driver->SkipCompilation(methodname);
+bool MIRGraph::SkipCompilationByProfile() {
+  return cu_->compiler_driver->SkipCompilation(MethodReference(cu_->dex_file, cu_->method_idx));
 }
 
 }  // namespace art
@@ -842,7 +842,7 @@ const uint64_t MIRGraph::oat_data_flow_attributes_[kMirOpLast] = {
   DF_DA | DF_UB,
 
   // 114 MirOpConstVector
-  DF_DA,
+  0,
 
   // 115 MirOpMoveVector
   0,
@@ -875,7 +875,7 @@ const uint64_t MIRGraph::oat_data_flow_attributes_[kMirOpLast] = {
   0,
 
   // 125 MirOpPackedAddReduce
-  DF_DA | DF_UA,
+  DF_DA | DF_UA | DF_CORE_A,
 
   // 126 MirOpPackedReduce
   DF_DA,
@@ -888,6 +888,12 @@ const uint64_t MIRGraph::oat_data_flow_attributes_[kMirOpLast] = {
 
   // 129 MirOpReturnVectorRegisters
   0,
+
+  // 130 MirOpPackedArrayGet
+  DF_UB | DF_UC | DF_REF_B | DF_CORE_C,
+
+  // 131 MirOpPackedArrayPut
+  DF_UB | DF_UC | DF_REF_B | DF_CORE_C,
 };
 
 /* Return the base virtual register for a SSA name */
@@ -929,12 +935,13 @@ bool MIRGraph::FindLocalLiveIn(BasicBlock* bb) {
 
   if (bb->data_flow_info == NULL) return false;
 
+  int num_vregs = GetNumOfCodeAndInlinedVRs();
   use_v = bb->data_flow_info->use_v =
-      new (arena_) ArenaBitVector(arena_, cu_->num_dalvik_registers, false, kBitMapUse);
+      new (arena_) ArenaBitVector(arena_, num_vregs, false, kBitMapUse);
   def_v = bb->data_flow_info->def_v =
-      new (arena_) ArenaBitVector(arena_, cu_->num_dalvik_registers, false, kBitMapDef);
+      new (arena_) ArenaBitVector(arena_, num_vregs, false, kBitMapDef);
   live_in_v = bb->data_flow_info->live_in_v =
-      new (arena_) ArenaBitVector(arena_, cu_->num_dalvik_registers, false, kBitMapLiveIn);
+      new (arena_) ArenaBitVector(arena_, num_vregs, false, kBitMapLiveIn);
 
   for (mir = bb->first_mir_insn; mir != NULL; mir = mir->next) {
     uint64_t df_attributes = GetDataFlowAttributes(mir);
@@ -1002,13 +1009,13 @@ int MIRGraph::AddNewSReg(int v_reg) {
 
 /* Find out the latest SSA register for a given Dalvik register */
 void MIRGraph::HandleSSAUse(int* uses, int dalvik_reg, int reg_index) {
-  DCHECK((dalvik_reg >= 0) && (dalvik_reg < cu_->num_dalvik_registers));
+  DCHECK((dalvik_reg >= 0) && (dalvik_reg < GetNumOfCodeAndInlinedVRs()));
   uses[reg_index] = vreg_to_ssa_map_[dalvik_reg];
 }
 
 /* Setup a new SSA register for a given Dalvik register */
 void MIRGraph::HandleSSADef(int* defs, int dalvik_reg, int reg_index) {
-  DCHECK((dalvik_reg >= 0) && (dalvik_reg < cu_->num_dalvik_registers));
+  DCHECK((dalvik_reg >= 0) && (dalvik_reg < GetNumOfCodeAndInlinedVRs()));
   int ssa_reg = AddNewSReg(dalvik_reg);
   vreg_to_ssa_map_[dalvik_reg] = ssa_reg;
   defs[reg_index] = ssa_reg;
@@ -1188,17 +1195,17 @@ bool MIRGraph::DoSSAConversion(BasicBlock* bb) {
    * predecessor blocks.
    */
   bb->data_flow_info->vreg_to_ssa_map_exit =
-      static_cast<int*>(arena_->Alloc(sizeof(int) * cu_->num_dalvik_registers,
+      static_cast<int*>(arena_->Alloc(sizeof(int) * GetNumOfCodeAndInlinedVRs(),
                                       kArenaAllocDFInfo));
 
   memcpy(bb->data_flow_info->vreg_to_ssa_map_exit, vreg_to_ssa_map_,
-         sizeof(int) * cu_->num_dalvik_registers);
+         sizeof(int) * GetNumOfCodeAndInlinedVRs());
   return true;
 }
 
 /* Setup the basic data structures for SSA conversion */
 void MIRGraph::CompilerInitializeSSAConversion() {
-  size_t num_dalvik_reg = cu_->num_dalvik_registers;
+  size_t num_dalvik_reg = GetNumOfCodeAndInlinedVRs();
 
   ssa_base_vregs_ = new (arena_) GrowableArray<int>(arena_, num_dalvik_reg + GetDefCount() + 128,
                                                     kGrowableArraySSAtoDalvikMap);
@@ -1237,6 +1244,10 @@ void MIRGraph::CompilerInitializeSSAConversion() {
     ssa_last_defs_[i] = 0;
   }
 
+  // Temporaries from a previous SSA conversion refer to stale SSA names, start over.
+  compiler_temps_.Reset();
+  num_non_special_compiler_temps_ = 0u;
+
   // Create a compiler temporary for Method*. This is done after SSA initialization.
   GetNewCompilerTemp(kCompilerTempSpecialMethodPtr, false);
 
@@ -68,7 +68,8 @@ void MirIFieldLoweringInfo::Resolve(CompilerDriver* compiler_driver,
     it->flags_ = 0u |  // Without kFlagIsStatic.
         (is_volatile ? kFlagIsVolatile : 0u) |
         (fast_path.first ? kFlagFastGet : 0u) |
-        (fast_path.second ? kFlagFastPut : 0u);
+        (fast_path.second ? kFlagFastPut : 0u) |
+        (resolved_field->IsFinal() ? kFlagIsFinal : 0u);
   }
 }
 
@@ -120,6 +120,10 @@ class MirIFieldLoweringInfo : public MirFieldInfo {
     return (flags_ & kFlagFastPut) != 0u;
   }
 
+  bool IsFinal() const {
+    return (flags_ & kFlagIsFinal) != 0u;
+  }
+
   MemberOffset FieldOffset() const {
     return field_offset_;
   }
@@ -128,17 +132,20 @@ class MirIFieldLoweringInfo : public MirFieldInfo {
   enum {
     kBitFastGet = kFieldInfoBitEnd,
     kBitFastPut,
+    kBitIsFinal,
     kIFieldLoweringInfoBitEnd
   };
   COMPILE_ASSERT(kIFieldLoweringInfoBitEnd <= 16, too_many_flags);
   static constexpr uint16_t kFlagFastGet = 1u << kBitFastGet;
   static constexpr uint16_t kFlagFastPut = 1u << kBitFastPut;
+  static constexpr uint16_t kFlagIsFinal = 1u << kBitIsFinal;
 
   // The member offset of the field, 0u if unresolved.
   MemberOffset field_offset_;
 
   friend class GlobalValueNumberingTest;
   friend class LocalValueNumberingTest;
+  friend class LoopOptimizationTest;
 };
 
 class MirSFieldLoweringInfo : public MirFieldInfo {
@@ -34,6 +34,8 @@
 namespace art {
 
 class GlobalValueNumbering;
+struct InductionVariable;
+struct VectorizableLoop;
 
 enum InstructionAnalysisAttributePos {
   kUninterestingOp = 0,
@@ -547,9 +549,9 @@ class MIRGraph {
   bool SkipCompilation(std::string* skip_message);
 
   /*
-   * Should we skip the compilation of this method based on its name?
+   * Should we skip the compilation of this method based on the profile?
    */
-  bool SkipCompilationByName(const std::string& methodname);
+  bool SkipCompilationByProfile();
 
   /*
    * Parse dex method and add MIR at current insert point.  Returns id (which is
@@ -681,6 +683,8 @@ class MIRGraph {
 
   void RemapRegLocations();
 
+  void MapInlinedVRegsToCompilerTemps();
+
   void DumpRegLocTable(RegLocation* table, int count);
 
   void BasicBlockOptimization();
@@ -737,6 +741,16 @@ class MIRGraph {
     return num_ssa_regs_;
   }
 
+  /**
+   * @brief Used to obtain the number of virtual registers tracked by the SSA construction.
+   * @details Registers of inlined callees are numbered right after the method's own Dalvik
+   * registers until MapInlinedVRegsToCompilerTemps() moves them to compiler temporaries.
+   * @return Returns the number of Dalvik registers plus the number of inlined registers.
+   */
+  int GetNumOfCodeAndInlinedVRs() const {
+    return cu_->num_dalvik_registers + num_inlined_vregs_;
+  }
+
   void SetNumSSARegs(int new_num) {
      /*
       * TODO: It's theoretically possible to exceed 32767, though any cases which did
@@ -926,6 +940,12 @@ class MIRGraph {
   bool ApplyGlobalValueNumberingGate();
   bool ApplyGlobalValueNumbering(BasicBlock* bb);
   void ApplyGlobalValueNumberingEnd();
+  bool EliminateRangeChecksGate();
+  void EliminateRangeChecks();
+  bool HoistLoopInvariantsGate();
+  void HoistLoopInvariants();
+  bool VectorizeLoopsGate();
+  void VectorizeLoops();
   /*
    * Type inference handling helpers.  Because Dalvik's bytecode is not fully typed,
    * we have to do some work to figure out the sreg type.  For some operations it is
@@ -983,6 +1003,9 @@ class MIRGraph {
   void InlineSpecialMethods(BasicBlock* bb);
   void InlineSpecialMethodsEnd();
 
+  bool InlineCallsGate();
+  void InlineCalls();
+
   /**
    * @brief Perform the initial preparation for the Method Uses.
    */
@@ -1118,6 +1141,19 @@ class MIRGraph {
   int GetSSAUseCount(int s_reg);
   bool BasicBlockOpt(BasicBlock* bb);
   bool BuildExtendedBBList(struct BasicBlock* bb);
+  bool IsInLoop(BasicBlockId bb_id, size_t loop_start, size_t loop_end);
+  MIR** MapSSADefinitions(ScopedArenaAllocator* allocator);
+  bool FindInductionVariable(MIR* phi, size_t loop_start, size_t loop_end, MIR** ssa_defs,
+                             InductionVariable* iv);
+  void EliminateRangeChecksInLoop(size_t loop_start, size_t loop_end, MIR** ssa_defs);
+  bool IsHoistableLoad(MIR* mir, size_t loop_start, size_t loop_end);
+  bool HoistLoopInvariantsFromLoop(size_t loop_start, size_t loop_end, MIR** ssa_defs);
+  bool InlineCall(BasicBlock* bb, MIR* invoke, MIR* move_result,
+                  const DexFile::CodeItem* code_item);
+  BasicBlock* SplitBlockAfter(BasicBlock* bb, MIR* mir);
+  size_t VectorizeInnermostLoops();
+  bool MatchVectorizableLoop(BasicBlock* header, BasicBlock* body, VectorizableLoop* loop);
+  void VectorizeLoop(const VectorizableLoop& loop);
   bool FillDefBlockMatrix(BasicBlock* bb);
   void InitializeDominationInfo(BasicBlock* bb);
   bool ComputeblockIDom(BasicBlock* bb);
@@ -1188,6 +1224,10 @@ class MIRGraph {
   int forward_branches_;
   GrowableArray<CompilerTemp*> compiler_temps_;
   size_t num_non_special_compiler_temps_;
+  // Registers reserved for inlined callees, numbered from cu_->num_dalvik_registers.
+  size_t num_inlined_vregs_;
+  // Code units inlined so far, checked against the per-method budget.
+  size_t num_inlined_code_units_;
   size_t max_available_non_special_compiler_temps_;
   size_t max_available_special_compiler_temps_;
   bool punt_to_interpreter_;                    // Difficult or not worthwhile - just interpret.
@@ -1201,6 +1241,8 @@ class MIRGraph {
   friend class ClassInitCheckEliminationTest;
   friend class GlobalValueNumberingTest;
   friend class LocalValueNumberingTest;
+  friend class LoopOptimizationTest;
+  friend class MethodInliningTest;
   friend class TopologicalSortOrderTest;
 };
 
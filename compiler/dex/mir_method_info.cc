@@ -79,14 +79,27 @@ void MirMethodLoweringInfo::Resolve(CompilerDriver* compiler_driver,
     bool needs_clinit =
         compiler_driver->NeedsClassInitialization(referrer_class.Get(), resolved_method);
     uint16_t other_flags = it->flags_ &
-        ~(kFlagFastPath | kFlagNeedsClassInitialization | (kInvokeTypeMask << kBitSharpTypeBegin));
+        ~(kFlagFastPath | kFlagNeedsClassInitialization | kFlagTargetIsSynchronized |
+          (kInvokeTypeMask << kBitSharpTypeBegin));
     it->flags_ = other_flags |
         (fast_path_flags != 0 ? kFlagFastPath : 0u) |
         (static_cast<uint16_t>(invoke_type) << kBitSharpTypeBegin) |
-        (needs_clinit ? kFlagNeedsClassInitialization : 0u);
+        (needs_clinit ? kFlagNeedsClassInitialization : 0u) |
+        (resolved_method->IsSynchronized() ? kFlagTargetIsSynchronized : 0u);
     it->target_dex_file_ = target_method.dex_file;
     it->target_method_idx_ = target_method.dex_method_index;
     it->stats_flags_ = fast_path_flags;
+
+    // Record the code of the target for the method inliner if we know it's the resolved method.
+    it->target_code_item_ = nullptr;
+    if (fast_path_flags != 0 && (invoke_type == kDirect || invoke_type == kStatic) &&
+        target_method.dex_file == it->declaring_dex_file_ &&
+        target_method.dex_method_index == it->declaring_method_idx_ &&
+        !resolved_method->IsNative() && !resolved_method->IsAbstract() &&
+        !resolved_method->IsConstructor() &&
+        resolved_method->GetDeclaringClass()->IsVerified()) {
+      it->target_code_item_ = resolved_method->GetCodeItem();
+    }
   }
 }
 
@@ -20,6 +20,7 @@
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/mutex.h"
+#include "dex_file.h"
 #include "invoke_type.h"
 #include "method_reference.h"
 
@@ -108,7 +109,8 @@ class MirMethodLoweringInfo : public MirMethodInfo {
         target_dex_file_(nullptr),
         target_method_idx_(0u),
         vtable_idx_(0u),
-        stats_flags_(0) {
+        stats_flags_(0),
+        target_code_item_(nullptr) {
   }
 
   void SetDevirtualizationTarget(const MethodReference& ref) {
@@ -127,6 +129,10 @@ class MirMethodLoweringInfo : public MirMethodInfo {
     return (flags_ & kFlagNeedsClassInitialization) != 0u;
   }
 
+  bool IsTargetSynchronized() const {
+    return (flags_ & kFlagTargetIsSynchronized) != 0u;
+  }
+
   InvokeType GetInvokeType() const {
     return static_cast<InvokeType>((flags_ >> kBitInvokeTypeBegin) & kInvokeTypeMask);
   }
@@ -155,6 +161,12 @@ class MirMethodLoweringInfo : public MirMethodInfo {
     return stats_flags_;
   }
 
+  // The code item of a sharpened (direct or static) target method of a verified class that
+  // a caller could take in place of the call, nullptr if the target isn't such a method.
+  const DexFile::CodeItem* GetTargetCodeItem() const {
+    return target_code_item_;
+  }
+
  private:
   enum {
     kBitFastPath = kMethodInfoBitEnd,
@@ -163,11 +175,13 @@ class MirMethodLoweringInfo : public MirMethodInfo {
     kBitSharpTypeBegin,
     kBitSharpTypeEnd = kBitSharpTypeBegin + 3,  // 3 bits for sharp type.
     kBitNeedsClassInitialization = kBitSharpTypeEnd,
+    kBitTargetIsSynchronized,
     kMethodLoweringInfoEnd
   };
   COMPILE_ASSERT(kMethodLoweringInfoEnd <= 16, too_many_flags);
   static constexpr uint16_t kFlagFastPath = 1u << kBitFastPath;
   static constexpr uint16_t kFlagNeedsClassInitialization = 1u << kBitNeedsClassInitialization;
+  static constexpr uint16_t kFlagTargetIsSynchronized = 1u << kBitTargetIsSynchronized;
   static constexpr uint16_t kInvokeTypeMask = 7u;
   COMPILE_ASSERT((1u << (kBitInvokeTypeEnd - kBitInvokeTypeBegin)) - 1u == kInvokeTypeMask,
                  assert_invoke_type_bits_ok);
@@ -184,8 +198,10 @@ class MirMethodLoweringInfo : public MirMethodInfo {
   uint16_t target_method_idx_;
   uint16_t vtable_idx_;
   int stats_flags_;
+  const DexFile::CodeItem* target_code_item_;
 
   friend class ClassInitCheckEliminationTest;
+  friend class MethodInliningTest;
 };
 
 }  // namespace art
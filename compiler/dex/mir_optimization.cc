@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
 #include "compiler_internals.h"
 #include "global_value_numbering.h"
 #include "local_value_numbering.h"
@@ -1285,6 +1287,423 @@ void MIRGraph::InlineSpecialMethodsEnd() {
   temp_scoped_alloc_.reset();
 }
 
+// Callees with more code units than this are not inlined.
+static constexpr uint32_t kMaxInlinedCalleeCodeUnits = 32u;
+// Budget of callee code units inlined into a single method.
+static constexpr size_t kMaxInlinedCodeUnitsPerMethod = 256u;
+// Non-special compiler temps left for the backend after homing the inlined registers.
+static constexpr size_t kInlinerReservedCompilerTemps = 2u;
+
+static uint32_t GetInvokeArgReg(MIR* invoke, uint32_t arg) {
+  DCHECK_LT(arg, invoke->dalvikInsn.vA);
+  if (Instruction::FormatOf(invoke->dalvikInsn.opcode) == Instruction::k3rc) {
+    return invoke->dalvikInsn.vC + arg;  // Range invoke.
+  } else {
+    return invoke->dalvikInsn.arg[arg];  // Non-range invoke.
+  }
+}
+
+static MIR* NewInlinedMove(MIRGraph* mir_graph, MIR* invoke, Instruction::Code opcode,
+                           uint32_t dest, uint32_t src) {
+  MIR* move = mir_graph->NewMIR();
+  move->offset = invoke->offset;
+  move->optimization_flags = MIR_CALLEE;
+  move->dalvikInsn.opcode = opcode;
+  move->dalvikInsn.vA = dest;
+  move->dalvikInsn.vB = src;
+  return move;
+}
+
+bool MIRGraph::InlineCallsGate() {
+  if ((cu_->disable_opt & (1u << kGeneralMethodInlining)) != 0u ||
+      (cu_->disable_opt & (1u << kSuppressMethodInlining)) != 0u ||
+      method_lowering_infos_.Size() == 0u) {
+    return false;
+  }
+  if (cu_->compiler_driver->GetMethodInlinerMap() == nullptr) {
+    // This isn't the Quick compiler.
+    return false;
+  }
+  // Debuggable code must keep the callee frames.
+  return !cu_->compiler_driver->GetCompilerOptions().GetIncludeDebugSymbols();
+}
+
+void MIRGraph::InlineCalls() {
+  // Inlining appends the continuation of each call site to the block list, so the blocks
+  // added here are scanned for further calls as well.
+  for (size_t i = 0u; i < block_list_.Size(); ++i) {
+    BasicBlock* bb = block_list_.Get(i);
+    if (bb->block_type != kDalvikByteCode || bb->hidden) {
+      continue;
+    }
+    for (MIR* mir = bb->first_mir_insn; mir != nullptr; mir = mir->next) {
+      if (MIR::DecodedInstruction::IsPseudoMirOp(mir->dalvikInsn.opcode) ||
+          (Instruction::FlagsOf(mir->dalvikInsn.opcode) & Instruction::kInvoke) == 0 ||
+          (mir->optimization_flags & MIR_INLINED) != 0) {
+        continue;
+      }
+      const MirMethodLoweringInfo& method_info = GetMethodLoweringInfo(mir);
+      if (!method_info.FastPath() || method_info.GetTargetCodeItem() == nullptr ||
+          method_info.IsTargetSynchronized()) {
+        continue;  // Inlining a synchronized method would drop its monitor-enter/exit.
+      }
+      InvokeType sharp_type = method_info.GetSharpType();
+      if ((sharp_type != kDirect) &&
+          (sharp_type != kStatic || method_info.NeedsClassInitialization())) {
+        continue;
+      }
+      MethodReference target = method_info.GetTargetMethod();
+      if (target.dex_file != cu_->dex_file || target.dex_method_index == cu_->method_idx) {
+        // Field and method indexes in the callee must be valid in our dex file; no recursion.
+        continue;
+      }
+      MIR* move_result = FindMoveResult(bb, mir);
+      if (move_result != nullptr && move_result != mir->next) {
+        continue;
+      }
+      if (InlineCall(bb, mir, move_result, method_info.GetTargetCodeItem())) {
+        if (cu_->verbose || cu_->print_pass) {
+          LOG(INFO) << "MethodInliner: Inlined " << method_info.GetInvokeType() << " ("
+              << sharp_type << ") call to \""
+              << PrettyMethod(target.dex_method_index, *target.dex_file) << "\" from \""
+              << PrettyMethod(cu_->method_idx, *cu_->dex_file)
+              << "\" @0x" << std::hex << mir->offset;
+        }
+        // The rest of the block moved to the continuation, which we visit later.
+        break;
+      }
+    }
+  }
+}
+
+/*
+ * Copy the callee's code in place of the invoke. Quick keeps no inline frame info, so the
+ * inlined code takes the dex pc of the invoke and must neither reach a safepoint nor throw
+ * an exception that would show the wrong stack trace. The only exception allowed is the NPE
+ * for a null receiver which the inlined invoke still raises at the call site; catch edges of
+ * the invoke therefore cover the inlined code as they are. Callee registers are numbered
+ * after the method's own Dalvik registers and share the same range across call sites.
+ */
+bool MIRGraph::InlineCall(BasicBlock* bb, MIR* invoke, MIR* move_result,
+                          const DexFile::CodeItem* code_item) {
+  const MirMethodLoweringInfo& method_info = GetMethodLoweringInfo(invoke);
+  MethodReference target = method_info.GetTargetMethod();
+  bool is_static = (method_info.GetSharpType() == kStatic);
+  uint32_t num_regs = code_item->registers_size_;
+  uint32_t num_ins = code_item->ins_size_;
+  uint32_t num_code_units = code_item->insns_size_in_code_units_;
+  if (code_item->tries_size_ != 0u || num_code_units == 0u ||
+      num_code_units > kMaxInlinedCalleeCodeUnits ||
+      num_inlined_code_units_ + num_code_units > kMaxInlinedCodeUnitsPerMethod ||
+      num_ins != invoke->dalvikInsn.vA) {
+    return false;
+  }
+  if (num_regs > num_inlined_vregs_ &&
+      num_regs + kInlinerReservedCompilerTemps > GetNumAvailableNonSpecialCompilerTemps()) {
+    return false;
+  }
+
+  // Wide arguments must be passed in register pairs to be moved as a unit.
+  const DexFile::MethodId& method_id = target.dex_file->GetMethodId(target.dex_method_index);
+  const char* shorty = target.dex_file->GetMethodShorty(method_id);
+  uint32_t num_arg_words = is_static ? 0u : 1u;
+  for (const char* type = shorty + 1; *type != '\0'; ++type) {
+    if (*type == 'J' || *type == 'D') {
+      if (num_arg_words + 1u >= num_ins ||
+          GetInvokeArgReg(invoke, num_arg_words + 1u) !=
+              GetInvokeArgReg(invoke, num_arg_words) + 1u) {
+        return false;
+      }
+      num_arg_words += 2u;
+    } else {
+      num_arg_words += 1u;
+    }
+  }
+  if (num_arg_words != num_ins) {
+    return false;
+  }
+
+  // Check the callee's instructions and find the block leaders.
+  ScopedArenaAllocator allocator(&cu_->arena_stack);
+  ScopedArenaVector<bool> is_insn(num_code_units, false, allocator.Adapter());
+  ScopedArenaVector<bool> is_leader(num_code_units, false, allocator.Adapter());
+  ScopedArenaVector<MirIFieldLoweringInfo> ifield_infos(allocator.Adapter());
+  const uint16_t* insns = code_item->insns_;
+  uint32_t this_reg = num_regs - num_ins;
+  bool writes_this = false;
+  bool uses_this = false;
+  is_leader[0] = true;
+  for (uint32_t offset = 0u; offset != num_code_units; ) {
+    const Instruction* inst = Instruction::At(insns + offset);
+    Instruction::Code opcode = inst->Opcode();
+    uint32_t width = inst->SizeInCodeUnits();
+    int flags = Instruction::FlagsOf(opcode);
+    if (width > num_code_units - offset) {
+      return false;
+    }
+    is_insn[offset] = true;
+    bool is_field_access = (opcode >= Instruction::IGET && opcode <= Instruction::IPUT_SHORT);
+    bool is_branch = (opcode >= Instruction::GOTO && opcode <= Instruction::GOTO_32) ||
+        (opcode >= Instruction::IF_EQ && opcode <= Instruction::IF_LEZ);
+    bool allowed =
+        (opcode == Instruction::NOP && width == 1u) ||  // But not a payload.
+        (opcode >= Instruction::MOVE && opcode <= Instruction::MOVE_OBJECT_16) ||
+        (opcode >= Instruction::RETURN_VOID && opcode <= Instruction::RETURN_OBJECT) ||
+        (opcode >= Instruction::CONST_4 && opcode <= Instruction::CONST_WIDE_HIGH16) ||
+        (opcode >= Instruction::CMPL_FLOAT && opcode <= Instruction::CMP_LONG) ||
+        (opcode >= Instruction::NEG_INT && opcode <= Instruction::USHR_INT_LIT8) ||
+        is_field_access || is_branch;
+    if (!allowed) {
+      return false;
+    }
+    if ((flags & Instruction::kThrow) != 0) {
+      if (is_field_access) {
+        // Only on the receiver, which the inlined invoke null-checks. Resolved below.
+        if (is_static || inst->VRegB_22c() != this_reg) {
+          return false;
+        }
+        uses_this = true;
+        ifield_infos.push_back(MirIFieldLoweringInfo(inst->VRegC_22c()));
+      } else if ((opcode == Instruction::DIV_INT_LIT16 || opcode == Instruction::REM_INT_LIT16 ||
+                  opcode == Instruction::DIV_INT_LIT8 || opcode == Instruction::REM_INT_LIT8)) {
+        if ((inst->HasVRegC() ? inst->VRegC() : 0) == 0) {
+          return false;
+        }
+      } else {
+        return false;  // DIV/REM by a register.
+      }
+    }
+    uint64_t df_attributes = GetDataFlowAttributes(opcode);
+    if ((df_attributes & DF_DA) != 0 &&
+        (static_cast<uint32_t>(inst->VRegA()) == this_reg ||
+         ((df_attributes & DF_A_WIDE) != 0 && inst->VRegA() + 1u == this_reg))) {
+      writes_this = true;
+    }
+    if (is_branch) {
+      int32_t branch_offset = inst->GetTargetOffset();
+      if (branch_offset <= 0 || static_cast<uint32_t>(branch_offset) >= num_code_units - offset) {
+        return false;  // Loops would need suspend checks.
+      }
+      is_leader[offset + branch_offset] = true;
+    }
+    if ((flags & Instruction::kContinue) == 0 || is_branch) {
+      if (offset + width != num_code_units) {
+        is_leader[offset + width] = true;
+      }
+    } else if (offset + width == num_code_units) {
+      return false;  // Falls off the end.
+    }
+    offset += width;
+  }
+  if (uses_this && writes_this) {
+    return false;
+  }
+  for (uint32_t offset = 0u; offset != num_code_units; ++offset) {
+    if (is_leader[offset] && !is_insn[offset]) {
+      return false;
+    }
+  }
+  if (!ifield_infos.empty()) {
+    if ((cu_->enable_debug & (1 << kDebugSlowFieldPath)) != 0) {
+      return false;
+    }
+    DexCompilationUnit inlined_unit(
+        cu_, cu_->class_loader, cu_->class_linker, *target.dex_file,
+        code_item, 0u /* class_def_idx not used */, target.dex_method_index,
+        0u /* access_flags not used */, nullptr /* verified_method not used */);
+    MirIFieldLoweringInfo::Resolve(cu_->compiler_driver, &inlined_unit, ifield_infos.data(),
+                                   ifield_infos.size());
+    size_t pos = 0u;
+    for (uint32_t offset = 0u; offset != num_code_units; ++offset) {
+      if (!is_insn[offset]) {
+        continue;
+      }
+      Instruction::Code opcode = Instruction::At(insns + offset)->Opcode();
+      if (opcode >= Instruction::IGET && opcode <= Instruction::IPUT_SHORT) {
+        const MirIFieldLoweringInfo& info = ifield_infos[pos];
+        ++pos;
+        if (!((opcode <= Instruction::IGET_SHORT) ? info.FastGet() : info.FastPut())) {
+          return false;
+        }
+      }
+    }
+  }
+
+  // We're committed. Splice the callee between the invoke and the rest of the block.
+  num_inlined_vregs_ = std::max<size_t>(num_inlined_vregs_, num_regs);
+  num_inlined_code_units_ += num_code_units;
+  uint32_t vreg_base = cu_->num_dalvik_registers;
+  BasicBlock* cont_bb = SplitBlockAfter(bb, (move_result != nullptr) ? move_result : invoke);
+  ScopedArenaVector<BasicBlock*> blocks(num_code_units, nullptr, allocator.Adapter());
+  for (uint32_t offset = 0u; offset != num_code_units; ++offset) {
+    if (is_leader[offset]) {
+      BasicBlock* new_bb = CreateNewBB(kDalvikByteCode);
+      new_bb->start_offset = invoke->offset;
+      new_bb->nesting_depth = bb->nesting_depth;
+      new_bb->use_lvn = bb->use_lvn;
+      blocks[offset] = new_bb;
+    }
+  }
+  BasicBlock* cur_bb = blocks[0];
+  bb->fall_through = cur_bb->id;
+  cur_bb->predecessors->Insert(bb->id);
+
+  // Pass the arguments.
+  uint32_t arg = 0u;
+  if (!is_static) {
+    cur_bb->AppendMIR(NewInlinedMove(this, invoke, Instruction::MOVE_OBJECT_16,
+                                     vreg_base + this_reg, GetInvokeArgReg(invoke, 0u)));
+    arg = 1u;
+  }
+  for (const char* type = shorty + 1; *type != '\0'; ++type) {
+    uint32_t dest = vreg_base + this_reg + arg;
+    uint32_t src = GetInvokeArgReg(invoke, arg);
+    if (*type == 'J' || *type == 'D') {
+      cur_bb->AppendMIR(NewInlinedMove(this, invoke, Instruction::MOVE_WIDE_16, dest, src));
+      arg += 2u;
+    } else {
+      Instruction::Code opcode =
+          (*type == 'L') ? Instruction::MOVE_OBJECT_16 : Instruction::MOVE_16;
+      cur_bb->AppendMIR(NewInlinedMove(this, invoke, opcode, dest, src));
+      arg += 1u;
+    }
+  }
+
+  // Copy the body.
+  size_t ifield_pos = 0u;
+  bool falls_through = true;
+  for (uint32_t offset = 0u; offset != num_code_units; ) {
+    const Instruction* inst = Instruction::At(insns + offset);
+    Instruction::Code opcode = inst->Opcode();
+    uint32_t width = inst->SizeInCodeUnits();
+    if (offset != 0u && blocks[offset] != nullptr) {
+      if (falls_through) {
+        cur_bb->fall_through = blocks[offset]->id;
+        blocks[offset]->predecessors->Insert(cur_bb->id);
+      }
+      cur_bb = blocks[offset];
+    }
+    falls_through = true;
+
+    MIR* insn = NewMIR();
+    insn->offset = invoke->offset;
+    insn->optimization_flags = MIR_CALLEE;
+    ParseInsn(insns + offset, &insn->dalvikInsn);
+    uint64_t df_attributes = GetDataFlowAttributes(opcode);
+    if ((df_attributes & (DF_DA | DF_UA)) != 0) {
+      insn->dalvikInsn.vA += vreg_base;
+    }
+    if ((df_attributes & DF_UB) != 0) {
+      insn->dalvikInsn.vB += vreg_base;
+    }
+    if ((df_attributes & DF_UC) != 0) {
+      insn->dalvikInsn.vC += vreg_base;
+    }
+
+    if (opcode >= Instruction::GOTO && opcode <= Instruction::GOTO_32) {
+      // Just fall through to the target.
+      BasicBlock* target_bb = blocks[offset + inst->GetTargetOffset()];
+      cur_bb->fall_through = target_bb->id;
+      target_bb->predecessors->Insert(cur_bb->id);
+      falls_through = false;
+    } else if (opcode >= Instruction::IF_EQ && opcode <= Instruction::IF_LEZ) {
+      // All inlined blocks share the invoke's offset and look like back edges; they aren't.
+      insn->optimization_flags |= MIR_IGNORE_SUSPEND_CHECK;
+      cur_bb->AppendMIR(insn);
+      BasicBlock* taken_bb = blocks[offset + inst->GetTargetOffset()];
+      BasicBlock* fall_through_bb = blocks[offset + width];
+      cur_bb->taken = taken_bb->id;
+      cur_bb->fall_through = fall_through_bb->id;
+      cur_bb->conditional_branch = true;
+      taken_bb->predecessors->Insert(cur_bb->id);
+      fall_through_bb->predecessors->Insert(cur_bb->id);
+      falls_through = false;
+    } else if (opcode >= Instruction::RETURN_VOID && opcode <= Instruction::RETURN_OBJECT) {
+      if (move_result != nullptr && opcode != Instruction::RETURN_VOID) {
+        Instruction::Code move_opcode =
+            (opcode == Instruction::RETURN_WIDE) ? Instruction::MOVE_WIDE_16 :
+            (opcode == Instruction::RETURN_OBJECT) ? Instruction::MOVE_OBJECT_16 :
+            Instruction::MOVE_16;
+        cur_bb->AppendMIR(NewInlinedMove(this, invoke, move_opcode, move_result->dalvikInsn.vA,
+                                         insn->dalvikInsn.vA));
+      }
+      cur_bb->fall_through = cont_bb->id;
+      cont_bb->predecessors->Insert(cur_bb->id);
+      falls_through = false;
+    } else if (opcode >= Instruction::IGET && opcode <= Instruction::IPUT_SHORT) {
+      // The receiver is null-checked by the invoke.
+      insn->optimization_flags |= MIR_IGNORE_NULL_CHECK;
+      insn->meta.ifield_lowering_info = ifield_lowering_infos_.Size();
+      ifield_lowering_infos_.Insert(ifield_infos[ifield_pos]);
+      ++ifield_pos;
+      cur_bb->AppendMIR(insn);
+    } else if (opcode != Instruction::NOP) {
+      cur_bb->AppendMIR(insn);
+    }
+    offset += width;
+  }
+  DCHECK_EQ(ifield_pos, ifield_infos.size());
+
+  // Keep the invoke for the receiver null check only, like the special method inliner.
+  invoke->optimization_flags |= MIR_INLINED;
+  if (move_result != nullptr) {
+    move_result->optimization_flags |= MIR_INLINED;
+    move_result->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpNop);
+  }
+  return true;
+}
+
+/*
+ * Move the MIRs following mir and the outgoing edges of bb to a new block.
+ * The new block gets no predecessors; bb is left without successors.
+ */
+BasicBlock* MIRGraph::SplitBlockAfter(BasicBlock* bb, MIR* mir) {
+  BasicBlock* bottom_block = CreateNewBB(kDalvikByteCode);
+  bottom_block->start_offset = mir->offset;
+  bottom_block->nesting_depth = bb->nesting_depth;
+  bottom_block->use_lvn = bb->use_lvn;
+  if (mir->next != nullptr) {
+    bottom_block->first_mir_insn = mir->next;
+    bottom_block->last_mir_insn = bb->last_mir_insn;
+    for (MIR* p = mir->next; p != nullptr; p = p->next) {
+      p->bb = bottom_block->id;
+    }
+    mir->next = nullptr;
+    bb->last_mir_insn = mir;
+  }
+  bottom_block->terminated_by_return = bb->terminated_by_return;
+  bottom_block->conditional_branch = bb->conditional_branch;
+  bottom_block->explicit_throw = bb->explicit_throw;
+  bb->terminated_by_return = false;
+  bb->conditional_branch = false;
+  bb->explicit_throw = false;
+
+  bottom_block->taken = bb->taken;
+  if (bottom_block->taken != NullBasicBlockId) {
+    GetBasicBlock(bottom_block->taken)->UpdatePredecessor(bb->id, bottom_block->id);
+    bb->taken = NullBasicBlockId;
+  }
+  bottom_block->fall_through = bb->fall_through;
+  if (bottom_block->fall_through != NullBasicBlockId) {
+    GetBasicBlock(bottom_block->fall_through)->UpdatePredecessor(bb->id, bottom_block->id);
+    bb->fall_through = NullBasicBlockId;
+  }
+  if (bb->successor_block_list_type != kNotUsed) {
+    bottom_block->successor_block_list_type = bb->successor_block_list_type;
+    bottom_block->successor_blocks = bb->successor_blocks;
+    bb->successor_block_list_type = kNotUsed;
+    bb->successor_blocks = nullptr;
+    GrowableArray<SuccessorBlockInfo*>::Iterator iterator(bottom_block->successor_blocks);
+    for (SuccessorBlockInfo* info = iterator.Next(); info != nullptr; info = iterator.Next()) {
+      BasicBlock* succ_bb = GetBasicBlock(info->block);
+      if (succ_bb != nullptr) {
+        succ_bb->UpdatePredecessor(bb->id, bottom_block->id);
+      }
+    }
+  }
+  return bottom_block;
+}
+
 void MIRGraph::DumpCheckStats() {
   Checkstats* stats =
       static_cast<Checkstats*>(arena_->Alloc(sizeof(Checkstats), kArenaAllocDFInfo));
@@ -1360,4 +1779,937 @@ void MIRGraph::BasicBlockOptimization() {
   }
 }
 
+/*
+ * Induction variables, range check elimination and loop invariant code motion.
+ *
+ * All three work on the loops recorded by the topological sort order, where the blocks of
+ * a loop occupy the index range [loop_start, loop_end) and the header is at loop_start.
+ *
+ * A basic induction variable is a header phi i = phi(init, i + step, ...) whose value on
+ * every back edge is the phi itself plus the same constant step. Range checks are removed
+ * from aget/aput of an array A indexed by such an i in blocks dominated by the in-loop
+ * successor of the header's exit test, when the test guarantees 0 <= i < A.length:
+ *
+ *   - i counts up from a constant >= 0 by 1 and the loop runs while i < array-length A,
+ *   - i counts down from (array-length A) - c with c >= 1 and the loop runs while i >= 0.
+ *
+ * Counting up by 1 cannot overflow since i < A.length <= INT_MAX on the back edge.
+ */
+struct InductionVariable {
+  MIR* phi;           // The header phi defining the induction variable.
+  int init_sreg;      // The value on loop entry.
+  int32_t step;       // The constant added on each back edge.
+};
+
+bool MIRGraph::IsInLoop(BasicBlockId bb_id, size_t loop_start, size_t loop_end) {
+  if (bb_id == NullBasicBlockId) {
+    return false;
+  }
+  // Unreachable blocks have index 0xffff and are never in a loop.
+  size_t idx = GetTopologicalSortOrderIndexes()->Get(bb_id);
+  return loop_start <= idx && idx < loop_end;
+}
+
+MIR** MIRGraph::MapSSADefinitions(ScopedArenaAllocator* allocator) {
+  size_t num_ssa_regs = GetNumSSARegs();
+  MIR** ssa_defs = static_cast<MIR**>(
+      allocator->Alloc(num_ssa_regs * sizeof(MIR*), kArenaAllocDFInfo));
+  std::fill_n(ssa_defs, num_ssa_regs, static_cast<MIR*>(nullptr));
+  AllNodesIterator iter(this);
+  for (BasicBlock* bb = iter.Next(); bb != nullptr; bb = iter.Next()) {
+    for (MIR* mir = bb->first_mir_insn; mir != nullptr; mir = mir->next) {
+      for (int i = 0; mir->ssa_rep != nullptr && i < mir->ssa_rep->num_defs; ++i) {
+        ssa_defs[mir->ssa_rep->defs[i]] = mir;
+      }
+    }
+  }
+  return ssa_defs;
+}
+
+bool MIRGraph::FindInductionVariable(MIR* phi, size_t loop_start, size_t loop_end,
+                                     MIR** ssa_defs, InductionVariable* iv) {
+  DCHECK_EQ(static_cast<int>(phi->dalvikInsn.opcode), kMirOpPhi);
+  int phi_sreg = phi->ssa_rep->defs[0];
+  iv->phi = phi;
+  iv->init_sreg = INVALID_SREG;
+  iv->step = 0;
+  for (int i = 0; i < phi->ssa_rep->num_uses; ++i) {
+    int s_reg = phi->ssa_rep->uses[i];
+    if (!IsInLoop(phi->meta.phi_incoming[i], loop_start, loop_end)) {
+      if (iv->init_sreg != INVALID_SREG && iv->init_sreg != s_reg) {
+        return false;
+      }
+      iv->init_sreg = s_reg;
+      continue;
+    }
+    MIR* def = ssa_defs[s_reg];
+    if (def == nullptr) {
+      return false;
+    }
+    int32_t step;
+    switch (def->dalvikInsn.opcode) {
+      case Instruction::ADD_INT_LIT8:
+      case Instruction::ADD_INT_LIT16:
+        if (def->ssa_rep->uses[0] != phi_sreg) {
+          return false;
+        }
+        step = def->dalvikInsn.vC;
+        break;
+      case Instruction::ADD_INT:
+      case Instruction::ADD_INT_2ADDR:
+        if (def->ssa_rep->uses[0] == phi_sreg && IsConst(def->ssa_rep->uses[1])) {
+          step = ConstantValue(def->ssa_rep->uses[1]);
+        } else if (def->ssa_rep->uses[1] == phi_sreg && IsConst(def->ssa_rep->uses[0])) {
+          step = ConstantValue(def->ssa_rep->uses[0]);
+        } else {
+          return false;
+        }
+        break;
+      default:
+        return false;
+    }
+    if (step == 0 || (iv->step != 0 && iv->step != step)) {
+      return false;
+    }
+    iv->step = step;
+  }
+  return iv->init_sreg != INVALID_SREG && iv->step != 0;
+}
+
+static Instruction::Code NegateIf(Instruction::Code opcode) {
+  switch (opcode) {
+    case Instruction::IF_EQ: return Instruction::IF_NE;
+    case Instruction::IF_NE: return Instruction::IF_EQ;
+    case Instruction::IF_LT: return Instruction::IF_GE;
+    case Instruction::IF_GE: return Instruction::IF_LT;
+    case Instruction::IF_GT: return Instruction::IF_LE;
+    case Instruction::IF_LE: return Instruction::IF_GT;
+    case Instruction::IF_EQZ: return Instruction::IF_NEZ;
+    case Instruction::IF_NEZ: return Instruction::IF_EQZ;
+    case Instruction::IF_LTZ: return Instruction::IF_GEZ;
+    case Instruction::IF_GEZ: return Instruction::IF_LTZ;
+    case Instruction::IF_GTZ: return Instruction::IF_LEZ;
+    case Instruction::IF_LEZ: return Instruction::IF_GTZ;
+    default:
+      LOG(FATAL) << "Unexpected opcode " << opcode;
+      return opcode;
+  }
+}
+
+bool MIRGraph::EliminateRangeChecksGate() {
+  if ((cu_->disable_opt & (1u << kRangeCheckElimination)) != 0u ||
+      (merged_df_flags_ & DF_HAS_RANGE_CHKS) == 0u) {
+    return false;
+  }
+  return true;
+}
+
+void MIRGraph::EliminateRangeChecks() {
+  GrowableArray<uint16_t>* loop_ends = GetTopologicalSortOrderLoopEnds();
+  ScopedArenaAllocator allocator(&cu_->arena_stack);
+  MIR** ssa_defs = nullptr;
+  for (size_t idx = 0u, size = loop_ends->Size(); idx != size; ++idx) {
+    if (loop_ends->Get(idx) == 0u) {
+      continue;
+    }
+    if (ssa_defs == nullptr) {
+      ssa_defs = MapSSADefinitions(&allocator);
+    }
+    EliminateRangeChecksInLoop(idx, loop_ends->Get(idx), ssa_defs);
+  }
+}
+
+void MIRGraph::EliminateRangeChecksInLoop(size_t loop_start, size_t loop_end, MIR** ssa_defs) {
+  GrowableArray<BasicBlockId>* order = GetTopologicalSortOrder();
+  BasicBlock* header = GetBasicBlock(order->Get(loop_start));
+  MIR* test = header->last_mir_insn;
+  if (header->block_type != kDalvikByteCode || test == nullptr ||
+      test->dalvikInsn.opcode < Instruction::IF_EQ ||
+      test->dalvikInsn.opcode > Instruction::IF_LEZ) {
+    return;
+  }
+  // The test must exit the loop on one edge and stay in it on the other.
+  bool taken_in_loop = IsInLoop(header->taken, loop_start, loop_end);
+  if (taken_in_loop == IsInLoop(header->fall_through, loop_start, loop_end)) {
+    return;
+  }
+  BasicBlockId in_loop_id = taken_in_loop ? header->taken : header->fall_through;
+  // The condition under which we stay in the loop.
+  Instruction::Code cond =
+      taken_in_loop ? test->dalvikInsn.opcode : NegateIf(test->dalvikInsn.opcode);
+  int32_t* uses = test->ssa_rep->uses;
+
+  int index_sreg;
+  MIR* length_def;
+  if (cond == Instruction::IF_LT || cond == Instruction::IF_GT) {
+    // i < n or n > i, with n = array-length A.
+    index_sreg = (cond == Instruction::IF_LT) ? uses[0] : uses[1];
+    length_def = ssa_defs[(cond == Instruction::IF_LT) ? uses[1] : uses[0]];
+  } else if (cond == Instruction::IF_GEZ || cond == Instruction::IF_GTZ) {
+    // i >= 0 or i > 0, counting down from (array-length A) - c; the length is checked below.
+    index_sreg = uses[0];
+    length_def = nullptr;
+  } else {
+    return;
+  }
+  MIR* phi = ssa_defs[index_sreg];
+  InductionVariable iv;
+  if (phi == nullptr || phi->bb != header->id ||
+      static_cast<int>(phi->dalvikInsn.opcode) != kMirOpPhi ||
+      !FindInductionVariable(phi, loop_start, loop_end, ssa_defs, &iv)) {
+    return;
+  }
+  if (length_def == nullptr) {
+    // Counting down: init = (array-length A) + c with c <= -1 and any negative step.
+    MIR* init_def = ssa_defs[iv.init_sreg];
+    if (iv.step >= 0 || init_def == nullptr ||
+        (init_def->dalvikInsn.opcode != Instruction::ADD_INT_LIT8 &&
+         init_def->dalvikInsn.opcode != Instruction::ADD_INT_LIT16) ||
+        static_cast<int32_t>(init_def->dalvikInsn.vC) > -1) {
+      return;
+    }
+    length_def = ssa_defs[init_def->ssa_rep->uses[0]];
+  } else {
+    // Counting up: a non-negative constant init and a step of 1.
+    if (iv.step != 1 || !IsConst(iv.init_sreg) || ConstantValue(iv.init_sreg) < 0) {
+      return;
+    }
+  }
+  if (length_def == nullptr || length_def->dalvikInsn.opcode != Instruction::ARRAY_LENGTH) {
+    return;
+  }
+  int array_sreg = length_def->ssa_rep->uses[0];
+
+  // Every path from the header to a block dominated by the in-loop successor passes the test
+  // with the current value of i, so accesses to A[i] in such blocks are in bounds.
+  for (size_t idx = loop_start; idx != loop_end; ++idx) {
+    BasicBlock* bb = GetBasicBlock(order->Get(idx));
+    if (bb->dominators == nullptr || !bb->dominators->IsBitSet(in_loop_id)) {
+      continue;
+    }
+    for (MIR* mir = bb->first_mir_insn; mir != nullptr; mir = mir->next) {
+      Instruction::Code opcode = mir->dalvikInsn.opcode;
+      if (opcode < Instruction::AGET || opcode > Instruction::APUT_SHORT) {
+        continue;
+      }
+      uint32_t start = mir->GetStartUseIndex();
+      if (mir->ssa_rep->uses[start] == array_sreg &&
+          mir->ssa_rep->uses[start + 1u] == index_sreg) {
+        mir->optimization_flags |= MIR_IGNORE_RANGE_CHECK;
+      }
+    }
+  }
+}
+
+/*
+ * Loop invariant code motion moves loads of loop invariant values, i.e. array-length of an
+ * invariant array and iget of a final field of an invariant object, from the start of the
+ * loop header to the end of its single pre-header. Only the leading non-phi instructions of
+ * the header are considered: they execute first in every iteration, so executing them once
+ * before the loop throws the same exceptions at the same point. The moved instructions keep
+ * their SSA form; since Quick also homes values in Dalvik registers, the registers they
+ * define must not be written anywhere else in the loop.
+ */
+bool MIRGraph::HoistLoopInvariantsGate() {
+  return (cu_->disable_opt & (1u << kLoopInvariantCodeMotion)) == 0u;
+}
+
+void MIRGraph::HoistLoopInvariants() {
+  GrowableArray<uint16_t>* loop_ends = GetTopologicalSortOrderLoopEnds();
+  ScopedArenaAllocator allocator(&cu_->arena_stack);
+  MIR** ssa_defs = nullptr;
+  for (size_t idx = 0u, size = loop_ends->Size(); idx != size; ++idx) {
+    if (loop_ends->Get(idx) == 0u) {
+      continue;
+    }
+    if (ssa_defs == nullptr) {
+      ssa_defs = MapSSADefinitions(&allocator);
+    }
+    if (HoistLoopInvariantsFromLoop(idx, loop_ends->Get(idx), ssa_defs) &&
+        cu_->verbose) {
+      LOG(INFO) << "Hoisted loop invariants out of loop at 0x" << std::hex
+                << GetBasicBlock(GetTopologicalSortOrder()->Get(idx))->start_offset
+                << std::dec << " in " << PrettyMethod(cu_->method_idx, *cu_->dex_file);
+    }
+  }
+}
+
+bool MIRGraph::IsHoistableLoad(MIR* mir, size_t loop_start, size_t loop_end) {
+  Instruction::Code opcode = mir->dalvikInsn.opcode;
+  if (opcode == Instruction::ARRAY_LENGTH) {
+    return true;
+  }
+  if (opcode < Instruction::IGET || opcode > Instruction::IGET_SHORT) {
+    return false;
+  }
+  const MirIFieldLoweringInfo& field_info = GetIFieldLoweringInfo(mir);
+  if (!field_info.IsResolved() || field_info.IsVolatile() || !field_info.IsFinal() ||
+      !field_info.FastGet()) {
+    return false;
+  }
+  // A constructor may still be initializing the final field in the loop.
+  GrowableArray<BasicBlockId>* order = GetTopologicalSortOrder();
+  for (size_t idx = loop_start; idx != loop_end; ++idx) {
+    BasicBlock* bb = GetBasicBlock(order->Get(idx));
+    for (MIR* put = bb->first_mir_insn; put != nullptr; put = put->next) {
+      if (put->dalvikInsn.opcode < Instruction::IPUT ||
+          put->dalvikInsn.opcode > Instruction::IPUT_SHORT) {
+        continue;
+      }
+      const MirIFieldLoweringInfo& put_info = GetIFieldLoweringInfo(put);
+      if (!put_info.IsResolved() ||
+          (put_info.DeclaringDexFile() == field_info.DeclaringDexFile() &&
+           put_info.DeclaringFieldIndex() == field_info.DeclaringFieldIndex())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static bool Contains(MIR* const* mirs, size_t num_mirs, MIR* mir) {
+  return std::find(mirs, mirs + num_mirs, mir) != mirs + num_mirs;
+}
+
+bool MIRGraph::HoistLoopInvariantsFromLoop(size_t loop_start, size_t loop_end, MIR** ssa_defs) {
+  static constexpr size_t kMaxHoisted = 8u;
+  GrowableArray<BasicBlockId>* order = GetTopologicalSortOrder();
+  BasicBlock* header = GetBasicBlock(order->Get(loop_start));
+  if (header->block_type != kDalvikByteCode || header->successor_block_list_type != kNotUsed) {
+    return false;
+  }
+  // The header must be entered from outside the loop through a single pre-header that
+  // leads only to the header.
+  BasicBlock* pre_header = nullptr;
+  GrowableArray<BasicBlockId>::Iterator pred_iter(header->predecessors);
+  for (BasicBlockId pred_id = pred_iter.Next(); pred_id != NullBasicBlockId;
+       pred_id = pred_iter.Next()) {
+    if (!IsInLoop(pred_id, loop_start, loop_end)) {
+      if (pre_header != nullptr) {
+        return false;
+      }
+      pre_header = GetBasicBlock(pred_id);
+    }
+  }
+  if (pre_header == nullptr || pre_header->block_type != kDalvikByteCode ||
+      pre_header->successor_block_list_type != kNotUsed ||
+      !((pre_header->fall_through == header->id && pre_header->taken == NullBasicBlockId) ||
+        (pre_header->taken == header->id && pre_header->fall_through == NullBasicBlockId))) {
+    return false;
+  }
+
+  // Collect the leading invariant loads of the header.
+  MIR* hoisted[kMaxHoisted];
+  size_t num_hoisted = 0u;
+  for (MIR* mir = header->first_mir_insn; mir != nullptr && num_hoisted != kMaxHoisted;
+       mir = mir->next) {
+    int opcode = mir->dalvikInsn.opcode;
+    if (opcode == kMirOpPhi || opcode == kMirOpNop) {
+      continue;
+    }
+    if (mir->ssa_rep == nullptr || !IsHoistableLoad(mir, loop_start, loop_end)) {
+      break;
+    }
+    bool invariant = true;
+    for (int i = 0; i < mir->ssa_rep->num_uses && invariant; ++i) {
+      MIR* def = ssa_defs[mir->ssa_rep->uses[i]];
+      invariant = def == nullptr || !IsInLoop(def->bb, loop_start, loop_end) ||
+          Contains(hoisted, num_hoisted, def);
+    }
+    if (!invariant) {
+      break;
+    }
+    hoisted[num_hoisted++] = mir;
+  }
+
+  // Drop trailing candidates until no other instruction in the loop writes a Dalvik register
+  // that the hoisted instructions define.
+  while (num_hoisted != 0u) {
+    bool conflict = false;
+    for (size_t idx = loop_start; idx != loop_end && !conflict; ++idx) {
+      BasicBlock* bb = GetBasicBlock(order->Get(idx));
+      for (MIR* mir = bb->first_mir_insn; mir != nullptr && !conflict; mir = mir->next) {
+        if (mir->ssa_rep == nullptr || Contains(hoisted, num_hoisted, mir)) {
+          continue;
+        }
+        for (int i = 0; i < mir->ssa_rep->num_defs && !conflict; ++i) {
+          int v_reg = SRegToVReg(mir->ssa_rep->defs[i]);
+          for (size_t h = 0u; h != num_hoisted && !conflict; ++h) {
+            for (int j = 0; j < hoisted[h]->ssa_rep->num_defs; ++j) {
+              if (SRegToVReg(hoisted[h]->ssa_rep->defs[j]) == v_reg) {
+                conflict = true;
+                break;
+              }
+            }
+          }
+        }
+      }
+    }
+    if (!conflict) {
+      break;
+    }
+    --num_hoisted;
+  }
+  if (num_hoisted == 0u) {
+    return false;
+  }
+
+  MIR* pre_header_goto = pre_header->last_mir_insn;
+  if (pre_header_goto != nullptr && pre_header_goto->dalvikInsn.opcode != Instruction::GOTO &&
+      pre_header_goto->dalvikInsn.opcode != Instruction::GOTO_16 &&
+      pre_header_goto->dalvikInsn.opcode != Instruction::GOTO_32) {
+    pre_header_goto = nullptr;
+  }
+  for (size_t h = 0u; h != num_hoisted; ++h) {
+    header->RemoveMIR(hoisted[h]);
+    if (pre_header_goto != nullptr) {
+      pre_header->InsertMIRBefore(pre_header_goto, hoisted[h]);
+    } else {
+      pre_header->AppendMIR(hoisted[h]);
+    }
+  }
+  return true;
+}
+
+/*
+ * Loop vectorization.
+ *
+ * Recognizes innermost counted loops over a single primitive array of the form
+ *
+ *   H: i = phi(c, i'), [sum = phi(s, sum')], [len = array-length A], if-ge i, len -> exit
+ *   B: x = aget A[i], x = x op k, ..., (aput x, A[i] | sum' = sum + x), i' = i + 1, goto H
+ *
+ * where c >= 0 is a constant and each k is a constant or a loop invariant, and rewrites
+ * them by inserting a vector loop in front of the original one:
+ *
+ *   VH: [len = array-length A], x = len - (W - 1), if-ge i, x -> H
+ *   VB: A[i..i+W-1] = packed ops on A[i..i+W-1] (or sum += add-reduce), i += W, goto VH
+ *
+ * The original loop then runs the remaining iterations as the scalar post-loop. Packed
+ * array accesses are unaligned, so no scalar pre-loop is needed for alignment. Vector
+ * registers are reserved and returned within VB, so no vector value is live across the
+ * back edge suspend check. The new blocks are expressed in Dalvik vregs and SSA is
+ * rebuilt afterwards.
+ */
+struct VectorizableLoop {
+  static constexpr size_t kMaxOps = 8u;
+
+  struct Op {
+    ExtendedMIROpcode opcode;
+    bool is_constant;
+    int32_t constant;     // Operand value or shift amount, if is_constant.
+    int operand_vreg;     // Loop invariant operand, if !is_constant.
+    NarrowDexOffset offset;
+  };
+
+  BasicBlock* pre_header;
+  BasicBlock* header;
+  BasicBlock* body;
+  MIR* array_length;      // In the header, or nullptr if the length is computed before the loop.
+  MIR* exit_test;
+  MIR* aget;
+  MIR* terminal;          // APUT storing the result, or ADD_INT reducing it into the sum.
+  MIR* increment;
+  MIR* back_edge;
+  int array_vreg;
+  int index_vreg;
+  int length_vreg;
+  int scratch_vreg;       // Dead at loop entry; the aget destination.
+  int sum_vreg;           // -1 if the terminal is an APUT.
+  OpSize lane_size;
+  int lanes;
+  size_t num_ops;
+  Op ops[kMaxOps];
+};
+
+static MIR* NextNonNopMIR(MIR* mir) {
+  while (mir != nullptr && static_cast<int>(mir->dalvikInsn.opcode) == kMirOpNop) {
+    mir = mir->next;
+  }
+  return mir;
+}
+
+static int PhiInput(MIR* phi, BasicBlockId pred_id) {
+  for (int i = 0; i < phi->ssa_rep->num_uses; ++i) {
+    if (phi->meta.phi_incoming[i] == pred_id) {
+      return phi->ssa_rep->uses[i];
+    }
+  }
+  return INVALID_SREG;
+}
+
+static bool IsDefinedIn(BasicBlock* bb, int s_reg) {
+  for (MIR* mir = bb->first_mir_insn; mir != nullptr; mir = mir->next) {
+    for (int i = 0; mir->ssa_rep != nullptr && i < mir->ssa_rep->num_defs; ++i) {
+      if (mir->ssa_rep->defs[i] == s_reg) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static int PackedOpcodeFor(Instruction::Code opcode) {
+  switch (opcode) {
+    case Instruction::ADD_INT:
+    case Instruction::ADD_INT_2ADDR:
+    case Instruction::ADD_INT_LIT16:
+    case Instruction::ADD_INT_LIT8:
+      return kMirOpPackedAddition;
+    case Instruction::SUB_INT:
+    case Instruction::SUB_INT_2ADDR:
+      return kMirOpPackedSubtract;
+    case Instruction::MUL_INT:
+    case Instruction::MUL_INT_2ADDR:
+    case Instruction::MUL_INT_LIT16:
+    case Instruction::MUL_INT_LIT8:
+      return kMirOpPackedMultiply;
+    case Instruction::AND_INT:
+    case Instruction::AND_INT_2ADDR:
+    case Instruction::AND_INT_LIT16:
+    case Instruction::AND_INT_LIT8:
+      return kMirOpPackedAnd;
+    case Instruction::OR_INT:
+    case Instruction::OR_INT_2ADDR:
+    case Instruction::OR_INT_LIT16:
+    case Instruction::OR_INT_LIT8:
+      return kMirOpPackedOr;
+    case Instruction::XOR_INT:
+    case Instruction::XOR_INT_2ADDR:
+    case Instruction::XOR_INT_LIT16:
+    case Instruction::XOR_INT_LIT8:
+      return kMirOpPackedXor;
+    case Instruction::SHL_INT:
+    case Instruction::SHL_INT_2ADDR:
+    case Instruction::SHL_INT_LIT8:
+      return kMirOpPackedShiftLeft;
+    case Instruction::SHR_INT:
+    case Instruction::SHR_INT_2ADDR:
+    case Instruction::SHR_INT_LIT8:
+      return kMirOpPackedSignedShiftRight;
+    case Instruction::USHR_INT:
+    case Instruction::USHR_INT_2ADDR:
+    case Instruction::USHR_INT_LIT8:
+      return kMirOpPackedUnsignedShiftRight;
+    default:
+      return kMirOpLast;
+  }
+}
+
+static bool IsLiteralOp(Instruction::Code opcode) {
+  return (opcode >= Instruction::ADD_INT_LIT16 && opcode <= Instruction::XOR_INT_LIT16) ||
+      (opcode >= Instruction::ADD_INT_LIT8 && opcode <= Instruction::USHR_INT_LIT8);
+}
+
+bool MIRGraph::VectorizeLoopsGate() {
+  if ((cu_->disable_opt & (1u << kLoopVectorization)) != 0u) {
+    return false;
+  }
+  if (cu_->compiler_driver->GetMethodInlinerMap() == nullptr) {
+    // This isn't the Quick compiler.
+    return false;
+  }
+  // Only the x86 backends lower the packed MIRs; PMULLD, PEXTRD and PHADDD need SSE4.1.
+  if (cu_->instruction_set != kX86 && cu_->instruction_set != kX86_64) {
+    return false;
+  }
+  return cu_->compiler_driver->GetInstructionSetFeatures().HasSse4_1();
+}
+
+void MIRGraph::VectorizeLoops() {
+  if (VectorizeInnermostLoops() != 0u) {
+    // Only pay for rebuilding the SSA form and loop information if we did something.
+    CalculateBasicBlockInformation();
+  }
+}
+
+size_t MIRGraph::VectorizeInnermostLoops() {
+  GrowableArray<BasicBlockId>* order = GetTopologicalSortOrder();
+  GrowableArray<uint16_t>* loop_ends = GetTopologicalSortOrderLoopEnds();
+  size_t num_vectorized = 0u;
+  for (size_t idx = 0u, size = order->Size(); idx + 1u < size; ++idx) {
+    // Only innermost loops made of a header and a single body block.
+    if (loop_ends->Get(idx) != idx + 2u) {
+      continue;
+    }
+    VectorizableLoop loop;
+    if (MatchVectorizableLoop(GetBasicBlock(order->Get(idx)), GetBasicBlock(order->Get(idx + 1u)),
+                              &loop)) {
+      VectorizeLoop(loop);
+      ++num_vectorized;
+    }
+  }
+  return num_vectorized;
+}
+
+bool MIRGraph::MatchVectorizableLoop(BasicBlock* header, BasicBlock* body,
+                                     VectorizableLoop* loop) {
+  if (header->block_type != kDalvikByteCode || body->block_type != kDalvikByteCode ||
+      header->successor_block_list_type != kNotUsed ||
+      body->successor_block_list_type != kNotUsed ||
+      body->taken != header->id || body->fall_through != NullBasicBlockId ||
+      body->predecessors->Size() != 1u || header->predecessors->Size() != 2u) {
+    return false;
+  }
+  BasicBlockId pre_header_id = header->predecessors->Get(0);
+  if (pre_header_id == body->id) {
+    pre_header_id = header->predecessors->Get(1);
+  } else if (header->predecessors->Get(1) != body->id) {
+    return false;
+  }
+  loop->pre_header = GetBasicBlock(pre_header_id);
+  loop->header = header;
+  loop->body = body;
+
+  // Header: at most two phis (induction and sum), an optional array-length and the exit test.
+  MIR* phis[2] = { nullptr, nullptr };
+  size_t num_phis = 0u;
+  loop->array_length = nullptr;
+  loop->exit_test = nullptr;
+  for (MIR* mir = NextNonNopMIR(header->first_mir_insn); mir != nullptr;
+       mir = NextNonNopMIR(mir->next)) {
+    int opcode = mir->dalvikInsn.opcode;
+    if (loop->exit_test != nullptr) {
+      return false;
+    } else if (opcode == kMirOpPhi && num_phis != arraysize(phis) &&
+               mir->ssa_rep->num_uses == 2) {
+      phis[num_phis++] = mir;
+    } else if (opcode == Instruction::ARRAY_LENGTH && loop->array_length == nullptr) {
+      loop->array_length = mir;
+    } else if ((opcode == Instruction::IF_GE && header->fall_through == body->id) ||
+               (opcode == Instruction::IF_LT && header->taken == body->id)) {
+      loop->exit_test = mir;
+    } else {
+      return false;
+    }
+  }
+  if (loop->exit_test == nullptr) {
+    return false;
+  }
+
+  // The induction variable starts at a non-negative constant and is compared to the length.
+  int index_sreg = loop->exit_test->ssa_rep->uses[0];
+  int length_sreg = loop->exit_test->ssa_rep->uses[1];
+  MIR* index_phi = nullptr;
+  MIR* sum_phi = nullptr;
+  for (size_t i = 0u; i != num_phis; ++i) {
+    if (phis[i]->ssa_rep->defs[0] == index_sreg) {
+      index_phi = phis[i];
+    } else {
+      sum_phi = phis[i];
+    }
+  }
+  if (index_phi == nullptr) {
+    return false;
+  }
+  int index_init_sreg = PhiInput(index_phi, pre_header_id);
+  if (index_init_sreg == INVALID_SREG || !IsConst(index_init_sreg) ||
+      ConstantValue(index_init_sreg) < 0) {
+    return false;
+  }
+
+  // The bound must be the length of the loop invariant array that we access.
+  MIR* length_def = loop->array_length;
+  if (length_def == nullptr) {
+    AllNodesIterator iter(this);
+    for (BasicBlock* bb = iter.Next(); bb != nullptr && length_def == nullptr; bb = iter.Next()) {
+      for (MIR* mir = bb->first_mir_insn; mir != nullptr; mir = mir->next) {
+        if (mir->ssa_rep != nullptr && mir->ssa_rep->num_defs != 0 &&
+            mir->ssa_rep->defs[0] == length_sreg) {
+          length_def = mir;
+          break;
+        }
+      }
+    }
+  }
+  if (length_def == nullptr || length_def->dalvikInsn.opcode != Instruction::ARRAY_LENGTH ||
+      length_def->ssa_rep->defs[0] != length_sreg) {
+    return false;
+  }
+  int array_sreg = length_def->ssa_rep->uses[0];
+  if (IsDefinedIn(header, array_sreg) || IsDefinedIn(body, array_sreg)) {
+    return false;
+  }
+  loop->array_vreg = SRegToVReg(array_sreg);
+  loop->index_vreg = SRegToVReg(index_sreg);
+  loop->length_vreg = SRegToVReg(length_sreg);
+
+  // Body: the load.
+  MIR* mir = NextNonNopMIR(body->first_mir_insn);
+  if (mir == nullptr || mir->ssa_rep->num_uses != 2 ||
+      mir->ssa_rep->uses[0] != array_sreg || mir->ssa_rep->uses[1] != index_sreg) {
+    return false;
+  }
+  Instruction::Code aput_opcode;
+  switch (mir->dalvikInsn.opcode) {
+    case Instruction::AGET:
+      aput_opcode = Instruction::APUT;
+      loop->lane_size = k32;
+      loop->lanes = 4;
+      break;
+    case Instruction::AGET_CHAR:
+    case Instruction::AGET_SHORT:
+      // Only the low 16 bits of each result are stored, so char and short share signed lanes.
+      aput_opcode = (mir->dalvikInsn.opcode == Instruction::AGET_CHAR) ? Instruction::APUT_CHAR
+                                                                       : Instruction::APUT_SHORT;
+      loop->lane_size = kSignedHalf;
+      loop->lanes = 8;
+      break;
+    case Instruction::AGET_BYTE:
+      aput_opcode = Instruction::APUT_BYTE;
+      loop->lane_size = kSignedByte;
+      loop->lanes = 16;
+      break;
+    default:
+      return false;
+  }
+  loop->aget = mir;
+  loop->scratch_vreg = mir->dalvikInsn.vA;
+  int value_sreg = mir->ssa_rep->defs[0];
+
+  // Body: the chain of lane-wise operations.
+  loop->num_ops = 0u;
+  loop->terminal = nullptr;
+  for (mir = NextNonNopMIR(mir->next); mir != nullptr; mir = NextNonNopMIR(mir->next)) {
+    Instruction::Code opcode = mir->dalvikInsn.opcode;
+    if (opcode == aput_opcode ||
+        (sum_phi != nullptr &&
+         (opcode == Instruction::ADD_INT || opcode == Instruction::ADD_INT_2ADDR) &&
+         (mir->ssa_rep->uses[0] == sum_phi->ssa_rep->defs[0] ||
+          mir->ssa_rep->uses[1] == sum_phi->ssa_rep->defs[0]))) {
+      loop->terminal = mir;
+      break;
+    }
+    if ((loop->lane_size == kSignedByte && opcode == Instruction::INT_TO_BYTE) ||
+        (loop->lane_size == kSignedHalf &&
+         (opcode == Instruction::INT_TO_CHAR || opcode == Instruction::INT_TO_SHORT))) {
+      // Truncation to the lane width is implicit in packed arithmetic.
+      if (mir->ssa_rep->uses[0] != value_sreg) {
+        return false;
+      }
+      value_sreg = mir->ssa_rep->defs[0];
+      continue;
+    }
+    int packed_opcode = PackedOpcodeFor(opcode);
+    if (packed_opcode == kMirOpLast || loop->num_ops == VectorizableLoop::kMaxOps) {
+      return false;
+    }
+    bool is_shift = (packed_opcode == kMirOpPackedShiftLeft ||
+                     packed_opcode == kMirOpPackedSignedShiftRight ||
+                     packed_opcode == kMirOpPackedUnsignedShiftRight);
+    // Narrow lanes only support operations whose low bits depend only on the low bits of
+    // the operands, and the backend's byte shift emulation is not exact.
+    if (is_shift && (loop->lane_size == kSignedByte ||
+                     (loop->lane_size == kSignedHalf && packed_opcode != kMirOpPackedShiftLeft))) {
+      return false;
+    }
+    VectorizableLoop::Op* op = &loop->ops[loop->num_ops];
+    op->opcode = static_cast<ExtendedMIROpcode>(packed_opcode);
+    op->offset = mir->offset;
+    if (IsLiteralOp(opcode)) {
+      if (mir->ssa_rep->uses[0] != value_sreg) {
+        return false;
+      }
+      op->is_constant = true;
+      op->constant = static_cast<int32_t>(mir->dalvikInsn.vC);
+    } else {
+      bool commutative = !is_shift && packed_opcode != kMirOpPackedSubtract;
+      int other_sreg;
+      if (mir->ssa_rep->uses[0] == value_sreg) {
+        other_sreg = mir->ssa_rep->uses[1];
+      } else if (commutative && mir->ssa_rep->uses[1] == value_sreg) {
+        other_sreg = mir->ssa_rep->uses[0];
+      } else {
+        return false;
+      }
+      op->is_constant = IsConst(other_sreg);
+      if (op->is_constant) {
+        op->constant = ConstantValue(other_sreg);
+      } else if (!is_shift && !IsDefinedIn(header, other_sreg) && !IsDefinedIn(body, other_sreg)) {
+        op->operand_vreg = SRegToVReg(other_sreg);
+      } else {
+        return false;
+      }
+    }
+    if (is_shift) {
+      op->constant &= 31;
+    }
+    ++loop->num_ops;
+    value_sreg = mir->ssa_rep->defs[0];
+  }
+
+  // Body: the store or the reduction.
+  if (loop->terminal == nullptr) {
+    return false;
+  }
+  if (loop->terminal->dalvikInsn.opcode == aput_opcode) {
+    if (sum_phi != nullptr || loop->num_ops == 0u ||
+        loop->terminal->ssa_rep->uses[0] != value_sreg ||
+        loop->terminal->ssa_rep->uses[1] != array_sreg ||
+        loop->terminal->ssa_rep->uses[2] != index_sreg) {
+      return false;
+    }
+    loop->sum_vreg = -1;
+  } else {
+    // Only 32-bit sums are exact: narrow elements are widened before they are added.
+    int sum_sreg = sum_phi->ssa_rep->defs[0];
+    const int32_t* uses = loop->terminal->ssa_rep->uses;
+    if (loop->lane_size != k32 ||
+        !((uses[0] == sum_sreg && uses[1] == value_sreg) ||
+          (uses[0] == value_sreg && uses[1] == sum_sreg)) ||
+        loop->terminal->ssa_rep->defs[0] != PhiInput(sum_phi, body->id)) {
+      return false;
+    }
+    loop->sum_vreg = SRegToVReg(sum_sreg);
+  }
+
+  // Body: the increment and the back edge.
+  mir = NextNonNopMIR(loop->terminal->next);
+  if (mir == nullptr ||
+      (mir->dalvikInsn.opcode != Instruction::ADD_INT_LIT8 &&
+       mir->dalvikInsn.opcode != Instruction::ADD_INT_LIT16) ||
+      mir->ssa_rep->uses[0] != index_sreg || static_cast<int32_t>(mir->dalvikInsn.vC) != 1 ||
+      mir->ssa_rep->defs[0] != PhiInput(index_phi, body->id)) {
+    return false;
+  }
+  loop->increment = mir;
+  mir = NextNonNopMIR(mir->next);
+  if (mir == nullptr || NextNonNopMIR(mir->next) != nullptr ||
+      (mir->dalvikInsn.opcode != Instruction::GOTO &&
+       mir->dalvikInsn.opcode != Instruction::GOTO_16 &&
+       mir->dalvikInsn.opcode != Instruction::GOTO_32)) {
+    return false;
+  }
+  loop->back_edge = mir;
+  return true;
+}
+
+void MIRGraph::VectorizeLoop(const VectorizableLoop& loop) {
+  BasicBlock* header = loop.header;
+  BasicBlock* vector_header = CreateNewBB(kDalvikByteCode);
+  BasicBlock* vector_body = CreateNewBB(kDalvikByteCode);
+  vector_header->start_offset = header->start_offset;
+  vector_header->nesting_depth = header->nesting_depth;
+  vector_header->conditional_branch = true;
+  vector_header->use_lvn = header->use_lvn;
+  vector_body->start_offset = loop.body->start_offset;
+  vector_body->nesting_depth = loop.body->nesting_depth;
+  vector_body->use_lvn = loop.body->use_lvn;
+
+  // Route the loop entry through the vector loop: pre_header -> VH -> (VB -> VH | H).
+  loop.pre_header->ReplaceChild(header->id, vector_header->id);
+  header->UpdatePredecessor(loop.pre_header->id, vector_header->id);
+  vector_header->predecessors->Insert(loop.pre_header->id);
+  vector_header->predecessors->Insert(vector_body->id);
+  vector_header->fall_through = vector_body->id;
+  vector_header->taken = header->id;
+  vector_body->predecessors->Insert(vector_header->id);
+  vector_body->taken = vector_header->id;
+
+  // VH: enter the vector body only if elements [i, i + W - 1] are all in bounds.
+  if (loop.array_length != nullptr) {
+    vector_header->AppendMIR(loop.array_length->Copy(this));
+  }
+  MIR* limit = NewMIR();
+  limit->dalvikInsn.opcode = Instruction::ADD_INT_LIT8;
+  limit->dalvikInsn.vA = loop.scratch_vreg;
+  limit->dalvikInsn.vB = loop.length_vreg;
+  limit->dalvikInsn.vC = static_cast<uint32_t>(-(loop.lanes - 1));
+  limit->offset = loop.exit_test->offset;
+  vector_header->AppendMIR(limit);
+  MIR* test = NewMIR();
+  test->dalvikInsn.opcode = Instruction::IF_GE;
+  test->dalvikInsn.vA = loop.index_vreg;
+  test->dalvikInsn.vB = loop.scratch_vreg;
+  test->offset = loop.exit_test->offset;
+  // The scratch vreg may hold a non-reference where the verifier expects one at this dex pc.
+  test->optimization_flags = MIR_IGNORE_SUSPEND_CHECK;
+  vector_header->AppendMIR(test);
+
+  // VB: vector register 0 holds the elements, vector register 1 the current operand.
+  uint32_t type_size = (static_cast<uint32_t>(loop.lane_size) << 16) | 128u;
+  MIR* reserve = NewMIR();
+  reserve->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpReserveVectorRegisters);
+  reserve->dalvikInsn.vA = 2u;
+  reserve->offset = loop.aget->offset;
+  vector_body->AppendMIR(reserve);
+  MIR* load = NewMIR();
+  load->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpPackedArrayGet);
+  load->dalvikInsn.vA = 0u;
+  load->dalvikInsn.vB = loop.array_vreg;
+  load->dalvikInsn.vC = loop.index_vreg;
+  load->dalvikInsn.arg[0] = type_size;
+  load->offset = loop.aget->offset;
+  vector_body->AppendMIR(load);
+  for (size_t i = 0u; i != loop.num_ops; ++i) {
+    const VectorizableLoop::Op& op = loop.ops[i];
+    MIR* packed = NewMIR();
+    packed->dalvikInsn.opcode = static_cast<Instruction::Code>(op.opcode);
+    packed->dalvikInsn.vA = 0u;
+    packed->dalvikInsn.vC = type_size;
+    packed->offset = op.offset;
+    if (op.opcode == kMirOpPackedShiftLeft || op.opcode == kMirOpPackedSignedShiftRight ||
+        op.opcode == kMirOpPackedUnsignedShiftRight) {
+      packed->dalvikInsn.vB = op.constant;
+    } else {
+      MIR* operand = NewMIR();
+      operand->dalvikInsn.vA = 1u;
+      operand->offset = op.offset;
+      if (op.is_constant) {
+        uint32_t value = static_cast<uint32_t>(op.constant);
+        if (loop.lane_size == kSignedHalf) {
+          value = (value & 0xffffu) * 0x00010001u;
+        } else if (loop.lane_size == kSignedByte) {
+          value = (value & 0xffu) * 0x01010101u;
+        }
+        operand->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpConstVector);
+        operand->dalvikInsn.vB = type_size;
+        for (size_t j = 0u; j != 4u; ++j) {
+          operand->dalvikInsn.arg[j] = value;
+        }
+      } else {
+        operand->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpPackedSet);
+        operand->dalvikInsn.vB = op.operand_vreg;
+        operand->dalvikInsn.vC = type_size;
+      }
+      vector_body->AppendMIR(operand);
+      packed->dalvikInsn.vB = 1u;
+    }
+    vector_body->AppendMIR(packed);
+  }
+  MIR* result = NewMIR();
+  if (loop.sum_vreg < 0) {
+    result->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpPackedArrayPut);
+    result->dalvikInsn.vA = 0u;
+    result->dalvikInsn.vB = loop.array_vreg;
+    result->dalvikInsn.vC = loop.index_vreg;
+    result->dalvikInsn.arg[0] = type_size;
+  } else {
+    result->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpPackedAddReduce);
+    result->dalvikInsn.vA = loop.sum_vreg;
+    result->dalvikInsn.vB = 0u;
+    result->dalvikInsn.vC = type_size;
+  }
+  result->offset = loop.terminal->offset;
+  vector_body->AppendMIR(result);
+  MIR* release = NewMIR();
+  release->dalvikInsn.opcode = static_cast<Instruction::Code>(kMirOpReturnVectorRegisters);
+  release->offset = loop.terminal->offset;
+  vector_body->AppendMIR(release);
+  MIR* step = NewMIR();
+  step->dalvikInsn.opcode = Instruction::ADD_INT_LIT8;
+  step->dalvikInsn.vA = loop.index_vreg;
+  step->dalvikInsn.vB = loop.index_vreg;
+  step->dalvikInsn.vC = loop.lanes;
+  step->offset = loop.increment->offset;
+  vector_body->AppendMIR(step);
+  vector_body->AppendMIR(loop.back_edge->Copy(this));
+
+  if (cu_->verbose) {
+    LOG(INFO) << "Vectorized loop at 0x" << std::hex << header->start_offset << " in "
+              << PrettyMethod(cu_->method_idx, *cu_->dex_file) << " with " << std::dec
+              << loop.lanes << " lanes";
+  }
+}
+
 }  // namespace art
@@ -16,10 +16,12 @@
 
 #include <vector>
 
+#include "common_runtime_test.h"
 #include "compiler_internals.h"
 #include "dataflow_iterator.h"
 #include "dataflow_iterator-inl.h"
 #include "gtest/gtest.h"
+#include "scoped_thread_state_change.h"
 
 namespace art {
 
@@ -219,6 +221,246 @@ class ClassInitCheckEliminationTest : public testing::Test {
   DexFile::CodeItem* code_item_;
 };
 
+class LoopOptimizationTest : public testing::Test {
+ protected:
+  struct IFieldDef {
+    uint16_t field_idx;
+    uintptr_t declaring_dex_file;
+    uint16_t declaring_field_idx;
+    bool is_final;
+  };
+
+  struct BBDef {
+    static constexpr size_t kMaxSuccessors = 4;
+    static constexpr size_t kMaxPredecessors = 4;
+
+    BBType type;
+    size_t num_successors;
+    BasicBlockId successors[kMaxPredecessors];
+    size_t num_predecessors;
+    BasicBlockId predecessors[kMaxPredecessors];
+  };
+
+  struct MIRDef {
+    static constexpr size_t kMaxSsaDefs = 2;
+    static constexpr size_t kMaxSsaUses = 4;
+
+    BasicBlockId bbid;
+    Instruction::Code opcode;
+    int32_t value;
+    uint32_t field_info;
+    size_t num_uses;
+    int32_t uses[kMaxSsaUses];
+    size_t num_defs;
+    int32_t defs[kMaxSsaDefs];
+  };
+
+#define DEF_CONST(bb, opcode, reg, value) \
+    { bb, opcode, value, 0u, 0, { }, 1, { reg } }
+#define DEF_BINOP_LIT(bb, opcode, reg, src, value) \
+    { bb, opcode, value, 0u, 1, { src }, 1, { reg } }
+#define DEF_BINOP(bb, opcode, reg, src1, src2) \
+    { bb, opcode, 0, 0u, 2, { src1, src2 }, 1, { reg } }
+#define DEF_UNOP(bb, opcode, reg, src) \
+    { bb, opcode, 0, 0u, 1, { src }, 1, { reg } }
+#define DEF_IGET(bb, opcode, reg, obj, field_info) \
+    { bb, opcode, 0, field_info, 1, { obj }, 1, { reg } }
+#define DEF_ARRAY_LENGTH(bb, reg, obj) \
+    { bb, Instruction::ARRAY_LENGTH, 0, 0u, 1, { obj }, 1, { reg } }
+#define DEF_AGET(bb, opcode, reg, obj, idx) \
+    { bb, opcode, 0, 0u, 2, { obj, idx }, 1, { reg } }
+#define DEF_APUT(bb, opcode, reg, obj, idx) \
+    { bb, opcode, 0, 0u, 3, { reg, obj, idx }, 0, { } }
+#define DEF_IF(bb, opcode, src1, src2) \
+    { bb, opcode, 0, 0u, 2, { src1, src2 }, 0, { } }
+#define DEF_IFZ(bb, opcode, src) \
+    { bb, opcode, 0, 0u, 1, { src }, 0, { } }
+#define DEF_GOTO(bb) \
+    { bb, Instruction::GOTO, 0, 0u, 0, { }, 0, { } }
+#define DEF_PHI2(bb, reg, src1, src2) \
+    { bb, static_cast<Instruction::Code>(kMirOpPhi), 0, 0u, 2u, { src1, src2 }, 1, { reg } }
+
+  void DoPrepareIFields(const IFieldDef* defs, size_t count) {
+    cu_.mir_graph->ifield_lowering_infos_.Reset();
+    cu_.mir_graph->ifield_lowering_infos_.Resize(count);
+    for (size_t i = 0u; i != count; ++i) {
+      const IFieldDef* def = &defs[i];
+      MirIFieldLoweringInfo field_info(def->field_idx);
+      if (def->declaring_dex_file != 0u) {
+        field_info.declaring_dex_file_ = reinterpret_cast<const DexFile*>(def->declaring_dex_file);
+        field_info.declaring_field_idx_ = def->declaring_field_idx;
+        field_info.flags_ = MirIFieldLoweringInfo::kFlagFastGet |
+            MirIFieldLoweringInfo::kFlagFastPut |
+            (def->is_final ? MirIFieldLoweringInfo::kFlagIsFinal : 0u);
+      }
+      cu_.mir_graph->ifield_lowering_infos_.Insert(field_info);
+    }
+  }
+
+  template <size_t count>
+  void PrepareIFields(const IFieldDef (&defs)[count]) {
+    DoPrepareIFields(defs, count);
+  }
+
+  void DoPrepareBasicBlocks(const BBDef* defs, size_t count) {
+    cu_.mir_graph->block_id_map_.clear();
+    cu_.mir_graph->block_list_.Reset();
+    ASSERT_LT(3u, count);  // null, entry, exit and at least one bytecode block.
+    ASSERT_EQ(kNullBlock, defs[0].type);
+    ASSERT_EQ(kEntryBlock, defs[1].type);
+    ASSERT_EQ(kExitBlock, defs[2].type);
+    for (size_t i = 0u; i != count; ++i) {
+      const BBDef* def = &defs[i];
+      BasicBlock* bb = cu_.mir_graph->NewMemBB(def->type, i);
+      cu_.mir_graph->block_list_.Insert(bb);
+      ASSERT_LE(def->num_successors, 2u);
+      bb->successor_block_list_type = kNotUsed;
+      bb->successor_blocks = nullptr;
+      bb->fall_through = (def->num_successors >= 1) ? def->successors[0] : 0u;
+      bb->taken = (def->num_successors >= 2) ? def->successors[1] : 0u;
+      bb->predecessors = new (&cu_.arena) GrowableArray<BasicBlockId>(
+          &cu_.arena, def->num_predecessors, kGrowableArrayPredecessors);
+      for (size_t j = 0u; j != def->num_predecessors; ++j) {
+        ASSERT_NE(0u, def->predecessors[j]);
+        bb->predecessors->Insert(def->predecessors[j]);
+      }
+      if (def->type == kDalvikByteCode || def->type == kEntryBlock || def->type == kExitBlock) {
+        bb->data_flow_info = static_cast<BasicBlockDataFlow*>(
+            cu_.arena.Alloc(sizeof(BasicBlockDataFlow), kArenaAllocDFInfo));
+      }
+    }
+    cu_.mir_graph->num_blocks_ = count;
+    ASSERT_EQ(count, cu_.mir_graph->block_list_.Size());
+    cu_.mir_graph->entry_block_ = cu_.mir_graph->block_list_.Get(1);
+    ASSERT_EQ(kEntryBlock, cu_.mir_graph->entry_block_->block_type);
+    cu_.mir_graph->exit_block_ = cu_.mir_graph->block_list_.Get(2);
+    ASSERT_EQ(kExitBlock, cu_.mir_graph->exit_block_->block_type);
+  }
+
+  template <size_t count>
+  void PrepareBasicBlocks(const BBDef (&defs)[count]) {
+    DoPrepareBasicBlocks(defs, count);
+  }
+
+  void DoPrepareMIRs(const MIRDef* defs, size_t count) {
+    mir_count_ = count;
+    mirs_ = reinterpret_cast<MIR*>(cu_.arena.Alloc(sizeof(MIR) * count, kArenaAllocMIR));
+    ssa_reps_.resize(count);
+    uint64_t merged_df_flags = 0u;
+    for (size_t i = 0u; i != count; ++i) {
+      const MIRDef* def = &defs[i];
+      MIR* mir = &mirs_[i];
+      ASSERT_LT(def->bbid, cu_.mir_graph->block_list_.Size());
+      BasicBlock* bb = cu_.mir_graph->block_list_.Get(def->bbid);
+      bb->AppendMIR(mir);
+      mir->dalvikInsn.opcode = def->opcode;
+      mir->dalvikInsn.vB = def->value;
+      mir->dalvikInsn.vC = def->value;
+      if (def->opcode >= Instruction::IGET && def->opcode <= Instruction::IPUT_SHORT) {
+        ASSERT_LT(def->field_info, cu_.mir_graph->ifield_lowering_infos_.Size());
+        mir->meta.ifield_lowering_info = def->field_info;
+      } else if (def->opcode == static_cast<Instruction::Code>(kMirOpPhi)) {
+        mir->meta.phi_incoming = static_cast<BasicBlockId*>(
+            cu_.arena.Alloc(def->num_uses * sizeof(BasicBlockId), kArenaAllocDFInfo));
+        for (size_t j = 0; j != def->num_uses; ++j) {
+          mir->meta.phi_incoming[j] = bb->predecessors->Get(j);
+        }
+      } else if (def->opcode == Instruction::CONST_4 || def->opcode == Instruction::CONST_16) {
+        cu_.mir_graph->SetConstant(def->defs[0], def->value);
+      }
+      mir->ssa_rep = &ssa_reps_[i];
+      mir->ssa_rep->num_uses = def->num_uses;
+      mir->ssa_rep->uses = const_cast<int32_t*>(def->uses);  // Not modified by the passes.
+      mir->ssa_rep->fp_use = nullptr;
+      mir->ssa_rep->num_defs = def->num_defs;
+      mir->ssa_rep->defs = const_cast<int32_t*>(def->defs);  // Not modified by the passes.
+      mir->ssa_rep->fp_def = nullptr;
+      mir->offset = 2 * i;  // All insns need to be at least 2 code units long.
+      mir->optimization_flags = 0u;
+      if (!MIR::DecodedInstruction::IsPseudoMirOp(def->opcode)) {
+        merged_df_flags |= MIRGraph::GetDataFlowAttributes(def->opcode);
+      }
+    }
+    mirs_[count - 1u].next = nullptr;
+    cu_.mir_graph->merged_df_flags_ = merged_df_flags;
+  }
+
+  template <size_t count>
+  void PrepareMIRs(const MIRDef (&defs)[count]) {
+    DoPrepareMIRs(defs, count);
+  }
+
+  void ComputeLoopInformation() {
+    cu_.mir_graph->SSATransformationStart();
+    cu_.mir_graph->ComputeDFSOrders();
+    cu_.mir_graph->ComputeDominators();
+    cu_.mir_graph->ComputeTopologicalSortOrder();
+    cu_.mir_graph->SSATransformationEnd();
+  }
+
+  void PerformRangeCheckElimination() {
+    ComputeLoopInformation();
+    ASSERT_TRUE(cu_.mir_graph->EliminateRangeChecksGate());
+    cu_.mir_graph->EliminateRangeChecks();
+  }
+
+  void PerformLoopInvariantCodeMotion() {
+    ComputeLoopInformation();
+    ASSERT_TRUE(cu_.mir_graph->HoistLoopInvariantsGate());
+    cu_.mir_graph->HoistLoopInvariants();
+  }
+
+  // The gate needs a compiler driver targeting SSE4.1, so run the transformation directly and
+  // leave the SSA rebuild to the pass. Returns the number of vectorized loops.
+  size_t PerformLoopVectorization() {
+    ComputeLoopInformation();
+    return cu_.mir_graph->VectorizeInnermostLoops();
+  }
+
+  std::vector<int> GetOpcodes(BasicBlockId bb_id) {
+    std::vector<int> opcodes;
+    for (MIR* mir = cu_.mir_graph->GetBasicBlock(bb_id)->first_mir_insn; mir != nullptr;
+         mir = mir->next) {
+      opcodes.push_back(mir->dalvikInsn.opcode);
+    }
+    return opcodes;
+  }
+
+  // Make the Dalvik register of s_reg the same as the one of other_s_reg.
+  void ShareVReg(int s_reg, int other_s_reg) {
+    cu_.mir_graph->ssa_base_vregs_->Put(s_reg, cu_.mir_graph->ssa_base_vregs_->Get(other_s_reg));
+  }
+
+  LoopOptimizationTest()
+      : pool_(),
+        cu_(&pool_),
+        mir_count_(0u),
+        mirs_(nullptr),
+        ssa_reps_() {
+    cu_.mir_graph.reset(new MIRGraph(&cu_, &cu_.arena));
+    cu_.access_flags = kAccStatic;  // Don't let "this" interfere with this test.
+    // Bind each sreg to its own vreg unless the test says otherwise.
+    cu_.mir_graph->ssa_base_vregs_ = new (&cu_.arena) GrowableArray<int>(&cu_.arena, kMaxSsaRegs);
+    cu_.mir_graph->ssa_subscripts_ = new (&cu_.arena) GrowableArray<int>(&cu_.arena, kMaxSsaRegs);
+    for (unsigned int i = 0; i < kMaxSsaRegs; i++) {
+      cu_.mir_graph->ssa_base_vregs_->Insert(i);
+      cu_.mir_graph->ssa_subscripts_->Insert(0);
+    }
+    cu_.mir_graph->is_constant_v_ =
+        new (&cu_.arena) ArenaBitVector(&cu_.arena, kMaxSsaRegs, false);
+    cu_.mir_graph->constant_values_ =
+        static_cast<int*>(cu_.arena.Alloc(sizeof(int) * kMaxSsaRegs, kArenaAllocDFInfo));
+  }
+
+  static constexpr size_t kMaxSsaRegs = 64u;
+
+  ArenaPool pool_;
+  CompilationUnit cu_;
+  size_t mir_count_;
+  MIR* mirs_;
+  std::vector<SSARepresentation> ssa_reps_;
+};
+
 TEST_F(ClassInitCheckEliminationTest, SingleBlock) {
   static const SFieldDef sfields[] = {
       { 0u, 1u, 0u, 0u },
@@ -423,4 +665,604 @@ TEST_F(ClassInitCheckEliminationTest, Catch) {
   }
 }
 
+
+TEST_F(LoopOptimizationTest, RangeCheckCountingUp) {
+  static const BBDef bbs[] = {
+      DEF_BB(kNullBlock, DEF_SUCC0(), DEF_PRED0()),
+      DEF_BB(kEntryBlock, DEF_SUCC1(3), DEF_PRED0()),
+      DEF_BB(kExitBlock, DEF_SUCC0(), DEF_PRED1(6)),
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(4), DEF_PRED1(1)),     // Pre-header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC2(5, 6), DEF_PRED2(3, 5)),  // Header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(4), DEF_PRED1(4)),     // Body.
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(2), DEF_PRED1(4)),     // Loop exit.
+  };
+  // The array is in sreg 0, a method argument.
+  static const MIRDef mirs[] = {
+      DEF_CONST(3u, Instruction::CONST_4, 1u, 0),
+      DEF_PHI2(4u, 2u, 1u, 4u),
+      DEF_ARRAY_LENGTH(4u, 3u, 0u),
+      DEF_IF(4u, Instruction::IF_GE, 2u, 3u),
+      DEF_AGET(5u, Instruction::AGET, 5u, 0u, 2u),       // Range check eliminated.
+      DEF_APUT(5u, Instruction::APUT, 5u, 0u, 2u),       // Range check eliminated.
+      DEF_AGET(5u, Instruction::AGET, 6u, 0u, 5u),       // Not indexed by the IV.
+      DEF_AGET(5u, Instruction::AGET, 7u, 8u, 2u),       // Another array.
+      DEF_BINOP_LIT(5u, Instruction::ADD_INT_LIT8, 4u, 2u, 1),
+      DEF_GOTO(5u),
+      DEF_AGET(6u, Instruction::AGET, 9u, 0u, 2u),       // Outside the loop.
+  };
+  static const bool expected_ignore_range_check[] = {
+      false, false, false, false, true, true, false, false, false, false, false
+  };
+
+  PrepareBasicBlocks(bbs);
+  PrepareMIRs(mirs);
+  PerformRangeCheckElimination();
+  ASSERT_EQ(arraysize(expected_ignore_range_check), mir_count_);
+  for (size_t i = 0u; i != arraysize(mirs); ++i) {
+    EXPECT_EQ(expected_ignore_range_check[i],
+              (mirs_[i].optimization_flags & MIR_IGNORE_RANGE_CHECK) != 0) << i;
+  }
+}
+
+TEST_F(LoopOptimizationTest, RangeCheckCountingDown) {
+  static const BBDef bbs[] = {
+      DEF_BB(kNullBlock, DEF_SUCC0(), DEF_PRED0()),
+      DEF_BB(kEntryBlock, DEF_SUCC1(3), DEF_PRED0()),
+      DEF_BB(kExitBlock, DEF_SUCC0(), DEF_PRED1(6)),
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(4), DEF_PRED1(1)),     // Pre-header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC2(5, 6), DEF_PRED2(3, 5)),  // Header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(4), DEF_PRED1(4)),     // Body.
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(2), DEF_PRED1(4)),     // Loop exit.
+  };
+  static const MIRDef mirs[] = {
+      DEF_ARRAY_LENGTH(3u, 1u, 0u),
+      DEF_BINOP_LIT(3u, Instruction::ADD_INT_LIT8, 2u, 1u, -1),
+      DEF_PHI2(4u, 3u, 2u, 4u),
+      DEF_IFZ(4u, Instruction::IF_LTZ, 3u),
+      DEF_AGET(5u, Instruction::AGET, 5u, 0u, 3u),       // Range check eliminated.
+      DEF_BINOP_LIT(5u, Instruction::ADD_INT_LIT8, 4u, 3u, -1),
+      DEF_GOTO(5u),
+  };
+  static const bool expected_ignore_range_check[] = {
+      false, false, false, false, true, false, false
+  };
+
+  PrepareBasicBlocks(bbs);
+  PrepareMIRs(mirs);
+  PerformRangeCheckElimination();
+  ASSERT_EQ(arraysize(expected_ignore_range_check), mir_count_);
+  for (size_t i = 0u; i != arraysize(mirs); ++i) {
+    EXPECT_EQ(expected_ignore_range_check[i],
+              (mirs_[i].optimization_flags & MIR_IGNORE_RANGE_CHECK) != 0) << i;
+  }
+}
+
+TEST_F(LoopOptimizationTest, RangeCheckKept) {
+  static const BBDef bbs[] = {
+      DEF_BB(kNullBlock, DEF_SUCC0(), DEF_PRED0()),
+      DEF_BB(kEntryBlock, DEF_SUCC1(3), DEF_PRED0()),
+      DEF_BB(kExitBlock, DEF_SUCC0(), DEF_PRED1(6)),
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(4), DEF_PRED1(1)),     // Pre-header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC2(5, 6), DEF_PRED2(3, 5)),  // Header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(4), DEF_PRED1(4)),     // Body.
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(2), DEF_PRED1(4)),     // Loop exit.
+  };
+  static const MIRDef mirs[] = {
+      DEF_CONST(3u, Instruction::CONST_4, 1u, -1),       // Negative start.
+      DEF_PHI2(4u, 2u, 1u, 4u),
+      DEF_ARRAY_LENGTH(4u, 3u, 0u),
+      DEF_IF(4u, Instruction::IF_GE, 2u, 3u),
+      DEF_AGET(5u, Instruction::AGET, 5u, 0u, 2u),
+      DEF_BINOP_LIT(5u, Instruction::ADD_INT_LIT8, 4u, 2u, 1),
+      DEF_GOTO(5u),
+  };
+
+  PrepareBasicBlocks(bbs);
+  PrepareMIRs(mirs);
+  PerformRangeCheckElimination();
+  for (size_t i = 0u; i != arraysize(mirs); ++i) {
+    EXPECT_EQ(0u, mirs_[i].optimization_flags & MIR_IGNORE_RANGE_CHECK) << i;
+  }
+}
+
+TEST_F(LoopOptimizationTest, HoistFinalFieldAndLength) {
+  static const IFieldDef ifields[] = {
+      { 0u, 1u, 0u, true },
+      { 1u, 1u, 1u, false },
+  };
+  static const BBDef bbs[] = {
+      DEF_BB(kNullBlock, DEF_SUCC0(), DEF_PRED0()),
+      DEF_BB(kEntryBlock, DEF_SUCC1(3), DEF_PRED0()),
+      DEF_BB(kExitBlock, DEF_SUCC0(), DEF_PRED1(6)),
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(4), DEF_PRED1(1)),     // Pre-header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC2(5, 6), DEF_PRED2(3, 5)),  // Header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(4), DEF_PRED1(4)),     // Body.
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(2), DEF_PRED1(4)),     // Loop exit.
+  };
+  // The object is in sreg 0, a method argument.
+  static const MIRDef mirs[] = {
+      DEF_CONST(3u, Instruction::CONST_4, 1u, 0),
+      DEF_PHI2(4u, 2u, 1u, 4u),
+      DEF_IGET(4u, Instruction::IGET_OBJECT, 3u, 0u, 0u),  // Final field; hoisted.
+      DEF_ARRAY_LENGTH(4u, 5u, 3u),                       // Hoisted.
+      DEF_IGET(4u, Instruction::IGET, 6u, 0u, 1u),         // Not final; stays.
+      DEF_IF(4u, Instruction::IF_GE, 2u, 5u),
+      DEF_AGET(5u, Instruction::AGET, 7u, 3u, 2u),
+      DEF_BINOP_LIT(5u, Instruction::ADD_INT_LIT8, 4u, 2u, 1),
+      DEF_GOTO(5u),
+  };
+  static const BasicBlockId expected_bb[] = {
+      3u, 4u, 3u, 3u, 4u, 4u, 5u, 5u, 5u
+  };
+
+  PrepareIFields(ifields);
+  PrepareBasicBlocks(bbs);
+  PrepareMIRs(mirs);
+  PerformLoopInvariantCodeMotion();
+  ASSERT_EQ(arraysize(expected_bb), mir_count_);
+  for (size_t i = 0u; i != arraysize(mirs); ++i) {
+    EXPECT_EQ(expected_bb[i], mirs_[i].bb) << i;
+  }
+  BasicBlock* pre_header = cu_.mir_graph->GetBasicBlock(3u);
+  EXPECT_EQ(&mirs_[0], pre_header->first_mir_insn);
+  EXPECT_EQ(&mirs_[2], mirs_[0].next);
+  EXPECT_EQ(&mirs_[3], mirs_[2].next);
+  EXPECT_EQ(&mirs_[3], pre_header->last_mir_insn);
+}
+
+TEST_F(LoopOptimizationTest, HoistBlockedByRegisterReuse) {
+  static const BBDef bbs[] = {
+      DEF_BB(kNullBlock, DEF_SUCC0(), DEF_PRED0()),
+      DEF_BB(kEntryBlock, DEF_SUCC1(3), DEF_PRED0()),
+      DEF_BB(kExitBlock, DEF_SUCC0(), DEF_PRED1(6)),
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(4), DEF_PRED1(1)),     // Pre-header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC2(5, 6), DEF_PRED2(3, 5)),  // Header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(4), DEF_PRED1(4)),     // Body.
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(2), DEF_PRED1(4)),     // Loop exit.
+  };
+  static const MIRDef mirs[] = {
+      DEF_CONST(3u, Instruction::CONST_4, 1u, 0),
+      DEF_PHI2(4u, 2u, 1u, 4u),
+      DEF_ARRAY_LENGTH(4u, 3u, 0u),
+      DEF_IF(4u, Instruction::IF_GE, 2u, 3u),
+      DEF_AGET(5u, Instruction::AGET, 5u, 0u, 2u),       // Writes the length's vreg.
+      DEF_BINOP_LIT(5u, Instruction::ADD_INT_LIT8, 4u, 2u, 1),
+      DEF_GOTO(5u),
+  };
+
+  PrepareBasicBlocks(bbs);
+  PrepareMIRs(mirs);
+  ShareVReg(5, 3);
+  PerformLoopInvariantCodeMotion();
+  EXPECT_EQ(4u, mirs_[2].bb);
+  EXPECT_EQ(&mirs_[2], mirs_[1].next);
+}
+
+// Loop body blocks end with a GOTO, so the header is their taken successor.
+#define DEF_LOOP_BBS() \
+    DEF_BB(kNullBlock, DEF_SUCC0(), DEF_PRED0()), \
+    DEF_BB(kEntryBlock, DEF_SUCC1(3), DEF_PRED0()), \
+    DEF_BB(kExitBlock, DEF_SUCC0(), DEF_PRED1(6)), \
+    DEF_BB(kDalvikByteCode, DEF_SUCC1(4), DEF_PRED1(1)),        /* Pre-header. */ \
+    DEF_BB(kDalvikByteCode, DEF_SUCC2(5, 6), DEF_PRED2(3, 5)),  /* Header. */ \
+    DEF_BB(kDalvikByteCode, DEF_SUCC2(0, 4), DEF_PRED1(4)),     /* Body. */ \
+    DEF_BB(kDalvikByteCode, DEF_SUCC1(2), DEF_PRED1(4))         /* Loop exit. */
+
+TEST_F(LoopOptimizationTest, VectorizeArrayUpdate) {
+  static const BBDef bbs[] = { DEF_LOOP_BBS() };
+  // The array is in sreg 0, a method argument. a[i] = a[i] * 3 + 5.
+  static const MIRDef mirs[] = {
+      DEF_CONST(3u, Instruction::CONST_4, 1u, 0),
+      DEF_CONST(3u, Instruction::CONST_4, 9u, 3),
+      DEF_PHI2(4u, 2u, 1u, 4u),
+      DEF_ARRAY_LENGTH(4u, 3u, 0u),
+      DEF_IF(4u, Instruction::IF_GE, 2u, 3u),
+      DEF_AGET(5u, Instruction::AGET, 5u, 0u, 2u),
+      DEF_BINOP(5u, Instruction::MUL_INT, 6u, 5u, 9u),
+      DEF_BINOP_LIT(5u, Instruction::ADD_INT_LIT8, 7u, 6u, 5),
+      DEF_APUT(5u, Instruction::APUT, 7u, 0u, 2u),
+      DEF_BINOP_LIT(5u, Instruction::ADD_INT_LIT8, 4u, 2u, 1),
+      DEF_GOTO(5u),
+  };
+
+  PrepareBasicBlocks(bbs);
+  PrepareMIRs(mirs);
+  mirs_[5].dalvikInsn.vA = 5u;  // The aget's destination is the scratch vreg.
+  ASSERT_EQ(1u, PerformLoopVectorization());
+
+  // pre-header -> VH -> (VB -> VH | H); H and B are left as the scalar post-loop.
+  const BasicBlockId vh_id = 7u;
+  const BasicBlockId vb_id = 8u;
+  BasicBlock* vh = cu_.mir_graph->GetBasicBlock(vh_id);
+  BasicBlock* vb = cu_.mir_graph->GetBasicBlock(vb_id);
+  ASSERT_TRUE(vh != nullptr);
+  ASSERT_TRUE(vb != nullptr);
+  EXPECT_EQ(vh_id, cu_.mir_graph->GetBasicBlock(3u)->fall_through);
+  EXPECT_EQ(vb_id, vh->fall_through);
+  EXPECT_EQ(4u, vh->taken);
+  EXPECT_EQ(vh_id, vb->taken);
+  EXPECT_EQ(NullBasicBlockId, vb->fall_through);
+  GrowableArray<BasicBlockId>* header_preds = cu_.mir_graph->GetBasicBlock(4u)->predecessors;
+  ASSERT_EQ(2u, header_preds->Size());
+  EXPECT_EQ(vh_id, header_preds->Get(0));
+  EXPECT_EQ(5u, header_preds->Get(1));
+
+  // VH: if (i >= length - 3) goto H.
+  static const int expected_vh[] = {
+      Instruction::ARRAY_LENGTH, Instruction::ADD_INT_LIT8, Instruction::IF_GE
+  };
+  EXPECT_EQ(std::vector<int>(expected_vh, expected_vh + arraysize(expected_vh)),
+            GetOpcodes(vh_id));
+  MIR* limit = vh->first_mir_insn->next;
+  EXPECT_EQ(5u, limit->dalvikInsn.vA);
+  EXPECT_EQ(3u, limit->dalvikInsn.vB);
+  EXPECT_EQ(-3, static_cast<int32_t>(limit->dalvikInsn.vC));
+  EXPECT_EQ(2u, limit->next->dalvikInsn.vA);
+  EXPECT_EQ(5u, limit->next->dalvikInsn.vB);
+
+  // VB: four lanes at a time, the operands in vector register 1.
+  static const int expected_vb[] = {
+      kMirOpReserveVectorRegisters, kMirOpPackedArrayGet,
+      kMirOpConstVector, kMirOpPackedMultiply,
+      kMirOpConstVector, kMirOpPackedAddition,
+      kMirOpPackedArrayPut, kMirOpReturnVectorRegisters,
+      Instruction::ADD_INT_LIT8, Instruction::GOTO
+  };
+  EXPECT_EQ(std::vector<int>(expected_vb, expected_vb + arraysize(expected_vb)),
+            GetOpcodes(vb_id));
+  const uint32_t type_size = (static_cast<uint32_t>(k32) << 16) | 128u;
+  MIR* load = vb->first_mir_insn->next;
+  EXPECT_EQ(0u, load->dalvikInsn.vB);
+  EXPECT_EQ(2u, load->dalvikInsn.vC);
+  EXPECT_EQ(type_size, load->dalvikInsn.arg[0]);
+  MIR* multiplier = load->next;
+  MIR* addend = multiplier->next->next;
+  for (size_t i = 0u; i != 4u; ++i) {
+    EXPECT_EQ(3u, multiplier->dalvikInsn.arg[i]);
+    EXPECT_EQ(5u, addend->dalvikInsn.arg[i]);
+  }
+  MIR* step = addend->next->next->next->next;
+  EXPECT_EQ(2u, step->dalvikInsn.vA);
+  EXPECT_EQ(4u, step->dalvikInsn.vC);
+}
+
+TEST_F(LoopOptimizationTest, VectorizeSum) {
+  static const BBDef bbs[] = { DEF_LOOP_BBS() };
+  // sum += a[i], with the array in sreg 0 and the length computed before the loop.
+  static const MIRDef mirs[] = {
+      DEF_CONST(3u, Instruction::CONST_4, 1u, 0),
+      DEF_CONST(3u, Instruction::CONST_4, 10u, 0),
+      DEF_ARRAY_LENGTH(3u, 3u, 0u),
+      DEF_PHI2(4u, 2u, 1u, 4u),
+      DEF_PHI2(4u, 11u, 10u, 12u),
+      DEF_IF(4u, Instruction::IF_GE, 2u, 3u),
+      DEF_AGET(5u, Instruction::AGET, 5u, 0u, 2u),
+      DEF_BINOP(5u, Instruction::ADD_INT_2ADDR, 12u, 11u, 5u),
+      DEF_BINOP_LIT(5u, Instruction::ADD_INT_LIT8, 4u, 2u, 1),
+      DEF_GOTO(5u),
+  };
+
+  PrepareBasicBlocks(bbs);
+  PrepareMIRs(mirs);
+  mirs_[6].dalvikInsn.vA = 5u;
+  ASSERT_EQ(1u, PerformLoopVectorization());
+
+  static const int expected_vh[] = { Instruction::ADD_INT_LIT8, Instruction::IF_GE };
+  EXPECT_EQ(std::vector<int>(expected_vh, expected_vh + arraysize(expected_vh)),
+            GetOpcodes(7u));
+  static const int expected_vb[] = {
+      kMirOpReserveVectorRegisters, kMirOpPackedArrayGet, kMirOpPackedAddReduce,
+      kMirOpReturnVectorRegisters, Instruction::ADD_INT_LIT8, Instruction::GOTO
+  };
+  EXPECT_EQ(std::vector<int>(expected_vb, expected_vb + arraysize(expected_vb)),
+            GetOpcodes(8u));
+  MIR* reduce = cu_.mir_graph->GetBasicBlock(8u)->first_mir_insn->next->next;
+  EXPECT_EQ(11u, reduce->dalvikInsn.vA);
+  EXPECT_EQ(0u, reduce->dalvikInsn.vB);
+}
+
+TEST_F(LoopOptimizationTest, VectorizeShortShiftLeft) {
+  static const BBDef bbs[] = { DEF_LOOP_BBS() };
+  // s[i] = (short) (s[i] << 2).
+  static const MIRDef mirs[] = {
+      DEF_CONST(3u, Instruction::CONST_4, 1u, 0),
+      DEF_PHI2(4u, 2u, 1u, 4u),
+      DEF_ARRAY_LENGTH(4u, 3u, 0u),
+      DEF_IF(4u, Instruction::IF_GE, 2u, 3u),
+      DEF_AGET(5u, Instruction::AGET_SHORT, 5u, 0u, 2u),
+      DEF_BINOP_LIT(5u, Instruction::SHL_INT_LIT8, 6u, 5u, 2),
+      DEF_UNOP(5u, Instruction::INT_TO_SHORT, 7u, 6u),
+      DEF_APUT(5u, Instruction::APUT_SHORT, 7u, 0u, 2u),
+      DEF_BINOP_LIT(5u, Instruction::ADD_INT_LIT8, 4u, 2u, 1),
+      DEF_GOTO(5u),
+  };
+
+  PrepareBasicBlocks(bbs);
+  PrepareMIRs(mirs);
+  mirs_[4].dalvikInsn.vA = 5u;
+  ASSERT_EQ(1u, PerformLoopVectorization());
+
+  // Eight lanes; the truncation is implicit and the shift amount is an immediate.
+  MIR* limit = cu_.mir_graph->GetBasicBlock(7u)->first_mir_insn->next;
+  EXPECT_EQ(-7, static_cast<int32_t>(limit->dalvikInsn.vC));
+  static const int expected_vb[] = {
+      kMirOpReserveVectorRegisters, kMirOpPackedArrayGet, kMirOpPackedShiftLeft,
+      kMirOpPackedArrayPut, kMirOpReturnVectorRegisters, Instruction::ADD_INT_LIT8,
+      Instruction::GOTO
+  };
+  EXPECT_EQ(std::vector<int>(expected_vb, expected_vb + arraysize(expected_vb)),
+            GetOpcodes(8u));
+  MIR* shift = cu_.mir_graph->GetBasicBlock(8u)->first_mir_insn->next->next;
+  EXPECT_EQ(2u, shift->dalvikInsn.vB);
+  EXPECT_EQ((static_cast<uint32_t>(kSignedHalf) << 16) | 128u, shift->dalvikInsn.vC);
+  EXPECT_EQ(8u, shift->next->next->next->dalvikInsn.vC);
+}
+
+TEST_F(LoopOptimizationTest, VectorizeRejectsNarrowRightShifts) {
+  static const BBDef bbs[] = { DEF_LOOP_BBS() };
+  // Right shifts would see the truncated lanes instead of the sign or zero extended values.
+  static const Instruction::Code kCases[][3] = {
+      { Instruction::AGET_SHORT, Instruction::SHR_INT_LIT8, Instruction::APUT_SHORT },
+      { Instruction::AGET_CHAR, Instruction::USHR_INT_LIT8, Instruction::APUT_CHAR },
+      { Instruction::AGET_BYTE, Instruction::SHR_INT_LIT8, Instruction::APUT_BYTE },
+      { Instruction::AGET_BYTE, Instruction::SHL_INT_LIT8, Instruction::APUT_BYTE },
+  };
+  for (const Instruction::Code (&codes)[3] : kCases) {
+    const MIRDef mirs[] = {
+        DEF_CONST(3u, Instruction::CONST_4, 1u, 0),
+        DEF_PHI2(4u, 2u, 1u, 4u),
+        DEF_ARRAY_LENGTH(4u, 3u, 0u),
+        DEF_IF(4u, Instruction::IF_GE, 2u, 3u),
+        DEF_AGET(5u, codes[0], 5u, 0u, 2u),
+        DEF_BINOP_LIT(5u, codes[1], 6u, 5u, 1),
+        DEF_APUT(5u, codes[2], 6u, 0u, 2u),
+        DEF_BINOP_LIT(5u, Instruction::ADD_INT_LIT8, 4u, 2u, 1),
+        DEF_GOTO(5u),
+    };
+    PrepareBasicBlocks(bbs);
+    PrepareMIRs(mirs);
+    EXPECT_EQ(0u, PerformLoopVectorization()) << codes[1];
+  }
+}
+
+TEST_F(LoopOptimizationTest, VectorizeRejectsMultipleArrays) {
+  static const BBDef bbs[] = { DEF_LOOP_BBS() };
+  // b[i] = a[i] + 1, with a in sreg 0 and b in sreg 8.
+  static const MIRDef mirs[] = {
+      DEF_CONST(3u, Instruction::CONST_4, 1u, 0),
+      DEF_PHI2(4u, 2u, 1u, 4u),
+      DEF_ARRAY_LENGTH(4u, 3u, 0u),
+      DEF_IF(4u, Instruction::IF_GE, 2u, 3u),
+      DEF_AGET(5u, Instruction::AGET, 5u, 0u, 2u),
+      DEF_BINOP_LIT(5u, Instruction::ADD_INT_LIT8, 6u, 5u, 1),
+      DEF_APUT(5u, Instruction::APUT, 6u, 8u, 2u),
+      DEF_BINOP_LIT(5u, Instruction::ADD_INT_LIT8, 4u, 2u, 1),
+      DEF_GOTO(5u),
+  };
+
+  PrepareBasicBlocks(bbs);
+  PrepareMIRs(mirs);
+  EXPECT_EQ(0u, PerformLoopVectorization());
+  EXPECT_EQ(4u, cu_.mir_graph->GetBasicBlock(3u)->fall_through);
+}
+
+TEST_F(LoopOptimizationTest, VectorizeOnlyInnermostLoop) {
+  static const BBDef bbs[] = {
+      DEF_BB(kNullBlock, DEF_SUCC0(), DEF_PRED0()),
+      DEF_BB(kEntryBlock, DEF_SUCC1(3), DEF_PRED0()),
+      DEF_BB(kExitBlock, DEF_SUCC0(), DEF_PRED1(9)),
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(4), DEF_PRED1(1)),     // Outer pre-header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC2(5, 9), DEF_PRED2(3, 8)),  // Outer header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(6), DEF_PRED1(4)),     // Inner pre-header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC2(7, 8), DEF_PRED2(5, 7)),  // Inner header.
+      DEF_BB(kDalvikByteCode, DEF_SUCC2(0, 6), DEF_PRED1(6)),  // Inner body.
+      DEF_BB(kDalvikByteCode, DEF_SUCC2(0, 4), DEF_PRED1(6)),  // Outer latch.
+      DEF_BB(kDalvikByteCode, DEF_SUCC1(2), DEF_PRED1(4)),     // Loop exit.
+  };
+  // for (j = 0; j < a.length; ++j) { for (i = 0; i < a.length; ++i) { a[i] += 1; } }
+  static const MIRDef mirs[] = {
+      DEF_CONST(3u, Instruction::CONST_4, 1u, 0),
+      DEF_PHI2(4u, 2u, 1u, 20u),
+      DEF_ARRAY_LENGTH(4u, 3u, 0u),
+      DEF_IF(4u, Instruction::IF_GE, 2u, 3u),
+      DEF_CONST(5u, Instruction::CONST_4, 11u, 0),
+      DEF_PHI2(6u, 12u, 11u, 14u),
+      DEF_ARRAY_LENGTH(6u, 13u, 0u),
+      DEF_IF(6u, Instruction::IF_GE, 12u, 13u),
+      DEF_AGET(7u, Instruction::AGET, 15u, 0u, 12u),
+      DEF_BINOP_LIT(7u, Instruction::ADD_INT_LIT8, 16u, 15u, 1),
+      DEF_APUT(7u, Instruction::APUT, 16u, 0u, 12u),
+      DEF_BINOP_LIT(7u, Instruction::ADD_INT_LIT8, 14u, 12u, 1),
+      DEF_GOTO(7u),
+      DEF_BINOP_LIT(8u, Instruction::ADD_INT_LIT8, 20u, 2u, 1),
+      DEF_GOTO(8u),
+  };
+
+  PrepareBasicBlocks(bbs);
+  PrepareMIRs(mirs);
+  mirs_[8].dalvikInsn.vA = 15u;
+  ASSERT_EQ(1u, PerformLoopVectorization());
+  // The vector loop is entered from the inner pre-header and exits to the inner header.
+  const BasicBlockId vh_id = 10u;
+  EXPECT_EQ(4u, cu_.mir_graph->GetBasicBlock(3u)->fall_through);
+  EXPECT_EQ(vh_id, cu_.mir_graph->GetBasicBlock(5u)->fall_through);
+  EXPECT_EQ(6u, cu_.mir_graph->GetBasicBlock(vh_id)->taken);
+}
+
+class MethodInliningTest : public CommonRuntimeTest {
+ protected:
+  static constexpr uint32_t kNumCallerRegs = 3u;
+
+  MethodInliningTest() : pool_(), cu_(&pool_), dex_file_(nullptr), invoke_(nullptr) {
+  }
+
+  void SetUp() OVERRIDE {
+    CommonRuntimeTest::SetUp();
+    {
+      ScopedObjectAccess soa(Thread::Current());
+      dex_file_ = OpenTestDexFile("MethodInlining");
+    }
+    ASSERT_TRUE(dex_file_ != nullptr);
+    cu_.dex_file = dex_file_;
+    ASSERT_NO_FATAL_FAILURE(
+        FindMethod("caller", &cu_.method_idx, &cu_.code_item, &cu_.access_flags));
+    cu_.num_dalvik_registers = kNumCallerRegs;
+    cu_.mir_graph.reset(new MIRGraph(&cu_, &cu_.arena));
+    ASSERT_TRUE(cu_.mir_graph->SetMaxAvailableNonSpecialCompilerTemps(16u));
+  }
+
+  void FindMethod(const char* name, uint32_t* method_idx, const DexFile::CodeItem** code_item,
+                  uint32_t* access_flags) {
+    const DexFile::ClassDef* class_def = dex_file_->FindClassDef("LMethodInlining;");
+    ASSERT_TRUE(class_def != nullptr);
+    ClassDataItemIterator it(*dex_file_, dex_file_->GetClassData(*class_def));
+    while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+      it.Next();
+    }
+    for (; it.HasNextDirectMethod(); it.Next()) {
+      const DexFile::MethodId& method_id = dex_file_->GetMethodId(it.GetMemberIndex());
+      if (strcmp(dex_file_->GetMethodName(method_id), name) == 0) {
+        *method_idx = it.GetMemberIndex();
+        *code_item = it.GetMethodCodeItem();
+        *access_flags = it.GetMemberAccessFlags();
+        return;
+      }
+    }
+    FAIL() << "No method " << name;
+  }
+
+  // Builds "v2 = <callee>(v0, v1); return v2" with the call resolved the way
+  // MirMethodLoweringInfo::Resolve() does for a fast static call.
+  void PrepareCall(const char* callee) {
+    uint32_t method_idx;
+    uint32_t access_flags;
+    const DexFile::CodeItem* code_item;
+    ASSERT_NO_FATAL_FAILURE(FindMethod(callee, &method_idx, &code_item, &access_flags));
+    ASSERT_TRUE(code_item != nullptr);
+    ASSERT_EQ(2u, code_item->ins_size_);
+
+    MirMethodLoweringInfo method_info(method_idx, kStatic);
+    method_info.flags_ |= MirMethodLoweringInfo::kFlagFastPath;
+    if ((access_flags & (kAccSynchronized | kAccDeclaredSynchronized)) != 0u) {
+      method_info.flags_ |= MirMethodLoweringInfo::kFlagTargetIsSynchronized;
+    }
+    method_info.target_dex_file_ = dex_file_;
+    method_info.target_method_idx_ = method_idx;
+    method_info.target_code_item_ = code_item;
+    cu_.mir_graph->method_lowering_infos_.Reset();
+    cu_.mir_graph->method_lowering_infos_.Insert(method_info);
+
+    MIRGraph* mir_graph = cu_.mir_graph.get();
+    mir_graph->block_id_map_.clear();
+    mir_graph->block_list_.Reset();
+    mir_graph->num_blocks_ = 0u;
+    mir_graph->CreateNewBB(kNullBlock);
+    BasicBlock* entry = mir_graph->CreateNewBB(kEntryBlock);
+    BasicBlock* exit = mir_graph->CreateNewBB(kExitBlock);
+    BasicBlock* bb = mir_graph->CreateNewBB(kDalvikByteCode);
+    mir_graph->entry_block_ = entry;
+    mir_graph->exit_block_ = exit;
+    entry->fall_through = bb->id;
+    bb->predecessors->Insert(entry->id);
+    bb->fall_through = exit->id;
+    exit->predecessors->Insert(bb->id);
+
+    invoke_ = mir_graph->NewMIR();
+    invoke_->dalvikInsn.opcode = Instruction::INVOKE_STATIC;
+    invoke_->dalvikInsn.vA = 2u;
+    invoke_->dalvikInsn.vB = method_idx;
+    invoke_->dalvikInsn.arg[0] = 0u;
+    invoke_->dalvikInsn.arg[1] = 1u;
+    invoke_->meta.method_lowering_info = 0u;
+    bb->AppendMIR(invoke_);
+    MIR* move_result = mir_graph->NewMIR();
+    move_result->dalvikInsn.opcode = Instruction::MOVE_RESULT;
+    move_result->dalvikInsn.vA = 2u;
+    move_result->offset = 3u;
+    bb->AppendMIR(move_result);
+    MIR* ret = mir_graph->NewMIR();
+    ret->dalvikInsn.opcode = Instruction::RETURN;
+    ret->dalvikInsn.vA = 2u;
+    ret->offset = 4u;
+    bb->AppendMIR(ret);
+  }
+
+  bool PerformMethodInlining() {
+    size_t num_blocks = cu_.mir_graph->GetNumBlocks();
+    cu_.mir_graph->InlineCalls();
+    bool inlined = (invoke_->optimization_flags & MIR_INLINED) != 0u;
+    // A call that isn't inlined must leave the graph alone.
+    EXPECT_EQ(inlined, cu_.mir_graph->GetNumBlocks() != num_blocks);
+    return inlined;
+  }
+
+  ArenaPool pool_;
+  CompilationUnit cu_;
+  const DexFile* dex_file_;
+  MIR* invoke_;
+};
+
+constexpr uint32_t MethodInliningTest::kNumCallerRegs;
+
+TEST_F(MethodInliningTest, InlinesSmallStaticMethod) {
+  ASSERT_NO_FATAL_FAILURE(PrepareCall("add"));
+  ASSERT_TRUE(PerformMethodInlining());
+  MIR* move_result = invoke_->next;
+  EXPECT_EQ(static_cast<Instruction::Code>(kMirOpNop), move_result->dalvikInsn.opcode);
+  EXPECT_NE(0u, move_result->optimization_flags & MIR_INLINED);
+
+  // The invoke falls through to the callee's code, which returns to the rest of the block.
+  BasicBlock* bb = cu_.mir_graph->GetBasicBlock(3u);
+  BasicBlock* callee_bb = cu_.mir_graph->GetBasicBlock(bb->fall_through);
+  ASSERT_TRUE(callee_bb != nullptr);
+  std::vector<MIR*> callee_mirs;
+  for (MIR* mir = callee_bb->first_mir_insn; mir != nullptr; mir = mir->next) {
+    EXPECT_NE(0u, mir->optimization_flags & MIR_CALLEE);
+    EXPECT_EQ(invoke_->offset, mir->offset);
+    callee_mirs.push_back(mir);
+  }
+  // Two argument moves, the addition and the move of the return value.
+  ASSERT_EQ(4u, callee_mirs.size());
+  EXPECT_EQ(Instruction::MOVE_16, callee_mirs[0]->dalvikInsn.opcode);
+  EXPECT_EQ(0u, callee_mirs[0]->dalvikInsn.vB);
+  EXPECT_EQ(Instruction::MOVE_16, callee_mirs[1]->dalvikInsn.opcode);
+  EXPECT_EQ(1u, callee_mirs[1]->dalvikInsn.vB);
+  // The callee's registers follow the caller's.
+  EXPECT_LE(kNumCallerRegs, callee_mirs[0]->dalvikInsn.vA);
+  EXPECT_LE(kNumCallerRegs, callee_mirs[1]->dalvikInsn.vA);
+  Instruction::Code add_opcode = callee_mirs[2]->dalvikInsn.opcode;
+  EXPECT_TRUE(add_opcode == Instruction::ADD_INT || add_opcode == Instruction::ADD_INT_2ADDR)
+      << add_opcode;
+  EXPECT_LE(kNumCallerRegs, callee_mirs[2]->dalvikInsn.vA);
+  EXPECT_EQ(Instruction::MOVE_16, callee_mirs[3]->dalvikInsn.opcode);
+  EXPECT_EQ(2u, callee_mirs[3]->dalvikInsn.vA);
+
+  BasicBlock* cont_bb = cu_.mir_graph->GetBasicBlock(callee_bb->fall_through);
+  ASSERT_TRUE(cont_bb != nullptr);
+  ASSERT_TRUE(cont_bb->first_mir_insn != nullptr);
+  EXPECT_EQ(Instruction::RETURN, cont_bb->first_mir_insn->dalvikInsn.opcode);
+  EXPECT_EQ(2u, cont_bb->fall_through);
+}
+
+TEST_F(MethodInliningTest, RejectsThrowingMethod) {
+  // The division by a register can throw an ArithmeticException with the wrong stack trace.
+  ASSERT_NO_FATAL_FAILURE(PrepareCall("div"));
+  EXPECT_FALSE(PerformMethodInlining());
+}
+
+TEST_F(MethodInliningTest, RejectsSynchronizedMethod) {
+  ASSERT_NO_FATAL_FAILURE(PrepareCall("syncAdd"));
+  EXPECT_FALSE(PerformMethodInlining());
+}
+
+TEST_F(MethodInliningTest, RejectsLargeMethod) {
+  uint32_t method_idx;
+  uint32_t access_flags;
+  const DexFile::CodeItem* code_item;
+  ASSERT_NO_FATAL_FAILURE(FindMethod("large", &method_idx, &code_item, &access_flags));
+  ASSERT_GT(code_item->insns_size_in_code_units_, 32u);
+  ASSERT_NO_FATAL_FAILURE(PrepareCall("large"));
+  EXPECT_FALSE(PerformMethodInlining());
+}
+
 }  // namespace art
@@ -36,10 +36,14 @@ const Pass* const PassDriver<PassDriverMEOpts>::g_passes[] = {
   GetPassInstance<CacheFieldLoweringInfo>(),
   GetPassInstance<CacheMethodLoweringInfo>(),
   GetPassInstance<SpecialMethodInliner>(),
+  GetPassInstance<MethodInliner>(),
   GetPassInstance<CodeLayout>(),
   GetPassInstance<NullCheckEliminationAndTypeInference>(),
   GetPassInstance<ClassInitCheckElimination>(),
   GetPassInstance<GlobalValueNumberingPass>(),
+  GetPassInstance<RangeCheckElimination>(),
+  GetPassInstance<LoopInvariantCodeMotion>(),
+  GetPassInstance<LoopVectorization>(),
   GetPassInstance<BBCombine>(),
   GetPassInstance<BBOptimizations>(),
 };
@@ -109,6 +109,8 @@ class ArmMir2Lir FINAL : public Mir2Lir {
     bool GenInlinedAbsDouble(CallInfo* info) OVERRIDE;
     bool GenInlinedCas(CallInfo* info, bool is_long, bool is_object);
     bool GenInlinedMinMax(CallInfo* info, bool is_min, bool is_long);
+    bool GenInlinedNumberOfLeadingZeros(CallInfo* info, OpSize size) OVERRIDE;
+    bool GenInlinedNumberOfTrailingZeros(CallInfo* info, OpSize size) OVERRIDE;
     bool GenInlinedSqrt(CallInfo* info);
     bool GenInlinedPeek(CallInfo* info, OpSize size);
     bool GenInlinedPoke(CallInfo* info, OpSize size);
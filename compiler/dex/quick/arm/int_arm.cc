@@ -740,6 +740,64 @@ bool ArmMir2Lir::GenInlinedMinMax(CallInfo* info, bool is_min, bool is_long) {
   return true;
 }
 
+bool ArmMir2Lir::GenInlinedNumberOfLeadingZeros(CallInfo* info, OpSize size) {
+  RegLocation rl_dest = InlineTarget(info);
+  if (size != k64) {
+    RegLocation rl_src = LoadValue(info->args[0], kCoreReg);
+    RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+    NewLIR3(kThumb2ClzRR, rl_result.reg.GetReg(), rl_src.reg.GetReg(), rl_src.reg.GetReg());
+    StoreValue(rl_dest, rl_result);
+    return true;
+  }
+  RegLocation rl_src = LoadValueWide(info->args[0], kCoreReg);
+  RegStorage r_count = AllocTemp();
+  RegStorage r_low_count = AllocTemp();
+  // The low word only contributes when the high word is zero, i.e. when clz(high) == 32.
+  NewLIR3(kThumb2ClzRR, r_count.GetReg(), rl_src.reg.GetHighReg(), rl_src.reg.GetHighReg());
+  LIR* done = OpCmpImmBranch(kCondNe, rl_src.reg.GetHigh(), 0, nullptr);
+  NewLIR3(kThumb2ClzRR, r_low_count.GetReg(), rl_src.reg.GetLowReg(), rl_src.reg.GetLowReg());
+  OpRegReg(kOpAdd, r_count, r_low_count);
+  done->target = NewLIR0(kPseudoTargetLabel);
+  RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+  OpRegCopy(rl_result.reg, r_count);
+  FreeTemp(r_count);
+  FreeTemp(r_low_count);
+  StoreValue(rl_dest, rl_result);
+  return true;
+}
+
+bool ArmMir2Lir::GenInlinedNumberOfTrailingZeros(CallInfo* info, OpSize size) {
+  RegLocation rl_dest = InlineTarget(info);
+  if (size != k64) {
+    RegLocation rl_src = LoadValue(info->args[0], kCoreReg);
+    RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+    // Trailing zeros are the leading zeros of the bit-reversed value.
+    NewLIR3(kThumb2RbitRR, rl_result.reg.GetReg(), rl_src.reg.GetReg(), rl_src.reg.GetReg());
+    NewLIR3(kThumb2ClzRR, rl_result.reg.GetReg(), rl_result.reg.GetReg(),
+            rl_result.reg.GetReg());
+    StoreValue(rl_dest, rl_result);
+    return true;
+  }
+  RegLocation rl_src = LoadValueWide(info->args[0], kCoreReg);
+  RegStorage r_count = AllocTemp();
+  RegStorage r_high_count = AllocTemp();
+  // The high word only contributes when the low word is zero.
+  NewLIR3(kThumb2RbitRR, r_count.GetReg(), rl_src.reg.GetLowReg(), rl_src.reg.GetLowReg());
+  NewLIR3(kThumb2ClzRR, r_count.GetReg(), r_count.GetReg(), r_count.GetReg());
+  LIR* done = OpCmpImmBranch(kCondNe, rl_src.reg.GetLow(), 0, nullptr);
+  NewLIR3(kThumb2RbitRR, r_high_count.GetReg(), rl_src.reg.GetHighReg(),
+          rl_src.reg.GetHighReg());
+  NewLIR3(kThumb2ClzRR, r_high_count.GetReg(), r_high_count.GetReg(), r_high_count.GetReg());
+  OpRegReg(kOpAdd, r_count, r_high_count);
+  done->target = NewLIR0(kPseudoTargetLabel);
+  RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+  OpRegCopy(rl_result.reg, r_count);
+  FreeTemp(r_count);
+  FreeTemp(r_high_count);
+  StoreValue(rl_dest, rl_result);
+  return true;
+}
+
 bool ArmMir2Lir::GenInlinedPeek(CallInfo* info, OpSize size) {
   RegLocation rl_src_address = info->args[0];  // long address
   rl_src_address = NarrowRegLoc(rl_src_address);  // ignore high half in info->args[1]
@@ -176,6 +176,12 @@ class Arm64Mir2Lir FINAL : public Mir2Lir {
     bool GenInlinedMinMax(CallInfo* info, bool is_min, bool is_long);
     bool GenInlinedMinMaxFP(CallInfo* info, bool is_min, bool is_double);
     bool GenInlinedSqrt(CallInfo* info);
+    bool GenInlinedCeil(CallInfo* info) OVERRIDE;
+    bool GenInlinedFloor(CallInfo* info) OVERRIDE;
+    bool GenInlinedRint(CallInfo* info) OVERRIDE;
+    bool GenInlinedRound(CallInfo* info, bool is_double) OVERRIDE;
+    bool GenInlinedNumberOfLeadingZeros(CallInfo* info, OpSize size) OVERRIDE;
+    bool GenInlinedNumberOfTrailingZeros(CallInfo* info, OpSize size) OVERRIDE;
     bool GenInlinedPeek(CallInfo* info, OpSize size);
     bool GenInlinedPoke(CallInfo* info, OpSize size);
     bool GenInlinedAbsLong(CallInfo* info);
@@ -383,6 +389,8 @@ class Arm64Mir2Lir FINAL : public Mir2Lir {
                           bool is_div, bool check_zero);
     RegLocation GenDivRemLit(RegLocation rl_dest, RegLocation rl_src1, int lit, bool is_div);
     size_t GetLoadStoreSize(LIR* lir);
+    // Double-precision Math rounding with the frint* opcode selecting the direction.
+    bool GenInlinedFrint(CallInfo* info, int op);
 };
 
 }  // namespace art
@@ -401,4 +401,48 @@ bool Arm64Mir2Lir::GenInlinedMinMaxFP(CallInfo* info, bool is_min, bool is_doubl
   return true;
 }
 
+bool Arm64Mir2Lir::GenInlinedFrint(CallInfo* info, int op) {
+  RegLocation rl_src = info->args[0];
+  RegLocation rl_dest = InlineTargetWide(info);
+  rl_src = LoadValueWide(rl_src, kFPReg);
+  RegLocation rl_result = EvalLoc(rl_dest, kFPReg, true);
+  NewLIR2(FWIDE(op), rl_result.reg.GetReg(), rl_src.reg.GetReg());
+  StoreValueWide(rl_dest, rl_result);
+  return true;
+}
+
+bool Arm64Mir2Lir::GenInlinedCeil(CallInfo* info) {
+  return GenInlinedFrint(info, kA64Frintp2ff);
+}
+
+bool Arm64Mir2Lir::GenInlinedFloor(CallInfo* info) {
+  return GenInlinedFrint(info, kA64Frintm2ff);
+}
+
+bool Arm64Mir2Lir::GenInlinedRint(CallInfo* info) {
+  return GenInlinedFrint(info, kA64Frintn2ff);
+}
+
+bool Arm64Mir2Lir::GenInlinedRound(CallInfo* info, bool is_double) {
+  // Math.round() is floor(x + 0.5) converted with saturation and NaN mapping to zero,
+  // which is exactly what fcvtms does with the sum.
+  ArmOpcode wide = (is_double) ? FWIDE(0) : FUNWIDE(0);
+  RegLocation rl_src = info->args[0];
+  RegLocation rl_dest = (is_double) ? InlineTargetWide(info) : InlineTarget(info);
+  rl_src = (is_double) ? LoadValueWide(rl_src, kFPReg) : LoadValue(rl_src, kFPReg);
+  RegStorage r_sum = (is_double) ? AllocTempDouble() : AllocTempSingle();
+  if (is_double) {
+    LoadConstantWide(r_sum, INT64_C(0x3fe0000000000000));  // 0.5
+  } else {
+    LoadConstant(r_sum, 0x3f000000);  // 0.5f
+  }
+  NewLIR3(kA64Fadd3fff | wide, r_sum.GetReg(), rl_src.reg.GetReg(), r_sum.GetReg());
+  RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+  NewLIR2((is_double) ? FWIDE(kA64Fcvtms2xf) : kA64Fcvtms2wf, rl_result.reg.GetReg(),
+          r_sum.GetReg());
+  FreeTemp(r_sum);
+  (is_double) ?  StoreValueWide(rl_dest, rl_result) : StoreValue(rl_dest, rl_result);
+  return true;
+}
+
 }  // namespace art
@@ -1348,4 +1348,32 @@ bool Arm64Mir2Lir::GenInlinedReverseBits(CallInfo* info, OpSize size) {
   return true;
 }
 
+bool Arm64Mir2Lir::GenInlinedNumberOfLeadingZeros(CallInfo* info, OpSize size) {
+  ArmOpcode wide = (size == k64) ? WIDE(0) : UNWIDE(0);
+  RegLocation rl_src_i = info->args[0];
+  RegLocation rl_dest = InlineTarget(info);  // The count is an int even for a long argument.
+  RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+  RegLocation rl_i = (size == k64) ? LoadValueWide(rl_src_i, kCoreReg)
+                                   : LoadValue(rl_src_i, kCoreReg);
+  RegStorage r_count = (size == k64) ? As64BitReg(rl_result.reg) : rl_result.reg;
+  NewLIR2(kA64Clz2rr | wide, r_count.GetReg(), rl_i.reg.GetReg());
+  StoreValue(rl_dest, rl_result);
+  return true;
+}
+
+bool Arm64Mir2Lir::GenInlinedNumberOfTrailingZeros(CallInfo* info, OpSize size) {
+  ArmOpcode wide = (size == k64) ? WIDE(0) : UNWIDE(0);
+  RegLocation rl_src_i = info->args[0];
+  RegLocation rl_dest = InlineTarget(info);
+  RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+  RegLocation rl_i = (size == k64) ? LoadValueWide(rl_src_i, kCoreReg)
+                                   : LoadValue(rl_src_i, kCoreReg);
+  RegStorage r_count = (size == k64) ? As64BitReg(rl_result.reg) : rl_result.reg;
+  // Trailing zeros are the leading zeros of the bit-reversed value.
+  NewLIR2(kA64Rbit2rr | wide, r_count.GetReg(), rl_i.reg.GetReg());
+  NewLIR2(kA64Clz2rr | wide, r_count.GetReg(), r_count.GetReg());
+  StoreValue(rl_dest, rl_result);
+  return true;
+}
+
 }  // namespace art
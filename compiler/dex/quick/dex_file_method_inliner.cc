@@ -39,6 +39,11 @@ static constexpr bool kIntrinsicIsStatic[] = {
     true,   // kIntrinsicFloatCvt
     true,   // kIntrinsicReverseBits
     true,   // kIntrinsicReverseBytes
+    true,   // kIntrinsicBitCount
+    true,   // kIntrinsicNumberOfLeadingZeros
+    true,   // kIntrinsicNumberOfTrailingZeros
+    true,   // kIntrinsicRotateRight
+    true,   // kIntrinsicRotateLeft
     true,   // kIntrinsicAbsInt
     true,   // kIntrinsicAbsLong
     true,   // kIntrinsicAbsFloat
@@ -48,9 +53,15 @@ static constexpr bool kIntrinsicIsStatic[] = {
     true,   // kIntrinsicMinMaxFloat
     true,   // kIntrinsicMinMaxDouble
     true,   // kIntrinsicSqrt
+    true,   // kIntrinsicCeil
+    true,   // kIntrinsicFloor
+    true,   // kIntrinsicRint
+    true,   // kIntrinsicRoundFloat
+    true,   // kIntrinsicRoundDouble
     false,  // kIntrinsicGet
     false,  // kIntrinsicCharAt
     false,  // kIntrinsicCompareTo
+    false,  // kIntrinsicEquals
     false,  // kIntrinsicIsEmptyOrLength
     false,  // kIntrinsicIndexOf
     true,   // kIntrinsicCurrentThread
@@ -60,12 +71,22 @@ static constexpr bool kIntrinsicIsStatic[] = {
     false,  // kIntrinsicUnsafeGet
     false,  // kIntrinsicUnsafePut
     true,   // kIntrinsicSystemArrayCopyCharArray
+    true,   // kIntrinsicSystemArrayCopy
+    true,   // kIntrinsicArraysFill
+    true,   // kIntrinsicArraysEquals
 };
 COMPILE_ASSERT(arraysize(kIntrinsicIsStatic) == kInlineOpNop, check_arraysize_kIntrinsicIsStatic);
 COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicDoubleCvt], DoubleCvt_must_be_static);
 COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicFloatCvt], FloatCvt_must_be_static);
 COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicReverseBits], ReverseBits_must_be_static);
 COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicReverseBytes], ReverseBytes_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicBitCount], BitCount_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicNumberOfLeadingZeros],
+               NumberOfLeadingZeros_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicNumberOfTrailingZeros],
+               NumberOfTrailingZeros_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicRotateRight], RotateRight_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicRotateLeft], RotateLeft_must_be_static);
 COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicAbsInt], AbsInt_must_be_static);
 COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicAbsLong], AbsLong_must_be_static);
 COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicAbsFloat], AbsFloat_must_be_static);
@@ -75,9 +96,15 @@ COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicMinMaxLong], MinMaxLong_must_be_stat
 COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicMinMaxFloat], MinMaxFloat_must_be_static);
 COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicMinMaxDouble], MinMaxDouble_must_be_static);
 COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicSqrt], Sqrt_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicCeil], Ceil_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicFloor], Floor_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicRint], Rint_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicRoundFloat], RoundFloat_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicRoundDouble], RoundDouble_must_be_static);
 COMPILE_ASSERT(!kIntrinsicIsStatic[kIntrinsicGet], Get_must_not_be_static);
 COMPILE_ASSERT(!kIntrinsicIsStatic[kIntrinsicCharAt], CharAt_must_not_be_static);
 COMPILE_ASSERT(!kIntrinsicIsStatic[kIntrinsicCompareTo], CompareTo_must_not_be_static);
+COMPILE_ASSERT(!kIntrinsicIsStatic[kIntrinsicEquals], Equals_must_not_be_static);
 COMPILE_ASSERT(!kIntrinsicIsStatic[kIntrinsicIsEmptyOrLength], IsEmptyOrLength_must_not_be_static);
 COMPILE_ASSERT(!kIntrinsicIsStatic[kIntrinsicIndexOf], IndexOf_must_not_be_static);
 COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicCurrentThread], CurrentThread_must_be_static);
@@ -88,6 +115,9 @@ COMPILE_ASSERT(!kIntrinsicIsStatic[kIntrinsicUnsafeGet], UnsafeGet_must_not_be_s
 COMPILE_ASSERT(!kIntrinsicIsStatic[kIntrinsicUnsafePut], UnsafePut_must_not_be_static);
 COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicSystemArrayCopyCharArray],
                SystemArrayCopyCharArray_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicSystemArrayCopy], SystemArrayCopy_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicArraysFill], ArraysFill_must_be_static);
+COMPILE_ASSERT(kIntrinsicIsStatic[kIntrinsicArraysEquals], ArraysEquals_must_be_static);
 
 MIR* AllocReplacementMIR(MIRGraph* mir_graph, MIR* invoke, MIR* move_return) {
   MIR* insn = mir_graph->NewMIR();
@@ -141,12 +171,25 @@ const char* const DexFileMethodInliner::kClassCacheNames[] = {
     "Llibcore/io/Memory;",     // kClassCacheLibcoreIoMemory
     "Lsun/misc/Unsafe;",       // kClassCacheSunMiscUnsafe
     "Ljava/lang/System;",      // kClassCacheJavaLangSystem
-    "[C"                       // kClassCacheJavaLangCharArray
+    "[C",                      // kClassCacheJavaLangCharArray
+    "Ljava/util/Arrays;",      // kClassCacheJavaUtilArrays
+    "[Z",                      // kClassCacheBooleanArray
+    "[B",                      // kClassCacheByteArray
+    "[S",                      // kClassCacheShortArray
+    "[I",                      // kClassCacheIntArray
+    "[J",                      // kClassCacheLongArray
+    "[F",                      // kClassCacheFloatArray
+    "[D",                      // kClassCacheDoubleArray
 };
 
 const char* const DexFileMethodInliner::kNameCacheNames[] = {
     "reverse",               // kNameCacheReverse
     "reverseBytes",          // kNameCacheReverseBytes
+    "bitCount",              // kNameCacheBitCount
+    "numberOfLeadingZeros",  // kNameCacheNumberOfLeadingZeros
+    "numberOfTrailingZeros",  // kNameCacheNumberOfTrailingZeros
+    "rotateRight",           // kNameCacheRotateRight
+    "rotateLeft",            // kNameCacheRotateLeft
     "doubleToRawLongBits",   // kNameCacheDoubleToRawLongBits
     "longBitsToDouble",      // kNameCacheLongBitsToDouble
     "floatToRawIntBits",     // kNameCacheFloatToRawIntBits
@@ -155,9 +198,14 @@ const char* const DexFileMethodInliner::kNameCacheNames[] = {
     "max",                   // kNameCacheMax
     "min",                   // kNameCacheMin
     "sqrt",                  // kNameCacheSqrt
+    "ceil",                  // kNameCacheCeil
+    "floor",                 // kNameCacheFloor
+    "rint",                  // kNameCacheRint
+    "round",                 // kNameCacheRound
     "get",                   // kNameCacheGet
     "charAt",                // kNameCacheCharAt
     "compareTo",             // kNameCacheCompareTo
+    "equals",                // kNameCacheEquals
     "isEmpty",               // kNameCacheIsEmpty
     "indexOf",               // kNameCacheIndexOf
     "length",                // kNameCacheLength
@@ -189,6 +237,7 @@ const char* const DexFileMethodInliner::kNameCacheNames[] = {
     "putObjectVolatile",     // kNameCachePutObjectVolatile
     "putOrderedObject",      // kNameCachePutOrderedObject
     "arraycopy",             // kNameCacheArrayCopy
+    "fill",                  // kNameCacheFill
 };
 
 const DexFileMethodInliner::ProtoDef DexFileMethodInliner::kProtoCacheDefs[] = {
@@ -268,7 +317,60 @@ const DexFileMethodInliner::ProtoDef DexFileMethodInliner::kProtoCacheDefs[] = {
         kClassCacheJavaLangObject } },
     // kProtoCacheCharArrayICharArrayII_V
     { kClassCacheVoid, 5, {kClassCacheJavaLangCharArray, kClassCacheInt,
-                kClassCacheJavaLangCharArray, kClassCacheInt, kClassCacheInt}}
+                kClassCacheJavaLangCharArray, kClassCacheInt, kClassCacheInt}},
+    // kProtoCacheJI_J
+    { kClassCacheLong, 2, { kClassCacheLong, kClassCacheInt } },
+    // kProtoCacheObject_Z
+    { kClassCacheBoolean, 1, { kClassCacheJavaLangObject } },
+    // kProtoCacheBooleanArrayIBooleanArrayII_V
+    { kClassCacheVoid, 5, { kClassCacheBooleanArray, kClassCacheInt,
+        kClassCacheBooleanArray, kClassCacheInt, kClassCacheInt } },
+    // kProtoCacheByteArrayIByteArrayII_V
+    { kClassCacheVoid, 5, { kClassCacheByteArray, kClassCacheInt,
+        kClassCacheByteArray, kClassCacheInt, kClassCacheInt } },
+    // kProtoCacheShortArrayIShortArrayII_V
+    { kClassCacheVoid, 5, { kClassCacheShortArray, kClassCacheInt,
+        kClassCacheShortArray, kClassCacheInt, kClassCacheInt } },
+    // kProtoCacheIntArrayIIntArrayII_V
+    { kClassCacheVoid, 5, { kClassCacheIntArray, kClassCacheInt,
+        kClassCacheIntArray, kClassCacheInt, kClassCacheInt } },
+    // kProtoCacheLongArrayILongArrayII_V
+    { kClassCacheVoid, 5, { kClassCacheLongArray, kClassCacheInt,
+        kClassCacheLongArray, kClassCacheInt, kClassCacheInt } },
+    // kProtoCacheFloatArrayIFloatArrayII_V
+    { kClassCacheVoid, 5, { kClassCacheFloatArray, kClassCacheInt,
+        kClassCacheFloatArray, kClassCacheInt, kClassCacheInt } },
+    // kProtoCacheDoubleArrayIDoubleArrayII_V
+    { kClassCacheVoid, 5, { kClassCacheDoubleArray, kClassCacheInt,
+        kClassCacheDoubleArray, kClassCacheInt, kClassCacheInt } },
+    // kProtoCacheBooleanArrayZ_V
+    { kClassCacheVoid, 2, { kClassCacheBooleanArray, kClassCacheBoolean } },
+    // kProtoCacheByteArrayB_V
+    { kClassCacheVoid, 2, { kClassCacheByteArray, kClassCacheByte } },
+    // kProtoCacheCharArrayC_V
+    { kClassCacheVoid, 2, { kClassCacheJavaLangCharArray, kClassCacheChar } },
+    // kProtoCacheShortArrayS_V
+    { kClassCacheVoid, 2, { kClassCacheShortArray, kClassCacheShort } },
+    // kProtoCacheIntArrayI_V
+    { kClassCacheVoid, 2, { kClassCacheIntArray, kClassCacheInt } },
+    // kProtoCacheLongArrayJ_V
+    { kClassCacheVoid, 2, { kClassCacheLongArray, kClassCacheLong } },
+    // kProtoCacheFloatArrayF_V
+    { kClassCacheVoid, 2, { kClassCacheFloatArray, kClassCacheFloat } },
+    // kProtoCacheDoubleArrayD_V
+    { kClassCacheVoid, 2, { kClassCacheDoubleArray, kClassCacheDouble } },
+    // kProtoCacheBooleanArrayBooleanArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheBooleanArray, kClassCacheBooleanArray } },
+    // kProtoCacheByteArrayByteArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheByteArray, kClassCacheByteArray } },
+    // kProtoCacheCharArrayCharArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheJavaLangCharArray, kClassCacheJavaLangCharArray } },
+    // kProtoCacheShortArrayShortArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheShortArray, kClassCacheShortArray } },
+    // kProtoCacheIntArrayIntArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheIntArray, kClassCacheIntArray } },
+    // kProtoCacheLongArrayLongArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheLongArray, kClassCacheLongArray } },
 };
 
 const DexFileMethodInliner::IntrinsicDef DexFileMethodInliner::kIntrinsicMethods[] = {
@@ -285,6 +387,16 @@ const DexFileMethodInliner::IntrinsicDef DexFileMethodInliner::kIntrinsicMethods
     INTRINSIC(JavaLangShort, ReverseBytes, S_S, kIntrinsicReverseBytes, kSignedHalf),
     INTRINSIC(JavaLangInteger, Reverse, I_I, kIntrinsicReverseBits, k32),
     INTRINSIC(JavaLangLong, Reverse, J_J, kIntrinsicReverseBits, k64),
+    INTRINSIC(JavaLangInteger, BitCount, I_I, kIntrinsicBitCount, k32),
+    INTRINSIC(JavaLangLong, BitCount, J_I, kIntrinsicBitCount, k64),
+    INTRINSIC(JavaLangInteger, NumberOfLeadingZeros, I_I, kIntrinsicNumberOfLeadingZeros, k32),
+    INTRINSIC(JavaLangLong, NumberOfLeadingZeros, J_I, kIntrinsicNumberOfLeadingZeros, k64),
+    INTRINSIC(JavaLangInteger, NumberOfTrailingZeros, I_I, kIntrinsicNumberOfTrailingZeros, k32),
+    INTRINSIC(JavaLangLong, NumberOfTrailingZeros, J_I, kIntrinsicNumberOfTrailingZeros, k64),
+    INTRINSIC(JavaLangInteger, RotateRight, II_I, kIntrinsicRotateRight, k32),
+    INTRINSIC(JavaLangLong, RotateRight, JI_J, kIntrinsicRotateRight, k64),
+    INTRINSIC(JavaLangInteger, RotateLeft, II_I, kIntrinsicRotateLeft, k32),
+    INTRINSIC(JavaLangLong, RotateLeft, JI_J, kIntrinsicRotateLeft, k64),
 
     INTRINSIC(JavaLangMath,       Abs, I_I, kIntrinsicAbsInt, 0),
     INTRINSIC(JavaLangStrictMath, Abs, I_I, kIntrinsicAbsInt, 0),
@@ -313,11 +425,22 @@ const DexFileMethodInliner::IntrinsicDef DexFileMethodInliner::kIntrinsicMethods
 
     INTRINSIC(JavaLangMath,       Sqrt, D_D, kIntrinsicSqrt, 0),
     INTRINSIC(JavaLangStrictMath, Sqrt, D_D, kIntrinsicSqrt, 0),
+    INTRINSIC(JavaLangMath,       Ceil, D_D, kIntrinsicCeil, 0),
+    INTRINSIC(JavaLangStrictMath, Ceil, D_D, kIntrinsicCeil, 0),
+    INTRINSIC(JavaLangMath,       Floor, D_D, kIntrinsicFloor, 0),
+    INTRINSIC(JavaLangStrictMath, Floor, D_D, kIntrinsicFloor, 0),
+    INTRINSIC(JavaLangMath,       Rint, D_D, kIntrinsicRint, 0),
+    INTRINSIC(JavaLangStrictMath, Rint, D_D, kIntrinsicRint, 0),
+    INTRINSIC(JavaLangMath,       Round, F_I, kIntrinsicRoundFloat, 0),
+    INTRINSIC(JavaLangStrictMath, Round, F_I, kIntrinsicRoundFloat, 0),
+    INTRINSIC(JavaLangMath,       Round, D_J, kIntrinsicRoundDouble, 0),
+    INTRINSIC(JavaLangStrictMath, Round, D_J, kIntrinsicRoundDouble, 0),
 
     INTRINSIC(JavaLangRefReference, Get, _Object, kIntrinsicGet, 0),
 
     INTRINSIC(JavaLangString, CharAt, I_C, kIntrinsicCharAt, 0),
     INTRINSIC(JavaLangString, CompareTo, String_I, kIntrinsicCompareTo, 0),
+    INTRINSIC(JavaLangString, Equals, Object_Z, kIntrinsicEquals, 0),
     INTRINSIC(JavaLangString, IsEmpty, _Z, kIntrinsicIsEmptyOrLength, kIntrinsicFlagIsEmpty),
     INTRINSIC(JavaLangString, IndexOf, II_I, kIntrinsicIndexOf, kIntrinsicFlagNone),
     INTRINSIC(JavaLangString, IndexOf, I_I, kIntrinsicIndexOf, kIntrinsicFlagBase0),
@@ -360,6 +483,38 @@ const DexFileMethodInliner::IntrinsicDef DexFileMethodInliner::kIntrinsicMethods
 
     INTRINSIC(JavaLangSystem, ArrayCopy, CharArrayICharArrayII_V , kIntrinsicSystemArrayCopyCharArray,
               0),
+    // Floating point arrays are copied, filled and compared as raw bits of the same width,
+    // except that Arrays.equals() must treat all NaNs as equal and is left alone for them.
+    INTRINSIC(JavaLangSystem, ArrayCopy, BooleanArrayIBooleanArrayII_V, kIntrinsicSystemArrayCopy,
+              kUnsignedByte),
+    INTRINSIC(JavaLangSystem, ArrayCopy, ByteArrayIByteArrayII_V, kIntrinsicSystemArrayCopy,
+              kUnsignedByte),
+    INTRINSIC(JavaLangSystem, ArrayCopy, ShortArrayIShortArrayII_V, kIntrinsicSystemArrayCopy,
+              kUnsignedHalf),
+    INTRINSIC(JavaLangSystem, ArrayCopy, IntArrayIIntArrayII_V, kIntrinsicSystemArrayCopy, k32),
+    INTRINSIC(JavaLangSystem, ArrayCopy, LongArrayILongArrayII_V, kIntrinsicSystemArrayCopy, k64),
+    INTRINSIC(JavaLangSystem, ArrayCopy, FloatArrayIFloatArrayII_V, kIntrinsicSystemArrayCopy,
+              k32),
+    INTRINSIC(JavaLangSystem, ArrayCopy, DoubleArrayIDoubleArrayII_V, kIntrinsicSystemArrayCopy,
+              k64),
+
+    INTRINSIC(JavaUtilArrays, Fill, BooleanArrayZ_V, kIntrinsicArraysFill, kUnsignedByte),
+    INTRINSIC(JavaUtilArrays, Fill, ByteArrayB_V, kIntrinsicArraysFill, kUnsignedByte),
+    INTRINSIC(JavaUtilArrays, Fill, CharArrayC_V, kIntrinsicArraysFill, kUnsignedHalf),
+    INTRINSIC(JavaUtilArrays, Fill, ShortArrayS_V, kIntrinsicArraysFill, kUnsignedHalf),
+    INTRINSIC(JavaUtilArrays, Fill, IntArrayI_V, kIntrinsicArraysFill, k32),
+    INTRINSIC(JavaUtilArrays, Fill, LongArrayJ_V, kIntrinsicArraysFill, k64),
+    INTRINSIC(JavaUtilArrays, Fill, FloatArrayF_V, kIntrinsicArraysFill, k32),
+    INTRINSIC(JavaUtilArrays, Fill, DoubleArrayD_V, kIntrinsicArraysFill, k64),
+
+    INTRINSIC(JavaUtilArrays, Equals, BooleanArrayBooleanArray_Z, kIntrinsicArraysEquals,
+              kUnsignedByte),
+    INTRINSIC(JavaUtilArrays, Equals, ByteArrayByteArray_Z, kIntrinsicArraysEquals, kUnsignedByte),
+    INTRINSIC(JavaUtilArrays, Equals, CharArrayCharArray_Z, kIntrinsicArraysEquals, kUnsignedHalf),
+    INTRINSIC(JavaUtilArrays, Equals, ShortArrayShortArray_Z, kIntrinsicArraysEquals,
+              kUnsignedHalf),
+    INTRINSIC(JavaUtilArrays, Equals, IntArrayIntArray_Z, kIntrinsicArraysEquals, k32),
+    INTRINSIC(JavaUtilArrays, Equals, LongArrayLongArray_Z, kIntrinsicArraysEquals, k64),
 
 
 #undef INTRINSIC
@@ -418,6 +573,18 @@ bool DexFileMethodInliner::GenIntrinsic(Mir2Lir* backend, CallInfo* info) {
       return backend->GenInlinedReverseBytes(info, static_cast<OpSize>(intrinsic.d.data));
     case kIntrinsicReverseBits:
       return backend->GenInlinedReverseBits(info, static_cast<OpSize>(intrinsic.d.data));
+    case kIntrinsicBitCount:
+      return backend->GenInlinedBitCount(info, static_cast<OpSize>(intrinsic.d.data));
+    case kIntrinsicNumberOfLeadingZeros:
+      return backend->GenInlinedNumberOfLeadingZeros(info, static_cast<OpSize>(intrinsic.d.data));
+    case kIntrinsicNumberOfTrailingZeros:
+      return backend->GenInlinedNumberOfTrailingZeros(info, static_cast<OpSize>(intrinsic.d.data));
+    case kIntrinsicRotateRight:
+      return backend->GenInlinedRotate(info, static_cast<OpSize>(intrinsic.d.data),
+                                       false /* is_left */);
+    case kIntrinsicRotateLeft:
+      return backend->GenInlinedRotate(info, static_cast<OpSize>(intrinsic.d.data),
+                                       true /* is_left */);
     case kIntrinsicAbsInt:
       return backend->GenInlinedAbsInt(info);
     case kIntrinsicAbsLong:
@@ -436,12 +603,24 @@ bool DexFileMethodInliner::GenIntrinsic(Mir2Lir* backend, CallInfo* info) {
       return backend->GenInlinedMinMaxFP(info, intrinsic.d.data & kIntrinsicFlagMin, true /* is_double */);
     case kIntrinsicSqrt:
       return backend->GenInlinedSqrt(info);
+    case kIntrinsicCeil:
+      return backend->GenInlinedCeil(info);
+    case kIntrinsicFloor:
+      return backend->GenInlinedFloor(info);
+    case kIntrinsicRint:
+      return backend->GenInlinedRint(info);
+    case kIntrinsicRoundFloat:
+      return backend->GenInlinedRound(info, false /* is_double */);
+    case kIntrinsicRoundDouble:
+      return backend->GenInlinedRound(info, true /* is_double */);
     case kIntrinsicGet:
       return backend->GenInlinedGet(info);
     case kIntrinsicCharAt:
       return backend->GenInlinedCharAt(info);
     case kIntrinsicCompareTo:
       return backend->GenInlinedStringCompareTo(info);
+    case kIntrinsicEquals:
+      return backend->GenInlinedStringEquals(info);
     case kIntrinsicIsEmptyOrLength:
       return backend->GenInlinedStringIsEmptyOrLength(
           info, intrinsic.d.data & kIntrinsicFlagIsEmpty);
@@ -466,6 +645,12 @@ bool DexFileMethodInliner::GenIntrinsic(Mir2Lir* backend, CallInfo* info) {
                                           intrinsic.d.data & kIntrinsicFlagIsOrdered);
     case kIntrinsicSystemArrayCopyCharArray:
       return backend->GenInlinedArrayCopyCharArray(info);
+    case kIntrinsicSystemArrayCopy:
+      return backend->GenInlinedArrayCopy(info, static_cast<OpSize>(intrinsic.d.data));
+    case kIntrinsicArraysFill:
+      return backend->GenInlinedArraysFill(info, static_cast<OpSize>(intrinsic.d.data));
+    case kIntrinsicArraysEquals:
+      return backend->GenInlinedArraysEquals(info, static_cast<OpSize>(intrinsic.d.data));
     default:
       LOG(FATAL) << "Unexpected intrinsic opcode: " << intrinsic.opcode;
       return false;  // avoid warning "control reaches end of non-void function"
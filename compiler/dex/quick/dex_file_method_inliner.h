@@ -121,6 +121,14 @@ class DexFileMethodInliner {
       kClassCacheSunMiscUnsafe,
       kClassCacheJavaLangSystem,
       kClassCacheJavaLangCharArray,
+      kClassCacheJavaUtilArrays,
+      kClassCacheBooleanArray,
+      kClassCacheByteArray,
+      kClassCacheShortArray,
+      kClassCacheIntArray,
+      kClassCacheLongArray,
+      kClassCacheFloatArray,
+      kClassCacheDoubleArray,
       kClassCacheLast
     };
 
@@ -133,6 +141,11 @@ class DexFileMethodInliner {
       kNameCacheFirst = 0,
       kNameCacheReverse =  kNameCacheFirst,
       kNameCacheReverseBytes,
+      kNameCacheBitCount,
+      kNameCacheNumberOfLeadingZeros,
+      kNameCacheNumberOfTrailingZeros,
+      kNameCacheRotateRight,
+      kNameCacheRotateLeft,
       kNameCacheDoubleToRawLongBits,
       kNameCacheLongBitsToDouble,
       kNameCacheFloatToRawIntBits,
@@ -141,9 +154,14 @@ class DexFileMethodInliner {
       kNameCacheMax,
       kNameCacheMin,
       kNameCacheSqrt,
+      kNameCacheCeil,
+      kNameCacheFloor,
+      kNameCacheRint,
+      kNameCacheRound,
       kNameCacheGet,
       kNameCacheCharAt,
       kNameCacheCompareTo,
+      kNameCacheEquals,
       kNameCacheIsEmpty,
       kNameCacheIndexOf,
       kNameCacheLength,
@@ -175,6 +193,7 @@ class DexFileMethodInliner {
       kNameCachePutObjectVolatile,
       kNameCachePutOrderedObject,
       kNameCacheArrayCopy,
+      kNameCacheFill,
       kNameCacheLast
     };
 
@@ -221,6 +240,29 @@ class DexFileMethodInliner {
       kProtoCacheObjectJ_Object,
       kProtoCacheObjectJObject_V,
       kProtoCacheCharArrayICharArrayII_V,
+      kProtoCacheJI_J,
+      kProtoCacheObject_Z,
+      kProtoCacheBooleanArrayIBooleanArrayII_V,
+      kProtoCacheByteArrayIByteArrayII_V,
+      kProtoCacheShortArrayIShortArrayII_V,
+      kProtoCacheIntArrayIIntArrayII_V,
+      kProtoCacheLongArrayILongArrayII_V,
+      kProtoCacheFloatArrayIFloatArrayII_V,
+      kProtoCacheDoubleArrayIDoubleArrayII_V,
+      kProtoCacheBooleanArrayZ_V,
+      kProtoCacheByteArrayB_V,
+      kProtoCacheCharArrayC_V,
+      kProtoCacheShortArrayS_V,
+      kProtoCacheIntArrayI_V,
+      kProtoCacheLongArrayJ_V,
+      kProtoCacheFloatArrayF_V,
+      kProtoCacheDoubleArrayD_V,
+      kProtoCacheBooleanArrayBooleanArray_Z,
+      kProtoCacheByteArrayByteArray_Z,
+      kProtoCacheCharArrayCharArray_Z,
+      kProtoCacheShortArrayShortArray_Z,
+      kProtoCacheIntArrayIntArray_Z,
+      kProtoCacheLongArrayLongArray_Z,
       kProtoCacheLast
     };
 
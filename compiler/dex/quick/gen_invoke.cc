@@ -1450,6 +1450,503 @@ bool Mir2Lir::GenInlinedDoubleCvt(CallInfo* info) {
 }
 
 bool Mir2Lir::GenInlinedArrayCopyCharArray(CallInfo* info) {
+  return GenInlinedArrayCopy(info, kUnsignedHalf);
+}
+
+// Longer primitive arrays are left to the runtime, the inlined loops have no suspend check.
+static constexpr int kMaxInlinedArrayLength = 128;
+
+static int ArrayElementScale(OpSize size) {
+  switch (size) {
+    case kUnsignedByte:
+      return 0;
+    case kUnsignedHalf:
+      return 1;
+    case k32:
+      return 2;
+    case k64:
+      return 3;
+    default:
+      LOG(FATAL) << "Unexpected array element size " << size;
+      return 0;
+  }
+}
+
+RegStorage Mir2Lir::GenArrayDataAddress(RegStorage r_array, RegStorage r_index, int scale,
+                                        int data_offset) {
+  RegStorage r_ptr = AllocTempRef();
+  if (!r_index.Valid()) {
+    OpRegCopy(r_ptr, r_array);
+  } else if (cu_->target64) {
+    // The index is non-negative, so writing its 32-bit view zero-extends it to the pointer size.
+    RegStorage r_index64 = AllocTempWide();
+    OpRegCopy(RegStorage::Solo32(r_index64.GetRegNum()), r_index);
+    if (scale != 0) {
+      OpRegImm(kOpLsl, r_index64, scale);
+    }
+    OpRegRegReg(kOpAdd, r_ptr, r_array, r_index64);
+    FreeTemp(r_index64);
+  } else {
+    if (scale != 0) {
+      OpRegRegImm(kOpLsl, r_ptr, r_index, scale);
+      OpRegReg(kOpAdd, r_ptr, r_array);
+    } else {
+      OpRegRegReg(kOpAdd, r_ptr, r_array, r_index);
+    }
+  }
+  OpRegImm(kOpAdd, r_ptr, data_offset);
+  return r_ptr;
+}
+
+/*
+ * System.arraycopy() for distinct primitive arrays of the same type. Anything the runtime
+ * would throw for, overlapping copies within one array and long copies go to the slow path.
+ */
+bool Mir2Lir::GenInlinedArrayCopy(CallInfo* info, OpSize size) {
+  if (cu_->instruction_set == kMips || cu_->instruction_set == kX86) {
+    // Not implemented for MIPS, and x86 runs out of temps for the copy loop.
+    return false;
+  }
+  RegLocation rl_src = info->args[0];
+  RegLocation rl_src_pos = info->args[1];
+  RegLocation rl_dst = info->args[2];
+  RegLocation rl_dst_pos = info->args[3];
+  RegLocation rl_length = info->args[4];
+  if ((rl_src_pos.is_const && mir_graph_->ConstantValue(rl_src_pos) < 0) ||
+      (rl_dst_pos.is_const && mir_graph_->ConstantValue(rl_dst_pos) < 0) ||
+      (rl_length.is_const && (mir_graph_->ConstantValue(rl_length) < 0 ||
+                              mir_graph_->ConstantValue(rl_length) > kMaxInlinedArrayLength))) {
+    // We would always take the slow path.
+    return false;
+  }
+  int scale = ArrayElementScale(size);
+  int data_offset = mirror::Array::DataOffset(1 << scale).Int32Value();
+  int len_offset = mirror::Array::LengthOffset().Int32Value();
+  LIR* slow_branches[9];
+  size_t num_slow_branches = 0u;
+
+  rl_src = LoadValue(rl_src, kRefReg);
+  rl_dst = LoadValue(rl_dst, kRefReg);
+  slow_branches[num_slow_branches++] = OpCmpImmBranch(kCondEq, rl_src.reg, 0, nullptr);
+  slow_branches[num_slow_branches++] = OpCmpImmBranch(kCondEq, rl_dst.reg, 0, nullptr);
+  slow_branches[num_slow_branches++] = OpCmpBranch(kCondEq, rl_src.reg, rl_dst.reg, nullptr);
+  rl_length = LoadValue(rl_length, kCoreReg);
+  RegStorage r_count = AllocTemp();
+  OpRegCopy(r_count, rl_length.reg);
+  FreeTemp(rl_length.reg);
+  slow_branches[num_slow_branches++] = OpCmpImmBranch(kCondLt, r_count, 0, nullptr);
+  slow_branches[num_slow_branches++] =
+      OpCmpImmBranch(kCondGt, r_count, kMaxInlinedArrayLength, nullptr);
+
+  // Check pos >= 0 and pos <= array.length - count for both arrays, then compute the
+  // address of the first element to copy. Free what we can early, 32-bit ARM is short on temps.
+  rl_src_pos = LoadValue(rl_src_pos, kCoreReg);
+  slow_branches[num_slow_branches++] = OpCmpImmBranch(kCondLt, rl_src_pos.reg, 0, nullptr);
+  RegStorage r_tmp = AllocTemp();
+  Load32Disp(rl_src.reg, len_offset, r_tmp);
+  OpRegReg(kOpSub, r_tmp, r_count);
+  slow_branches[num_slow_branches++] = OpCmpBranch(kCondGt, rl_src_pos.reg, r_tmp, nullptr);
+  FreeTemp(r_tmp);
+  RegStorage r_src_ptr = GenArrayDataAddress(rl_src.reg, rl_src_pos.reg, scale, data_offset);
+  FreeTemp(rl_src.reg);
+  FreeTemp(rl_src_pos.reg);
+
+  rl_dst_pos = LoadValue(rl_dst_pos, kCoreReg);
+  slow_branches[num_slow_branches++] = OpCmpImmBranch(kCondLt, rl_dst_pos.reg, 0, nullptr);
+  r_tmp = AllocTemp();
+  Load32Disp(rl_dst.reg, len_offset, r_tmp);
+  OpRegReg(kOpSub, r_tmp, r_count);
+  slow_branches[num_slow_branches++] = OpCmpBranch(kCondGt, rl_dst_pos.reg, r_tmp, nullptr);
+  FreeTemp(r_tmp);
+  RegStorage r_dst_ptr = GenArrayDataAddress(rl_dst.reg, rl_dst_pos.reg, scale, data_offset);
+  FreeTemp(rl_dst.reg);
+  FreeTemp(rl_dst_pos.reg);
+  DCHECK_EQ(num_slow_branches, arraysize(slow_branches));
+
+  if (size == k64 && !cu_->target64) {
+    // Copy the halves of each element separately.
+    OpRegImm(kOpLsl, r_count, 1);
+    scale = 2;
+    size = k32;
+  }
+  // The arrays are distinct, copy backwards.
+  RegStorage r_value = (size == k64) ? AllocTempWide() : AllocTemp();
+  LIR* loop = NewLIR0(kPseudoTargetLabel);
+  LIR* done_branch = OpCmpImmBranch(kCondEq, r_count, 0, nullptr);
+  OpRegImm(kOpSub, r_count, 1);
+  LoadBaseIndexed(r_src_ptr, r_count, r_value, scale, size);
+  StoreBaseIndexed(r_dst_ptr, r_count, r_value, scale, size);
+  OpUnconditionalBranch(loop);
+  FreeTemp(r_value);
+  FreeTemp(r_count);
+  FreeTemp(r_src_ptr);
+  FreeTemp(r_dst_ptr);
+
+  LIR* check_failed = NewLIR0(kPseudoTargetLabel);
+  for (size_t i = 0u; i != num_slow_branches; ++i) {
+    slow_branches[i]->target = check_failed;
+  }
+  LIR* launchpad_branch = OpUnconditionalBranch(nullptr);
+  LIR* return_point = NewLIR0(kPseudoTargetLabel);
+  done_branch->target = return_point;
+  AddIntrinsicSlowPath(info, launchpad_branch, return_point);
+  return true;
+}
+
+bool Mir2Lir::GenInlinedArraysFill(CallInfo* info, OpSize size) {
+  if (cu_->instruction_set == kMips || cu_->instruction_set == kX86 ||
+      (size == k64 && !cu_->target64)) {
+    // Not implemented for MIPS, and x86 or a long pair runs out of temps for the loop.
+    return false;
+  }
+  int scale = ArrayElementScale(size);
+  int data_offset = mirror::Array::DataOffset(1 << scale).Int32Value();
+  RegLocation rl_array = LoadValue(info->args[0], kRefReg);
+  RegLocation rl_value = info->args[1];
+  // Floating point values are stored by their bits.
+  rl_value = (size == k64) ? LoadValueWide(rl_value, kCoreReg) : LoadValue(rl_value, kCoreReg);
+  // Let the slow path throw the NullPointerException.
+  LIR* null_branch = OpCmpImmBranch(kCondEq, rl_array.reg, 0, nullptr);
+  RegStorage r_count = AllocTemp();
+  Load32Disp(rl_array.reg, mirror::Array::LengthOffset().Int32Value(), r_count);
+  LIR* too_long_branch = OpCmpImmBranch(kCondGt, r_count, kMaxInlinedArrayLength, nullptr);
+  RegStorage r_ptr = GenArrayDataAddress(rl_array.reg, RegStorage::InvalidReg(), scale,
+                                         data_offset);
+  FreeTemp(rl_array.reg);
+  LIR* loop = NewLIR0(kPseudoTargetLabel);
+  LIR* done_branch = OpCmpImmBranch(kCondEq, r_count, 0, nullptr);
+  OpRegImm(kOpSub, r_count, 1);
+  StoreBaseIndexed(r_ptr, r_count, rl_value.reg, scale, size);
+  OpUnconditionalBranch(loop);
+  FreeTemp(r_count);
+  FreeTemp(r_ptr);
+
+  LIR* check_failed = NewLIR0(kPseudoTargetLabel);
+  null_branch->target = check_failed;
+  too_long_branch->target = check_failed;
+  LIR* launchpad_branch = OpUnconditionalBranch(nullptr);
+  LIR* return_point = NewLIR0(kPseudoTargetLabel);
+  done_branch->target = return_point;
+  AddIntrinsicSlowPath(info, launchpad_branch, return_point);
+  return true;
+}
+
+bool Mir2Lir::GenInlinedArraysEquals(CallInfo* info, OpSize size) {
+  if (cu_->instruction_set == kMips || cu_->instruction_set == kX86) {
+    // Not implemented for MIPS, and x86 runs out of temps for the compare loop.
+    return false;
+  }
+  int scale = ArrayElementScale(size);
+  int data_offset = mirror::Array::DataOffset(1 << scale).Int32Value();
+  int len_offset = mirror::Array::LengthOffset().Int32Value();
+  RegLocation rl_a = LoadValue(info->args[0], kRefReg);
+  RegLocation rl_b = LoadValue(info->args[1], kRefReg);
+  RegLocation rl_dest = InlineTarget(info);
+  LIR* equal_branches[2];
+  LIR* differ_branches[4];
+
+  equal_branches[0] = OpCmpBranch(kCondEq, rl_a.reg, rl_b.reg, nullptr);
+  differ_branches[0] = OpCmpImmBranch(kCondEq, rl_a.reg, 0, nullptr);
+  differ_branches[1] = OpCmpImmBranch(kCondEq, rl_b.reg, 0, nullptr);
+  RegStorage r_count = AllocTemp();
+  RegStorage r_tmp = AllocTemp();
+  Load32Disp(rl_a.reg, len_offset, r_count);
+  Load32Disp(rl_b.reg, len_offset, r_tmp);
+  differ_branches[2] = OpCmpBranch(kCondNe, r_count, r_tmp, nullptr);
+  FreeTemp(r_tmp);
+  LIR* too_long_branch = OpCmpImmBranch(kCondGt, r_count, kMaxInlinedArrayLength, nullptr);
+  RegStorage r_a_ptr = GenArrayDataAddress(rl_a.reg, RegStorage::InvalidReg(), scale,
+                                           data_offset);
+  FreeTemp(rl_a.reg);
+  RegStorage r_b_ptr = GenArrayDataAddress(rl_b.reg, RegStorage::InvalidReg(), scale,
+                                           data_offset);
+  FreeTemp(rl_b.reg);
+
+  if (size == k64 && !cu_->target64) {
+    // Compare the halves of each element separately.
+    OpRegImm(kOpLsl, r_count, 1);
+    scale = 2;
+    size = k32;
+  }
+  RegStorage r_a_value = (size == k64) ? AllocTempWide() : AllocTemp();
+  RegStorage r_b_value = (size == k64) ? AllocTempWide() : AllocTemp();
+  LIR* loop = NewLIR0(kPseudoTargetLabel);
+  equal_branches[1] = OpCmpImmBranch(kCondEq, r_count, 0, nullptr);
+  OpRegImm(kOpSub, r_count, 1);
+  LoadBaseIndexed(r_a_ptr, r_count, r_a_value, scale, size);
+  LoadBaseIndexed(r_b_ptr, r_count, r_b_value, scale, size);
+  differ_branches[3] = OpCmpBranch(kCondNe, r_a_value, r_b_value, nullptr);
+  OpUnconditionalBranch(loop);
+  FreeTemp(r_a_value);
+  FreeTemp(r_b_value);
+  FreeTemp(r_count);
+  FreeTemp(r_a_ptr);
+  FreeTemp(r_b_ptr);
+
+  // Use the return register for the result, so that the slow path can rejoin us.
+  RegLocation rl_result = GetReturn(kCoreReg);
+  LIR* equal = NewLIR0(kPseudoTargetLabel);
+  LoadConstant(rl_result.reg, 1);
+  LIR* equal_done = OpUnconditionalBranch(nullptr);
+  LIR* differ = NewLIR0(kPseudoTargetLabel);
+  LoadConstant(rl_result.reg, 0);
+  LIR* done = NewLIR0(kPseudoTargetLabel);
+  equal_done->target = done;
+  for (LIR* branch : equal_branches) {
+    branch->target = equal;
+  }
+  for (LIR* branch : differ_branches) {
+    branch->target = differ;
+  }
+  AddIntrinsicSlowPath(info, too_long_branch, done);
+  StoreValue(rl_dest, rl_result);
+  return true;
+}
+
+bool Mir2Lir::GenInlinedStringEquals(CallInfo* info) {
+  if (cu_->instruction_set == kMips || cu_->instruction_set == kX86) {
+    // Not implemented for MIPS, and x86 runs out of temps for the compare loop.
+    return false;
+  }
+  int value_offset = mirror::String::ValueOffset().Int32Value();
+  int count_offset = mirror::String::CountOffset().Int32Value();
+  int offset_offset = mirror::String::OffsetOffset().Int32Value();
+  int data_offset = mirror::Array::DataOffset(sizeof(uint16_t)).Int32Value();
+  int class_offset = mirror::Object::ClassOffset().Int32Value();
+
+  RegLocation rl_this = LoadValue(info->args[0], kRefReg);
+  RegLocation rl_cmp = LoadValue(info->args[1], kRefReg);
+  RegLocation rl_dest = InlineTarget(info);
+  LIR* equal_branches[2];
+  LIR* differ_branches[4];
+
+  GenNullCheck(rl_this.reg, info->opt_flags);
+  equal_branches[0] = OpCmpBranch(kCondEq, rl_this.reg, rl_cmp.reg, nullptr);
+  differ_branches[0] = OpCmpImmBranch(kCondEq, rl_cmp.reg, 0, nullptr);
+  // String is final, so the argument is a String exactly if its class is the same.
+  RegStorage r_this_class = AllocTempRef();
+  RegStorage r_cmp_class = AllocTempRef();
+  LoadRefDisp(rl_this.reg, class_offset, r_this_class, kNotVolatile);
+  MarkPossibleNullPointerException(info->opt_flags);
+  LoadRefDisp(rl_cmp.reg, class_offset, r_cmp_class, kNotVolatile);
+  differ_branches[1] = OpCmpBranch(kCondNe, r_this_class, r_cmp_class, nullptr);
+  FreeTemp(r_this_class);
+  FreeTemp(r_cmp_class);
+  RegStorage r_count = AllocTemp();
+  RegStorage r_tmp = AllocTemp();
+  Load32Disp(rl_this.reg, count_offset, r_count);
+  Load32Disp(rl_cmp.reg, count_offset, r_tmp);
+  differ_branches[2] = OpCmpBranch(kCondNe, r_count, r_tmp, nullptr);
+  FreeTemp(r_tmp);
+  LIR* too_long_branch = OpCmpImmBranch(kCondGt, r_count, kMaxInlinedArrayLength, nullptr);
+
+  // Address the first char of each string.
+  RegStorage r_offset = AllocTemp();
+  RegStorage r_value = AllocTempRef();
+  Load32Disp(rl_this.reg, offset_offset, r_offset);
+  LoadRefDisp(rl_this.reg, value_offset, r_value, kNotVolatile);
+  FreeTemp(rl_this.reg);
+  RegStorage r_this_ptr = GenArrayDataAddress(r_value, r_offset, 1, data_offset);
+  Load32Disp(rl_cmp.reg, offset_offset, r_offset);
+  LoadRefDisp(rl_cmp.reg, value_offset, r_value, kNotVolatile);
+  FreeTemp(rl_cmp.reg);
+  RegStorage r_cmp_ptr = GenArrayDataAddress(r_value, r_offset, 1, data_offset);
+  FreeTemp(r_offset);
+  FreeTemp(r_value);
+
+  RegStorage r_this_char = AllocTemp();
+  RegStorage r_cmp_char = AllocTemp();
+  LIR* loop = NewLIR0(kPseudoTargetLabel);
+  equal_branches[1] = OpCmpImmBranch(kCondEq, r_count, 0, nullptr);
+  OpRegImm(kOpSub, r_count, 1);
+  LoadBaseIndexed(r_this_ptr, r_count, r_this_char, 1, kUnsignedHalf);
+  LoadBaseIndexed(r_cmp_ptr, r_count, r_cmp_char, 1, kUnsignedHalf);
+  differ_branches[3] = OpCmpBranch(kCondNe, r_this_char, r_cmp_char, nullptr);
+  OpUnconditionalBranch(loop);
+  FreeTemp(r_this_char);
+  FreeTemp(r_cmp_char);
+  FreeTemp(r_count);
+  FreeTemp(r_this_ptr);
+  FreeTemp(r_cmp_ptr);
+
+  // Use the return register for the result, so that the slow path can rejoin us.
+  RegLocation rl_result = GetReturn(kCoreReg);
+  LIR* equal = NewLIR0(kPseudoTargetLabel);
+  LoadConstant(rl_result.reg, 1);
+  LIR* equal_done = OpUnconditionalBranch(nullptr);
+  LIR* differ = NewLIR0(kPseudoTargetLabel);
+  LoadConstant(rl_result.reg, 0);
+  LIR* done = NewLIR0(kPseudoTargetLabel);
+  equal_done->target = done;
+  for (LIR* branch : equal_branches) {
+    branch->target = equal;
+  }
+  for (LIR* branch : differ_branches) {
+    branch->target = differ;
+  }
+  AddIntrinsicSlowPath(info, too_long_branch, done);
+  StoreValue(rl_dest, rl_result);
+  return true;
+}
+
+// Population count of a 32-bit value, see Hacker's Delight, 5-1. r_dest may be r_src.
+void Mir2Lir::GenBitCount32(RegStorage r_dest, RegStorage r_src, RegStorage r_tmp) {
+  OpRegRegImm(kOpLsr, r_tmp, r_src, 1);
+  OpRegImm(kOpAnd, r_tmp, 0x55555555);
+  OpRegRegReg(kOpSub, r_dest, r_src, r_tmp);
+  OpRegRegImm(kOpLsr, r_tmp, r_dest, 2);
+  OpRegImm(kOpAnd, r_tmp, 0x33333333);
+  OpRegImm(kOpAnd, r_dest, 0x33333333);
+  OpRegReg(kOpAdd, r_dest, r_tmp);
+  OpRegRegImm(kOpLsr, r_tmp, r_dest, 4);
+  OpRegReg(kOpAdd, r_dest, r_tmp);
+  OpRegImm(kOpAnd, r_dest, 0x0f0f0f0f);
+  OpRegRegImm(kOpLsr, r_tmp, r_dest, 8);
+  OpRegReg(kOpAdd, r_dest, r_tmp);
+  OpRegRegImm(kOpLsr, r_tmp, r_dest, 16);
+  OpRegReg(kOpAdd, r_dest, r_tmp);
+  OpRegImm(kOpAnd, r_dest, 0x3f);
+}
+
+bool Mir2Lir::GenInlinedBitCount(CallInfo* info, OpSize size) {
+  if (cu_->instruction_set == kMips) {
+    // Not implemented for MIPS.
+    return false;
+  }
+  RegLocation rl_dest = InlineTarget(info);
+  if (size != k64) {
+    RegLocation rl_src = LoadValue(info->args[0], kCoreReg);
+    RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+    RegStorage r_tmp = AllocTemp();
+    GenBitCount32(rl_result.reg, rl_src.reg, r_tmp);
+    FreeTemp(r_tmp);
+    StoreValue(rl_dest, rl_result);
+    return true;
+  }
+  RegLocation rl_src = LoadValueWide(info->args[0], kCoreReg);
+  if (!cu_->target64) {
+    RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+    RegStorage r_high = AllocTemp();
+    RegStorage r_tmp = AllocTemp();
+    GenBitCount32(rl_result.reg, rl_src.reg.GetLow(), r_tmp);
+    GenBitCount32(r_high, rl_src.reg.GetHigh(), r_tmp);
+    OpRegReg(kOpAdd, rl_result.reg, r_high);
+    FreeTemp(r_high);
+    FreeTemp(r_tmp);
+    StoreValue(rl_dest, rl_result);
+    return true;
+  }
+  // The same reduction on all 64 bits; the masks don't fit in an immediate.
+  RegStorage r_value = AllocTempWide();
+  RegStorage r_tmp = AllocTempWide();
+  RegStorage r_mask = AllocTempWide();
+  LoadConstantWide(r_mask, INT64_C(0x5555555555555555));
+  OpRegRegImm(kOpLsr, r_tmp, rl_src.reg, 1);
+  OpRegReg(kOpAnd, r_tmp, r_mask);
+  OpRegRegReg(kOpSub, r_value, rl_src.reg, r_tmp);
+  LoadConstantWide(r_mask, INT64_C(0x3333333333333333));
+  OpRegRegImm(kOpLsr, r_tmp, r_value, 2);
+  OpRegReg(kOpAnd, r_tmp, r_mask);
+  OpRegReg(kOpAnd, r_value, r_mask);
+  OpRegReg(kOpAdd, r_value, r_tmp);
+  LoadConstantWide(r_mask, INT64_C(0x0f0f0f0f0f0f0f0f));
+  OpRegRegImm(kOpLsr, r_tmp, r_value, 4);
+  OpRegReg(kOpAdd, r_value, r_tmp);
+  OpRegReg(kOpAnd, r_value, r_mask);
+  OpRegRegImm(kOpLsr, r_tmp, r_value, 8);
+  OpRegReg(kOpAdd, r_value, r_tmp);
+  OpRegRegImm(kOpLsr, r_tmp, r_value, 16);
+  OpRegReg(kOpAdd, r_value, r_tmp);
+  OpRegRegImm(kOpLsr, r_tmp, r_value, 32);
+  OpRegReg(kOpAdd, r_value, r_tmp);
+  FreeTemp(r_mask);
+  FreeTemp(r_tmp);
+  RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+  OpRegRegImm(kOpAnd, rl_result.reg, RegStorage::Solo32(r_value.GetRegNum()), 0x7f);
+  FreeTemp(r_value);
+  StoreValue(rl_dest, rl_result);
+  return true;
+}
+
+bool Mir2Lir::GenInlinedNumberOfLeadingZeros(CallInfo* /*info*/, OpSize /*size*/) {
+  // Needs a count leading zeros instruction, implemented by the targets.
+  return false;
+}
+
+bool Mir2Lir::GenInlinedNumberOfTrailingZeros(CallInfo* /*info*/, OpSize /*size*/) {
+  // Needs a count leading zeros or bit scan instruction, implemented by the targets.
+  return false;
+}
+
+/*
+ * Integer/Long.rotateRight() and rotateLeft(). A constant distance becomes a pair of shifts;
+ * a variable one needs a rotate by register which takes the distance modulo the width.
+ */
+bool Mir2Lir::GenInlinedRotate(CallInfo* info, OpSize size, bool is_left) {
+  bool is_long = (size == k64);
+  RegLocation rl_shift = info->args[is_long ? 2 : 1];
+  if (cu_->instruction_set == kMips || (is_long && !cu_->target64) ||
+      (!rl_shift.is_const && cu_->instruction_set != kThumb2 &&
+       cu_->instruction_set != kArm64)) {
+    // Not implemented for MIPS, a long pair would need shifts across registers and only ARM
+    // has a rotate by register.
+    return false;
+  }
+  int bits = is_long ? 64 : 32;
+  RegLocation rl_src = is_long ? LoadValueWide(info->args[0], kCoreReg)
+                               : LoadValue(info->args[0], kCoreReg);
+  RegLocation rl_dest = is_long ? InlineTargetWide(info) : InlineTarget(info);
+  RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+  if (rl_shift.is_const) {
+    int shift = mir_graph_->ConstantValue(rl_shift) & (bits - 1);
+    if (is_left) {
+      shift = (bits - shift) & (bits - 1);
+    }
+    if (shift == 0) {
+      OpRegCopy(rl_result.reg, rl_src.reg);
+    } else {
+      RegStorage r_tmp = is_long ? AllocTempWide() : AllocTemp();
+      OpRegRegImm(kOpLsr, r_tmp, rl_src.reg, shift);
+      OpRegRegImm(kOpLsl, rl_result.reg, rl_src.reg, bits - shift);
+      OpRegReg(kOpOr, rl_result.reg, r_tmp);
+      FreeTemp(r_tmp);
+    }
+  } else {
+    rl_shift = LoadValue(rl_shift, kCoreReg);
+    RegStorage r_shift = is_long ? AllocTempWide() : AllocTemp();
+    // The upper half of a long distance doesn't matter modulo 64.
+    OpRegCopy(is_long ? RegStorage::Solo32(r_shift.GetRegNum()) : r_shift, rl_shift.reg);
+    if (is_left) {
+      OpRegReg(kOpNeg, r_shift, r_shift);
+    }
+    OpRegRegReg(kOpRor, rl_result.reg, rl_src.reg, r_shift);
+    FreeTemp(r_shift);
+  }
+  if (is_long) {
+    StoreValueWide(rl_dest, rl_result);
+  } else {
+    StoreValue(rl_dest, rl_result);
+  }
+  return true;
+}
+
+bool Mir2Lir::GenInlinedCeil(CallInfo* /*info*/) {
+  // Needs a rounding instruction, implemented by the targets.
+  return false;
+}
+
+bool Mir2Lir::GenInlinedFloor(CallInfo* /*info*/) {
+  // Needs a rounding instruction, implemented by the targets.
+  return false;
+}
+
+bool Mir2Lir::GenInlinedRint(CallInfo* /*info*/) {
+  // Needs a rounding instruction, implemented by the targets.
+  return false;
+}
+
+bool Mir2Lir::GenInlinedRound(CallInfo* /*info*/, bool /*is_double*/) {
+  // Needs a rounding conversion instruction, implemented by the targets.
   return false;
 }
 
@@ -966,6 +966,23 @@ class Mir2Lir : public Backend {
     bool GenInlinedFloatCvt(CallInfo* info);
     bool GenInlinedDoubleCvt(CallInfo* info);
     virtual bool GenInlinedArrayCopyCharArray(CallInfo* info);
+    virtual bool GenInlinedArrayCopy(CallInfo* info, OpSize size);
+    virtual bool GenInlinedArraysFill(CallInfo* info, OpSize size);
+    virtual bool GenInlinedArraysEquals(CallInfo* info, OpSize size);
+    virtual bool GenInlinedStringEquals(CallInfo* info);
+    virtual bool GenInlinedBitCount(CallInfo* info, OpSize size);
+    virtual bool GenInlinedNumberOfLeadingZeros(CallInfo* info, OpSize size);
+    virtual bool GenInlinedNumberOfTrailingZeros(CallInfo* info, OpSize size);
+    virtual bool GenInlinedRotate(CallInfo* info, OpSize size, bool is_left);
+    virtual bool GenInlinedCeil(CallInfo* info);
+    virtual bool GenInlinedFloor(CallInfo* info);
+    virtual bool GenInlinedRint(CallInfo* info);
+    virtual bool GenInlinedRound(CallInfo* info, bool is_double);
+    void GenBitCount32(RegStorage r_dest, RegStorage r_src, RegStorage r_tmp);
+    // Returns a new temp pointing at element r_index of r_array, or at element 0 if r_index
+    // isn't valid. The index must be non-negative.
+    RegStorage GenArrayDataAddress(RegStorage r_array, RegStorage r_index, int scale,
+                                   int data_offset);
     virtual bool GenInlinedIndexOf(CallInfo* info, bool zero_based);
     bool GenInlinedStringCompareTo(CallInfo* info);
     bool GenInlinedCurrentThread(CallInfo* info);
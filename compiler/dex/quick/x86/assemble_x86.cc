@@ -413,6 +413,7 @@ ENCODING_MAP(Cmp, IS_LOAD, 0, 0,
   { kX86PextrbMRI, kMemRegImm, IS_QUAD_OP     | REG_USE02 | IS_STORE, { 0x66, 0, 0x0F, 0x3A, 0x16, 0, 0, 1, false }, "kX86PextrbMRI", "[!0r+!1d],!2r,!3d" },
   { kX86PextrwMRI, kMemRegImm, IS_QUAD_OP     | REG_USE02 | IS_STORE, { 0x66, 0, 0x0F, 0x3A, 0x16, 0, 0, 1, false }, "kX86PextrwMRI", "[!0r+!1d],!2r,!3d" },
   { kX86PextrdMRI, kMemRegImm, IS_QUAD_OP     | REG_USE02 | IS_STORE, { 0x66, 0, 0x0F, 0x3A, 0x16, 0, 0, 1, false }, "kX86PextrdMRI", "[!0r+!1d],!2r,!3d" },
+  { kX86RoundsdRRI, kRegRegImm, IS_TERTIARY_OP | REG_DEF0 | REG_USE1, { 0x66, 0, 0x0F, 0x3A, 0x0B, 0, 0, 1, false }, "RoundsdRRI", "!0r,!1r,!2d" },
 
   { kX86PshuflwRRI, kRegRegImm, IS_TERTIARY_OP | REG_DEF0 | REG_USE1, { 0xF2, 0, 0x0F, 0x70, 0, 0, 0, 1, false }, "PshuflwRRI", "!0r,!1r,!2d" },
   { kX86PshufdRRI,  kRegRegImm, IS_TERTIARY_OP | REG_DEF0 | REG_USE1, { 0x66, 0, 0x0F, 0x70, 0, 0, 0, 1, false }, "PshuffRRI", "!0r,!1r,!2d" },
@@ -508,6 +509,10 @@ ENCODING_MAP(Cmp, IS_LOAD, 0, 0,
   EXT_0F_ENCODING_MAP(Movzx16q, REX_W, 0xB7, REG_DEF0),
   EXT_0F_ENCODING_MAP(Movsx8q,  REX, 0xBE, REG_DEF0),
   EXT_0F_ENCODING_MAP(Movsx16q, REX_W, 0xBF, REG_DEF0),
+  EXT_0F_ENCODING_MAP(Bsf32, 0x00, 0xBC, REG_DEF0 | SETS_CCODES),
+  EXT_0F_ENCODING_MAP(Bsr32, 0x00, 0xBD, REG_DEF0 | SETS_CCODES),
+  EXT_0F_ENCODING_MAP(Bsf64, REX_W, 0xBC, REG_DEF0 | SETS_CCODES),
+  EXT_0F_ENCODING_MAP(Bsr64, REX_W, 0xBD, REG_DEF0 | SETS_CCODES),
 #undef EXT_0F_ENCODING_MAP
 
   { kX86Jcc8,  kJcc,  IS_BINARY_OP | IS_BRANCH | NEEDS_FIXUP | USES_CCODES, { 0,             0, 0x70, 0,    0, 0, 0, 0, false }, "Jcc8",  "!1c !0t" },
@@ -176,6 +176,12 @@ class X86Mir2Lir : public Mir2Lir {
   bool GenInlinedSqrt(CallInfo* info);
   bool GenInlinedAbsFloat(CallInfo* info) OVERRIDE;
   bool GenInlinedAbsDouble(CallInfo* info) OVERRIDE;
+  bool GenInlinedCeil(CallInfo* info) OVERRIDE;
+  bool GenInlinedFloor(CallInfo* info) OVERRIDE;
+  bool GenInlinedRint(CallInfo* info) OVERRIDE;
+  bool GenInlinedNumberOfLeadingZeros(CallInfo* info, OpSize size) OVERRIDE;
+  bool GenInlinedNumberOfTrailingZeros(CallInfo* info, OpSize size) OVERRIDE;
+  bool GenInlinedRotate(CallInfo* info, OpSize size, bool is_left) OVERRIDE;
   bool GenInlinedPeek(CallInfo* info, OpSize size);
   bool GenInlinedPoke(CallInfo* info, OpSize size);
   bool GenInlinedCharAt(CallInfo* info) OVERRIDE;
@@ -530,6 +536,14 @@ class X86Mir2Lir : public Mir2Lir {
   bool IsByteRegister(RegStorage reg);
   bool GenInlinedArrayCopyCharArray(CallInfo* info) OVERRIDE;
 
+  /*
+   * @brief Generate roundsd for Math.ceil, floor and rint when SSE4.1 is available.
+   * @param info Call parameters
+   * @param rounding_mode The roundsd immediate selecting the rounding direction.
+   * @returns true if the intrinsic was generated.
+   */
+  bool GenInlinedRoundsd(CallInfo* info, int rounding_mode);
+
   /*
    * @brief generate inline code for fast case of Strng.indexOf.
    * @param info Call parameters
@@ -694,6 +708,17 @@ class X86Mir2Lir : public Mir2Lir {
    */
   void GenSetVector(BasicBlock *bb, MIR *mir);
 
+  /*
+   * @brief Load or store a vector from/to consecutive primitive array elements.
+   * @param bb The basic block in which the MIR is from.
+   * @param mir The MIR whose opcode is kMirOpPackedArrayGet or kMirOpPackedArrayPut.
+   * @param is_store 'true' for kMirOpPackedArrayPut.
+   * @note vA: vector register.
+   * @note vB: array VR, vC: index VR.
+   * @note arg[0]: TypeSize.
+   */
+  void GenPackedArrayAccess(BasicBlock *bb, MIR *mir, bool is_store);
+
   /*
    * @brief Generate code for a vector opcode.
    * @param bb The basic block in which the MIR is from.
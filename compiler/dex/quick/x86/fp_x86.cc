@@ -593,6 +593,31 @@ bool X86Mir2Lir::GenInlinedSqrt(CallInfo* info) {
   return true;
 }
 
+bool X86Mir2Lir::GenInlinedRoundsd(CallInfo* info, int rounding_mode) {
+  if (!cu_->GetInstructionSetFeatures().HasSse4_1()) {
+    return false;
+  }
+  RegLocation rl_src = info->args[0];
+  RegLocation rl_dest = InlineTargetWide(info);
+  rl_src = LoadValueWide(rl_src, kFPReg);
+  RegLocation rl_result = EvalLoc(rl_dest, kFPReg, true);
+  NewLIR3(kX86RoundsdRRI, rl_result.reg.GetReg(), rl_src.reg.GetReg(), rounding_mode);
+  StoreValueWide(rl_dest, rl_result);
+  return true;
+}
+
+bool X86Mir2Lir::GenInlinedCeil(CallInfo* info) {
+  return GenInlinedRoundsd(info, 2);  // Round toward positive infinity.
+}
+
+bool X86Mir2Lir::GenInlinedFloor(CallInfo* info) {
+  return GenInlinedRoundsd(info, 1);  // Round toward negative infinity.
+}
+
+bool X86Mir2Lir::GenInlinedRint(CallInfo* info) {
+  return GenInlinedRoundsd(info, 0);  // Round to nearest even.
+}
+
 bool X86Mir2Lir::GenInlinedAbsFloat(CallInfo* info) {
   // Get the argument
   RegLocation rl_src = info->args[0];
@@ -822,6 +822,83 @@ bool X86Mir2Lir::GenInlinedMinMax(CallInfo* info, bool is_min, bool is_long) {
   return true;
 }
 
+bool X86Mir2Lir::GenInlinedRotate(CallInfo* info, OpSize size, bool is_left) {
+  bool is_long = (size == k64);
+  RegLocation rl_shift = info->args[is_long ? 2 : 1];
+  if (rl_shift.is_const || (is_long && !cu_->target64)) {
+    return Mir2Lir::GenInlinedRotate(info, size, is_left);
+  }
+
+  // A variable rotate takes its distance in CL and masks it to the operand width.
+  FlushAllRegs();
+  LockTemp(rs_rCX);
+  LoadValueDirectFixed(rl_shift, rs_rCX);
+  if (is_left) {
+    OpReg(kOpNeg, rs_rCX);
+  }
+  RegLocation rl_src = is_long ? LoadValueWide(info->args[0], kCoreReg)
+                               : LoadValue(info->args[0], kCoreReg);
+  RegLocation rl_dest = is_long ? InlineTargetWide(info) : InlineTarget(info);
+  RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+  OpRegCopy(rl_result.reg, rl_src.reg);
+  OpRegReg(kOpRor, rl_result.reg, rs_rCX);
+  FreeTemp(rs_rCX);
+  if (is_long) {
+    StoreValueWide(rl_dest, rl_result);
+  } else {
+    StoreValue(rl_dest, rl_result);
+  }
+  return true;
+}
+
+bool X86Mir2Lir::GenInlinedNumberOfLeadingZeros(CallInfo* info, OpSize size) {
+  bool is_long = (size == k64);
+  if (is_long && !cu_->target64) {
+    return false;
+  }
+  RegLocation rl_src = is_long ? LoadValueWide(info->args[0], kCoreReg)
+                               : LoadValue(info->args[0], kCoreReg);
+  RegLocation rl_dest = InlineTarget(info);
+  RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+  RegStorage r_tmp = is_long ? AllocTempWide() : AllocTemp();
+  RegStorage r_tmp32 = is_long ? As32BitReg(r_tmp) : r_tmp;
+
+  // bsr gives the index of the highest set bit and sets ZF for a zero input, in which
+  // case the index is taken as -1 so that the subtraction below yields the full width.
+  NewLIR2(is_long ? kX86Bsr64RR : kX86Bsr32RR, r_tmp.GetReg(), rl_src.reg.GetReg());
+  LIR* non_zero = OpCondBranch(kCondNe, nullptr);
+  LoadConstant(r_tmp32, -1);
+  non_zero->target = NewLIR0(kPseudoTargetLabel);
+  LoadConstant(rl_result.reg, is_long ? 63 : 31);
+  OpRegReg(kOpSub, rl_result.reg, r_tmp32);
+  FreeTemp(r_tmp);
+  StoreValue(rl_dest, rl_result);
+  return true;
+}
+
+bool X86Mir2Lir::GenInlinedNumberOfTrailingZeros(CallInfo* info, OpSize size) {
+  bool is_long = (size == k64);
+  if (is_long && !cu_->target64) {
+    return false;
+  }
+  RegLocation rl_src = is_long ? LoadValueWide(info->args[0], kCoreReg)
+                               : LoadValue(info->args[0], kCoreReg);
+  RegLocation rl_dest = InlineTarget(info);
+  RegLocation rl_result = EvalLoc(rl_dest, kCoreReg, true);
+  RegStorage r_tmp = is_long ? AllocTempWide() : AllocTemp();
+  RegStorage r_tmp32 = is_long ? As32BitReg(r_tmp) : r_tmp;
+
+  // bsf gives the index of the lowest set bit; a zero input has every bit trailing.
+  NewLIR2(is_long ? kX86Bsf64RR : kX86Bsf32RR, r_tmp.GetReg(), rl_src.reg.GetReg());
+  LIR* non_zero = OpCondBranch(kCondNe, nullptr);
+  LoadConstant(r_tmp32, is_long ? 64 : 32);
+  non_zero->target = NewLIR0(kPseudoTargetLabel);
+  OpRegCopy(rl_result.reg, r_tmp32);
+  FreeTemp(r_tmp);
+  StoreValue(rl_dest, rl_result);
+  return true;
+}
+
 bool X86Mir2Lir::GenInlinedPeek(CallInfo* info, OpSize size) {
   RegLocation rl_src_address = info->args[0];  // long address
   RegLocation rl_address;
@@ -1099,8 +1099,8 @@ void X86Mir2Lir::InstallLiteralPools() {
 
 bool X86Mir2Lir::GenInlinedArrayCopyCharArray(CallInfo* info) {
   if (cu_->target64) {
-    // TODO: Implement ArrayCOpy intrinsic for x86_64
-    return false;
+    // x86_64 has enough registers for the generic element loop.
+    return Mir2Lir::GenInlinedArrayCopyCharArray(info);
   }
 
   RegLocation rl_src = info->args[0];
@@ -1710,6 +1710,12 @@ void X86Mir2Lir::GenMachineSpecificExtendedMethodMIR(BasicBlock* bb, MIR* mir) {
     case kMirOpPackedSet:
       GenSetVector(bb, mir);
       break;
+    case kMirOpPackedArrayGet:
+      GenPackedArrayAccess(bb, mir, false);
+      break;
+    case kMirOpPackedArrayPut:
+      GenPackedArrayAccess(bb, mir, true);
+      break;
     default:
       break;
   }
@@ -2302,17 +2308,27 @@ void X86Mir2Lir::GenSetVector(BasicBlock *bb, MIR *mir) {
   }
 
   // If opsize is 8 bits wide then double value and use 16 bit shuffle instead.
+  // Work on a copy: rl_src may be the promoted home of a live VR.
+  RegStorage rs_src = rl_src.reg;
+  RegStorage temp;
   if (opsize == kSignedByte || opsize == kUnsignedByte) {
-    RegStorage temp = AllocTemp();
-    // val = val + (val << 8).
+    temp = AllocTemp();
+    RegStorage temp2 = AllocTemp();
+    // val = (val & 0xff) | ((val & 0xff) << 8).
     NewLIR2(kX86Mov32RR, temp.GetReg(), rl_src.reg.GetReg());
-    NewLIR2(kX86Sal32RI, temp.GetReg(), 8);
-    NewLIR2(kX86Or32RR, rl_src.reg.GetReg(), temp.GetReg());
-    FreeTemp(temp);
+    NewLIR2(kX86And32RI, temp.GetReg(), 0xff);
+    NewLIR2(kX86Mov32RR, temp2.GetReg(), temp.GetReg());
+    NewLIR2(kX86Sal32RI, temp2.GetReg(), 8);
+    NewLIR2(kX86Or32RR, temp.GetReg(), temp2.GetReg());
+    FreeTemp(temp2);
+    rs_src = temp;
   }
 
   // Load the value into the XMM register.
-  NewLIR2(op_mov, rs_dest.GetReg(), rl_src.reg.GetReg());
+  NewLIR2(op_mov, rs_dest.GetReg(), rs_src.GetReg());
+  if (temp.Valid()) {
+    FreeTemp(temp);
+  }
 
   // Now shuffle the value across the destination.
   NewLIR3(op_low, rs_dest.GetReg(), rs_dest.GetReg(), imm);
@@ -2323,6 +2339,49 @@ void X86Mir2Lir::GenSetVector(BasicBlock *bb, MIR *mir) {
   }
 }
 
+void X86Mir2Lir::GenPackedArrayAccess(BasicBlock *bb, MIR *mir, bool is_store) {
+  DCHECK_EQ(mir->dalvikInsn.arg[0] & 0xFFFF, 128U);
+  OpSize opsize = static_cast<OpSize>(mir->dalvikInsn.arg[0] >> 16);
+  RegStorage rs_vector = RegStorage::Solo128(mir->dalvikInsn.vA);
+  int data_offset = mirror::Array::DataOffset(sizeof(int32_t)).Int32Value();
+  int scale = 0;
+
+  switch (opsize) {
+    case k64:
+    case kDouble:
+      data_offset = mirror::Array::DataOffset(sizeof(int64_t)).Int32Value();
+      scale = 3;
+      break;
+    case k32:
+    case kSingle:
+      scale = 2;
+      break;
+    case kSignedHalf:
+    case kUnsignedHalf:
+      scale = 1;
+      break;
+    case kSignedByte:
+    case kUnsignedByte:
+      scale = 0;
+      break;
+    default:
+      LOG(FATAL) << "Unsupported vector array access " << opsize;
+      break;
+  }
+
+  // No null or bounds checks: the producer of this MIR has already proven that
+  // the array is non-null and that all elements of the vector are in bounds.
+  RegLocation rl_array = LoadValue(mir_graph_->GetSrc(mir, 0), kRefReg);
+  RegLocation rl_index = LoadValue(mir_graph_->GetSrc(mir, 1), kCoreReg);
+  if (is_store) {
+    NewLIR5(kX86MovupsAR, rl_array.reg.GetReg(), rl_index.reg.GetReg(), scale, data_offset,
+            rs_vector.GetReg());
+  } else {
+    NewLIR5(kX86MovupsRA, rs_vector.GetReg(), rl_array.reg.GetReg(), rl_index.reg.GetReg(), scale,
+            data_offset);
+  }
+}
+
 LIR *X86Mir2Lir::ScanVectorLiteral(MIR *mir) {
   int *args = reinterpret_cast<int*>(mir->dalvikInsn.arg);
   for (LIR *p = const_vectors_; p != nullptr; p = p->next) {
@@ -217,6 +217,7 @@ LIR* X86Mir2Lir::OpRegReg(OpKind op, RegStorage r_dest_src1, RegStorage r_src2)
       case kOpLsl: opcode = is64Bit ? kX86Sal64RC : kX86Sal32RC; src2_must_be_cx = true; break;
       case kOpLsr: opcode = is64Bit ? kX86Shr64RC : kX86Shr32RC; src2_must_be_cx = true; break;
       case kOpAsr: opcode = is64Bit ? kX86Sar64RC : kX86Sar32RC; src2_must_be_cx = true; break;
+      case kOpRor: opcode = is64Bit ? kX86Ror64RC : kX86Ror32RC; src2_must_be_cx = true; break;
       case kOpMov: opcode = is64Bit ? kX86Mov64RR : kX86Mov32RR; break;
       case kOpCmp: opcode = is64Bit ? kX86Cmp64RR : kX86Cmp32RR; break;
       case kOpAdd: opcode = is64Bit ? kX86Add64RR : kX86Add32RR; break;
@@ -938,6 +939,18 @@ void X86Mir2Lir::AnalyzeExtendedMIR(int opcode, BasicBlock * bb, MIR *mir) {
     case kMirOpConstVector:
       store_method_addr_ = true;
       break;
+    case kMirOpPackedMultiply:
+    case kMirOpPackedShiftLeft:
+    case kMirOpPackedSignedShiftRight:
+    case kMirOpPackedUnsignedShiftRight:
+    case kMirOpPackedAddReduce: {
+      // Byte vectors are emulated with 16 bit operations and masks from the literal pool.
+      OpSize opsize = static_cast<OpSize>(mir->dalvikInsn.vC >> 16);
+      if (opsize == kSignedByte || opsize == kUnsignedByte) {
+        store_method_addr_ = true;
+      }
+      break;
+    }
     default:
       // Ignore the rest.
       break;
@@ -579,6 +579,7 @@ enum X86OpCode {
   kX86PextrbMRI,                // Extract 8 bits from XMM into memory
   kX86PextrwMRI,                // Extract 16 bits from XMM into memory
   kX86PextrdMRI,                // Extract 32 bits from XMM into memory
+  kX86RoundsdRRI,               // Round double using the immediate rounding mode (SSE4.1)
   kX86PshuflwRRI,               // Shuffle 16 bits in lower 64 bits of XMM.
   kX86PshufdRRI,                // Shuffle 32 bits in XMM.
   kX86ShufpsRRI,                // FP Shuffle 32 bits in XMM.
@@ -634,6 +635,10 @@ enum X86OpCode {
   Binary0fOpCode(kX86Movzx16q),  // zero-extend 16-bit value to quad word
   Binary0fOpCode(kX86Movsx8q),   // sign-extend 8-bit value to quad word
   Binary0fOpCode(kX86Movsx16q),  // sign-extend 16-bit value to quad word
+  Binary0fOpCode(kX86Bsf32),     // index of lowest set bit
+  Binary0fOpCode(kX86Bsr32),     // index of highest set bit
+  Binary0fOpCode(kX86Bsf64),     // index of lowest set bit in quad word
+  Binary0fOpCode(kX86Bsr64),     // index of highest set bit in quad word
 #undef Binary0fOpCode
   kX86Jcc8, kX86Jcc32,  // jCC rel8/32; lir operands - 0: rel, 1: CC, target assigned
   kX86Jmp8, kX86Jmp32,  // jmp rel8/32; lir operands - 0: rel, target assigned
@@ -525,4 +525,40 @@ void MIRGraph::RemapRegLocations() {
   }
 }
 
+/*
+ * Registers of inlined callees live past the method's own Dalvik registers
+ * during the optimizations. The runtime frame layout has no room there, so
+ * home them in non-special compiler temps instead. Must run after
+ * RemapRegLocations() so that the s_reg_low names still index the inlined
+ * registers' initial SSA names.
+ */
+void MIRGraph::MapInlinedVRegsToCompilerTemps() {
+  if (num_inlined_vregs_ == 0u) {
+    return;
+  }
+  // Only the Method* temp may exist at this point, and it must stay at position 0.
+  DCHECK_EQ(GetNumUsedCompilerTemps(), 1u);
+  DCHECK_EQ(num_non_special_compiler_temps_, 0u);
+  int num_inlined_vregs = static_cast<int>(num_inlined_vregs_);
+  int first_inlined_vreg = cu_->num_dalvik_registers;
+  // The high half of a wide value must live at the next higher address, i.e. in the next
+  // less negative temp, so the lowest inlined register gets the most negative temp.
+  int lowest_temp_vreg = static_cast<int>(kVRegNonSpecialTempBaseReg) - (num_inlined_vregs - 1);
+  for (int i = num_inlined_vregs - 1; i >= 0; --i) {
+    CompilerTemp* compiler_temp =
+        static_cast<CompilerTemp*>(arena_->Alloc(sizeof(CompilerTemp), kArenaAllocRegAlloc));
+    compiler_temp->v_reg = lowest_temp_vreg + i;
+    compiler_temp->s_reg_low = first_inlined_vreg + i;
+    compiler_temps_.Insert(compiler_temp);
+    num_non_special_compiler_temps_++;
+  }
+  for (int s_reg = 0; s_reg < GetNumSSARegs(); ++s_reg) {
+    int v_reg = SRegToVReg(s_reg);
+    if (v_reg >= first_inlined_vreg) {
+      DCHECK_LT(v_reg, GetNumOfCodeAndInlinedVRs());
+      ssa_base_vregs_->Put(s_reg, lowest_temp_vreg + (v_reg - first_inlined_vreg));
+    }
+  }
+}
+
 }  // namespace art
@@ -19,6 +19,7 @@
 #define ATRACE_TAG ATRACE_TAG_DALVIK
 #include <utils/Trace.h>
 
+#include <algorithm>
 #include <vector>
 #include <unistd.h>
 
@@ -34,6 +35,7 @@
 #include "dex/verified_method.h"
 #include "dex/quick/dex_file_method_inliner.h"
 #include "driver/compiler_options.h"
+#include "driver/reused_oat_file.h"
 #include "jni_internal.h"
 #include "object_lock.h"
 #include "profiler.h"
@@ -61,6 +63,14 @@
 
 namespace art {
 
+// Shards of each deduplication set per compiler thread, enough to keep threads adding compiled
+// artifacts at the same time from contending on a shard lock.
+static constexpr size_t kDedupeShardsPerThread = 2;
+
+// Dirty memory a compiler thread keeps in free arenas between methods. Most methods fit in a
+// few arenas; the rest is trimmed after compiling an unusually large method.
+static constexpr size_t kMaxFreeArenaBytesPerThread = 4 * MB;
+
 static double Percentage(size_t x, size_t y) {
   return 100.0 * (static_cast<double>(x)) / (static_cast<double>(x + y));
 }
@@ -350,15 +360,16 @@ CompilerDriver::CompilerDriver(const CompilerOptions* compiler_options,
       timings_logger_(timer),
       compiler_library_(NULL),
       compiler_context_(NULL),
+      arena_pools_lock_("compiler arena pools lock"),
       compiler_enable_auto_elf_loading_(NULL),
       compiler_get_method_code_addr_(NULL),
       support_boot_image_fixup_(instruction_set != kMips),
       cfi_info_(nullptr),
-      dedupe_code_("dedupe code"),
-      dedupe_mapping_table_("dedupe mapping table"),
-      dedupe_vmap_table_("dedupe vmap table"),
-      dedupe_gc_map_("dedupe gc map"),
-      dedupe_cfi_info_("dedupe cfi info") {
+      dedupe_code_("dedupe code", thread_count * kDedupeShardsPerThread),
+      dedupe_mapping_table_("dedupe mapping table", thread_count * kDedupeShardsPerThread),
+      dedupe_vmap_table_("dedupe vmap table", thread_count * kDedupeShardsPerThread),
+      dedupe_gc_map_("dedupe gc map", thread_count * kDedupeShardsPerThread),
+      dedupe_cfi_info_("dedupe cfi info", thread_count * kDedupeShardsPerThread) {
   DCHECK(compiler_options_ != nullptr);
   DCHECK(verification_results_ != nullptr);
   DCHECK(method_inliner_map_ != nullptr);
@@ -369,7 +380,8 @@ CompilerDriver::CompilerDriver(const CompilerOptions* compiler_options,
 
   compiler_->Init();
 
-  CHECK(!Runtime::Current()->IsStarted());
+  // Only the JIT creates a driver in a started runtime, and it never compiles an image.
+  CHECK(!image_ || !Runtime::Current()->IsStarted());
   if (image_) {
     CHECK(image_classes_.get() != nullptr);
   } else {
@@ -392,25 +404,25 @@ CompilerDriver::CompilerDriver(const CompilerOptions* compiler_options,
   }
 }
 
-std::vector<uint8_t>* CompilerDriver::DeduplicateCode(const std::vector<uint8_t>& code) {
+ArrayRef<const uint8_t> CompilerDriver::DeduplicateCode(const std::vector<uint8_t>& code) {
   return dedupe_code_.Add(Thread::Current(), code);
 }
 
-std::vector<uint8_t>* CompilerDriver::DeduplicateMappingTable(const std::vector<uint8_t>& code) {
+ArrayRef<const uint8_t> CompilerDriver::DeduplicateMappingTable(const std::vector<uint8_t>& code) {
   return dedupe_mapping_table_.Add(Thread::Current(), code);
 }
 
-std::vector<uint8_t>* CompilerDriver::DeduplicateVMapTable(const std::vector<uint8_t>& code) {
+ArrayRef<const uint8_t> CompilerDriver::DeduplicateVMapTable(const std::vector<uint8_t>& code) {
   return dedupe_vmap_table_.Add(Thread::Current(), code);
 }
 
-std::vector<uint8_t>* CompilerDriver::DeduplicateGCMap(const std::vector<uint8_t>& code) {
+ArrayRef<const uint8_t> CompilerDriver::DeduplicateGCMap(const std::vector<uint8_t>& code) {
   return dedupe_gc_map_.Add(Thread::Current(), code);
 }
 
-std::vector<uint8_t>* CompilerDriver::DeduplicateCFIInfo(const std::vector<uint8_t>* cfi_info) {
+ArrayRef<const uint8_t> CompilerDriver::DeduplicateCFIInfo(const std::vector<uint8_t>* cfi_info) {
   if (cfi_info == nullptr) {
-    return nullptr;
+    return ArrayRef<const uint8_t>();
   }
   return dedupe_cfi_info_.Add(Thread::Current(), *cfi_info);
 }
@@ -439,6 +451,10 @@ CompilerDriver::~CompilerDriver() {
   }
   CHECK_PTHREAD_CALL(pthread_key_delete, (tls_key_), "delete tls key");
   compiler_->UnInit();
+  {
+    MutexLock mu(self, arena_pools_lock_);
+    STLDeleteElements(&arena_pools_);
+  }
 }
 
 CompilerTls* CompilerDriver::GetTls() {
@@ -451,6 +467,37 @@ CompilerTls* CompilerDriver::GetTls() {
   return res;
 }
 
+ArenaPool* CompilerDriver::GetArenaPool() {
+  CompilerTls* tls = GetTls();
+  ArenaPool* pool = tls->GetArenaPool();
+  if (pool == nullptr) {
+    // Mem map backed arenas let an idle thread's free arenas be madvised away while the
+    // address space is kept for the next method. Allocations are only counted per kind for
+    // --dump-stats.
+    pool = new ArenaPool(true, kMaxFreeArenaBytesPerThread, dump_stats_);
+    tls->SetArenaPool(pool);
+    MutexLock mu(Thread::Current(), arena_pools_lock_);
+    arena_pools_.push_back(pool);
+  }
+  return pool;
+}
+
+void CompilerDriver::TrimArenaPools() {
+  MutexLock mu(Thread::Current(), arena_pools_lock_);
+  for (ArenaPool* pool : arena_pools_) {
+    pool->TrimFreeArenas();
+  }
+}
+
+ArenaPoolUsage CompilerDriver::GetArenaPoolUsage() {
+  ArenaPoolUsage usage;
+  MutexLock mu(Thread::Current(), arena_pools_lock_);
+  for (ArenaPool* pool : arena_pools_) {
+    usage.Merge(pool->GetUsage());
+  }
+  return usage;
+}
+
 #define CREATE_TRAMPOLINE(type, abi, offset) \
     if (Is64BitInstructionSet(instruction_set_)) { \
       return CreateTrampoline64(instruction_set_, abi, \
@@ -501,15 +548,37 @@ const std::vector<uint8_t>* CompilerDriver::CreateQuickToInterpreterBridge() con
 }
 #undef CREATE_TRAMPOLINE
 
+void CompilerDriver::SetReusedOatFile(ReusedOatFile* reused_oat_file) {
+  CHECK(!IsImage()) << "Images embed absolute addresses and cannot reuse code";
+  CHECK(!compiler_options_->GetIncludePatchInformation());
+  reused_oat_file_.reset(reused_oat_file);
+}
+
 void CompilerDriver::CompileAll(jobject class_loader,
                                 const std::vector<const DexFile*>& dex_files,
                                 TimingLogger* timings) {
   DCHECK(!Runtime::Current()->IsStarted());
   std::unique_ptr<ThreadPool> thread_pool(new ThreadPool("Compiler driver thread pool", thread_count_ - 1));
   PreCompile(class_loader, dex_files, thread_pool.get(), timings);
+  if (reused_oat_file_.get() != nullptr) {
+    reused_oat_file_->Setup(*this, dex_files, timings);
+  }
   Compile(class_loader, dex_files, thread_pool.get(), timings);
+  // The arenas are not needed again until the next compilation, leave the memory to the
+  // oat and image writers.
+  TrimArenaPools();
+  if (reused_oat_file_.get() != nullptr) {
+    VLOG(compiler) << "Reused " << reused_oat_file_->GetReusedMethodCount()
+                   << " compiled methods, recompiled "
+                   << reused_oat_file_->GetRecompiledMethodCount();
+  }
   if (dump_stats_) {
     stats_->Dump();
+    ArenaPoolUsage arena_usage = GetArenaPoolUsage();
+    LOG(INFO) << Dumpable<ArenaPoolUsage>(arena_usage);
+  } else if (VLOG_IS_ON(compiler)) {
+    ArenaPoolUsage arena_usage = GetArenaPoolUsage();
+    VLOG(compiler) << Dumpable<ArenaPoolUsage>(arena_usage);
   }
 }
 
@@ -546,7 +615,7 @@ static DexToDexCompilationLevel GetDexToDexCompilationlevel(
 }
 
 void CompilerDriver::CompileOne(mirror::ArtMethod* method, TimingLogger* timings) {
-  DCHECK(!Runtime::Current()->IsStarted());
+  const bool runtime_started = Runtime::Current()->IsStarted();
   Thread* self = Thread::Current();
   jobject jclass_loader;
   const DexFile* dex_file;
@@ -570,12 +639,15 @@ void CompilerDriver::CompileOne(mirror::ArtMethod* method, TimingLogger* timings
   std::vector<const DexFile*> dex_files;
   dex_files.push_back(dex_file);
 
-  std::unique_ptr<ThreadPool> thread_pool(new ThreadPool("Compiler driver thread pool", 0U));
-  PreCompile(jclass_loader, dex_files, thread_pool.get(), timings);
+  if (!runtime_started) {
+    std::unique_ptr<ThreadPool> thread_pool(new ThreadPool("Compiler driver thread pool", 0U));
+    PreCompile(jclass_loader, dex_files, thread_pool.get(), timings);
+  }
 
-  // Can we run DEX-to-DEX compiler on this class ?
+  // Can we run DEX-to-DEX compiler on this class ? Never in a started runtime, where the dex file
+  // is mapped read-only and may be executing.
   DexToDexCompilationLevel dex_to_dex_compilation_level = kDontDexToDexCompile;
-  {
+  if (!runtime_started) {
     ScopedObjectAccess soa(Thread::Current());
     const DexFile::ClassDef& class_def = dex_file->GetClassDef(class_def_idx);
     StackHandleScope<1> hs(soa.Self());
@@ -605,16 +677,24 @@ void CompilerDriver::PreCompile(jobject class_loader, const std::vector<const De
                                 ThreadPool* thread_pool, TimingLogger* timings) {
   LoadImageClasses(timings);
 
+  FindHotClasses(dex_files, timings);
+
   if (!compiler_options_->IsVerificationEnabled()) {
     VLOG(compiler) << "Verify none mode specified, skipping pre-compilation";
     return;
   }
 
-  Resolve(class_loader, dex_files, thread_pool, timings);
+  if (IsImage()) {
+    // Image classes are initialized inside transactions that do not yet support multiple
+    // threads, so keep the phases separate and run the initialization single threaded.
+    Resolve(class_loader, dex_files, thread_pool, timings);
 
-  Verify(class_loader, dex_files, thread_pool, timings);
+    Verify(class_loader, dex_files, thread_pool, timings);
 
-  InitializeClasses(class_loader, dex_files, thread_pool, timings);
+    InitializeClasses(class_loader, dex_files, thread_pool, timings);
+  } else {
+    ResolveVerifyAndInitialize(class_loader, dex_files, thread_pool, timings);
+  }
 
   UpdateImageClasses(timings);
 }
@@ -1365,6 +1445,8 @@ class ParallelCompilationManager {
       dex_file_(dex_file),
       thread_pool_(thread_pool) {}
 
+  virtual ~ParallelCompilationManager() {}
+
   ClassLinker* GetClassLinker() const {
     CHECK(class_linker_ != NULL);
     return class_linker_;
@@ -1407,6 +1489,12 @@ class ParallelCompilationManager {
     return index_.FetchAndAddSequentiallyConsistent(1);
   }
 
+ protected:
+  // Invokes the callback for an index handed out by ForAll().
+  virtual void Dispatch(Callback* callback, size_t index) {
+    callback(this, index);
+  }
+
  private:
   class ForAllClosure : public Task {
    public:
@@ -1421,7 +1509,7 @@ class ParallelCompilationManager {
         if (UNLIKELY(index >= end_)) {
           break;
         }
-        callback_(manager_, index);
+        manager_->Dispatch(callback_, index);
         self->AssertNoPendingException();
       }
     }
@@ -1446,6 +1534,59 @@ class ParallelCompilationManager {
   DISALLOW_COPY_AND_ASSIGN(ParallelCompilationManager);
 };
 
+// Runs a per-class callback over the class defs of several dex files from a single shared work
+// queue, so that worker threads are not left idle at the end of each dex file. Class def
+// indices are global across the dex files and are mapped back to a per-dex file
+// ParallelCompilationManager before invoking the callback.
+class MultiDexCompilationManager : public ParallelCompilationManager {
+ public:
+  MultiDexCompilationManager(ClassLinker* class_linker,
+                             jobject class_loader,
+                             CompilerDriver* compiler,
+                             const std::vector<const DexFile*>& dex_files,
+                             ThreadPool* thread_pool)
+    : ParallelCompilationManager(class_linker, class_loader, compiler, nullptr, thread_pool),
+      num_class_defs_(0) {
+    for (const DexFile* dex_file : dex_files) {
+      CHECK(dex_file != NULL);
+      managers_.push_back(new ParallelCompilationManager(class_linker, class_loader, compiler,
+                                                         dex_file, thread_pool));
+      num_class_defs_ += dex_file->NumClassDefs();
+      class_def_ends_.push_back(num_class_defs_);
+    }
+  }
+
+  ~MultiDexCompilationManager() {
+    STLDeleteElements(&managers_);
+  }
+
+  size_t NumClassDefs() const {
+    return num_class_defs_;
+  }
+
+  void ForAllClassDefs(Callback callback, size_t work_units) {
+    ForAll(0, num_class_defs_, callback, work_units);
+  }
+
+ protected:
+  void Dispatch(Callback* callback, size_t index) OVERRIDE {
+    // Find the first dex file whose class defs end beyond the global index.
+    auto it = std::upper_bound(class_def_ends_.begin(), class_def_ends_.end(), index);
+    DCHECK(it != class_def_ends_.end());
+    size_t dex_file_index = it - class_def_ends_.begin();
+    size_t begin = (dex_file_index == 0) ? 0 : class_def_ends_[dex_file_index - 1];
+    callback(managers_[dex_file_index], index - begin);
+  }
+
+ private:
+  size_t num_class_defs_;
+  // Exclusive end of the global class def index range of each dex file.
+  std::vector<size_t> class_def_ends_;
+  std::vector<ParallelCompilationManager*> managers_;
+
+  DISALLOW_COPY_AND_ASSIGN(MultiDexCompilationManager);
+};
+
 // Return true if the class should be skipped during compilation.
 //
 // The first case where we skip is for redundant class definitions in
@@ -1541,7 +1682,9 @@ static void ResolveClassFieldsAndMethods(const ParallelCompilationManager* manag
       CheckAndClearResolveException(soa.Self());
       resolve_fields_and_methods = false;
     } else {
-      resolve_fields_and_methods = manager->GetCompiler()->IsImage();
+      // Hot classes are resolved up front so that their code finds the entries in the dex cache.
+      resolve_fields_and_methods = manager->GetCompiler()->IsImage() ||
+          manager->GetCompiler()->IsHotClass(ClassReference(&dex_file, class_def_index));
     }
     // Note the class_data pointer advances through the headers,
     // static fields, instance fields, direct methods, and virtual
@@ -1828,13 +1971,34 @@ void CompilerDriver::InitializeClasses(jobject class_loader,
   }
 }
 
+static void ResolveVerifyAndInitializeClass(const ParallelCompilationManager* manager,
+                                            size_t class_def_index)
+    LOCKS_EXCLUDED(Locks::mutator_lock_) {
+  // Superclasses and interfaces are resolved, verified and initialized on demand by the class
+  // linker, so a class does not need to wait for the rest of the dex files to finish a phase.
+  ResolveClassFieldsAndMethods(manager, class_def_index);
+  VerifyClass(manager, class_def_index);
+  InitializeClass(manager, class_def_index);
+}
+
+void CompilerDriver::ResolveVerifyAndInitialize(jobject class_loader,
+                                                const std::vector<const DexFile*>& dex_files,
+                                                ThreadPool* thread_pool, TimingLogger* timings) {
+  TimingLogger::ScopedTiming t("Resolve Verify And Initialize", timings);
+  MultiDexCompilationManager context(Runtime::Current()->GetClassLinker(), class_loader, this,
+                                     dex_files, thread_pool);
+  context.ForAllClassDefs(ResolveVerifyAndInitializeClass, thread_count_);
+}
+
 void CompilerDriver::Compile(jobject class_loader, const std::vector<const DexFile*>& dex_files,
                              ThreadPool* thread_pool, TimingLogger* timings) {
-  for (size_t i = 0; i != dex_files.size(); ++i) {
-    const DexFile* dex_file = dex_files[i];
-    CHECK(dex_file != NULL);
-    CompileDexFile(class_loader, *dex_file, thread_pool, timings);
-  }
+  // Code generation consults the verification and initialization state of other classes, so
+  // compilation only starts once the front end is done for all dex files to keep the output
+  // deterministic. Within this phase work is shared across all of the dex files.
+  TimingLogger::ScopedTiming t("Compile Dex Files", timings);
+  MultiDexCompilationManager context(Runtime::Current()->GetClassLinker(), class_loader, this,
+                                     dex_files, thread_pool);
+  context.ForAllClassDefs(CompilerDriver::CompileClass, thread_count_);
 }
 
 void CompilerDriver::CompileClass(const ParallelCompilationManager* manager, size_t class_def_index) {
@@ -1911,14 +2075,6 @@ void CompilerDriver::CompileClass(const ParallelCompilationManager* manager, siz
   DCHECK(!it.HasNext());
 }
 
-void CompilerDriver::CompileDexFile(jobject class_loader, const DexFile& dex_file,
-                                    ThreadPool* thread_pool, TimingLogger* timings) {
-  TimingLogger::ScopedTiming t("Compile Dex File", timings);
-  ParallelCompilationManager context(Runtime::Current()->GetClassLinker(), class_loader, this,
-                                     &dex_file, thread_pool);
-  context.ForAll(0, dex_file.NumClassDefs(), CompilerDriver::CompileClass, thread_count_);
-}
-
 void CompilerDriver::CompileMethod(const DexFile::CodeItem* code_item, uint32_t access_flags,
                                    InvokeType invoke_type, uint16_t class_def_idx,
                                    uint32_t method_idx, jobject class_loader,
@@ -1940,7 +2096,11 @@ void CompilerDriver::CompileMethod(const DexFile::CodeItem* code_item, uint32_t
   } else {
     MethodReference method_ref(&dex_file, method_idx);
     bool compile = verification_results_->IsCandidateForCompilation(method_ref, access_flags);
-    if (compile) {
+    if (compile && reused_oat_file_.get() != nullptr) {
+      compiled_method = reused_oat_file_->CopyCompiledMethod(this, dex_file, class_def_idx,
+                                                             method_idx, code_item);
+    }
+    if (compile && compiled_method == nullptr) {
       // NOTE: if compiler declines to compile this method, it will return NULL.
       compiled_method = compiler_->Compile(code_item, access_flags, invoke_type, class_def_idx,
                                            method_idx, class_loader, dex_file);
@@ -2023,6 +2183,31 @@ CompiledMethod* CompilerDriver::GetCompiledMethod(MethodReference ref) const {
   return it->second;
 }
 
+void CompilerDriver::RemoveCompiledMethod(MethodReference ref) {
+  CompiledMethod* compiled_method = nullptr;
+  {
+    MutexLock mu(Thread::Current(), compiled_methods_lock_);
+    MethodTable::iterator it = compiled_methods_.find(ref);
+    if (it != compiled_methods_.end()) {
+      compiled_method = it->second;
+      compiled_methods_.erase(it);
+    }
+  }
+  delete compiled_method;
+}
+
+void CompilerDriver::ClearDedupeSets() {
+  if (kIsDebugBuild) {
+    MutexLock mu(Thread::Current(), compiled_methods_lock_);
+    CHECK(compiled_methods_.empty());
+  }
+  dedupe_code_.Clear();
+  dedupe_mapping_table_.Clear();
+  dedupe_vmap_table_.Clear();
+  dedupe_gc_map_.Clear();
+  dedupe_cfi_info_.Clear();
+}
+
 void CompilerDriver::AddRequiresConstructorBarrier(Thread* self, const DexFile* dex_file,
                                                    uint16_t class_def_index) {
   WriterMutexLock mu(self, freezing_constructor_lock_);
@@ -2082,26 +2267,108 @@ void CompilerDriver::InstructionSetToLLVMTarget(InstructionSet instruction_set,
     }
   }
 
-bool CompilerDriver::SkipCompilation(const std::string& method_name) {
+bool CompilerDriver::IsHotMethod(const ProfileFile::ProfileData& data) const {
+  // Methods that comprise top_k_threshold % of the total samples are hot.
+  // Compare against the start of the topK percentage bucket just in case the threshold
+  // falls inside a bucket.
+  return data.GetTopKUsedPercentage() - data.GetUsedPercent()
+         <= compiler_options_->GetTopKProfileThreshold();
+}
+
+void CompilerDriver::FindHotClasses(const std::vector<const DexFile*>& dex_files,
+                                    TimingLogger* timings) {
+  if (!profile_present_) {
+    return;
+  }
+  TimingLogger::ScopedTiming t("FindHotClasses", timings);
+  for (const DexFile* dex_file : dex_files) {
+    for (size_t class_def_index = 0; class_def_index != dex_file->NumClassDefs();
+         ++class_def_index) {
+      const byte* class_data = dex_file->GetClassData(dex_file->GetClassDef(class_def_index));
+      if (class_data == nullptr) {
+        continue;
+      }
+      ClassDataItemIterator it(*dex_file, class_data);
+      while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+        it.Next();
+      }
+      for (; it.HasNext(); it.Next()) {
+        ProfileFile::ProfileData data;
+        if (profile_file_.GetProfileData(&data, *dex_file, it.GetMemberIndex()) &&
+            IsHotMethod(data)) {
+          hot_classes_.insert(ClassReference(dex_file, class_def_index));
+          break;
+        }
+      }
+    }
+  }
+  VLOG(compiler) << "Found " << hot_classes_.size() << " classes with hot methods";
+}
+
+bool CompilerDriver::IsHotClass(const ClassReference& class_ref) const {
+  return hot_classes_.find(class_ref) != hot_classes_.end();
+}
+
+CodeLayoutGroup CompilerDriver::GetCodeLayoutGroup(const MethodReference& method_ref) const {
+  if (!profile_present_) {
+    return kCodeLayoutCold;
+  }
+  const DexFile& dex_file = *method_ref.dex_file;
+  ProfileFile::ProfileData data;
+  if (profile_file_.GetProfileData(&data, dex_file, method_ref.dex_method_index) &&
+      IsHotMethod(data)) {
+    return kCodeLayoutHot;
+  }
+  const DexFile::MethodId& method_id = dex_file.GetMethodId(method_ref.dex_method_index);
+  const char* name = dex_file.GetMethodName(method_id);
+  if (strcmp(name, "<clinit>") == 0 || strcmp(name, "<init>") == 0) {
+    const DexFile::ClassDef* class_def = dex_file.FindClassDef(method_id.class_idx_);
+    if (class_def != nullptr &&
+        IsHotClass(ClassReference(&dex_file, dex_file.GetIndexForClassDef(*class_def)))) {
+      return kCodeLayoutStartup;
+    }
+  }
+  return kCodeLayoutCold;
+}
+
+std::ostream& operator<<(std::ostream& os, const CodeLayoutGroup& rhs) {
+  switch (rhs) {
+    case kCodeLayoutHot:
+      os << "hot";
+      break;
+    case kCodeLayoutStartup:
+      os << "startup";
+      break;
+    case kCodeLayoutCold:
+      os << "cold";
+      break;
+    default:
+      os << "CodeLayoutGroup[" << static_cast<int>(rhs) << "]";
+      break;
+  }
+  return os;
+}
+
+bool CompilerDriver::SkipCompilation(const MethodReference& method_ref) {
   if (!profile_present_) {
     return false;
   }
   // First find the method in the profile file.
   ProfileFile::ProfileData data;
-  if (!profile_file_.GetProfileData(&data, method_name)) {
+  if (!profile_file_.GetProfileData(&data, *method_ref.dex_file, method_ref.dex_method_index)) {
     // Not in profile, no information can be determined.
     if (kIsDebugBuild) {
-      VLOG(compiler) << "not compiling " << method_name << " because it's not in the profile";
+      VLOG(compiler) << "not compiling "
+          << PrettyMethod(method_ref.dex_method_index, *method_ref.dex_file)
+          << " because it's not in the profile";
     }
     return true;
   }
 
   // Methods that comprise top_k_threshold % of the total samples will be compiled.
-  // Compare against the start of the topK percentage bucket just in case the threshold
-  // falls inside a bucket.
-  bool compile = data.GetTopKUsedPercentage() - data.GetUsedPercent()
-                 <= compiler_options_->GetTopKProfileThreshold();
+  bool compile = IsHotMethod(data);
   if (kIsDebugBuild) {
+    std::string method_name = PrettyMethod(method_ref.dex_method_index, *method_ref.dex_file);
     if (compile) {
       LOG(INFO) << "compiling method " << method_name << " because its usage is part of top "
           << data.GetTopKUsedPercentage() << "% with a percent of " << data.GetUsedPercent() << "%"
@@ -38,6 +38,7 @@
 #include "safe_map.h"
 #include "thread_pool.h"
 #include "utils/arena_allocator.h"
+#include "utils/array_ref.h"
 #include "utils/dedupe_set.h"
 
 namespace art {
@@ -47,12 +48,14 @@ class MethodVerifier;
 }  // namespace verifier
 
 class CompiledClass;
+class CompilerDriverTest;
 class CompilerOptions;
 class DexCompilationUnit;
 class DexFileToMethodInlinerMap;
 struct InlineIGetIPutData;
 class OatWriter;
 class ParallelCompilationManager;
+class ReusedOatFile;
 class ScopedObjectAccess;
 template<class T> class Handle;
 class TimingLogger;
@@ -76,18 +79,34 @@ enum DexToDexCompilationLevel {
   kOptimize               // Perform required transformation and peep-hole optimizations.
 };
 
+// Groups in which compiled code is laid out in the oat file, in layout order. Keeping the
+// code that is touched early and often together reduces the number of oat pages faulted in.
+enum CodeLayoutGroup {
+  kCodeLayoutHot,       // Methods within the top K% of the profile.
+  kCodeLayoutStartup,   // Initializers of classes with hot methods, run once when first used.
+  kCodeLayoutCold,      // Everything else, including all methods when there is no profile.
+  kCodeLayoutGroupCount
+};
+std::ostream& operator<<(std::ostream& os, const CodeLayoutGroup& rhs);
+
 // Thread-local storage compiler worker threads
 class CompilerTls {
   public:
-    CompilerTls() : llvm_info_(NULL) {}
+    CompilerTls() : llvm_info_(NULL), arena_pool_(nullptr) {}
     ~CompilerTls() {}
 
     void* GetLLVMInfo() { return llvm_info_; }
 
     void SetLLVMInfo(void* llvm_info) { llvm_info_ = llvm_info; }
 
+    ArenaPool* GetArenaPool() { return arena_pool_; }
+
+    void SetArenaPool(ArenaPool* arena_pool) { arena_pool_ = arena_pool; }
+
   private:
     void* llvm_info_;
+    // Owned by the CompilerDriver.
+    ArenaPool* arena_pool_;
 };
 
 class CompilerDriver {
@@ -115,7 +134,9 @@ class CompilerDriver {
                   TimingLogger* timings)
       LOCKS_EXCLUDED(Locks::mutator_lock_);
 
-  // Compile a single Method.
+  // Compile a single Method. In a started runtime, as used by the JIT, the declaring class is
+  // expected to be resolved, verified and initialized already so pre-compilation and DEX-to-DEX
+  // quickening are skipped.
   void CompileOne(mirror::ArtMethod* method, TimingLogger* timings)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
@@ -147,6 +168,12 @@ class CompilerDriver {
     return profile_present_;
   }
 
+  // Returns the group in which the code of the given method should be laid out.
+  CodeLayoutGroup GetCodeLayoutGroup(const MethodReference& method_ref) const;
+
+  // Does the profile contain hot methods of the class? Only valid after PreCompile().
+  bool IsHotClass(const ClassReference& class_ref) const;
+
   // Are we compiling and creating an image file?
   bool IsImage() const {
     return image_;
@@ -186,6 +213,13 @@ class CompilerDriver {
   CompiledMethod* GetCompiledMethod(MethodReference ref) const
       LOCKS_EXCLUDED(compiled_methods_lock_);
 
+  // Drop a compiled method once its code has been installed elsewhere, e.g. by the JIT.
+  void RemoveCompiledMethod(MethodReference ref) LOCKS_EXCLUDED(compiled_methods_lock_);
+
+  // Free the deduplicated code and tables. Only valid when no compilation is running and no
+  // CompiledMethod is left, e.g. once the JIT copied its only method into the code cache.
+  void ClearDedupeSets();
+
   void AddRequiresConstructorBarrier(Thread* self, const DexFile* dex_file,
                                      uint16_t class_def_index);
   bool RequiresConstructorBarrier(Thread* self, const DexFile* dex_file, uint16_t class_def_index);
@@ -367,9 +401,19 @@ class CompilerDriver {
     support_boot_image_fixup_ = support_boot_image_fixup;
   }
 
-  ArenaPool* GetArenaPool() {
-    return &arena_pool_;
-  }
+  // Takes ownership of the oat file of a previous compilation, whose code is copied for
+  // methods that have not changed instead of compiling them again.
+  void SetReusedOatFile(ReusedOatFile* reused_oat_file);
+
+  // Returns the arena pool of the calling thread. Arenas are recycled across the methods
+  // compiled by that thread without contending with other compiler threads.
+  ArenaPool* GetArenaPool();
+
+  // Releases the free arenas of all compiler threads.
+  void TrimArenaPools();
+
+  // Combined usage of the compiler threads' arena pools.
+  ArenaPoolUsage GetArenaPoolUsage();
 
   bool WriteElf(const std::string& android_root,
                 bool is_host,
@@ -593,11 +637,11 @@ class CompilerDriver {
   void RecordClassStatus(ClassReference ref, mirror::Class::Status status)
       LOCKS_EXCLUDED(compiled_classes_lock_);
 
-  std::vector<uint8_t>* DeduplicateCode(const std::vector<uint8_t>& code);
-  std::vector<uint8_t>* DeduplicateMappingTable(const std::vector<uint8_t>& code);
-  std::vector<uint8_t>* DeduplicateVMapTable(const std::vector<uint8_t>& code);
-  std::vector<uint8_t>* DeduplicateGCMap(const std::vector<uint8_t>& code);
-  std::vector<uint8_t>* DeduplicateCFIInfo(const std::vector<uint8_t>* cfi_info);
+  ArrayRef<const uint8_t> DeduplicateCode(const std::vector<uint8_t>& code);
+  ArrayRef<const uint8_t> DeduplicateMappingTable(const std::vector<uint8_t>& code);
+  ArrayRef<const uint8_t> DeduplicateVMapTable(const std::vector<uint8_t>& code);
+  ArrayRef<const uint8_t> DeduplicateGCMap(const std::vector<uint8_t>& code);
+  ArrayRef<const uint8_t> DeduplicateCFIInfo(const std::vector<uint8_t>* cfi_info);
 
   /*
    * @brief return the pointer to the Call Frame Information.
@@ -611,7 +655,13 @@ class CompilerDriver {
   bool profile_present_;
 
   // Should the compiler run on this method given profile information?
-  bool SkipCompilation(const std::string& method_name);
+  bool SkipCompilation(const MethodReference& method_ref);
+
+  // Is the method part of the top K% of the profile samples?
+  bool IsHotMethod(const ProfileFile::ProfileData& data) const;
+
+  // Collect the classes with at least one hot method into hot_classes_.
+  void FindHotClasses(const std::vector<const DexFile*>& dex_files, TimingLogger* timings);
 
  private:
   // These flags are internal to CompilerDriver for collecting INVOKE resolution statistics.
@@ -674,15 +724,19 @@ class CompilerDriver {
                          ThreadPool* thread_pool, TimingLogger* timings)
       LOCKS_EXCLUDED(Locks::mutator_lock_, compiled_classes_lock_);
 
+  // Resolve, verify and initialize each class of the application dex files in a single parallel
+  // pass shared across all of the dex files.
+  void ResolveVerifyAndInitialize(jobject class_loader,
+                                  const std::vector<const DexFile*>& dex_files,
+                                  ThreadPool* thread_pool, TimingLogger* timings)
+      LOCKS_EXCLUDED(Locks::mutator_lock_, compiled_classes_lock_);
+
   void UpdateImageClasses(TimingLogger* timings) LOCKS_EXCLUDED(Locks::mutator_lock_);
   static void FindClinitImageClassesCallback(mirror::Object* object, void* arg)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
   void Compile(jobject class_loader, const std::vector<const DexFile*>& dex_files,
                ThreadPool* thread_pool, TimingLogger* timings);
-  void CompileDexFile(jobject class_loader, const DexFile& dex_file,
-                      ThreadPool* thread_pool, TimingLogger* timings)
-      LOCKS_EXCLUDED(Locks::mutator_lock_);
   void CompileMethod(const DexFile::CodeItem* code_item, uint32_t access_flags,
                      InvokeType invoke_type, uint16_t class_def_idx, uint32_t method_idx,
                      jobject class_loader, const DexFile& dex_file,
@@ -719,6 +773,10 @@ class CompilerDriver {
   mutable Mutex compiled_methods_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   MethodTable compiled_methods_ GUARDED_BY(compiled_methods_lock_);
 
+  // Classes that have at least one hot method in the profile. Filled in by PreCompile() and
+  // read-only afterwards.
+  std::set<ClassReference> hot_classes_;
+
   const bool image_;
 
   // If image_ is true, specifies the classes that will be included in
@@ -754,8 +812,9 @@ class CompilerDriver {
 
   pthread_key_t tls_key_;
 
-  // Arena pool used by the compiler.
-  ArenaPool arena_pool_;
+  // Arena pools of the compiler threads, see GetArenaPool().
+  Mutex arena_pools_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::vector<ArenaPool*> arena_pools_ GUARDED_BY(arena_pools_lock_);
 
   typedef void (*CompilerEnableAutoElfLoadingFn)(CompilerDriver& driver);
   CompilerEnableAutoElfLoadingFn compiler_enable_auto_elf_loading_;
@@ -766,48 +825,44 @@ class CompilerDriver {
 
   bool support_boot_image_fixup_;
 
+  // Previous compilation whose code is reused, see SetReusedOatFile.
+  std::unique_ptr<ReusedOatFile> reused_oat_file_;
+
   // Call Frame Information, which might be generated to help stack tracebacks.
   std::unique_ptr<std::vector<uint8_t>> cfi_info_;
 
   // DeDuplication data structures, these own the corresponding byte arrays.
   class DedupeHashFunc {
    public:
-    size_t operator()(const std::vector<uint8_t>& array) const {
-      // For small arrays compute a hash using every byte.
-      static const size_t kSmallArrayThreshold = 16;
-      size_t hash = 0x811c9dc5;
-      if (array.size() <= kSmallArrayThreshold) {
-        for (uint8_t b : array) {
-          hash = (hash * 16777619) ^ b;
-        }
-      } else {
-        // For larger arrays use the 2 bytes at 6 bytes (the location of a push registers
-        // instruction field for quick generated code on ARM) and then select a number of other
-        // values at random.
-        static const size_t kRandomHashCount = 16;
-        for (size_t i = 0; i < 2; ++i) {
-          uint8_t b = array[i + 6];
-          hash = (hash * 16777619) ^ b;
-        }
-        for (size_t i = 2; i < kRandomHashCount; ++i) {
-          size_t r = i * 1103515245 + 12345;
-          uint8_t b = array[r % array.size()];
-          hash = (hash * 16777619) ^ b;
-        }
+    size_t operator()(const ArrayRef<const uint8_t>& array) const {
+      // Hash every byte a word at a time. Sampling a few bytes makes code sharing a prologue
+      // and a size collide, which makes every lookup compare whole arrays.
+      const uint8_t* data = array.data();
+      size_t size = array.size();
+      uint32_t hash = 0x811c9dc5 ^ static_cast<uint32_t>(size);
+      size_t i = 0;
+      for (; i + sizeof(uint32_t) <= size; i += sizeof(uint32_t)) {
+        uint32_t word;
+        memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 0x5bd1e995;
+        hash ^= hash >> 15;
       }
-      hash += hash << 13;
-      hash ^= hash >> 7;
-      hash += hash << 3;
-      hash ^= hash >> 17;
-      hash += hash << 5;
+      for (; i < size; ++i) {
+        hash = (hash ^ data[i]) * 16777619;
+      }
+      hash ^= hash >> 13;
+      hash *= 0x5bd1e995;
+      hash ^= hash >> 15;
       return hash;
     }
   };
-  DedupeSet<std::vector<uint8_t>, size_t, DedupeHashFunc, 4> dedupe_code_;
-  DedupeSet<std::vector<uint8_t>, size_t, DedupeHashFunc, 4> dedupe_mapping_table_;
-  DedupeSet<std::vector<uint8_t>, size_t, DedupeHashFunc, 4> dedupe_vmap_table_;
-  DedupeSet<std::vector<uint8_t>, size_t, DedupeHashFunc, 4> dedupe_gc_map_;
-  DedupeSet<std::vector<uint8_t>, size_t, DedupeHashFunc, 4> dedupe_cfi_info_;
+  DedupeSet<uint8_t, DedupeHashFunc> dedupe_code_;
+  DedupeSet<uint8_t, DedupeHashFunc> dedupe_mapping_table_;
+  DedupeSet<uint8_t, DedupeHashFunc> dedupe_vmap_table_;
+  DedupeSet<uint8_t, DedupeHashFunc> dedupe_gc_map_;
+  DedupeSet<uint8_t, DedupeHashFunc> dedupe_cfi_info_;
+
+  friend class CompilerDriverTest;  // For the individual PreCompile() phases.
 
   DISALLOW_COPY_AND_ASSIGN(CompilerDriver);
 };
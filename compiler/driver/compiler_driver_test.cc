@@ -19,6 +19,11 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ScopedLocalRef.h>
 
 #include "class_linker.h"
 #include "common_compiler_test.h"
@@ -32,6 +37,8 @@
 #include "mirror/object-inl.h"
 #include "handle_scope-inl.h"
 #include "scoped_thread_state_change.h"
+#include "thread_pool.h"
+#include "well_known_classes.h"
 
 namespace art {
 
@@ -95,6 +102,64 @@ class CompilerDriverTest : public CommonCompilerTest {
     }
   }
 
+  // Like LoadDex() but puts the dex files of several test jars in one class loader.
+  jobject LoadDexFiles(const std::vector<const char*>& dex_names) {
+    std::vector<const DexFile*> dex_files;
+    for (const char* dex_name : dex_names) {
+      std::vector<const DexFile*> jar_dex_files = OpenTestDexFiles(dex_name);
+      dex_files.insert(dex_files.end(), jar_dex_files.begin(), jar_dex_files.end());
+    }
+    for (const DexFile* dex_file : dex_files) {
+      class_linker_->RegisterDexFile(*dex_file);
+    }
+    ScopedObjectAccessUnchecked soa(Thread::Current());
+    ScopedLocalRef<jobject> class_loader_local(soa.Env(),
+        soa.Env()->AllocObject(WellKnownClasses::dalvik_system_PathClassLoader));
+    jobject class_loader = soa.Env()->NewGlobalRef(class_loader_local.get());
+    soa.Self()->SetClassLoaderOverride(soa.Decode<mirror::ClassLoader*>(class_loader_local.get()));
+    Runtime::Current()->SetCompileTimeClassPath(class_loader, dex_files);
+    return class_loader;
+  }
+
+  // Resolves, verifies and initializes the classes of several dex files in a new class loader,
+  // either with the shared multi-dex work queue or one phase at a time for all dex files, as
+  // for an image. Returns the descriptor and resulting status of each class.
+  std::vector<std::pair<std::string, mirror::Class::Status>> PreCompileMultiDex(bool by_phase)
+      LOCKS_EXCLUDED(Locks::mutator_lock_) {
+    jobject class_loader = LoadDexFiles({"AbstractMethod", "Interfaces", "StaticsFromCode"});
+    std::vector<const DexFile*> dex_files =
+        Runtime::Current()->GetCompileTimeClassPath(class_loader);
+    std::unique_ptr<CompilerDriver> driver(
+        new CompilerDriver(compiler_options_.get(), verification_results_.get(),
+                           method_inliner_map_.get(), Compiler::kQuick,
+                           compiler_driver_->GetInstructionSet(),
+                           compiler_driver_->GetInstructionSetFeatures(),
+                           false, NULL, 4, false, false, timer_.get()));
+    TimingLogger timings("CompilerDriverTest::PreCompileMultiDex", false, false);
+    ThreadPool thread_pool("Compiler driver test thread pool", driver->GetThreadCount() - 1);
+    if (by_phase) {
+      driver->Resolve(class_loader, dex_files, &thread_pool, &timings);
+      driver->Verify(class_loader, dex_files, &thread_pool, &timings);
+      driver->InitializeClasses(class_loader, dex_files, &thread_pool, &timings);
+    } else {
+      driver->ResolveVerifyAndInitialize(class_loader, dex_files, &thread_pool, &timings);
+    }
+
+    std::vector<std::pair<std::string, mirror::Class::Status>> statuses;
+    ScopedObjectAccess soa(Thread::Current());
+    mirror::ClassLoader* loader = soa.Decode<mirror::ClassLoader*>(class_loader);
+    for (const DexFile* dex_file : dex_files) {
+      for (size_t i = 0; i < dex_file->NumClassDefs(); i++) {
+        const char* descriptor = dex_file->GetClassDescriptor(dex_file->GetClassDef(i));
+        mirror::Class* klass = class_linker_->LookupClass(descriptor, loader);
+        statuses.push_back(std::make_pair(
+            std::string(descriptor),
+            (klass != nullptr) ? klass->GetStatus() : mirror::Class::kStatusNotReady));
+      }
+    }
+    return statuses;
+  }
+
   JNIEnv* env_;
   jclass class_;
   jmethodID mid_;
@@ -180,6 +245,19 @@ TEST_F(CompilerDriverTest, AbstractMethodErrorStub) {
   }
 }
 
+TEST_F(CompilerDriverTest, MultiDexPreCompileMatchesPhases) {
+  // Each run gets its own class loader, so the second one starts from unresolved classes too.
+  std::vector<std::pair<std::string, mirror::Class::Status>> multi_dex =
+      PreCompileMultiDex(false);
+  std::vector<std::pair<std::string, mirror::Class::Status>> by_phase = PreCompileMultiDex(true);
+  ASSERT_EQ(by_phase.size(), multi_dex.size());
+  for (size_t i = 0; i != by_phase.size(); ++i) {
+    EXPECT_EQ(by_phase[i].first, multi_dex[i].first);
+    EXPECT_GE(by_phase[i].second, mirror::Class::kStatusResolved) << by_phase[i].first;
+    EXPECT_EQ(by_phase[i].second, multi_dex[i].second) << multi_dex[i].first;
+  }
+}
+
 // TODO: need check-cast test (when stub complete & we can throw/catch
 
 }  // namespace art
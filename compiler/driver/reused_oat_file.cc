@@ -0,0 +1,544 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "reused_oat_file.h"
+
+#include <algorithm>
+
+#include "base/stl_util.h"
+#include "base/stringprintf.h"
+#include "base/timing_logger.h"
+#include "compiled_class.h"
+#include "compiled_method.h"
+#include "dex/verification_results.h"
+#include "dex_instruction-inl.h"
+#include "driver/compiler_driver.h"
+#include "mirror/art_method.h"
+#include "mirror/class.h"
+#include "oat_file-inl.h"
+#include "utils.h"
+#include "vmap_table.h"
+
+namespace art {
+
+// Marker hashes for classes that are not defined in the compiled dex files and for classes
+// whose hash depends on itself through a malformed class hierarchy.
+static constexpr uint64_t kAbsentClassHash = 0u;
+static constexpr uint64_t kCircularClassHash = 1u;
+
+enum ClassHashState {
+  kClassHashNotComputed,
+  kClassHashInProgress,
+  kClassHashComputed,
+};
+
+// 64-bit FNV-1a over the values fed to it.
+class KeyHasher {
+ public:
+  KeyHasher() : hash_(UINT64_C(0xcbf29ce484222325)) {}
+
+  void Update(const void* data, size_t size) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    for (size_t i = 0; i != size; ++i) {
+      hash_ = (hash_ ^ bytes[i]) * UINT64_C(0x100000001b3);
+    }
+  }
+
+  void Update(uint64_t value) {
+    Update(&value, sizeof(value));
+  }
+
+  // Strings include their terminator so that adjacent strings cannot run together.
+  void Update(const char* str) {
+    Update(str, strlen(str) + 1);
+  }
+
+  uint64_t Get() const {
+    return hash_;
+  }
+
+ private:
+  uint64_t hash_;
+};
+
+// Returns the number of bytes of an encoded mapping table, see MappingTable.
+static size_t MappingTableSize(const uint8_t* table) {
+  const uint8_t* ptr = table;
+  uint32_t total_size = DecodeUnsignedLeb128(&ptr);
+  DecodeUnsignedLeb128(&ptr);  // pc to dex size.
+  for (uint32_t i = 0; i != total_size; ++i) {
+    DecodeUnsignedLeb128(&ptr);  // Native pc offset.
+    DecodeSignedLeb128(&ptr);  // Dex pc.
+  }
+  return ptr - table;
+}
+
+// Returns the number of bytes of an encoded vmap table, see VmapTable.
+static size_t VmapTableSize(const uint8_t* table) {
+  const uint8_t* ptr = table;
+  uint32_t size = DecodeUnsignedLeb128(&ptr);
+  for (uint32_t i = 0; i != size; ++i) {
+    DecodeUnsignedLeb128(&ptr);
+  }
+  return ptr - table;
+}
+
+// Returns the number of bytes of a native gc map, see NativePcOffsetToReferenceMap.
+static size_t NativeGcMapSize(const uint8_t* gc_map) {
+  size_t native_offset_width = gc_map[0] & 7;
+  size_t reg_width = (static_cast<size_t>(gc_map[0]) | (static_cast<size_t>(gc_map[1]) << 8)) >> 3;
+  size_t num_entries = gc_map[2] | (gc_map[3] << 8);
+  return 4u + num_entries * (native_offset_width + reg_width);
+}
+
+// dex2oat options that only name the inputs and outputs of a compilation or control its
+// diagnostics. They do not affect the generated code.
+static const char* const kIgnoredDex2OatOptions[] = {
+  "--dex-file=",
+  "--dex-location=",
+  "--zip-fd=",
+  "--zip-location=",
+  "--oat-file=",
+  "--oat-symbols=",
+  "--oat-fd=",
+  "--oat-location=",
+  "--bitcode=",
+  "--reuse-oat=",
+  "--watch-dog",
+  "--no-watch-dog",
+  "--dump-timing",
+  "--dump-passes",
+  "--dump-stats",
+};
+
+// Returns the options of a dex2oat command line that may affect the generated code.
+static std::string GetCodeGenerationOptions(const char* cmdline) {
+  std::vector<std::string> options;
+  Split(cmdline, ' ', options);
+  std::string result;
+  for (const std::string& option : options) {
+    bool ignored = false;
+    for (const char* ignored_option : kIgnoredDex2OatOptions) {
+      if (StartsWith(option, ignored_option)) {
+        ignored = true;
+        break;
+      }
+    }
+    if (!ignored) {
+      result += option;
+      result += ' ';
+    }
+  }
+  return result;
+}
+
+static const char* GetStoreValueByKey(const SafeMap<std::string, std::string>& key_value_store,
+                                      const char* key) {
+  auto it = key_value_store.find(key);
+  return (it != key_value_store.end()) ? it->second.c_str() : nullptr;
+}
+
+template <typename T>
+static std::vector<uint8_t> CopyTable(const uint8_t* table, T size_fn) {
+  if (table == nullptr) {
+    return std::vector<uint8_t>();
+  }
+  return std::vector<uint8_t>(table, table + size_fn(table));
+}
+
+ReusedOatFile* ReusedOatFile::Open(const std::string& filename,
+                                   InstructionSet instruction_set,
+                                   const InstructionSetFeatures& instruction_set_features,
+                                   uint32_t image_file_location_oat_checksum,
+                                   uintptr_t image_file_location_oat_data_begin,
+                                   int32_t image_patch_delta,
+                                   const SafeMap<std::string, std::string>& key_value_store,
+                                   std::string* error_msg) {
+  std::unique_ptr<OatFile> oat_file(OatFile::Open(filename, filename, nullptr, false, error_msg));
+  if (oat_file.get() == nullptr) {
+    return nullptr;
+  }
+  const OatHeader& header = oat_file->GetOatHeader();
+  if (header.GetInstructionSet() != instruction_set ||
+      header.GetInstructionSetFeatures() != instruction_set_features) {
+    *error_msg = StringPrintf("Oat file '%s' was compiled for a different instruction set",
+                              filename.c_str());
+    return nullptr;
+  }
+  // Code compiled against the boot image embeds pointers into it.
+  if (header.GetImageFileLocationOatChecksum() != image_file_location_oat_checksum ||
+      header.GetImageFileLocationOatDataBegin() != image_file_location_oat_data_begin ||
+      header.GetImagePatchDelta() != image_patch_delta) {
+    *error_msg = StringPrintf("Oat file '%s' was compiled against a different boot image",
+                              filename.c_str());
+    return nullptr;
+  }
+  // The instruction set features are compared above, the other compiler options are only
+  // recorded in the key-value store. Refuse files that do not record them.
+  const char* old_filter = header.GetStoreValueByKey(OatHeader::kCompilerFilterKey);
+  const char* filter = GetStoreValueByKey(key_value_store, OatHeader::kCompilerFilterKey);
+  const char* old_cmdline = header.GetStoreValueByKey(OatHeader::kDex2OatCmdLineKey);
+  const char* cmdline = GetStoreValueByKey(key_value_store, OatHeader::kDex2OatCmdLineKey);
+  if (old_filter == nullptr || filter == nullptr || strcmp(old_filter, filter) != 0 ||
+      old_cmdline == nullptr || cmdline == nullptr ||
+      GetCodeGenerationOptions(old_cmdline) != GetCodeGenerationOptions(cmdline)) {
+    *error_msg = StringPrintf("Oat file '%s' was compiled with different compiler options",
+                              filename.c_str());
+    return nullptr;
+  }
+  std::vector<const OatFile::OatDexFile*> oat_dex_files = oat_file->GetOatDexFiles();
+  std::vector<const DexFile*> old_dex_files;
+  for (const OatFile::OatDexFile* oat_dex_file : oat_dex_files) {
+    const DexFile* dex_file = oat_dex_file->OpenDexFile(error_msg);
+    if (dex_file == nullptr) {
+      STLDeleteElements(&old_dex_files);
+      return nullptr;
+    }
+    old_dex_files.push_back(dex_file);
+  }
+  return new ReusedOatFile(oat_file.release(), oat_dex_files, old_dex_files);
+}
+
+ReusedOatFile::ReusedOatFile(const OatFile* oat_file,
+                             const std::vector<const OatFile::OatDexFile*>& oat_dex_files,
+                             const std::vector<const DexFile*>& old_dex_files)
+    : oat_file_(oat_file),
+      oat_dex_files_(oat_dex_files),
+      reused_methods_(0),
+      recompiled_methods_(0) {
+  old_set_.dex_files = old_dex_files;
+}
+
+ReusedOatFile::~ReusedOatFile() {
+  STLDeleteElements(&old_set_.dex_files);
+}
+
+void ReusedOatFile::Setup(const CompilerDriver& driver,
+                          const std::vector<const DexFile*>& dex_files,
+                          TimingLogger* timings) {
+  TimingLogger::ScopedTiming t("Hash Reused Oat Classes", timings);
+  InitDexFileSet(&old_set_);
+  for (size_t i = 0; i != old_set_.dex_files.size(); ++i) {
+    for (size_t j = 0; j != old_set_.dex_files[i]->NumClassDefs(); ++j) {
+      old_set_.class_status[i][j] = oat_dex_files_[i]->GetOatClass(j).GetStatus();
+    }
+  }
+
+  new_set_.dex_files = dex_files;
+  InitDexFileSet(&new_set_);
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    for (size_t j = 0; j != dex_files[i]->NumClassDefs(); ++j) {
+      // Mirror the status OatWriter records for the class.
+      ClassReference ref(dex_files[i], j);
+      CompiledClass* compiled_class = driver.GetCompiledClass(ref);
+      mirror::Class::Status status;
+      if (compiled_class != nullptr) {
+        status = compiled_class->GetStatus();
+      } else if (driver.GetVerificationResults()->IsClassRejected(ref)) {
+        status = mirror::Class::kStatusError;
+      } else {
+        status = mirror::Class::kStatusNotReady;
+      }
+      new_set_.class_status[i][j] = status;
+    }
+  }
+
+  // Hash every class up front: the dex-to-dex compiler rewrites code items in place while
+  // classes are being compiled.
+  for (DexFileSet* set : { &old_set_, &new_set_ }) {
+    for (size_t i = 0; i != set->dex_files.size(); ++i) {
+      for (size_t j = 0; j != set->dex_files[i]->NumClassDefs(); ++j) {
+        GetClassHash(set, i, j);
+      }
+    }
+  }
+}
+
+void ReusedOatFile::InitDexFileSet(DexFileSet* set) {
+  size_t num_dex_files = set->dex_files.size();
+  set->class_status.resize(num_dex_files);
+  set->class_hashes.resize(num_dex_files);
+  set->class_hash_state.resize(num_dex_files);
+  for (size_t i = 0; i != num_dex_files; ++i) {
+    const DexFile* dex_file = set->dex_files[i];
+    size_t num_class_defs = dex_file->NumClassDefs();
+    set->class_status[i].resize(num_class_defs, mirror::Class::kStatusNotReady);
+    set->class_hashes[i].resize(num_class_defs, kAbsentClassHash);
+    set->class_hash_state[i].resize(num_class_defs, kClassHashNotComputed);
+    for (size_t j = 0; j != num_class_defs; ++j) {
+      StringPiece descriptor(dex_file->GetClassDescriptor(dex_file->GetClassDef(j)));
+      if (set->classes.find(descriptor) == set->classes.end()) {
+        set->classes.Put(descriptor, std::make_pair(i, static_cast<uint16_t>(j)));
+      }
+    }
+  }
+}
+
+static void HashCodeItem(KeyHasher* hasher, const DexFile::CodeItem* code_item) {
+  if (code_item == nullptr) {
+    hasher->Update(UINT64_C(0));
+    return;
+  }
+  hasher->Update(code_item->registers_size_);
+  hasher->Update(code_item->ins_size_);
+  hasher->Update(code_item->outs_size_);
+  hasher->Update(code_item->tries_size_);
+  hasher->Update(code_item->insns_size_in_code_units_);
+  hasher->Update(code_item->insns_, code_item->insns_size_in_code_units_ * sizeof(uint16_t));
+  for (uint32_t i = 0; i != code_item->tries_size_; ++i) {
+    const DexFile::TryItem* try_item = DexFile::GetTryItems(*code_item, i);
+    hasher->Update(try_item->start_addr_);
+    hasher->Update(try_item->insn_count_);
+    for (CatchHandlerIterator it(*code_item, *try_item); it.HasNext(); it.Next()) {
+      hasher->Update(it.GetHandlerTypeIndex());
+      hasher->Update(it.GetHandlerAddress());
+    }
+  }
+}
+
+uint64_t ReusedOatFile::GetClassHash(DexFileSet* set, size_t dex_index, uint16_t class_def_idx) {
+  uint8_t& state = set->class_hash_state[dex_index][class_def_idx];
+  if (state == kClassHashComputed) {
+    return set->class_hashes[dex_index][class_def_idx];
+  } else if (state == kClassHashInProgress) {
+    return kCircularClassHash;
+  }
+  state = kClassHashInProgress;
+
+  const DexFile& dex_file = *set->dex_files[dex_index];
+  const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_idx);
+  KeyHasher hasher;
+  hasher.Update(dex_file.GetClassDescriptor(class_def));
+  hasher.Update(class_def.access_flags_);
+  hasher.Update(static_cast<uint64_t>(set->class_status[dex_index][class_def_idx]));
+  // The superclass and interfaces determine field offsets, vtable and interface method indices.
+  std::vector<const char*> supertypes;
+  if (class_def.superclass_idx_ != DexFile::kDexNoIndex16) {
+    supertypes.push_back(dex_file.StringByTypeIdx(class_def.superclass_idx_));
+  }
+  const DexFile::TypeList* interfaces = dex_file.GetInterfacesList(class_def);
+  if (interfaces != nullptr) {
+    for (size_t i = 0; i != interfaces->Size(); ++i) {
+      supertypes.push_back(dex_file.StringByTypeIdx(interfaces->GetTypeItem(i).type_idx_));
+    }
+  }
+  for (const char* supertype : supertypes) {
+    hasher.Update(supertype);
+    auto it = set->classes.find(StringPiece(supertype));
+    hasher.Update(it == set->classes.end()
+                  ? kAbsentClassHash
+                  : GetClassHash(set, it->second.first, it->second.second));
+  }
+  // Fields and methods, including code so that callers inlining a method see its changes.
+  const byte* class_data = dex_file.GetClassData(class_def);
+  if (class_data != nullptr) {
+    ClassDataItemIterator it(dex_file, class_data);
+    for (; it.HasNextStaticField() || it.HasNextInstanceField(); it.Next()) {
+      const DexFile::FieldId& field_id = dex_file.GetFieldId(it.GetMemberIndex());
+      hasher.Update(it.GetMemberAccessFlags());
+      hasher.Update(dex_file.GetFieldName(field_id));
+      hasher.Update(dex_file.GetFieldTypeDescriptor(field_id));
+    }
+    for (; it.HasNext(); it.Next()) {
+      const DexFile::MethodId& method_id = dex_file.GetMethodId(it.GetMemberIndex());
+      hasher.Update(it.GetMemberAccessFlags());
+      hasher.Update(dex_file.GetMethodName(method_id));
+      hasher.Update(dex_file.GetMethodSignature(method_id).ToString().c_str());
+      HashCodeItem(&hasher, it.GetMethodCodeItem());
+    }
+  }
+
+  uint64_t hash = hasher.Get();
+  // Keep clear of the marker values.
+  if (hash == kAbsentClassHash || hash == kCircularClassHash) {
+    hash += 2u;
+  }
+  set->class_hashes[dex_index][class_def_idx] = hash;
+  state = kClassHashComputed;
+  return hash;
+}
+
+uint64_t ReusedOatFile::GetClassHashByDescriptor(const DexFileSet& set, const char* descriptor) {
+  while (*descriptor == '[') {
+    ++descriptor;
+  }
+  auto it = set.classes.find(StringPiece(descriptor));
+  if (it == set.classes.end()) {
+    return kAbsentClassHash;
+  }
+  DCHECK_EQ(set.class_hash_state[it->second.first][it->second.second], kClassHashComputed);
+  return set.class_hashes[it->second.first][it->second.second];
+}
+
+uint64_t ReusedOatFile::ComputeMethodKey(const DexFileSet& set, size_t dex_index,
+                                         uint16_t class_def_idx, uint32_t method_idx,
+                                         const DexFile::CodeItem* code_item) {
+  const DexFile& dex_file = *set.dex_files[dex_index];
+  const DexFile::MethodId& method_id = dex_file.GetMethodId(method_idx);
+  KeyHasher hasher;
+  // The class hash covers the code item itself.
+  hasher.Update(set.class_hashes[dex_index][class_def_idx]);
+  hasher.Update(dex_file.GetMethodName(method_id));
+  hasher.Update(dex_file.GetMethodSignature(method_id).ToString().c_str());
+
+  // Resolve every index used by the code to the entity it names.
+  auto hash_type = [&](uint32_t type_idx) {
+    const char* descriptor = dex_file.StringByTypeIdx(type_idx);
+    hasher.Update(descriptor);
+    hasher.Update(GetClassHashByDescriptor(set, descriptor));
+  };
+  auto hash_field = [&](uint32_t field_idx) {
+    const DexFile::FieldId& field_id = dex_file.GetFieldId(field_idx);
+    hash_type(field_id.class_idx_);
+    hasher.Update(dex_file.GetFieldName(field_id));
+    hasher.Update(dex_file.GetFieldTypeDescriptor(field_id));
+  };
+  auto hash_method = [&](uint32_t callee_idx) {
+    const DexFile::MethodId& callee_id = dex_file.GetMethodId(callee_idx);
+    hash_type(callee_id.class_idx_);
+    hasher.Update(dex_file.GetMethodName(callee_id));
+    hasher.Update(dex_file.GetMethodSignature(callee_id).ToString().c_str());
+  };
+  const uint16_t* insns = code_item->insns_;
+  size_t dex_pc = 0;
+  while (dex_pc < code_item->insns_size_in_code_units_) {
+    const Instruction* inst = Instruction::At(insns + dex_pc);
+    switch (inst->GetVerifyTypeArgumentB()) {
+      case Instruction::kVerifyRegBField:
+        hash_field(inst->VRegB());
+        break;
+      case Instruction::kVerifyRegBMethod:
+        hash_method(inst->VRegB());
+        break;
+      case Instruction::kVerifyRegBNewInstance:
+      case Instruction::kVerifyRegBType:
+        hash_type(inst->VRegB());
+        break;
+      case Instruction::kVerifyRegBString:
+        hasher.Update(dex_file.StringDataByIdx(inst->VRegB()));
+        break;
+      default:
+        break;
+    }
+    switch (inst->GetVerifyTypeArgumentC()) {
+      case Instruction::kVerifyRegCField:
+        hash_field(inst->VRegC());
+        break;
+      case Instruction::kVerifyRegCNewArray:
+      case Instruction::kVerifyRegCType:
+        hash_type(inst->VRegC());
+        break;
+      default:
+        break;
+    }
+    dex_pc += inst->SizeInCodeUnits();
+  }
+  for (uint32_t i = 0; i != code_item->tries_size_; ++i) {
+    const DexFile::TryItem* try_item = DexFile::GetTryItems(*code_item, i);
+    for (CatchHandlerIterator it(*code_item, *try_item); it.HasNext(); it.Next()) {
+      if (it.GetHandlerTypeIndex() != DexFile::kDexNoIndex16) {
+        hash_type(it.GetHandlerTypeIndex());
+      }
+    }
+  }
+  return hasher.Get();
+}
+
+int32_t ReusedOatFile::FindOldMethod(const DexFile& old_dex_file,
+                                     const DexFile::ClassDef& old_class_def,
+                                     const DexFile& dex_file, uint32_t method_idx,
+                                     uint32_t* old_method_idx,
+                                     const DexFile::CodeItem** old_code_item) {
+  const byte* class_data = old_dex_file.GetClassData(old_class_def);
+  if (class_data == nullptr) {
+    return -1;
+  }
+  const DexFile::MethodId& method_id = dex_file.GetMethodId(method_idx);
+  const char* name = dex_file.GetMethodName(method_id);
+  const Signature signature = dex_file.GetMethodSignature(method_id);
+  ClassDataItemIterator it(old_dex_file, class_data);
+  while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+    it.Next();
+  }
+  // Methods are numbered in class data order, as in OatWriter.
+  for (int32_t class_def_method_index = 0; it.HasNext(); ++class_def_method_index, it.Next()) {
+    const DexFile::MethodId& old_method_id = old_dex_file.GetMethodId(it.GetMemberIndex());
+    if (strcmp(name, old_dex_file.GetMethodName(old_method_id)) == 0 &&
+        signature == old_dex_file.GetMethodSignature(old_method_id)) {
+      *old_method_idx = it.GetMemberIndex();
+      *old_code_item = it.GetMethodCodeItem();
+      return class_def_method_index;
+    }
+  }
+  return -1;
+}
+
+CompiledMethod* ReusedOatFile::CopyCompiledMethod(CompilerDriver* driver,
+                                                  const DexFile& dex_file,
+                                                  uint16_t class_def_idx, uint32_t method_idx,
+                                                  const DexFile::CodeItem* code_item) {
+  DCHECK(code_item != nullptr);
+  auto dex_it = std::find(new_set_.dex_files.begin(), new_set_.dex_files.end(), &dex_file);
+  CHECK(dex_it != new_set_.dex_files.end()) << dex_file.GetLocation();
+  size_t dex_index = dex_it - new_set_.dex_files.begin();
+
+  // The class may have moved between dex files, so look it up by descriptor.
+  const char* descriptor = dex_file.GetClassDescriptor(dex_file.GetClassDef(class_def_idx));
+  auto class_it = old_set_.classes.find(StringPiece(descriptor));
+  if (class_it == old_set_.classes.end()) {
+    recompiled_methods_.FetchAndAddSequentiallyConsistent(1);
+    return nullptr;
+  }
+  size_t old_dex_index = class_it->second.first;
+  uint16_t old_class_def_idx = class_it->second.second;
+  const DexFile& old_dex_file = *old_set_.dex_files[old_dex_index];
+  uint32_t old_method_idx;
+  const DexFile::CodeItem* old_code_item;
+  int32_t class_def_method_index =
+      FindOldMethod(old_dex_file, old_dex_file.GetClassDef(old_class_def_idx), dex_file,
+                    method_idx, &old_method_idx, &old_code_item);
+  if (class_def_method_index < 0 || old_code_item == nullptr ||
+      ComputeMethodKey(old_set_, old_dex_index, old_class_def_idx, old_method_idx,
+                       old_code_item) !=
+      ComputeMethodKey(new_set_, dex_index, class_def_idx, method_idx, code_item)) {
+    recompiled_methods_.FetchAndAddSequentiallyConsistent(1);
+    return nullptr;
+  }
+
+  const OatFile::OatMethod oat_method =
+      oat_dex_files_[old_dex_index]->GetOatClass(old_class_def_idx)
+          .GetOatMethod(class_def_method_index);
+  const uint8_t* code =
+      reinterpret_cast<const uint8_t*>(
+          mirror::ArtMethod::EntryPointToCodePointer(oat_method.GetQuickCode()));
+  if (code == nullptr) {
+    // Not compiled previously, for example because of the compiler filter.
+    recompiled_methods_.FetchAndAddSequentiallyConsistent(1);
+    return nullptr;
+  }
+  std::vector<uint8_t> quick_code(code, code + oat_method.GetQuickCodeSize());
+  std::vector<uint8_t> mapping_table = CopyTable(oat_method.GetMappingTable(), MappingTableSize);
+  std::vector<uint8_t> vmap_table = CopyTable(oat_method.GetVmapTable(), VmapTableSize);
+  std::vector<uint8_t> native_gc_map = CopyTable(oat_method.GetNativeGcMap(), NativeGcMapSize);
+  reused_methods_.FetchAndAddSequentiallyConsistent(1);
+  return new CompiledMethod(driver, driver->GetInstructionSet(), quick_code,
+                            oat_method.GetFrameSizeInBytes(), oat_method.GetCoreSpillMask(),
+                            oat_method.GetFpSpillMask(), mapping_table, vmap_table,
+                            native_gc_map, nullptr);
+}
+
+}  // namespace art
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ART_COMPILER_DRIVER_REUSED_OAT_FILE_H_
+#define ART_COMPILER_DRIVER_REUSED_OAT_FILE_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "atomic.h"
+#include "base/macros.h"
+#include "base/stringpiece.h"
+#include "dex_file.h"
+#include "instruction_set.h"
+#include "oat_file.h"
+#include "safe_map.h"
+
+namespace art {
+
+class CompiledMethod;
+class CompilerDriver;
+class TimingLogger;
+
+// An oat file from a previous dex2oat run whose compiled code is copied into the current
+// compilation for methods that did not change, so that only changed methods are recompiled.
+//
+// Quick code embeds raw dex indices, field offsets, vtable indices and inlined callees, so a
+// method is only reused when, in both the old and the new dex files:
+//   - its own class is identical and has the same compile time status,
+//   - every string, type, field and method index used by its code names the same entity,
+//   - every class defined in the compiled dex files that its code references is identical,
+//     including superclasses and interfaces, and has the same compile time status.
+// Classes from the boot class path are covered by checking the boot image oat checksum. The
+// compiler options are compared through the oat header key-value store, the compiler itself only
+// through the oat version.
+class ReusedOatFile {
+ public:
+  // Opens the oat file at `filename` and checks that it targets the same instruction set and
+  // boot image as the current compilation, and that its key-value store records the same
+  // compiler filter and code generation options as `key_value_store`, the store of the oat file
+  // being written. Returns nullptr and sets `error_msg` otherwise.
+  static ReusedOatFile* Open(const std::string& filename,
+                             InstructionSet instruction_set,
+                             const InstructionSetFeatures& instruction_set_features,
+                             uint32_t image_file_location_oat_checksum,
+                             uintptr_t image_file_location_oat_data_begin,
+                             int32_t image_patch_delta,
+                             const SafeMap<std::string, std::string>& key_value_store,
+                             std::string* error_msg);
+
+  ~ReusedOatFile();
+
+  // Computes the class hashes of the previous and the new dex files. Must be called after the
+  // class status of the new dex files is final and before any of them is quickened.
+  void Setup(const CompilerDriver& driver, const std::vector<const DexFile*>& dex_files,
+             TimingLogger* timings);
+
+  // Returns a copy of the previously compiled code for the given method, or nullptr if the
+  // method may have changed or was not compiled in the previous oat file.
+  CompiledMethod* CopyCompiledMethod(CompilerDriver* driver, const DexFile& dex_file,
+                                     uint16_t class_def_idx, uint32_t method_idx,
+                                     const DexFile::CodeItem* code_item);
+
+  size_t GetReusedMethodCount() const {
+    return reused_methods_.LoadRelaxed();
+  }
+
+  size_t GetRecompiledMethodCount() const {
+    return recompiled_methods_.LoadRelaxed();
+  }
+
+ private:
+  // The classes of one generation of dex files, looked up by descriptor with the first
+  // definition winning as with the PathClassLoader.
+  struct DexFileSet {
+    std::vector<const DexFile*> dex_files;
+    // Compile time status of each class def, indexed like `dex_files`.
+    std::vector<std::vector<int32_t>> class_status;
+    std::vector<std::vector<uint64_t>> class_hashes;
+    std::vector<std::vector<uint8_t>> class_hash_state;
+    SafeMap<StringPiece, std::pair<size_t, uint16_t>> classes;
+  };
+
+  ReusedOatFile(const OatFile* oat_file,
+                const std::vector<const OatFile::OatDexFile*>& oat_dex_files,
+                const std::vector<const DexFile*>& old_dex_files);
+
+  static void InitDexFileSet(DexFileSet* set);
+  static uint64_t GetClassHash(DexFileSet* set, size_t dex_index, uint16_t class_def_idx);
+  static uint64_t GetClassHashByDescriptor(const DexFileSet& set, const char* descriptor);
+  static uint64_t ComputeMethodKey(const DexFileSet& set, size_t dex_index,
+                                   uint16_t class_def_idx, uint32_t method_idx,
+                                   const DexFile::CodeItem* code_item);
+
+  // Finds the method of the previous dex file matching `method_idx` of `dex_file`. Returns the
+  // index of the method within its class def, as used by OatClass, or -1 if there is none.
+  static int32_t FindOldMethod(const DexFile& old_dex_file, const DexFile::ClassDef& old_class_def,
+                               const DexFile& dex_file, uint32_t method_idx,
+                               uint32_t* old_method_idx, const DexFile::CodeItem** old_code_item);
+
+  std::unique_ptr<const OatFile> oat_file_;
+  std::vector<const OatFile::OatDexFile*> oat_dex_files_;
+  DexFileSet old_set_;
+  DexFileSet new_set_;
+
+  AtomicInteger reused_methods_;
+  AtomicInteger recompiled_methods_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReusedOatFile);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_DRIVER_REUSED_OAT_FILE_H_
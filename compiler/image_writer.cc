@@ -260,6 +260,14 @@ bool ImageWriter::ComputeLazyFieldsForClassesVisitor(Class* c, void* /*arg*/) {
   return true;
 }
 
+void ImageWriter::InternStringsCallback(Object* obj, void* /*arg*/) {
+  if (obj->GetClass()->IsStringClass()) {
+    // The image intern table is built from the strong interns, weakly interned strings are
+    // promoted here.
+    Runtime::Current()->GetInternTable()->InternStrong(obj->AsString());
+  }
+}
+
 void ImageWriter::ComputeEagerResolvedStringsCallback(Object* obj, void* arg) {
   if (!obj->GetClass()->IsStringClass()) {
     return;
@@ -414,7 +422,7 @@ ObjectArray<Object>* ImageWriter::CreateImageRoots() const {
   Runtime* runtime = Runtime::Current();
   ClassLinker* class_linker = runtime->GetClassLinker();
   Thread* self = Thread::Current();
-  StackHandleScope<3> hs(self);
+  StackHandleScope<4> hs(self);
   Handle<Class> object_array_class(hs.NewHandle(
       class_linker->FindSystemClass(self, "[Ljava/lang/Object;")));
 
@@ -441,6 +449,22 @@ ObjectArray<Object>* ImageWriter::CreateImageRoots() const {
     }
   }
 
+  // build the read only table of the interned strings, all of the strings in the heap have been
+  // interned by now so this does not change while we lay out the objects.
+  InternTable* intern_table = runtime->GetInternTable();
+  std::vector<mirror::String*> strings;
+  intern_table->GetStrongInterns(&strings);
+  const size_t num_strings = strings.size();
+  Handle<ObjectArray<Object>> image_strings(hs.NewHandle(
+      ObjectArray<Object>::Alloc(self, object_array_class.Get(),
+                                 InternTable::ImageTableCapacity(num_strings))));
+  CHECK(image_strings.Get() != nullptr) << "Failed to allocate the image intern table.";
+  // Read the strings again since the allocation may have caused a GC.
+  strings.clear();
+  intern_table->GetStrongInterns(&strings);
+  CHECK_EQ(num_strings, strings.size()) << "The number of interned strings changed.";
+  InternTable::BuildImageTable(strings, image_strings->AsObjectArray<mirror::String>());
+
   // build an Object[] of the roots needed to restore the runtime
   Handle<ObjectArray<Object>> image_roots(hs.NewHandle(
       ObjectArray<Object>::Alloc(self, object_array_class.Get(), ImageHeader::kImageRootsMax)));
@@ -455,6 +479,7 @@ ObjectArray<Object>* ImageWriter::CreateImageRoots() const {
                           runtime->GetCalleeSaveMethod(Runtime::kRefsAndArgs));
   image_roots->Set<false>(ImageHeader::kDexCaches, dex_caches.Get());
   image_roots->Set<false>(ImageHeader::kClassRoots, class_linker->GetClassRoots());
+  image_roots->Set<false>(ImageHeader::kInternTable, image_strings.Get());
   for (int i = 0; i < ImageHeader::kImageRootsMax; i++) {
     CHECK(image_roots->Get(i) != NULL);
   }
@@ -527,10 +552,16 @@ void ImageWriter::WalkFieldsCallback(mirror::Object* obj, void* arg) {
 void ImageWriter::CalculateNewObjectOffsets(size_t oat_loaded_size, size_t oat_data_offset) {
   CHECK_NE(0U, oat_loaded_size);
   Thread* self = Thread::Current();
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  {
+    // Strongly intern all of the strings up front so that the image intern table contains every
+    // string CalculateObjectOffsets will map to its interned copy.
+    ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
+    heap->VisitObjects(InternStringsCallback, this);
+  }
   StackHandleScope<1> hs(self);
   Handle<ObjectArray<Object>> image_roots(hs.NewHandle(CreateImageRoots()));
 
-  gc::Heap* heap = Runtime::Current()->GetHeap();
   DCHECK_EQ(0U, image_end_);
 
   // Leave space for the header, but do not write it yet, we need to
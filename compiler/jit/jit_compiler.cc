@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jit_compiler.h"
+
+#include "base/timing_logger.h"
+#include "compiler_callbacks.h"
+#include "entrypoints/entrypoint_utils.h"
+#include "handle_scope-inl.h"
+#include "instrumentation.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "method_reference.h"
+#include "mirror/art_method-inl.h"
+#include "runtime.h"
+#include "scoped_thread_state_change.h"
+#include "thread.h"
+#include "verifier/method_verifier-inl.h"
+
+namespace art {
+namespace jit {
+
+JitCompiler* JitCompiler::Create() {
+  return new JitCompiler();
+}
+
+extern "C" void* jit_load() {
+  VLOG(compiler) << "loading jit compiler";
+  JitCompiler* const jit_compiler = JitCompiler::Create();
+  CHECK(jit_compiler != nullptr);
+  VLOG(compiler) << "Done loading jit compiler";
+  return jit_compiler;
+}
+
+extern "C" void jit_unload(void* handle) {
+  DCHECK(handle != nullptr);
+  delete reinterpret_cast<JitCompiler*>(handle);
+}
+
+extern "C" bool jit_compile_method(void* handle, mirror::ArtMethod* method, Thread* self)
+    SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+  JitCompiler* jit_compiler = reinterpret_cast<JitCompiler*>(handle);
+  DCHECK(jit_compiler != nullptr);
+  return jit_compiler->CompileMethod(self, method);
+}
+
+JitCompiler::JitCompiler() : total_time_(0) {
+  compiler_options_.reset(new CompilerOptions);
+  verification_results_.reset(new VerificationResults(compiler_options_.get()));
+  method_inliner_map_.reset(new DexFileToMethodInlinerMap);
+  callbacks_.reset(new QuickCompilerCallbacks(verification_results_.get(),
+                                              method_inliner_map_.get()));
+  cumulative_logger_.reset(new CumulativeLogger("jit times"));
+  // Quick emits Thumb2 code for ARM, as dex2oat does.
+  InstructionSet instruction_set = (kRuntimeISA == kArm) ? kThumb2 : kRuntimeISA;
+  compiler_driver_.reset(new CompilerDriver(compiler_options_.get(),
+                                            verification_results_.get(),
+                                            method_inliner_map_.get(),
+                                            Compiler::kQuick, instruction_set,
+                                            InstructionSetFeatures::GuessInstructionSetFeatures(),
+                                            false, nullptr, 1, false, false,
+                                            cumulative_logger_.get()));
+  // The code is used in place, there is no oat writer to apply boot image patches.
+  compiler_driver_->SetSupportBootImageFixup(false);
+}
+
+JitCompiler::~JitCompiler() {
+}
+
+bool JitCompiler::CompileMethod(Thread* self, mirror::ArtMethod* method) {
+  const uint64_t start_time = NanoTime();
+  StackHandleScope<1> hs(self);
+  self->AssertNoPendingException();
+  Runtime* runtime = Runtime::Current();
+  Handle<mirror::ArtMethod> h_method(hs.NewHandle(method));
+  if (runtime->GetJit()->GetCodeCache()->ContainsMethod(method)) {
+    VLOG(compiler) << "Already compiled " << PrettyMethod(method);
+    return true;  // Already compiled
+  }
+  if (!VerifyMethod(self, h_method)) {
+    VLOG(compiler) << "Not compiling " << PrettyMethod(method) << " which failed to verify";
+    return false;
+  }
+  TimingLogger logger("JIT compiler timing logger", true, VLOG_IS_ON(compiler));
+  compiler_driver_->CompileOne(h_method.Get(), &logger);
+  MethodReference method_ref(h_method->GetDexFile(), h_method->GetDexMethodIndex());
+  const CompiledMethod* compiled_method = compiler_driver_->GetCompiledMethod(method_ref);
+  bool result = false;
+  if (compiled_method != nullptr && !compiled_method->GetQuickCode().empty()) {
+    result = AddToCodeCache(self, h_method.Get(), compiled_method);
+  }
+  // The code cache now owns a copy of the code and tables. The driver lives as long as the JIT,
+  // so drop its deduplicated copies rather than keep every method ever compiled.
+  compiler_driver_->RemoveCompiledMethod(method_ref);
+  compiler_driver_->ClearDedupeSets();
+  total_time_ += NanoTime() - start_time;
+  return result;
+}
+
+bool JitCompiler::VerifyMethod(Thread* self, Handle<mirror::ArtMethod> method) {
+  StackHandleScope<2> hs(self);
+  Handle<mirror::DexCache> dex_cache(hs.NewHandle(method->GetDexCache()));
+  Handle<mirror::ClassLoader> class_loader(hs.NewHandle(method->GetClassLoader()));
+  // Don't load classes on the compiler thread, unresolved types only make the code slower.
+  verifier::MethodVerifier verifier(method->GetDexFile(), &dex_cache, &class_loader,
+                                    &method->GetClassDef(), method->GetCodeItem(),
+                                    method->GetDexMethodIndex(), method.Get(),
+                                    method->GetAccessFlags(), false, true, false);
+  if (!verifier.Verify() || verifier.HasFailures()) {
+    self->ClearException();
+    return false;
+  }
+  return callbacks_->MethodVerified(&verifier);
+}
+
+bool JitCompiler::AddToCodeCache(Thread* self, mirror::ArtMethod* method,
+                                 const CompiledMethod* compiled_method) {
+  JitCodeCache* const code_cache = Runtime::Current()->GetJit()->GetCodeCache();
+  ArrayRef<const uint8_t> mapping_table = compiled_method->GetMappingTable();
+  ArrayRef<const uint8_t> vmap_table = compiled_method->GetVmapTable();
+  ArrayRef<const uint8_t> gc_map = compiled_method->GetGcMap();
+  uint8_t* mapping_table_ptr = nullptr;
+  uint8_t* vmap_table_ptr = nullptr;
+  uint8_t* gc_map_ptr = nullptr;
+  if (!mapping_table.empty()) {
+    mapping_table_ptr = code_cache->AddDataArray(self, mapping_table.data(),
+                                                 mapping_table.data() + mapping_table.size());
+    if (mapping_table_ptr == nullptr) {
+      return false;
+    }
+  }
+  if (!vmap_table.empty()) {
+    vmap_table_ptr = code_cache->AddDataArray(self, vmap_table.data(),
+                                              vmap_table.data() + vmap_table.size());
+    if (vmap_table_ptr == nullptr) {
+      return false;
+    }
+  }
+  if (!gc_map.empty()) {
+    gc_map_ptr = code_cache->AddDataArray(self, gc_map.data(), gc_map.data() + gc_map.size());
+    if (gc_map_ptr == nullptr) {
+      return false;
+    }
+  }
+  ArrayRef<const uint8_t> code = compiled_method->GetQuickCode();
+  const InstructionSet instruction_set = compiled_method->GetInstructionSet();
+  uint8_t* code_ptr = code_cache->CommitCode(self, mapping_table_ptr, vmap_table_ptr,
+                                             compiled_method->GetFrameSizeInBytes(),
+                                             compiled_method->GetCoreSpillMask(),
+                                             compiled_method->GetFpSpillMask(),
+                                             code.data(), code.size(),
+                                             GetInstructionSetAlignment(instruction_set));
+  if (code_ptr == nullptr) {
+    VLOG(compiler) << "JIT code cache full, not installing " << PrettyMethod(method);
+    return false;
+  }
+  const void* entry_point = CompiledMethod::CodePointer(code_ptr, instruction_set);
+  // The GC map must be in place before any frame of the new code can be walked.
+  method->SetNativeGcMap(gc_map_ptr);
+  code_cache->SaveCompiledCode(method, entry_point);
+  Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(method, entry_point,
+                                                              GetPortableToQuickBridge(), false);
+  return true;
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ART_COMPILER_JIT_JIT_COMPILER_H_
+#define ART_COMPILER_JIT_JIT_COMPILER_H_
+
+#include <memory>
+
+#include "base/mutex.h"
+#include "compiled_method.h"
+#include "dex/verification_results.h"
+#include "dex/quick/dex_file_to_method_inliner_map.h"
+#include "dex/quick_compiler_callbacks.h"
+#include "driver/compiler_driver.h"
+#include "driver/compiler_options.h"
+#include "handle.h"
+
+namespace art {
+
+class CumulativeLogger;
+
+namespace mirror {
+  class ArtMethod;
+}  // namespace mirror
+
+namespace jit {
+
+// Compiler half of the JIT, loaded into the runtime through the jit_load/jit_unload/
+// jit_compile_method entrypoints. Compiles single methods of a started runtime with the Quick
+// backend and installs the code into the runtime's JitCodeCache.
+class JitCompiler {
+ public:
+  static JitCompiler* Create();
+  virtual ~JitCompiler();
+
+  bool CompileMethod(Thread* self, mirror::ArtMethod* method)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  uint64_t GetTotalCompileTime() const {
+    return total_time_;
+  }
+
+ private:
+  JitCompiler();
+
+  // Verify the method again to record the VerifiedMethod (GC map, devirtualization and safe cast
+  // information) the Quick backend needs. The runtime does not keep it after class verification.
+  bool VerifyMethod(Thread* self, Handle<mirror::ArtMethod> method)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Copy the tables and code of a compiled method into the code cache and update the method's
+  // entrypoints.
+  bool AddToCodeCache(Thread* self, mirror::ArtMethod* method,
+                      const CompiledMethod* compiled_method)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  uint64_t total_time_;
+  std::unique_ptr<CompilerOptions> compiler_options_;
+  std::unique_ptr<VerificationResults> verification_results_;
+  std::unique_ptr<DexFileToMethodInlinerMap> method_inliner_map_;
+  std::unique_ptr<QuickCompilerCallbacks> callbacks_;
+  std::unique_ptr<CumulativeLogger> cumulative_logger_;
+  std::unique_ptr<CompilerDriver> compiler_driver_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitCompiler);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_COMPILER_JIT_JIT_COMPILER_H_
@@ -432,6 +432,71 @@ TEST_F(JniCompilerTest, CompileAndRunStaticDoubleDoubleMethod) {
   EXPECT_EQ(2, gJava_MyClassNatives_fooSDD_calls);
 }
 
+int gJava_MyClassNatives_criticalSII_calls = 0;
+jint Java_MyClassNatives_criticalSII(jint x, jint y) {
+  // Critical natives are called without a JNIEnv*, a jclass or a transition out of Runnable.
+  EXPECT_EQ(kRunnable, Thread::Current()->GetState());
+  EXPECT_EQ(0U, Thread::Current()->NumStackReferences());
+  gJava_MyClassNatives_criticalSII_calls++;
+  return x - y;  // non-commutative operator
+}
+
+TEST_F(JniCompilerTest, CompileAndRunCriticalIntIntMethod) {
+  TEST_DISABLED_FOR_PORTABLE();
+  SetUpForTest(true, "criticalSII", "(II)I", nullptr);
+  JNINativeMethod methods[] = {
+      { "criticalSII", "#(II)I", reinterpret_cast<void*>(&Java_MyClassNatives_criticalSII) } };
+  ASSERT_EQ(JNI_OK, env_->RegisterNatives(jklass_, methods, 1));
+
+  EXPECT_EQ(0, gJava_MyClassNatives_criticalSII_calls);
+  jint result = env_->CallStaticIntMethod(jklass_, jmethod_, 50, 20);
+  EXPECT_EQ(30, result);
+  EXPECT_EQ(1, gJava_MyClassNatives_criticalSII_calls);
+  result = env_->CallStaticIntMethod(jklass_, jmethod_, -1, 0x7fffffff);
+  EXPECT_EQ(static_cast<jint>(0x80000000), result);
+  EXPECT_EQ(2, gJava_MyClassNatives_criticalSII_calls);
+}
+
+int gJava_MyClassNatives_criticalSJJ_calls = 0;
+jlong Java_MyClassNatives_criticalSJJ(jlong x, jlong y) {
+  EXPECT_EQ(kRunnable, Thread::Current()->GetState());
+  gJava_MyClassNatives_criticalSJJ_calls++;
+  return x - y;  // non-commutative operator
+}
+
+TEST_F(JniCompilerTest, CompileAndRunCriticalLongLongMethod) {
+  TEST_DISABLED_FOR_PORTABLE();
+  SetUpForTest(true, "criticalSJJ", "(JJ)J", nullptr);
+  JNINativeMethod methods[] = {
+      { "criticalSJJ", "#(JJ)J", reinterpret_cast<void*>(&Java_MyClassNatives_criticalSJJ) } };
+  ASSERT_EQ(JNI_OK, env_->RegisterNatives(jklass_, methods, 1));
+
+  EXPECT_EQ(0, gJava_MyClassNatives_criticalSJJ_calls);
+  jlong a = INT64_C(0x1234567890ABCDEF);
+  jlong b = INT64_C(0xFEDCBA0987654321);
+  jlong result = env_->CallStaticLongMethod(jklass_, jmethod_, a, b);
+  EXPECT_EQ(a - b, result);
+  EXPECT_EQ(1, gJava_MyClassNatives_criticalSJJ_calls);
+
+  // Unregistering restores the regular JNI convention.
+  env_->UnregisterNatives(jklass_);
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::ArtMethod* method = soa.DecodeMethod(jmethod_);
+  EXPECT_FALSE(method->IsCriticalNative());
+}
+
+TEST_F(JniCompilerTest, CriticalNativeRejectsReferenceArguments) {
+  TEST_DISABLED_FOR_PORTABLE();
+  SetUpForTest(true, "fooSIOO",
+               "(ILjava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;", nullptr);
+  JNINativeMethod methods[] = {
+      { "fooSIOO", "#(ILjava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;",
+        reinterpret_cast<void*>(&Java_MyClassNatives_criticalSII) } };
+  EXPECT_EQ(JNI_ERR, env_->RegisterNatives(jklass_, methods, 1));
+  EXPECT_TRUE(env_->ExceptionCheck() == JNI_TRUE);
+  env_->ExceptionClear();
+}
+
 int gJava_MyClassNatives_fooSIOO_calls = 0;
 jobject Java_MyClassNatives_fooSIOO(JNIEnv* env, jclass klass, jint x, jobject y,
                              jobject z) {
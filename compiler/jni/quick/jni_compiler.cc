@@ -48,6 +48,11 @@ static void CopyParameter(Assembler* jni_asm,
 static void SetNativeParameter(Assembler* jni_asm,
                                JniCallingConvention* jni_conv,
                                ManagedRegister in_reg);
+static void GenerateCriticalNativeCall(Assembler* jni_asm,
+                                       ManagedRuntimeCallingConvention* mr_conv,
+                                       JniCallingConvention* critical_jni_conv,
+                                       InstructionSet instruction_set,
+                                       size_t frame_size);
 
 // Generate the JNI bridge for the given method, general contract:
 // - Arguments are in the managed runtime format, either on stack or in
@@ -66,7 +71,7 @@ CompiledMethod* ArtJniCompileMethodInternal(CompilerDriver* driver,
   const bool is_64_bit_target = Is64BitInstructionSet(instruction_set);
   // Calling conventions used to iterate over parameters to method
   std::unique_ptr<JniCallingConvention> main_jni_conv(
-      JniCallingConvention::Create(is_static, is_synchronized, shorty, instruction_set));
+      JniCallingConvention::Create(is_static, is_synchronized, false, shorty, instruction_set));
   bool reference_return = main_jni_conv->IsReturnAReference();
 
   std::unique_ptr<ManagedRuntimeCallingConvention> mr_conv(
@@ -86,7 +91,20 @@ CompiledMethod* ArtJniCompileMethodInternal(CompilerDriver* driver,
   }
 
   std::unique_ptr<JniCallingConvention> end_jni_conv(
-      JniCallingConvention::Create(is_static, is_synchronized, jni_end_shorty, instruction_set));
+      JniCallingConvention::Create(is_static, is_synchronized, false, jni_end_shorty,
+                                   instruction_set));
+
+  // Static, unsynchronized methods taking and returning only primitives may be registered as
+  // critical natives at runtime. The stub for such a method checks the access flags on entry
+  // and, when kAccCriticalNative is set, calls the native code directly without a JNIEnv*, a
+  // jclass, a handle scope or a thread state transition.
+  const bool is_critical_native_candidate =
+      is_static && !is_synchronized && strchr(shorty, 'L') == nullptr;
+  std::unique_ptr<JniCallingConvention> critical_jni_conv;
+  if (is_critical_native_candidate) {
+    critical_jni_conv.reset(
+        JniCallingConvention::Create(is_static, is_synchronized, true, shorty, instruction_set));
+  }
 
   // Assembler that holds generated instructions
   std::unique_ptr<Assembler> jni_asm(Assembler::Create(instruction_set));
@@ -102,6 +120,14 @@ CompiledMethod* ArtJniCompileMethodInternal(CompilerDriver* driver,
   const std::vector<ManagedRegister>& callee_save_regs = main_jni_conv->CalleeSaveRegisters();
   __ BuildFrame(frame_size, mr_conv->MethodRegister(), callee_save_regs, mr_conv->EntrySpills());
 
+  // 1.5. Divert critical natives to the direct call emitted after the regular exit.
+  Label critical_native_entry;
+  if (is_critical_native_candidate) {
+    __ BranchIfBitSet(mr_conv->MethodRegister(), mirror::ArtMethod::AccessFlagsOffset(),
+                      kAccCriticalNative, mr_conv->InterproceduralScratchRegister(),
+                      &critical_native_entry);
+  }
+
   // 2. Set up the HandleScope
   mr_conv->ResetIterator(FrameOffset(frame_size));
   main_jni_conv->ResetIterator(FrameOffset(0));
@@ -422,6 +448,14 @@ CompiledMethod* ArtJniCompileMethodInternal(CompilerDriver* driver,
   //     them.
   __ RemoveFrame(frame_size, callee_save_regs);
 
+  // 16.5. Critical native path: call the native code directly in the frame built above.
+  if (is_critical_native_candidate) {
+    __ Bind(&critical_native_entry);
+    GenerateCriticalNativeCall(jni_asm.get(), mr_conv.get(), critical_jni_conv.get(),
+                               instruction_set, frame_size);
+    __ RemoveFrame(frame_size, callee_save_regs);
+  }
+
   // 17. Finalize code generation
   __ EmitSlowPaths();
   size_t cs = __ CodeSize();
@@ -530,6 +564,63 @@ static void CopyParameter(Assembler* jni_asm,
   }
 }
 
+// Call the native code of a critical native. The thread stays Runnable, so there is no
+// JNIEnv*, jclass, handle scope or local reference state to set up and nothing to check on
+// return; the frame is only extended for the outgoing arguments.
+static void GenerateCriticalNativeCall(Assembler* jni_asm,
+                                       ManagedRuntimeCallingConvention* mr_conv,
+                                       JniCallingConvention* critical_jni_conv,
+                                       InstructionSet instruction_set,
+                                       size_t frame_size) {
+  CHECK(critical_jni_conv->IsCriticalNative());
+  const size_t out_arg_size = critical_jni_conv->OutArgSize();
+  __ IncreaseFrameSize(out_arg_size);
+
+  // All managed arguments are on the stack once the entry spills are done, so the copies
+  // can be made in order without clobbering each other.
+  mr_conv->ResetIterator(FrameOffset(frame_size + out_arg_size));
+  critical_jni_conv->ResetIterator(FrameOffset(out_arg_size));
+  while (mr_conv->HasNext()) {
+    CHECK(critical_jni_conv->HasNext());
+    CopyParameter(jni_asm, mr_conv, critical_jni_conv, frame_size, out_arg_size);
+    mr_conv->Next();
+    critical_jni_conv->Next();
+  }
+
+  __ Call(critical_jni_conv->MethodStackOffset(), mirror::ArtMethod::NativeMethodOffset(),
+          mr_conv->InterproceduralScratchRegister());
+
+  if (critical_jni_conv->RequiresSmallResultTypeExtension()) {
+    if (critical_jni_conv->GetReturnType() == Primitive::kPrimByte ||
+        critical_jni_conv->GetReturnType() == Primitive::kPrimShort) {
+      __ SignExtend(critical_jni_conv->ReturnRegister(),
+                    Primitive::ComponentSize(critical_jni_conv->GetReturnType()));
+    } else if (critical_jni_conv->GetReturnType() == Primitive::kPrimBoolean ||
+               critical_jni_conv->GetReturnType() == Primitive::kPrimChar) {
+      __ ZeroExtend(critical_jni_conv->ReturnRegister(),
+                    Primitive::ComponentSize(critical_jni_conv->GetReturnType()));
+    }
+  }
+
+  // Move the result from the native to the managed return register through the frame, as
+  // they differ for floating point results on some ISAs.
+  if (critical_jni_conv->SizeOfReturnValue() != 0) {
+    FrameOffset return_save_location = critical_jni_conv->ReturnValueSaveLocation();
+    if (instruction_set == kMips &&
+        critical_jni_conv->GetReturnType() == Primitive::kPrimDouble &&
+        return_save_location.Uint32Value() % 8 != 0) {
+      // Ensure doubles are 8-byte aligned for MIPS
+      return_save_location = FrameOffset(return_save_location.Uint32Value() + kMipsPointerSize);
+    }
+    CHECK_LT(return_save_location.Uint32Value(), frame_size + out_arg_size);
+    __ Store(return_save_location, critical_jni_conv->ReturnRegister(),
+             critical_jni_conv->SizeOfReturnValue());
+    __ Load(mr_conv->ReturnRegister(), return_save_location, mr_conv->SizeOfReturnValue());
+  }
+
+  __ DecreaseFrameSize(out_arg_size);
+}
+
 static void SetNativeParameter(Assembler* jni_asm,
                                JniCallingConvention* jni_conv,
                                ManagedRegister in_reg) {
@@ -14,11 +14,17 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#include "base/unix_file/fd_file.h"
 #include "common_compiler_test.h"
 #include "compiler.h"
 #include "dex/verification_results.h"
 #include "dex/quick/dex_file_to_method_inliner_map.h"
 #include "dex/quick_compiler_callbacks.h"
+#include "driver/reused_oat_file.h"
 #include "entrypoints/quick/quick_entrypoints.h"
 #include "mirror/art_method-inl.h"
 #include "mirror/class-inl.h"
@@ -59,12 +65,12 @@ class OatTest : public CommonCompilerTest {
         EXPECT_EQ(oat_method.GetFpSpillMask(), compiled_method->GetFpSpillMask());
         uintptr_t oat_code_aligned = RoundDown(reinterpret_cast<uintptr_t>(quick_oat_code), 2);
         quick_oat_code = reinterpret_cast<const void*>(oat_code_aligned);
-        const std::vector<uint8_t>* quick_code = compiled_method->GetQuickCode();
-        EXPECT_TRUE(quick_code != nullptr);
-        size_t code_size = quick_code->size() * sizeof(quick_code[0]);
-        EXPECT_EQ(0, memcmp(quick_oat_code, &quick_code[0], code_size))
+        ArrayRef<const uint8_t> quick_code = compiled_method->GetQuickCode();
+        EXPECT_FALSE(quick_code.empty());
+        size_t code_size = quick_code.size() * sizeof(quick_code[0]);
+        EXPECT_EQ(0, memcmp(quick_oat_code, quick_code.data(), code_size))
             << PrettyMethod(method) << " " << code_size;
-        CHECK_EQ(0, memcmp(quick_oat_code, &quick_code[0], code_size));
+        CHECK_EQ(0, memcmp(quick_oat_code, quick_code.data(), code_size));
       } else {
         const void* portable_oat_code = oat_method.GetPortableCode();
         EXPECT_TRUE(portable_oat_code != nullptr) << PrettyMethod(method);
@@ -73,15 +79,18 @@ class OatTest : public CommonCompilerTest {
         EXPECT_EQ(oat_method.GetFpSpillMask(), 0U);
         uintptr_t oat_code_aligned = RoundDown(reinterpret_cast<uintptr_t>(portable_oat_code), 2);
         portable_oat_code = reinterpret_cast<const void*>(oat_code_aligned);
-        const std::vector<uint8_t>* portable_code = compiled_method->GetPortableCode();
-        EXPECT_TRUE(portable_code != nullptr);
-        size_t code_size = portable_code->size() * sizeof(portable_code[0]);
-        EXPECT_EQ(0, memcmp(quick_oat_code, &portable_code[0], code_size))
+        ArrayRef<const uint8_t> portable_code = compiled_method->GetPortableCode();
+        EXPECT_FALSE(portable_code.empty());
+        size_t code_size = portable_code.size() * sizeof(portable_code[0]);
+        EXPECT_EQ(0, memcmp(quick_oat_code, portable_code.data(), code_size))
             << PrettyMethod(method) << " " << code_size;
-        CHECK_EQ(0, memcmp(quick_oat_code, &portable_code[0], code_size));
+        CHECK_EQ(0, memcmp(quick_oat_code, portable_code.data(), code_size));
       }
     }
   }
+
+  void CompileReusingOatFile(const char* dex_name, size_t* reused_methods,
+                             size_t* recompiled_methods);
 };
 
 TEST_F(OatTest, WriteRead) {
@@ -181,6 +190,265 @@ TEST_F(OatTest, WriteRead) {
   }
 }
 
+TEST_F(OatTest, ReusedOatFileHeaderCheck) {
+  TimingLogger timings("OatTest::ReusedOatFileHeaderCheck", false, false);
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  InstructionSet insn_set = kIsTargetBuild ? kThumb2 : kX86;
+  InstructionSetFeatures insn_features;
+  compiler_options_.reset(new CompilerOptions);
+  verification_results_.reset(new VerificationResults(compiler_options_.get()));
+  method_inliner_map_.reset(new DexFileToMethodInlinerMap);
+  timer_.reset(new CumulativeLogger("Compilation times"));
+  compiler_driver_.reset(new CompilerDriver(compiler_options_.get(),
+                                            verification_results_.get(),
+                                            method_inliner_map_.get(),
+                                            Compiler::kQuick, insn_set,
+                                            insn_features, false, NULL, 2, true, true,
+                                            timer_.get()));
+
+  ScopedObjectAccess soa(Thread::Current());
+  ScratchFile tmp;
+  SafeMap<std::string, std::string> key_value_store;
+  key_value_store.Put(OatHeader::kDex2OatCmdLineKey,
+                      "dex2oat --dex-file=a.jar --oat-file=a.odex --compiler-filter=speed");
+  key_value_store.Put(OatHeader::kCompilerFilterKey, "speed");
+  OatWriter oat_writer(class_linker->GetBootClassPath(),
+                       42U,
+                       4096U,
+                       0,
+                       compiler_driver_.get(),
+                       &timings,
+                       &key_value_store);
+  ASSERT_TRUE(compiler_driver_->WriteElf(GetTestAndroidRoot(),
+                                         !kIsTargetBuild,
+                                         class_linker->GetBootClassPath(),
+                                         &oat_writer,
+                                         tmp.GetFile()));
+
+  std::string error_msg;
+  std::unique_ptr<ReusedOatFile> reused_oat_file(
+      ReusedOatFile::Open(tmp.GetFilename(), insn_set, insn_features, 42U, 4096U, 0,
+                          key_value_store, &error_msg));
+  EXPECT_TRUE(reused_oat_file.get() != nullptr) << error_msg;
+
+  // Code compiled against a different boot image or for a different target cannot be reused.
+  reused_oat_file.reset(
+      ReusedOatFile::Open(tmp.GetFilename(), insn_set, insn_features, 43U, 4096U, 0,
+                          key_value_store, &error_msg));
+  EXPECT_TRUE(reused_oat_file.get() == nullptr);
+  reused_oat_file.reset(
+      ReusedOatFile::Open(tmp.GetFilename(), insn_set, insn_features, 42U, 8192U, 0,
+                          key_value_store, &error_msg));
+  EXPECT_TRUE(reused_oat_file.get() == nullptr);
+  reused_oat_file.reset(
+      ReusedOatFile::Open(tmp.GetFilename(), kMips, insn_features, 42U, 4096U, 0,
+                          key_value_store, &error_msg));
+  EXPECT_TRUE(reused_oat_file.get() == nullptr);
+
+  // The input and output files do not matter, the compiler options do.
+  SafeMap<std::string, std::string> other_store(key_value_store);
+  other_store.Overwrite(OatHeader::kDex2OatCmdLineKey,
+                        "dex2oat --dex-file=b.jar --oat-file=b.odex --compiler-filter=speed "
+                        "--reuse-oat=a.odex");
+  reused_oat_file.reset(
+      ReusedOatFile::Open(tmp.GetFilename(), insn_set, insn_features, 42U, 4096U, 0,
+                          other_store, &error_msg));
+  EXPECT_TRUE(reused_oat_file.get() != nullptr) << error_msg;
+  other_store.Overwrite(OatHeader::kDex2OatCmdLineKey,
+                        "dex2oat --dex-file=a.jar --oat-file=a.odex --compiler-filter=speed "
+                        "--include-debug-symbols");
+  reused_oat_file.reset(
+      ReusedOatFile::Open(tmp.GetFilename(), insn_set, insn_features, 42U, 4096U, 0,
+                          other_store, &error_msg));
+  EXPECT_TRUE(reused_oat_file.get() == nullptr);
+  other_store = key_value_store;
+  other_store.Overwrite(OatHeader::kCompilerFilterKey, "everything");
+  reused_oat_file.reset(
+      ReusedOatFile::Open(tmp.GetFilename(), insn_set, insn_features, 42U, 4096U, 0,
+                          other_store, &error_msg));
+  EXPECT_TRUE(reused_oat_file.get() == nullptr);
+  reused_oat_file.reset(
+      ReusedOatFile::Open(tmp.GetFilename(), insn_set, insn_features, 42U, 4096U, 0,
+                          SafeMap<std::string, std::string>(), &error_msg));
+  EXPECT_TRUE(reused_oat_file.get() == nullptr);
+}
+
+// Compiles ReusedOat into an oat file, then compiles `dex_name` reusing it.
+void OatTest::CompileReusingOatFile(const char* dex_name, size_t* reused_methods,
+                                    size_t* recompiled_methods) {
+  TimingLogger timings("OatTest::CompileReusingOatFile", false, false);
+  // The fixture's driver compiles an image, which cannot reuse code.
+  InstructionSet insn_set = compiler_driver_->GetInstructionSet();
+  InstructionSetFeatures insn_features = compiler_driver_->GetInstructionSetFeatures();
+  SafeMap<std::string, std::string> key_value_store;
+  key_value_store.Put(OatHeader::kDex2OatCmdLineKey, "dex2oat --compiler-filter=speed");
+  key_value_store.Put(OatHeader::kCompilerFilterKey, "speed");
+
+  jobject class_loader;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    class_loader = LoadDex("ReusedOat");
+  }
+  std::vector<const DexFile*> dex_files =
+      Runtime::Current()->GetCompileTimeClassPath(class_loader);
+  compiler_driver_.reset(new CompilerDriver(compiler_options_.get(),
+                                            verification_results_.get(),
+                                            method_inliner_map_.get(),
+                                            Compiler::kQuick, insn_set,
+                                            insn_features, false, NULL, 2, true, true,
+                                            timer_.get()));
+  compiler_driver_->SetSupportBootImageFixup(false);
+  compiler_driver_->CompileAll(class_loader, dex_files, &timings);
+  ScratchFile tmp;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    OatWriter oat_writer(dex_files, 42U, 4096U, 0, compiler_driver_.get(), &timings,
+                         &key_value_store);
+    ASSERT_TRUE(compiler_driver_->WriteElf(GetTestAndroidRoot(), !kIsTargetBuild, dex_files,
+                                           &oat_writer, tmp.GetFile()));
+  }
+
+  std::string error_msg;
+  ReusedOatFile* reused_oat_file =
+      ReusedOatFile::Open(tmp.GetFilename(), insn_set, insn_features, 42U, 4096U, 0,
+                          key_value_store, &error_msg);
+  ASSERT_TRUE(reused_oat_file != nullptr) << error_msg;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    class_loader = LoadDex(dex_name);
+  }
+  dex_files = Runtime::Current()->GetCompileTimeClassPath(class_loader);
+  compiler_driver_.reset(new CompilerDriver(compiler_options_.get(),
+                                            verification_results_.get(),
+                                            method_inliner_map_.get(),
+                                            Compiler::kQuick, insn_set,
+                                            insn_features, false, NULL, 2, true, true,
+                                            timer_.get()));
+  compiler_driver_->SetSupportBootImageFixup(false);
+  compiler_driver_->SetReusedOatFile(reused_oat_file);
+  compiler_driver_->CompileAll(class_loader, dex_files, &timings);
+  *reused_methods = reused_oat_file->GetReusedMethodCount();
+  *recompiled_methods = reused_oat_file->GetRecompiledMethodCount();
+}
+
+TEST_F(OatTest, ReusedOatFileReusesUnchangedMethods) {
+  if (kUsePortableCompiler) {
+    return;  // Only Quick code is reused.
+  }
+  size_t reused_methods = 0;
+  size_t recompiled_methods = 0;
+  CompileReusingOatFile("ReusedOat", &reused_methods, &recompiled_methods);
+  // Unchanged.<init>, triple and sum, Changed.<init> and inc.
+  EXPECT_EQ(5U, reused_methods);
+  EXPECT_EQ(0U, recompiled_methods);
+}
+
+TEST_F(OatTest, ReusedOatFileRecompilesChangedMethods) {
+  if (kUsePortableCompiler) {
+    return;  // Only Quick code is reused.
+  }
+  size_t reused_methods = 0;
+  size_t recompiled_methods = 0;
+  CompileReusingOatFile("ReusedOat2", &reused_methods, &recompiled_methods);
+  // The code item of Changed.inc differs, which changes the hash of its class and so the keys of
+  // all of its methods. Unchanged does not refer to Changed and is still reused.
+  EXPECT_EQ(3U, reused_methods);
+  EXPECT_EQ(2U, recompiled_methods);
+}
+
+TEST_F(OatTest, HotMethodsComeFirst) {
+  if (kUsePortableCompiler) {
+    return;  // Only Quick code is laid out by group.
+  }
+  TimingLogger timings("OatTest::HotMethodsComeFirst", false, false);
+  InstructionSet insn_set = compiler_driver_->GetInstructionSet();
+  InstructionSetFeatures insn_features = compiler_driver_->GetInstructionSetFeatures();
+  // Unchanged.sum is hot. Changed.inc is profiled but below the top 90%, triple is not profiled.
+  ScratchFile profile;
+  std::string profile_data("100/0/0\n"
+                           "int Unchanged.sum(int[])/95/10\n"
+                           "int Changed.inc(int)/5/10\n");
+  ASSERT_TRUE(profile.GetFile()->WriteFully(profile_data.data(), profile_data.size()));
+
+  jobject class_loader;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    class_loader = LoadDex("ReusedOat");
+  }
+  std::vector<const DexFile*> dex_files =
+      Runtime::Current()->GetCompileTimeClassPath(class_loader);
+  ASSERT_EQ(1U, dex_files.size());
+  const DexFile* dex_file = dex_files[0];
+  compiler_driver_.reset(new CompilerDriver(compiler_options_.get(),
+                                            verification_results_.get(),
+                                            method_inliner_map_.get(),
+                                            Compiler::kQuick, insn_set,
+                                            insn_features, false, NULL, 2, true, true,
+                                            timer_.get(), profile.GetFilename()));
+  ASSERT_TRUE(compiler_driver_->ProfilePresent());
+  compiler_driver_->SetSupportBootImageFixup(false);
+  compiler_driver_->CompileAll(class_loader, dex_files, &timings);
+  ScratchFile tmp;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    SafeMap<std::string, std::string> key_value_store;
+    OatWriter oat_writer(dex_files, 42U, 4096U, 0, compiler_driver_.get(), &timings,
+                         &key_value_store);
+    ASSERT_TRUE(compiler_driver_->WriteElf(GetTestAndroidRoot(), !kIsTargetBuild, dex_files,
+                                           &oat_writer, tmp.GetFile()));
+  }
+  std::string error_msg;
+  std::unique_ptr<OatFile> oat_file(OatFile::Open(tmp.GetFilename(), tmp.GetFilename(), NULL,
+                                                  false, &error_msg));
+  ASSERT_TRUE(oat_file.get() != nullptr) << error_msg;
+  uint32_t dex_file_checksum = dex_file->GetLocationChecksum();
+  const OatFile::OatDexFile* oat_dex_file =
+      oat_file->GetOatDexFile(dex_file->GetLocation().c_str(), &dex_file_checksum);
+  ASSERT_TRUE(oat_dex_file != nullptr);
+
+  // Collect the code range of each layout group, in the order the oat writer visits them.
+  uint32_t begin[kCodeLayoutGroupCount];
+  uint32_t end[kCodeLayoutGroupCount];
+  std::fill_n(begin, kCodeLayoutGroupCount, std::numeric_limits<uint32_t>::max());
+  std::fill_n(end, kCodeLayoutGroupCount, 0u);
+  std::map<std::string, CodeLayoutGroup> groups;
+  for (size_t class_def_index = 0; class_def_index != dex_file->NumClassDefs();
+       ++class_def_index) {
+    const DexFile::ClassDef& class_def = dex_file->GetClassDef(class_def_index);
+    bool hot_class = (strcmp(dex_file->GetClassDescriptor(class_def), "LUnchanged;") == 0);
+    EXPECT_EQ(hot_class,
+              compiler_driver_->IsHotClass(ClassReference(dex_file, class_def_index)));
+    const OatFile::OatClass oat_class = oat_dex_file->GetOatClass(class_def_index);
+    ClassDataItemIterator it(*dex_file, dex_file->GetClassData(class_def));
+    while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+      it.Next();
+    }
+    for (size_t method_index = 0; it.HasNext(); ++method_index, it.Next()) {
+      MethodReference method_ref(dex_file, it.GetMemberIndex());
+      CodeLayoutGroup group = compiler_driver_->GetCodeLayoutGroup(method_ref);
+      groups.insert(std::make_pair(PrettyMethod(it.GetMemberIndex(), *dex_file), group));
+      uint32_t code_offset = oat_class.GetOatMethod(method_index).GetCodeOffset();
+      if (code_offset != 0u) {
+        begin[group] = std::min(begin[group], code_offset);
+        end[group] = std::max(end[group], code_offset);
+      }
+    }
+  }
+  EXPECT_EQ(kCodeLayoutHot, groups["int Unchanged.sum(int[])"]);
+  EXPECT_EQ(kCodeLayoutStartup, groups["void Unchanged.<init>()"]);
+  EXPECT_EQ(kCodeLayoutCold, groups["int Unchanged.triple(int)"]);
+  EXPECT_EQ(kCodeLayoutCold, groups["int Changed.inc(int)"]);
+  EXPECT_EQ(kCodeLayoutCold, groups["void Changed.<init>()"]);
+  // The hot and cold groups have compiled leaf methods; the constructors may be skipped.
+  ASSERT_NE(0u, end[kCodeLayoutHot]);
+  ASSERT_NE(0u, end[kCodeLayoutCold]);
+  EXPECT_LT(end[kCodeLayoutHot], begin[kCodeLayoutCold]);
+  if (end[kCodeLayoutStartup] != 0u) {
+    EXPECT_LT(end[kCodeLayoutHot], begin[kCodeLayoutStartup]);
+    EXPECT_LT(end[kCodeLayoutStartup], begin[kCodeLayoutCold]);
+  }
+}
+
 TEST_F(OatTest, OatHeaderSizeCheck) {
   // If this test is failing and you have to update these constants,
   // it is time to update OatHeader::kOatVersion
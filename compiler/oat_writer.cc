@@ -18,6 +18,8 @@
 
 #include <zlib.h>
 
+#include <algorithm>
+
 #include "base/bit_vector.h"
 #include "base/stl_util.h"
 #include "base/unix_file/fd_file.h"
@@ -93,6 +95,7 @@ OatWriter::OatWriter(const std::vector<const DexFile*>& dex_files,
     size_oat_class_method_bitmaps_(0),
     size_oat_class_method_offsets_(0) {
   CHECK(key_value_store != nullptr);
+  std::fill_n(code_layout_group_sizes_, static_cast<size_t>(kCodeLayoutGroupCount), 0u);
 
   size_t offset;
   {
@@ -138,8 +141,8 @@ OatWriter::~OatWriter() {
 }
 
 struct OatWriter::GcMapDataAccess {
-  static const std::vector<uint8_t>* GetData(const CompiledMethod* compiled_method) ALWAYS_INLINE {
-    return &compiled_method->GetGcMap();
+  static ArrayRef<const uint8_t> GetData(const CompiledMethod* compiled_method) ALWAYS_INLINE {
+    return compiled_method->GetGcMap();
   }
 
   static uint32_t GetOffset(OatClass* oat_class, size_t method_offsets_index) ALWAYS_INLINE {
@@ -157,8 +160,8 @@ struct OatWriter::GcMapDataAccess {
 };
 
 struct OatWriter::MappingTableDataAccess {
-  static const std::vector<uint8_t>* GetData(const CompiledMethod* compiled_method) ALWAYS_INLINE {
-    return &compiled_method->GetMappingTable();
+  static ArrayRef<const uint8_t> GetData(const CompiledMethod* compiled_method) ALWAYS_INLINE {
+    return compiled_method->GetMappingTable();
   }
 
   static uint32_t GetOffset(OatClass* oat_class, size_t method_offsets_index) ALWAYS_INLINE {
@@ -179,8 +182,8 @@ struct OatWriter::MappingTableDataAccess {
 };
 
 struct OatWriter::VmapTableDataAccess {
-  static const std::vector<uint8_t>* GetData(const CompiledMethod* compiled_method) ALWAYS_INLINE {
-    return &compiled_method->GetVmapTable();
+  static ArrayRef<const uint8_t> GetData(const CompiledMethod* compiled_method) ALWAYS_INLINE {
+    return compiled_method->GetVmapTable();
   }
 
   static uint32_t GetOffset(OatClass* oat_class, size_t method_offsets_index) ALWAYS_INLINE {
@@ -249,7 +252,8 @@ class OatWriter::OatDexMethodVisitor : public DexMethodVisitor {
   OatDexMethodVisitor(OatWriter* writer, size_t offset)
     : DexMethodVisitor(writer, offset),
       oat_class_index_(0u),
-      method_offsets_index_(0u) {
+      method_offsets_index_(0u),
+      layout_group_(kCodeLayoutGroupCount) {
   }
 
   bool StartClass(const DexFile* dex_file, size_t class_def_index) {
@@ -264,9 +268,24 @@ class OatWriter::OatDexMethodVisitor : public DexMethodVisitor {
     return DexMethodVisitor::EndClass();
   }
 
+  // Restrict the following visit to the methods in the given code layout group.
+  void StartLayoutGroup(CodeLayoutGroup layout_group) {
+    oat_class_index_ = 0u;
+    layout_group_ = layout_group;
+  }
+
  protected:
+  // Is the compiled method at method_offsets_index_ part of the visited layout group?
+  // Without a call to StartLayoutGroup() all methods are visited.
+  bool IsInLayoutGroup(const OatClass* oat_class) const {
+    DCHECK_LT(method_offsets_index_, oat_class->layout_groups_.size());
+    return layout_group_ == kCodeLayoutGroupCount ||
+        oat_class->layout_groups_[method_offsets_index_] == layout_group_;
+  }
+
   size_t oat_class_index_;
   size_t method_offsets_index_;
+  CodeLayoutGroup layout_group_;
 };
 
 class OatWriter::InitOatClassesMethodVisitor : public DexMethodVisitor {
@@ -274,13 +293,16 @@ class OatWriter::InitOatClassesMethodVisitor : public DexMethodVisitor {
   InitOatClassesMethodVisitor(OatWriter* writer, size_t offset)
     : DexMethodVisitor(writer, offset),
       compiled_methods_(),
+      layout_groups_(),
       num_non_null_compiled_methods_(0u) {
     compiled_methods_.reserve(256u);
+    layout_groups_.reserve(256u);
   }
 
   bool StartClass(const DexFile* dex_file, size_t class_def_index) {
     DexMethodVisitor::StartClass(dex_file, class_def_index);
     compiled_methods_.clear();
+    layout_groups_.clear();
     num_non_null_compiled_methods_ = 0u;
     return true;
   }
@@ -296,6 +318,10 @@ class OatWriter::InitOatClassesMethodVisitor : public DexMethodVisitor {
     compiled_methods_.push_back(compiled_method);
     if (compiled_method != nullptr) {
         ++num_non_null_compiled_methods_;
+        CodeLayoutGroup layout_group = writer_->compiler_driver_->GetCodeLayoutGroup(
+            MethodReference(dex_file_, method_idx));
+        layout_groups_.push_back(layout_group);
+        ++writer_->code_layout_group_sizes_[layout_group];
     }
     return true;
   }
@@ -312,7 +338,7 @@ class OatWriter::InitOatClassesMethodVisitor : public DexMethodVisitor {
       status = mirror::Class::kStatusNotReady;
     }
 
-    OatClass* oat_class = new OatClass(offset_, compiled_methods_,
+    OatClass* oat_class = new OatClass(offset_, compiled_methods_, layout_groups_,
                                        num_non_null_compiled_methods_, status);
     writer_->oat_classes_.push_back(oat_class);
     offset_ += oat_class->SizeOf();
@@ -321,6 +347,7 @@ class OatWriter::InitOatClassesMethodVisitor : public DexMethodVisitor {
 
  private:
   std::vector<CompiledMethod*> compiled_methods_;
+  std::vector<CodeLayoutGroup> layout_groups_;
   size_t num_non_null_compiled_methods_;
 };
 
@@ -335,24 +362,27 @@ class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
     OatClass* oat_class = writer_->oat_classes_[oat_class_index_];
     CompiledMethod* compiled_method = oat_class->GetCompiledMethod(class_def_method_index);
 
-    if (compiled_method != nullptr) {
+    if (compiled_method != nullptr && !IsInLayoutGroup(oat_class)) {
+      // Laid out with another group.
+      ++method_offsets_index_;
+    } else if (compiled_method != nullptr) {
       // Derived from CompiledMethod.
       uint32_t quick_code_offset = 0;
 
-      const std::vector<uint8_t>* portable_code = compiled_method->GetPortableCode();
-      const std::vector<uint8_t>* quick_code = compiled_method->GetQuickCode();
-      if (portable_code != nullptr) {
-        CHECK(quick_code == nullptr);
+      ArrayRef<const uint8_t> portable_code = compiled_method->GetPortableCode();
+      ArrayRef<const uint8_t> quick_code = compiled_method->GetQuickCode();
+      if (!portable_code.empty()) {
+        CHECK(quick_code.empty());
         size_t oat_method_offsets_offset =
             oat_class->GetOatMethodOffsetsOffsetFromOatHeader(class_def_method_index);
         compiled_method->AddOatdataOffsetToCompliledCodeOffset(
             oat_method_offsets_offset + OFFSETOF_MEMBER(OatMethodOffsets, code_offset_));
       } else {
-        CHECK(quick_code != nullptr);
+        CHECK(!quick_code.empty());
         offset_ = compiled_method->AlignCode(offset_);
         DCHECK_ALIGNED_PARAM(offset_,
                              GetInstructionSetAlignment(compiled_method->GetInstructionSet()));
-        uint32_t code_size = quick_code->size() * sizeof(uint8_t);
+        uint32_t code_size = quick_code.size() * sizeof(uint8_t);
         CHECK_NE(code_size, 0U);
         uint32_t thumb_offset = compiled_method->CodeDelta();
         quick_code_offset = offset_ + sizeof(OatQuickMethodHeader) + thumb_offset;
@@ -396,7 +426,7 @@ class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
         if (!deduped) {
           writer_->oat_header_->UpdateChecksum(method_header, sizeof(*method_header));
           offset_ += sizeof(*method_header);  // Method header is prepended before code.
-          writer_->oat_header_->UpdateChecksum(&(*quick_code)[0], code_size);
+          writer_->oat_header_->UpdateChecksum(quick_code.data(), code_size);
           offset_ += code_size;
         }
 
@@ -404,11 +434,11 @@ class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
         std::vector<uint8_t>* cfi_info = writer_->compiler_driver_->GetCallFrameInformation();
         if (cfi_info != nullptr) {
           // Copy in the FDE, if present
-          const std::vector<uint8_t>* fde = compiled_method->GetCFIInfo();
-          if (fde != nullptr) {
+          ArrayRef<const uint8_t> fde = compiled_method->GetCFIInfo();
+          if (!fde.empty()) {
             // Copy the information into cfi_info and then fix the address in the new copy.
             int cur_offset = cfi_info->size();
-            cfi_info->insert(cfi_info->end(), fde->begin(), fde->end());
+            cfi_info->insert(cfi_info->end(), fde.begin(), fde.end());
 
             // Set the 'CIE_pointer' field to cur_offset+4.
             uint32_t CIE_pointer = cur_offset + 4;
@@ -457,11 +487,11 @@ class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
         } else {
           status = mirror::Class::kStatusNotReady;
         }
-        const std::vector<uint8_t>& gc_map = compiled_method->GetGcMap();
+        ArrayRef<const uint8_t> gc_map = compiled_method->GetGcMap();
         size_t gc_map_size = gc_map.size() * sizeof(gc_map[0]);
         bool is_native = (it.GetMemberAccessFlags() & kAccNative) != 0;
         CHECK(gc_map_size != 0 || is_native || status < mirror::Class::kStatusVerified)
-            << &gc_map << " " << gc_map_size << " " << (is_native ? "true" : "false") << " "
+            << static_cast<const void*>(gc_map.data()) << " " << gc_map_size << " " << (is_native ? "true" : "false") << " "
             << (status < mirror::Class::kStatusVerified) << " " << status << " "
             << PrettyMethod(it.GetMemberIndex(), *dex_file_);
       }
@@ -497,17 +527,18 @@ class OatWriter::InitMapMethodVisitor : public OatDexMethodVisitor {
       DCHECK_LT(method_offsets_index_, oat_class->method_offsets_.size());
       DCHECK_EQ(DataAccess::GetOffset(oat_class, method_offsets_index_), 0u);
 
-      const std::vector<uint8_t>* map = DataAccess::GetData(compiled_method);
-      uint32_t map_size = map->size() * sizeof((*map)[0]);
+      ArrayRef<const uint8_t> map = DataAccess::GetData(compiled_method);
+      uint32_t map_size = map.size() * sizeof(map[0]);
       if (map_size != 0u) {
-        auto lb = dedupe_map_.lower_bound(map);
-        if (lb != dedupe_map_.end() && !dedupe_map_.key_comp()(map, lb->first)) {
+        // Deduplicated tables are identified by their data.
+        auto lb = dedupe_map_.lower_bound(map.data());
+        if (lb != dedupe_map_.end() && !dedupe_map_.key_comp()(map.data(), lb->first)) {
           DataAccess::SetOffset(oat_class, method_offsets_index_, lb->second);
         } else {
           DataAccess::SetOffset(oat_class, method_offsets_index_, offset_);
-          dedupe_map_.PutBefore(lb, map, offset_);
+          dedupe_map_.PutBefore(lb, map.data(), offset_);
           offset_ += map_size;
-          writer_->oat_header_->UpdateChecksum(&(*map)[0], map_size);
+          writer_->oat_header_->UpdateChecksum(map.data(), map_size);
         }
       }
       ++method_offsets_index_;
@@ -519,7 +550,7 @@ class OatWriter::InitMapMethodVisitor : public OatDexMethodVisitor {
  private:
   // Deduplication is already done on a pointer basis by the compiler driver,
   // so we can simply compare the pointers to find out if things are duplicated.
-  SafeMap<const std::vector<uint8_t>*, uint32_t> dedupe_map_;
+  SafeMap<const uint8_t*, uint32_t> dedupe_map_;
 };
 
 class OatWriter::InitImageMethodVisitor : public OatDexMethodVisitor {
@@ -572,13 +603,16 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
     OatClass* oat_class = writer_->oat_classes_[oat_class_index_];
     const CompiledMethod* compiled_method = oat_class->GetCompiledMethod(class_def_method_index);
 
-    if (compiled_method != NULL) {  // ie. not an abstract method
+    if (compiled_method != NULL && !IsInLayoutGroup(oat_class)) {
+      // Written with another group.
+      ++method_offsets_index_;
+    } else if (compiled_method != NULL) {  // ie. not an abstract method
       size_t file_offset = file_offset_;
       OutputStream* out = out_;
 
-      const std::vector<uint8_t>* quick_code = compiled_method->GetQuickCode();
-      if (quick_code != nullptr) {
-        CHECK(compiled_method->GetPortableCode() == nullptr);
+      ArrayRef<const uint8_t> quick_code = compiled_method->GetQuickCode();
+      if (!quick_code.empty()) {
+        CHECK(compiled_method->GetPortableCode().empty());
         uint32_t aligned_offset = compiled_method->AlignCode(offset_);
         uint32_t aligned_code_delta = aligned_offset - offset_;
         if (aligned_code_delta != 0) {
@@ -596,7 +630,7 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
         }
         DCHECK_ALIGNED_PARAM(offset_,
                              GetInstructionSetAlignment(compiled_method->GetInstructionSet()));
-        uint32_t code_size = quick_code->size() * sizeof(uint8_t);
+        uint32_t code_size = quick_code.size() * sizeof(uint8_t);
         CHECK_NE(code_size, 0U);
 
         // Deduplicate code arrays.
@@ -613,7 +647,7 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
           writer_->size_method_header_ += sizeof(method_header);
           offset_ += sizeof(method_header);
           DCHECK_OFFSET_();
-          if (!out->WriteFully(&(*quick_code)[0], code_size)) {
+          if (!out->WriteFully(quick_code.data(), code_size)) {
             ReportWriteFailure("method code", it);
             return false;
           }
@@ -660,13 +694,13 @@ class OatWriter::WriteMapMethodVisitor : public OatDexMethodVisitor {
       ++method_offsets_index_;
 
       // Write deduplicated map.
-      const std::vector<uint8_t>* map = DataAccess::GetData(compiled_method);
-      size_t map_size = map->size() * sizeof((*map)[0]);
+      ArrayRef<const uint8_t> map = DataAccess::GetData(compiled_method);
+      size_t map_size = map.size() * sizeof(map[0]);
       DCHECK((map_size == 0u && map_offset == 0u) ||
             (map_size != 0u && map_offset != 0u && map_offset <= offset_))
           << PrettyMethod(it.GetMemberIndex(), *dex_file_);
       if (map_size != 0u && map_offset == offset_) {
-        if (UNLIKELY(!out->WriteFully(&(*map)[0], map_size))) {
+        if (UNLIKELY(!out->WriteFully(map.data(), map_size))) {
           ReportWriteFailure(it);
           return false;
         }
@@ -730,6 +764,25 @@ bool OatWriter::VisitDexMethods(DexMethodVisitor* visitor) {
   return true;
 }
 
+template <typename Visitor>
+bool OatWriter::VisitDexMethodsByLayoutGroup(Visitor* visitor) {
+  for (size_t i = 0; i != kCodeLayoutGroupCount; ++i) {
+    CodeLayoutGroup layout_group = static_cast<CodeLayoutGroup>(i);
+    if (code_layout_group_sizes_[layout_group] == 0u) {
+      continue;
+    }
+    size_t start_offset = visitor->GetOffset();
+    visitor->StartLayoutGroup(layout_group);
+    if (UNLIKELY(!VisitDexMethods(visitor))) {
+      return false;
+    }
+    VLOG(compiler) << "Oat code layout group " << layout_group << ": "
+        << code_layout_group_sizes_[layout_group] << " methods, "
+        << PrettySize(visitor->GetOffset() - start_offset);
+  }
+  return true;
+}
+
 size_t OatWriter::InitOatHeader() {
   oat_header_ = OatHeader::Create(compiler_driver_->GetInstructionSet(),
                                   compiler_driver_->GetInstructionSetFeatures(),
@@ -866,7 +919,13 @@ size_t OatWriter::InitOatCodeDexFiles(size_t offset) {
       offset = visitor.GetOffset();                   \
     } while (false)
 
-  VISIT(InitCodeMethodVisitor);
+  {
+    // Lay out the code of hot methods first so that it is packed into as few pages as possible.
+    InitCodeMethodVisitor visitor(this, offset);
+    bool success = VisitDexMethodsByLayoutGroup(&visitor);
+    DCHECK(success);
+    offset = visitor.GetOffset();
+  }
   if (compiler_driver_->IsImage()) {
     VISIT(InitImageMethodVisitor);
   }
@@ -1068,20 +1127,12 @@ size_t OatWriter::WriteCode(OutputStream* out, const size_t file_offset, size_t
 size_t OatWriter::WriteCodeDexFiles(OutputStream* out,
                                     const size_t file_offset,
                                     size_t relative_offset) {
-  #define VISIT(VisitorType)                                              \
-    do {                                                                  \
-      VisitorType visitor(this, out, file_offset, relative_offset);       \
-      if (UNLIKELY(!VisitDexMethods(&visitor))) {                         \
-        return 0;                                                         \
-      }                                                                   \
-      relative_offset = visitor.GetOffset();                              \
-    } while (false)
-
-  VISIT(WriteCodeMethodVisitor);
-
-  #undef VISIT
-
-  return relative_offset;
+  // Write the code in the same order as it was laid out by InitOatCodeDexFiles().
+  WriteCodeMethodVisitor visitor(this, out, file_offset, relative_offset);
+  if (UNLIKELY(!VisitDexMethodsByLayoutGroup(&visitor))) {
+    return 0;
+  }
+  return visitor.GetOffset();
 }
 
 OatWriter::OatDexFile::OatDexFile(size_t offset, const DexFile& dex_file) {
@@ -1147,11 +1198,14 @@ bool OatWriter::OatDexFile::Write(OatWriter* oat_writer,
 
 OatWriter::OatClass::OatClass(size_t offset,
                               const std::vector<CompiledMethod*>& compiled_methods,
+                              const std::vector<CodeLayoutGroup>& layout_groups,
                               uint32_t num_non_null_compiled_methods,
                               mirror::Class::Status status)
-    : compiled_methods_(compiled_methods) {
+    : compiled_methods_(compiled_methods),
+      layout_groups_(layout_groups) {
   uint32_t num_methods = compiled_methods.size();
   CHECK_LE(num_non_null_compiled_methods, num_methods);
+  CHECK_EQ(num_non_null_compiled_methods, layout_groups.size());
 
   offset_ = offset;
   oat_method_offsets_offsets_from_oat_class_.resize(num_methods);
@@ -141,6 +141,11 @@ class OatWriter {
   // with a given DexMethodVisitor.
   bool VisitDexMethods(DexMethodVisitor* visitor);
 
+  // Visit the methods once for each non-empty code layout group, in layout order, so
+  // that the code visitors lay out the code of each group contiguously.
+  template <typename Visitor>
+  bool VisitDexMethodsByLayoutGroup(Visitor* visitor);
+
   size_t InitOatHeader();
   size_t InitOatDexFiles(size_t offset);
   size_t InitDexFiles(size_t offset);
@@ -182,6 +187,7 @@ class OatWriter {
    public:
     explicit OatClass(size_t offset,
                       const std::vector<CompiledMethod*>& compiled_methods,
+                      const std::vector<CodeLayoutGroup>& layout_groups,
                       uint32_t num_non_null_compiled_methods,
                       mirror::Class::Status status);
     ~OatClass();
@@ -206,6 +212,10 @@ class OatWriter {
     // CompiledMethods for each class_def_method_index, or NULL if no method is available.
     std::vector<CompiledMethod*> compiled_methods_;
 
+    // The code layout group of each CompiledMethod present in the OatClass, indexed
+    // like method_offsets_.
+    std::vector<CodeLayoutGroup> layout_groups_;
+
     // Offset from OatClass::offset_ to the OatMethodOffsets for the
     // class_def_method_index. If 0, it means the corresponding
     // CompiledMethod entry in OatClass::compiled_methods_ should be
@@ -261,6 +271,8 @@ class OatWriter {
   OatHeader* oat_header_;
   std::vector<OatDexFile*> oat_dex_files_;
   std::vector<OatClass*> oat_classes_;
+  // Number of compiled methods in each code layout group.
+  size_t code_layout_group_sizes_[kCodeLayoutGroupCount];
   std::unique_ptr<const std::vector<uint8_t>> interpreter_to_interpreter_bridge_;
   std::unique_ptr<const std::vector<uint8_t>> interpreter_to_compiled_code_bridge_;
   std::unique_ptr<const std::vector<uint8_t>> jni_dlsym_lookup_;
@@ -307,15 +319,16 @@ class OatWriter {
 
   struct CodeOffsetsKeyComparator {
     bool operator()(const CompiledMethod* lhs, const CompiledMethod* rhs) const {
-      if (lhs->GetQuickCode() != rhs->GetQuickCode()) {
-        return lhs->GetQuickCode() < rhs->GetQuickCode();
+      // Deduplicated arrays are compared by their data.
+      if (lhs->GetQuickCode().data() != rhs->GetQuickCode().data()) {
+        return lhs->GetQuickCode().data() < rhs->GetQuickCode().data();
       }
       // If the code is the same, all other fields are likely to be the same as well.
-      if (UNLIKELY(&lhs->GetMappingTable() != &rhs->GetMappingTable())) {
-        return &lhs->GetMappingTable() < &rhs->GetMappingTable();
+      if (UNLIKELY(lhs->GetMappingTable().data() != rhs->GetMappingTable().data())) {
+        return lhs->GetMappingTable().data() < rhs->GetMappingTable().data();
       }
-      if (UNLIKELY(&lhs->GetVmapTable() != &rhs->GetVmapTable())) {
-        return &lhs->GetVmapTable() < &rhs->GetVmapTable();
+      if (UNLIKELY(lhs->GetVmapTable().data() != rhs->GetVmapTable().data())) {
+        return lhs->GetVmapTable().data() < rhs->GetVmapTable().data();
       }
       return false;
     }
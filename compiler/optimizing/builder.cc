@@ -23,6 +23,7 @@
 #include "dex_instruction.h"
 #include "dex_instruction-inl.h"
 #include "driver/compiler_driver-inl.h"
+#include "method_reference.h"
 #include "mirror/art_field.h"
 #include "mirror/art_field-inl.h"
 #include "mirror/class_loader.h"
@@ -65,6 +66,40 @@ class Temporaries : public ValueObject {
   size_t index_;
 };
 
+/**
+ * Helper class to read the payload of a packed-switch or sparse-switch
+ * instruction. Target offsets are relative to the switch instruction.
+ */
+class SwitchTable : public ValueObject {
+ public:
+  explicit SwitchTable(const Instruction& instruction)
+      : sparse_(instruction.Opcode() == Instruction::SPARSE_SWITCH),
+        payload_(reinterpret_cast<const uint16_t*>(&instruction) + instruction.VRegB_31t()),
+        values_(reinterpret_cast<const int32_t*>(payload_ + 2)) {
+    DCHECK_EQ(payload_[0], sparse_ ? static_cast<uint16_t>(Instruction::kSparseSwitchSignature)
+                                   : static_cast<uint16_t>(Instruction::kPackedSwitchSignature));
+  }
+
+  size_t GetNumEntries() const { return payload_[1]; }
+
+  int32_t GetKeyAt(size_t index) const {
+    return sparse_ ? values_[index] : values_[0] + static_cast<int32_t>(index);
+  }
+
+  int32_t GetTargetOffsetAt(size_t index) const {
+    return sparse_ ? values_[GetNumEntries() + index] : values_[1 + index];
+  }
+
+ private:
+  const bool sparse_;
+  const uint16_t* const payload_;
+  // Keys followed by targets for sparse switches, first key followed by targets for
+  // packed switches.
+  const int32_t* const values_;
+
+  DISALLOW_COPY_AND_ASSIGN(SwitchTable);
+};
+
 static bool IsTypeSupported(Primitive::Type type) {
   return type != Primitive::kPrimFloat && type != Primitive::kPrimDouble;
 }
@@ -231,7 +266,6 @@ void HGraphBuilder::MaybeUpdateCurrentBlock(size_t index) {
 }
 
 void HGraphBuilder::ComputeBranchTargets(const uint16_t* code_ptr, const uint16_t* code_end) {
-  // TODO: Support switch instructions.
   branch_targets_.SetSize(code_end - code_ptr);
 
   // Create the first block for the dex instructions, single successor of the entry block.
@@ -257,6 +291,21 @@ void HGraphBuilder::ComputeBranchTargets(const uint16_t* code_ptr, const uint16_
         block = new (arena_) HBasicBlock(graph_);
         branch_targets_.Put(dex_offset, block);
       }
+    } else if (instruction.IsSwitch()) {
+      SwitchTable table(instruction);
+      for (size_t i = 0, e = table.GetNumEntries(); i < e; ++i) {
+        int32_t target = table.GetTargetOffsetAt(i) + dex_offset;
+        if (FindBlockStartingAt(target) == nullptr) {
+          block = new (arena_) HBasicBlock(graph_);
+          branch_targets_.Put(target, block);
+        }
+      }
+      dex_offset += instruction.SizeInCodeUnits();
+      code_ptr += instruction.SizeInCodeUnits();
+      if ((code_ptr < code_end) && (FindBlockStartingAt(dex_offset) == nullptr)) {
+        block = new (arena_) HBasicBlock(graph_);
+        branch_targets_.Put(dex_offset, block);
+      }
     } else {
       code_ptr += instruction.SizeInCodeUnits();
       dex_offset += instruction.SizeInCodeUnits();
@@ -307,6 +356,62 @@ void HGraphBuilder::Binop_22b(const Instruction& instruction, bool reverse) {
   UpdateLocal(instruction.VRegA(), current_block_->GetLastInstruction());
 }
 
+template<typename T>
+void HGraphBuilder::LongShift_23x(const Instruction& instruction) {
+  HInstruction* first = LoadLocal(instruction.VRegB(), Primitive::kPrimLong);
+  HInstruction* second = LoadLocal(instruction.VRegC(), Primitive::kPrimInt);
+  current_block_->AddInstruction(new (arena_) T(Primitive::kPrimLong, first, second));
+  UpdateLocal(instruction.VRegA(), current_block_->GetLastInstruction());
+}
+
+template<typename T>
+void HGraphBuilder::LongShift_12x(const Instruction& instruction) {
+  HInstruction* first = LoadLocal(instruction.VRegA(), Primitive::kPrimLong);
+  HInstruction* second = LoadLocal(instruction.VRegB(), Primitive::kPrimInt);
+  current_block_->AddInstruction(new (arena_) T(Primitive::kPrimLong, first, second));
+  UpdateLocal(instruction.VRegA(), current_block_->GetLastInstruction());
+}
+
+template<typename T>
+void HGraphBuilder::BuildCheckedDivRem(uint16_t out_reg,
+                                       HInstruction* first,
+                                       HInstruction* second,
+                                       Primitive::Type type,
+                                       uint32_t dex_offset) {
+  // The check has to be right before the division, as the baseline code generator only
+  // keeps the previous instruction live.
+  if (!second->IsIntConstant() || second->AsIntConstant()->GetValue() == 0) {
+    second = new (arena_) HDivZeroCheck(second, dex_offset);
+    current_block_->AddInstruction(second);
+  }
+  current_block_->AddInstruction(new (arena_) T(type, first, second, dex_offset));
+  UpdateLocal(out_reg, current_block_->GetLastInstruction());
+}
+
+template<typename T>
+void HGraphBuilder::Unop_12x(const Instruction& instruction, Primitive::Type type) {
+  HInstruction* first = LoadLocal(instruction.VRegB(), type);
+  current_block_->AddInstruction(new (arena_) T(type, first));
+  UpdateLocal(instruction.VRegA(), current_block_->GetLastInstruction());
+}
+
+void HGraphBuilder::Conversion_12x(const Instruction& instruction,
+                                   Primitive::Type input_type,
+                                   Primitive::Type result_type) {
+  HInstruction* first = LoadLocal(instruction.VRegB(), input_type);
+  current_block_->AddInstruction(new (arena_) HTypeConversion(result_type, first));
+  UpdateLocal(instruction.VRegA(), current_block_->GetLastInstruction());
+}
+
+void HGraphBuilder::Not_12x(const Instruction& instruction, Primitive::Type type) {
+  HInstruction* first = LoadLocal(instruction.VRegB(), type);
+  HInstruction* all_ones = (type == Primitive::kPrimLong)
+      ? static_cast<HInstruction*>(GetLongConstant(-1))
+      : static_cast<HInstruction*>(GetIntConstant(-1));
+  current_block_->AddInstruction(new (arena_) HXor(type, first, all_ones));
+  UpdateLocal(instruction.VRegA(), current_block_->GetLastInstruction());
+}
+
 void HGraphBuilder::BuildReturn(const Instruction& instruction, Primitive::Type type) {
   if (type == Primitive::kPrimVoid) {
     current_block_->AddInstruction(new (arena_) HReturnVoid());
@@ -334,9 +439,40 @@ bool HGraphBuilder::BuildInvoke(const Instruction& instruction,
       && instruction.Opcode() != Instruction::INVOKE_STATIC_RANGE;
   const size_t number_of_arguments = strlen(descriptor) - (is_instance_call ? 0 : 1);
 
-  // Treat invoke-direct like static calls for now.
-  HInvoke* invoke = new (arena_) HInvokeStatic(
-      arena_, number_of_arguments, return_type, dex_offset, method_idx);
+  HInvoke* invoke = nullptr;
+  if (instruction.Opcode() == Instruction::INVOKE_VIRTUAL
+      || instruction.Opcode() == Instruction::INVOKE_VIRTUAL_RANGE) {
+    if (compiler_driver_ == nullptr) {
+      return false;
+    }
+    InvokeType invoke_type = kVirtual;
+    MethodReference target_method(dex_file_, method_idx);
+    int vtable_index;
+    uintptr_t direct_code;
+    uintptr_t direct_method;
+    if (!compiler_driver_->ComputeInvokeInfo(dex_compilation_unit_, dex_offset, true, false,
+                                             &invoke_type, &target_method, &vtable_index,
+                                             &direct_code, &direct_method)) {
+      // The target could not be resolved, we do not implement the slow path.
+      return false;
+    }
+    if (invoke_type == kVirtual) {
+      invoke = new (arena_) HInvokeVirtual(
+          arena_, number_of_arguments, return_type, dex_offset, vtable_index);
+    } else if (invoke_type == kDirect && target_method.dex_file == dex_file_) {
+      // A final method, dispatch it like invoke-direct.
+      invoke = new (arena_) HInvokeStatic(
+          arena_, number_of_arguments, return_type, dex_offset,
+          target_method.dex_method_index, kDirect);
+    } else {
+      return false;
+    }
+  } else {
+    // Treat invoke-direct like static calls for now.
+    invoke = new (arena_) HInvokeStatic(
+        arena_, number_of_arguments, return_type, dex_offset, method_idx,
+        is_instance_call ? kDirect : kStatic);
+  }
 
   size_t start_index = 0;
   Temporaries temps(graph_, is_instance_call ? 1 : 0);
@@ -378,6 +514,46 @@ bool HGraphBuilder::BuildInvoke(const Instruction& instruction,
   return true;
 }
 
+void HGraphBuilder::BuildSwitch(const Instruction& instruction, uint32_t dex_offset) {
+  SwitchTable table(instruction);
+  HBasicBlock* fall_through = FindBlockStartingAt(dex_offset + instruction.SizeInCodeUnits());
+  DCHECK(fall_through != nullptr);
+
+  // Entries branching to the fall-through block do not need a test.
+  size_t number_of_tests = 0;
+  for (size_t i = 0, e = table.GetNumEntries(); i < e; ++i) {
+    if (FindBlockStartingAt(dex_offset + table.GetTargetOffsetAt(i)) != fall_through) {
+      ++number_of_tests;
+    }
+  }
+  if (number_of_tests == 0) {
+    return;
+  }
+
+  // Lower the switch to a chain of equality tests, each in its own block.
+  for (size_t i = 0, e = table.GetNumEntries(); i < e; ++i) {
+    HBasicBlock* target = FindBlockStartingAt(dex_offset + table.GetTargetOffsetAt(i));
+    DCHECK(target != nullptr);
+    if (target == fall_through) {
+      continue;
+    }
+    HInstruction* value = LoadLocal(instruction.VRegA_31t(), Primitive::kPrimInt);
+    HEqual* comparison = new (arena_) HEqual(value, GetIntConstant(table.GetKeyAt(i)));
+    current_block_->AddInstruction(comparison);
+    current_block_->AddInstruction(new (arena_) HIf(comparison));
+    current_block_->AddSuccessor(target);
+    if (--number_of_tests == 0) {
+      current_block_->AddSuccessor(fall_through);
+    } else {
+      HBasicBlock* next = new (arena_) HBasicBlock(graph_);
+      graph_->AddBlock(next);
+      current_block_->AddSuccessor(next);
+      current_block_ = next;
+    }
+  }
+  current_block_ = nullptr;
+}
+
 bool HGraphBuilder::BuildFieldAccess(const Instruction& instruction,
                                      uint32_t dex_offset,
                                      bool is_put) {
@@ -602,7 +778,8 @@ bool HGraphBuilder::AnalyzeDexInstruction(const Instruction& instruction, int32_
     }
 
     case Instruction::INVOKE_STATIC:
-    case Instruction::INVOKE_DIRECT: {
+    case Instruction::INVOKE_DIRECT:
+    case Instruction::INVOKE_VIRTUAL: {
       uint32_t method_idx = instruction.VRegB_35c();
       uint32_t number_of_vreg_arguments = instruction.VRegA_35c();
       uint32_t args[5];
@@ -614,7 +791,8 @@ bool HGraphBuilder::AnalyzeDexInstruction(const Instruction& instruction, int32_
     }
 
     case Instruction::INVOKE_STATIC_RANGE:
-    case Instruction::INVOKE_DIRECT_RANGE: {
+    case Instruction::INVOKE_DIRECT_RANGE:
+    case Instruction::INVOKE_VIRTUAL_RANGE: {
       uint32_t method_idx = instruction.VRegB_3rc();
       uint32_t number_of_vreg_arguments = instruction.VRegA_3rc();
       uint32_t register_index = instruction.VRegC();
@@ -685,6 +863,163 @@ bool HGraphBuilder::AnalyzeDexInstruction(const Instruction& instruction, int32_
       break;
     }
 
+#define BINOP_XX(opcode, type, binop)                                             \
+    case Instruction::opcode: {                                                   \
+      Binop_23x<binop>(instruction, Primitive::type);                             \
+      break;                                                                      \
+    }                                                                             \
+    case Instruction::opcode##_2ADDR: {                                           \
+      Binop_12x<binop>(instruction, Primitive::type);                             \
+      break;                                                                      \
+    }
+
+    BINOP_XX(MUL_INT, kPrimInt, HMul);
+    BINOP_XX(MUL_LONG, kPrimLong, HMul);
+    BINOP_XX(AND_INT, kPrimInt, HAnd);
+    BINOP_XX(AND_LONG, kPrimLong, HAnd);
+    BINOP_XX(OR_INT, kPrimInt, HOr);
+    BINOP_XX(OR_LONG, kPrimLong, HOr);
+    BINOP_XX(XOR_INT, kPrimInt, HXor);
+    BINOP_XX(XOR_LONG, kPrimLong, HXor);
+    BINOP_XX(SHL_INT, kPrimInt, HShl);
+    BINOP_XX(SHR_INT, kPrimInt, HShr);
+    BINOP_XX(USHR_INT, kPrimInt, HUShr);
+
+#define LONG_SHIFT_XX(opcode, shift)                                              \
+    case Instruction::opcode: {                                                   \
+      LongShift_23x<shift>(instruction);                                          \
+      break;                                                                      \
+    }                                                                             \
+    case Instruction::opcode##_2ADDR: {                                           \
+      LongShift_12x<shift>(instruction);                                          \
+      break;                                                                      \
+    }
+
+    LONG_SHIFT_XX(SHL_LONG, HShl);
+    LONG_SHIFT_XX(SHR_LONG, HShr);
+    LONG_SHIFT_XX(USHR_LONG, HUShr);
+
+#define DIV_REM_XX(opcode, type, op)                                              \
+    case Instruction::opcode: {                                                   \
+      HInstruction* first = LoadLocal(instruction.VRegB(), Primitive::type);      \
+      HInstruction* second = LoadLocal(instruction.VRegC(), Primitive::type);     \
+      BuildCheckedDivRem<op>(instruction.VRegA(), first, second, Primitive::type, \
+                             dex_offset);                                         \
+      break;                                                                      \
+    }                                                                             \
+    case Instruction::opcode##_2ADDR: {                                           \
+      HInstruction* first = LoadLocal(instruction.VRegA(), Primitive::type);      \
+      HInstruction* second = LoadLocal(instruction.VRegB(), Primitive::type);     \
+      BuildCheckedDivRem<op>(instruction.VRegA(), first, second, Primitive::type, \
+                             dex_offset);                                         \
+      break;                                                                      \
+    }
+
+    DIV_REM_XX(DIV_INT, kPrimInt, HDiv);
+    DIV_REM_XX(DIV_LONG, kPrimLong, HDiv);
+    DIV_REM_XX(REM_INT, kPrimInt, HRem);
+    DIV_REM_XX(REM_LONG, kPrimLong, HRem);
+
+#define BINOP_LIT_XX(opcode, binop)                                               \
+    case Instruction::opcode##_LIT16: {                                           \
+      Binop_22s<binop>(instruction, false);                                       \
+      break;                                                                      \
+    }                                                                             \
+    case Instruction::opcode##_LIT8: {                                            \
+      Binop_22b<binop>(instruction, false);                                       \
+      break;                                                                      \
+    }
+
+    BINOP_LIT_XX(MUL_INT, HMul);
+    BINOP_LIT_XX(AND_INT, HAnd);
+    BINOP_LIT_XX(OR_INT, HOr);
+    BINOP_LIT_XX(XOR_INT, HXor);
+
+#define DIV_REM_LIT_XX(opcode, op)                                                \
+    case Instruction::opcode##_LIT16: {                                           \
+      HInstruction* first = LoadLocal(instruction.VRegB(), Primitive::kPrimInt);  \
+      BuildCheckedDivRem<op>(instruction.VRegA(), first,                          \
+                             GetIntConstant(instruction.VRegC_22s()),             \
+                             Primitive::kPrimInt, dex_offset);                    \
+      break;                                                                      \
+    }                                                                             \
+    case Instruction::opcode##_LIT8: {                                            \
+      HInstruction* first = LoadLocal(instruction.VRegB(), Primitive::kPrimInt);  \
+      BuildCheckedDivRem<op>(instruction.VRegA(), first,                          \
+                             GetIntConstant(instruction.VRegC_22b()),             \
+                             Primitive::kPrimInt, dex_offset);                    \
+      break;                                                                      \
+    }
+
+    DIV_REM_LIT_XX(DIV_INT, HDiv);
+    DIV_REM_LIT_XX(REM_INT, HRem);
+
+    case Instruction::SHL_INT_LIT8: {
+      Binop_22b<HShl>(instruction, false);
+      break;
+    }
+
+    case Instruction::SHR_INT_LIT8: {
+      Binop_22b<HShr>(instruction, false);
+      break;
+    }
+
+    case Instruction::USHR_INT_LIT8: {
+      Binop_22b<HUShr>(instruction, false);
+      break;
+    }
+
+    case Instruction::NEG_INT: {
+      Unop_12x<HNeg>(instruction, Primitive::kPrimInt);
+      break;
+    }
+
+    case Instruction::NEG_LONG: {
+      Unop_12x<HNeg>(instruction, Primitive::kPrimLong);
+      break;
+    }
+
+    case Instruction::NOT_INT: {
+      Not_12x(instruction, Primitive::kPrimInt);
+      break;
+    }
+
+    case Instruction::NOT_LONG: {
+      Not_12x(instruction, Primitive::kPrimLong);
+      break;
+    }
+
+    case Instruction::INT_TO_LONG: {
+      Conversion_12x(instruction, Primitive::kPrimInt, Primitive::kPrimLong);
+      break;
+    }
+
+    case Instruction::LONG_TO_INT: {
+      Conversion_12x(instruction, Primitive::kPrimLong, Primitive::kPrimInt);
+      break;
+    }
+
+    case Instruction::INT_TO_BYTE: {
+      Conversion_12x(instruction, Primitive::kPrimInt, Primitive::kPrimByte);
+      break;
+    }
+
+    case Instruction::INT_TO_SHORT: {
+      Conversion_12x(instruction, Primitive::kPrimInt, Primitive::kPrimShort);
+      break;
+    }
+
+    case Instruction::INT_TO_CHAR: {
+      Conversion_12x(instruction, Primitive::kPrimInt, Primitive::kPrimChar);
+      break;
+    }
+
+    case Instruction::PACKED_SWITCH:
+    case Instruction::SPARSE_SWITCH: {
+      BuildSwitch(instruction, dex_offset);
+      break;
+    }
+
     case Instruction::NEW_INSTANCE: {
       current_block_->AddInstruction(
           new (arena_) HNewInstance(dex_offset, instruction.VRegB_21c()));
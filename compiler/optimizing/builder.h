@@ -87,6 +87,32 @@ class HGraphBuilder : public ValueObject {
   template<typename T>
   void Binop_22s(const Instruction& instruction, bool reverse);
 
+  // Builds a long shift, whose distance is an int.
+  template<typename T>
+  void LongShift_23x(const Instruction& instruction);
+
+  template<typename T>
+  void LongShift_12x(const Instruction& instruction);
+
+  // Builds `vA = first op second` for an HDiv or HRem. The divisor is checked against
+  // zero first, unless it is a non-zero constant.
+  template<typename T>
+  void BuildCheckedDivRem(uint16_t out_reg,
+                          HInstruction* first,
+                          HInstruction* second,
+                          Primitive::Type type,
+                          uint32_t dex_offset);
+
+  template<typename T>
+  void Unop_12x(const Instruction& instruction, Primitive::Type type);
+
+  void Conversion_12x(const Instruction& instruction,
+                      Primitive::Type input_type,
+                      Primitive::Type result_type);
+
+  // Builds `vA = ~vB` as an exclusive or with all bits set.
+  void Not_12x(const Instruction& instruction, Primitive::Type type);
+
   template<typename T> void If_21t(const Instruction& instruction, uint32_t dex_offset);
   template<typename T> void If_22t(const Instruction& instruction, uint32_t dex_offset);
 
@@ -98,6 +124,9 @@ class HGraphBuilder : public ValueObject {
                         bool is_get,
                         Primitive::Type anticipated_type);
 
+  // Builds a chain of equality tests for a packed-switch or sparse-switch.
+  void BuildSwitch(const Instruction& instruction, uint32_t dex_offset);
+
   // Builds an invocation node and returns whether the instruction is supported.
   bool BuildInvoke(const Instruction& instruction,
                    uint32_t dex_offset,
@@ -235,7 +235,8 @@ void CodeGenerator::InitLocations(HInstruction* instruction) {
   AllocateRegistersLocally(instruction);
   for (size_t i = 0, e = instruction->InputCount(); i < e; ++i) {
     Location location = instruction->GetLocations()->InAt(i);
-    if (location.IsValid()) {
+    // Constant locations are encoded directly in the instruction.
+    if (location.IsValid() && !location.IsConstant()) {
       // Move the input to the desired location.
       Move(instruction->InputAt(i), location, instruction);
     }
@@ -20,6 +20,7 @@
 #include "gc/accounting/card_table.h"
 #include "mirror/array.h"
 #include "mirror/art_method.h"
+#include "mirror/class.h"
 #include "thread.h"
 #include "utils/assembler.h"
 #include "utils/arm/assembler_arm.h"
@@ -117,6 +118,23 @@ class BoundsCheckSlowPathARM : public SlowPathCode {
   DISALLOW_COPY_AND_ASSIGN(BoundsCheckSlowPathARM);
 };
 
+class DivZeroCheckSlowPathARM : public SlowPathCode {
+ public:
+  explicit DivZeroCheckSlowPathARM(uint32_t dex_pc) : dex_pc_(dex_pc) {}
+
+  virtual void EmitNativeCode(CodeGenerator* codegen) OVERRIDE {
+    __ Bind(GetEntryLabel());
+    int32_t offset = QUICK_ENTRYPOINT_OFFSET(kArmWordSize, pThrowDivZero).Int32Value();
+    __ ldr(LR, Address(TR, offset));
+    __ blx(LR);
+    codegen->RecordPcInfo(dex_pc_);
+  }
+
+ private:
+  const uint32_t dex_pc_;
+  DISALLOW_COPY_AND_ASSIGN(DivZeroCheckSlowPathARM);
+};
+
 #undef __
 #define __ reinterpret_cast<ArmAssembler*>(GetAssembler())->
 
@@ -794,6 +812,14 @@ void InstructionCodeGeneratorARM::VisitReturn(HReturn* ret) {
 }
 
 void LocationsBuilderARM::VisitInvokeStatic(HInvokeStatic* invoke) {
+  HandleInvoke(invoke);
+}
+
+void LocationsBuilderARM::VisitInvokeVirtual(HInvokeVirtual* invoke) {
+  HandleInvoke(invoke);
+}
+
+void LocationsBuilderARM::HandleInvoke(HInvoke* invoke) {
   codegen_->MarkNotLeaf();
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(invoke);
   locations->AddTemp(ArmCoreLocation(R0));
@@ -863,6 +889,32 @@ void InstructionCodeGeneratorARM::VisitInvokeStatic(HInvokeStatic* invoke) {
   DCHECK(!codegen_->IsLeafMethod());
 }
 
+void InstructionCodeGeneratorARM::VisitInvokeVirtual(HInvokeVirtual* invoke) {
+  Register temp = invoke->GetLocations()->GetTemp(0).AsArm().AsCoreRegister();
+  uint32_t method_offset = mirror::Class::EmbeddedVTableOffset().Uint32Value() +
+      invoke->GetVTableIndex() * sizeof(mirror::Class::VTableEntry);
+  LocationSummary* locations = invoke->GetLocations();
+  Location receiver = locations->InAt(0);
+  uint32_t class_offset = mirror::Object::ClassOffset().Int32Value();
+  // temp = object->GetClass();
+  if (receiver.IsStackSlot()) {
+    __ ldr(temp, Address(SP, receiver.GetStackIndex()));
+    __ ldr(temp, Address(temp, class_offset));
+  } else {
+    __ ldr(temp, Address(receiver.AsArm().AsCoreRegister(), class_offset));
+  }
+  // temp = temp->GetMethodAt(method_offset);
+  __ ldr(temp, Address(temp, method_offset));
+  // LR = temp->GetEntryPoint();
+  __ ldr(LR, Address(temp,
+                     mirror::ArtMethod::EntryPointFromQuickCompiledCodeOffset().Int32Value()));
+  // LR();
+  __ blx(LR);
+
+  codegen_->RecordPcInfo(invoke->GetDexPc());
+  DCHECK(!codegen_->IsLeafMethod());
+}
+
 void LocationsBuilderARM::VisitAdd(HAdd* add) {
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(add);
   switch (add->GetResultType()) {
@@ -984,6 +1036,395 @@ void InstructionCodeGeneratorARM::VisitSub(HSub* sub) {
   }
 }
 
+void LocationsBuilderARM::VisitMul(HMul* mul) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(mul);
+  switch (mul->GetResultType()) {
+    case Primitive::kPrimInt:
+    case Primitive::kPrimLong: {
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::RequiresRegister());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+    }
+
+    case Primitive::kPrimBoolean:
+    case Primitive::kPrimByte:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      LOG(FATAL) << "Unexpected mul type " << mul->GetResultType();
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented mul type " << mul->GetResultType();
+  }
+  mul->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorARM::VisitMul(HMul* mul) {
+  LocationSummary* locations = mul->GetLocations();
+  switch (mul->GetResultType()) {
+    case Primitive::kPrimInt:
+      __ mul(locations->Out().AsArm().AsCoreRegister(),
+             locations->InAt(0).AsArm().AsCoreRegister(),
+             locations->InAt(1).AsArm().AsCoreRegister());
+      break;
+
+    case Primitive::kPrimLong: {
+      Register out_lo = locations->Out().AsArm().AsRegisterPairLow();
+      Register out_hi = locations->Out().AsArm().AsRegisterPairHigh();
+      Register in1_lo = locations->InAt(0).AsArm().AsRegisterPairLow();
+      Register in1_hi = locations->InAt(0).AsArm().AsRegisterPairHigh();
+      Register in2_lo = locations->InAt(1).AsArm().AsRegisterPairLow();
+      Register in2_hi = locations->InAt(1).AsArm().AsRegisterPairHigh();
+      // The output does not overlap the inputs, which are still read after out.hi is written.
+      // out.hi = in1.lo * in2.hi + in1.hi * in2.lo + high32(in1.lo * in2.lo)
+      // out.lo = low32(in1.lo * in2.lo)
+      __ mul(IP, in1_lo, in2_hi);
+      __ mla(out_hi, in1_hi, in2_lo, IP);
+      __ umull(out_lo, IP, in1_lo, in2_lo);
+      __ add(out_hi, out_hi, ShifterOperand(IP));
+      break;
+    }
+
+    case Primitive::kPrimBoolean:
+    case Primitive::kPrimByte:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      LOG(FATAL) << "Unexpected mul type " << mul->GetResultType();
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented mul type " << mul->GetResultType();
+  }
+}
+
+void LocationsBuilderARM::HandleDivRem(HBinaryOperation* instruction) {
+  // Not all ARM cores have `sdiv`, the division is done by the runtime.
+  codegen_->MarkNotLeaf();
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt: {
+      // __aeabi_idivmod returns the quotient in R0 and the remainder in R1.
+      locations->SetInAt(0, ArmCoreLocation(R0));
+      locations->SetInAt(1, ArmCoreLocation(R1));
+      locations->SetOut(ArmCoreLocation(instruction->IsDiv() ? R0 : R1));
+      break;
+    }
+
+    case Primitive::kPrimLong: {
+      // __aeabi_ldivmod returns the quotient in R0_R1 and the remainder in R2_R3.
+      locations->SetInAt(
+          0, Location::RegisterLocation(ArmManagedRegister::FromRegisterPair(R0_R1)));
+      locations->SetInAt(
+          1, Location::RegisterLocation(ArmManagedRegister::FromRegisterPair(R2_R3)));
+      locations->SetOut(Location::RegisterLocation(
+          ArmManagedRegister::FromRegisterPair(instruction->IsDiv() ? R0_R1 : R2_R3)));
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unimplemented " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+  instruction->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorARM::HandleDivRem(HBinaryOperation* instruction) {
+  bool is_div = instruction->IsDiv();
+  int32_t offset;
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt:
+      offset = QUICK_ENTRYPOINT_OFFSET(kArmWordSize, pIdivmod).Int32Value();
+      break;
+
+    case Primitive::kPrimLong:
+      offset = is_div
+          ? QUICK_ENTRYPOINT_OFFSET(kArmWordSize, pLdiv).Int32Value()
+          : QUICK_ENTRYPOINT_OFFSET(kArmWordSize, pLmod).Int32Value();
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+      return;
+  }
+  __ ldr(LR, Address(TR, offset));
+  __ blx(LR);
+  codegen_->RecordPcInfo(is_div ? instruction->AsDiv()->GetDexPc()
+                                : instruction->AsRem()->GetDexPc());
+  DCHECK(!codegen_->IsLeafMethod());
+}
+
+void LocationsBuilderARM::VisitDiv(HDiv* instruction) {
+  HandleDivRem(instruction);
+}
+
+void InstructionCodeGeneratorARM::VisitDiv(HDiv* instruction) {
+  HandleDivRem(instruction);
+}
+
+void LocationsBuilderARM::VisitRem(HRem* instruction) {
+  HandleDivRem(instruction);
+}
+
+void InstructionCodeGeneratorARM::VisitRem(HRem* instruction) {
+  HandleDivRem(instruction);
+}
+
+void LocationsBuilderARM::VisitDivZeroCheck(HDivZeroCheck* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  locations->SetInAt(0, Location::Any());
+  locations->SetOut(Location::SameAsFirstInput());
+  instruction->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorARM::VisitDivZeroCheck(HDivZeroCheck* instruction) {
+  SlowPathCode* slow_path =
+      new (GetGraph()->GetArena()) DivZeroCheckSlowPathARM(instruction->GetDexPc());
+  codegen_->AddSlowPath(slow_path);
+
+  LocationSummary* locations = instruction->GetLocations();
+  Location value = locations->InAt(0);
+  DCHECK(value.Equals(locations->Out()));
+
+  if (instruction->GetType() == Primitive::kPrimInt) {
+    if (value.IsRegister()) {
+      __ cmp(value.AsArm().AsCoreRegister(), ShifterOperand(0));
+    } else {
+      DCHECK(value.IsStackSlot());
+      __ ldr(IP, Address(SP, value.GetStackIndex()));
+      __ cmp(IP, ShifterOperand(0));
+    }
+    __ b(slow_path->GetEntryLabel(), EQ);
+  } else {
+    DCHECK_EQ(instruction->GetType(), Primitive::kPrimLong);
+    if (value.IsRegister()) {
+      __ orrs(IP, value.AsArm().AsRegisterPairLow(),
+              ShifterOperand(value.AsArm().AsRegisterPairHigh()));
+      __ b(slow_path->GetEntryLabel(), EQ);
+    } else {
+      DCHECK(value.IsDoubleStackSlot());
+      // The value is zero if both of its halves are.
+      Label not_zero;
+      __ ldr(IP, Address(SP, value.GetStackIndex()));
+      __ cmp(IP, ShifterOperand(0));
+      __ b(&not_zero, NE);
+      __ ldr(IP, Address(SP, value.GetHighStackIndex(kArmWordSize)));
+      __ cmp(IP, ShifterOperand(0));
+      __ b(slow_path->GetEntryLabel(), EQ);
+      __ Bind(&not_zero);
+    }
+  }
+}
+
+void LocationsBuilderARM::HandleBitwiseOperation(HBinaryOperation* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt:
+    case Primitive::kPrimLong: {
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::RequiresRegister());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unexpected " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+  instruction->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorARM::HandleBitwiseOperation(HBinaryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt: {
+      Register out = locations->Out().AsArm().AsCoreRegister();
+      Register first = locations->InAt(0).AsArm().AsCoreRegister();
+      ShifterOperand second(locations->InAt(1).AsArm().AsCoreRegister());
+      if (instruction->IsAnd()) {
+        __ and_(out, first, second);
+      } else if (instruction->IsOr()) {
+        __ orr(out, first, second);
+      } else {
+        DCHECK(instruction->IsXor());
+        __ eor(out, first, second);
+      }
+      break;
+    }
+
+    case Primitive::kPrimLong: {
+      ArmManagedRegister out = locations->Out().AsArm();
+      ArmManagedRegister first = locations->InAt(0).AsArm();
+      ArmManagedRegister second = locations->InAt(1).AsArm();
+      if (instruction->IsAnd()) {
+        __ and_(out.AsRegisterPairLow(), first.AsRegisterPairLow(),
+                ShifterOperand(second.AsRegisterPairLow()));
+        __ and_(out.AsRegisterPairHigh(), first.AsRegisterPairHigh(),
+                ShifterOperand(second.AsRegisterPairHigh()));
+      } else if (instruction->IsOr()) {
+        __ orr(out.AsRegisterPairLow(), first.AsRegisterPairLow(),
+               ShifterOperand(second.AsRegisterPairLow()));
+        __ orr(out.AsRegisterPairHigh(), first.AsRegisterPairHigh(),
+               ShifterOperand(second.AsRegisterPairHigh()));
+      } else {
+        DCHECK(instruction->IsXor());
+        __ eor(out.AsRegisterPairLow(), first.AsRegisterPairLow(),
+               ShifterOperand(second.AsRegisterPairLow()));
+        __ eor(out.AsRegisterPairHigh(), first.AsRegisterPairHigh(),
+               ShifterOperand(second.AsRegisterPairHigh()));
+      }
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unexpected " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+}
+
+void LocationsBuilderARM::VisitAnd(HAnd* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void InstructionCodeGeneratorARM::VisitAnd(HAnd* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void LocationsBuilderARM::VisitOr(HOr* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void InstructionCodeGeneratorARM::VisitOr(HOr* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void LocationsBuilderARM::VisitXor(HXor* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void InstructionCodeGeneratorARM::VisitXor(HXor* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void LocationsBuilderARM::HandleShift(HBinaryOperation* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt: {
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::RegisterOrConstant(instruction->InputAt(1)));
+      locations->SetOut(Location::RequiresRegister());
+      break;
+    }
+
+    case Primitive::kPrimLong: {
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::RequiresRegister());
+      // The output does not overlap the inputs, which are still read after it is written.
+      locations->SetOut(Location::RequiresRegister());
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unimplemented " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+  instruction->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorARM::HandleShift(HBinaryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  if (instruction->GetResultType() == Primitive::kPrimLong) {
+    Register out_lo = locations->Out().AsArm().AsRegisterPairLow();
+    Register out_hi = locations->Out().AsArm().AsRegisterPairHigh();
+    Register in_lo = locations->InAt(0).AsArm().AsRegisterPairLow();
+    Register in_hi = locations->InAt(0).AsArm().AsRegisterPairHigh();
+    // Register shifts by 32 or more give 0 (or the sign for ASR), which takes care of the
+    // half that is shifted out. The other half is fixed up when the distance is at least 32.
+    __ and_(IP, locations->InAt(1).AsArm().AsCoreRegister(), ShifterOperand(kMaxLongShiftValue));
+    if (instruction->IsShl()) {
+      __ Lsl(out_hi, in_hi, IP);
+      __ rsb(out_lo, IP, ShifterOperand(32));
+      __ Lsr(out_lo, in_lo, out_lo);
+      __ orr(out_hi, out_hi, ShifterOperand(out_lo));
+      __ subs(out_lo, IP, ShifterOperand(32));
+      __ it(PL);
+      __ Lsl(out_hi, in_lo, out_lo, false, PL);
+      __ Lsl(out_lo, in_lo, IP);
+    } else {
+      __ Lsr(out_lo, in_lo, IP);
+      __ rsb(out_hi, IP, ShifterOperand(32));
+      __ Lsl(out_hi, in_hi, out_hi);
+      __ orr(out_lo, out_lo, ShifterOperand(out_hi));
+      __ subs(out_hi, IP, ShifterOperand(32));
+      __ it(PL);
+      if (instruction->IsShr()) {
+        __ Asr(out_lo, in_hi, out_hi, false, PL);
+        __ Asr(out_hi, in_hi, IP);
+      } else {
+        DCHECK(instruction->IsUShr());
+        __ Lsr(out_lo, in_hi, out_hi, false, PL);
+        __ Lsr(out_hi, in_hi, IP);
+      }
+    }
+    return;
+  }
+
+  Register out = locations->Out().AsArm().AsCoreRegister();
+  Register first = locations->InAt(0).AsArm().AsCoreRegister();
+  DCHECK_EQ(instruction->GetResultType(), Primitive::kPrimInt);
+  Location distance = locations->InAt(1);
+  if (distance.IsConstant()) {
+    uint32_t shift = distance.GetConstant()->AsIntConstant()->GetValue() & kMaxIntShiftValue;
+    if (shift == 0) {
+      // An immediate shift of zero encodes a shift by 32 for LSR and ASR.
+      __ mov(out, ShifterOperand(first));
+    } else if (instruction->IsShl()) {
+      __ Lsl(out, first, shift);
+    } else if (instruction->IsShr()) {
+      __ Asr(out, first, shift);
+    } else {
+      DCHECK(instruction->IsUShr());
+      __ Lsr(out, first, shift);
+    }
+  } else {
+    // Register shifts use the low byte of the distance, the dex semantics only use five bits.
+    __ and_(IP, distance.AsArm().AsCoreRegister(), ShifterOperand(kMaxIntShiftValue));
+    if (instruction->IsShl()) {
+      __ Lsl(out, first, IP);
+    } else if (instruction->IsShr()) {
+      __ Asr(out, first, IP);
+    } else {
+      DCHECK(instruction->IsUShr());
+      __ Lsr(out, first, IP);
+    }
+  }
+}
+
+void LocationsBuilderARM::VisitShl(HShl* instruction) {
+  HandleShift(instruction);
+}
+
+void InstructionCodeGeneratorARM::VisitShl(HShl* instruction) {
+  HandleShift(instruction);
+}
+
+void LocationsBuilderARM::VisitShr(HShr* instruction) {
+  HandleShift(instruction);
+}
+
+void InstructionCodeGeneratorARM::VisitShr(HShr* instruction) {
+  HandleShift(instruction);
+}
+
+void LocationsBuilderARM::VisitUShr(HUShr* instruction) {
+  HandleShift(instruction);
+}
+
+void InstructionCodeGeneratorARM::VisitUShr(HUShr* instruction) {
+  HandleShift(instruction);
+}
+
 void LocationsBuilderARM::VisitNewInstance(HNewInstance* instruction) {
   codegen_->MarkNotLeaf();
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
@@ -1036,6 +1477,103 @@ void InstructionCodeGeneratorARM::VisitNot(HNot* instruction) {
          locations->InAt(0).AsArm().AsCoreRegister(), ShifterOperand(1));
 }
 
+void LocationsBuilderARM::VisitNeg(HNeg* neg) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(neg);
+  switch (neg->GetType()) {
+    case Primitive::kPrimInt:
+    case Primitive::kPrimLong:
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented neg type " << neg->GetType();
+  }
+  neg->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorARM::VisitNeg(HNeg* neg) {
+  LocationSummary* locations = neg->GetLocations();
+  switch (neg->GetType()) {
+    case Primitive::kPrimInt:
+      __ rsb(locations->Out().AsArm().AsCoreRegister(),
+             locations->InAt(0).AsArm().AsCoreRegister(), ShifterOperand(0));
+      break;
+
+    case Primitive::kPrimLong: {
+      ArmManagedRegister out = locations->Out().AsArm();
+      ArmManagedRegister in = locations->InAt(0).AsArm();
+      // Do LoadImmediate before `rsbs`, as LoadImmediate might affect the status flags.
+      __ LoadImmediate(out.AsRegisterPairHigh(), 0);
+      // out.lo = 0 - in.lo, setting the carry when there is no borrow.
+      __ rsbs(out.AsRegisterPairLow(), in.AsRegisterPairLow(), ShifterOperand(0));
+      // out.hi = 0 - in.hi - borrow
+      __ sbc(out.AsRegisterPairHigh(), out.AsRegisterPairHigh(),
+             ShifterOperand(in.AsRegisterPairHigh()));
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unimplemented neg type " << neg->GetType();
+  }
+}
+
+void LocationsBuilderARM::VisitTypeConversion(HTypeConversion* conversion) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(conversion);
+  switch (conversion->GetResultType()) {
+    case Primitive::kPrimByte:
+    case Primitive::kPrimShort:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimInt:
+    case Primitive::kPrimLong:
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented conversion from " << conversion->GetInputType()
+                 << " to " << conversion->GetResultType();
+  }
+  conversion->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorARM::VisitTypeConversion(HTypeConversion* conversion) {
+  LocationSummary* locations = conversion->GetLocations();
+  Location in = locations->InAt(0);
+  Location out = locations->Out();
+  switch (conversion->GetResultType()) {
+    case Primitive::kPrimByte:
+      __ Lsl(out.AsArm().AsCoreRegister(), in.AsArm().AsCoreRegister(), 24);
+      __ Asr(out.AsArm().AsCoreRegister(), out.AsArm().AsCoreRegister(), 24);
+      break;
+
+    case Primitive::kPrimShort:
+      __ Lsl(out.AsArm().AsCoreRegister(), in.AsArm().AsCoreRegister(), 16);
+      __ Asr(out.AsArm().AsCoreRegister(), out.AsArm().AsCoreRegister(), 16);
+      break;
+
+    case Primitive::kPrimChar:
+      __ Lsl(out.AsArm().AsCoreRegister(), in.AsArm().AsCoreRegister(), 16);
+      __ Lsr(out.AsArm().AsCoreRegister(), out.AsArm().AsCoreRegister(), 16);
+      break;
+
+    case Primitive::kPrimLong:
+      DCHECK_EQ(conversion->GetInputType(), Primitive::kPrimInt);
+      __ mov(out.AsArm().AsRegisterPairLow(), ShifterOperand(in.AsArm().AsCoreRegister()));
+      __ Asr(out.AsArm().AsRegisterPairHigh(), out.AsArm().AsRegisterPairLow(), 31);
+      break;
+
+    case Primitive::kPrimInt:
+      DCHECK_EQ(conversion->GetInputType(), Primitive::kPrimLong);
+      __ mov(out.AsArm().AsCoreRegister(), ShifterOperand(in.AsArm().AsRegisterPairLow()));
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented conversion from " << conversion->GetInputType()
+                 << " to " << conversion->GetResultType();
+  }
+}
+
 void LocationsBuilderARM::VisitCompare(HCompare* compare) {
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(compare);
   locations->SetInAt(0, Location::RequiresRegister());
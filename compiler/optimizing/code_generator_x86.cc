@@ -24,6 +24,7 @@
 #include "entrypoints/quick/quick_entrypoints.h"
 #include "mirror/array.h"
 #include "mirror/art_method.h"
+#include "mirror/class.h"
 #include "thread.h"
 
 namespace art {
@@ -114,6 +115,21 @@ class BoundsCheckSlowPathX86 : public SlowPathCode {
   DISALLOW_COPY_AND_ASSIGN(BoundsCheckSlowPathX86);
 };
 
+class DivZeroCheckSlowPathX86 : public SlowPathCode {
+ public:
+  explicit DivZeroCheckSlowPathX86(uint32_t dex_pc) : dex_pc_(dex_pc) {}
+
+  virtual void EmitNativeCode(CodeGenerator* codegen) OVERRIDE {
+    __ Bind(GetEntryLabel());
+    __ fs()->call(Address::Absolute(QUICK_ENTRYPOINT_OFFSET(kX86WordSize, pThrowDivZero)));
+    codegen->RecordPcInfo(dex_pc_);
+  }
+
+ private:
+  const uint32_t dex_pc_;
+  DISALLOW_COPY_AND_ASSIGN(DivZeroCheckSlowPathX86);
+};
+
 #undef __
 #define __ reinterpret_cast<X86Assembler*>(GetAssembler())->
 
@@ -740,6 +756,14 @@ void InstructionCodeGeneratorX86::VisitReturn(HReturn* ret) {
 }
 
 void LocationsBuilderX86::VisitInvokeStatic(HInvokeStatic* invoke) {
+  HandleInvoke(invoke);
+}
+
+void LocationsBuilderX86::VisitInvokeVirtual(HInvokeVirtual* invoke) {
+  HandleInvoke(invoke);
+}
+
+void LocationsBuilderX86::HandleInvoke(HInvoke* invoke) {
   codegen_->MarkNotLeaf();
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(invoke);
   locations->AddTemp(X86CpuLocation(EAX));
@@ -802,6 +826,29 @@ void InstructionCodeGeneratorX86::VisitInvokeStatic(HInvokeStatic* invoke) {
   codegen_->RecordPcInfo(invoke->GetDexPc());
 }
 
+void InstructionCodeGeneratorX86::VisitInvokeVirtual(HInvokeVirtual* invoke) {
+  Register temp = invoke->GetLocations()->GetTemp(0).AsX86().AsCpuRegister();
+  uint32_t method_offset = mirror::Class::EmbeddedVTableOffset().Uint32Value() +
+      invoke->GetVTableIndex() * sizeof(mirror::Class::VTableEntry);
+  LocationSummary* locations = invoke->GetLocations();
+  Location receiver = locations->InAt(0);
+  uint32_t class_offset = mirror::Object::ClassOffset().Int32Value();
+  // temp = object->GetClass();
+  if (receiver.IsStackSlot()) {
+    __ movl(temp, Address(ESP, receiver.GetStackIndex()));
+    __ movl(temp, Address(temp, class_offset));
+  } else {
+    __ movl(temp, Address(receiver.AsX86().AsCpuRegister(), class_offset));
+  }
+  // temp = temp->GetMethodAt(method_offset);
+  __ movl(temp, Address(temp, method_offset));
+  // call temp->GetEntryPoint();
+  __ call(Address(temp, mirror::ArtMethod::EntryPointFromQuickCompiledCodeOffset().Int32Value()));
+
+  DCHECK(!codegen_->IsLeafMethod());
+  codegen_->RecordPcInfo(invoke->GetDexPc());
+}
+
 void LocationsBuilderX86::VisitAdd(HAdd* add) {
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(add);
   switch (add->GetResultType()) {
@@ -948,6 +995,480 @@ void InstructionCodeGeneratorX86::VisitSub(HSub* sub) {
   }
 }
 
+void LocationsBuilderX86::VisitMul(HMul* mul) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(mul);
+  switch (mul->GetResultType()) {
+    case Primitive::kPrimInt: {
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::Any());
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    }
+
+    case Primitive::kPrimLong: {
+      // The low halves are multiplied with `mull`, which writes EDX:EAX. The first
+      // input is fixed to the only allocatable pair that overlaps neither of them.
+      locations->SetInAt(
+          0, Location::RegisterLocation(X86ManagedRegister::FromRegisterPair(ECX_EBX)));
+      locations->SetInAt(1, Location::Any());
+      locations->SetOut(Location::SameAsFirstInput());
+      locations->AddTemp(X86CpuLocation(EAX));
+      locations->AddTemp(X86CpuLocation(EDX));
+      break;
+    }
+
+    case Primitive::kPrimBoolean:
+    case Primitive::kPrimByte:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      LOG(FATAL) << "Unexpected mul type " << mul->GetResultType();
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented mul type " << mul->GetResultType();
+  }
+  mul->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86::VisitMul(HMul* mul) {
+  LocationSummary* locations = mul->GetLocations();
+  Location first = locations->InAt(0);
+  Location second = locations->InAt(1);
+  switch (mul->GetResultType()) {
+    case Primitive::kPrimInt: {
+      DCHECK_EQ(first.AsX86().AsCpuRegister(), locations->Out().AsX86().AsCpuRegister());
+      if (second.IsRegister()) {
+        __ imull(first.AsX86().AsCpuRegister(), second.AsX86().AsCpuRegister());
+      } else if (second.IsConstant()) {
+        Immediate imm(second.GetConstant()->AsIntConstant()->GetValue());
+        __ imull(first.AsX86().AsCpuRegister(), imm);
+      } else {
+        __ imull(first.AsX86().AsCpuRegister(), Address(ESP, second.GetStackIndex()));
+      }
+      break;
+    }
+
+    case Primitive::kPrimLong: {
+      DCHECK_EQ(first.AsX86().AsRegisterPair(), locations->Out().AsX86().AsRegisterPair());
+      DCHECK_EQ(EAX, locations->GetTemp(0).AsX86().AsCpuRegister());
+      DCHECK_EQ(EDX, locations->GetTemp(1).AsX86().AsCpuRegister());
+      Register in1_lo = first.AsX86().AsRegisterPairLow();
+      Register in1_hi = first.AsX86().AsRegisterPairHigh();
+      // out.hi = in1.hi * in2.lo + in1.lo * in2.hi + high32(in1.lo * in2.lo)
+      // out.lo = low32(in1.lo * in2.lo)
+      if (second.IsRegister()) {
+        Register in2_lo = second.AsX86().AsRegisterPairLow();
+        Register in2_hi = second.AsX86().AsRegisterPairHigh();
+        __ imull(in1_hi, in2_lo);
+        __ movl(EAX, in1_lo);
+        __ imull(EAX, in2_hi);
+        __ addl(in1_hi, EAX);
+        __ movl(EAX, in1_lo);
+        __ mull(in2_lo);
+      } else {
+        DCHECK(second.IsDoubleStackSlot());
+        Address in2_lo(ESP, second.GetStackIndex());
+        Address in2_hi(ESP, second.GetHighStackIndex(kX86WordSize));
+        __ imull(in1_hi, in2_lo);
+        __ movl(EAX, in1_lo);
+        __ imull(EAX, in2_hi);
+        __ addl(in1_hi, EAX);
+        __ movl(EAX, in1_lo);
+        __ mull(in2_lo);
+      }
+      __ addl(in1_hi, EDX);
+      __ movl(in1_lo, EAX);
+      break;
+    }
+
+    case Primitive::kPrimBoolean:
+    case Primitive::kPrimByte:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      LOG(FATAL) << "Unexpected mul type " << mul->GetResultType();
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented mul type " << mul->GetResultType();
+  }
+}
+
+void LocationsBuilderX86::HandleDivRem(HBinaryOperation* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt: {
+      // `idivl` divides EDX:EAX, and leaves the quotient in EAX and the remainder in EDX.
+      locations->SetInAt(0, X86CpuLocation(EAX));
+      locations->SetInAt(1, Location::RequiresRegister());
+      locations->AddTemp(X86CpuLocation(EDX));
+      locations->SetOut(X86CpuLocation(instruction->IsDiv() ? EAX : EDX));
+      break;
+    }
+
+    case Primitive::kPrimLong: {
+      codegen_->MarkNotLeaf();
+      // The registers art_quick_ldiv and art_quick_lmod take their arguments in.
+      locations->SetInAt(
+          0, Location::RegisterLocation(X86ManagedRegister::FromRegisterPair(EAX_ECX)));
+      locations->SetInAt(
+          1, Location::RegisterLocation(X86ManagedRegister::FromRegisterPair(EDX_EBX)));
+      locations->SetOut(Location::RegisterLocation(X86ManagedRegister::FromRegisterPair(EAX_EDX)));
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unimplemented " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+  instruction->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86::HandleDivRem(HBinaryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  bool is_div = instruction->IsDiv();
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt: {
+      DCHECK_EQ(EAX, locations->InAt(0).AsX86().AsCpuRegister());
+      Register second = locations->InAt(1).AsX86().AsCpuRegister();
+      // MIN_VALUE / -1 raises a divide error, so a divisor of -1 is handled without `idivl`.
+      Label not_minus_one, done;
+      __ cmpl(second, Immediate(-1));
+      __ j(kNotEqual, &not_minus_one);
+      if (is_div) {
+        __ negl(EAX);
+      } else {
+        __ xorl(EDX, EDX);
+      }
+      __ jmp(&done);
+      __ Bind(&not_minus_one);
+      __ cdq();
+      __ idivl(second);
+      __ Bind(&done);
+      break;
+    }
+
+    case Primitive::kPrimLong: {
+      if (is_div) {
+        __ fs()->call(Address::Absolute(QUICK_ENTRYPOINT_OFFSET(kX86WordSize, pLdiv)));
+      } else {
+        __ fs()->call(Address::Absolute(QUICK_ENTRYPOINT_OFFSET(kX86WordSize, pLmod)));
+      }
+      codegen_->RecordPcInfo(is_div ? instruction->AsDiv()->GetDexPc()
+                                    : instruction->AsRem()->GetDexPc());
+      DCHECK(!codegen_->IsLeafMethod());
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unimplemented " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+}
+
+void LocationsBuilderX86::VisitDiv(HDiv* instruction) {
+  HandleDivRem(instruction);
+}
+
+void InstructionCodeGeneratorX86::VisitDiv(HDiv* instruction) {
+  HandleDivRem(instruction);
+}
+
+void LocationsBuilderX86::VisitRem(HRem* instruction) {
+  HandleDivRem(instruction);
+}
+
+void InstructionCodeGeneratorX86::VisitRem(HRem* instruction) {
+  HandleDivRem(instruction);
+}
+
+void LocationsBuilderX86::VisitDivZeroCheck(HDivZeroCheck* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  locations->SetInAt(0, Location::Any());
+  locations->SetOut(Location::SameAsFirstInput());
+  instruction->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86::VisitDivZeroCheck(HDivZeroCheck* instruction) {
+  SlowPathCode* slow_path =
+      new (GetGraph()->GetArena()) DivZeroCheckSlowPathX86(instruction->GetDexPc());
+  codegen_->AddSlowPath(slow_path);
+
+  LocationSummary* locations = instruction->GetLocations();
+  Location value = locations->InAt(0);
+  DCHECK(value.Equals(locations->Out()));
+
+  if (instruction->GetType() == Primitive::kPrimInt) {
+    if (value.IsRegister()) {
+      __ testl(value.AsX86().AsCpuRegister(), value.AsX86().AsCpuRegister());
+    } else {
+      DCHECK(value.IsStackSlot());
+      __ cmpl(Address(ESP, value.GetStackIndex()), Immediate(0));
+    }
+    __ j(kEqual, slow_path->GetEntryLabel());
+  } else {
+    DCHECK_EQ(instruction->GetType(), Primitive::kPrimLong);
+    // The value is zero if both of its halves are.
+    Label not_zero;
+    if (value.IsRegister()) {
+      __ testl(value.AsX86().AsRegisterPairLow(), value.AsX86().AsRegisterPairLow());
+      __ j(kNotEqual, &not_zero);
+      __ testl(value.AsX86().AsRegisterPairHigh(), value.AsX86().AsRegisterPairHigh());
+    } else {
+      DCHECK(value.IsDoubleStackSlot());
+      __ cmpl(Address(ESP, value.GetStackIndex()), Immediate(0));
+      __ j(kNotEqual, &not_zero);
+      __ cmpl(Address(ESP, value.GetHighStackIndex(kX86WordSize)), Immediate(0));
+    }
+    __ j(kEqual, slow_path->GetEntryLabel());
+    __ Bind(&not_zero);
+  }
+}
+
+void LocationsBuilderX86::HandleBitwiseOperation(HBinaryOperation* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt:
+    case Primitive::kPrimLong: {
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::Any());
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unexpected " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+  instruction->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86::HandleBitwiseOperation(HBinaryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  Location first = locations->InAt(0);
+  Location second = locations->InAt(1);
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt: {
+      Register dst = first.AsX86().AsCpuRegister();
+      DCHECK_EQ(dst, locations->Out().AsX86().AsCpuRegister());
+      if (second.IsRegister()) {
+        Register src = second.AsX86().AsCpuRegister();
+        if (instruction->IsAnd()) {
+          __ andl(dst, src);
+        } else if (instruction->IsOr()) {
+          __ orl(dst, src);
+        } else {
+          DCHECK(instruction->IsXor());
+          __ xorl(dst, src);
+        }
+      } else if (second.IsConstant()) {
+        Immediate imm(second.GetConstant()->AsIntConstant()->GetValue());
+        if (instruction->IsAnd()) {
+          __ andl(dst, imm);
+        } else if (instruction->IsOr()) {
+          __ orl(dst, imm);
+        } else {
+          DCHECK(instruction->IsXor());
+          __ xorl(dst, imm);
+        }
+      } else {
+        Address src(ESP, second.GetStackIndex());
+        if (instruction->IsAnd()) {
+          __ andl(dst, src);
+        } else if (instruction->IsOr()) {
+          __ orl(dst, src);
+        } else {
+          DCHECK(instruction->IsXor());
+          __ xorl(dst, src);
+        }
+      }
+      break;
+    }
+
+    case Primitive::kPrimLong: {
+      DCHECK_EQ(first.AsX86().AsRegisterPair(), locations->Out().AsX86().AsRegisterPair());
+      Register dst_lo = first.AsX86().AsRegisterPairLow();
+      Register dst_hi = first.AsX86().AsRegisterPairHigh();
+      if (second.IsRegister()) {
+        Register src_lo = second.AsX86().AsRegisterPairLow();
+        Register src_hi = second.AsX86().AsRegisterPairHigh();
+        if (instruction->IsAnd()) {
+          __ andl(dst_lo, src_lo);
+          __ andl(dst_hi, src_hi);
+        } else if (instruction->IsOr()) {
+          __ orl(dst_lo, src_lo);
+          __ orl(dst_hi, src_hi);
+        } else {
+          DCHECK(instruction->IsXor());
+          __ xorl(dst_lo, src_lo);
+          __ xorl(dst_hi, src_hi);
+        }
+      } else {
+        Address src_lo(ESP, second.GetStackIndex());
+        Address src_hi(ESP, second.GetHighStackIndex(kX86WordSize));
+        if (instruction->IsAnd()) {
+          __ andl(dst_lo, src_lo);
+          __ andl(dst_hi, src_hi);
+        } else if (instruction->IsOr()) {
+          __ orl(dst_lo, src_lo);
+          __ orl(dst_hi, src_hi);
+        } else {
+          DCHECK(instruction->IsXor());
+          __ xorl(dst_lo, src_lo);
+          __ xorl(dst_hi, src_hi);
+        }
+      }
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unexpected " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+}
+
+void LocationsBuilderX86::VisitAnd(HAnd* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void InstructionCodeGeneratorX86::VisitAnd(HAnd* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void LocationsBuilderX86::VisitOr(HOr* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void InstructionCodeGeneratorX86::VisitOr(HOr* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void LocationsBuilderX86::VisitXor(HXor* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void InstructionCodeGeneratorX86::VisitXor(HXor* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void LocationsBuilderX86::HandleShift(HBinaryOperation* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt: {
+      locations->SetInAt(0, Location::RequiresRegister());
+      // A variable shift distance has to be in CL.
+      HInstruction* distance = instruction->InputAt(1);
+      locations->SetInAt(1, distance->IsConstant()
+          ? Location::ConstantLocation(distance->AsConstant())
+          : X86CpuLocation(ECX));
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    }
+
+    case Primitive::kPrimLong: {
+      // `shld` and `shrd` only take their distance in CL, constant or not.
+      locations->SetInAt(
+          0, Location::RegisterLocation(X86ManagedRegister::FromRegisterPair(EAX_EDX)));
+      locations->SetInAt(1, X86CpuLocation(ECX));
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unimplemented " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+  instruction->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86::HandleShift(HBinaryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  if (instruction->GetResultType() == Primitive::kPrimLong) {
+    DCHECK_EQ(ECX, locations->InAt(1).AsX86().AsCpuRegister());
+    Register low = locations->InAt(0).AsX86().AsRegisterPairLow();
+    Register high = locations->InAt(0).AsX86().AsRegisterPairHigh();
+    // The hardware masks the distance to five bits, a distance of 32 to 63 moves
+    // one half into the other.
+    Label done;
+    if (instruction->IsShl()) {
+      __ shld(high, low);
+      __ shll(low, ECX);
+      __ testl(ECX, Immediate(32));
+      __ j(kEqual, &done);
+      __ movl(high, low);
+      __ xorl(low, low);
+    } else if (instruction->IsShr()) {
+      __ shrd(low, high);
+      __ sarl(high, ECX);
+      __ testl(ECX, Immediate(32));
+      __ j(kEqual, &done);
+      __ movl(low, high);
+      __ sarl(high, Immediate(31));
+    } else {
+      DCHECK(instruction->IsUShr());
+      __ shrd(low, high);
+      __ shrl(high, ECX);
+      __ testl(ECX, Immediate(32));
+      __ j(kEqual, &done);
+      __ movl(low, high);
+      __ xorl(high, high);
+    }
+    __ Bind(&done);
+    return;
+  }
+
+  Register dst = locations->InAt(0).AsX86().AsCpuRegister();
+  DCHECK_EQ(dst, locations->Out().AsX86().AsCpuRegister());
+  DCHECK_EQ(instruction->GetResultType(), Primitive::kPrimInt);
+  Location distance = locations->InAt(1);
+  if (distance.IsConstant()) {
+    Immediate imm(distance.GetConstant()->AsIntConstant()->GetValue() & kMaxIntShiftValue);
+    if (instruction->IsShl()) {
+      __ shll(dst, imm);
+    } else if (instruction->IsShr()) {
+      __ sarl(dst, imm);
+    } else {
+      DCHECK(instruction->IsUShr());
+      __ shrl(dst, imm);
+    }
+  } else {
+    // The hardware masks the distance to five bits, as the dex semantics require.
+    Register shifter = distance.AsX86().AsCpuRegister();
+    DCHECK_EQ(shifter, ECX);
+    if (instruction->IsShl()) {
+      __ shll(dst, shifter);
+    } else if (instruction->IsShr()) {
+      __ sarl(dst, shifter);
+    } else {
+      DCHECK(instruction->IsUShr());
+      __ shrl(dst, shifter);
+    }
+  }
+}
+
+void LocationsBuilderX86::VisitShl(HShl* instruction) {
+  HandleShift(instruction);
+}
+
+void InstructionCodeGeneratorX86::VisitShl(HShl* instruction) {
+  HandleShift(instruction);
+}
+
+void LocationsBuilderX86::VisitShr(HShr* instruction) {
+  HandleShift(instruction);
+}
+
+void InstructionCodeGeneratorX86::VisitShr(HShr* instruction) {
+  HandleShift(instruction);
+}
+
+void LocationsBuilderX86::VisitUShr(HUShr* instruction) {
+  HandleShift(instruction);
+}
+
+void InstructionCodeGeneratorX86::VisitUShr(HUShr* instruction) {
+  HandleShift(instruction);
+}
+
 void LocationsBuilderX86::VisitNewInstance(HNewInstance* instruction) {
   codegen_->MarkNotLeaf();
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
@@ -999,6 +1520,113 @@ void InstructionCodeGeneratorX86::VisitNot(HNot* instruction) {
   __ xorl(out.AsX86().AsCpuRegister(), Immediate(1));
 }
 
+void LocationsBuilderX86::VisitNeg(HNeg* neg) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(neg);
+  switch (neg->GetType()) {
+    case Primitive::kPrimInt:
+    case Primitive::kPrimLong:
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented neg type " << neg->GetType();
+  }
+  neg->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86::VisitNeg(HNeg* neg) {
+  LocationSummary* locations = neg->GetLocations();
+  Location in = locations->InAt(0);
+  switch (neg->GetType()) {
+    case Primitive::kPrimInt:
+      DCHECK_EQ(in.AsX86().AsCpuRegister(), locations->Out().AsX86().AsCpuRegister());
+      __ negl(in.AsX86().AsCpuRegister());
+      break;
+
+    case Primitive::kPrimLong:
+      DCHECK_EQ(in.AsX86().AsRegisterPair(), locations->Out().AsX86().AsRegisterPair());
+      // -(hi:lo) is (~hi + (lo == 0)):(-lo), and negl sets the carry when lo is not zero.
+      __ negl(in.AsX86().AsRegisterPairLow());
+      __ adcl(in.AsX86().AsRegisterPairHigh(), Immediate(0));
+      __ negl(in.AsX86().AsRegisterPairHigh());
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented neg type " << neg->GetType();
+  }
+}
+
+void LocationsBuilderX86::VisitTypeConversion(HTypeConversion* conversion) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(conversion);
+  Primitive::Type input_type = conversion->GetInputType();
+  switch (conversion->GetResultType()) {
+    case Primitive::kPrimByte:
+    case Primitive::kPrimShort:
+    case Primitive::kPrimChar:
+      DCHECK_EQ(input_type, Primitive::kPrimInt);
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+
+    case Primitive::kPrimLong:
+      // Sign extension with `cdq`.
+      DCHECK_EQ(input_type, Primitive::kPrimInt);
+      locations->SetInAt(0, X86CpuLocation(EAX));
+      locations->SetOut(Location::RegisterLocation(X86ManagedRegister::FromRegisterPair(EAX_EDX)));
+      break;
+
+    case Primitive::kPrimInt:
+      DCHECK_EQ(input_type, Primitive::kPrimLong);
+      locations->SetInAt(0, Location::Any());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented conversion from " << input_type
+                 << " to " << conversion->GetResultType();
+  }
+  conversion->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86::VisitTypeConversion(HTypeConversion* conversion) {
+  LocationSummary* locations = conversion->GetLocations();
+  Location in = locations->InAt(0);
+  Location out = locations->Out();
+  switch (conversion->GetResultType()) {
+    case Primitive::kPrimByte:
+      __ movsxb(out.AsX86().AsCpuRegister(), in.AsX86().AsByteRegister());
+      break;
+
+    case Primitive::kPrimShort:
+      __ movsxw(out.AsX86().AsCpuRegister(), in.AsX86().AsCpuRegister());
+      break;
+
+    case Primitive::kPrimChar:
+      __ movzxw(out.AsX86().AsCpuRegister(), in.AsX86().AsCpuRegister());
+      break;
+
+    case Primitive::kPrimLong:
+      DCHECK_EQ(in.AsX86().AsCpuRegister(), EAX);
+      DCHECK_EQ(out.AsX86().AsRegisterPair(), EAX_EDX);
+      __ cdq();
+      break;
+
+    case Primitive::kPrimInt:
+      if (in.IsRegister()) {
+        __ movl(out.AsX86().AsCpuRegister(), in.AsX86().AsRegisterPairLow());
+      } else {
+        DCHECK(in.IsDoubleStackSlot());
+        __ movl(out.AsX86().AsCpuRegister(), Address(ESP, in.GetStackIndex()));
+      }
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented conversion from " << conversion->GetInputType()
+                 << " to " << conversion->GetResultType();
+  }
+}
+
 void LocationsBuilderX86::VisitCompare(HCompare* compare) {
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(compare);
   locations->SetInAt(0, Location::RequiresRegister());
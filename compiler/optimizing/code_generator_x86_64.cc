@@ -20,6 +20,7 @@
 #include "gc/accounting/card_table.h"
 #include "mirror/array.h"
 #include "mirror/art_method.h"
+#include "mirror/class.h"
 #include "mirror/object_reference.h"
 #include "thread.h"
 #include "utils/assembler.h"
@@ -121,6 +122,22 @@ class BoundsCheckSlowPathX86_64 : public SlowPathCode {
   DISALLOW_COPY_AND_ASSIGN(BoundsCheckSlowPathX86_64);
 };
 
+class DivZeroCheckSlowPathX86_64 : public SlowPathCode {
+ public:
+  explicit DivZeroCheckSlowPathX86_64(uint32_t dex_pc) : dex_pc_(dex_pc) {}
+
+  virtual void EmitNativeCode(CodeGenerator* codegen) OVERRIDE {
+    __ Bind(GetEntryLabel());
+    __ gs()->call(
+        Address::Absolute(QUICK_ENTRYPOINT_OFFSET(kX86_64WordSize, pThrowDivZero), true));
+    codegen->RecordPcInfo(dex_pc_);
+  }
+
+ private:
+  const uint32_t dex_pc_;
+  DISALLOW_COPY_AND_ASSIGN(DivZeroCheckSlowPathX86_64);
+};
+
 #undef __
 #define __ reinterpret_cast<X86_64Assembler*>(GetAssembler())->
 
@@ -685,6 +702,14 @@ Location InvokeDexCallingConventionVisitor::GetNextLocation(Primitive::Type type
 }
 
 void LocationsBuilderX86_64::VisitInvokeStatic(HInvokeStatic* invoke) {
+  HandleInvoke(invoke);
+}
+
+void LocationsBuilderX86_64::VisitInvokeVirtual(HInvokeVirtual* invoke) {
+  HandleInvoke(invoke);
+}
+
+void LocationsBuilderX86_64::HandleInvoke(HInvoke* invoke) {
   codegen_->MarkNotLeaf();
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(invoke);
   locations->AddTemp(X86_64CpuLocation(RDI));
@@ -744,6 +769,29 @@ void InstructionCodeGeneratorX86_64::VisitInvokeStatic(HInvokeStatic* invoke) {
   codegen_->RecordPcInfo(invoke->GetDexPc());
 }
 
+void InstructionCodeGeneratorX86_64::VisitInvokeVirtual(HInvokeVirtual* invoke) {
+  CpuRegister temp = invoke->GetLocations()->GetTemp(0).AsX86_64().AsCpuRegister();
+  size_t method_offset = mirror::Class::EmbeddedVTableOffset().SizeValue() +
+      invoke->GetVTableIndex() * sizeof(mirror::Class::VTableEntry);
+  LocationSummary* locations = invoke->GetLocations();
+  Location receiver = locations->InAt(0);
+  size_t class_offset = mirror::Object::ClassOffset().SizeValue();
+  // temp = object->GetClass();
+  if (receiver.IsStackSlot()) {
+    __ movl(temp, Address(CpuRegister(RSP), receiver.GetStackIndex()));
+    __ movl(temp, Address(temp, class_offset));
+  } else {
+    __ movl(temp, Address(receiver.AsX86_64().AsCpuRegister(), class_offset));
+  }
+  // temp = temp->GetMethodAt(method_offset);
+  __ movl(temp, Address(temp, method_offset));
+  // call temp->GetEntryPoint();
+  __ call(Address(temp, mirror::ArtMethod::EntryPointFromQuickCompiledCodeOffset().SizeValue()));
+
+  DCHECK(!codegen_->IsLeafMethod());
+  codegen_->RecordPcInfo(invoke->GetDexPc());
+}
+
 void LocationsBuilderX86_64::VisitAdd(HAdd* add) {
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(add);
   switch (add->GetResultType()) {
@@ -876,6 +924,379 @@ void InstructionCodeGeneratorX86_64::VisitSub(HSub* sub) {
   }
 }
 
+void LocationsBuilderX86_64::VisitMul(HMul* mul) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(mul);
+  switch (mul->GetResultType()) {
+    case Primitive::kPrimInt: {
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::Any());
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    }
+    case Primitive::kPrimLong: {
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::RequiresRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    }
+
+    case Primitive::kPrimBoolean:
+    case Primitive::kPrimByte:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      LOG(FATAL) << "Unexpected mul type " << mul->GetResultType();
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented mul type " << mul->GetResultType();
+  }
+  mul->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86_64::VisitMul(HMul* mul) {
+  LocationSummary* locations = mul->GetLocations();
+  CpuRegister first = locations->InAt(0).AsX86_64().AsCpuRegister();
+  Location second = locations->InAt(1);
+  DCHECK_EQ(first.AsRegister(), locations->Out().AsX86_64().AsCpuRegister().AsRegister());
+  switch (mul->GetResultType()) {
+    case Primitive::kPrimInt: {
+      if (second.IsRegister()) {
+        __ imull(first, second.AsX86_64().AsCpuRegister());
+      } else if (second.IsConstant()) {
+        Immediate imm(second.GetConstant()->AsIntConstant()->GetValue());
+        __ imull(first, imm);
+      } else {
+        __ imull(first, Address(CpuRegister(RSP), second.GetStackIndex()));
+      }
+      break;
+    }
+    case Primitive::kPrimLong: {
+      __ imulq(first, second.AsX86_64().AsCpuRegister());
+      break;
+    }
+
+    case Primitive::kPrimBoolean:
+    case Primitive::kPrimByte:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      LOG(FATAL) << "Unexpected mul type " << mul->GetResultType();
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented mul type " << mul->GetResultType();
+  }
+}
+
+void LocationsBuilderX86_64::HandleDivRem(HBinaryOperation* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt:
+    case Primitive::kPrimLong: {
+      // `idiv` divides RDX:RAX, and leaves the quotient in RAX and the remainder in RDX.
+      locations->SetInAt(0, X86_64CpuLocation(RAX));
+      locations->SetInAt(1, Location::RequiresRegister());
+      locations->AddTemp(X86_64CpuLocation(RDX));
+      locations->SetOut(X86_64CpuLocation(instruction->IsDiv() ? RAX : RDX));
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unimplemented " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+  instruction->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86_64::HandleDivRem(HBinaryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  DCHECK_EQ(RAX, locations->InAt(0).AsX86_64().AsCpuRegister().AsRegister());
+  CpuRegister second = locations->InAt(1).AsX86_64().AsCpuRegister();
+  CpuRegister rax(RAX);
+  CpuRegister rdx(RDX);
+  bool is_long = instruction->GetResultType() == Primitive::kPrimLong;
+  DCHECK(is_long || instruction->GetResultType() == Primitive::kPrimInt);
+  // MIN_VALUE / -1 raises a divide error, so a divisor of -1 is handled without `idiv`.
+  Label not_minus_one, done;
+  if (is_long) {
+    __ cmpq(second, Immediate(-1));
+  } else {
+    __ cmpl(second, Immediate(-1));
+  }
+  __ j(kNotEqual, &not_minus_one);
+  if (instruction->IsDiv()) {
+    if (is_long) {
+      __ negq(rax);
+    } else {
+      __ negl(rax);
+    }
+  } else {
+    __ xorl(rdx, rdx);
+  }
+  __ jmp(&done);
+  __ Bind(&not_minus_one);
+  if (is_long) {
+    __ cqo();
+    __ idivq(second);
+  } else {
+    __ cdq();
+    __ idivl(second);
+  }
+  __ Bind(&done);
+}
+
+void LocationsBuilderX86_64::VisitDiv(HDiv* instruction) {
+  HandleDivRem(instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitDiv(HDiv* instruction) {
+  HandleDivRem(instruction);
+}
+
+void LocationsBuilderX86_64::VisitRem(HRem* instruction) {
+  HandleDivRem(instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitRem(HRem* instruction) {
+  HandleDivRem(instruction);
+}
+
+void LocationsBuilderX86_64::VisitDivZeroCheck(HDivZeroCheck* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  locations->SetInAt(0, Location::Any());
+  locations->SetOut(Location::SameAsFirstInput());
+  instruction->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86_64::VisitDivZeroCheck(HDivZeroCheck* instruction) {
+  SlowPathCode* slow_path =
+      new (GetGraph()->GetArena()) DivZeroCheckSlowPathX86_64(instruction->GetDexPc());
+  codegen_->AddSlowPath(slow_path);
+
+  LocationSummary* locations = instruction->GetLocations();
+  Location value = locations->InAt(0);
+  DCHECK(value.Equals(locations->Out()));
+
+  if (value.IsRegister()) {
+    CpuRegister reg = value.AsX86_64().AsCpuRegister();
+    if (instruction->GetType() == Primitive::kPrimLong) {
+      __ cmpq(reg, Immediate(0));
+    } else {
+      __ cmpl(reg, Immediate(0));
+    }
+    __ j(kEqual, slow_path->GetEntryLabel());
+  } else if (value.IsStackSlot()) {
+    __ cmpl(Address(CpuRegister(RSP), value.GetStackIndex()), Immediate(0));
+    __ j(kEqual, slow_path->GetEntryLabel());
+  } else {
+    DCHECK(value.IsDoubleStackSlot());
+    // The value is zero if both of its halves are.
+    Label not_zero;
+    __ cmpl(Address(CpuRegister(RSP), value.GetStackIndex()), Immediate(0));
+    __ j(kNotEqual, &not_zero);
+    __ cmpl(Address(CpuRegister(RSP), value.GetStackIndex() + kX86_64WordSize / 2), Immediate(0));
+    __ j(kEqual, slow_path->GetEntryLabel());
+    __ Bind(&not_zero);
+  }
+}
+
+void LocationsBuilderX86_64::HandleBitwiseOperation(HBinaryOperation* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt: {
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::RegisterOrConstant(instruction->InputAt(1)));
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    }
+    case Primitive::kPrimLong: {
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::RequiresRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unexpected " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+  instruction->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86_64::HandleBitwiseOperation(HBinaryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  CpuRegister first = locations->InAt(0).AsX86_64().AsCpuRegister();
+  Location second = locations->InAt(1);
+  DCHECK_EQ(first.AsRegister(), locations->Out().AsX86_64().AsCpuRegister().AsRegister());
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt: {
+      if (second.IsRegister()) {
+        CpuRegister src = second.AsX86_64().AsCpuRegister();
+        if (instruction->IsAnd()) {
+          __ andl(first, src);
+        } else if (instruction->IsOr()) {
+          __ orl(first, src);
+        } else {
+          DCHECK(instruction->IsXor());
+          __ xorl(first, src);
+        }
+      } else {
+        Immediate imm(second.GetConstant()->AsIntConstant()->GetValue());
+        if (instruction->IsAnd()) {
+          __ andl(first, imm);
+        } else if (instruction->IsOr()) {
+          __ orl(first, imm);
+        } else {
+          DCHECK(instruction->IsXor());
+          __ xorl(first, imm);
+        }
+      }
+      break;
+    }
+    case Primitive::kPrimLong: {
+      CpuRegister src = second.AsX86_64().AsCpuRegister();
+      if (instruction->IsAnd()) {
+        __ andq(first, src);
+      } else if (instruction->IsOr()) {
+        __ orq(first, src);
+      } else {
+        DCHECK(instruction->IsXor());
+        __ xorq(first, src);
+      }
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unexpected " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+}
+
+void LocationsBuilderX86_64::VisitAnd(HAnd* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitAnd(HAnd* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void LocationsBuilderX86_64::VisitOr(HOr* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitOr(HOr* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void LocationsBuilderX86_64::VisitXor(HXor* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitXor(HXor* instruction) {
+  HandleBitwiseOperation(instruction);
+}
+
+void LocationsBuilderX86_64::HandleShift(HBinaryOperation* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
+  switch (instruction->GetResultType()) {
+    case Primitive::kPrimInt:
+    case Primitive::kPrimLong: {
+      locations->SetInAt(0, Location::RequiresRegister());
+      // A variable shift distance has to be in CL.
+      HInstruction* distance = instruction->InputAt(1);
+      locations->SetInAt(1, distance->IsConstant()
+          ? Location::ConstantLocation(distance->AsConstant())
+          : X86_64CpuLocation(RCX));
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    }
+
+    default:
+      LOG(FATAL) << "Unimplemented " << instruction->DebugName() << " type "
+                 << instruction->GetResultType();
+  }
+  instruction->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86_64::HandleShift(HBinaryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  CpuRegister first = locations->InAt(0).AsX86_64().AsCpuRegister();
+  DCHECK_EQ(first.AsRegister(), locations->Out().AsX86_64().AsCpuRegister().AsRegister());
+  bool is_long = instruction->GetResultType() == Primitive::kPrimLong;
+  DCHECK(is_long || instruction->GetResultType() == Primitive::kPrimInt);
+  Location distance = locations->InAt(1);
+  if (distance.IsConstant()) {
+    int32_t value = distance.GetConstant()->AsIntConstant()->GetValue();
+    Immediate imm(value & (is_long ? kMaxLongShiftValue : kMaxIntShiftValue));
+    if (instruction->IsShl()) {
+      if (is_long) {
+        __ shlq(first, imm);
+      } else {
+        __ shll(first, imm);
+      }
+    } else if (instruction->IsShr()) {
+      if (is_long) {
+        __ sarq(first, imm);
+      } else {
+        __ sarl(first, imm);
+      }
+    } else {
+      DCHECK(instruction->IsUShr());
+      if (is_long) {
+        __ shrq(first, imm);
+      } else {
+        __ shrl(first, imm);
+      }
+    }
+  } else {
+    // The hardware masks the distance to five bits (six for longs), as the dex semantics require.
+    CpuRegister shifter = distance.AsX86_64().AsCpuRegister();
+    if (instruction->IsShl()) {
+      if (is_long) {
+        __ shlq(first, shifter);
+      } else {
+        __ shll(first, shifter);
+      }
+    } else if (instruction->IsShr()) {
+      if (is_long) {
+        __ sarq(first, shifter);
+      } else {
+        __ sarl(first, shifter);
+      }
+    } else {
+      DCHECK(instruction->IsUShr());
+      if (is_long) {
+        __ shrq(first, shifter);
+      } else {
+        __ shrl(first, shifter);
+      }
+    }
+  }
+}
+
+void LocationsBuilderX86_64::VisitShl(HShl* instruction) {
+  HandleShift(instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitShl(HShl* instruction) {
+  HandleShift(instruction);
+}
+
+void LocationsBuilderX86_64::VisitShr(HShr* instruction) {
+  HandleShift(instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitShr(HShr* instruction) {
+  HandleShift(instruction);
+}
+
+void LocationsBuilderX86_64::VisitUShr(HUShr* instruction) {
+  HandleShift(instruction);
+}
+
+void InstructionCodeGeneratorX86_64::VisitUShr(HUShr* instruction) {
+  HandleShift(instruction);
+}
+
 void LocationsBuilderX86_64::VisitNewInstance(HNewInstance* instruction) {
   codegen_->MarkNotLeaf();
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
@@ -925,6 +1346,91 @@ void InstructionCodeGeneratorX86_64::VisitNot(HNot* instruction) {
   __ xorq(locations->Out().AsX86_64().AsCpuRegister(), Immediate(1));
 }
 
+void LocationsBuilderX86_64::VisitNeg(HNeg* neg) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(neg);
+  switch (neg->GetType()) {
+    case Primitive::kPrimInt:
+    case Primitive::kPrimLong:
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented neg type " << neg->GetType();
+  }
+  neg->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86_64::VisitNeg(HNeg* neg) {
+  LocationSummary* locations = neg->GetLocations();
+  CpuRegister in = locations->InAt(0).AsX86_64().AsCpuRegister();
+  DCHECK_EQ(in.AsRegister(), locations->Out().AsX86_64().AsCpuRegister().AsRegister());
+  switch (neg->GetType()) {
+    case Primitive::kPrimInt:
+      __ negl(in);
+      break;
+
+    case Primitive::kPrimLong:
+      __ negq(in);
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented neg type " << neg->GetType();
+  }
+}
+
+void LocationsBuilderX86_64::VisitTypeConversion(HTypeConversion* conversion) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(conversion);
+  switch (conversion->GetResultType()) {
+    case Primitive::kPrimByte:
+    case Primitive::kPrimShort:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimInt:
+    case Primitive::kPrimLong:
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented conversion from " << conversion->GetInputType()
+                 << " to " << conversion->GetResultType();
+  }
+  conversion->SetLocations(locations);
+}
+
+void InstructionCodeGeneratorX86_64::VisitTypeConversion(HTypeConversion* conversion) {
+  LocationSummary* locations = conversion->GetLocations();
+  CpuRegister in = locations->InAt(0).AsX86_64().AsCpuRegister();
+  CpuRegister out = locations->Out().AsX86_64().AsCpuRegister();
+  switch (conversion->GetResultType()) {
+    case Primitive::kPrimByte:
+      __ movsxb(out, in);
+      break;
+
+    case Primitive::kPrimShort:
+      __ movsxw(out, in);
+      break;
+
+    case Primitive::kPrimChar:
+      __ movzxw(out, in);
+      break;
+
+    case Primitive::kPrimLong:
+      DCHECK_EQ(conversion->GetInputType(), Primitive::kPrimInt);
+      __ movsxd(out, in);
+      break;
+
+    case Primitive::kPrimInt:
+      DCHECK_EQ(conversion->GetInputType(), Primitive::kPrimLong);
+      __ movl(out, in);
+      break;
+
+    default:
+      LOG(FATAL) << "Unimplemented conversion from " << conversion->GetInputType()
+                 << " to " << conversion->GetResultType();
+  }
+}
+
 void LocationsBuilderX86_64::VisitPhi(HPhi* instruction) {
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
   for (size_t i = 0, e = instruction->InputCount(); i < e; ++i) {
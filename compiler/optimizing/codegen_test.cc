@@ -78,21 +78,28 @@ static void TestCode(const uint16_t* data, bool has_result = false, int32_t expe
   CodeGenerator* codegen = CodeGenerator::Create(&arena, graph, kX86);
   // We avoid doing a stack overflow check that requires the runtime being setup,
   // by making sure the compiler knows the methods we are running are leaf methods.
+  // Code calling into the runtime is only compiled.
   codegen->CompileBaseline(&allocator, true);
 #if defined(__i386__)
-  Run(allocator, *codegen, has_result, expected);
+  if (codegen->IsLeafMethod()) {
+    Run(allocator, *codegen, has_result, expected);
+  }
 #endif
 
   codegen = CodeGenerator::Create(&arena, graph, kArm);
   codegen->CompileBaseline(&allocator, true);
 #if defined(__arm__)
-  Run(allocator, *codegen, has_result, expected);
+  if (codegen->IsLeafMethod()) {
+    Run(allocator, *codegen, has_result, expected);
+  }
 #endif
 
   codegen = CodeGenerator::Create(&arena, graph, kX86_64);
   codegen->CompileBaseline(&allocator, true);
 #if defined(__x86_64__)
-  Run(allocator, *codegen, has_result, expected);
+  if (codegen->IsLeafMethod()) {
+    Run(allocator, *codegen, has_result, expected);
+  }
 #endif
 }
 
@@ -254,4 +261,240 @@ TEST(CodegenTest, ReturnAdd4) {
   TestCode(data, true, 7);
 }
 
+TEST(CodegenTest, ReturnMulInt) {
+  const uint16_t data[] = TWO_REGISTERS_CODE_ITEM(
+    Instruction::CONST_4 | 3 << 12 | 0,
+    Instruction::CONST_4 | 4 << 12 | 1 << 8,
+    Instruction::MUL_INT, 1 << 8 | 0,
+    Instruction::MUL_INT_LIT8, 0xFE << 8 | 0,
+    Instruction::RETURN);
+
+  TestCode(data, true, -24);
+}
+
+TEST(CodegenTest, ReturnAndOrXorInt) {
+  const uint16_t data[] = TWO_REGISTERS_CODE_ITEM(
+    Instruction::CONST_4 | 6 << 12 | 0,
+    Instruction::CONST_4 | 3 << 12 | 1 << 8,
+    Instruction::AND_INT_2ADDR | 1 << 12,
+    Instruction::OR_INT_LIT16, 0x10,
+    Instruction::XOR_INT_LIT8, 3 << 8 | 0,
+    Instruction::RETURN);
+
+  TestCode(data, true, 17);
+}
+
+TEST(CodegenTest, ReturnShlIntMasksDistance) {
+  const uint16_t data[] = TWO_REGISTERS_CODE_ITEM(
+    Instruction::CONST_16 | 0 << 8, 240,
+    Instruction::CONST_16 | 1 << 8, 33,
+    Instruction::SHL_INT, 1 << 8 | 0,
+    Instruction::RETURN);
+
+  TestCode(data, true, 480);
+}
+
+TEST(CodegenTest, ReturnShrInt) {
+  const uint16_t data[] = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_16 | 0 << 8, 0xFFF0,
+    Instruction::SHR_INT_LIT8, 2 << 8 | 0,
+    Instruction::RETURN);
+
+  TestCode(data, true, -4);
+}
+
+TEST(CodegenTest, ReturnUShrInt) {
+  const uint16_t data[] = TWO_REGISTERS_CODE_ITEM(
+    Instruction::CONST_16 | 0 << 8, 0xFFF0,
+    Instruction::CONST_16 | 1 << 8, 28,
+    Instruction::USHR_INT_2ADDR | 1 << 12,
+    Instruction::RETURN);
+
+  TestCode(data, true, 15);
+}
+
+TEST(CodegenTest, ReturnNegNotInt) {
+  const uint16_t data[] = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 5 << 12 | 0,
+    Instruction::NEG_INT | 0 << 8 | 0 << 12,
+    Instruction::NOT_INT | 0 << 8 | 0 << 12,
+    Instruction::RETURN);
+
+  TestCode(data, true, 4);
+}
+
+TEST(CodegenTest, ReturnIntToByte) {
+  const uint16_t data[] = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_16 | 0 << 8, 0x1FF,
+    Instruction::INT_TO_BYTE | 0 << 8 | 0 << 12,
+    Instruction::RETURN);
+
+  TestCode(data, true, -1);
+}
+
+TEST(CodegenTest, ReturnIntToShort) {
+  const uint16_t data[] = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST | 0 << 8, 0x8000, 0x0001,
+    Instruction::INT_TO_SHORT | 0 << 8 | 0 << 12,
+    Instruction::RETURN);
+
+  TestCode(data, true, -32768);
+}
+
+TEST(CodegenTest, ReturnIntToChar) {
+  const uint16_t data[] = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0xF << 12 | 0,
+    Instruction::INT_TO_CHAR | 0 << 8 | 0 << 12,
+    Instruction::RETURN);
+
+  TestCode(data, true, 0xFFFF);
+}
+
+TEST(CodegenTest, ReturnLongArithmetic) {
+  const uint16_t data[] = FOUR_REGISTERS_CODE_ITEM(
+    Instruction::CONST_WIDE_16 | 0 << 8, 7,
+    Instruction::CONST_WIDE_16 | 2 << 8, 6,
+    Instruction::MUL_LONG, 2 << 8 | 0,             // 42
+    Instruction::NOT_LONG | 0 << 8 | 0 << 12,      // -43
+    Instruction::NEG_LONG | 0 << 8 | 0 << 12,      // 43
+    Instruction::CONST_WIDE_16 | 2 << 8, 0xF,
+    Instruction::AND_LONG_2ADDR | 2 << 12,         // 11
+    Instruction::OR_LONG, 2 << 8 | 0,              // 15
+    Instruction::CONST_WIDE_16 | 2 << 8, 0x30,
+    Instruction::XOR_LONG_2ADDR | 2 << 12,         // 63
+    Instruction::LONG_TO_INT | 0 << 8 | 0 << 12,
+    Instruction::RETURN);
+
+  TestCode(data, true, 63);
+}
+
+TEST(CodegenTest, ReturnMulLongHighWord) {
+  const uint16_t data[] = FOUR_REGISTERS_CODE_ITEM(
+    Instruction::CONST_WIDE_32 | 0 << 8, 0x0000, 0x0001,
+    Instruction::MUL_LONG_2ADDR | 0 << 12,         // 1 << 32
+    Instruction::CONST_WIDE_16 | 2 << 8, 0,
+    Instruction::CMP_LONG, 2 << 8 | 0,
+    Instruction::RETURN);
+
+  TestCode(data, true, 1);
+}
+
+TEST(CodegenTest, ReturnIntToLongSignExtends) {
+  const uint16_t data[] = FOUR_REGISTERS_CODE_ITEM(
+    Instruction::CONST_4 | 0xF << 12 | 0,
+    Instruction::INT_TO_LONG | 2 << 8 | 0 << 12,
+    Instruction::CONST_WIDE_16 | 0 << 8, 0,
+    Instruction::CMP_LONG, 0 << 8 | 2,
+    Instruction::RETURN);
+
+  TestCode(data, true, -1);
+}
+
+TEST(CodegenTest, ReturnDivRemInt) {
+  const uint16_t data[] = THREE_REGISTERS_CODE_ITEM(
+    Instruction::CONST_4 | 0x9 << 12 | 0 << 8,     // -7
+    Instruction::CONST_4 | 2 << 12 | 1 << 8,
+    Instruction::DIV_INT | 2 << 8, 1 << 8 | 0,     // -3
+    Instruction::REM_INT_2ADDR | 0 << 8 | 1 << 12, // -1
+    Instruction::ADD_INT_2ADDR | 0 << 8 | 2 << 12,
+    Instruction::RETURN);
+
+  TestCode(data, true, -4);
+}
+
+TEST(CodegenTest, ReturnDivIntMinValueByMinusOne) {
+  const uint16_t data[] = THREE_REGISTERS_CODE_ITEM(
+    Instruction::CONST_HIGH16 | 0 << 8, 0x8000,
+    Instruction::CONST_4 | 0xF << 12 | 1 << 8,
+    Instruction::DIV_INT | 2 << 8, 1 << 8 | 0,     // Integer.MIN_VALUE
+    Instruction::REM_INT | 0 << 8, 1 << 8 | 0,     // 0
+    Instruction::ADD_INT_2ADDR | 0 << 8 | 2 << 12,
+    Instruction::RETURN);
+
+  TestCode(data, true, static_cast<int32_t>(0x80000000));
+}
+
+TEST(CodegenTest, ReturnDivRemIntLiteral) {
+  const uint16_t data[] = TWO_REGISTERS_CODE_ITEM(
+    Instruction::CONST_4 | 7 << 12 | 0 << 8,
+    Instruction::DIV_INT_LIT8 | 1 << 8, 0xFE << 8 | 0,       // -3
+    Instruction::REM_INT_LIT16 | 0 << 8 | 0 << 12, 5,        // 2
+    Instruction::ADD_INT_2ADDR | 0 << 8 | 1 << 12,
+    Instruction::RETURN);
+
+  TestCode(data, true, -1);
+}
+
+TEST(CodegenTest, ReturnShlUShrLong) {
+  const uint16_t data[] = FOUR_REGISTERS_CODE_ITEM(
+    Instruction::CONST_WIDE_16 | 0 << 8, 3,
+    Instruction::CONST_16 | 2 << 8, 97,
+    Instruction::SHL_LONG | 0 << 8, 2 << 8 | 0,              // 3 << 33
+    Instruction::CONST_16 | 2 << 8, 32,
+    Instruction::USHR_LONG_2ADDR | 0 << 8 | 2 << 12,         // 6
+    Instruction::CONST_16 | 2 << 8, 31,
+    Instruction::SHL_LONG | 0 << 8, 2 << 8 | 0,              // 3 << 32
+    Instruction::CONST_16 | 2 << 8, 30,
+    Instruction::USHR_LONG | 0 << 8, 2 << 8 | 0,             // 12
+    Instruction::LONG_TO_INT | 0 << 8 | 0 << 12,
+    Instruction::RETURN);
+
+  TestCode(data, true, 12);
+}
+
+TEST(CodegenTest, ReturnShrLong) {
+  const uint16_t data[] = FOUR_REGISTERS_CODE_ITEM(
+    Instruction::CONST_WIDE_HIGH16 | 0 << 8, 0x8000,
+    Instruction::CONST_4 | 4 << 12 | 2 << 8,
+    Instruction::SHR_LONG_2ADDR | 0 << 8 | 2 << 12,
+    Instruction::CONST_16 | 2 << 8, 36,
+    Instruction::SHR_LONG | 0 << 8, 2 << 8 | 0,              // 0xFFFFFFFFFF800000
+    Instruction::LONG_TO_INT | 0 << 8 | 0 << 12,
+    Instruction::RETURN);
+
+  TestCode(data, true, -8388608);
+}
+
+TEST(CodegenTest, ReturnDivRemLong) {
+  const uint16_t data[] = FOUR_REGISTERS_CODE_ITEM(
+    Instruction::CONST_WIDE_HIGH16 | 0 << 8, 0x8000,
+    Instruction::CONST_WIDE_16 | 2 << 8, 0xFFFF,
+    Instruction::DIV_LONG_2ADDR | 0 << 8 | 2 << 12,          // Long.MIN_VALUE
+    Instruction::CONST_WIDE_16 | 2 << 8, 7,
+    Instruction::REM_LONG_2ADDR | 0 << 8 | 2 << 12,          // -1
+    Instruction::LONG_TO_INT | 0 << 8 | 0 << 12,
+    Instruction::RETURN);
+
+  TestCode(data, true, -1);
+}
+
+TEST(CodegenTest, ReturnPackedSwitch) {
+  const uint16_t data[] = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 1 << 12 | 0,
+    Instruction::PACKED_SWITCH | 0 << 8, 9, 0,
+    Instruction::CONST_4 | 7 << 12 | 0,
+    Instruction::RETURN,
+    Instruction::CONST_4 | 3 << 12 | 0,
+    Instruction::RETURN,
+    Instruction::CONST_4 | 4 << 12 | 0,
+    Instruction::RETURN,
+    Instruction::kPackedSwitchSignature, 2, 0, 0, 5, 0, 7, 0);
+
+  TestCode(data, true, 4);
+}
+
+TEST(CodegenTest, ReturnSparseSwitch) {
+  const uint16_t data[] = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_16 | 0 << 8, 0xFFFB,
+    Instruction::SPARSE_SWITCH | 0 << 8, 8, 0,
+    Instruction::CONST_4 | 7 << 12 | 0,
+    Instruction::RETURN,
+    Instruction::CONST_4 | 3 << 12 | 0,
+    Instruction::RETURN,
+    Instruction::NOP,
+    Instruction::kSparseSwitchSignature, 2, 0xFFFB, 0xFFFF, 1000, 0, 5, 0, 3, 0);
+
+  TestCode(data, true, 3);
+}
+
 }  // namespace art
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "constant_folding.h"
+
+namespace art {
+
+// The code generators expect the input of an HIf to be a condition, so conditions
+// used by an HIf are kept until branches on constants can be simplified.
+static bool IsUsedByIf(HInstruction* instruction) {
+  for (HUseIterator<HInstruction> it(instruction->GetUses()); !it.Done(); it.Advance()) {
+    if (it.Current()->GetUser()->IsIf()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void HConstantFolding::Run() {
+  VisitReversePostOrder();
+}
+
+void HConstantFolding::VisitInstruction(HInstruction* instruction) {
+  if (instruction->IsCondition() && IsUsedByIf(instruction)) {
+    return;
+  }
+  HConstant* constant = instruction->TryStaticEvaluation(GetGraph()->GetArena());
+  if (constant != nullptr) {
+    instruction->GetBlock()->InsertInstructionBefore(constant, instruction);
+    instruction->ReplaceWith(constant);
+  }
+}
+
+}  // namespace art
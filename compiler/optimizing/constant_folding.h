@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_CONSTANT_FOLDING_H_
+#define ART_COMPILER_OPTIMIZING_CONSTANT_FOLDING_H_
+
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * Optimization pass performing a simple constant folding on the SSA form: instructions
+ * whose inputs are all constants are replaced by the constant they evaluate to. Blocks
+ * are visited in reverse post order so that folded inputs are seen by their users.
+ *
+ * The folded instructions are left in the graph without uses, and are expected to be
+ * removed by a dead code elimination pass.
+ */
+class HConstantFolding : public HOptimization {
+ public:
+  explicit HConstantFolding(HGraph* graph) : HOptimization(graph, kConstantFoldingPassName) {}
+
+  virtual void Run();
+
+  virtual void VisitInstruction(HInstruction* instruction);
+
+  static constexpr const char* kConstantFoldingPassName = "constant_folding";
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HConstantFolding);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_CONSTANT_FOLDING_H_
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <limits>
+
+#include "constant_folding.h"
+#include "dead_code_elimination.h"
+#include "nodes.h"
+#include "utils/arena_allocator.h"
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+// Creates a graph with an entry block, a body block and an exit block. The body
+// block is returned in `body` and the caller must end it with a return.
+static HGraph* CreateGraph(ArenaAllocator* allocator, HBasicBlock** body) {
+  HGraph* graph = new (allocator) HGraph(allocator);
+  HBasicBlock* entry = new (allocator) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  *body = new (allocator) HBasicBlock(graph);
+  graph->AddBlock(*body);
+  HBasicBlock* exit = new (allocator) HBasicBlock(graph);
+  graph->AddBlock(exit);
+  graph->SetExitBlock(exit);
+  exit->AddInstruction(new (allocator) HExit());
+  entry->AddSuccessor(*body);
+  (*body)->AddSuccessor(exit);
+  return graph;
+}
+
+static void Finish(HGraph* graph) {
+  graph->GetEntryBlock()->AddInstruction(new (graph->GetArena()) HGoto());
+  graph->BuildDominatorTree();
+}
+
+TEST(ConstantFoldingTest, IntAddition) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  HBasicBlock* body;
+  HGraph* graph = CreateGraph(&allocator, &body);
+  HInstruction* one = new (&allocator) HIntConstant(1);
+  HInstruction* two = new (&allocator) HIntConstant(2);
+  graph->GetEntryBlock()->AddInstruction(one);
+  graph->GetEntryBlock()->AddInstruction(two);
+  HInstruction* add = new (&allocator) HAdd(Primitive::kPrimInt, one, two);
+  body->AddInstruction(add);
+  HInstruction* ret = new (&allocator) HReturn(add);
+  body->AddInstruction(ret);
+  Finish(graph);
+
+  HConstantFolding(graph).Run();
+  ASSERT_TRUE(ret->InputAt(0)->IsIntConstant());
+  EXPECT_EQ(3, ret->InputAt(0)->AsIntConstant()->GetValue());
+  EXPECT_FALSE(add->HasUses());
+
+  HDeadCodeElimination(graph).Run();
+  EXPECT_FALSE(add->IsInBlock());
+  EXPECT_TRUE(ret->InputAt(0)->IsInBlock());
+}
+
+// Folding is transitive, the result of a folded instruction can be folded again.
+TEST(ConstantFoldingTest, ChainedIntOperations) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  HBasicBlock* body;
+  HGraph* graph = CreateGraph(&allocator, &body);
+  HInstruction* one = new (&allocator) HIntConstant(1);
+  HInstruction* three = new (&allocator) HIntConstant(3);
+  graph->GetEntryBlock()->AddInstruction(one);
+  graph->GetEntryBlock()->AddInstruction(three);
+  HInstruction* add = new (&allocator) HAdd(Primitive::kPrimInt, one, three);
+  body->AddInstruction(add);
+  HInstruction* sub = new (&allocator) HSub(Primitive::kPrimInt, add, one);
+  body->AddInstruction(sub);
+  HInstruction* equal = new (&allocator) HEqual(sub, three);
+  body->AddInstruction(equal);
+  HInstruction* ret = new (&allocator) HReturn(equal);
+  body->AddInstruction(ret);
+  Finish(graph);
+
+  HConstantFolding(graph).Run();
+  ASSERT_TRUE(ret->InputAt(0)->IsIntConstant());
+  EXPECT_EQ(1, ret->InputAt(0)->AsIntConstant()->GetValue());
+
+  HDeadCodeElimination(graph).Run();
+  EXPECT_FALSE(add->IsInBlock());
+  EXPECT_FALSE(sub->IsInBlock());
+  EXPECT_FALSE(equal->IsInBlock());
+  // The constants used by the folded instructions are dead as well.
+  EXPECT_FALSE(one->IsInBlock());
+  EXPECT_FALSE(three->IsInBlock());
+}
+
+TEST(ConstantFoldingTest, IntOverflow) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  HBasicBlock* body;
+  HGraph* graph = CreateGraph(&allocator, &body);
+  HInstruction* max = new (&allocator) HIntConstant(std::numeric_limits<int32_t>::max());
+  HInstruction* one = new (&allocator) HIntConstant(1);
+  graph->GetEntryBlock()->AddInstruction(max);
+  graph->GetEntryBlock()->AddInstruction(one);
+  HInstruction* add = new (&allocator) HAdd(Primitive::kPrimInt, max, one);
+  body->AddInstruction(add);
+  HInstruction* ret = new (&allocator) HReturn(add);
+  body->AddInstruction(ret);
+  Finish(graph);
+
+  HConstantFolding(graph).Run();
+  ASSERT_TRUE(ret->InputAt(0)->IsIntConstant());
+  EXPECT_EQ(std::numeric_limits<int32_t>::min(), ret->InputAt(0)->AsIntConstant()->GetValue());
+}
+
+TEST(ConstantFoldingTest, LongOperations) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  HBasicBlock* body;
+  HGraph* graph = CreateGraph(&allocator, &body);
+  HInstruction* min = new (&allocator) HLongConstant(std::numeric_limits<int64_t>::min());
+  HInstruction* one = new (&allocator) HLongConstant(1);
+  graph->GetEntryBlock()->AddInstruction(min);
+  graph->GetEntryBlock()->AddInstruction(one);
+  HInstruction* sub = new (&allocator) HSub(Primitive::kPrimLong, min, one);
+  body->AddInstruction(sub);
+  HInstruction* compare = new (&allocator) HCompare(Primitive::kPrimLong, sub, one);
+  body->AddInstruction(compare);
+  HInstruction* ret = new (&allocator) HReturn(compare);
+  body->AddInstruction(ret);
+  Finish(graph);
+
+  HConstantFolding(graph).Run();
+  ASSERT_TRUE(compare->InputAt(0)->IsLongConstant());
+  EXPECT_EQ(std::numeric_limits<int64_t>::max(), compare->InputAt(0)->AsLongConstant()->GetValue());
+  // Comparing longs produces an int.
+  ASSERT_TRUE(ret->InputAt(0)->IsIntConstant());
+  EXPECT_EQ(1, ret->InputAt(0)->AsIntConstant()->GetValue());
+}
+
+TEST(ConstantFoldingTest, Not) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  HBasicBlock* body;
+  HGraph* graph = CreateGraph(&allocator, &body);
+  HInstruction* zero = new (&allocator) HIntConstant(0);
+  graph->GetEntryBlock()->AddInstruction(zero);
+  HInstruction* not_instr = new (&allocator) HNot(zero);
+  body->AddInstruction(not_instr);
+  HInstruction* ret = new (&allocator) HReturn(not_instr);
+  body->AddInstruction(ret);
+  Finish(graph);
+
+  HConstantFolding(graph).Run();
+  ASSERT_TRUE(ret->InputAt(0)->IsIntConstant());
+  EXPECT_EQ(1, ret->InputAt(0)->AsIntConstant()->GetValue());
+}
+
+// Shift distances are masked like the dex instructions do, and conversions truncate.
+TEST(ConstantFoldingTest, BitwiseShiftsAndConversions) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  HBasicBlock* body;
+  HGraph* graph = CreateGraph(&allocator, &body);
+  HInstruction* value = new (&allocator) HIntConstant(0x1ff);
+  HInstruction* distance = new (&allocator) HIntConstant(33);
+  HInstruction* mask = new (&allocator) HIntConstant(0xf0);
+  HInstruction* minus_one = new (&allocator) HLongConstant(-1);
+  graph->GetEntryBlock()->AddInstruction(value);
+  graph->GetEntryBlock()->AddInstruction(distance);
+  graph->GetEntryBlock()->AddInstruction(mask);
+  graph->GetEntryBlock()->AddInstruction(minus_one);
+  // (0x1ff << 1) is 0x3fe.
+  HInstruction* shl = new (&allocator) HShl(Primitive::kPrimInt, value, distance);
+  body->AddInstruction(shl);
+  // 0x3fe & 0xf0 is 0xf0.
+  HInstruction* and_instr = new (&allocator) HAnd(Primitive::kPrimInt, shl, mask);
+  body->AddInstruction(and_instr);
+  // 0xf0 * 0x1ff is 0x1df10.
+  HInstruction* mul = new (&allocator) HMul(Primitive::kPrimInt, and_instr, value);
+  body->AddInstruction(mul);
+  // (byte) 0x1df10 is 0x10.
+  HInstruction* to_byte = new (&allocator) HTypeConversion(Primitive::kPrimByte, mul);
+  body->AddInstruction(to_byte);
+  HInstruction* neg = new (&allocator) HNeg(Primitive::kPrimInt, to_byte);
+  body->AddInstruction(neg);
+  HInstruction* to_long = new (&allocator) HTypeConversion(Primitive::kPrimLong, neg);
+  body->AddInstruction(to_long);
+  // ~(-16L) is 15.
+  HInstruction* xor_instr = new (&allocator) HXor(Primitive::kPrimLong, to_long, minus_one);
+  body->AddInstruction(xor_instr);
+  HInstruction* ret = new (&allocator) HReturn(xor_instr);
+  body->AddInstruction(ret);
+  Finish(graph);
+
+  HConstantFolding(graph).Run();
+  EXPECT_FALSE(to_long->HasUses());
+  ASSERT_TRUE(ret->InputAt(0)->IsLongConstant());
+  EXPECT_EQ(15, ret->InputAt(0)->AsLongConstant()->GetValue());
+
+  HDeadCodeElimination(graph).Run();
+  EXPECT_FALSE(shl->IsInBlock());
+  EXPECT_FALSE(to_byte->IsInBlock());
+  EXPECT_FALSE(xor_instr->IsInBlock());
+}
+
+// Instructions with non constant inputs, and conditions used by an if, are not folded.
+TEST(ConstantFoldingTest, NotFolded) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  HGraph* graph = new (&allocator) HGraph(&allocator);
+  HBasicBlock* entry = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  HInstruction* parameter = new (&allocator) HParameterValue(0, Primitive::kPrimInt);
+  entry->AddInstruction(parameter);
+  HInstruction* one = new (&allocator) HIntConstant(1);
+  entry->AddInstruction(one);
+  HInstruction* add = new (&allocator) HAdd(Primitive::kPrimInt, parameter, one);
+  entry->AddInstruction(add);
+  HInstruction* equal = new (&allocator) HEqual(one, one);
+  entry->AddInstruction(equal);
+  entry->AddInstruction(new (&allocator) HIf(equal));
+
+  HBasicBlock* then_block = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(then_block);
+  then_block->AddInstruction(new (&allocator) HReturn(add));
+  HBasicBlock* else_block = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(else_block);
+  else_block->AddInstruction(new (&allocator) HReturn(one));
+  HBasicBlock* exit = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(exit);
+  graph->SetExitBlock(exit);
+  exit->AddInstruction(new (&allocator) HExit());
+  entry->AddSuccessor(then_block);
+  entry->AddSuccessor(else_block);
+  then_block->AddSuccessor(exit);
+  else_block->AddSuccessor(exit);
+  graph->BuildDominatorTree();
+
+  HConstantFolding(graph).Run();
+  HDeadCodeElimination(graph).Run();
+  EXPECT_TRUE(add->IsInBlock());
+  EXPECT_TRUE(equal->IsInBlock());
+  EXPECT_TRUE(entry->GetLastInstruction()->InputAt(0) == equal);
+}
+
+}  // namespace art
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dead_code_elimination.h"
+#include "nodes.h"
+#include "utils/arena_allocator.h"
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+TEST(DeadCodeEliminationTest, RemoveUnusedInstructions) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  HGraph* graph = new (&allocator) HGraph(&allocator);
+  HBasicBlock* entry = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  HInstruction* parameter = new (&allocator) HParameterValue(0, Primitive::kPrimNot);
+  entry->AddInstruction(parameter);
+  HInstruction* one = new (&allocator) HIntConstant(1);
+  entry->AddInstruction(one);
+  HInstruction* unused_constant = new (&allocator) HIntConstant(2);
+  entry->AddInstruction(unused_constant);
+  entry->AddInstruction(new (&allocator) HGoto());
+
+  HBasicBlock* block = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(block);
+  HInstruction* null_check = new (&allocator) HNullCheck(parameter, 0);
+  block->AddInstruction(null_check);
+  HInstruction* length = new (&allocator) HArrayLength(null_check);
+  block->AddInstruction(length);
+  // A chain of unused instructions: the users are removed before their inputs.
+  HInstruction* add = new (&allocator) HAdd(Primitive::kPrimInt, length, one);
+  block->AddInstruction(add);
+  HInstruction* sub = new (&allocator) HSub(Primitive::kPrimInt, add, one);
+  block->AddInstruction(sub);
+  // Memory accesses are kept, even when unused.
+  HInstruction* get = new (&allocator) HInstanceFieldGet(
+      null_check, Primitive::kPrimInt, MemberOffset(8));
+  block->AddInstruction(get);
+  HInstruction* set = new (&allocator) HInstanceFieldSet(null_check, one, MemberOffset(12));
+  block->AddInstruction(set);
+  block->AddInstruction(new (&allocator) HReturnVoid());
+
+  HBasicBlock* exit = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(exit);
+  graph->SetExitBlock(exit);
+  exit->AddInstruction(new (&allocator) HExit());
+  entry->AddSuccessor(block);
+  block->AddSuccessor(exit);
+  graph->BuildDominatorTree();
+
+  HDeadCodeElimination(graph).Run();
+  EXPECT_FALSE(sub->IsInBlock());
+  EXPECT_FALSE(add->IsInBlock());
+  EXPECT_FALSE(length->IsInBlock());
+  EXPECT_FALSE(unused_constant->IsInBlock());
+  EXPECT_TRUE(one->IsInBlock());
+  EXPECT_TRUE(null_check->IsInBlock());
+  EXPECT_TRUE(get->IsInBlock());
+  EXPECT_TRUE(set->IsInBlock());
+  EXPECT_TRUE(parameter->IsInBlock());
+}
+
+}  // namespace art
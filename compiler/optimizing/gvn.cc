@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gvn.h"
+
+namespace art {
+
+void GlobalValueNumberer::Run() {
+  VisitReversePostOrder();
+}
+
+void GlobalValueNumberer::VisitBasicBlock(HBasicBlock* block) {
+  HBasicBlock* dominator = block->GetDominator();
+  ValueSet* set = (dominator == nullptr)
+      ? new (GetGraph()->GetArena()) ValueSet(GetGraph()->GetArena())
+      : sets_.Get(dominator->GetBlockId())->Copy();
+  sets_.Put(block->GetBlockId(), set);
+
+  // Phis are not numbered, so only instructions are visited.
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* current = it.Current();
+    if (!current->CanBeMoved()) {
+      continue;
+    }
+    HInstruction* existing = set->Lookup(current);
+    if (existing != nullptr) {
+      current->ReplaceWith(existing);
+      block->RemoveInstruction(current);
+    } else {
+      set->Add(current);
+    }
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_GVN_H_
+#define ART_COMPILER_OPTIMIZING_GVN_H_
+
+#include "optimization.h"
+
+namespace art {
+
+/**
+ * A node in the collision list of a ValueSet. Encodes the instruction,
+ * the hash code, and the next node in the collision list.
+ */
+class ValueSetNode : public ArenaObject {
+ public:
+  ValueSetNode(HInstruction* instruction, size_t hash_code, ValueSetNode* next)
+      : instruction_(instruction), hash_code_(hash_code), next_(next) {}
+
+  size_t GetHashCode() const { return hash_code_; }
+  HInstruction* GetInstruction() const { return instruction_; }
+  ValueSetNode* GetNext() const { return next_; }
+
+ private:
+  HInstruction* const instruction_;
+  const size_t hash_code_;
+  ValueSetNode* const next_;
+
+  DISALLOW_COPY_AND_ASSIGN(ValueSetNode);
+};
+
+/**
+ * A ValueSet holds the instructions that are available at a given point of the graph:
+ * instructions that can be moved and that dominate that point. It is a fixed size hash
+ * table with collision lists, allocated in the arena of the graph.
+ */
+class ValueSet : public ArenaObject {
+ public:
+  explicit ValueSet(ArenaAllocator* allocator)
+      : allocator_(allocator), number_of_entries_(0) {
+    for (size_t i = 0; i < kDefaultNumberOfEntries; ++i) {
+      table_[i] = nullptr;
+    }
+  }
+
+  // Adds an instruction in the set.
+  void Add(HInstruction* instruction) {
+    DCHECK(Lookup(instruction) == nullptr);
+    size_t hash_code = instruction->ComputeHashCode();
+    size_t index = hash_code % kDefaultNumberOfEntries;
+    table_[index] = new (allocator_) ValueSetNode(instruction, hash_code, table_[index]);
+    ++number_of_entries_;
+  }
+
+  // If in the set, returns an equivalent instruction to the given instruction. Returns
+  // null otherwise.
+  HInstruction* Lookup(HInstruction* instruction) const {
+    size_t hash_code = instruction->ComputeHashCode();
+    size_t index = hash_code % kDefaultNumberOfEntries;
+    for (ValueSetNode* node = table_[index]; node != nullptr; node = node->GetNext()) {
+      if (node->GetHashCode() == hash_code && node->GetInstruction()->Equals(instruction)) {
+        return node->GetInstruction();
+      }
+    }
+    return nullptr;
+  }
+
+  // Returns a copy of this set. The collision lists are shared until an instruction is added
+  // to one of the sets, since nodes are only ever prepended.
+  ValueSet* Copy() const {
+    ValueSet* copy = new (allocator_) ValueSet(allocator_);
+    for (size_t i = 0; i < kDefaultNumberOfEntries; ++i) {
+      copy->table_[i] = table_[i];
+    }
+    copy->number_of_entries_ = number_of_entries_;
+    return copy;
+  }
+
+  size_t GetNumberOfEntries() const { return number_of_entries_; }
+
+ private:
+  static constexpr size_t kDefaultNumberOfEntries = 32;
+
+  ArenaAllocator* const allocator_;
+
+  // The number of entries in the set.
+  size_t number_of_entries_;
+
+  // The internal implementation of the set. It uses a combination of a hash code based
+  // fixed-size list, and a linked list to handle hash code collisions.
+  ValueSetNode* table_[kDefaultNumberOfEntries];
+
+  DISALLOW_COPY_AND_ASSIGN(ValueSet);
+};
+
+/**
+ * Optimization phase that removes redundant instructions. Blocks are visited in reverse
+ * post order, so that the dominator of a block is processed before the block itself. A
+ * block starts with the set of values available at the end of its dominator, and each
+ * instruction that can be moved is either replaced by an equal instruction in that set,
+ * or added to it.
+ */
+class GlobalValueNumberer : public HOptimization {
+ public:
+  explicit GlobalValueNumberer(HGraph* graph)
+      : HOptimization(graph, kGlobalValueNumberingPassName),
+        sets_(graph->GetArena(), graph->GetBlocks().Size()) {
+    sets_.SetSize(graph->GetBlocks().Size());
+  }
+
+  virtual void Run();
+
+  // Per-block GVN, records the set of values available at the end of the block.
+  virtual void VisitBasicBlock(HBasicBlock* block);
+
+  static constexpr const char* kGlobalValueNumberingPassName = "GVN";
+
+ private:
+  // The values available at the end of each visited block, indexed by block id.
+  GrowableArray<ValueSet*> sets_;
+
+  DISALLOW_COPY_AND_ASSIGN(GlobalValueNumberer);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_GVN_H_
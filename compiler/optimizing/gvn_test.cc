@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gvn.h"
+#include "nodes.h"
+#include "utils/arena_allocator.h"
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+TEST(GVNTest, LocalValueNumbering) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  HGraph* graph = new (&allocator) HGraph(&allocator);
+  HBasicBlock* entry = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  HInstruction* first = new (&allocator) HParameterValue(0, Primitive::kPrimInt);
+  entry->AddInstruction(first);
+  HInstruction* second = new (&allocator) HParameterValue(1, Primitive::kPrimInt);
+  entry->AddInstruction(second);
+  HInstruction* parameter = new (&allocator) HParameterValue(2, Primitive::kPrimNot);
+  entry->AddInstruction(parameter);
+  entry->AddInstruction(new (&allocator) HGoto());
+
+  HBasicBlock* block = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(block);
+  HInstruction* add = new (&allocator) HAdd(Primitive::kPrimInt, first, second);
+  block->AddInstruction(add);
+  HInstruction* redundant_add = new (&allocator) HAdd(Primitive::kPrimInt, first, second);
+  block->AddInstruction(redundant_add);
+  HInstruction* sub = new (&allocator) HSub(Primitive::kPrimInt, add, redundant_add);
+  block->AddInstruction(sub);
+  // Different constants, operations or operand orders are different values.
+  HInstruction* other_sub = new (&allocator) HSub(Primitive::kPrimInt, redundant_add, add);
+  block->AddInstruction(other_sub);
+  HInstruction* other_add = new (&allocator) HAdd(Primitive::kPrimInt, second, first);
+  block->AddInstruction(other_add);
+  HInstruction* constant = new (&allocator) HIntConstant(42);
+  block->AddInstruction(constant);
+  HInstruction* same_constant = new (&allocator) HIntConstant(42);
+  block->AddInstruction(same_constant);
+  HInstruction* other_constant = new (&allocator) HIntConstant(43);
+  block->AddInstruction(other_constant);
+  // Field loads are not numbered since stores and calls may change the value.
+  HInstruction* get = new (&allocator) HInstanceFieldGet(
+      parameter, Primitive::kPrimInt, MemberOffset(8));
+  block->AddInstruction(get);
+  HInstruction* same_get = new (&allocator) HInstanceFieldGet(
+      parameter, Primitive::kPrimInt, MemberOffset(8));
+  block->AddInstruction(same_get);
+  block->AddInstruction(new (&allocator) HReturnVoid());
+
+  HBasicBlock* exit = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(exit);
+  graph->SetExitBlock(exit);
+  exit->AddInstruction(new (&allocator) HExit());
+  entry->AddSuccessor(block);
+  block->AddSuccessor(exit);
+  graph->BuildDominatorTree();
+
+  GlobalValueNumberer(graph).Run();
+  EXPECT_TRUE(add->IsInBlock());
+  EXPECT_FALSE(redundant_add->IsInBlock());
+  EXPECT_EQ(add, sub->InputAt(0));
+  EXPECT_EQ(add, sub->InputAt(1));
+  // Once the inputs are numbered the same, both subtractions are equal.
+  EXPECT_FALSE(other_sub->IsInBlock());
+  EXPECT_TRUE(other_add->IsInBlock());
+  EXPECT_TRUE(constant->IsInBlock());
+  EXPECT_FALSE(same_constant->IsInBlock());
+  EXPECT_TRUE(other_constant->IsInBlock());
+  EXPECT_TRUE(get->IsInBlock());
+  EXPECT_TRUE(same_get->IsInBlock());
+}
+
+// Values are only reused in the blocks they dominate.
+TEST(GVNTest, GlobalValueNumbering) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  HGraph* graph = new (&allocator) HGraph(&allocator);
+  HBasicBlock* entry = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  HInstruction* first = new (&allocator) HParameterValue(0, Primitive::kPrimInt);
+  entry->AddInstruction(first);
+  HInstruction* second = new (&allocator) HParameterValue(1, Primitive::kPrimInt);
+  entry->AddInstruction(second);
+  HInstruction* add = new (&allocator) HAdd(Primitive::kPrimInt, first, second);
+  entry->AddInstruction(add);
+  HInstruction* equal = new (&allocator) HEqual(first, second);
+  entry->AddInstruction(equal);
+  entry->AddInstruction(new (&allocator) HIf(equal));
+
+  HBasicBlock* then_block = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(then_block);
+  HInstruction* then_add = new (&allocator) HAdd(Primitive::kPrimInt, first, second);
+  then_block->AddInstruction(then_add);
+  HInstruction* then_sub = new (&allocator) HSub(Primitive::kPrimInt, first, second);
+  then_block->AddInstruction(then_sub);
+  then_block->AddInstruction(new (&allocator) HGoto());
+
+  HBasicBlock* else_block = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(else_block);
+  HInstruction* else_add = new (&allocator) HAdd(Primitive::kPrimInt, first, second);
+  else_block->AddInstruction(else_add);
+  HInstruction* else_sub = new (&allocator) HSub(Primitive::kPrimInt, first, second);
+  else_block->AddInstruction(else_sub);
+  else_block->AddInstruction(new (&allocator) HGoto());
+
+  HBasicBlock* join = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(join);
+  HInstruction* join_add = new (&allocator) HAdd(Primitive::kPrimInt, first, second);
+  join->AddInstruction(join_add);
+  HInstruction* join_sub = new (&allocator) HSub(Primitive::kPrimInt, first, second);
+  join->AddInstruction(join_sub);
+  join->AddInstruction(new (&allocator) HReturnVoid());
+
+  HBasicBlock* exit = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(exit);
+  graph->SetExitBlock(exit);
+  exit->AddInstruction(new (&allocator) HExit());
+  entry->AddSuccessor(then_block);
+  entry->AddSuccessor(else_block);
+  then_block->AddSuccessor(join);
+  else_block->AddSuccessor(join);
+  join->AddSuccessor(exit);
+  graph->BuildDominatorTree();
+
+  GlobalValueNumberer(graph).Run();
+  EXPECT_TRUE(add->IsInBlock());
+  EXPECT_FALSE(then_add->IsInBlock());
+  EXPECT_FALSE(else_add->IsInBlock());
+  EXPECT_FALSE(join_add->IsInBlock());
+  // Neither branch dominates the other one, nor the join block.
+  EXPECT_TRUE(then_sub->IsInBlock());
+  EXPECT_TRUE(else_sub->IsInBlock());
+  EXPECT_TRUE(join_sub->IsInBlock());
+  // The condition is left alone.
+  EXPECT_TRUE(equal->IsInBlock());
+}
+
+}  // namespace art
@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "inliner.h"
+
+#include "builder.h"
+#include "class_linker.h"
+#include "dex_instruction-inl.h"
+#include "driver/compiler_driver-inl.h"
+#include "driver/compiler_options.h"
+#include "driver/dex_compilation_unit.h"
+#include "mirror/art_method-inl.h"
+#include "mirror/class_loader.h"
+#include "mirror/dex_cache.h"
+#include "nodes.h"
+#include "scoped_thread_state_change.h"
+#include "ssa_phi_elimination.h"
+#include "thread.h"
+
+namespace art {
+
+static size_t CountDexInstructions(const DexFile::CodeItem& code_item) {
+  size_t count = 0;
+  const uint16_t* code_ptr = code_item.insns_;
+  const uint16_t* code_end = code_item.insns_ + code_item.insns_size_in_code_units_;
+  while (code_ptr < code_end) {
+    code_ptr += Instruction::At(code_ptr)->SizeInCodeUnits();
+    ++count;
+  }
+  return count;
+}
+
+// Returns whether `instruction` is the receiver of the direct call `invoke`, in the graph
+// of its callee.
+static bool IsReceiver(HInstruction* instruction, HInvokeStatic* invoke) {
+  return invoke->GetInvokeType() == kDirect
+      && instruction->IsParameterValue()
+      && instruction->AsParameterValue()->GetIndex() == 0;
+}
+
+void HInliner::Run() {
+  for (HReversePostOrderIterator it(*GetGraph()); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    for (HInstructionIterator instr_it(block->GetInstructions());
+         !instr_it.Done();
+         instr_it.Advance()) {
+      HInstruction* current = instr_it.Current();
+      if (current->IsInvokeStatic()) {
+        TryInline(current->AsInvokeStatic());
+      }
+    }
+  }
+}
+
+bool HInliner::TryInline(HInvokeStatic* invoke) {
+  const uint32_t method_index = invoke->GetIndexInDexCache();
+  const DexFile& dex_file = *outer_compilation_unit_.GetDexFile();
+  const DexFile::CodeItem* code_item;
+  uint16_t class_def_idx;
+  uint32_t callee_method_index;
+  uint32_t access_flags;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<2> hs(soa.Self());
+    Handle<mirror::DexCache> dex_cache(hs.NewHandle(
+        outer_compilation_unit_.GetClassLinker()->FindDexCache(dex_file)));
+    Handle<mirror::ClassLoader> class_loader(hs.NewHandle(
+        soa.Decode<mirror::ClassLoader*>(outer_compilation_unit_.GetClassLoader())));
+    mirror::ArtMethod* resolved_method = compiler_driver_->ResolveMethod(
+        soa, dex_cache, class_loader, &outer_compilation_unit_, method_index,
+        invoke->GetInvokeType());
+
+    if (resolved_method == nullptr) {
+      VLOG(compiler) << "Method cannot be resolved " << PrettyMethod(method_index, dex_file);
+      return false;
+    }
+
+    if (resolved_method->GetDexFile() != &dex_file) {
+      // The graph builder and the dex cache accesses of the caller assume a single dex file.
+      VLOG(compiler) << "Method " << PrettyMethod(method_index, dex_file)
+                     << " is in another dex file";
+      return false;
+    }
+
+    if (resolved_method->IsNative() || resolved_method->IsAbstract()) {
+      VLOG(compiler) << "Method " << PrettyMethod(method_index, dex_file) << " has no code";
+      return false;
+    }
+
+    if (resolved_method->IsSynchronized()) {
+      VLOG(compiler) << "Method " << PrettyMethod(method_index, dex_file) << " is synchronized";
+      return false;
+    }
+
+    mirror::Class* klass = resolved_method->GetDeclaringClass();
+    if (!klass->IsVerified()) {
+      VLOG(compiler) << "Class of " << PrettyMethod(method_index, dex_file)
+                     << " is not verified";
+      return false;
+    }
+
+    // A static call initializes the class of the callee, which we cannot do once inlined.
+    // The class of the caller is being initialized or initialized when the caller runs.
+    if (invoke->GetInvokeType() == kStatic
+        && !klass->IsInitialized()
+        && klass->GetDexClassDefIndex() != outer_compilation_unit_.GetClassDefIndex()) {
+      VLOG(compiler) << "Class of " << PrettyMethod(method_index, dex_file)
+                     << " may need to be initialized";
+      return false;
+    }
+
+    code_item = resolved_method->GetCodeItem();
+    class_def_idx = klass->GetDexClassDefIndex();
+    callee_method_index = resolved_method->GetDexMethodIndex();
+    access_flags = resolved_method->GetAccessFlags();
+  }
+
+  if (callee_method_index == outer_compilation_unit_.GetDexMethodIndex()) {
+    VLOG(compiler) << "Method " << PrettyMethod(method_index, dex_file) << " is recursive";
+    return false;
+  }
+
+  const CompilerOptions& compiler_options = compiler_driver_->GetCompilerOptions();
+  size_t number_of_instructions = CountDexInstructions(*code_item);
+  if (number_of_instructions > compiler_options.GetTinyMethodThreshold()) {
+    VLOG(compiler) << "Method " << PrettyMethod(method_index, dex_file)
+                   << " is too big to inline";
+    return false;
+  }
+  if (number_of_inlined_instructions_ + number_of_instructions
+          > compiler_options.GetSmallMethodThreshold()) {
+    VLOG(compiler) << "Inlining budget exhausted in "
+                   << PrettyMethod(outer_compilation_unit_.GetDexMethodIndex(), dex_file);
+    return false;
+  }
+
+  DexCompilationUnit dex_compilation_unit(
+      nullptr,
+      outer_compilation_unit_.GetClassLoader(),
+      outer_compilation_unit_.GetClassLinker(),
+      dex_file,
+      code_item,
+      class_def_idx,
+      callee_method_index,
+      access_flags,
+      nullptr);
+
+  HGraphBuilder builder(
+      GetGraph()->GetArena(), &dex_compilation_unit, &dex_file, compiler_driver_);
+  HGraph* callee_graph = builder.BuildGraph(*code_item);
+  if (callee_graph == nullptr) {
+    VLOG(compiler) << "Method " << PrettyMethod(method_index, dex_file)
+                   << " could not be built";
+    return false;
+  }
+
+  callee_graph->BuildDominatorTree();
+  callee_graph->TransformToSSA();
+  SsaRedundantPhiElimination(callee_graph).Run();
+  SsaDeadPhiElimination(callee_graph).Run();
+
+  size_t number_of_inlined_instructions = number_of_instructions;
+  if (depth_ + 1 < kMaximumInliningDepth) {
+    HInliner inliner(callee_graph, dex_compilation_unit, compiler_driver_, depth_ + 1);
+    inliner.Run();
+    number_of_inlined_instructions += inliner.GetNumberOfInlinedInstructions();
+  }
+  if (number_of_inlined_instructions_ + number_of_inlined_instructions
+          > compiler_options.GetSmallMethodThreshold()) {
+    VLOG(compiler) << "Inlining budget exhausted in "
+                   << PrettyMethod(outer_compilation_unit_.GetDexMethodIndex(), dex_file);
+    return false;
+  }
+
+  if (!CanInlineGraph(invoke, callee_graph)) {
+    VLOG(compiler) << "Method " << PrettyMethod(method_index, dex_file)
+                   << " could not be inlined";
+    return false;
+  }
+
+  InlineGraph(invoke, callee_graph);
+  number_of_inlined_instructions_ += number_of_inlined_instructions;
+  VLOG(compiler) << "Successfully inlined " << PrettyMethod(method_index, dex_file);
+  return true;
+}
+
+bool HInliner::CanInlineGraph(HInvokeStatic* invoke, HGraph* callee_graph) {
+  // Only inline graphs made of an entry block, a body block and the exit block.
+  const GrowableArray<HBasicBlock*>& blocks = callee_graph->GetReversePostOrder();
+  if (blocks.Size() != 3) {
+    return false;
+  }
+
+  size_t number_of_parameters = 0;
+  for (HInstructionIterator it(callee_graph->GetEntryBlock()->GetInstructions());
+       !it.Done();
+       it.Advance()) {
+    HInstruction* current = it.Current();
+    if (current->IsParameterValue()) {
+      ++number_of_parameters;
+    } else if (!current->IsConstant() && !current->IsGoto()) {
+      return false;
+    }
+  }
+  if (number_of_parameters != invoke->InputCount()) {
+    return false;
+  }
+
+  HBasicBlock* body = blocks.Get(1);
+  DCHECK(body->GetFirstPhi() == nullptr);
+  HInstruction* last = body->GetLastInstruction();
+  if (!last->IsReturn() && !last->IsReturnVoid()) {
+    return false;
+  }
+
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* current = it.Current();
+    if (current->IsNullCheck() && IsReceiver(current->InputAt(0), invoke)) {
+      continue;
+    }
+    if (current->NeedsEnvironment()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HInliner::InlineGraph(HInvokeStatic* invoke, HGraph* callee_graph) {
+  HBasicBlock* caller_block = invoke->GetBlock();
+  HBasicBlock* body = callee_graph->GetReversePostOrder().Get(1);
+
+  // Parameters become the arguments of the invoke. Parameters are in the same
+  // order as the arguments, a long parameter using a single argument.
+  size_t argument_index = 0;
+  for (HInstructionIterator it(callee_graph->GetEntryBlock()->GetInstructions());
+       !it.Done();
+       it.Advance()) {
+    HInstruction* current = it.Current();
+    if (current->IsParameterValue()) {
+      current->ReplaceWith(invoke->InputAt(argument_index++));
+    } else if (current->IsConstant()) {
+      caller_block->MoveInstructionBefore(current, invoke);
+    }
+  }
+
+  HInstruction* receiver = (invoke->GetInvokeType() == kDirect) ? invoke->InputAt(0) : nullptr;
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* current = it.Current();
+    if (current->IsReturn()) {
+      HInstruction* value = current->InputAt(0);
+      body->RemoveInstruction(current);
+      invoke->ReplaceWith(value);
+    } else if (current->IsReturnVoid()) {
+      DCHECK(!invoke->HasUses());
+    } else if (current->IsNullCheck() && current->InputAt(0) == receiver) {
+      // The caller already checked the receiver.
+      current->ReplaceWith(receiver);
+      body->RemoveInstruction(current);
+    } else if (!current->IsTemporary()) {
+      // Temporaries are only used by the baseline compiler.
+      caller_block->MoveInstructionBefore(current, invoke);
+    }
+  }
+
+  caller_block->RemoveInstruction(invoke);
+}
+
+}  // namespace art
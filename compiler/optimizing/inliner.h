@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_INLINER_H_
+#define ART_COMPILER_OPTIMIZING_INLINER_H_
+
+#include "invoke_type.h"
+#include "optimization.h"
+
+namespace art {
+
+class CompilerDriver;
+class DexCompilationUnit;
+
+/**
+ * Optimization pass replacing calls to small static and direct methods by the body of
+ * the callee. Callee graphs are built with HGraphBuilder in the arena of the caller,
+ * transformed to SSA, and recursively inlined up to kMaximumInliningDepth.
+ *
+ * Only callees made of a single basic block and that cannot call into the runtime are
+ * inlined: the code generators do not know about inlined frames, so any instruction
+ * needing an environment would report the wrong method and dex pc. The null check of
+ * the receiver of a direct call is the exception, since the caller already performs it.
+ *
+ * A callee is inlined if it has at most CompilerOptions::GetTinyMethodThreshold() dex
+ * instructions, and as long as the total number of inlined dex instructions stays under
+ * CompilerOptions::GetSmallMethodThreshold().
+ */
+class HInliner : public HOptimization {
+ public:
+  HInliner(HGraph* outer_graph,
+           const DexCompilationUnit& outer_compilation_unit,
+           CompilerDriver* compiler_driver,
+           size_t depth = 0)
+      : HOptimization(outer_graph, kInlinerPassName),
+        outer_compilation_unit_(outer_compilation_unit),
+        compiler_driver_(compiler_driver),
+        depth_(depth),
+        number_of_inlined_instructions_(0) {}
+
+  virtual void Run();
+
+  // Number of dex instructions of the callees inlined by this pass, including the ones
+  // they inlined themselves.
+  size_t GetNumberOfInlinedInstructions() const { return number_of_inlined_instructions_; }
+
+  // Returns whether the SSA graph of the callee of `invoke` has a shape that can be inlined.
+  static bool CanInlineGraph(HInvokeStatic* invoke, HGraph* callee_graph);
+
+  // Replaces `invoke` by the body of `callee_graph`. CanInlineGraph must have returned true.
+  static void InlineGraph(HInvokeStatic* invoke, HGraph* callee_graph);
+
+  static constexpr const char* kInlinerPassName = "inliner";
+
+ private:
+  static constexpr size_t kMaximumInliningDepth = 3;
+
+  // Builds the graph of the callee of `invoke` and inlines it. Returns whether the invoke
+  // was replaced.
+  bool TryInline(HInvokeStatic* invoke);
+
+  const DexCompilationUnit& outer_compilation_unit_;
+  CompilerDriver* const compiler_driver_;
+  const size_t depth_;
+  size_t number_of_inlined_instructions_;
+
+  DISALLOW_COPY_AND_ASSIGN(HInliner);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_INLINER_H_
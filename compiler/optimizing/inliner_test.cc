@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "inliner.h"
+#include "nodes.h"
+#include "utils/arena_allocator.h"
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+// Creates a graph made of an entry, a body and an exit block, with `number_of_parameters`
+// parameters of type `type` in the entry block.
+static HGraph* CreateSingleBlockGraph(ArenaAllocator* allocator,
+                                      size_t number_of_parameters,
+                                      Primitive::Type type,
+                                      HBasicBlock** body) {
+  HGraph* graph = new (allocator) HGraph(allocator);
+  HBasicBlock* entry = new (allocator) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  for (size_t i = 0; i < number_of_parameters; ++i) {
+    entry->AddInstruction(new (allocator) HParameterValue(i, type));
+  }
+  entry->AddInstruction(new (allocator) HGoto());
+
+  *body = new (allocator) HBasicBlock(graph);
+  graph->AddBlock(*body);
+  HBasicBlock* exit = new (allocator) HBasicBlock(graph);
+  graph->AddBlock(exit);
+  graph->SetExitBlock(exit);
+  exit->AddInstruction(new (allocator) HExit());
+  entry->AddSuccessor(*body);
+  (*body)->AddSuccessor(exit);
+  return graph;
+}
+
+static HInstruction* GetParameter(HGraph* graph, size_t index) {
+  HInstruction* parameter = graph->GetEntryBlock()->GetFirstInstruction();
+  for (size_t i = 0; i < index; ++i) {
+    parameter = parameter->GetNext();
+  }
+  DCHECK(parameter->IsParameterValue());
+  return parameter;
+}
+
+// A getter: the null check of the receiver is removed and the field is loaded from the
+// receiver checked by the caller.
+TEST(InlinerTest, InlineGetter) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+
+  HBasicBlock* callee_body;
+  HGraph* callee = CreateSingleBlockGraph(&allocator, 1, Primitive::kPrimNot, &callee_body);
+  HInstruction* this_parameter = GetParameter(callee, 0);
+  HInstruction* callee_null_check = new (&allocator) HNullCheck(this_parameter, 0);
+  callee_body->AddInstruction(callee_null_check);
+  GrowableArray<HInstruction*> locals(&allocator, 1);
+  locals.Add(this_parameter);
+  HEnvironment* environment = new (&allocator) HEnvironment(&allocator, 1);
+  environment->Populate(locals);
+  callee_null_check->SetEnvironment(environment);
+  HInstruction* get = new (&allocator) HInstanceFieldGet(
+      callee_null_check, Primitive::kPrimInt, MemberOffset(8));
+  callee_body->AddInstruction(get);
+  callee_body->AddInstruction(new (&allocator) HReturn(get));
+  callee->BuildDominatorTree();
+
+  HBasicBlock* body;
+  HGraph* graph = CreateSingleBlockGraph(&allocator, 1, Primitive::kPrimNot, &body);
+  HInstruction* null_check = new (&allocator) HNullCheck(GetParameter(graph, 0), 0);
+  body->AddInstruction(null_check);
+  HInvokeStatic* invoke = new (&allocator) HInvokeStatic(
+      &allocator, 1, Primitive::kPrimInt, 0, 0, kDirect);
+  invoke->SetArgumentAt(0, null_check);
+  body->AddInstruction(invoke);
+  HInstruction* add = new (&allocator) HAdd(Primitive::kPrimInt, invoke, invoke);
+  body->AddInstruction(add);
+  body->AddInstruction(new (&allocator) HReturn(add));
+  graph->BuildDominatorTree();
+
+  ASSERT_TRUE(HInliner::CanInlineGraph(invoke, callee));
+  HInliner::InlineGraph(invoke, callee);
+
+  EXPECT_FALSE(invoke->IsInBlock());
+  EXPECT_FALSE(callee_null_check->IsInBlock());
+  EXPECT_EQ(body, get->GetBlock());
+  EXPECT_EQ(null_check->GetNext(), get);
+  EXPECT_EQ(get->GetNext(), add);
+  EXPECT_EQ(null_check, get->InputAt(0));
+  EXPECT_EQ(get, add->InputAt(0));
+  EXPECT_EQ(get, add->InputAt(1));
+  EXPECT_FALSE(this_parameter->HasUses());
+  // The caller null check is only used by the field load.
+  EXPECT_TRUE(null_check->HasOnlyOneUse());
+  EXPECT_TRUE(null_check->GetEnvUses() == nullptr);
+}
+
+// A static method adding a constant to its argument.
+TEST(InlinerTest, InlineStaticWithConstant) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+
+  HBasicBlock* callee_body;
+  HGraph* callee = CreateSingleBlockGraph(&allocator, 1, Primitive::kPrimInt, &callee_body);
+  HInstruction* constant = new (&allocator) HIntConstant(1);
+  callee->GetEntryBlock()->InsertInstructionBefore(
+      constant, callee->GetEntryBlock()->GetLastInstruction());
+  HInstruction* callee_add = new (&allocator) HAdd(
+      Primitive::kPrimInt, GetParameter(callee, 0), constant);
+  callee_body->AddInstruction(callee_add);
+  callee_body->AddInstruction(new (&allocator) HReturn(callee_add));
+  callee->BuildDominatorTree();
+
+  HBasicBlock* body;
+  HGraph* graph = CreateSingleBlockGraph(&allocator, 1, Primitive::kPrimInt, &body);
+  HInstruction* parameter = GetParameter(graph, 0);
+  HInvokeStatic* invoke = new (&allocator) HInvokeStatic(
+      &allocator, 1, Primitive::kPrimInt, 0, 0);
+  invoke->SetArgumentAt(0, parameter);
+  body->AddInstruction(invoke);
+  HInstruction* ret = new (&allocator) HReturn(invoke);
+  body->AddInstruction(ret);
+  graph->BuildDominatorTree();
+
+  ASSERT_TRUE(HInliner::CanInlineGraph(invoke, callee));
+  HInliner::InlineGraph(invoke, callee);
+
+  EXPECT_FALSE(invoke->IsInBlock());
+  EXPECT_EQ(body, constant->GetBlock());
+  EXPECT_EQ(body, callee_add->GetBlock());
+  EXPECT_EQ(body->GetFirstInstruction(), constant);
+  EXPECT_EQ(callee_add, ret->InputAt(0));
+  EXPECT_EQ(parameter, callee_add->InputAt(0));
+  EXPECT_EQ(constant, callee_add->InputAt(1));
+  EXPECT_TRUE(parameter->HasOnlyOneUse());
+  EXPECT_TRUE(callee_add->HasOnlyOneUse());
+}
+
+TEST(InlinerTest, RejectedGraphs) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+
+  HBasicBlock* body;
+  HGraph* graph = CreateSingleBlockGraph(&allocator, 1, Primitive::kPrimNot, &body);
+  HInvokeStatic* invoke = new (&allocator) HInvokeStatic(
+      &allocator, 1, Primitive::kPrimVoid, 0, 0);
+  invoke->SetArgumentAt(0, GetParameter(graph, 0));
+  body->AddInstruction(invoke);
+  body->AddInstruction(new (&allocator) HReturnVoid());
+  graph->BuildDominatorTree();
+
+  // The number of parameters must match the number of arguments.
+  HBasicBlock* callee_body;
+  HGraph* callee = CreateSingleBlockGraph(&allocator, 2, Primitive::kPrimNot, &callee_body);
+  callee_body->AddInstruction(new (&allocator) HReturnVoid());
+  callee->BuildDominatorTree();
+  EXPECT_FALSE(HInliner::CanInlineGraph(invoke, callee));
+
+  // Null checks are only removed for the receiver of direct calls.
+  callee = CreateSingleBlockGraph(&allocator, 1, Primitive::kPrimNot, &callee_body);
+  callee_body->AddInstruction(new (&allocator) HNullCheck(GetParameter(callee, 0), 0));
+  callee_body->AddInstruction(new (&allocator) HReturnVoid());
+  callee->BuildDominatorTree();
+  EXPECT_FALSE(HInliner::CanInlineGraph(invoke, callee));
+
+  // Calls need an environment.
+  callee = CreateSingleBlockGraph(&allocator, 1, Primitive::kPrimNot, &callee_body);
+  HInvokeStatic* nested_invoke = new (&allocator) HInvokeStatic(
+      &allocator, 0, Primitive::kPrimVoid, 0, 0);
+  callee_body->AddInstruction(nested_invoke);
+  callee_body->AddInstruction(new (&allocator) HReturnVoid());
+  callee->BuildDominatorTree();
+  EXPECT_FALSE(HInliner::CanInlineGraph(invoke, callee));
+
+  // Only single block callees are inlined.
+  callee = new (&allocator) HGraph(&allocator);
+  HBasicBlock* entry = new (&allocator) HBasicBlock(callee);
+  callee->AddBlock(entry);
+  callee->SetEntryBlock(entry);
+  HInstruction* parameter = new (&allocator) HParameterValue(0, Primitive::kPrimNot);
+  entry->AddInstruction(parameter);
+  entry->AddInstruction(new (&allocator) HGoto());
+  HBasicBlock* first = new (&allocator) HBasicBlock(callee);
+  callee->AddBlock(first);
+  first->AddInstruction(new (&allocator) HGoto());
+  HBasicBlock* second = new (&allocator) HBasicBlock(callee);
+  callee->AddBlock(second);
+  second->AddInstruction(new (&allocator) HReturnVoid());
+  HBasicBlock* exit = new (&allocator) HBasicBlock(callee);
+  callee->AddBlock(exit);
+  callee->SetExitBlock(exit);
+  exit->AddInstruction(new (&allocator) HExit());
+  entry->AddSuccessor(first);
+  first->AddSuccessor(second);
+  second->AddSuccessor(exit);
+  callee->BuildDominatorTree();
+  EXPECT_FALSE(HInliner::CanInlineGraph(invoke, callee));
+
+  // The same callee without the extra block is inlined.
+  callee = CreateSingleBlockGraph(&allocator, 1, Primitive::kPrimNot, &callee_body);
+  callee_body->AddInstruction(new (&allocator) HReturnVoid());
+  callee->BuildDominatorTree();
+  EXPECT_TRUE(HInliner::CanInlineGraph(invoke, callee));
+}
+
+}  // namespace art
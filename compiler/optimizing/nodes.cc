@@ -305,6 +305,28 @@ void HBasicBlock::InsertInstructionBefore(HInstruction* instruction, HInstructio
   }
   instruction->SetBlock(this);
   instruction->SetId(GetGraph()->GetNextInstructionId());
+  for (size_t i = 0; i < instruction->InputCount(); i++) {
+    instruction->InputAt(i)->AddUseAt(instruction, i);
+  }
+}
+
+void HBasicBlock::MoveInstructionBefore(HInstruction* instruction, HInstruction* cursor) {
+  DCHECK(cursor->AsPhi() == nullptr);
+  DCHECK(instruction->AsPhi() == nullptr);
+  DCHECK_EQ(cursor->GetBlock(), this);
+  DCHECK(!instruction->IsControlFlow());
+  DCHECK_EQ(instruction->GetBlock()->GetGraph()->GetArena(), GetGraph()->GetArena());
+  instruction->GetBlock()->instructions_.RemoveInstruction(instruction);
+  instruction->next_ = cursor;
+  instruction->previous_ = cursor->previous_;
+  cursor->previous_ = instruction;
+  if (GetFirstInstruction() == cursor) {
+    instructions_.first_instruction_ = instruction;
+  } else {
+    instruction->previous_->next_ = instruction;
+  }
+  instruction->SetBlock(this);
+  instruction->SetId(GetGraph()->GetNextInstructionId());
 }
 
 static void Add(HInstructionList* instruction_list,
@@ -337,6 +359,9 @@ static void Remove(HInstructionList* instruction_list,
   for (size_t i = 0; i < instruction->InputCount(); i++) {
     instruction->InputAt(i)->RemoveUser(instruction, i);
   }
+  if (instruction->HasEnvironment()) {
+    instruction->GetEnvironment()->RemoveAsUserOfAllInputs();
+  }
 }
 
 void HBasicBlock::RemoveInstruction(HInstruction* instruction) {
@@ -363,6 +388,32 @@ void HInstruction::RemoveUser(HInstruction* user, size_t input_index) {
   }
 }
 
+void HInstruction::RemoveEnvironmentUser(HEnvironment* user, size_t input_index) {
+  HUseListNode<HEnvironment>* previous = nullptr;
+  HUseListNode<HEnvironment>* current = env_uses_;
+  while (current != nullptr) {
+    if (current->GetUser() == user && current->GetIndex() == input_index) {
+      if (previous == nullptr) {
+        env_uses_ = current->GetTail();
+      } else {
+        previous->SetTail(current->GetTail());
+      }
+      return;
+    }
+    previous = current;
+    current = current->GetTail();
+  }
+}
+
+void HEnvironment::RemoveAsUserOfAllInputs() {
+  for (size_t i = 0, e = vregs_.Size(); i < e; ++i) {
+    HInstruction* instruction = vregs_.Get(i);
+    if (instruction != nullptr) {
+      instruction->RemoveEnvironmentUser(this, i);
+    }
+  }
+}
+
 void HInstructionList::AddInstruction(HInstruction* instruction) {
   if (first_instruction_ == nullptr) {
     DCHECK(last_instruction_ == nullptr);
@@ -436,6 +487,12 @@ void HGraphVisitor::VisitInsertionOrder() {
   }
 }
 
+void HGraphVisitor::VisitReversePostOrder() {
+  for (HReversePostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    VisitBasicBlock(it.Current());
+  }
+}
+
 void HGraphVisitor::VisitBasicBlock(HBasicBlock* block) {
   for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
     it.Current()->Accept(this);
@@ -464,4 +521,95 @@ bool HCondition::NeedsMaterialization() const {
   return false;
 }
 
+bool HInstruction::Equals(HInstruction* other) const {
+  if (!CanBeMoved() || !other->CanBeMoved()) return false;
+  if (GetKind() != other->GetKind()) return false;
+  if (GetType() != other->GetType()) return false;
+  if (InputCount() != other->InputCount()) return false;
+  for (size_t i = 0, e = InputCount(); i < e; ++i) {
+    if (InputAt(i) != other->InputAt(i)) return false;
+  }
+  return InstructionDataEquals(other);
+}
+
+HConstant* HBinaryOperation::TryStaticEvaluation(ArenaAllocator* allocator) {
+  HInstruction* left = GetLeft();
+  HInstruction* right = GetRight();
+  if (left->IsIntConstant() && right->IsIntConstant()) {
+    int32_t value = Evaluate(left->AsIntConstant()->GetValue(),
+                             right->AsIntConstant()->GetValue());
+    return new (allocator) HIntConstant(value);
+  } else if (left->IsLongConstant() && right->IsLongConstant()) {
+    int64_t value = Evaluate(left->AsLongConstant()->GetValue(),
+                             right->AsLongConstant()->GetValue());
+    if (GetResultType() == Primitive::kPrimLong) {
+      return new (allocator) HLongConstant(value);
+    }
+    // Comparisons of longs produce an int or a boolean.
+    return new (allocator) HIntConstant(static_cast<int32_t>(value));
+  }
+  return nullptr;
+}
+
+// A constant division by zero is left in place, the HDivZeroCheck in front of it throws.
+static bool IsZeroDivisor(HInstruction* divisor) {
+  return (divisor->IsIntConstant() && divisor->AsIntConstant()->GetValue() == 0)
+      || (divisor->IsLongConstant() && divisor->AsLongConstant()->GetValue() == 0);
+}
+
+HConstant* HDiv::TryStaticEvaluation(ArenaAllocator* allocator) {
+  return IsZeroDivisor(GetRight()) ? nullptr : HBinaryOperation::TryStaticEvaluation(allocator);
+}
+
+HConstant* HRem::TryStaticEvaluation(ArenaAllocator* allocator) {
+  return IsZeroDivisor(GetRight()) ? nullptr : HBinaryOperation::TryStaticEvaluation(allocator);
+}
+
+HConstant* HNot::TryStaticEvaluation(ArenaAllocator* allocator) {
+  HInstruction* input = InputAt(0);
+  if (input->IsIntConstant()) {
+    // Same as the code generators, the input is a boolean.
+    return new (allocator) HIntConstant(input->AsIntConstant()->GetValue() ^ 1);
+  }
+  return nullptr;
+}
+
+HConstant* HNeg::TryStaticEvaluation(ArenaAllocator* allocator) {
+  HInstruction* input = InputAt(0);
+  if (input->IsIntConstant()) {
+    uint32_t value = static_cast<uint32_t>(input->AsIntConstant()->GetValue());
+    return new (allocator) HIntConstant(static_cast<int32_t>(-value));
+  } else if (input->IsLongConstant()) {
+    uint64_t value = static_cast<uint64_t>(input->AsLongConstant()->GetValue());
+    return new (allocator) HLongConstant(static_cast<int64_t>(-value));
+  }
+  return nullptr;
+}
+
+HConstant* HTypeConversion::TryStaticEvaluation(ArenaAllocator* allocator) {
+  HInstruction* input = InputAt(0);
+  int64_t value;
+  if (input->IsIntConstant()) {
+    value = input->AsIntConstant()->GetValue();
+  } else if (input->IsLongConstant()) {
+    value = input->AsLongConstant()->GetValue();
+  } else {
+    return nullptr;
+  }
+  switch (GetResultType()) {
+    case Primitive::kPrimByte:
+      return new (allocator) HIntConstant(static_cast<int8_t>(value));
+    case Primitive::kPrimShort:
+      return new (allocator) HIntConstant(static_cast<int16_t>(value));
+    case Primitive::kPrimChar:
+      return new (allocator) HIntConstant(static_cast<uint16_t>(value));
+    case Primitive::kPrimInt:
+      return new (allocator) HIntConstant(static_cast<int32_t>(value));
+    case Primitive::kPrimLong:
+      return new (allocator) HLongConstant(value);
+    default:
+      return nullptr;
+  }
+}
+
 }  // namespace art
@@ -17,6 +17,7 @@
 #ifndef ART_COMPILER_OPTIMIZING_NODES_H_
 #define ART_COMPILER_OPTIMIZING_NODES_H_
 
+#include "invoke_type.h"
 #include "locations.h"
 #include "offsets.h"
 #include "primitive.h"
@@ -40,6 +41,10 @@ static const int kDefaultNumberOfSuccessors = 2;
 static const int kDefaultNumberOfPredecessors = 2;
 static const int kDefaultNumberOfBackEdges = 1;
 
+// Masks applied to the distance of int and long shifts.
+static const int kMaxIntShiftValue = 0x1f;
+static const int kMaxLongShiftValue = 0x3f;
+
 enum IfCondition {
   kCondEQ,
   kCondNE,
@@ -352,6 +357,9 @@ class HBasicBlock : public ArenaObject {
   void AddInstruction(HInstruction* instruction);
   void RemoveInstruction(HInstruction* instruction);
   void InsertInstructionBefore(HInstruction* instruction, HInstruction* cursor);
+  // Moves `instruction` from its current block, possibly of another graph sharing the
+  // same arena, to this block before `cursor`. Uses of and by `instruction` are kept.
+  void MoveInstructionBefore(HInstruction* instruction, HInstruction* cursor);
   void AddPhi(HPhi* phi);
   void RemovePhi(HPhi* phi);
 
@@ -442,7 +450,20 @@ class HBasicBlock : public ArenaObject {
   M(ArrayLength)                                           \
   M(BoundsCheck)                                           \
   M(NullCheck)                                             \
+  M(DivZeroCheck)                                          \
   M(Temporary)                                             \
+  M(Mul)                                                   \
+  M(Div)                                                   \
+  M(Rem)                                                   \
+  M(And)                                                   \
+  M(Or)                                                    \
+  M(Xor)                                                   \
+  M(Shl)                                                   \
+  M(Shr)                                                   \
+  M(UShr)                                                  \
+  M(Neg)                                                   \
+  M(TypeConversion)                                        \
+  M(InvokeVirtual)                                         \
 
 #define FOR_EACH_INSTRUCTION(M)                            \
   FOR_EACH_CONCRETE_INSTRUCTION(M)                         \
@@ -452,10 +473,11 @@ class HBasicBlock : public ArenaObject {
 FOR_EACH_INSTRUCTION(FORWARD_DECLARATION)
 #undef FORWARD_DECLARATION
 
-#define DECLARE_INSTRUCTION(type)                          \
-  virtual const char* DebugName() const { return #type; }  \
-  virtual H##type* As##type() { return this; }             \
-  virtual void Accept(HGraphVisitor* visitor)              \
+#define DECLARE_INSTRUCTION(type)                             \
+  virtual InstructionKind GetKind() const { return k##type; } \
+  virtual const char* DebugName() const { return #type; }     \
+  virtual H##type* As##type() { return this; }                \
+  virtual void Accept(HGraphVisitor* visitor)                 \
 
 template <typename T>
 class HUseListNode : public ArenaObject {
@@ -494,6 +516,12 @@ class HInstruction : public ArenaObject {
 
   virtual ~HInstruction() {}
 
+#define DECLARE_KIND(type) k##type,
+  enum InstructionKind {
+    FOR_EACH_INSTRUCTION(DECLARE_KIND)
+  };
+#undef DECLARE_KIND
+
   HInstruction* GetNext() const { return next_; }
   HInstruction* GetPrevious() const { return previous_; }
 
@@ -506,6 +534,7 @@ class HInstruction : public ArenaObject {
   virtual HInstruction* InputAt(size_t i) const = 0;
 
   virtual void Accept(HGraphVisitor* visitor) = 0;
+  virtual InstructionKind GetKind() const = 0;
   virtual const char* DebugName() const = 0;
 
   virtual Primitive::Type GetType() const { return Primitive::kPrimVoid; }
@@ -524,6 +553,7 @@ class HInstruction : public ArenaObject {
   }
 
   void RemoveUser(HInstruction* user, size_t index);
+  void RemoveEnvironmentUser(HEnvironment* user, size_t index);
 
   HUseListNode<HInstruction>* GetUses() const { return uses_; }
   HUseListNode<HEnvironment>* GetEnvUses() const { return env_uses_; }
@@ -562,6 +592,32 @@ class HInstruction : public ArenaObject {
     return uses_ != nullptr && uses_->GetTail() == nullptr;
   }
 
+  // Returns whether the value of this instruction only depends on its inputs and on the data
+  // compared by `InstructionDataEquals`: the instruction does not read or write memory that
+  // may change, cannot throw and does not need an environment. Such an instruction can be
+  // removed when it has no uses, and be replaced by an equal instruction dominating it.
+  virtual bool CanBeMoved() const { return false; }
+
+  // Returns whether the data of this instruction, excluding its inputs, is the same as the
+  // data of `other`. Only called when both instructions have the same kind.
+  virtual bool InstructionDataEquals(HInstruction* other) const { return false; }
+
+  // Returns whether `other` computes the same value as this instruction, that is both can be
+  // moved, have the same kind, type and inputs, and their data is the same.
+  bool Equals(HInstruction* other) const;
+
+  virtual size_t ComputeHashCode() const {
+    size_t result = GetKind();
+    for (size_t i = 0, e = InputCount(); i < e; ++i) {
+      result = (result * 31) + InputAt(i)->GetId();
+    }
+    return result;
+  }
+
+  // Returns a new constant, not yet added to the graph, holding the value of this instruction
+  // if it can be computed at compile time. Returns null otherwise.
+  virtual HConstant* TryStaticEvaluation(ArenaAllocator* allocator) { return nullptr; }
+
 #define INSTRUCTION_TYPE_CHECK(type)                                           \
   bool Is##type() { return (As##type() != nullptr); }                          \
   virtual H##type* As##type() { return nullptr; }
@@ -663,6 +719,10 @@ class HEnvironment : public ArenaObject {
     return &vregs_;
   }
 
+  // Removes this environment from the environment uses of the instructions it contains,
+  // used when the instruction owning the environment is removed from the graph.
+  void RemoveAsUserOfAllInputs();
+
  private:
   GrowableArray<HInstruction*> vregs_;
 
@@ -909,6 +969,15 @@ class HBinaryOperation : public HExpression<2> {
 
   virtual bool IsCommutative() { return false; }
 
+  virtual bool CanBeMoved() const { return true; }
+  virtual bool InstructionDataEquals(HInstruction* other) const { return true; }
+
+  // Apply this operation to `x` and `y`. Arithmetic wraps around on overflow, as in Java.
+  virtual int32_t Evaluate(int32_t x, int32_t y) const = 0;
+  virtual int64_t Evaluate(int64_t x, int64_t y) const = 0;
+
+  virtual HConstant* TryStaticEvaluation(ArenaAllocator* allocator);
+
  private:
   DISALLOW_COPY_AND_ASSIGN(HBinaryOperation);
 };
@@ -935,6 +1004,9 @@ class HEqual : public HCondition {
   HEqual(HInstruction* first, HInstruction* second)
       : HCondition(first, second) {}
 
+  virtual int32_t Evaluate(int32_t x, int32_t y) const { return x == y; }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const { return x == y; }
+
   DECLARE_INSTRUCTION(Equal);
 
   virtual IfCondition GetCondition() const {
@@ -950,6 +1022,9 @@ class HNotEqual : public HCondition {
   HNotEqual(HInstruction* first, HInstruction* second)
       : HCondition(first, second) {}
 
+  virtual int32_t Evaluate(int32_t x, int32_t y) const { return x != y; }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const { return x != y; }
+
   DECLARE_INSTRUCTION(NotEqual);
 
   virtual IfCondition GetCondition() const {
@@ -965,6 +1040,9 @@ class HLessThan : public HCondition {
   HLessThan(HInstruction* first, HInstruction* second)
       : HCondition(first, second) {}
 
+  virtual int32_t Evaluate(int32_t x, int32_t y) const { return x < y; }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const { return x < y; }
+
   DECLARE_INSTRUCTION(LessThan);
 
   virtual IfCondition GetCondition() const {
@@ -980,6 +1058,9 @@ class HLessThanOrEqual : public HCondition {
   HLessThanOrEqual(HInstruction* first, HInstruction* second)
       : HCondition(first, second) {}
 
+  virtual int32_t Evaluate(int32_t x, int32_t y) const { return x <= y; }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const { return x <= y; }
+
   DECLARE_INSTRUCTION(LessThanOrEqual);
 
   virtual IfCondition GetCondition() const {
@@ -995,6 +1076,9 @@ class HGreaterThan : public HCondition {
   HGreaterThan(HInstruction* first, HInstruction* second)
       : HCondition(first, second) {}
 
+  virtual int32_t Evaluate(int32_t x, int32_t y) const { return x > y; }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const { return x > y; }
+
   DECLARE_INSTRUCTION(GreaterThan);
 
   virtual IfCondition GetCondition() const {
@@ -1010,6 +1094,9 @@ class HGreaterThanOrEqual : public HCondition {
   HGreaterThanOrEqual(HInstruction* first, HInstruction* second)
       : HCondition(first, second) {}
 
+  virtual int32_t Evaluate(int32_t x, int32_t y) const { return x >= y; }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const { return x >= y; }
+
   DECLARE_INSTRUCTION(GreaterThanOrEqual);
 
   virtual IfCondition GetCondition() const {
@@ -1031,6 +1118,13 @@ class HCompare : public HBinaryOperation {
     DCHECK_EQ(type, second->GetType());
   }
 
+  virtual int32_t Evaluate(int32_t x, int32_t y) const {
+    return x == y ? 0 : (x > y ? 1 : -1);
+  }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const {
+    return x == y ? 0 : (x > y ? 1 : -1);
+  }
+
   DECLARE_INSTRUCTION(Compare);
 
  private:
@@ -1089,6 +1183,8 @@ class HConstant : public HExpression<0> {
  public:
   explicit HConstant(Primitive::Type type) : HExpression(type) {}
 
+  virtual bool CanBeMoved() const { return true; }
+
   DECLARE_INSTRUCTION(Constant);
 
  private:
@@ -1103,6 +1199,12 @@ class HIntConstant : public HConstant {
 
   int32_t GetValue() const { return value_; }
 
+  virtual bool InstructionDataEquals(HInstruction* other) const {
+    return other->AsIntConstant()->value_ == value_;
+  }
+
+  virtual size_t ComputeHashCode() const { return GetValue(); }
+
   DECLARE_INSTRUCTION(IntConstant);
 
  private:
@@ -1117,6 +1219,12 @@ class HLongConstant : public HConstant {
 
   int64_t GetValue() const { return value_; }
 
+  virtual bool InstructionDataEquals(HInstruction* other) const {
+    return other->AsLongConstant()->value_ == value_;
+  }
+
+  virtual size_t ComputeHashCode() const { return static_cast<size_t>(GetValue()); }
+
   DECLARE_INSTRUCTION(LongConstant);
 
  private:
@@ -1171,20 +1279,49 @@ class HInvokeStatic : public HInvoke {
                 uint32_t number_of_arguments,
                 Primitive::Type return_type,
                 uint32_t dex_pc,
-                uint32_t index_in_dex_cache)
+                uint32_t index_in_dex_cache,
+                InvokeType invoke_type = kStatic)
       : HInvoke(arena, number_of_arguments, return_type, dex_pc),
-        index_in_dex_cache_(index_in_dex_cache) {}
+        index_in_dex_cache_(index_in_dex_cache),
+        invoke_type_(invoke_type) {}
 
   uint32_t GetIndexInDexCache() const { return index_in_dex_cache_; }
 
+  // Either kStatic or kDirect, direct calls are dispatched like static calls and have
+  // the null checked receiver as first argument.
+  InvokeType GetInvokeType() const { return invoke_type_; }
+
   DECLARE_INSTRUCTION(InvokeStatic);
 
  private:
   const uint32_t index_in_dex_cache_;
+  const InvokeType invoke_type_;
 
   DISALLOW_COPY_AND_ASSIGN(HInvokeStatic);
 };
 
+class HInvokeVirtual : public HInvoke {
+ public:
+  HInvokeVirtual(ArenaAllocator* arena,
+                 uint32_t number_of_arguments,
+                 Primitive::Type return_type,
+                 uint32_t dex_pc,
+                 uint32_t vtable_index)
+      : HInvoke(arena, number_of_arguments, return_type, dex_pc),
+        vtable_index_(vtable_index) {}
+
+  // Index of the target in the embedded vtable of the class of the receiver,
+  // which is the first argument.
+  uint32_t GetVTableIndex() const { return vtable_index_; }
+
+  DECLARE_INSTRUCTION(InvokeVirtual);
+
+ private:
+  const uint32_t vtable_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(HInvokeVirtual);
+};
+
 class HNewInstance : public HExpression<0> {
  public:
   HNewInstance(uint32_t dex_pc, uint16_t type_index) : HExpression(Primitive::kPrimNot),
@@ -1212,6 +1349,13 @@ class HAdd : public HBinaryOperation {
 
   virtual bool IsCommutative() { return true; }
 
+  virtual int32_t Evaluate(int32_t x, int32_t y) const {
+    return static_cast<int32_t>(static_cast<uint32_t>(x) + static_cast<uint32_t>(y));
+  }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const {
+    return static_cast<int64_t>(static_cast<uint64_t>(x) + static_cast<uint64_t>(y));
+  }
+
   DECLARE_INSTRUCTION(Add);
 
  private:
@@ -1225,12 +1369,186 @@ class HSub : public HBinaryOperation {
 
   virtual bool IsCommutative() { return false; }
 
+  virtual int32_t Evaluate(int32_t x, int32_t y) const {
+    return static_cast<int32_t>(static_cast<uint32_t>(x) - static_cast<uint32_t>(y));
+  }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const {
+    return static_cast<int64_t>(static_cast<uint64_t>(x) - static_cast<uint64_t>(y));
+  }
+
   DECLARE_INSTRUCTION(Sub);
 
  private:
   DISALLOW_COPY_AND_ASSIGN(HSub);
 };
 
+class HMul : public HBinaryOperation {
+ public:
+  HMul(Primitive::Type result_type, HInstruction* left, HInstruction* right)
+      : HBinaryOperation(result_type, left, right) {}
+
+  virtual bool IsCommutative() { return true; }
+
+  virtual int32_t Evaluate(int32_t x, int32_t y) const {
+    return static_cast<int32_t>(static_cast<uint32_t>(x) * static_cast<uint32_t>(y));
+  }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const {
+    return static_cast<int64_t>(static_cast<uint64_t>(x) * static_cast<uint64_t>(y));
+  }
+
+  DECLARE_INSTRUCTION(Mul);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HMul);
+};
+
+// Integral division. The divisor has been checked against zero by an HDivZeroCheck,
+// and MIN_VALUE / -1 wraps around to MIN_VALUE, as in Java.
+class HDiv : public HBinaryOperation {
+ public:
+  HDiv(Primitive::Type result_type, HInstruction* left, HInstruction* right, uint32_t dex_pc)
+      : HBinaryOperation(result_type, left, right), dex_pc_(dex_pc) {}
+
+  virtual int32_t Evaluate(int32_t x, int32_t y) const {
+    // Negate as unsigned so that MIN_VALUE / -1 does not trap.
+    return (y == -1) ? static_cast<int32_t>(-static_cast<uint32_t>(x)) : x / y;
+  }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const {
+    return (y == -1) ? static_cast<int64_t>(-static_cast<uint64_t>(x)) : x / y;
+  }
+
+  virtual HConstant* TryStaticEvaluation(ArenaAllocator* allocator);
+
+  uint32_t GetDexPc() const { return dex_pc_; }
+
+  DECLARE_INSTRUCTION(Div);
+
+ private:
+  const uint32_t dex_pc_;
+
+  DISALLOW_COPY_AND_ASSIGN(HDiv);
+};
+
+// Integral remainder, with the sign of the dividend. MIN_VALUE % -1 is 0, as in Java.
+class HRem : public HBinaryOperation {
+ public:
+  HRem(Primitive::Type result_type, HInstruction* left, HInstruction* right, uint32_t dex_pc)
+      : HBinaryOperation(result_type, left, right), dex_pc_(dex_pc) {}
+
+  virtual int32_t Evaluate(int32_t x, int32_t y) const { return (y == -1) ? 0 : x % y; }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const { return (y == -1) ? 0 : x % y; }
+
+  virtual HConstant* TryStaticEvaluation(ArenaAllocator* allocator);
+
+  uint32_t GetDexPc() const { return dex_pc_; }
+
+  DECLARE_INSTRUCTION(Rem);
+
+ private:
+  const uint32_t dex_pc_;
+
+  DISALLOW_COPY_AND_ASSIGN(HRem);
+};
+
+class HAnd : public HBinaryOperation {
+ public:
+  HAnd(Primitive::Type result_type, HInstruction* left, HInstruction* right)
+      : HBinaryOperation(result_type, left, right) {}
+
+  virtual bool IsCommutative() { return true; }
+
+  virtual int32_t Evaluate(int32_t x, int32_t y) const { return x & y; }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const { return x & y; }
+
+  DECLARE_INSTRUCTION(And);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HAnd);
+};
+
+class HOr : public HBinaryOperation {
+ public:
+  HOr(Primitive::Type result_type, HInstruction* left, HInstruction* right)
+      : HBinaryOperation(result_type, left, right) {}
+
+  virtual bool IsCommutative() { return true; }
+
+  virtual int32_t Evaluate(int32_t x, int32_t y) const { return x | y; }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const { return x | y; }
+
+  DECLARE_INSTRUCTION(Or);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HOr);
+};
+
+class HXor : public HBinaryOperation {
+ public:
+  HXor(Primitive::Type result_type, HInstruction* left, HInstruction* right)
+      : HBinaryOperation(result_type, left, right) {}
+
+  virtual bool IsCommutative() { return true; }
+
+  virtual int32_t Evaluate(int32_t x, int32_t y) const { return x ^ y; }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const { return x ^ y; }
+
+  DECLARE_INSTRUCTION(Xor);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HXor);
+};
+
+// Shifts only use the low 5 bits (int) or 6 bits (long) of the distance, as in Java.
+class HShl : public HBinaryOperation {
+ public:
+  HShl(Primitive::Type result_type, HInstruction* left, HInstruction* right)
+      : HBinaryOperation(result_type, left, right) {}
+
+  virtual int32_t Evaluate(int32_t x, int32_t y) const {
+    return static_cast<int32_t>(static_cast<uint32_t>(x) << (y & kMaxIntShiftValue));
+  }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const {
+    return static_cast<int64_t>(static_cast<uint64_t>(x) << (y & kMaxLongShiftValue));
+  }
+
+  DECLARE_INSTRUCTION(Shl);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HShl);
+};
+
+class HShr : public HBinaryOperation {
+ public:
+  HShr(Primitive::Type result_type, HInstruction* left, HInstruction* right)
+      : HBinaryOperation(result_type, left, right) {}
+
+  virtual int32_t Evaluate(int32_t x, int32_t y) const { return x >> (y & kMaxIntShiftValue); }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const { return x >> (y & kMaxLongShiftValue); }
+
+  DECLARE_INSTRUCTION(Shr);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HShr);
+};
+
+class HUShr : public HBinaryOperation {
+ public:
+  HUShr(Primitive::Type result_type, HInstruction* left, HInstruction* right)
+      : HBinaryOperation(result_type, left, right) {}
+
+  virtual int32_t Evaluate(int32_t x, int32_t y) const {
+    return static_cast<int32_t>(static_cast<uint32_t>(x) >> (y & kMaxIntShiftValue));
+  }
+  virtual int64_t Evaluate(int64_t x, int64_t y) const {
+    return static_cast<int64_t>(static_cast<uint64_t>(x) >> (y & kMaxLongShiftValue));
+  }
+
+  DECLARE_INSTRUCTION(UShr);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HUShr);
+};
+
 // The value of a parameter in this method. Its location depends on
 // the calling convention.
 class HParameterValue : public HExpression<0> {
@@ -1256,12 +1574,59 @@ class HNot : public HExpression<1> {
     SetRawInputAt(0, input);
   }
 
+  virtual bool CanBeMoved() const { return true; }
+  virtual bool InstructionDataEquals(HInstruction* other) const { return true; }
+
+  virtual HConstant* TryStaticEvaluation(ArenaAllocator* allocator);
+
   DECLARE_INSTRUCTION(Not);
 
  private:
   DISALLOW_COPY_AND_ASSIGN(HNot);
 };
 
+class HNeg : public HExpression<1> {
+ public:
+  HNeg(Primitive::Type result_type, HInstruction* input) : HExpression(result_type) {
+    SetRawInputAt(0, input);
+  }
+
+  virtual bool CanBeMoved() const { return true; }
+  virtual bool InstructionDataEquals(HInstruction* other) const { return true; }
+
+  virtual HConstant* TryStaticEvaluation(ArenaAllocator* allocator);
+
+  DECLARE_INSTRUCTION(Neg);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HNeg);
+};
+
+// Conversion between integral types: int-to-long, long-to-int, and the
+// narrowing int-to-byte, int-to-short and int-to-char.
+class HTypeConversion : public HExpression<1> {
+ public:
+  HTypeConversion(Primitive::Type result_type, HInstruction* input)
+      : HExpression(result_type) {
+    SetRawInputAt(0, input);
+  }
+
+  Primitive::Type GetInputType() const { return InputAt(0)->GetType(); }
+  Primitive::Type GetResultType() const { return GetType(); }
+
+  virtual bool CanBeMoved() const { return true; }
+  virtual bool InstructionDataEquals(HInstruction* other) const {
+    return other->GetType() == GetType();
+  }
+
+  virtual HConstant* TryStaticEvaluation(ArenaAllocator* allocator);
+
+  DECLARE_INSTRUCTION(TypeConversion);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HTypeConversion);
+};
+
 class HPhi : public HInstruction {
  public:
   HPhi(ArenaAllocator* arena, uint32_t reg_number, size_t number_of_inputs, Primitive::Type type)
@@ -1321,6 +1686,27 @@ class HNullCheck : public HExpression<1> {
   DISALLOW_COPY_AND_ASSIGN(HNullCheck);
 };
 
+// Throws an ArithmeticException if the divisor of an HDiv or HRem is zero.
+class HDivZeroCheck : public HExpression<1> {
+ public:
+  HDivZeroCheck(HInstruction* value, uint32_t dex_pc)
+      : HExpression(value->GetType()), dex_pc_(dex_pc) {
+    DCHECK(value->GetType() == Primitive::kPrimInt || value->GetType() == Primitive::kPrimLong);
+    SetRawInputAt(0, value);
+  }
+
+  virtual bool NeedsEnvironment() const { return true; }
+
+  uint32_t GetDexPc() const { return dex_pc_; }
+
+  DECLARE_INSTRUCTION(DivZeroCheck);
+
+ private:
+  const uint32_t dex_pc_;
+
+  DISALLOW_COPY_AND_ASSIGN(HDivZeroCheck);
+};
+
 class FieldInfo : public ValueObject {
  public:
   explicit FieldInfo(MemberOffset field_offset)
@@ -1418,6 +1804,10 @@ class HArrayLength : public HExpression<1> {
     SetRawInputAt(0, array);
   }
 
+  // The length of an array never changes, and the input has already been null checked.
+  virtual bool CanBeMoved() const { return true; }
+  virtual bool InstructionDataEquals(HInstruction* other) const { return true; }
+
   DECLARE_INSTRUCTION(ArrayLength);
 
  private:
@@ -1557,6 +1947,7 @@ class HGraphVisitor : public ValueObject {
   virtual void VisitBasicBlock(HBasicBlock* block);
 
   void VisitInsertionOrder();
+  void VisitReversePostOrder();
 
   HGraph* GetGraph() const { return graph_; }
 
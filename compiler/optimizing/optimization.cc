@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "optimization.h"
+
+namespace art {
+
+void HOptimization::Execute(HGraphVisualizer* visualizer) {
+  Run();
+  visualizer->DumpGraph(pass_name_);
+  if (kIsDebugBuild) {
+    Check();
+  }
+}
+
+static void CheckInstruction(HInstruction* instruction, HBasicBlock* block, const char* pass_name) {
+  CHECK_EQ(instruction->GetBlock(), block)
+      << instruction->DebugName() << " " << instruction->GetId() << " after " << pass_name;
+  for (size_t i = 0, e = instruction->InputCount(); i < e; ++i) {
+    HInstruction* input = instruction->InputAt(i);
+    CHECK(input->IsInBlock())
+        << instruction->DebugName() << " " << instruction->GetId() << " uses removed "
+        << input->DebugName() << " " << input->GetId() << " after " << pass_name;
+    bool found = false;
+    for (HUseIterator<HInstruction> it(input->GetUses()); !it.Done(); it.Advance()) {
+      HUseListNode<HInstruction>* use = it.Current();
+      if (use->GetUser() == instruction && use->GetIndex() == i) {
+        found = true;
+        break;
+      }
+    }
+    CHECK(found) << instruction->DebugName() << " " << instruction->GetId()
+                 << " is not a user of its input " << i << " after " << pass_name;
+  }
+}
+
+void HOptimization::Check() const {
+  for (HReversePostOrderIterator it(*GetGraph()); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    for (HInstructionIterator inst_it(block->GetPhis()); !inst_it.Done(); inst_it.Advance()) {
+      CheckInstruction(inst_it.Current(), block, pass_name_);
+    }
+    for (HInstructionIterator inst_it(block->GetInstructions()); !inst_it.Done();
+         inst_it.Advance()) {
+      CheckInstruction(inst_it.Current(), block, pass_name_);
+    }
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_OPTIMIZATION_H_
+#define ART_COMPILER_OPTIMIZING_OPTIMIZATION_H_
+
+#include "graph_visualizer.h"
+#include "nodes.h"
+
+namespace art {
+
+/**
+ * Abstraction to implement an optimization pass over a graph in SSA form. Passes are
+ * visitors of the graph, so that they can dispatch on the instructions they transform.
+ */
+class HOptimization : public HGraphVisitor {
+ public:
+  HOptimization(HGraph* graph, const char* pass_name)
+      : HGraphVisitor(graph), pass_name_(pass_name) {}
+
+  virtual ~HOptimization() {}
+
+  const char* GetPassName() const { return pass_name_; }
+
+  // Performs the transformation on the graph.
+  virtual void Run() = 0;
+
+  // Runs the pass, dumps the resulting graph to `visualizer` and, in debug builds,
+  // checks that the graph is still consistent.
+  void Execute(HGraphVisualizer* visualizer);
+
+ private:
+  // Verifies that each instruction is in the block it claims to be in and that the use
+  // lists of its inputs reference it.
+  void Check() const;
+
+  const char* const pass_name_;
+
+  DISALLOW_COPY_AND_ASSIGN(HOptimization);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_OPTIMIZATION_H_
@@ -20,9 +20,13 @@
 #include "builder.h"
 #include "code_generator.h"
 #include "compilers.h"
+#include "constant_folding.h"
+#include "dead_code_elimination.h"
 #include "driver/compiler_driver.h"
 #include "driver/dex_compilation_unit.h"
 #include "graph_visualizer.h"
+#include "gvn.h"
+#include "inliner.h"
 #include "nodes.h"
 #include "register_allocator.h"
 #include "ssa_phi_elimination.h"
@@ -65,6 +69,27 @@ static bool kIsVisualizerEnabled = false;
  */
 static const char* kStringFilter = "";
 
+static void RunOptimizations(HGraph* graph,
+                             const DexCompilationUnit& dex_compilation_unit,
+                             CompilerDriver* compiler_driver,
+                             HGraphVisualizer* visualizer) {
+  HInliner inliner(graph, dex_compilation_unit, compiler_driver);
+  HConstantFolding constant_folding(graph);
+  HDeadCodeElimination dead_code_elimination(graph);
+  GlobalValueNumberer global_value_numberer(graph);
+
+  HOptimization* optimizations[] = {
+    &inliner,
+    &constant_folding,
+    &dead_code_elimination,
+    &global_value_numberer,
+  };
+
+  for (size_t i = 0; i < arraysize(optimizations); ++i) {
+    optimizations[i]->Execute(visualizer);
+  }
+}
+
 OptimizingCompiler::OptimizingCompiler(CompilerDriver* driver) : QuickCompiler(driver) {
   if (kIsVisualizerEnabled) {
     visualizer_output_.reset(new std::ofstream("art.cfg"));
@@ -101,8 +126,7 @@ CompiledMethod* OptimizingCompiler::TryCompile(const DexFile::CodeItem* code_ite
   bool shouldOptimize =
       dex_compilation_unit.GetSymbol().find("00024reg_00024") != std::string::npos;
 
-  ArenaPool pool;
-  ArenaAllocator arena(&pool);
+  ArenaAllocator arena(GetCompilerDriver()->GetArenaPool());
   HGraphBuilder builder(&arena, &dex_compilation_unit, &dex_file, GetCompilerDriver());
 
   HGraph* graph = builder.BuildGraph(*code_item);
@@ -136,6 +160,8 @@ CompiledMethod* OptimizingCompiler::TryCompile(const DexFile::CodeItem* code_ite
     SsaRedundantPhiElimination(graph).Run();
     SsaDeadPhiElimination(graph).Run();
 
+    RunOptimizations(graph, dex_compilation_unit, GetCompilerDriver(), &visualizer);
+
     SsaLivenessAnalysis liveness(*graph, codegen);
     liveness.Analyze();
     visualizer.DumpGraph(kLivenessPassName);
@@ -36,6 +36,9 @@ namespace art {
 #define THREE_REGISTERS_CODE_ITEM(...)                                     \
     { 3, 0, 0, 0, 0, 0, NUM_INSTRUCTIONS(__VA_ARGS__), 0, __VA_ARGS__ }
 
+#define FOUR_REGISTERS_CODE_ITEM(...)                                      \
+    { 4, 0, 0, 0, 0, 0, NUM_INSTRUCTIONS(__VA_ARGS__), 0, __VA_ARGS__ }
+
 LiveInterval* BuildInterval(const size_t ranges[][2],
                             size_t number_of_ranges,
                             ArenaAllocator* allocator,
@@ -243,4 +243,99 @@ TEST(PrettyPrinterTest, IntConstant) {
 
   TestCode(data, expected);
 }
+
+TEST(PrettyPrinterTest, DivZeroCheck) {
+  const char* expected =
+    "BasicBlock 0, succ: 1\n"
+    "  0: Local [11, 10, 6, 3]\n"
+    "  1: Local [7, 5]\n"
+    "  2: IntConstant [3]\n"
+    "  4: IntConstant [5]\n"
+    "  14: Goto 1\n"
+    "BasicBlock 1, pred: 0, succ: 2\n"
+    "  3: StoreLocal(0, 2)\n"
+    "  5: StoreLocal(1, 4)\n"
+    "  6: LoadLocal(0) [9]\n"
+    "  7: LoadLocal(1) [8]\n"
+    "  8: DivZeroCheck(7) [9]\n"
+    "  9: Div(6, 8) [10]\n"
+    "  10: StoreLocal(0, 9)\n"
+    "  11: LoadLocal(0) [12]\n"
+    "  12: Return(11)\n"
+    "BasicBlock 2, pred: 1\n"
+    "  13: Exit\n";
+
+  const uint16_t data[] = TWO_REGISTERS_CODE_ITEM(
+    Instruction::CONST_4 | 4 << 12 | 0 << 8,
+    Instruction::CONST_4 | 2 << 12 | 1 << 8,
+    Instruction::DIV_INT_2ADDR | 0 << 8 | 1 << 12,
+    Instruction::RETURN | 0 << 8);
+
+  TestCode(data, expected);
+}
+
+// Only a literal divisor of zero needs a check.
+TEST(PrettyPrinterTest, DivRemLiteral) {
+  const char* expected =
+    "BasicBlock 0, succ: 1\n"
+    "  0: Local [12, 11, 7, 6, 3, 2]\n"
+    "  1: IntConstant [2]\n"
+    "  4: IntConstant [5]\n"
+    "  8: IntConstant [9]\n"
+    "  15: Goto 1\n"
+    "BasicBlock 1, pred: 0, succ: 2\n"
+    "  2: StoreLocal(0, 1)\n"
+    "  3: LoadLocal(0) [5]\n"
+    "  5: Div(3, 4) [6]\n"
+    "  6: StoreLocal(0, 5)\n"
+    "  7: LoadLocal(0) [10]\n"
+    "  9: DivZeroCheck(8) [10]\n"
+    "  10: Rem(7, 9) [11]\n"
+    "  11: StoreLocal(0, 10)\n"
+    "  12: LoadLocal(0) [13]\n"
+    "  13: Return(12)\n"
+    "BasicBlock 2, pred: 1\n"
+    "  14: Exit\n";
+
+  const uint16_t data[] = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 4 << 12 | 0 << 8,
+    Instruction::DIV_INT_LIT8 | 0 << 8, 2 << 8 | 0,
+    Instruction::REM_INT_LIT8 | 0 << 8, 0 << 8 | 0,
+    Instruction::RETURN | 0 << 8);
+
+  TestCode(data, expected);
+}
+
+// The distance of a long shift is a single int register.
+TEST(PrettyPrinterTest, ShlLong) {
+  const char* expected =
+    "BasicBlock 0, succ: 1\n"
+    "  0: Local [12, 11, 8, 5]\n"
+    "  1: Local\n"
+    "  2: Local [9, 7]\n"
+    "  3: Local\n"
+    "  4: LongConstant [5]\n"
+    "  6: IntConstant [7]\n"
+    "  15: Goto 1\n"
+    "BasicBlock 1, pred: 0, succ: 2\n"
+    "  5: StoreLocal(0, 4)\n"
+    "  7: StoreLocal(2, 6)\n"
+    "  8: LoadLocal(0) [10]\n"
+    "  9: LoadLocal(2) [10]\n"
+    "  10: Shl(8, 9) [11]\n"
+    "  11: StoreLocal(0, 10)\n"
+    "  12: LoadLocal(0) [13]\n"
+    "  13: Return(12)\n"
+    "BasicBlock 2, pred: 1\n"
+    "  14: Exit\n";
+
+  const uint16_t data[] = FOUR_REGISTERS_CODE_ITEM(
+    Instruction::CONST_WIDE_16 | 0 << 8, 3,
+    Instruction::CONST_4 | 5 << 12 | 2 << 8,
+    Instruction::SHL_LONG | 0 << 8, 2 << 8 | 0,
+    Instruction::RETURN_WIDE | 0 << 8);
+
+  TestCode(data, expected);
+}
+
 }  // namespace art
@@ -30,6 +30,7 @@ static constexpr bool kUseMemMap = false;
 static constexpr bool kUseMemSet = true && kUseMemMap;
 static constexpr size_t kValgrindRedZoneBytes = 8;
 constexpr size_t Arena::kDefaultSize;
+constexpr size_t ArenaPool::kUnlimitedFreeBytes;
 
 template <bool kCount>
 const char* const ArenaAllocatorStatsImpl<kCount>::kAllocNames[] = {
@@ -79,6 +80,11 @@ size_t ArenaAllocatorStatsImpl<kCount>::BytesAllocated() const {
   return std::accumulate(alloc_stats_, alloc_stats_ + arraysize(alloc_stats_), init);
 }
 
+template <bool kCount>
+size_t ArenaAllocatorStatsImpl<kCount>::BytesAllocatedOfKind(ArenaAllocKind kind) const {
+  return alloc_stats_[kind];
+}
+
 template <bool kCount>
 void ArenaAllocatorStatsImpl<kCount>::Dump(std::ostream& os, const Arena* first,
                                            ssize_t lost_bytes_adjustment) const {
@@ -108,14 +114,14 @@ void ArenaAllocatorStatsImpl<kCount>::Dump(std::ostream& os, const Arena* first,
   }
 }
 
-// Explicitly instantiate the used implementation.
-template class ArenaAllocatorStatsImpl<kArenaAllocatorCountAllocations>;
+// Explicitly instantiate the counting implementation, pools may count allocations at run time.
+template class ArenaAllocatorStatsImpl<true>;
 
-Arena::Arena(size_t size)
+Arena::Arena(size_t size, bool use_mem_map)
     : bytes_allocated_(0),
       map_(nullptr),
       next_(nullptr) {
-  if (kUseMemMap) {
+  if (use_mem_map) {
     std::string error_msg;
     map_ = MemMap::MapAnonymous("dalvik-arena", NULL, size, PROT_READ | PROT_WRITE, false,
                                 &error_msg);
@@ -129,7 +135,7 @@ Arena::Arena(size_t size)
 }
 
 Arena::~Arena() {
-  if (kUseMemMap) {
+  if (map_ != nullptr) {
     delete map_;
   } else {
     free(reinterpret_cast<void*>(memory_));
@@ -138,7 +144,7 @@ Arena::~Arena() {
 
 void Arena::Reset() {
   if (bytes_allocated_) {
-    if (kUseMemSet || !kUseMemMap) {
+    if (kUseMemSet || map_ == nullptr) {
       memset(Begin(), 0, bytes_allocated_);
     } else {
       map_->MadviseDontNeedAndZero();
@@ -147,9 +153,79 @@ void Arena::Reset() {
   }
 }
 
+void Arena::Release() {
+  if (map_ != nullptr && bytes_allocated_ != 0) {
+    map_->MadviseDontNeedAndZero();
+    bytes_allocated_ = 0;
+  }
+}
+
+ArenaPoolUsage::ArenaPoolUsage()
+    : num_allocators_(0u),
+      peak_in_use_bytes_(0u),
+      peak_footprint_bytes_(0u) {
+  std::fill_n(peak_bytes_, arraysize(peak_bytes_), 0u);
+  std::fill_n(total_bytes_, arraysize(total_bytes_), 0u);
+}
+
+void ArenaPoolUsage::RecordAllocator(const ArenaAllocatorStatsImpl<true>& stats) {
+  ++num_allocators_;
+  for (size_t i = 0; i != arraysize(peak_bytes_); ++i) {
+    size_t bytes = stats.BytesAllocatedOfKind(static_cast<ArenaAllocKind>(i));
+    peak_bytes_[i] = std::max(peak_bytes_[i], bytes);
+    total_bytes_[i] += bytes;
+  }
+}
+
+void ArenaPoolUsage::RecordArenaBytes(size_t in_use_bytes, size_t footprint_bytes) {
+  peak_in_use_bytes_ = std::max(peak_in_use_bytes_, in_use_bytes);
+  peak_footprint_bytes_ = std::max(peak_footprint_bytes_, footprint_bytes);
+}
+
+void ArenaPoolUsage::Merge(const ArenaPoolUsage& other) {
+  num_allocators_ += other.num_allocators_;
+  // Pools are used concurrently and we don't know whether their peaks coincided, so the sum
+  // is an upper bound of the combined peak.
+  peak_in_use_bytes_ += other.peak_in_use_bytes_;
+  peak_footprint_bytes_ += other.peak_footprint_bytes_;
+  for (size_t i = 0; i != arraysize(peak_bytes_); ++i) {
+    peak_bytes_[i] = std::max(peak_bytes_[i], other.peak_bytes_[i]);
+    total_bytes_[i] += other.total_bytes_[i];
+  }
+}
+
+void ArenaPoolUsage::Dump(std::ostream& os) const {
+  os << "Arena usage: peak in use: " << PrettySize(peak_in_use_bytes_)
+     << ", peak footprint: " << PrettySize(peak_footprint_bytes_) << "\n";
+  if (num_allocators_ == 0u) {
+    return;
+  }
+  os << "===== Allocation by kind over " << num_allocators_
+     << " allocators (peak per allocator, average per allocator)\n";
+  for (size_t i = 0; i != arraysize(peak_bytes_); ++i) {
+    os << ArenaAllocatorStatsImpl<true>::kAllocNames[i] << std::setw(10) << peak_bytes_[i]
+       << std::setw(10) << total_bytes_[i] / num_allocators_ << "\n";
+  }
+}
+
 ArenaPool::ArenaPool()
-    : lock_("Arena pool lock"),
-      free_arenas_(nullptr) {
+    : use_mem_map_(kUseMemMap),
+      max_free_bytes_(kUnlimitedFreeBytes),
+      count_allocations_(false),
+      lock_("Arena pool lock"),
+      free_arenas_(nullptr),
+      in_use_bytes_(0u),
+      footprint_bytes_(0u) {
+}
+
+ArenaPool::ArenaPool(bool use_mem_map, size_t max_free_bytes, bool count_allocations)
+    : use_mem_map_(use_mem_map),
+      max_free_bytes_(max_free_bytes),
+      count_allocations_(count_allocations),
+      lock_("Arena pool lock"),
+      free_arenas_(nullptr),
+      in_use_bytes_(0u),
+      footprint_bytes_(0u) {
 }
 
 ArenaPool::~ArenaPool() {
@@ -168,10 +244,16 @@ Arena* ArenaPool::AllocArena(size_t size) {
     if (free_arenas_ != nullptr && LIKELY(free_arenas_->Size() >= size)) {
       ret = free_arenas_;
       free_arenas_ = free_arenas_->next_;
+      in_use_bytes_ += ret->Size();
+    } else {
+      // Account for the new arena up front so that we take the lock only once.
+      footprint_bytes_ += size;
+      in_use_bytes_ += size;
     }
+    usage_.RecordArenaBytes(in_use_bytes_, footprint_bytes_);
   }
   if (ret == nullptr) {
-    ret = new Arena(size);
+    ret = new Arena(size, use_mem_map_);
   }
   ret->Reset();
   return ret;
@@ -184,17 +266,59 @@ void ArenaPool::FreeArenaChain(Arena* first) {
     }
   }
   if (first != nullptr) {
+    size_t freed_bytes = first->Size();
     Arena* last = first;
     while (last->next_ != nullptr) {
       last = last->next_;
+      freed_bytes += last->Size();
     }
     Thread* self = Thread::Current();
     MutexLock lock(self, lock_);
     last->next_ = free_arenas_;
     free_arenas_ = first;
+    DCHECK_GE(in_use_bytes_, freed_bytes);
+    in_use_bytes_ -= freed_bytes;
+    if (max_free_bytes_ != kUnlimitedFreeBytes) {
+      TrimFreeArenasLocked(max_free_bytes_);
+    }
   }
 }
 
+void ArenaPool::TrimFreeArenas() {
+  MutexLock lock(Thread::Current(), lock_);
+  TrimFreeArenasLocked(0u);
+}
+
+void ArenaPool::TrimFreeArenasLocked(size_t max_free_bytes) {
+  // Arenas are reused from the front of the list, so the ones at the back are the coldest.
+  size_t dirty_bytes = 0u;
+  Arena** link = &free_arenas_;
+  while (*link != nullptr) {
+    Arena* arena = *link;
+    if (dirty_bytes + arena->bytes_allocated_ <= max_free_bytes) {
+      dirty_bytes += arena->bytes_allocated_;
+      link = &arena->next_;
+    } else if (use_mem_map_) {
+      arena->Release();
+      link = &arena->next_;
+    } else {
+      *link = arena->next_;
+      footprint_bytes_ -= arena->Size();
+      delete arena;
+    }
+  }
+}
+
+void ArenaPool::RecordAllocatorStats(const ArenaAllocatorStatsImpl<true>& stats) {
+  MutexLock lock(Thread::Current(), lock_);
+  usage_.RecordAllocator(stats);
+}
+
+ArenaPoolUsage ArenaPool::GetUsage() {
+  MutexLock lock(Thread::Current(), lock_);
+  return usage_;
+}
+
 size_t ArenaAllocator::BytesAllocated() const {
   return ArenaAllocatorStats::BytesAllocated();
 }
@@ -205,7 +329,8 @@ ArenaAllocator::ArenaAllocator(ArenaPool* pool)
     end_(nullptr),
     ptr_(nullptr),
     arena_head_(nullptr),
-    running_on_valgrind_(RUNNING_ON_VALGRIND > 0) {
+    running_on_valgrind_(RUNNING_ON_VALGRIND > 0),
+    count_allocations_(pool->CountsAllocations()) {
 }
 
 void ArenaAllocator::UpdateBytesAllocated() {
@@ -226,6 +351,9 @@ void* ArenaAllocator::AllocValgrind(size_t bytes, ArenaAllocKind kind) {
     }
   }
   ArenaAllocatorStats::RecordAlloc(rounded_bytes, kind);
+  if (count_allocations_) {
+    kind_stats_.RecordAlloc(rounded_bytes, kind);
+  }
   uint8_t* ret = ptr_;
   ptr_ += rounded_bytes;
   // Check that the memory is already zeroed out.
@@ -239,6 +367,9 @@ void* ArenaAllocator::AllocValgrind(size_t bytes, ArenaAllocKind kind) {
 ArenaAllocator::~ArenaAllocator() {
   // Reclaim all the arenas by giving them back to the thread pool.
   UpdateBytesAllocated();
+  if (count_allocations_) {
+    pool_->RecordAllocatorStats(kind_stats_);
+  }
   pool_->FreeArenaChain(arena_head_);
 }
 
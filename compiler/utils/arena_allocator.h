@@ -34,6 +34,8 @@ class ArenaStack;
 class ScopedArenaAllocator;
 class MemStats;
 
+// Set to true to count the allocations of every allocator for MemStats. Pools created with
+// count_allocations (dex2oat --dump-stats) count them per kind without it.
 static constexpr bool kArenaAllocatorCountAllocations = false;
 
 // Type of allocation for memory tuning.
@@ -70,6 +72,7 @@ class ArenaAllocatorStatsImpl<false> {
   void RecordAlloc(size_t bytes, ArenaAllocKind kind) { UNUSED(bytes); UNUSED(kind); }
   size_t NumAllocations() const { return 0u; }
   size_t BytesAllocated() const { return 0u; }
+  size_t BytesAllocatedOfKind(ArenaAllocKind kind) const { UNUSED(kind); return 0u; }
   void Dump(std::ostream& os, const Arena* first, ssize_t lost_bytes_adjustment) const {
     UNUSED(os); UNUSED(first); UNUSED(lost_bytes_adjustment);
   }
@@ -86,6 +89,7 @@ class ArenaAllocatorStatsImpl {
   void RecordAlloc(size_t bytes, ArenaAllocKind kind);
   size_t NumAllocations() const;
   size_t BytesAllocated() const;
+  size_t BytesAllocatedOfKind(ArenaAllocKind kind) const;
   void Dump(std::ostream& os, const Arena* first, ssize_t lost_bytes_adjustment) const;
 
  private:
@@ -94,6 +98,8 @@ class ArenaAllocatorStatsImpl {
   size_t alloc_stats_[kNumArenaAllocKinds];  // Bytes used by various allocation kinds.
 
   static const char* const kAllocNames[];
+
+  friend class ArenaPoolUsage;
 };
 
 typedef ArenaAllocatorStatsImpl<kArenaAllocatorCountAllocations> ArenaAllocatorStats;
@@ -101,9 +107,12 @@ typedef ArenaAllocatorStatsImpl<kArenaAllocatorCountAllocations> ArenaAllocatorS
 class Arena {
  public:
   static constexpr size_t kDefaultSize = 128 * KB;
-  explicit Arena(size_t size = kDefaultSize);
+  explicit Arena(size_t size = kDefaultSize, bool use_mem_map = false);
   ~Arena();
   void Reset();
+  // Returns the dirty pages of a mem map backed arena to the kernel, keeping the mapping.
+  // Does nothing for malloc backed arenas.
+  void Release();
   uint8_t* Begin() {
     return memory_;
   }
@@ -134,16 +143,71 @@ class Arena {
   DISALLOW_COPY_AND_ASSIGN(Arena);
 };
 
+// Peak and cumulative usage of the allocators that drew from one or more arena pools.
+class ArenaPoolUsage {
+ public:
+  ArenaPoolUsage();
+
+  // Only called for pools that count allocations.
+  void RecordAllocator(const ArenaAllocatorStatsImpl<true>& stats);
+  void RecordArenaBytes(size_t in_use_bytes, size_t footprint_bytes);
+  // Adds the usage of a pool used concurrently with ours. The peaks are summed, so the merged
+  // peaks are an upper bound.
+  void Merge(const ArenaPoolUsage& other);
+  void Dump(std::ostream& os) const;
+
+  size_t GetPeakInUseBytes() const {
+    return peak_in_use_bytes_;
+  }
+
+  size_t GetPeakFootprintBytes() const {
+    return peak_footprint_bytes_;
+  }
+
+ private:
+  size_t num_allocators_;
+  // Largest amount of arena memory handed out at once.
+  size_t peak_in_use_bytes_;
+  // Largest amount of arena memory owned at once, whether in use or free.
+  size_t peak_footprint_bytes_;
+  size_t peak_bytes_[kNumArenaAllocKinds];
+  size_t total_bytes_[kNumArenaAllocKinds];
+};
+
 class ArenaPool {
  public:
+  static constexpr size_t kUnlimitedFreeBytes = static_cast<size_t>(-1);
+
   ArenaPool();
+  // Arenas returned to the pool are kept for reuse. Once the dirty memory of the free arenas
+  // exceeds max_free_bytes, the least recently used ones are trimmed: mem map backed arenas
+  // are madvised away but stay mapped, malloc backed arenas are freed.
+  // With count_allocations, the allocators drawing from the pool also report their bytes
+  // allocated per kind.
+  ArenaPool(bool use_mem_map, size_t max_free_bytes, bool count_allocations = false);
   ~ArenaPool();
   Arena* AllocArena(size_t size);
   void FreeArenaChain(Arena* first);
+  // Trims all free arenas, e.g. when the pool will be idle for a while.
+  void TrimFreeArenas();
+  void RecordAllocatorStats(const ArenaAllocatorStatsImpl<true>& stats);
+  ArenaPoolUsage GetUsage();
+
+  bool CountsAllocations() const {
+    return count_allocations_;
+  }
 
  private:
+  void TrimFreeArenasLocked(size_t max_free_bytes) EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  const bool use_mem_map_;
+  const size_t max_free_bytes_;
+  const bool count_allocations_;
   Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   Arena* free_arenas_ GUARDED_BY(lock_);
+  size_t in_use_bytes_ GUARDED_BY(lock_);
+  size_t footprint_bytes_ GUARDED_BY(lock_);
+  ArenaPoolUsage usage_ GUARDED_BY(lock_);
   DISALLOW_COPY_AND_ASSIGN(ArenaPool);
 };
 
@@ -166,6 +230,9 @@ class ArenaAllocator : private ArenaAllocatorStats {
       }
     }
     ArenaAllocatorStats::RecordAlloc(bytes, kind);
+    if (UNLIKELY(count_allocations_)) {
+      kind_stats_.RecordAlloc(bytes, kind);
+    }
     uint8_t* ret = ptr_;
     ptr_ += bytes;
     return ret;
@@ -189,6 +256,8 @@ class ArenaAllocator : private ArenaAllocatorStats {
   uint8_t* ptr_;
   Arena* arena_head_;
   bool running_on_valgrind_;
+  const bool count_allocations_;
+  ArenaAllocatorStatsImpl<true> kind_stats_;
 
   DISALLOW_COPY_AND_ASSIGN(ArenaAllocator);
 };  // ArenaAllocator
@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include <sstream>
+#include <string>
+
 #include "gtest/gtest.h"
 #include "utils/arena_allocator.h"
 #include "utils/arena_bit_vector.h"
@@ -30,4 +33,83 @@ TEST(ArenaAllocator, Test) {
   EXPECT_EQ(2U, bv.GetStorageSize());
 }
 
+TEST(ArenaAllocator, ReuseArenas) {
+  ArenaPool pool(true, Arena::kDefaultSize);
+  uint8_t* first;
+  {
+    ArenaAllocator arena(&pool);
+    first = reinterpret_cast<uint8_t*>(arena.Alloc(64, kArenaAllocMisc));
+    memset(first, 0xff, 64);
+  }
+  {
+    ArenaAllocator arena(&pool);
+    uint8_t* second = reinterpret_cast<uint8_t*>(arena.Alloc(64, kArenaAllocMisc));
+    EXPECT_EQ(first, second);
+    for (size_t i = 0; i != 64; ++i) {
+      EXPECT_EQ(0u, second[i]);
+    }
+  }
+  ArenaPoolUsage usage = pool.GetUsage();
+  EXPECT_EQ(Arena::kDefaultSize, usage.GetPeakInUseBytes());
+  EXPECT_EQ(Arena::kDefaultSize, usage.GetPeakFootprintBytes());
+}
+
+TEST(ArenaAllocator, TrimFreeArenas) {
+  for (bool use_mem_map : { false, true }) {
+    ArenaPool pool(use_mem_map, ArenaPool::kUnlimitedFreeBytes);
+    {
+      ArenaAllocator arena(&pool);
+      memset(arena.Alloc(Arena::kDefaultSize, kArenaAllocMisc), 0xff, Arena::kDefaultSize);
+      memset(arena.Alloc(Arena::kDefaultSize, kArenaAllocMisc), 0xff, Arena::kDefaultSize);
+    }
+    pool.TrimFreeArenas();
+    {
+      // Trimmed arenas must come back zeroed, whether they were released or freed.
+      ArenaAllocator arena(&pool);
+      for (size_t n = 0; n != 2; ++n) {
+        uint8_t* data =
+            reinterpret_cast<uint8_t*>(arena.Alloc(Arena::kDefaultSize, kArenaAllocMisc));
+        for (size_t i = 0; i != Arena::kDefaultSize; ++i) {
+          ASSERT_EQ(0u, data[i]);
+        }
+      }
+    }
+    EXPECT_EQ(2 * Arena::kDefaultSize, pool.GetUsage().GetPeakInUseBytes());
+  }
+}
+
+TEST(ArenaAllocator, MergeUsage) {
+  ArenaPool pool1(false, ArenaPool::kUnlimitedFreeBytes);
+  ArenaPool pool2(false, ArenaPool::kUnlimitedFreeBytes);
+  {
+    ArenaAllocator arena1(&pool1);
+    arena1.Alloc(64, kArenaAllocMisc);
+    ArenaAllocator arena2(&pool2);
+    arena2.Alloc(2 * Arena::kDefaultSize, kArenaAllocMisc);
+  }
+  // The merged peaks don't know whether the pools peaked at the same time; they add up.
+  ArenaPoolUsage usage = pool1.GetUsage();
+  usage.Merge(pool2.GetUsage());
+  EXPECT_EQ(3 * Arena::kDefaultSize, usage.GetPeakInUseBytes());
+  EXPECT_EQ(3 * Arena::kDefaultSize, usage.GetPeakFootprintBytes());
+}
+
+TEST(ArenaAllocator, CountAllocations) {
+  ArenaPool pool(false, ArenaPool::kUnlimitedFreeBytes);
+  ArenaPool counting_pool(false, ArenaPool::kUnlimitedFreeBytes, true);
+  {
+    ArenaAllocator arena(&pool);
+    arena.Alloc(64, kArenaAllocMisc);
+    ArenaAllocator counting_arena(&counting_pool);
+    counting_arena.Alloc(64, kArenaAllocMisc);
+    counting_arena.Alloc(32, kArenaAllocBB);
+  }
+  std::ostringstream os;
+  pool.GetUsage().Dump(os);
+  EXPECT_EQ(std::string::npos, os.str().find("Allocation by kind"));
+  std::ostringstream counting_os;
+  counting_pool.GetUsage().Dump(counting_os);
+  EXPECT_NE(std::string::npos, counting_os.str().find("Allocation by kind over 1 allocators"));
+}
+
 }  // namespace art
@@ -819,6 +819,16 @@ void ArmAssembler::ExceptionPoll(ManagedRegister mscratch, size_t stack_adjust)
   b(slow->Entry(), NE);
 }
 
+void ArmAssembler::BranchIfBitSet(ManagedRegister mbase, MemberOffset offs, uint32_t mask,
+                                  ManagedRegister mscratch, Label* label) {
+  CHECK(IsPowerOfTwo(mask));
+  ArmManagedRegister base = mbase.AsArm();
+  ArmManagedRegister scratch = mscratch.AsArm();
+  LoadFromOffset(kLoadWord, scratch.AsCoreRegister(), base.AsCoreRegister(), offs.Int32Value());
+  tst(scratch.AsCoreRegister(), ShifterOperand(mask));
+  b(label, NE);
+}
+
 void ArmExceptionSlowPath::Emit(Assembler* sasm) {
   ArmAssembler* sp_asm = down_cast<ArmAssembler*>(sasm);
 #define __ sp_asm->
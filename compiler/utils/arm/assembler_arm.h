@@ -721,6 +721,9 @@ class ArmAssembler : public Assembler {
   // and branch to a ExceptionSlowPath if it is.
   void ExceptionPoll(ManagedRegister scratch, size_t stack_adjust) OVERRIDE;
 
+  void BranchIfBitSet(ManagedRegister base, MemberOffset offs, uint32_t mask,
+                      ManagedRegister scratch, Label* label) OVERRIDE;
+
   static uint32_t ModifiedImmediate(uint32_t value);
 
   static bool IsLowRegister(Register r) {
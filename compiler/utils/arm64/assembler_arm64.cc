@@ -609,6 +609,32 @@ void Arm64Assembler::ExceptionPoll(ManagedRegister m_scratch, size_t stack_adjus
   ___ Cbnz(reg_x(scratch.AsCoreRegister()), current_exception->Entry());
 }
 
+vixl::Label* Arm64Assembler::GetVixlLabel(Label* label) {
+  auto it = vixl_labels_.find(label);
+  if (it != vixl_labels_.end()) {
+    return it->second;
+  }
+  vixl::Label* vixl_label = new vixl::Label();
+  vixl_labels_.insert(std::make_pair(label, vixl_label));
+  return vixl_label;
+}
+
+void Arm64Assembler::BranchIfBitSet(ManagedRegister m_base, MemberOffset offs, uint32_t mask,
+                                    ManagedRegister m_scratch, Label* label) {
+  CHECK(IsPowerOfTwo(mask));
+  Arm64ManagedRegister base = m_base.AsArm64();
+  Arm64ManagedRegister scratch = m_scratch.AsArm64();
+  CHECK(base.IsCoreRegister()) << base;
+  CHECK(scratch.IsCoreRegister()) << scratch;
+  LoadWFromOffset(kLoadWord, scratch.AsOverlappingCoreRegisterLow(), base.AsCoreRegister(),
+                  offs.Int32Value());
+  ___ Tbnz(reg_w(scratch.AsOverlappingCoreRegisterLow()), CTZ(mask), GetVixlLabel(label));
+}
+
+void Arm64Assembler::Bind(Label* label) {
+  ___ Bind(GetVixlLabel(label));
+}
+
 void Arm64Assembler::EmitExceptionPoll(Arm64Exception *exception) {
   vixl::UseScratchRegisterScope temps(vixl_masm_);
   temps.Exclude(reg_x(exception->scratch_.AsCoreRegister()));
@@ -18,10 +18,12 @@
 #define ART_COMPILER_UTILS_ARM64_ASSEMBLER_ARM64_H_
 
 #include <stdint.h>
+#include <map>
 #include <memory>
 #include <vector>
 
 #include "base/logging.h"
+#include "base/stl_util.h"
 #include "constants_arm64.h"
 #include "utils/arm64/managed_register_arm64.h"
 #include "utils/assembler.h"
@@ -85,6 +87,7 @@ class Arm64Assembler FINAL : public Assembler {
   vixl_masm_(new vixl::MacroAssembler(vixl_buf_, kBufferSizeArm64)) {}
 
   virtual ~Arm64Assembler() {
+    STLDeleteValues(&vixl_labels_);
     delete vixl_masm_;
     delete[] vixl_buf_;
   }
@@ -193,6 +196,10 @@ class Arm64Assembler FINAL : public Assembler {
   // and branch to a ExceptionSlowPath if it is.
   void ExceptionPoll(ManagedRegister scratch, size_t stack_adjust) OVERRIDE;
 
+  void BranchIfBitSet(ManagedRegister base, MemberOffset offs, uint32_t mask,
+                      ManagedRegister scratch, Label* label) OVERRIDE;
+  void Bind(Label* label) OVERRIDE;
+
  private:
   static vixl::Register reg_x(int code) {
     CHECK(code < kNumberOfCoreRegisters) << code;
@@ -219,6 +226,9 @@ class Arm64Assembler FINAL : public Assembler {
   // Emits Exception block.
   void EmitExceptionPoll(Arm64Exception *exception);
 
+  // Returns the vixl label standing in for a generic assembler label.
+  vixl::Label* GetVixlLabel(Label* label);
+
   void StoreWToOffset(StoreOperandType type, WRegister source,
                       Register base, int32_t offset);
   void StoreToOffset(Register source, Register base, int32_t offset);
@@ -244,6 +254,9 @@ class Arm64Assembler FINAL : public Assembler {
   // List of exception blocks to generate at the end of the code cache.
   std::vector<Arm64Exception*> exception_blocks_;
 
+  // Vixl labels for the generic labels bound or branched to through the JNI interface.
+  std::map<Label*, vixl::Label*> vixl_labels_;
+
   // Used for testing.
   friend class Arm64ManagedRegister_VixlRegisters_Test;
 };
@@ -499,6 +499,14 @@ class Assembler {
   // and branch to a ExceptionSlowPath if it is.
   virtual void ExceptionPoll(ManagedRegister scratch, size_t stack_adjust) = 0;
 
+  // Load the 32-bit field at [base+offs] and branch to label if the single
+  // bit in mask is set in it.
+  virtual void BranchIfBitSet(ManagedRegister base, MemberOffset offs, uint32_t mask,
+                              ManagedRegister scratch, Label* label) = 0;
+
+  // Bind a label branched to by BranchIfBitSet.
+  virtual void Bind(Label* label) = 0;
+
   virtual ~Assembler() {}
 
  protected:
@@ -17,68 +17,182 @@
 #ifndef ART_COMPILER_UTILS_DEDUPE_SET_H_
 #define ART_COMPILER_UTILS_DEDUPE_SET_H_
 
-#include <set>
+#include <string.h>
+
+#include <algorithm>
+#include <new>
+#include <sstream>
 #include <string>
+#include <vector>
 
+#include "atomic.h"
 #include "base/mutex.h"
 #include "base/stl_util.h"
 #include "base/stringprintf.h"
+#include "utils.h"
+#include "utils/arena_allocator.h"
+#include "utils/array_ref.h"
 
 namespace art {
 
-// A set of Keys that support a HashFunc returning HashType. Used to find duplicates of Key in the
-// Add method. The data-structure is thread-safe through the use of internal locks, it also
-// supports the lock being sharded.
-template <typename Key, typename HashType, typename HashFunc, HashType kShard = 1>
+// A set of arrays of T that returns a single copy for equal arrays added to it. Used to share
+// identical code and tables between compiled methods. The copies live in arenas owned by the set
+// and remain valid until the set is destroyed.
+//
+// The set is split into shards selected by hash, each with its own lock and open addressing
+// table. Finding an array that is already present does not take the lock since tables and
+// entries are immutable once published. A lookup that misses retries under the shard lock
+// before inserting.
+template <typename T, typename HashFunc>
 class DedupeSet {
-  typedef std::pair<HashType, Key*> HashedKey;
-
-  class Comparator {
-   public:
-    bool operator()(const HashedKey& a, const HashedKey& b) const {
-      if (a.first != b.first) {
-        return a.first < b.first;
-      } else {
-        return *a.second < *b.second;
+ public:
+  DedupeSet(const char* set_name, size_t num_shards)
+      : set_name_(set_name), num_shards_(RoundUpToPowerOfTwo(std::max<size_t>(num_shards, 1u))) {
+    CreateShards();
+  }
+
+  ~DedupeSet() {
+    STLDeleteElements(&shards_);
+  }
+
+  // Drops all the arrays and frees their memory. The arrays returned by Add() must not be used
+  // anymore and no Add() may run concurrently.
+  void Clear() {
+    STLDeleteElements(&shards_);
+    pool_.TrimFreeArenas();
+    CreateShards();
+  }
+
+  ArrayRef<const T> Add(Thread* self, const std::vector<T>& key) {
+    return Add(self, ArrayRef<const T>(key));
+  }
+
+  ArrayRef<const T> Add(Thread* self, const ArrayRef<const T>& key) {
+    size_t hash = HashFunc()(key);
+    Shard* shard = shards_[hash & (num_shards_ - 1)];
+    // The low bits select the shard, use the others for the slot.
+    size_t slot_hash = hash / num_shards_;
+    const Entry* entry = Find(shard->table.LoadSequentiallyConsistent(), hash, slot_hash, key);
+    if (entry == nullptr) {
+      MutexLock lock(self, shard->lock);
+      Table* table = shard->table.LoadRelaxed();
+      entry = Find(table, hash, slot_hash, key);
+      if (entry == nullptr) {
+        entry = shard->Insert(hash, slot_hash, key);
       }
     }
+    return ArrayRef<const T>(entry->Data(), entry->length);
+  }
+
+ private:
+  struct Entry {
+    size_t hash;
+    size_t length;
+
+    const T* Data() const {
+      return reinterpret_cast<const T*>(this + 1);
+    }
   };
 
- public:
-  Key* Add(Thread* self, const Key& key) {
-    HashType raw_hash = HashFunc()(key);
-    HashType shard_hash = raw_hash / kShard;
-    HashType shard_bin = raw_hash % kShard;
-    HashedKey hashed_key(shard_hash, const_cast<Key*>(&key));
-    MutexLock lock(self, *lock_[shard_bin]);
-    auto it = keys_[shard_bin].find(hashed_key);
-    if (it != keys_[shard_bin].end()) {
-      return it->second;
+  struct Table {
+    size_t mask;
+    Atomic<const Entry*>* slots;
+  };
+
+  struct Shard {
+    static constexpr size_t kInitialCapacity = 64u;
+
+    Shard(const std::string& name, ArenaPool* pool, size_t num_shards)
+        : lock_name(name), lock(lock_name.c_str()), allocator(pool), table(nullptr),
+          num_entries(0u), num_shards(num_shards) {
+      table.StoreRelaxed(NewTable(kInitialCapacity));
     }
-    hashed_key.second = new Key(key);
-    keys_[shard_bin].insert(hashed_key);
-    return hashed_key.second;
-  }
 
-  explicit DedupeSet(const char* set_name) {
-    for (HashType i = 0; i < kShard; ++i) {
+    Table* NewTable(size_t capacity) {
+      Table* new_table = new (allocator.Alloc(sizeof(Table), kArenaAllocMisc)) Table;
+      new_table->mask = capacity - 1u;
+      new_table->slots = reinterpret_cast<Atomic<const Entry*>*>(
+          allocator.Alloc(capacity * sizeof(Atomic<const Entry*>), kArenaAllocMisc));
+      for (size_t i = 0; i != capacity; ++i) {
+        new (&new_table->slots[i]) Atomic<const Entry*>(nullptr);
+      }
+      return new_table;
+    }
+
+    static void Put(Table* t, size_t slot_hash, const Entry* entry) {
+      size_t index = slot_hash & t->mask;
+      while (t->slots[index].LoadRelaxed() != nullptr) {
+        index = (index + 1u) & t->mask;
+      }
+      // Release the entry contents to lock-free readers.
+      t->slots[index].StoreRelease(entry);
+    }
+
+    const Entry* Insert(size_t hash, size_t slot_hash, const ArrayRef<const T>& key)
+        EXCLUSIVE_LOCKS_REQUIRED(lock) {
+      Table* t = table.LoadRelaxed();
+      size_t capacity = t->mask + 1u;
+      // Keep the load factor at most 1/2 so that probe sequences stay short.
+      if ((num_entries + 1u) * 2u > capacity) {
+        Table* new_table = NewTable(capacity * 2u);
+        for (size_t i = 0; i != capacity; ++i) {
+          const Entry* old_entry = t->slots[i].LoadRelaxed();
+          if (old_entry != nullptr) {
+            Put(new_table, old_entry->hash / num_shards, old_entry);
+          }
+        }
+        // Lookups racing with this miss new entries and retry under the lock.
+        table.StoreRelease(new_table);
+        t = new_table;
+      }
+      size_t data_size = key.size() * sizeof(T);
+      Entry* entry = new (allocator.Alloc(sizeof(Entry) + data_size, kArenaAllocMisc)) Entry;
+      entry->hash = hash;
+      entry->length = key.size();
+      if (data_size != 0u) {
+        memcpy(const_cast<T*>(entry->Data()), key.data(), data_size);
+      }
+      Put(t, slot_hash, entry);
+      ++num_entries;
+      return entry;
+    }
+
+    const std::string lock_name;
+    Mutex lock;
+    ArenaAllocator allocator GUARDED_BY(lock);
+    Atomic<Table*> table;
+    size_t num_entries GUARDED_BY(lock);
+    const size_t num_shards;
+  };
+
+  void CreateShards() {
+    for (size_t i = 0; i < num_shards_; ++i) {
       std::ostringstream oss;
-      oss << set_name << " lock " << i;
-      lock_name_[i] = oss.str();
-      lock_[i].reset(new Mutex(lock_name_[i].c_str()));
+      oss << set_name_ << " lock " << i;
+      shards_.push_back(new Shard(oss.str(), &pool_, num_shards_));
     }
   }
 
-  ~DedupeSet() {
-    for (HashType i = 0; i < kShard; ++i) {
-      STLDeleteValues(&keys_[i]);
+  static const Entry* Find(const Table* t, size_t hash, size_t slot_hash,
+                           const ArrayRef<const T>& key) {
+    size_t index = slot_hash & t->mask;
+    while (true) {
+      const Entry* entry = t->slots[index].LoadSequentiallyConsistent();
+      if (entry == nullptr) {
+        return nullptr;
+      }
+      if (entry->hash == hash && entry->length == key.size() &&
+          (key.size() == 0u || memcmp(entry->Data(), key.data(), key.size() * sizeof(T)) == 0)) {
+        return entry;
+      }
+      index = (index + 1u) & t->mask;
     }
   }
 
- private:
-  std::string lock_name_[kShard];
-  std::unique_ptr<Mutex> lock_[kShard];
-  std::set<HashedKey, Comparator> keys_[kShard];
+  const std::string set_name_;
+  const size_t num_shards_;
+  ArenaPool pool_;
+  std::vector<Shard*> shards_;
 
   DISALLOW_COPY_AND_ASSIGN(DedupeSet);
 };
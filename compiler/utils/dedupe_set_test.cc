@@ -22,7 +22,7 @@ namespace art {
 
 class DedupeHashFunc {
  public:
-  size_t operator()(const std::vector<uint8_t>& array) const {
+  size_t operator()(const ArrayRef<const uint8_t>& array) const {
     size_t hash = 0;
     for (uint8_t c : array) {
       hash += c;
@@ -35,8 +35,8 @@ class DedupeHashFunc {
 TEST(DedupeSetTest, Test) {
   Thread* self = Thread::Current();
   typedef std::vector<uint8_t> ByteArray;
-  DedupeSet<ByteArray, size_t, DedupeHashFunc> deduplicator("test");
-  ByteArray* array1;
+  DedupeSet<uint8_t, DedupeHashFunc> deduplicator("test", 4);
+  ArrayRef<const uint8_t> array1;
   {
     ByteArray test1;
     test1.push_back(10);
@@ -44,10 +44,11 @@ TEST(DedupeSetTest, Test) {
     test1.push_back(30);
     test1.push_back(45);
     array1 = deduplicator.Add(self, test1);
-    ASSERT_EQ(test1, *array1);
+    ASSERT_NE(array1.data(), test1.data());
+    ASSERT_EQ(test1, ByteArray(array1.begin(), array1.end()));
   }
 
-  ByteArray* array2;
+  ArrayRef<const uint8_t> array2;
   {
     ByteArray test1;
     test1.push_back(10);
@@ -55,11 +56,11 @@ TEST(DedupeSetTest, Test) {
     test1.push_back(30);
     test1.push_back(45);
     array2 = deduplicator.Add(self, test1);
-    ASSERT_EQ(array2, array1);
-    ASSERT_EQ(test1, *array2);
+    ASSERT_EQ(array2.data(), array1.data());
+    ASSERT_EQ(test1, ByteArray(array2.begin(), array2.end()));
   }
 
-  ByteArray* array3;
+  ArrayRef<const uint8_t> array3;
   {
     ByteArray test1;
     test1.push_back(10);
@@ -67,9 +68,55 @@ TEST(DedupeSetTest, Test) {
     test1.push_back(30);
     test1.push_back(47);
     array3 = deduplicator.Add(self, test1);
-    ASSERT_NE(array3, &test1);
-    ASSERT_EQ(test1, *array3);
+    ASSERT_NE(array3.data(), array1.data());
+    ASSERT_EQ(test1, ByteArray(array3.begin(), array3.end()));
   }
 }
 
+TEST(DedupeSetTest, Grow) {
+  Thread* self = Thread::Current();
+  typedef std::vector<uint8_t> ByteArray;
+  DedupeSet<uint8_t, DedupeHashFunc> deduplicator("test", 2);
+  static constexpr size_t kNumArrays = 5000;
+  std::vector<ArrayRef<const uint8_t>> added;
+  for (size_t i = 0; i != kNumArrays; ++i) {
+    ByteArray array;
+    array.push_back(static_cast<uint8_t>(i));
+    array.push_back(static_cast<uint8_t>(i >> 8));
+    array.push_back(static_cast<uint8_t>(i % 7));
+    added.push_back(deduplicator.Add(self, array));
+  }
+  // Entries must survive table growth and keep their identity.
+  for (size_t i = 0; i != kNumArrays; ++i) {
+    ByteArray array;
+    array.push_back(static_cast<uint8_t>(i));
+    array.push_back(static_cast<uint8_t>(i >> 8));
+    array.push_back(static_cast<uint8_t>(i % 7));
+    ArrayRef<const uint8_t> found = deduplicator.Add(self, array);
+    ASSERT_EQ(added[i].data(), found.data());
+    ASSERT_EQ(array, ByteArray(found.begin(), found.end()));
+  }
+}
+
+
+TEST(DedupeSetTest, Clear) {
+  Thread* self = Thread::Current();
+  typedef std::vector<uint8_t> ByteArray;
+  DedupeSet<uint8_t, DedupeHashFunc> deduplicator("test", 2);
+  for (size_t round = 0; round != 3; ++round) {
+    for (size_t i = 0; i != 1000; ++i) {
+      ByteArray array(64, static_cast<uint8_t>(i));
+      array.push_back(static_cast<uint8_t>(i >> 8));
+      deduplicator.Add(self, array);
+    }
+    deduplicator.Clear();
+  }
+  // The set still deduplicates after it was cleared.
+  ByteArray test(3, 7);
+  ArrayRef<const uint8_t> array1 = deduplicator.Add(self, test);
+  ArrayRef<const uint8_t> array2 = deduplicator.Add(self, test);
+  ASSERT_EQ(array1.data(), array2.data());
+  ASSERT_EQ(test, ByteArray(array2.begin(), array2.end()));
+}
+
 }  // namespace art
@@ -159,6 +159,10 @@ void MipsAssembler::Bind(Label* label, bool is_jump) {
   label->BindTo(bound_pc);
 }
 
+void MipsAssembler::Bind(Label* label) {
+  Bind(label, false);
+}
+
 void MipsAssembler::Add(Register rd, Register rs, Register rt) {
   EmitR(0, rs, rt, rd, 0, 0x20);
 }
@@ -947,6 +951,18 @@ void MipsAssembler::ExceptionPoll(ManagedRegister mscratch, size_t stack_adjust)
   EmitBranch(scratch.AsCoreRegister(), ZERO, slow->Entry(), false);
 }
 
+void MipsAssembler::BranchIfBitSet(ManagedRegister mbase, MemberOffset offs, uint32_t mask,
+                                   ManagedRegister mscratch, Label* label) {
+  CHECK(IsPowerOfTwo(mask));
+  MipsManagedRegister base = mbase.AsMips();
+  MipsManagedRegister scratch = mscratch.AsMips();
+  LoadFromOffset(kLoadWord, scratch.AsCoreRegister(), base.AsCoreRegister(), offs.Int32Value());
+  // The mask may not fit an andi immediate, so shift the bit down to bit 0 first.
+  Srl(scratch.AsCoreRegister(), scratch.AsCoreRegister(), CTZ(mask));
+  Andi(scratch.AsCoreRegister(), scratch.AsCoreRegister(), 1);
+  EmitBranch(scratch.AsCoreRegister(), ZERO, label, false);
+}
+
 void MipsExceptionSlowPath::Emit(Assembler* sasm) {
   MipsAssembler* sp_asm = down_cast<MipsAssembler*>(sasm);
 #define __ sp_asm->
@@ -150,6 +150,7 @@ class MipsAssembler FINAL : public Assembler {
   void EmitBranch(Register rt, Register rs, Label* label, bool equal);
   void EmitJump(Label* label, bool link);
   void Bind(Label* label, bool is_jump);
+  void Bind(Label* label) OVERRIDE;
 
   //
   // Overridden common assembler high-level functionality
@@ -267,6 +268,9 @@ class MipsAssembler FINAL : public Assembler {
   // and branch to a ExceptionSlowPath if it is.
   void ExceptionPoll(ManagedRegister mscratch, size_t stack_adjust) OVERRIDE;
 
+  void BranchIfBitSet(ManagedRegister mbase, MemberOffset offs, uint32_t mask,
+                      ManagedRegister mscratch, Label* label) OVERRIDE;
+
  private:
   void EmitR(int opcode, Register rs, Register rt, Register rd, int shamt, int funct);
   void EmitI(int opcode, Register rs, Register rt, uint16_t imm);
@@ -851,6 +851,13 @@ void X86Assembler::andl(Register dst, const Immediate& imm) {
 }
 
 
+void X86Assembler::andl(Register dst, const Address& address) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x23);
+  EmitOperand(dst, address);
+}
+
+
 void X86Assembler::orl(Register dst, Register src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x0B);
@@ -864,6 +871,13 @@ void X86Assembler::orl(Register dst, const Immediate& imm) {
 }
 
 
+void X86Assembler::orl(Register dst, const Address& address) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x0B);
+  EmitOperand(dst, address);
+}
+
+
 void X86Assembler::xorl(Register dst, Register src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x33);
@@ -875,6 +889,13 @@ void X86Assembler::xorl(Register dst, const Immediate& imm) {
   EmitComplex(6, Operand(dst), imm);
 }
 
+
+void X86Assembler::xorl(Register dst, const Address& address) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x33);
+  EmitOperand(dst, address);
+}
+
 void X86Assembler::addl(Register reg, const Immediate& imm) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitComplex(0, Operand(reg), imm);
@@ -1083,6 +1104,14 @@ void X86Assembler::shld(Register dst, Register src) {
 }
 
 
+void X86Assembler::shrd(Register dst, Register src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x0F);
+  EmitUint8(0xAD);
+  EmitRegisterOperand(src, dst);
+}
+
+
 void X86Assembler::negl(Register reg) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0xF7);
@@ -1839,6 +1868,16 @@ void X86Assembler::ExceptionPoll(ManagedRegister /*scratch*/, size_t stack_adjus
   j(kNotEqual, slow->Entry());
 }
 
+void X86Assembler::BranchIfBitSet(ManagedRegister mbase, MemberOffset offs, uint32_t mask,
+                                  ManagedRegister mscratch, Label* label) {
+  CHECK(IsPowerOfTwo(mask));
+  X86ManagedRegister base = mbase.AsX86();
+  X86ManagedRegister scratch = mscratch.AsX86();
+  movl(scratch.AsCpuRegister(), Address(base.AsCpuRegister(), offs));
+  testl(scratch.AsCpuRegister(), Immediate(mask));
+  j(kNotZero, label);
+}
+
 void X86ExceptionSlowPath::Emit(Assembler *sasm) {
   X86Assembler* sp_asm = down_cast<X86Assembler*>(sasm);
 #define __ sp_asm->
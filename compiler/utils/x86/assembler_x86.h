@@ -350,12 +350,15 @@ class X86Assembler FINAL : public Assembler {
 
   void andl(Register dst, const Immediate& imm);
   void andl(Register dst, Register src);
+  void andl(Register dst, const Address& address);
 
   void orl(Register dst, const Immediate& imm);
   void orl(Register dst, Register src);
+  void orl(Register dst, const Address& address);
 
   void xorl(Register dst, Register src);
   void xorl(Register dst, const Immediate& imm);
+  void xorl(Register dst, const Address& address);
 
   void addl(Register dst, Register src);
   void addl(Register reg, const Immediate& imm);
@@ -403,6 +406,7 @@ class X86Assembler FINAL : public Assembler {
   void sarl(Register reg, const Immediate& imm);
   void sarl(Register operand, Register shifter);
   void shld(Register dst, Register src);
+  void shrd(Register dst, Register src);
 
   void negl(Register reg);
   void notl(Register reg);
@@ -453,7 +457,7 @@ class X86Assembler FINAL : public Assembler {
   //
   int PreferredLoopAlignment() { return 16; }
   void Align(int alignment, int offset);
-  void Bind(Label* label);
+  void Bind(Label* label) OVERRIDE;
 
   //
   // Overridden common assembler high-level functionality
@@ -571,6 +575,9 @@ class X86Assembler FINAL : public Assembler {
   // and branch to a ExceptionSlowPath if it is.
   void ExceptionPoll(ManagedRegister scratch, size_t stack_adjust) OVERRIDE;
 
+  void BranchIfBitSet(ManagedRegister base, MemberOffset offs, uint32_t mask,
+                      ManagedRegister scratch, Label* label) OVERRIDE;
+
  private:
   inline void EmitUint8(uint8_t value);
   inline void EmitInt32(int32_t value);
@@ -293,6 +293,7 @@ class X86_64Assembler FINAL : public Assembler {
   void movzxw(CpuRegister dst, const Address& src);
   void movsxw(CpuRegister dst, CpuRegister src);
   void movsxw(CpuRegister dst, const Address& src);
+  void movsxd(CpuRegister dst, CpuRegister src);
   void movw(CpuRegister dst, const Address& src);
   void movw(const Address& dst, CpuRegister src);
 
@@ -396,11 +397,14 @@ class X86_64Assembler FINAL : public Assembler {
   void andl(CpuRegister dst, const Immediate& imm);
   void andl(CpuRegister dst, CpuRegister src);
   void andq(CpuRegister dst, const Immediate& imm);
+  void andq(CpuRegister dst, CpuRegister src);
 
   void orl(CpuRegister dst, const Immediate& imm);
   void orl(CpuRegister dst, CpuRegister src);
+  void orq(CpuRegister dst, CpuRegister src);
 
   void xorl(CpuRegister dst, CpuRegister src);
+  void xorl(CpuRegister dst, const Immediate& imm);
   void xorq(CpuRegister dst, const Immediate& imm);
   void xorq(CpuRegister dst, CpuRegister src);
 
@@ -423,8 +427,10 @@ class X86_64Assembler FINAL : public Assembler {
   void subq(CpuRegister dst, const Address& address);
 
   void cdq();
+  void cqo();
 
   void idivl(CpuRegister reg);
+  void idivq(CpuRegister reg);
 
   void imull(CpuRegister dst, CpuRegister src);
   void imull(CpuRegister reg, const Immediate& imm);
@@ -433,6 +439,8 @@ class X86_64Assembler FINAL : public Assembler {
   void imull(CpuRegister reg);
   void imull(const Address& address);
 
+  void imulq(CpuRegister dst, CpuRegister src);
+
   void mull(CpuRegister reg);
   void mull(const Address& address);
 
@@ -443,9 +451,15 @@ class X86_64Assembler FINAL : public Assembler {
   void sarl(CpuRegister reg, const Immediate& imm);
   void sarl(CpuRegister operand, CpuRegister shifter);
 
+  void shlq(CpuRegister reg, const Immediate& imm);
+  void shlq(CpuRegister operand, CpuRegister shifter);
   void shrq(CpuRegister reg, const Immediate& imm);
+  void shrq(CpuRegister operand, CpuRegister shifter);
+  void sarq(CpuRegister reg, const Immediate& imm);
+  void sarq(CpuRegister operand, CpuRegister shifter);
 
   void negl(CpuRegister reg);
+  void negq(CpuRegister reg);
   void notl(CpuRegister reg);
 
   void enter(const Immediate& imm);
@@ -495,7 +509,7 @@ class X86_64Assembler FINAL : public Assembler {
   //
   int PreferredLoopAlignment() { return 16; }
   void Align(int alignment, int offset);
-  void Bind(Label* label);
+  void Bind(Label* label) OVERRIDE;
 
   //
   // Overridden common assembler high-level functionality
@@ -614,6 +628,9 @@ class X86_64Assembler FINAL : public Assembler {
   // and branch to a ExceptionSlowPath if it is.
   void ExceptionPoll(ManagedRegister scratch, size_t stack_adjust) OVERRIDE;
 
+  void BranchIfBitSet(ManagedRegister base, MemberOffset offs, uint32_t mask,
+                      ManagedRegister scratch, Label* label) OVERRIDE;
+
  private:
   void EmitUint8(uint8_t value);
   void EmitInt32(int32_t value);
@@ -631,7 +648,7 @@ class X86_64Assembler FINAL : public Assembler {
   void EmitNearLabelLink(Label* label);
 
   void EmitGenericShift(bool wide, int rm, CpuRegister reg, const Immediate& imm);
-  void EmitGenericShift(int rm, CpuRegister operand, CpuRegister shifter);
+  void EmitGenericShift(bool wide, int rm, CpuRegister operand, CpuRegister shifter);
 
   // If any input is not false, output the necessary rex prefix.
   void EmitOptionalRex(bool force, bool w, bool r, bool x, bool b);
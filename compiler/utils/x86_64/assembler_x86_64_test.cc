@@ -125,6 +125,81 @@ TEST_F(AssemblerX86_64Test, XorqImm) {
   DriverStr(RepeatRI(&x86_64::X86_64Assembler::xorq, 4U, "xorq ${imm}, %{reg}"), "xorqi");
 }
 
+
+TEST_F(AssemblerX86_64Test, AndqRegs) {
+  DriverStr(RepeatRR(&x86_64::X86_64Assembler::andq, "andq %{reg2}, %{reg1}"), "andq");
+}
+
+TEST_F(AssemblerX86_64Test, OrqRegs) {
+  DriverStr(RepeatRR(&x86_64::X86_64Assembler::orq, "orq %{reg2}, %{reg1}"), "orq");
+}
+
+TEST_F(AssemblerX86_64Test, ImulqRegs) {
+  DriverStr(RepeatRR(&x86_64::X86_64Assembler::imulq, "imulq %{reg2}, %{reg1}"), "imulq");
+}
+
+TEST_F(AssemblerX86_64Test, Negq) {
+  DriverStr(RepeatR(&x86_64::X86_64Assembler::negq, "negq %{reg}"), "negq");
+}
+
+TEST_F(AssemblerX86_64Test, Movsxd) {
+  GetAssembler()->movsxd(x86_64::CpuRegister(x86_64::R8), x86_64::CpuRegister(x86_64::R11));
+  GetAssembler()->movsxd(x86_64::CpuRegister(x86_64::RAX), x86_64::CpuRegister(x86_64::RCX));
+  const char* expected =
+    "movslq %R11d, %R8\n"
+    "movslq %ECX, %RAX\n";
+
+  DriverStr(expected, "movsxd");
+}
+
+TEST_F(AssemblerX86_64Test, ShiftsExtendedRegisters) {
+  GetAssembler()->shll(x86_64::CpuRegister(x86_64::R8), x86_64::Immediate(3));
+  GetAssembler()->sarl(x86_64::CpuRegister(x86_64::R9), x86_64::CpuRegister(x86_64::RCX));
+  GetAssembler()->shrl(x86_64::CpuRegister(x86_64::R15), x86_64::Immediate(1));
+  const char* expected =
+    "shll $3, %R8d\n"
+    "sarl %cl, %R9d\n"
+    "shrl $1, %R15d\n";
+
+  DriverStr(expected, "shifts");
+}
+
+TEST_F(AssemblerX86_64Test, ShiftqImm) {
+  GetAssembler()->shlq(x86_64::CpuRegister(x86_64::R8), x86_64::Immediate(1));
+  GetAssembler()->shrq(x86_64::CpuRegister(x86_64::RAX), x86_64::Immediate(33));
+  GetAssembler()->sarq(x86_64::CpuRegister(x86_64::R15), x86_64::Immediate(63));
+  const char* expected =
+    "shlq $1, %R8\n"
+    "shrq $33, %RAX\n"
+    "sarq $63, %R15\n";
+
+  DriverStr(expected, "shiftqi");
+}
+
+TEST_F(AssemblerX86_64Test, ShiftqRegs) {
+  GetAssembler()->shlq(x86_64::CpuRegister(x86_64::R8), x86_64::CpuRegister(x86_64::RCX));
+  GetAssembler()->shrq(x86_64::CpuRegister(x86_64::RAX), x86_64::CpuRegister(x86_64::RCX));
+  GetAssembler()->sarq(x86_64::CpuRegister(x86_64::R15), x86_64::CpuRegister(x86_64::RCX));
+  const char* expected =
+    "shlq %cl, %R8\n"
+    "shrq %cl, %RAX\n"
+    "sarq %cl, %R15\n";
+
+  DriverStr(expected, "shiftq");
+}
+
+TEST_F(AssemblerX86_64Test, Idivq) {
+  GetAssembler()->cqo();
+  GetAssembler()->idivq(x86_64::CpuRegister(x86_64::R9));
+  GetAssembler()->idivq(x86_64::CpuRegister(x86_64::RCX));
+  const char* expected =
+    "cqto\n"
+    "idivq %R9\n"
+    "idivq %RCX\n";
+
+  DriverStr(expected, "idivq");
+}
+
 TEST_F(AssemblerX86_64Test, Movl) {
   GetAssembler()->movl(x86_64::CpuRegister(x86_64::R8), x86_64::CpuRegister(x86_64::R11));
   GetAssembler()->movl(x86_64::CpuRegister(x86_64::RAX), x86_64::CpuRegister(x86_64::R11));
@@ -44,6 +44,7 @@
 #include "dex/quick/dex_file_to_method_inliner_map.h"
 #include "driver/compiler_driver.h"
 #include "driver/compiler_options.h"
+#include "driver/reused_oat_file.h"
 #include "elf_fixup.h"
 #include "elf_patcher.h"
 #include "elf_stripper.h"
@@ -221,6 +222,11 @@ static void Usage(const char* fmt, ...) {
   UsageError("");
   UsageError("  --profile-file=<filename>: specify profiler output file to use for compilation.");
   UsageError("");
+  UsageError("  --reuse-oat=<file.oat>: copy the compiled code of methods that have not changed");
+  UsageError("      since a previous compilation of the same application with the same options");
+  UsageError("      instead of compiling them again. Not supported with --image.");
+  UsageError("      Example: --reuse-oat=/data/dalvik-cache/x86/app.oat");
+  UsageError("");
   UsageError("  --print-pass-names: print a list of pass names");
   UsageError("");
   UsageError("  --disable-passes=<pass-names>:  disable one or more passes separated by comma.");
@@ -355,6 +361,7 @@ class Dex2Oat {
                                       TimingLogger& timings,
                                       CumulativeLogger& compiler_phases_timings,
                                       std::string profile_file,
+                                      const std::string& reuse_oat_filename,
                                       SafeMap<std::string, std::string>* key_value_store) {
     CHECK(key_value_store != nullptr);
 
@@ -392,6 +399,24 @@ class Dex2Oat {
 
     driver->GetCompiler()->SetBitcodeFileName(*driver.get(), bitcode_filename);
 
+    if (!reuse_oat_filename.empty()) {
+      TimingLogger::ScopedTiming t("Opening reused oat file", &timings);
+      const ImageHeader& image_header =
+          Runtime::Current()->GetHeap()->GetImageSpace()->GetImageHeader();
+      std::string error_msg;
+      ReusedOatFile* reused_oat_file = ReusedOatFile::Open(
+          reuse_oat_filename, instruction_set_, instruction_set_features_,
+          image_header.GetOatChecksum(),
+          reinterpret_cast<uintptr_t>(image_header.GetOatDataBegin()),
+          image_header.GetPatchDelta(), *key_value_store, &error_msg);
+      if (reused_oat_file == nullptr) {
+        LOG(WARNING) << "Compiling all methods, cannot reuse " << reuse_oat_filename << ": "
+                     << error_msg;
+      } else {
+        driver->SetReusedOatFile(reused_oat_file);
+      }
+    }
+
     driver->CompileAll(class_loader, dex_files, &timings);
 
     TimingLogger::ScopedTiming t2("dex2oat OatWriter", &timings);
@@ -732,6 +757,12 @@ static InstructionSetFeatures ParseFeatureList(std::string str) {
     } else if (feature == "nolpae") {
       // Turn off support for Large Physical Address Extension.
       result.SetHasLpae(false);
+    } else if (feature == "sse4.1") {
+      // Supports SSE4.1 (x86 and x86-64 only).
+      result.SetHasSse4_1(true);
+    } else if (feature == "nosse4.1") {
+      // Turn off support for SSE4.1.
+      result.SetHasSse4_1(false);
     } else {
       Usage("Unknown instruction set feature: '%s'", feature.c_str());
     }
@@ -842,6 +873,7 @@ static int dex2oat(int argc, char** argv) {
 
   // Profile file to use
   std::string profile_file;
+  std::string reuse_oat_filename;
   double top_k_profile_threshold = CompilerOptions::kDefaultTopKProfileThreshold;
 
   bool is_host = false;
@@ -1017,6 +1049,8 @@ static int dex2oat(int argc, char** argv) {
     } else if (option.starts_with("--profile-file=")) {
       profile_file = option.substr(strlen("--profile-file=")).data();
       VLOG(compiler) << "dex2oat: profile file is " << profile_file;
+    } else if (option.starts_with("--reuse-oat=")) {
+      reuse_oat_filename = option.substr(strlen("--reuse-oat=")).data();
     } else if (option == "--no-profile-file") {
       // No profile
     } else if (option.starts_with("--top-k-profile-threshold=")) {
@@ -1094,6 +1128,18 @@ static int dex2oat(int argc, char** argv) {
     Usage("--image-classes-zip should be used with --image-classes");
   }
 
+  if (!reuse_oat_filename.empty()) {
+    if (image) {
+      Usage("--reuse-oat should not be used with --image");
+    }
+    if (include_patch_information) {
+      Usage("--reuse-oat should not be used with --include-patch-information");
+    }
+    if (compiler_kind == Compiler::kPortable) {
+      Usage("--reuse-oat is not supported by the portable backend");
+    }
+  }
+
   if (dex_filenames.empty() && zip_fd == -1) {
     Usage("Input must be supplied with either --dex-file or --zip-fd");
   }
@@ -1358,6 +1404,7 @@ static int dex2oat(int argc, char** argv) {
     }
     if (num_methods <= compiler_options->GetNumDexMethodsThreshold()) {
       compiler_options->SetCompilerFilter(CompilerOptions::kSpeed);
+      compiler_filter_string = "speed";
       VLOG(compiler) << "Below method threshold, compiling anyways";
     }
   }
@@ -1378,6 +1425,7 @@ static int dex2oat(int argc, char** argv) {
   oss.str("");  // Reset.
   oss << kRuntimeISA;
   key_value_store->Put(OatHeader::kDex2OatHostKey, oss.str());
+  key_value_store->Put(OatHeader::kCompilerFilterKey, compiler_filter_string);
 
   std::unique_ptr<const CompilerDriver> compiler(dex2oat->CreateOatFile(boot_image_option,
                                                                         android_root,
@@ -1393,6 +1441,7 @@ static int dex2oat(int argc, char** argv) {
                                                                         timings,
                                                                         compiler_phases_timings,
                                                                         profile_file,
+                                                                        reuse_oat_filename,
                                                                         key_value_store.get()));
   if (compiler.get() == nullptr) {
     LOG(ERROR) << "Failed to create oat file: " << oat_location;
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/stl_util.h"
+#include "base/stringpiece.h"
+#include "base/stringprintf.h"
+#include "binary_profile.h"
+#include "dex_file.h"
+#include "utils.h"
+
+namespace art {
+
+static int orig_argc;
+static char** orig_argv;
+
+static std::string CommandLine() {
+  std::vector<std::string> command;
+  for (int i = 0; i < orig_argc; ++i) {
+    command.push_back(orig_argv[i]);
+  }
+  return Join(command, ' ');
+}
+
+static void UsageErrorV(const char* fmt, va_list ap) {
+  std::string error;
+  StringAppendV(&error, fmt, ap);
+  LOG(ERROR) << error;
+}
+
+static void UsageError(const char* fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  UsageErrorV(fmt, ap);
+  va_end(ap);
+}
+
+static void Usage(const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  UsageErrorV(fmt, ap);
+  va_end(ap);
+
+  UsageError("Command: %s", CommandLine().c_str());
+  UsageError("Usage: profman [options]...");
+  UsageError("  Merges profiles into the binary profile format and dumps them.");
+  UsageError("");
+  UsageError("  --profile-file=<file>: a binary or text profile to merge. May be specified");
+  UsageError("      multiple times. Text profiles name their methods, so they can only be");
+  UsageError("      converted for the methods of the dex files given with --dex-file.");
+  UsageError("");
+  UsageError("  --dex-file=<file.dex|file.apk>: a dex file the profiles refer to. Used to");
+  UsageError("      convert text profiles and to print method names. May be specified");
+  UsageError("      multiple times.");
+  UsageError("");
+  UsageError("  --output-file=<file>: write the merged profile to the file, which is");
+  UsageError("      locked and replaced.");
+  UsageError("");
+  UsageError("  --dump: print the merged profile to stdout, hottest methods first.");
+  UsageError("");
+
+  exit(EXIT_FAILURE);
+}
+
+static bool WriteProfileFile(const std::string& filename, const BinaryProfile& profile,
+                             std::string* error_msg) {
+  int fd = TEMP_FAILURE_RETRY(open(filename.c_str(), O_WRONLY | O_CREAT, 0644));
+  if (fd < 0) {
+    *error_msg = StringPrintf("Failed to open %s: %s", filename.c_str(), strerror(errno));
+    return false;
+  }
+  // Take the same lock as the profiler, which may be updating the file.
+  bool success = true;
+  if (TEMP_FAILURE_RETRY(flock(fd, LOCK_EX)) != 0) {
+    *error_msg = StringPrintf("Failed to lock %s: %s", filename.c_str(), strerror(errno));
+    success = false;
+  } else if (ftruncate(fd, 0) != 0) {
+    *error_msg = StringPrintf("Failed to truncate %s: %s", filename.c_str(), strerror(errno));
+    success = false;
+  } else {
+    success = profile.Save(fd, error_msg);
+  }
+  close(fd);
+  return success;
+}
+
+static int profman(int argc, char** argv) {
+  InitLogging(argv);
+  orig_argc = argc;
+  orig_argv = argv;
+
+  // Skip over the command name.
+  argv++;
+  argc--;
+
+  if (argc == 0) {
+    Usage("No arguments specified");
+  }
+
+  std::vector<std::string> profile_files;
+  std::vector<std::string> dex_filenames;
+  std::string output_file;
+  bool dump = false;
+  for (int i = 0; i < argc; ++i) {
+    const StringPiece option(argv[i]);
+    if (option.starts_with("--profile-file=")) {
+      profile_files.push_back(option.substr(strlen("--profile-file=")).ToString());
+    } else if (option.starts_with("--dex-file=")) {
+      dex_filenames.push_back(option.substr(strlen("--dex-file=")).ToString());
+    } else if (option.starts_with("--output-file=")) {
+      output_file = option.substr(strlen("--output-file=")).ToString();
+    } else if (option == "--dump") {
+      dump = true;
+    } else {
+      Usage("Unknown argument %s", option.data());
+    }
+  }
+  if (profile_files.empty()) {
+    Usage("No --profile-file specified");
+  }
+  if (output_file.empty() && !dump) {
+    Usage("Nothing to do, specify --output-file or --dump");
+  }
+
+  std::vector<const DexFile*> dex_files;
+  for (const std::string& dex_filename : dex_filenames) {
+    std::string error_msg;
+    if (!DexFile::Open(dex_filename.c_str(), dex_filename.c_str(), &error_msg, &dex_files)) {
+      LOG(ERROR) << "Failed to open dex file " << dex_filename << ": " << error_msg;
+      return EXIT_FAILURE;
+    }
+  }
+
+  BinaryProfile profile;
+  for (const std::string& profile_file : profile_files) {
+    std::string error_msg;
+    size_t num_unknown = 0u;
+    if (!profile.MergeFile(profile_file, dex_files, &num_unknown, &error_msg)) {
+      LOG(ERROR) << "Failed to merge profile " << profile_file << ": " << error_msg;
+      return EXIT_FAILURE;
+    }
+    if (num_unknown != 0u) {
+      LOG(WARNING) << "Dropped " << num_unknown << " methods of " << profile_file
+                   << " that are not defined in the given dex files";
+    }
+  }
+
+  if (!output_file.empty()) {
+    std::string error_msg;
+    if (!WriteProfileFile(output_file, profile, &error_msg)) {
+      LOG(ERROR) << error_msg;
+      return EXIT_FAILURE;
+    }
+  }
+  if (dump) {
+    profile.Dump(std::cout, dex_files);
+  }
+  STLDeleteElements(&dex_files);
+  return EXIT_SUCCESS;
+}
+
+}  // namespace art
+
+int main(int argc, char** argv) {
+  return art::profman(argc, argv);
+}
@@ -35,8 +35,10 @@ LIBART_COMMON_SRC_FILES := \
   base/unix_file/null_file.cc \
   base/unix_file/random_access_file_utils.cc \
   base/unix_file/string_file.cc \
+  binary_profile.cc \
   check_jni.cc \
   class_linker.cc \
+  class_table.cc \
   common_throws.cc \
   debugger.cc \
   dex_file.cc \
@@ -69,6 +71,7 @@ LIBART_COMMON_SRC_FILES := \
   gc/space/image_space.cc \
   gc/space/large_object_space.cc \
   gc/space/malloc_space.cc \
+  gc/space/region_space.cc \
   gc/space/rosalloc_space.cc \
   gc/space/space.cc \
   gc/space/zygote_space.cc \
@@ -79,6 +82,8 @@ LIBART_COMMON_SRC_FILES := \
   instrumentation.cc \
   intern_table.cc \
   interpreter/interpreter.cc \
+  interpreter/inline_cache.cc \
+  interpreter/interpreter_asm_impl.cc \
   interpreter/interpreter_common.cc \
   interpreter/interpreter_switch_impl.cc \
   jdwp/jdwp_event.cc \
@@ -88,6 +93,8 @@ LIBART_COMMON_SRC_FILES := \
   jdwp/jdwp_request.cc \
   jdwp/jdwp_socket.cc \
   jdwp/object_registry.cc \
+  jit/jit.cc \
+  jit/jit_code_cache.cc \
   jni_internal.cc \
   jobject_comparator.cc \
   mem_map.cc \
@@ -222,7 +229,8 @@ LIBART_TARGET_SRC_FILES_arm := \
   arch/arm/quick_entrypoints_arm.S \
   arch/arm/arm_sdiv.S \
   arch/arm/thread_arm.cc \
-  arch/arm/fault_handler_arm.cc
+  arch/arm/fault_handler_arm.cc \
+  arch/arm/interpreter_arm.S
 
 LIBART_TARGET_SRC_FILES_arm64 := \
   arch/arm64/context_arm64.cc \
@@ -251,6 +259,7 @@ LIBART_TARGET_SRC_FILES_x86 := \
 LIBART_SRC_FILES_x86_64 := \
   arch/x86_64/context_x86_64.cc \
   arch/x86_64/entrypoints_init_x86_64.cc \
+  arch/x86_64/interpreter_x86_64.S \
   arch/x86_64/jni_entrypoints_x86_64.S \
   arch/x86_64/portable_entrypoints_x86_64.S \
   arch/x86_64/quick_entrypoints_x86_64.S \
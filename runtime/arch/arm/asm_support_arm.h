@@ -28,6 +28,12 @@
 // Offset of field Thread::tlsPtr_.exception verified in InitCpu
 #define THREAD_EXCEPTION_OFFSET 116
 
+// Offsets of fields ShadowFrame::dex_pc_, ShadowFrame::number_of_vregs_ and
+// ShadowFrame::vregs_ verified in InitCpu
+#define SHADOWFRAME_DEX_PC_OFFSET 12
+#define SHADOWFRAME_NUMBER_OF_VREGS_OFFSET 0
+#define SHADOWFRAME_VREGS_OFFSET 16
+
 #define FRAME_SIZE_SAVE_ALL_CALLEE_SAVE 176
 #define FRAME_SIZE_REFS_ONLY_CALLEE_SAVE 32
 #define FRAME_SIZE_REFS_AND_ARGS_CALLEE_SAVE 48
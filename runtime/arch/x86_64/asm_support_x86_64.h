@@ -27,6 +27,8 @@
 // Offset of field Runtime::callee_save_methods_[kRefsAndArgs]
 #define RUNTIME_REF_AND_ARGS_CALLEE_SAVE_FRAME_OFFSET 16
 
+// Offset of field Thread::tls32_.state_and_flags verified in InitCpu
+#define THREAD_FLAGS_OFFSET 0
 // Offset of field Thread::self_ verified in InitCpu
 #define THREAD_SELF_OFFSET 184
 // Offset of field Thread::card_table_ verified in InitCpu
@@ -36,6 +38,12 @@
 // Offset of field Thread::thin_lock_thread_id_ verified in InitCpu
 #define THREAD_ID_OFFSET 12
 
+// Offsets of fields ShadowFrame::dex_pc_, ShadowFrame::number_of_vregs_ and
+// ShadowFrame::vregs_ verified in InitCpu
+#define SHADOWFRAME_DEX_PC_OFFSET 24
+#define SHADOWFRAME_NUMBER_OF_VREGS_OFFSET 0
+#define SHADOWFRAME_VREGS_OFFSET 28
+
 #define FRAME_SIZE_SAVE_ALL_CALLEE_SAVE 64 + 4*8
 #define FRAME_SIZE_REFS_ONLY_CALLEE_SAVE 64 + 4*8
 #define FRAME_SIZE_REFS_AND_ARGS_CALLEE_SAVE 176 + 4*8
@@ -27,6 +27,11 @@
 #define CLASS_OFFSET 0
 #define LOCK_WORD_OFFSET 4
 
+// Values returned by the runtime helpers of the assembly interpreter.
+#define ASM_INTERP_CONTINUE 0
+#define ASM_INTERP_EXCEPTION 1
+#define ASM_INTERP_FALLBACK 2
+
 #ifndef USE_BAKER_OR_BROOKS_READ_BARRIER
 
 // Offsets within java.lang.Class.
@@ -35,6 +40,8 @@
 // Array offsets.
 #define ARRAY_LENGTH_OFFSET 8
 #define OBJECT_ARRAY_DATA_OFFSET 12
+#define INT_ARRAY_DATA_OFFSET 12
+#define LONG_ARRAY_DATA_OFFSET 16
 
 // Offsets within java.lang.String.
 #define STRING_VALUE_OFFSET 8
@@ -55,6 +62,8 @@
 // Array offsets.
 #define ARRAY_LENGTH_OFFSET 16
 #define OBJECT_ARRAY_DATA_OFFSET 20
+#define INT_ARRAY_DATA_OFFSET 20
+#define LONG_ARRAY_DATA_OFFSET 24
 
 // Offsets within java.lang.String.
 #define STRING_VALUE_OFFSET 16
@@ -305,6 +305,7 @@ struct LogVerbosity {
   bool gc;
   bool heap;
   bool jdwp;
+  bool jit;
   bool jni;
   bool monitor;
   bool profiler;
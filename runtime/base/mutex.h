@@ -63,6 +63,9 @@ enum LockLevel {
   kRosAllocGlobalLock,
   kRosAllocBracketLock,
   kRosAllocBulkFreeLock,
+  kBumpPointerSpaceBlockLock,
+  kRegionSpaceRegionLock,
+  kConcurrentCopyingMarkStackLock,
   kAllocSpaceLock,
   kReferenceProcessorLock,
   kDexFileMethodInlinerLock,
@@ -71,6 +74,8 @@ enum LockLevel {
   kTransactionLogLock,
   kInternTableLock,
   kDefaultMutexLevel,
+  kJitCodeCacheLock,
+  kJitSamplesLock,
   kMarkSweepLargeObjectLock,
   kPinTableLock,
   kLoadLibraryLock,
@@ -0,0 +1,532 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "binary_profile.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+#include "base/logging.h"
+#include "base/stringprintf.h"
+#include "dex_file.h"
+#include "leb128.h"
+#include "method_reference.h"
+#include "utils.h"
+
+namespace art {
+
+const uint8_t BinaryProfile::kMagic[] = { 'p', 'r', 'o', '\0' };
+const uint8_t BinaryProfile::kVersion[] = { '0', '0', '2', '\0' };
+const uint8_t BinaryProfile::kVersionWithoutCallSites[] = { '0', '0', '1', '\0' };
+
+static uint32_t SaturatingAdd(uint32_t lhs, uint32_t rhs) {
+  return (lhs > std::numeric_limits<uint32_t>::max() - rhs)
+      ? std::numeric_limits<uint32_t>::max()
+      : lhs + rhs;
+}
+
+// Bounds checked reader for serialized profiles, which may come from truncated files.
+class BinaryProfileReader {
+ public:
+  BinaryProfileReader(const uint8_t* data, size_t size) : ptr_(data), end_(data + size) {}
+
+  bool ReadUnsignedLeb128(uint32_t* value) {
+    uint32_t result = 0u;
+    for (uint32_t shift = 0u; shift < 35u; shift += 7u) {
+      if (ptr_ == end_) {
+        return false;
+      }
+      uint8_t byte = *ptr_++;
+      result |= static_cast<uint32_t>(byte & 0x7fu) << shift;
+      if ((byte & 0x80u) == 0u) {
+        *value = result;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadUint32(uint32_t* value) {
+    uint8_t bytes[4];
+    if (!ReadBytes(bytes, sizeof(bytes))) {
+      return false;
+    }
+    *value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) |
+        (static_cast<uint32_t>(bytes[3]) << 24);
+    return true;
+  }
+
+  bool ReadBytes(void* dest, size_t size) {
+    if (static_cast<size_t>(end_ - ptr_) < size) {
+      return false;
+    }
+    memcpy(dest, ptr_, size);
+    ptr_ += size;
+    return true;
+  }
+
+  bool IsAtEnd() const {
+    return ptr_ == end_;
+  }
+
+ private:
+  const uint8_t* ptr_;
+  const uint8_t* const end_;
+
+  DISALLOW_COPY_AND_ASSIGN(BinaryProfileReader);
+};
+
+bool BinaryProfile::HasMagic(const uint8_t* data, size_t size) {
+  return size >= sizeof(kMagic) && memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+void BinaryProfile::AddSummary(uint32_t num_samples, uint32_t num_null_methods,
+                               uint32_t num_boot_methods) {
+  num_samples_ = SaturatingAdd(num_samples_, num_samples);
+  num_null_methods_ = SaturatingAdd(num_null_methods_, num_null_methods);
+  num_boot_methods_ = SaturatingAdd(num_boot_methods_, num_boot_methods);
+}
+
+BinaryProfile::DexFileData* BinaryProfile::GetOrAddDexFile(const std::string& dex_location,
+                                                           uint32_t dex_location_checksum) {
+  auto dex_lb = dex_files_.lower_bound(dex_location_checksum);
+  if (dex_lb == dex_files_.end() || dex_files_.key_comp()(dex_location_checksum, dex_lb->first)) {
+    DexFileData data;
+    data.location = dex_location;
+    dex_lb = dex_files_.PutBefore(dex_lb, dex_location_checksum, data);
+  }
+  return &dex_lb->second;
+}
+
+void BinaryProfile::AddMethodSamples(const std::string& dex_location,
+                                     uint32_t dex_location_checksum, uint32_t method_idx,
+                                     uint32_t count) {
+  SafeMap<uint32_t, uint32_t>* method_samples =
+      &GetOrAddDexFile(dex_location, dex_location_checksum)->method_samples;
+  auto method_lb = method_samples->lower_bound(method_idx);
+  if (method_lb == method_samples->end() ||
+      method_samples->key_comp()(method_idx, method_lb->first)) {
+    method_samples->PutBefore(method_lb, method_idx, count);
+  } else {
+    method_lb->second = SaturatingAdd(method_lb->second, count);
+  }
+}
+
+void BinaryProfile::AddReceiverTypes(const std::string& dex_location,
+                                     uint32_t dex_location_checksum, uint32_t method_idx,
+                                     uint32_t dex_pc, const std::vector<std::string>& descriptors) {
+  auto* receiver_types = &GetOrAddDexFile(dex_location, dex_location_checksum)->receiver_types;
+  const std::pair<uint32_t, uint32_t> call_site(method_idx, dex_pc);
+  auto lb = receiver_types->lower_bound(call_site);
+  if (lb == receiver_types->end() || receiver_types->key_comp()(call_site, lb->first)) {
+    lb = receiver_types->PutBefore(lb, call_site, std::set<std::string>());
+  }
+  lb->second.insert(descriptors.begin(), descriptors.end());
+}
+
+void BinaryProfile::MergeWith(const BinaryProfile& other) {
+  AddSummary(other.num_samples_, other.num_null_methods_, other.num_boot_methods_);
+  other.VisitMethods([this](const std::string& dex_location, uint32_t dex_location_checksum,
+                            uint32_t method_idx, uint32_t count) {
+    AddMethodSamples(dex_location, dex_location_checksum, method_idx, count);
+  });
+  other.VisitCallSites([this](const std::string& dex_location, uint32_t dex_location_checksum,
+                              uint32_t method_idx, uint32_t dex_pc,
+                              const std::set<std::string>& descriptors) {
+    AddReceiverTypes(dex_location, dex_location_checksum, method_idx, dex_pc,
+                     std::vector<std::string>(descriptors.begin(), descriptors.end()));
+  });
+}
+
+bool BinaryProfile::GetReceiverTypes(uint32_t dex_location_checksum, uint32_t method_idx,
+                                     uint32_t dex_pc,
+                                     std::vector<std::string>* descriptors) const {
+  auto dex_it = dex_files_.find(dex_location_checksum);
+  if (dex_it == dex_files_.end()) {
+    return false;
+  }
+  auto it = dex_it->second.receiver_types.find(std::make_pair(method_idx, dex_pc));
+  if (it == dex_it->second.receiver_types.end()) {
+    return false;
+  }
+  descriptors->insert(descriptors->end(), it->second.begin(), it->second.end());
+  return true;
+}
+
+uint32_t BinaryProfile::GetMethodSamples(uint32_t dex_location_checksum,
+                                         uint32_t method_idx) const {
+  auto dex_it = dex_files_.find(dex_location_checksum);
+  if (dex_it == dex_files_.end()) {
+    return 0u;
+  }
+  auto method_it = dex_it->second.method_samples.find(method_idx);
+  return (method_it != dex_it->second.method_samples.end()) ? method_it->second : 0u;
+}
+
+size_t BinaryProfile::NumMethods() const {
+  size_t num_methods = 0u;
+  for (const auto& dex_entry : dex_files_) {
+    num_methods += dex_entry.second.method_samples.size();
+  }
+  return num_methods;
+}
+
+size_t BinaryProfile::NumCallSites() const {
+  size_t num_call_sites = 0u;
+  for (const auto& dex_entry : dex_files_) {
+    num_call_sites += dex_entry.second.receiver_types.size();
+  }
+  return num_call_sites;
+}
+
+void BinaryProfile::Serialize(std::vector<uint8_t>* out) const {
+  Leb128EncodingVector encoder;
+  encoder.PushBackUnsigned(num_samples_);
+  encoder.PushBackUnsigned(num_null_methods_);
+  encoder.PushBackUnsigned(num_boot_methods_);
+  encoder.PushBackUnsigned(dex_files_.size());
+  out->insert(out->end(), kMagic, kMagic + sizeof(kMagic));
+  out->insert(out->end(), kVersion, kVersion + sizeof(kVersion));
+  out->insert(out->end(), encoder.GetData().begin(), encoder.GetData().end());
+  for (const auto& dex_entry : dex_files_) {
+    uint32_t checksum = dex_entry.first;
+    for (size_t i = 0; i != 4u; ++i) {
+      out->push_back(static_cast<uint8_t>(checksum >> (8u * i)));
+    }
+    const DexFileData& data = dex_entry.second;
+    Leb128EncodingVector dex_encoder;
+    dex_encoder.PushBackUnsigned(data.location.size());
+    out->insert(out->end(), dex_encoder.GetData().begin(), dex_encoder.GetData().end());
+    out->insert(out->end(), data.location.begin(), data.location.end());
+    Leb128EncodingVector method_encoder;
+    method_encoder.PushBackUnsigned(data.method_samples.size());
+    uint32_t last_method_idx = 0u;
+    for (const auto& method_entry : data.method_samples) {
+      method_encoder.PushBackUnsigned(method_entry.first - last_method_idx);
+      method_encoder.PushBackUnsigned(method_entry.second);
+      last_method_idx = method_entry.first;
+    }
+    out->insert(out->end(), method_encoder.GetData().begin(), method_encoder.GetData().end());
+    Leb128EncodingVector call_site_encoder;
+    call_site_encoder.PushBackUnsigned(data.receiver_types.size());
+    last_method_idx = 0u;
+    out->insert(out->end(), call_site_encoder.GetData().begin(),
+                call_site_encoder.GetData().end());
+    for (const auto& call_site_entry : data.receiver_types) {
+      Leb128EncodingVector encoder;
+      encoder.PushBackUnsigned(call_site_entry.first.first - last_method_idx);
+      encoder.PushBackUnsigned(call_site_entry.first.second);
+      encoder.PushBackUnsigned(call_site_entry.second.size());
+      last_method_idx = call_site_entry.first.first;
+      out->insert(out->end(), encoder.GetData().begin(), encoder.GetData().end());
+      for (const std::string& descriptor : call_site_entry.second) {
+        Leb128EncodingVector size_encoder;
+        size_encoder.PushBackUnsigned(descriptor.size());
+        out->insert(out->end(), size_encoder.GetData().begin(), size_encoder.GetData().end());
+        out->insert(out->end(), descriptor.begin(), descriptor.end());
+      }
+    }
+  }
+}
+
+bool BinaryProfile::Deserialize(const uint8_t* data, size_t size, std::string* error_msg) {
+  BinaryProfileReader reader(data, size);
+  uint8_t magic[sizeof(kMagic)];
+  uint8_t version[sizeof(kVersion)];
+  if (!reader.ReadBytes(magic, sizeof(magic)) || memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+    *error_msg = "Not a binary profile";
+    return false;
+  }
+  if (!reader.ReadBytes(version, sizeof(version)) ||
+      (memcmp(version, kVersion, sizeof(kVersion)) != 0 &&
+       memcmp(version, kVersionWithoutCallSites, sizeof(kVersionWithoutCallSites)) != 0)) {
+    *error_msg = "Unsupported binary profile version";
+    return false;
+  }
+  const bool has_call_sites = memcmp(version, kVersion, sizeof(kVersion)) == 0;
+  BinaryProfile profile;
+  uint32_t num_samples;
+  uint32_t num_null_methods;
+  uint32_t num_boot_methods;
+  uint32_t num_dex_files;
+  if (!reader.ReadUnsignedLeb128(&num_samples) ||
+      !reader.ReadUnsignedLeb128(&num_null_methods) ||
+      !reader.ReadUnsignedLeb128(&num_boot_methods) ||
+      !reader.ReadUnsignedLeb128(&num_dex_files)) {
+    *error_msg = "Truncated binary profile header";
+    return false;
+  }
+  profile.AddSummary(num_samples, num_null_methods, num_boot_methods);
+  for (uint32_t i = 0; i != num_dex_files; ++i) {
+    uint32_t checksum;
+    uint32_t location_size;
+    if (!reader.ReadUint32(&checksum) || !reader.ReadUnsignedLeb128(&location_size)) {
+      *error_msg = StringPrintf("Truncated binary profile dex file %u", i);
+      return false;
+    }
+    std::string location(location_size, '\0');
+    uint32_t num_methods;
+    if (!reader.ReadBytes(&location[0], location_size) ||
+        !reader.ReadUnsignedLeb128(&num_methods)) {
+      *error_msg = StringPrintf("Truncated binary profile dex file %u", i);
+      return false;
+    }
+    uint32_t method_idx = 0u;
+    for (uint32_t j = 0; j != num_methods; ++j) {
+      uint32_t method_idx_delta;
+      uint32_t count;
+      if (!reader.ReadUnsignedLeb128(&method_idx_delta) || !reader.ReadUnsignedLeb128(&count)) {
+        *error_msg = StringPrintf("Truncated binary profile methods of %s", location.c_str());
+        return false;
+      }
+      method_idx += method_idx_delta;
+      profile.AddMethodSamples(location, checksum, method_idx, count);
+    }
+    uint32_t num_call_sites = 0u;
+    if (has_call_sites && !reader.ReadUnsignedLeb128(&num_call_sites)) {
+      *error_msg = StringPrintf("Truncated binary profile call sites of %s", location.c_str());
+      return false;
+    }
+    method_idx = 0u;
+    for (uint32_t j = 0; j != num_call_sites; ++j) {
+      uint32_t method_idx_delta;
+      uint32_t dex_pc;
+      uint32_t num_receivers;
+      if (!reader.ReadUnsignedLeb128(&method_idx_delta) || !reader.ReadUnsignedLeb128(&dex_pc) ||
+          !reader.ReadUnsignedLeb128(&num_receivers)) {
+        *error_msg = StringPrintf("Truncated binary profile call sites of %s", location.c_str());
+        return false;
+      }
+      method_idx += method_idx_delta;
+      std::vector<std::string> descriptors;
+      for (uint32_t k = 0; k != num_receivers; ++k) {
+        uint32_t descriptor_size;
+        if (!reader.ReadUnsignedLeb128(&descriptor_size)) {
+          *error_msg = StringPrintf("Truncated binary profile call sites of %s", location.c_str());
+          return false;
+        }
+        std::string descriptor(descriptor_size, '\0');
+        if (!reader.ReadBytes(&descriptor[0], descriptor_size)) {
+          *error_msg = StringPrintf("Truncated binary profile call sites of %s", location.c_str());
+          return false;
+        }
+        descriptors.push_back(descriptor);
+      }
+      profile.AddReceiverTypes(location, checksum, method_idx, dex_pc, descriptors);
+    }
+  }
+  if (!reader.IsAtEnd()) {
+    *error_msg = "Trailing data after binary profile";
+    return false;
+  }
+  MergeWith(profile);
+  return true;
+}
+
+bool BinaryProfile::Load(int fd, std::string* error_msg) {
+  std::vector<uint8_t> data;
+  uint8_t buffer[4 * KB];
+  while (true) {
+    ssize_t bytes_read = TEMP_FAILURE_RETRY(read(fd, buffer, sizeof(buffer)));
+    if (bytes_read < 0) {
+      *error_msg = StringPrintf("Failed to read profile: %s", strerror(errno));
+      return false;
+    }
+    if (bytes_read == 0) {
+      break;
+    }
+    data.insert(data.end(), buffer, buffer + bytes_read);
+  }
+  return Deserialize(data.data(), data.size(), error_msg);
+}
+
+bool BinaryProfile::Save(int fd, std::string* error_msg) const {
+  std::vector<uint8_t> data;
+  Serialize(&data);
+  const uint8_t* ptr = data.data();
+  size_t remaining = data.size();
+  while (remaining != 0u) {
+    ssize_t bytes_written = TEMP_FAILURE_RETRY(write(fd, ptr, remaining));
+    if (bytes_written < 0) {
+      *error_msg = StringPrintf("Failed to write profile: %s", strerror(errno));
+      return false;
+    }
+    ptr += bytes_written;
+    remaining -= bytes_written;
+  }
+  return true;
+}
+
+// Maps the names used by text profiles to the methods defined in the given dex files.
+static void BuildMethodNameIndex(const std::vector<const DexFile*>& dex_files,
+                                 SafeMap<std::string, MethodReference>* methods) {
+  for (const DexFile* dex_file : dex_files) {
+    for (size_t i = 0; i != dex_file->NumClassDefs(); ++i) {
+      const byte* class_data = dex_file->GetClassData(dex_file->GetClassDef(i));
+      if (class_data == nullptr) {
+        continue;
+      }
+      ClassDataItemIterator it(*dex_file, class_data);
+      while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+        it.Next();
+      }
+      for (; it.HasNext(); it.Next()) {
+        std::string name = PrettyMethod(it.GetMemberIndex(), *dex_file);
+        if (methods->find(name) == methods->end()) {
+          methods->Put(name, MethodReference(dex_file, it.GetMemberIndex()));
+        }
+      }
+    }
+  }
+}
+
+// Converts the text profile in data, in the format written by ProfileSampleResults::Write.
+static bool ParseTextProfile(const std::string& data,
+                             const std::vector<const DexFile*>& dex_files,
+                             BinaryProfile* profile, size_t* num_unknown,
+                             std::string* error_msg) {
+  std::vector<std::string> lines;
+  Split(data, '\n', lines);
+  if (lines.empty()) {
+    *error_msg = "Empty text profile";
+    return false;
+  }
+  // The first line contains summary information.
+  std::vector<std::string> summary_info;
+  Split(lines[0], '/', summary_info);
+  if (summary_info.size() != 3) {
+    *error_msg = "Bad text profile summary: " + lines[0];
+    return false;
+  }
+  profile->AddSummary(strtoul(summary_info[0].c_str(), nullptr, 10),
+                      strtoul(summary_info[1].c_str(), nullptr, 10),
+                      strtoul(summary_info[2].c_str(), nullptr, 10));
+  SafeMap<std::string, MethodReference> methods;
+  BuildMethodNameIndex(dex_files, &methods);
+  // Each other line is name/count/size, optionally followed by the bounded stack context.
+  for (size_t i = 1; i != lines.size(); ++i) {
+    std::vector<std::string> info;
+    Split(lines[i], '/', info);
+    if (info.size() != 3 && info.size() != 4) {
+      *error_msg = "Malformed text profile line: " + lines[i];
+      return false;
+    }
+    auto it = methods.find(info[0]);
+    if (it == methods.end()) {
+      ++*num_unknown;
+      continue;
+    }
+    const MethodReference& method_ref = it->second;
+    profile->AddMethodSamples(method_ref.dex_file->GetLocation(),
+                              method_ref.dex_file->GetLocationChecksum(),
+                              method_ref.dex_method_index,
+                              strtoul(info[1].c_str(), nullptr, 10));
+  }
+  return true;
+}
+
+bool BinaryProfile::MergeFile(const std::string& filename,
+                              const std::vector<const DexFile*>& dex_files,
+                              size_t* num_unknown, std::string* error_msg) {
+  std::string data;
+  if (!ReadFileToString(filename, &data)) {
+    *error_msg = StringPrintf("Failed to read %s", filename.c_str());
+    return false;
+  }
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+  if (HasMagic(bytes, data.size())) {
+    return Deserialize(bytes, data.size(), error_msg);
+  }
+  BinaryProfile text_profile;
+  if (!ParseTextProfile(data, dex_files, &text_profile, num_unknown, error_msg)) {
+    return false;
+  }
+  MergeWith(text_profile);
+  return true;
+}
+
+void BinaryProfile::Dump(std::ostream& os, const std::vector<const DexFile*>& dex_files) const {
+  os << "samples=" << num_samples_ << " null=" << num_null_methods_
+     << " boot=" << num_boot_methods_ << " dex_files=" << NumDexFiles()
+     << " methods=" << NumMethods() << "\n";
+  // Order by decreasing count, then by dex file and method index.
+  typedef std::tuple<uint32_t, uint32_t, uint32_t> Entry;
+  std::vector<Entry> entries;
+  entries.reserve(NumMethods());
+  VisitMethods([&entries](const std::string& /* dex_location */, uint32_t dex_location_checksum,
+                          uint32_t method_idx, uint32_t count) {
+    entries.push_back(Entry(std::numeric_limits<uint32_t>::max() - count, dex_location_checksum,
+                            method_idx));
+  });
+  std::sort(entries.begin(), entries.end());
+  for (const Entry& entry : entries) {
+    uint32_t count = std::numeric_limits<uint32_t>::max() - std::get<0>(entry);
+    uint32_t checksum = std::get<1>(entry);
+    uint32_t method_idx = std::get<2>(entry);
+    const DexFile* dex_file = nullptr;
+    for (const DexFile* candidate : dex_files) {
+      if (candidate->GetLocationChecksum() == checksum &&
+          method_idx < candidate->NumMethodIds()) {
+        dex_file = candidate;
+        break;
+      }
+    }
+    os << StringPrintf("%10u %6.2f%% ", count,
+                       num_samples_ != 0u ? 100.0 * count / num_samples_ : 0.0);
+    if (dex_file != nullptr) {
+      os << PrettyMethod(method_idx, *dex_file);
+    } else {
+      os << dex_files_.Get(checksum).location << StringPrintf(" [0x%08x] method@%u", checksum,
+                                                              method_idx);
+    }
+    os << "\n";
+  }
+  if (NumCallSites() != 0u) {
+    os << "call_sites=" << NumCallSites() << "\n";
+  }
+  VisitCallSites([&os, &dex_files](const std::string& dex_location,
+                                   uint32_t dex_location_checksum, uint32_t method_idx,
+                                   uint32_t dex_pc, const std::set<std::string>& descriptors) {
+    const DexFile* dex_file = nullptr;
+    for (const DexFile* candidate : dex_files) {
+      if (candidate->GetLocationChecksum() == dex_location_checksum &&
+          method_idx < candidate->NumMethodIds()) {
+        dex_file = candidate;
+        break;
+      }
+    }
+    if (dex_file != nullptr) {
+      os << PrettyMethod(method_idx, *dex_file);
+    } else {
+      os << dex_location << StringPrintf(" [0x%08x] method@%u", dex_location_checksum,
+                                         method_idx);
+    }
+    os << StringPrintf(" @0x%04x:", dex_pc);
+    for (const std::string& descriptor : descriptors) {
+      os << " " << descriptor;
+    }
+    os << "\n";
+  });
+}
+
+}  // namespace art
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ART_RUNTIME_BINARY_PROFILE_H_
+#define ART_RUNTIME_BINARY_PROFILE_H_
+
+#include <stdint.h>
+
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "safe_map.h"
+
+namespace art {
+
+class DexFile;
+
+// Method sample counts keyed by dex file location checksum and method index, with a compact
+// versioned serialization. Unlike the text profile it needs neither method names nor parsing
+// of decimal numbers, and profiles of many processes or runs are combined with MergeWith().
+// The profile also carries the receiver classes the interpreter's inline caches observed at
+// virtual and interface call sites, for the compiler.
+//
+// The serialized format, with multi-byte values in ULEB128 unless noted otherwise:
+//
+//   magic              "pro\0"
+//   version            "002\0", version "001" profiles have no call sites
+//   num_samples        number of samples attributed to the profiled methods
+//   num_null_methods   samples that could not be attributed to a method
+//   num_boot_methods   samples in methods of the boot class path
+//   num_dex_files
+//   for each dex file:
+//     checksum         dex file location checksum, 4 bytes little-endian
+//     location_size
+//     location         location_size bytes, not null terminated
+//     num_methods
+//     for each method, in increasing method index order:
+//       method_idx     delta from the previous method index of this dex file
+//       count          number of samples
+//     num_call_sites
+//     for each call site, in increasing method index and dex pc order:
+//       method_idx     delta from the method index of the previous call site of this dex file
+//       dex_pc
+//       num_receivers
+//       for each receiver class, in increasing descriptor order:
+//         descriptor_size
+//         descriptor   descriptor_size bytes, not null terminated
+class BinaryProfile {
+ public:
+  static const uint8_t kMagic[4];
+  static const uint8_t kVersion[4];
+  // Version without call sites, still accepted by Deserialize.
+  static const uint8_t kVersionWithoutCallSites[4];
+
+  BinaryProfile() : num_samples_(0u), num_null_methods_(0u), num_boot_methods_(0u) {}
+
+  // Does the data start like a binary profile?
+  static bool HasMagic(const uint8_t* data, size_t size);
+
+  void AddSummary(uint32_t num_samples, uint32_t num_null_methods, uint32_t num_boot_methods);
+
+  // Adds count samples to the method. The location is only recorded for dumping, dex files
+  // are identified by their checksum.
+  void AddMethodSamples(const std::string& dex_location, uint32_t dex_location_checksum,
+                        uint32_t method_idx, uint32_t count);
+
+  // Adds the receiver classes observed at the invoke at dex_pc of the method.
+  void AddReceiverTypes(const std::string& dex_location, uint32_t dex_location_checksum,
+                        uint32_t method_idx, uint32_t dex_pc,
+                        const std::vector<std::string>& descriptors);
+
+  // Adds all samples and receiver classes of the other profile to this one.
+  void MergeWith(const BinaryProfile& other);
+
+  // Returns the number of samples of the method, 0 if it was never sampled.
+  uint32_t GetMethodSamples(uint32_t dex_location_checksum, uint32_t method_idx) const;
+
+  // Returns the descriptors of the receiver classes observed at the invoke at dex_pc of the
+  // method, in increasing order. Returns false if the call site is not in the profile.
+  bool GetReceiverTypes(uint32_t dex_location_checksum, uint32_t method_idx, uint32_t dex_pc,
+                        std::vector<std::string>* descriptors) const;
+
+  // Calls visitor(dex_location, dex_location_checksum, method_idx, count) for each method.
+  template <typename Visitor>
+  void VisitMethods(const Visitor& visitor) const {
+    for (const auto& dex_entry : dex_files_) {
+      for (const auto& method_entry : dex_entry.second.method_samples) {
+        visitor(dex_entry.second.location, dex_entry.first, method_entry.first,
+                method_entry.second);
+      }
+    }
+  }
+
+  // Calls visitor(dex_location, dex_location_checksum, method_idx, dex_pc, descriptors) for
+  // each call site.
+  template <typename Visitor>
+  void VisitCallSites(const Visitor& visitor) const {
+    for (const auto& dex_entry : dex_files_) {
+      for (const auto& call_site_entry : dex_entry.second.receiver_types) {
+        visitor(dex_entry.second.location, dex_entry.first, call_site_entry.first.first,
+                call_site_entry.first.second, call_site_entry.second);
+      }
+    }
+  }
+
+  uint32_t GetNumSamples() const {
+    return num_samples_;
+  }
+
+  uint32_t GetNumNullMethods() const {
+    return num_null_methods_;
+  }
+
+  uint32_t GetNumBootMethods() const {
+    return num_boot_methods_;
+  }
+
+  size_t NumDexFiles() const {
+    return dex_files_.size();
+  }
+
+  size_t NumMethods() const;
+
+  size_t NumCallSites() const;
+
+  void Serialize(std::vector<uint8_t>* out) const;
+
+  // Merges the serialized profile into this one. On failure, returns false with an error
+  // message and leaves this profile unchanged.
+  bool Deserialize(const uint8_t* data, size_t size, std::string* error_msg);
+
+  // Merges the profile read from the current position of fd up to the end of the file.
+  bool Load(int fd, std::string* error_msg);
+
+  // Writes the serialized profile at the current position of fd.
+  bool Save(int fd, std::string* error_msg) const;
+
+  // Merges the binary or text profile file into this one. Text profiles name their methods,
+  // so only the methods defined in dex_files are converted; the others are counted in
+  // *num_unknown. On failure, returns false with an error message and leaves this profile
+  // unchanged.
+  bool MergeFile(const std::string& filename, const std::vector<const DexFile*>& dex_files,
+                 size_t* num_unknown, std::string* error_msg);
+
+  // Dumps the profile, hottest methods first. Methods of the given dex files are printed
+  // by name, others by dex file location and method index.
+  void Dump(std::ostream& os, const std::vector<const DexFile*>& dex_files) const;
+
+ private:
+  struct DexFileData {
+    std::string location;
+    SafeMap<uint32_t, uint32_t> method_samples;
+    // Receiver class descriptors keyed by method index and dex pc of the call site.
+    SafeMap<std::pair<uint32_t, uint32_t>, std::set<std::string>> receiver_types;
+  };
+
+  DexFileData* GetOrAddDexFile(const std::string& dex_location, uint32_t dex_location_checksum);
+
+  uint32_t num_samples_;
+  uint32_t num_null_methods_;
+  uint32_t num_boot_methods_;
+  SafeMap<uint32_t, DexFileData> dex_files_;
+
+  DISALLOW_COPY_AND_ASSIGN(BinaryProfile);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_BINARY_PROFILE_H_
@@ -0,0 +1,307 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "binary_profile.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <vector>
+
+#include "common_runtime_test.h"
+#include "dex_file.h"
+#include "mirror/art_method-inl.h"
+#include "mirror/class-inl.h"
+#include "profiler.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+
+class BinaryProfileTest : public CommonRuntimeTest {
+ protected:
+  // Updates the profile file the way the profiler does: the previous profile is read and
+  // merged, then the file is rewritten in place.
+  void WriteProfile(ProfileSampleResults* results, ProfileDataType type,
+                    const std::string& filename) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    int fd = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    ASSERT_GE(fd, 0);
+    results->ReadPrevious(fd, type);
+    lseek(fd, 0, SEEK_SET);
+    std::ostringstream os;
+    results->Write(os, type);
+    std::string data(os.str());
+    ASSERT_EQ(static_cast<ssize_t>(data.size()), write(fd, data.data(), data.size()));
+    ASSERT_EQ(0, ftruncate(fd, data.size()));
+    close(fd);
+  }
+};
+
+TEST_F(BinaryProfileTest, SerializeRoundTrip) {
+  BinaryProfile profile;
+  profile.AddSummary(100u, 2u, 3u);
+  profile.AddMethodSamples("a.dex", 0x12345678u, 7u, 10u);
+  profile.AddMethodSamples("a.dex", 0x12345678u, 300u, 40u);
+  profile.AddMethodSamples("a.dex", 0x12345678u, 7u, 5u);
+  profile.AddMethodSamples("b.dex", 0x9abcdef0u, 7u, 45u);
+  EXPECT_EQ(2u, profile.NumDexFiles());
+  EXPECT_EQ(3u, profile.NumMethods());
+  EXPECT_EQ(15u, profile.GetMethodSamples(0x12345678u, 7u));
+  EXPECT_EQ(0u, profile.GetMethodSamples(0x12345678u, 8u));
+
+  std::vector<uint8_t> data;
+  profile.Serialize(&data);
+  ASSERT_TRUE(BinaryProfile::HasMagic(data.data(), data.size()));
+
+  BinaryProfile loaded;
+  std::string error_msg;
+  ASSERT_TRUE(loaded.Deserialize(data.data(), data.size(), &error_msg)) << error_msg;
+  EXPECT_EQ(100u, loaded.GetNumSamples());
+  EXPECT_EQ(2u, loaded.GetNumNullMethods());
+  EXPECT_EQ(3u, loaded.GetNumBootMethods());
+  EXPECT_EQ(3u, loaded.NumMethods());
+  EXPECT_EQ(15u, loaded.GetMethodSamples(0x12345678u, 7u));
+  EXPECT_EQ(40u, loaded.GetMethodSamples(0x12345678u, 300u));
+  EXPECT_EQ(45u, loaded.GetMethodSamples(0x9abcdef0u, 7u));
+
+  // Deserializing again merges the samples.
+  ASSERT_TRUE(loaded.Deserialize(data.data(), data.size(), &error_msg)) << error_msg;
+  EXPECT_EQ(200u, loaded.GetNumSamples());
+  EXPECT_EQ(30u, loaded.GetMethodSamples(0x12345678u, 7u));
+  EXPECT_EQ(3u, loaded.NumMethods());
+}
+
+TEST_F(BinaryProfileTest, RejectsBadData) {
+  BinaryProfile profile;
+  profile.AddSummary(10u, 0u, 0u);
+  profile.AddMethodSamples("a.dex", 1u, 2u, 10u);
+  std::vector<uint8_t> data;
+  profile.Serialize(&data);
+
+  BinaryProfile loaded;
+  std::string error_msg;
+  for (size_t size = 0; size != data.size(); ++size) {
+    EXPECT_FALSE(loaded.Deserialize(data.data(), size, &error_msg)) << size;
+  }
+  std::vector<uint8_t> trailing(data);
+  trailing.push_back(0u);
+  EXPECT_FALSE(loaded.Deserialize(trailing.data(), trailing.size(), &error_msg));
+  std::vector<uint8_t> bad_version(data);
+  bad_version[sizeof(BinaryProfile::kMagic)] = '9';
+  EXPECT_FALSE(loaded.Deserialize(bad_version.data(), bad_version.size(), &error_msg));
+  // Failed loads leave the profile unchanged.
+  EXPECT_EQ(0u, loaded.GetNumSamples());
+  EXPECT_EQ(0u, loaded.NumMethods());
+}
+
+TEST_F(BinaryProfileTest, Merge) {
+  BinaryProfile first;
+  first.AddSummary(10u, 1u, 0u);
+  first.AddMethodSamples("a.dex", 1u, 2u, 10u);
+  BinaryProfile second;
+  second.AddSummary(20u, 0u, 4u);
+  second.AddMethodSamples("a.dex", 1u, 2u, 5u);
+  second.AddMethodSamples("a.dex", 1u, 3u, 0xffffffffu);
+  first.MergeWith(second);
+  EXPECT_EQ(30u, first.GetNumSamples());
+  EXPECT_EQ(1u, first.GetNumNullMethods());
+  EXPECT_EQ(4u, first.GetNumBootMethods());
+  EXPECT_EQ(15u, first.GetMethodSamples(1u, 2u));
+  first.MergeWith(second);
+  // Counts saturate rather than wrap around.
+  EXPECT_EQ(0xffffffffu, first.GetMethodSamples(1u, 3u));
+}
+
+TEST_F(BinaryProfileTest, ReceiverTypes) {
+  BinaryProfile profile;
+  profile.AddSummary(10u, 0u, 0u);
+  profile.AddMethodSamples("a.dex", 1u, 2u, 10u);
+  profile.AddReceiverTypes("a.dex", 1u, 2u, 0x10u, {"LB;", "LA;"});
+  profile.AddReceiverTypes("a.dex", 1u, 2u, 0x20u, {"LC;"});
+  // Call sites of methods without samples are kept too.
+  profile.AddReceiverTypes("b.dex", 3u, 400u, 0x4u, {"LD;"});
+  EXPECT_EQ(3u, profile.NumCallSites());
+
+  std::vector<uint8_t> data;
+  profile.Serialize(&data);
+  BinaryProfile loaded;
+  std::string error_msg;
+  ASSERT_TRUE(loaded.Deserialize(data.data(), data.size(), &error_msg)) << error_msg;
+  EXPECT_EQ(3u, loaded.NumCallSites());
+  std::vector<std::string> descriptors;
+  ASSERT_TRUE(loaded.GetReceiverTypes(1u, 2u, 0x10u, &descriptors));
+  EXPECT_EQ(std::vector<std::string>({"LA;", "LB;"}), descriptors);
+  descriptors.clear();
+  ASSERT_TRUE(loaded.GetReceiverTypes(3u, 400u, 0x4u, &descriptors));
+  EXPECT_EQ(std::vector<std::string>({"LD;"}), descriptors);
+  EXPECT_FALSE(loaded.GetReceiverTypes(1u, 2u, 0x30u, &descriptors));
+  EXPECT_FALSE(loaded.GetReceiverTypes(2u, 2u, 0x10u, &descriptors));
+
+  // Merging takes the union of the receiver classes.
+  BinaryProfile other;
+  other.AddReceiverTypes("a.dex", 1u, 2u, 0x10u, {"LA;", "LE;"});
+  loaded.MergeWith(other);
+  descriptors.clear();
+  ASSERT_TRUE(loaded.GetReceiverTypes(1u, 2u, 0x10u, &descriptors));
+  EXPECT_EQ(std::vector<std::string>({"LA;", "LB;", "LE;"}), descriptors);
+  EXPECT_EQ(3u, loaded.NumCallSites());
+
+  // Truncated call sites are rejected.
+  for (size_t size = 0; size != data.size(); ++size) {
+    BinaryProfile truncated;
+    EXPECT_FALSE(truncated.Deserialize(data.data(), size, &error_msg)) << size;
+  }
+}
+
+TEST_F(BinaryProfileTest, ReadsVersionWithoutCallSites) {
+  BinaryProfile profile;
+  profile.AddSummary(10u, 0u, 0u);
+  profile.AddMethodSamples("a.dex", 1u, 2u, 10u);
+  std::vector<uint8_t> data;
+  profile.Serialize(&data);
+  // The only dex file ends with an empty list of call sites, which version 001 does not have.
+  ASSERT_EQ(0u, data.back());
+  data.pop_back();
+  memcpy(&data[sizeof(BinaryProfile::kMagic)], BinaryProfile::kVersionWithoutCallSites,
+         sizeof(BinaryProfile::kVersionWithoutCallSites));
+  BinaryProfile loaded;
+  std::string error_msg;
+  ASSERT_TRUE(loaded.Deserialize(data.data(), data.size(), &error_msg)) << error_msg;
+  EXPECT_EQ(10u, loaded.GetMethodSamples(1u, 2u));
+  EXPECT_EQ(0u, loaded.NumCallSites());
+}
+
+TEST_F(BinaryProfileTest, ProfileFile) {
+  const DexFile& dex_file = *java_lang_dex_file_;
+  ASSERT_GT(dex_file.NumMethodIds(), 3u);
+  BinaryProfile profile;
+  profile.AddSummary(100u, 0u, 0u);
+  profile.AddMethodSamples(dex_file.GetLocation(), dex_file.GetLocationChecksum(), 1u, 60u);
+  profile.AddMethodSamples(dex_file.GetLocation(), dex_file.GetLocationChecksum(), 2u, 30u);
+  profile.AddMethodSamples(dex_file.GetLocation(), dex_file.GetLocationChecksum(), 3u, 10u);
+  profile.AddReceiverTypes(dex_file.GetLocation(), dex_file.GetLocationChecksum(), 1u, 4u,
+                           {"Ljava/lang/String;"});
+
+  ScratchFile file;
+  std::string error_msg;
+  ASSERT_TRUE(profile.Save(file.GetFd(), &error_msg)) << error_msg;
+  ProfileFile profile_file;
+  ASSERT_TRUE(profile_file.LoadFile(file.GetFilename()));
+
+  // The compiler finds the receiver classes recorded by the interpreter.
+  std::vector<std::string> descriptors;
+  ASSERT_TRUE(profile_file.GetReceiverTypes(dex_file, 1u, 4u, &descriptors));
+  EXPECT_EQ(std::vector<std::string>({"Ljava/lang/String;"}), descriptors);
+  EXPECT_FALSE(profile_file.GetReceiverTypes(dex_file, 1u, 6u, &descriptors));
+
+  ProfileFile::ProfileData data;
+  ASSERT_TRUE(profile_file.GetProfileData(&data, dex_file, 1u));
+  EXPECT_EQ(60u, data.GetCount());
+  EXPECT_DOUBLE_EQ(60.0, data.GetUsedPercent());
+  EXPECT_DOUBLE_EQ(60.0, data.GetTopKUsedPercentage());
+  ASSERT_TRUE(profile_file.GetProfileData(&data, dex_file, 3u));
+  EXPECT_DOUBLE_EQ(100.0, data.GetTopKUsedPercentage());
+  EXPECT_FALSE(profile_file.GetProfileData(&data, dex_file, 4u));
+
+  // Binary profiles have no method names to report.
+  std::set<std::string> top_k;
+  profile_file.GetTopKSamples(top_k, 95.0);
+  EXPECT_TRUE(top_k.empty());
+  std::set<std::pair<uint32_t, uint32_t>> binary_top_k;
+  profile_file.GetTopKSamples(&binary_top_k, 95.0);
+  EXPECT_EQ(2u, binary_top_k.size());
+  EXPECT_EQ(1u, binary_top_k.count(std::make_pair(dex_file.GetLocationChecksum(), 1u)));
+  EXPECT_EQ(1u, binary_top_k.count(std::make_pair(dex_file.GetLocationChecksum(), 2u)));
+}
+
+TEST_F(BinaryProfileTest, WriteLoadAndMergeFile) {
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::Class* object_class = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  ASSERT_TRUE(object_class != nullptr);
+  mirror::ArtMethod* hash_code = object_class->FindVirtualMethod("hashCode", "()I");
+  mirror::ArtMethod* to_string = object_class->FindVirtualMethod("toString",
+                                                                 "()Ljava/lang/String;");
+  ASSERT_TRUE(hash_code != nullptr);
+  ASSERT_TRUE(to_string != nullptr);
+  const DexFile& dex_file = *hash_code->GetDexFile();
+  uint32_t checksum = dex_file.GetLocationChecksum();
+
+  Mutex lock("binary profile test lock");
+  ScratchFile binary_file;
+  {
+    ProfileSampleResults results(lock);
+    results.Put(hash_code);
+    results.Put(hash_code);
+    results.Put(to_string);
+    WriteProfile(&results, kProfilerBinaryMethod, binary_file.GetFilename());
+  }
+  {
+    // The second write merges the samples of the first one.
+    ProfileSampleResults results(lock);
+    results.Put(hash_code);
+    WriteProfile(&results, kProfilerBinaryMethod, binary_file.GetFilename());
+  }
+
+  // The file is a binary profile from its first byte.
+  std::string contents;
+  ASSERT_TRUE(ReadFileToString(binary_file.GetFilename(), &contents));
+  ASSERT_TRUE(BinaryProfile::HasMagic(reinterpret_cast<const uint8_t*>(contents.data()),
+                                      contents.size()));
+
+  ProfileFile profile_file;
+  ASSERT_TRUE(profile_file.LoadFile(binary_file.GetFilename()));
+  ProfileFile::ProfileData data;
+  ASSERT_TRUE(profile_file.GetProfileData(&data, dex_file, hash_code->GetDexMethodIndex()));
+  EXPECT_EQ(3u, data.GetCount());
+  ASSERT_TRUE(profile_file.GetProfileData(&data, dex_file, to_string->GetDexMethodIndex()));
+  EXPECT_EQ(1u, data.GetCount());
+
+  // A text profile of the same methods.
+  ScratchFile text_file;
+  {
+    ProfileSampleResults results(lock);
+    results.Put(to_string);
+    results.Put(to_string);
+    WriteProfile(&results, kProfilerMethod, text_file.GetFilename());
+  }
+
+  // Merge both as profman does.
+  std::vector<const DexFile*> dex_files;
+  dex_files.push_back(&dex_file);
+  BinaryProfile merged;
+  std::string error_msg;
+  size_t num_unknown = 0u;
+  ASSERT_TRUE(merged.MergeFile(binary_file.GetFilename(), dex_files, &num_unknown, &error_msg))
+      << error_msg;
+  ASSERT_TRUE(merged.MergeFile(text_file.GetFilename(), dex_files, &num_unknown, &error_msg))
+      << error_msg;
+  EXPECT_EQ(0u, num_unknown);
+  EXPECT_EQ(6u, merged.GetNumSamples());
+  EXPECT_EQ(2u, merged.NumMethods());
+  EXPECT_EQ(3u, merged.GetMethodSamples(checksum, hash_code->GetDexMethodIndex()));
+  EXPECT_EQ(3u, merged.GetMethodSamples(checksum, to_string->GetDexMethodIndex()));
+
+  // Without the dex files, the names of the text profile cannot be resolved.
+  BinaryProfile unresolved;
+  ASSERT_TRUE(unresolved.MergeFile(text_file.GetFilename(), std::vector<const DexFile*>(),
+                                   &num_unknown, &error_msg)) << error_msg;
+  EXPECT_EQ(1u, num_unknown);
+  EXPECT_EQ(0u, unresolved.NumMethods());
+}
+
+}  // namespace art
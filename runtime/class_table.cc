@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_table.h"
+
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "root_hash_table-inl.h"
+#include "utils.h"
+
+namespace art {
+
+// Matches the class with the descriptor defined by class_loader.
+class DescriptorAndLoaderEquals {
+ public:
+  DescriptorAndLoaderEquals(const char* descriptor, const mirror::ClassLoader* class_loader)
+      : descriptor_(descriptor), class_loader_(class_loader) {}
+
+  bool operator()(mirror::Class* klass) const SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    return klass->GetClassLoader() == class_loader_ && klass->DescriptorEquals(descriptor_);
+  }
+
+ private:
+  const char* const descriptor_;
+  const mirror::ClassLoader* const class_loader_;
+};
+
+// Matches the classes with the descriptor regardless of their class loader.
+class DescriptorEquals {
+ public:
+  explicit DescriptorEquals(const char* descriptor) : descriptor_(descriptor) {}
+
+  bool operator()(mirror::Class* klass) const SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    return klass->DescriptorEquals(descriptor_);
+  }
+
+ private:
+  const char* const descriptor_;
+};
+
+ClassTable::ClassTable() : table_(kMinCapacity, true) {
+}
+
+mirror::Class* ClassTable::Lookup(const char* descriptor, const mirror::ClassLoader* class_loader,
+                                  size_t hash) {
+  return table_.Find(hash, DescriptorAndLoaderEquals(descriptor, class_loader));
+}
+
+void ClassTable::LookupAll(const char* descriptor, size_t hash,
+                           std::vector<mirror::Class*>* result) {
+  table_.FindAll(hash, DescriptorEquals(descriptor), result);
+}
+
+void ClassTable::Insert(mirror::Class* klass, size_t hash) {
+  if (kIsDebugBuild) {
+    // Check for duplicates in the table.
+    std::string descriptor(klass->GetDescriptor());
+    CHECK(Lookup(descriptor.c_str(), klass->GetClassLoader(), hash) == nullptr)
+        << PrettyClass(klass) << " " << klass->GetClassLoader();
+  }
+  table_.Insert(klass, hash);
+}
+
+bool ClassTable::Replace(mirror::Class* existing, mirror::Class* klass, size_t hash) {
+  return table_.Replace(existing, klass, hash);
+}
+
+bool ClassTable::Remove(const char* descriptor, const mirror::ClassLoader* class_loader,
+                        size_t hash) {
+  return table_.Remove(hash, DescriptorAndLoaderEquals(descriptor, class_loader));
+}
+
+void ClassTable::UpdateMovedRoot(size_t hash, mirror::Class* old_ref, mirror::Class* new_ref) {
+  table_.UpdateMovedRoot(hash, old_ref, new_ref);
+}
+
+void ClassTable::VisitRoots(RootCallback* callback, void* arg, RootType root_type) {
+  table_.VisitRoots(callback, arg, root_type);
+}
+
+void ClassTable::FreeRetiredArrays(Thread* self) {
+  table_.FreeRetiredArrays(self);
+}
+
+bool ClassTable::Visit(ClassVisitor* visitor, void* arg) {
+  return table_.Visit(visitor, arg);
+}
+
+}  // namespace art
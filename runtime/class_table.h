@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_CLASS_TABLE_H_
+#define ART_RUNTIME_CLASS_TABLE_H_
+
+#include <vector>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "object_callbacks.h"
+#include "root_hash_table.h"
+
+namespace art {
+
+namespace mirror {
+  class Class;
+  class ClassLoader;
+}  // namespace mirror
+
+typedef bool (ClassVisitor)(mirror::Class* c, void* arg);
+
+// Hash table from a class descriptor hash to the mirror::Class instances with that descriptor.
+// Lookups are lock free, all other operations require the classlinker_classes_lock_ to be held
+// exclusively.
+class ClassTable {
+ public:
+  ClassTable();
+
+  ~ClassTable() {}
+
+  // Lock free, returns null if there is no class with the descriptor defined by class_loader.
+  mirror::Class* Lookup(const char* descriptor, const mirror::ClassLoader* class_loader,
+                        size_t hash)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Lock free, appends every class with the descriptor regardless of its class loader.
+  void LookupAll(const char* descriptor, size_t hash, std::vector<mirror::Class*>* result)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // The class must not already be in the table.
+  void Insert(mirror::Class* klass, size_t hash)
+      EXCLUSIVE_LOCKS_REQUIRED(Locks::classlinker_classes_lock_)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Replaces existing with klass in place, returns false if existing was not found.
+  bool Replace(mirror::Class* existing, mirror::Class* klass, size_t hash)
+      EXCLUSIVE_LOCKS_REQUIRED(Locks::classlinker_classes_lock_)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Returns true if a class with the descriptor defined by class_loader was removed.
+  bool Remove(const char* descriptor, const mirror::ClassLoader* class_loader, size_t hash)
+      EXCLUSIVE_LOCKS_REQUIRED(Locks::classlinker_classes_lock_)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Updates the entry for a class which was moved by the GC while its root was only visited
+  // through the new roots log.
+  void UpdateMovedRoot(size_t hash, mirror::Class* old_ref, mirror::Class* new_ref)
+      EXCLUSIVE_LOCKS_REQUIRED(Locks::classlinker_classes_lock_);
+
+  void VisitRoots(RootCallback* callback, void* arg, RootType root_type)
+      EXCLUSIVE_LOCKS_REQUIRED(Locks::classlinker_classes_lock_);
+
+  // Must be called with the mutator lock held exclusively.
+  void FreeRetiredArrays(Thread* self) EXCLUSIVE_LOCKS_REQUIRED(Locks::classlinker_classes_lock_);
+
+  // Stops and returns false as soon as the visitor returns false.
+  bool Visit(ClassVisitor* visitor, void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::classlinker_classes_lock_, Locks::mutator_lock_);
+
+  size_t Size() const SHARED_LOCKS_REQUIRED(Locks::classlinker_classes_lock_) {
+    return table_.Size();
+  }
+
+  size_t Capacity() const {
+    return table_.Capacity();
+  }
+
+ private:
+  static constexpr size_t kMinCapacity = 1 * KB;
+
+  RootHashTable<mirror::Class> table_;
+
+  DISALLOW_COPY_AND_ASSIGN(ClassTable);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_CLASS_TABLE_H_
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_table.h"
+
+#include <string>
+#include <vector>
+
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "mirror/class-inl.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+
+class ClassTableTest : public CommonRuntimeTest {
+ protected:
+  static bool CollectClasses(mirror::Class* klass, void* arg) {
+    reinterpret_cast<std::vector<mirror::Class*>*>(arg)->push_back(klass);
+    return true;
+  }
+
+  static size_t Hash(const std::string& descriptor) {
+    return std::hash<std::string>()(descriptor);
+  }
+};
+
+TEST_F(ClassTableTest, InsertLookupRemove) {
+  ScopedObjectAccess soa(Thread::Current());
+  std::vector<mirror::Class*> classes;
+  class_linker_->VisitClasses(CollectClasses, &classes);
+  ASSERT_FALSE(classes.empty());
+  ClassTable table;
+  WriterMutexLock mu(soa.Self(), *Locks::classlinker_classes_lock_);
+  for (mirror::Class* klass : classes) {
+    table.Insert(klass, Hash(klass->GetDescriptor()));
+  }
+  EXPECT_EQ(classes.size(), table.Size());
+  // The table grew to keep the load factor down.
+  EXPECT_LE(classes.size() * 10, table.Capacity() * 7);
+  for (mirror::Class* klass : classes) {
+    std::string descriptor(klass->GetDescriptor());
+    EXPECT_EQ(klass, table.Lookup(descriptor.c_str(), klass->GetClassLoader(), Hash(descriptor)));
+  }
+  mirror::Class* object_class = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  ASSERT_TRUE(object_class != nullptr);
+  const size_t object_hash = Hash("Ljava/lang/Object;");
+  std::vector<mirror::Class*> found;
+  table.LookupAll("Ljava/lang/Object;", object_hash, &found);
+  ASSERT_EQ(1U, found.size());
+  EXPECT_EQ(object_class, found[0]);
+  EXPECT_TRUE(table.Lookup("LDoesNotExist;", nullptr, Hash("LDoesNotExist;")) == nullptr);
+  // Removed classes are no longer found but lookups probing past them still succeed.
+  EXPECT_TRUE(table.Remove("Ljava/lang/Object;", nullptr, object_hash));
+  EXPECT_FALSE(table.Remove("Ljava/lang/Object;", nullptr, object_hash));
+  EXPECT_TRUE(table.Lookup("Ljava/lang/Object;", nullptr, object_hash) == nullptr);
+  EXPECT_EQ(classes.size() - 1, table.Size());
+  for (mirror::Class* klass : classes) {
+    if (klass != object_class) {
+      std::string descriptor(klass->GetDescriptor());
+      EXPECT_EQ(klass, table.Lookup(descriptor.c_str(), klass->GetClassLoader(),
+                                    Hash(descriptor)));
+    }
+  }
+  // Replacing keeps the slot but returns the new class.
+  mirror::Class* string_class = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/String;");
+  ASSERT_TRUE(string_class != nullptr);
+  table.Insert(object_class, object_hash);
+  EXPECT_TRUE(table.Replace(object_class, string_class, object_hash));
+  EXPECT_FALSE(table.Replace(object_class, string_class, object_hash));
+  found.clear();
+  table.LookupAll("Ljava/lang/String;", object_hash, &found);
+  ASSERT_EQ(1U, found.size());
+  EXPECT_EQ(string_class, found[0]);
+}
+
+}  // namespace art
@@ -351,6 +351,60 @@ const DexFile* DexFile::OpenMemory(const byte* base,
   }
 }
 
+static uint32_t HashDescriptor(const char* descriptor) {
+  uint32_t hash = 0;
+  for (; *descriptor != '\0'; ++descriptor) {
+    hash = hash * 31 + *descriptor;
+  }
+  return hash;
+}
+
+class DexFile::ClassDefIndex {
+ public:
+  explicit ClassDefIndex(const DexFile& dex_file)
+      : mask_(RoundUpToPowerOfTwo(dex_file.NumClassDefs() * 2) - 1),
+        entries_(new Entry[mask_ + 1]) {
+    for (size_t i = 0; i <= mask_; ++i) {
+      entries_[i].class_def_idx = kDexNoIndex;
+    }
+    for (size_t i = 0, num_class_defs = dex_file.NumClassDefs(); i < num_class_defs; ++i) {
+      const uint32_t hash = HashDescriptor(dex_file.GetClassDescriptor(dex_file.GetClassDef(i)));
+      size_t pos = hash & mask_;
+      while (entries_[pos].class_def_idx != kDexNoIndex) {
+        pos = (pos + 1) & mask_;
+      }
+      entries_[pos].hash = hash;
+      entries_[pos].class_def_idx = i;
+    }
+  }
+
+  const ClassDef* Find(const DexFile& dex_file, const char* descriptor) const {
+    const uint32_t hash = HashDescriptor(descriptor);
+    // The table is at most half full, so there is always an empty entry ending the probe.
+    for (size_t pos = hash & mask_; entries_[pos].class_def_idx != kDexNoIndex;
+         pos = (pos + 1) & mask_) {
+      if (entries_[pos].hash == hash) {
+        const ClassDef& class_def = dex_file.GetClassDef(entries_[pos].class_def_idx);
+        if (strcmp(dex_file.GetClassDescriptor(class_def), descriptor) == 0) {
+          return &class_def;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+ private:
+  struct Entry {
+    uint32_t hash;
+    uint32_t class_def_idx;
+  };
+
+  const size_t mask_;
+  std::unique_ptr<Entry[]> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ClassDefIndex);
+};
+
 DexFile::DexFile(const byte* base, size_t size,
                  const std::string& location,
                  uint32_t location_checksum,
@@ -366,7 +420,8 @@ DexFile::DexFile(const byte* base, size_t size,
       field_ids_(reinterpret_cast<const FieldId*>(base + header_->field_ids_off_)),
       method_ids_(reinterpret_cast<const MethodId*>(base + header_->method_ids_off_)),
       proto_ids_(reinterpret_cast<const ProtoId*>(base + header_->proto_ids_off_)),
-      class_defs_(reinterpret_cast<const ClassDef*>(base + header_->class_defs_off_)) {
+      class_defs_(reinterpret_cast<const ClassDef*>(base + header_->class_defs_off_)),
+      class_def_index_(nullptr) {
   CHECK(begin_ != NULL) << GetLocation();
   CHECK_GT(size_, 0U) << GetLocation();
 }
@@ -376,6 +431,7 @@ DexFile::~DexFile() {
   // that's only called after DetachCurrentThread, which means there's no JNIEnv. We could
   // re-attach, but cleaning up these global references is not obviously useful. It's not as if
   // the global reference table is otherwise empty!
+  delete class_def_index_.LoadRelaxed();
 }
 
 bool DexFile::Init(std::string* error_msg) {
@@ -424,11 +480,27 @@ uint32_t DexFile::GetVersion() const {
   return atoi(version);
 }
 
+const DexFile::ClassDefIndex* DexFile::GetClassDefIndex() const {
+  const ClassDefIndex* index = class_def_index_.LoadSequentiallyConsistent();
+  if (LIKELY(index != nullptr)) {
+    return index;
+  }
+  std::unique_ptr<const ClassDefIndex> new_index(new ClassDefIndex(*this));
+  if (class_def_index_.CompareExchangeStrongSequentiallyConsistent(nullptr, new_index.get())) {
+    return new_index.release();
+  }
+  // Another thread won the race.
+  return class_def_index_.LoadSequentiallyConsistent();
+}
+
 const DexFile::ClassDef* DexFile::FindClassDef(const char* descriptor) const {
   size_t num_class_defs = NumClassDefs();
   if (num_class_defs == 0) {
     return NULL;
   }
+  if (num_class_defs >= kMinClassDefsForIndex) {
+    return GetClassDefIndex()->Find(*this, descriptor);
+  }
   const StringId* string_id = FindStringId(descriptor);
   if (string_id == NULL) {
     return NULL;
@@ -437,18 +509,15 @@ const DexFile::ClassDef* DexFile::FindClassDef(const char* descriptor) const {
   if (type_id == NULL) {
     return NULL;
   }
-  uint16_t type_idx = GetIndexForTypeId(*type_id);
-  for (size_t i = 0; i < num_class_defs; ++i) {
-    const ClassDef& class_def = GetClassDef(i);
-    if (class_def.class_idx_ == type_idx) {
-      return &class_def;
-    }
-  }
-  return NULL;
+  return FindClassDef(GetIndexForTypeId(*type_id));
 }
 
 const DexFile::ClassDef* DexFile::FindClassDef(uint16_t type_idx) const {
   size_t num_class_defs = NumClassDefs();
+  if (num_class_defs >= kMinClassDefsForIndex) {
+    // Type ids are unique per descriptor, so the class def with the descriptor is the one.
+    return GetClassDefIndex()->Find(*this, StringByTypeIdx(type_idx));
+  }
   for (size_t i = 0; i < num_class_defs; ++i) {
     const ClassDef& class_def = GetClassDef(i);
     if (class_def.class_idx_ == type_idx) {
@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include "atomic.h"
 #include "base/logging.h"
 #include "base/mutex.h"  // For Locks::mutator_lock_.
 #include "globals.h"
@@ -619,7 +620,8 @@ class DexFile {
     return StringByTypeIdx(class_def.class_idx_);
   }
 
-  // Looks up a class definition by its class descriptor.
+  // Looks up a class definition by its class descriptor. Uses a hash index from descriptors to
+  // class definitions, built on the first lookup, unless the dex file has few class definitions.
   const ClassDef* FindClassDef(const char* descriptor) const;
 
   // Looks up a class definition by its type index.
@@ -942,6 +944,19 @@ class DexFile {
 
   // Points to the base of the class definition list.
   const ClassDef* const class_defs_;
+
+  // Dex files with fewer class definitions than this are searched linearly.
+  static constexpr size_t kMinClassDefsForIndex = 16;
+
+  // Open addressing hash table from class descriptors to class definitions.
+  class ClassDefIndex;
+
+  // Returns the class def index, building it if needed. Racing threads may both build one, the
+  // loser deletes its copy.
+  const ClassDefIndex* GetClassDefIndex() const;
+
+  // Lazily built by GetClassDefIndex.
+  mutable Atomic<const ClassDefIndex*> class_def_index_;
 };
 std::ostream& operator<<(std::ostream& os, const DexFile& dex_file);
 
@@ -220,6 +220,29 @@ TEST_F(DexFileTest, ClassDefs) {
   EXPECT_STREQ("LNested;", raw->GetClassDescriptor(c1));
 }
 
+TEST_F(DexFileTest, FindClassDef) {
+  ScopedObjectAccess soa(Thread::Current());
+  // A small dex file is searched linearly, the core library dex file uses the hash index.
+  const DexFile* nested(OpenTestDexFile("Nested"));
+  ASSERT_TRUE(nested != NULL);
+  for (const DexFile* dex_file : {nested, java_lang_dex_file_}) {
+    for (size_t i = 0; i < dex_file->NumClassDefs(); ++i) {
+      const DexFile::ClassDef& class_def = dex_file->GetClassDef(i);
+      const char* descriptor = dex_file->GetClassDescriptor(class_def);
+      EXPECT_EQ(&class_def, dex_file->FindClassDef(descriptor)) << descriptor;
+      EXPECT_EQ(&class_def, dex_file->FindClassDef(class_def.class_idx_)) << descriptor;
+    }
+    EXPECT_TRUE(dex_file->FindClassDef("LDoesNotExist;") == NULL);
+  }
+  // Types which are only referenced have no class def.
+  const DexFile::StringId* string_id = nested->FindStringId("Ljava/lang/Object;");
+  ASSERT_TRUE(string_id != NULL);
+  const DexFile::TypeId* type_id = nested->FindTypeId(nested->GetIndexForStringId(*string_id));
+  ASSERT_TRUE(type_id != NULL);
+  EXPECT_TRUE(nested->FindClassDef(nested->GetIndexForTypeId(*type_id)) == NULL);
+  EXPECT_TRUE(nested->FindClassDef("Ljava/lang/Object;") == NULL);
+}
+
 TEST_F(DexFileTest, GetMethodSignature) {
   ScopedObjectAccess soa(Thread::Current());
   const DexFile* raw(OpenTestDexFile("GetMethodSignature"));
@@ -66,12 +66,13 @@ extern "C" int64_t artLmul(int64_t a, int64_t b) {
   return a * b;
 }
 
+// Long.MIN_VALUE / -1 overflows and traps on x86, Java wraps it around to Long.MIN_VALUE.
 extern "C" int64_t artLdiv(int64_t a, int64_t b) {
-  return a / b;
+  return (b == -1) ? static_cast<int64_t>(-static_cast<uint64_t>(a)) : a / b;
 }
 
 extern "C" int64_t artLmod(int64_t a, int64_t b) {
-  return a % b;
+  return (b == -1) ? 0 : a % b;
 }
 
 }  // namespace art
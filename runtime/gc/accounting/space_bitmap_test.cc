@@ -87,6 +87,34 @@ TEST_F(SpaceBitmapTest, ScanRange) {
   }
 }
 
+TEST_F(SpaceBitmapTest, ClearRange) {
+  byte* heap_begin = reinterpret_cast<byte*>(0x10000000);
+  size_t heap_capacity = 16 * MB;
+
+  std::unique_ptr<ContinuousSpaceBitmap> space_bitmap(
+      ContinuousSpaceBitmap::Create("test bitmap", heap_begin, heap_capacity));
+  EXPECT_TRUE(space_bitmap.get() != NULL);
+
+  // Clear ranges which start and end both inside of and on word boundaries.
+  const size_t num_objects = kBitsPerWord * 4;
+  for (size_t begin = 0; begin < kBitsPerWord + 1; begin += 3) {
+    for (size_t end = begin; end <= num_objects; end += 5) {
+      for (size_t i = 0; i < num_objects; ++i) {
+        space_bitmap->Set(reinterpret_cast<mirror::Object*>(heap_begin + i * kObjectAlignment));
+      }
+      space_bitmap->ClearRange(
+          reinterpret_cast<mirror::Object*>(heap_begin + begin * kObjectAlignment),
+          reinterpret_cast<mirror::Object*>(heap_begin + end * kObjectAlignment));
+      for (size_t i = 0; i < num_objects; ++i) {
+        const mirror::Object* obj =
+            reinterpret_cast<mirror::Object*>(heap_begin + i * kObjectAlignment);
+        EXPECT_EQ(i < begin || i >= end, space_bitmap->Test(obj))
+            << begin << " " << end << " " << i;
+      }
+    }
+  }
+}
+
 class SimpleCounter {
  public:
   explicit SimpleCounter(size_t* counter) : count_(counter) {}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_ACCOUNTING_WORK_STEALING_DEQUE_H_
+#define ART_RUNTIME_GC_ACCOUNTING_WORK_STEALING_DEQUE_H_
+
+#include <memory>
+#include <vector>
+
+#include "atomic.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "utils.h"
+
+namespace art {
+namespace gc {
+namespace accounting {
+
+// A Chase-Lev work stealing deque. The owning thread pushes and pops at the bottom without
+// synchronizing with other threads unless the deque is almost empty, any other thread may steal
+// from the top. The backing array grows when full.
+template <typename T>
+class WorkStealingDeque {
+ public:
+  static constexpr size_t kDefaultCapacity = 1 * KB;
+
+  explicit WorkStealingDeque(size_t initial_capacity = kDefaultCapacity)
+      : top_(0), bottom_(0), array_(nullptr) {
+    CHECK(IsPowerOfTwo(initial_capacity)) << initial_capacity;
+    arrays_.emplace_back(new CircularArray(initial_capacity));
+    array_.StoreRelaxed(arrays_.back().get());
+  }
+
+  ~WorkStealingDeque() {}
+
+  // Only called by the owner thread.
+  void PushBottom(T value) {
+    const int32_t bottom = bottom_.LoadRelaxed();
+    const int32_t top = top_.LoadSequentiallyConsistent();
+    CircularArray* array = array_.LoadRelaxed();
+    if (UNLIKELY(static_cast<size_t>(bottom - top) >= array->Capacity())) {
+      array = Grow(array, top, bottom);
+    }
+    array->Put(bottom, value);
+    // Publishes the element to the thieves.
+    bottom_.StoreSequentiallyConsistent(bottom + 1);
+  }
+
+  // Only called by the owner thread. Returns false if the deque was empty or if the last element
+  // was stolen from under us.
+  bool PopBottom(T* value) {
+    const int32_t bottom = bottom_.LoadRelaxed() - 1;
+    CircularArray* array = array_.LoadRelaxed();
+    bottom_.StoreSequentiallyConsistent(bottom);
+    const int32_t top = top_.LoadSequentiallyConsistent();
+    if (top > bottom) {
+      // Empty.
+      bottom_.StoreRelaxed(bottom + 1);
+      return false;
+    }
+    *value = array->Get(bottom);
+    if (top != bottom) {
+      // More than one element left, no thief can race with us.
+      return true;
+    }
+    // Last element, race against the thieves for it.
+    const bool won = top_.CompareExchangeStrongSequentiallyConsistent(top, top + 1);
+    bottom_.StoreRelaxed(bottom + 1);
+    return won;
+  }
+
+  // May be called by any thread. Returns false if the deque was empty or if another thread won
+  // the race for the top element.
+  bool Steal(T* value) {
+    const int32_t top = top_.LoadSequentiallyConsistent();
+    const int32_t bottom = bottom_.LoadSequentiallyConsistent();
+    if (top >= bottom) {
+      return false;
+    }
+    CircularArray* array = array_.LoadSequentiallyConsistent();
+    T result = array->Get(top);
+    if (!top_.CompareExchangeStrongSequentiallyConsistent(top, top + 1)) {
+      return false;
+    }
+    *value = result;
+    return true;
+  }
+
+  // Racy when called concurrently with pushes or steals, only used as a hint.
+  bool IsEmpty() const {
+    return bottom_.LoadSequentiallyConsistent() <= top_.LoadSequentiallyConsistent();
+  }
+
+  size_t Size() const {
+    const int32_t size = bottom_.LoadSequentiallyConsistent() - top_.LoadSequentiallyConsistent();
+    return size > 0 ? static_cast<size_t>(size) : 0U;
+  }
+
+  size_t Capacity() const {
+    return array_.LoadRelaxed()->Capacity();
+  }
+
+  // Must not be called concurrently with any other operation. Releases the retired arrays.
+  void Reset() {
+    DCHECK(IsEmpty());
+    top_.StoreRelaxed(0);
+    bottom_.StoreRelaxed(0);
+    CircularArray* current = array_.LoadRelaxed();
+    for (auto& array : arrays_) {
+      if (array.get() == current) {
+        array.swap(arrays_.front());
+        break;
+      }
+    }
+    arrays_.resize(1);
+  }
+
+ private:
+  class CircularArray {
+   public:
+    explicit CircularArray(size_t capacity)
+        : mask_(capacity - 1), slots_(new Atomic<T>[capacity]) {
+      DCHECK(IsPowerOfTwo(capacity));
+    }
+
+    size_t Capacity() const {
+      return mask_ + 1;
+    }
+
+    T Get(int32_t index) const {
+      return slots_[index & mask_].LoadRelaxed();
+    }
+
+    void Put(int32_t index, T value) {
+      slots_[index & mask_].StoreRelaxed(value);
+    }
+
+   private:
+    const size_t mask_;
+    std::unique_ptr<Atomic<T>[]> slots_;
+
+    DISALLOW_COPY_AND_ASSIGN(CircularArray);
+  };
+
+  CircularArray* Grow(CircularArray* array, int32_t top, int32_t bottom) {
+    CircularArray* new_array = new CircularArray(array->Capacity() * 2);
+    for (int32_t i = top; i < bottom; ++i) {
+      new_array->Put(i, array->Get(i));
+    }
+    arrays_.emplace_back(new_array);
+    array_.StoreSequentiallyConsistent(new_array);
+    return new_array;
+  }
+
+  // Index of the next element to steal.
+  Atomic<int32_t> top_;
+  // Index one past the last element pushed by the owner.
+  Atomic<int32_t> bottom_;
+  Atomic<CircularArray*> array_;
+  // Current and retired arrays, only modified by the owner.
+  std::vector<std::unique_ptr<CircularArray>> arrays_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_ACCOUNTING_WORK_STEALING_DEQUE_H_
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "work_stealing_deque.h"
+
+#include <pthread.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace art {
+namespace gc {
+namespace accounting {
+
+typedef WorkStealingDeque<uintptr_t> Deque;
+
+TEST(WorkStealingDeque, PushPopSteal) {
+  Deque deque(4);
+  uintptr_t value = 0;
+  EXPECT_TRUE(deque.IsEmpty());
+  EXPECT_FALSE(deque.PopBottom(&value));
+  EXPECT_FALSE(deque.Steal(&value));
+  for (uintptr_t i = 1; i <= 3; ++i) {
+    deque.PushBottom(i);
+  }
+  EXPECT_EQ(3U, deque.Size());
+  // The owner pops the most recently pushed element, thieves take the oldest.
+  ASSERT_TRUE(deque.PopBottom(&value));
+  EXPECT_EQ(3U, value);
+  ASSERT_TRUE(deque.Steal(&value));
+  EXPECT_EQ(1U, value);
+  ASSERT_TRUE(deque.PopBottom(&value));
+  EXPECT_EQ(2U, value);
+  EXPECT_TRUE(deque.IsEmpty());
+  EXPECT_FALSE(deque.PopBottom(&value));
+  EXPECT_FALSE(deque.Steal(&value));
+}
+
+TEST(WorkStealingDeque, Grow) {
+  static constexpr uintptr_t kCount = 100;
+  Deque deque(4);
+  // Interleave steals so that the live range wraps around the array before it grows.
+  uintptr_t value = 0;
+  deque.PushBottom(0);
+  deque.PushBottom(1);
+  ASSERT_TRUE(deque.Steal(&value));
+  EXPECT_EQ(0U, value);
+  for (uintptr_t i = 2; i < kCount; ++i) {
+    deque.PushBottom(i);
+  }
+  EXPECT_GE(deque.Capacity(), kCount);
+  for (uintptr_t i = 1; i < kCount / 2; ++i) {
+    ASSERT_TRUE(deque.Steal(&value));
+    EXPECT_EQ(i, value);
+  }
+  for (uintptr_t i = kCount - 1; i >= kCount / 2; --i) {
+    ASSERT_TRUE(deque.PopBottom(&value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_TRUE(deque.IsEmpty());
+  deque.Reset();
+  EXPECT_TRUE(deque.IsEmpty());
+  deque.PushBottom(42);
+  ASSERT_TRUE(deque.PopBottom(&value));
+  EXPECT_EQ(42U, value);
+}
+
+static constexpr size_t kNumThieves = 4;
+static constexpr uintptr_t kNumElements = 100000;
+
+struct StealArgs {
+  Deque* deque;
+  Atomic<bool>* done;
+  std::vector<uintptr_t> stolen;
+};
+
+static void* StealLoop(void* arg) {
+  StealArgs* args = reinterpret_cast<StealArgs*>(arg);
+  uintptr_t value;
+  while (!args->done->LoadSequentiallyConsistent() || !args->deque->IsEmpty()) {
+    if (args->deque->Steal(&value)) {
+      args->stolen.push_back(value);
+    }
+  }
+  return nullptr;
+}
+
+// Every element must be taken exactly once, either by the owner or by one of the thieves.
+TEST(WorkStealingDeque, ConcurrentSteal) {
+  Deque deque(16);
+  Atomic<bool> done(false);
+  StealArgs args[kNumThieves];
+  pthread_t threads[kNumThieves];
+  for (size_t i = 0; i < kNumThieves; ++i) {
+    args[i].deque = &deque;
+    args[i].done = &done;
+    ASSERT_EQ(0, pthread_create(&threads[i], nullptr, StealLoop, &args[i]));
+  }
+  std::vector<size_t> taken(kNumElements, 0);
+  uintptr_t value;
+  for (uintptr_t i = 0; i < kNumElements; ++i) {
+    deque.PushBottom(i);
+    // Pop every third element back so that the owner and the thieves race for the bottom.
+    if (i % 3 == 0 && deque.PopBottom(&value)) {
+      ++taken[value];
+    }
+  }
+  while (deque.PopBottom(&value)) {
+    ++taken[value];
+  }
+  done.StoreSequentiallyConsistent(true);
+  for (size_t i = 0; i < kNumThieves; ++i) {
+    ASSERT_EQ(0, pthread_join(threads[i], nullptr));
+    for (uintptr_t stolen : args[i].stolen) {
+      ++taken[stolen];
+    }
+  }
+  for (uintptr_t i = 0; i < kNumElements; ++i) {
+    EXPECT_EQ(1U, taken[i]) << i;
+  }
+}
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
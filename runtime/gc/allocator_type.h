@@ -28,6 +28,8 @@ enum AllocatorType {
   kAllocatorTypeDlMalloc,  // Use dlmalloc allocator, has entrypoints.
   kAllocatorTypeNonMoving,  // Special allocator for non moving objects, doesn't have entrypoints.
   kAllocatorTypeLOS,  // Large object space, also doesn't have entrypoints.
+  kAllocatorTypeRegion,  // Use the region space allocator, has entrypoints.
+  kAllocatorTypeRegionTLAB,  // Use region sized TLABs from the region space, has entrypoints.
 };
 
 }  // namespace gc
@@ -16,10 +16,713 @@
 
 #include "concurrent_copying.h"
 
+#include <vector>
+
+#include "base/logging.h"
+#include "base/mutex-inl.h"
+#include "base/timing_logger.h"
+#include "gc/accounting/atomic_stack.h"
+#include "gc/accounting/heap_bitmap-inl.h"
+#include "gc/accounting/mod_union_table.h"
+#include "gc/accounting/space_bitmap-inl.h"
+#include "gc/heap.h"
+#include "gc/reference_processor.h"
+#include "gc/space/image_space.h"
+#include "gc/space/large_object_space.h"
+#include "gc/space/malloc_space.h"
+#include "gc/space/region_space-inl.h"
+#include "gc/space/space-inl.h"
+#include "lock_word.h"
+#include "mirror/object-inl.h"
+#include "mirror/reference-inl.h"
+#include "read_barrier-inl.h"
+#include "runtime.h"
+#include "thread-inl.h"
+#include "thread_list.h"
+
 namespace art {
 namespace gc {
 namespace collector {
 
+// Initial number of references the mutators can push before the shared mark stack is resized.
+static constexpr size_t kSharedMarkStackSize = 64 * KB;
+
+ConcurrentCopying::ConcurrentCopying(Heap* heap, bool /*generational*/,
+                                     const std::string& name_prefix)
+    : GarbageCollector(heap,
+                       name_prefix + (name_prefix.empty() ? "" : " ") +
+                       "concurrent copying + mark sweep"),
+      region_space_(nullptr),
+      region_space_bitmap_(nullptr),
+      force_evacuate_all_(false),
+      fallback_space_(nullptr),
+      mark_bitmap_(nullptr),
+      los_mark_bitmap_(nullptr),
+      gc_mark_stack_(nullptr),
+      mark_stack_lock_("concurrent copying mark stack lock", kConcurrentCopyingMarkStackLock),
+      shared_mark_stack_(accounting::ObjectStack::Create("concurrent copying shared mark stack",
+                                                         kSharedMarkStackSize,
+                                                         kSharedMarkStackSize)),
+      thread_running_gc_(nullptr),
+      is_marking_(0),
+      objects_moved_(0),
+      bytes_moved_(0),
+      bytes_reserved_for_copies_(0),
+      objects_lost_(0),
+      from_space_objects_(0),
+      from_space_bytes_(0) {
+}
+
+ConcurrentCopying::~ConcurrentCopying() {
+}
+
+void ConcurrentCopying::RunPhases() {
+  CHECK(kUseBakerReadBarrier) << "Concurrent copying requires Baker read barriers";
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertNotHeld(self);
+  thread_running_gc_ = self;
+  {
+    ReaderMutexLock mu(self, *Locks::mutator_lock_);
+    InitializePhase();
+  }
+  {
+    ScopedPause pause(this);
+    GetHeap()->PreGcVerificationPaused(this);
+    FlipThreadRoots();
+  }
+  {
+    ReaderMutexLock mu(self, *Locks::mutator_lock_);
+    MarkingPhase();
+  }
+  {
+    ScopedPause pause(this);
+    FinalPause();
+  }
+  {
+    ReaderMutexLock mu(self, *Locks::mutator_lock_);
+    ReclaimPhase();
+  }
+  GetHeap()->PostGcVerification(this);
+  FinishPhase();
+  thread_running_gc_ = nullptr;
+}
+
+void ConcurrentCopying::InitializePhase() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  gc_mark_stack_ = heap_->GetMarkStack();
+  DCHECK(gc_mark_stack_ != nullptr);
+  DCHECK(gc_mark_stack_->IsEmpty());
+  immune_region_.Reset();
+  objects_moved_.StoreRelaxed(0);
+  bytes_moved_.StoreRelaxed(0);
+  bytes_reserved_for_copies_.StoreRelaxed(0);
+  objects_lost_.StoreRelaxed(0);
+  CHECK(region_space_ != nullptr) << "No region space to collect";
+  region_space_bitmap_ = region_space_->GetRegionBitmap();
+  fallback_space_ = heap_->GetNonMovingSpace();
+  {
+    ReaderMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
+    mark_bitmap_ = heap_->GetMarkBitmap();
+  }
+  los_mark_bitmap_ = heap_->GetLargeObjectsSpace()->GetMarkBitmap();
+  // Without generations there is no point in keeping soft references around, the next collection
+  // would see the same heap.
+  GetCurrentIteration()->SetClearSoftReferences(true);
+  BindBitmaps();
+}
+
+void ConcurrentCopying::BindBitmaps() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  WriterMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
+  // Mark all of the spaces we never collect as immune.
+  for (const auto& space : heap_->GetContinuousSpaces()) {
+    if (space->GetGcRetentionPolicy() == space::kGcRetentionPolicyNeverCollect ||
+        space->GetGcRetentionPolicy() == space::kGcRetentionPolicyFullCollect) {
+      CHECK(immune_region_.AddContinuousSpace(space)) << "Failed to add space " << *space;
+    }
+  }
+}
+
+void ConcurrentCopying::FlipThreadRoots() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  // Revoke the TLABs so that the from-space accounting is complete and nobody keeps allocating
+  // into the from-space after the flip.
+  RevokeAllThreadLocalBuffers();
+  {
+    WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
+    if (kUseThreadLocalAllocationStack) {
+      heap_->RevokeAllThreadLocalAllocationStacks(self);
+    }
+    heap_->SwapStacks(self);
+    accounting::ObjectStack* live_stack = heap_->GetLiveStack();
+    heap_->MarkAllocStackAsLive(live_stack);
+    live_stack->Reset();
+  }
+  // Process dirty cards and add dirty cards to the mod-union tables of the immune spaces.
+  heap_->ProcessCards(GetTimings(), false);
+  // From now on the mutators allocate into new to-space regions. Objects allocated there are never
+  // scanned since they can only hold references the mutators loaded through the read barrier.
+  region_space_->SetFromSpace(force_evacuate_all_);
+  from_space_objects_ = region_space_->GetObjectsAllocatedInFromSpace();
+  from_space_bytes_ = region_space_->GetBytesAllocatedInFromSpace();
+  is_marking_.StoreSequentiallyConsistent(1);
+  MarkRoots();
+  UpdateAndMarkModUnion();
+}
+
+void ConcurrentCopying::MarkRoots() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Runtime::Current()->VisitRoots(MarkRootCallback, this);
+}
+
+void ConcurrentCopying::UpdateAndMarkModUnion() {
+  for (const auto& space : heap_->GetContinuousSpaces()) {
+    if (!immune_region_.ContainsSpace(space)) {
+      continue;
+    }
+    // Objects in the immune spaces are never grayed, so every reference out of them must be
+    // updated before the mutators may read it.
+    accounting::ModUnionTable* table = heap_->FindModUnionTableFromSpace(space);
+    if (table != nullptr) {
+      TimingLogger::ScopedTiming t(
+          space->IsZygoteSpace() ? "UpdateAndMarkZygoteModUnionTable" :
+                                   "UpdateAndMarkImageModUnionTable",
+          GetTimings());
+      table->UpdateAndMarkReferences(MarkHeapReferenceCallback, this);
+    } else {
+      // The cards were processed without a table, so the space has no record of the references
+      // stored into it so far. Scan it in full this once, the new table records the cards
+      // dirtied from now on.
+      TimingLogger::ScopedTiming t("ScanImmuneSpace", GetTimings());
+      heap_->AddModUnionTable(new accounting::ModUnionTableCardCache(
+          std::string(space->GetName()) + " mod-union table", heap_, space));
+      accounting::ContinuousSpaceBitmap* live_bitmap = space->GetLiveBitmap();
+      CHECK(live_bitmap != nullptr) << "No mod-union table or live bitmap for " << *space;
+      live_bitmap->VisitMarkedRange(reinterpret_cast<uintptr_t>(space->Begin()),
+                                    reinterpret_cast<uintptr_t>(space->End()),
+                                    [this](mirror::Object* obj)
+          SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+        Scan(obj);
+      });
+    }
+  }
+}
+
+void ConcurrentCopying::MarkingPhase() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ProcessMarkStack();
+}
+
+void ConcurrentCopying::FinalPause() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  // Scan whatever the mutators grayed since the last time the shared mark stack was drained.
+  ProcessMarkStack();
+  MarkAllocStack();
+  ProcessReferences(self);
+  SweepSystemWeaks();
+  // Revoke the TLABs the objects were evacuated into so that the to-space can be walked.
+  RevokeAllThreadLocalBuffers();
+  is_marking_.StoreSequentiallyConsistent(0);
+  if (kEnableNoFromSpaceRefsVerification) {
+    VerifyNoFromSpaceReferences();
+  }
+  heap_->PreSweepingGcVerification(this);
+}
+
+void ConcurrentCopying::MarkAllocStack() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
+  if (kUseThreadLocalAllocationStack) {
+    heap_->RevokeAllThreadLocalAllocationStacks(self);
+  }
+  heap_->SwapStacks(self);
+  // Objects allocated into the non-moving and large object spaces while marking only hold
+  // references loaded through the read barrier, they can be treated as black.
+  accounting::ObjectStack* live_stack = heap_->GetLiveStack();
+  accounting::ContinuousSpaceBitmap* non_moving_mark_bitmap = fallback_space_->GetMarkBitmap();
+  heap_->MarkAllocStack(non_moving_mark_bitmap, non_moving_mark_bitmap, los_mark_bitmap_,
+                        live_stack);
+  heap_->MarkAllocStackAsLive(live_stack);
+  live_stack->Reset();
+}
+
+void ConcurrentCopying::ProcessReferences(Thread* self) {
+  WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
+  GetHeap()->GetReferenceProcessor()->ProcessReferences(
+      false, GetTimings(), GetCurrentIteration()->GetClearSoftReferences(),
+      &HeapReferenceMarkedCallback, &MarkObjectCallback, &ProcessMarkStackCallback, this);
+}
+
+void ConcurrentCopying::SweepSystemWeaks() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Runtime::Current()->SweepSystemWeaks(MarkedForwardingAddressCallback, this);
+}
+
+void ConcurrentCopying::ReclaimPhase() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  {
+    // Record freed memory. The evacuated objects live in buffers the heap did not account for as
+    // allocations, so subtract them from what the from-space held.
+    const uint64_t from_objects = from_space_objects_;
+    const uint64_t to_objects = objects_moved_.LoadSequentiallyConsistent();
+    CHECK_LE(to_objects, from_objects);
+    const int64_t to_bytes = bytes_reserved_for_copies_.LoadSequentiallyConsistent();
+    // Note: Freed bytes can be negative since the copies are rounded up to whole buffers.
+    RecordFree(ObjectBytePair(from_objects - to_objects, from_space_bytes_ - to_bytes));
+  }
+  {
+    // Nothing may refer to the evacuated regions any more. The regions which were marked in place
+    // are freed if none of their objects survived.
+    TimingLogger::ScopedTiming split("ClearFromSpace", GetTimings());
+    uint64_t cleared_bytes;
+    uint64_t cleared_objects;
+    region_space_->ClearFromSpace(&cleared_bytes, &cleared_objects);
+    RecordFree(ObjectBytePair(cleared_objects, cleared_bytes));
+  }
+  {
+    WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
+    // Reclaim unmarked objects in the spaces which are marked in place.
+    Sweep(false);
+    // Swap the live and mark bitmaps for each space which we modified space. This is an
+    // optimization that enables us to not clear live bits inside of the sweep. Only swaps unbound
+    // bitmaps.
+    SwapBitmaps();
+    GetHeap()->UnBindBitmaps();
+  }
+}
+
+void ConcurrentCopying::Sweep(bool swap_bitmaps) {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  for (const auto& space : heap_->GetContinuousSpaces()) {
+    if (!space->IsContinuousMemMapAllocSpace() || space == region_space_ ||
+        immune_region_.ContainsSpace(space)) {
+      continue;
+    }
+    space::ContinuousMemMapAllocSpace* alloc_space = space->AsContinuousMemMapAllocSpace();
+    if (alloc_space->GetLiveBitmap() == nullptr) {
+      continue;
+    }
+    TimingLogger::ScopedTiming split("SweepAllocSpace", GetTimings());
+    RecordFree(alloc_space->Sweep(swap_bitmaps));
+  }
+  SweepLargeObjects(swap_bitmaps);
+}
+
+void ConcurrentCopying::SweepLargeObjects(bool swap_bitmaps) {
+  TimingLogger::ScopedTiming split("SweepLargeObjects", GetTimings());
+  RecordFreeLOS(heap_->GetLargeObjectsSpace()->Sweep(swap_bitmaps));
+}
+
+void ConcurrentCopying::FinishPhase() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  CHECK(gc_mark_stack_->IsEmpty());
+  gc_mark_stack_->Reset();
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    CHECK(shared_mark_stack_->IsEmpty());
+  }
+  VLOG(heap) << "Evacuated " << objects_moved_.LoadRelaxed() << " objects ("
+             << PrettySize(bytes_moved_.LoadRelaxed()) << "), lost "
+             << objects_lost_.LoadRelaxed() << " copy races";
+  region_space_bitmap_ = nullptr;
+  fallback_space_ = nullptr;
+  // Clear all of the spaces' mark bitmaps.
+  WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
+  heap_->ClearMarkedObjects();
+}
+
+void ConcurrentCopying::RevokeAllThreadLocalBuffers() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  GetHeap()->RevokeAllThreadLocalBuffers();
+}
+
+inline bool ConcurrentCopying::IsInFromSpace(mirror::Object* obj) const {
+  return region_space_->IsInFromSpace(obj);
+}
+
+inline bool ConcurrentCopying::IsInToSpace(mirror::Object* obj) const {
+  return region_space_->IsInToSpace(obj);
+}
+
+inline mirror::Object* ConcurrentCopying::GetFwdPtr(mirror::Object* from_ref) {
+  DCHECK(IsInFromSpace(from_ref));
+  LockWord lock_word = from_ref->GetLockWord(true);
+  if (lock_word.GetState() == LockWord::kForwardingAddress) {
+    return reinterpret_cast<mirror::Object*>(lock_word.ForwardingAddress());
+  }
+  return nullptr;
+}
+
+mirror::Object* ConcurrentCopying::Mark(mirror::Object* from_ref) {
+  if (from_ref == nullptr) {
+    return nullptr;
+  }
+  switch (region_space_->GetRegionType(from_ref)) {
+    case space::RegionSpace::kRegionTypeToSpace:
+      // Objects in the to-space were either evacuated or allocated after the flip.
+      return from_ref;
+    case space::RegionSpace::kRegionTypeFromSpace: {
+      mirror::Object* to_ref = GetFwdPtr(from_ref);
+      if (to_ref == nullptr) {
+        to_ref = Copy(from_ref);
+      }
+      return to_ref;
+    }
+    case space::RegionSpace::kRegionTypeUnevacFromSpace:
+      // Regions which are not evacuated are marked in place. The live bytes decide whether the
+      // region gets evacuated by the next collection.
+      if (MarkInPlace(from_ref, region_space_bitmap_)) {
+        region_space_->AddLiveBytes(
+            from_ref, RoundUp(from_ref->SizeOf<kVerifyNone>(), space::RegionSpace::kAlignment));
+      }
+      return from_ref;
+    case space::RegionSpace::kRegionTypeNone:
+      break;
+  }
+  if (immune_region_.ContainsObject(from_ref)) {
+    // References out of the immune spaces were updated during the flip.
+    return from_ref;
+  }
+  accounting::ContinuousSpaceBitmap* bitmap = mark_bitmap_->GetContinuousSpaceBitmap(from_ref);
+  if (bitmap != nullptr) {
+    MarkInPlace(from_ref, bitmap);
+  } else {
+    DCHECK(los_mark_bitmap_->HasAddress(from_ref)) << "Object " << from_ref << " in no space";
+    MarkInPlace(from_ref, los_mark_bitmap_);
+  }
+  return from_ref;
+}
+
+template <size_t kAlignment>
+inline bool ConcurrentCopying::MarkInPlace(mirror::Object* ref,
+                                           accounting::SpaceBitmap<kAlignment>* bitmap) {
+  if (bitmap->Test(ref)) {
+    // Already gray or scanned.
+    return false;
+  }
+  // Gray the object before setting the mark bit so that another thread which sees the mark bit
+  // also sees the object as gray until it is scanned.
+  if (!ref->AtomicSetReadBarrierPointer(ReadBarrier::WhitePtr(), ReadBarrier::GrayPtr())) {
+    // Lost the race, the winner pushes the object.
+    return false;
+  }
+  bitmap->AtomicTestAndSet(ref);
+  PushOntoMarkStack(ref);
+  return true;
+}
+
+mirror::Object* ConcurrentCopying::AllocateCopy(Thread* self, size_t num_bytes, bool* in_tlab) {
+  // Objects larger than a region are never evacuated.
+  DCHECK_LE(num_bytes, space::RegionSpace::kRegionSize);
+  if (self->TlabSize() < num_bytes) {
+    // The remainder of the current TLAB is abandoned, this is the same as what happens when a
+    // mutator refills its TLAB. Copies may use the regions the mutators are not allowed to.
+    if (region_space_->AllocNewTlab(self, true)) {
+      bytes_reserved_for_copies_.FetchAndAddSequentiallyConsistent(
+          space::RegionSpace::kRegionSize);
+    }
+  }
+  if (LIKELY(self->TlabSize() >= num_bytes)) {
+    *in_tlab = true;
+    return self->AllocTlab(num_bytes);
+  }
+  // The region space is exhausted, fall back to the non-moving space.
+  *in_tlab = false;
+  size_t bytes_allocated;
+  mirror::Object* ref = fallback_space_->Alloc(self, num_bytes, &bytes_allocated, nullptr);
+  if (ref != nullptr) {
+    bytes_reserved_for_copies_.FetchAndAddSequentiallyConsistent(bytes_allocated);
+  }
+  return ref;
+}
+
+mirror::Object* ConcurrentCopying::Copy(mirror::Object* from_ref) {
+  DCHECK(IsInFromSpace(from_ref));
+  Thread* const self = Thread::Current();
+  // Compute the size before allocating since reading the class may evacuate it, which allocates.
+  const size_t obj_size = from_ref->SizeOf<kVerifyNone>();
+  const size_t num_bytes = RoundUp(obj_size, space::RegionSpace::kAlignment);
+  bool in_tlab;
+  mirror::Object* to_ref = AllocateCopy(self, num_bytes, &in_tlab);
+  CHECK(to_ref != nullptr) << "Out of memory in the to-space and fallback space while evacuating "
+                           << from_ref;
+  if (!in_tlab) {
+    // Mark the copy before publishing it, objects in the fallback space are marked in place.
+    fallback_space_->GetLiveBitmap()->AtomicTestAndSet(to_ref);
+    fallback_space_->GetMarkBitmap()->AtomicTestAndSet(to_ref);
+  }
+  while (true) {
+    LockWord old_lock_word = from_ref->GetLockWord(true);
+    if (old_lock_word.GetState() == LockWord::kForwardingAddress) {
+      // Lost the race, another thread evacuated the object first. Discard our copy.
+      mirror::Object* winner = reinterpret_cast<mirror::Object*>(old_lock_word.ForwardingAddress());
+      memset(to_ref, 0, num_bytes);
+      if (in_tlab) {
+        self->RevertLastTlabAllocation(to_ref, num_bytes);
+      } else {
+        fallback_space_->GetLiveBitmap()->Clear(to_ref);
+        fallback_space_->GetMarkBitmap()->Clear(to_ref);
+        const size_t freed = fallback_space_->Free(self, to_ref);
+        bytes_reserved_for_copies_.FetchAndSubSequentiallyConsistent(freed);
+      }
+      objects_lost_.FetchAndAddSequentiallyConsistent(1);
+      return winner;
+    }
+    memcpy(to_ref, from_ref, obj_size);
+    // The lock word copied may be stale, the copy must carry the one we install the forwarding
+    // address over.
+    to_ref->SetLockWord(old_lock_word, false);
+    // The copy is gray until the GC thread scans it since its fields still refer to the
+    // from-space.
+    to_ref->SetReadBarrierPointer(ReadBarrier::GrayPtr());
+    LockWord new_lock_word = LockWord::FromForwardingAddress(reinterpret_cast<size_t>(to_ref));
+    // The sequentially consistent CAS publishes the contents of the copy along with the
+    // forwarding address.
+    if (from_ref->CasLockWordWeakSequentiallyConsistent(old_lock_word, new_lock_word)) {
+      objects_moved_.FetchAndAddSequentiallyConsistent(1);
+      bytes_moved_.FetchAndAddSequentiallyConsistent(num_bytes);
+      PushOntoMarkStack(to_ref);
+      return to_ref;
+    }
+    // Either the CAS failed spuriously or the lock word changed, retry.
+  }
+}
+
+mirror::Object* ConcurrentCopying::IsMarked(mirror::Object* from_ref) {
+  DCHECK(from_ref != nullptr);
+  switch (region_space_->GetRegionType(from_ref)) {
+    case space::RegionSpace::kRegionTypeToSpace:
+      return from_ref;
+    case space::RegionSpace::kRegionTypeFromSpace:
+      // Returns either the forwarding address or nullptr.
+      return GetFwdPtr(from_ref);
+    case space::RegionSpace::kRegionTypeUnevacFromSpace:
+      return region_space_bitmap_->Test(from_ref) ? from_ref : nullptr;
+    case space::RegionSpace::kRegionTypeNone:
+      break;
+  }
+  if (immune_region_.ContainsObject(from_ref)) {
+    return from_ref;
+  }
+  accounting::ContinuousSpaceBitmap* bitmap = mark_bitmap_->GetContinuousSpaceBitmap(from_ref);
+  if (bitmap != nullptr) {
+    return bitmap->Test(from_ref) ? from_ref : nullptr;
+  }
+  return los_mark_bitmap_->Test(from_ref) ? from_ref : nullptr;
+}
+
+static void PushOntoObjectStack(accounting::ObjectStack* mark_stack, mirror::Object* obj) {
+  if (UNLIKELY(mark_stack->Size() >= mark_stack->Capacity())) {
+    // Expand the mark stack to 2x its current size, Resize() drops the contents.
+    std::vector<mirror::Object*> temp(mark_stack->Begin(), mark_stack->End());
+    mark_stack->Resize(mark_stack->Capacity() * 2);
+    for (mirror::Object* ref : temp) {
+      mark_stack->PushBack(ref);
+    }
+  }
+  mark_stack->PushBack(obj);
+}
+
+void ConcurrentCopying::PushOntoMarkStack(mirror::Object* obj) {
+  Thread* self = Thread::Current();
+  if (self == thread_running_gc_) {
+    PushOntoObjectStack(gc_mark_stack_, obj);
+  } else {
+    MutexLock mu(self, mark_stack_lock_);
+    PushOntoObjectStack(shared_mark_stack_.get(), obj);
+  }
+}
+
+size_t ConcurrentCopying::DrainSharedMarkStack(Thread* self) {
+  MutexLock mu(self, mark_stack_lock_);
+  const size_t count = shared_mark_stack_->Size();
+  while (!shared_mark_stack_->IsEmpty()) {
+    PushOntoObjectStack(gc_mark_stack_, shared_mark_stack_->PopBack());
+  }
+  return count;
+}
+
+void ConcurrentCopying::ProcessMarkStack() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  DCHECK_EQ(self, thread_running_gc_);
+  do {
+    while (!gc_mark_stack_->IsEmpty()) {
+      mirror::Object* to_ref = gc_mark_stack_->PopBack();
+      DCHECK(!IsInFromSpace(to_ref));
+      DCHECK_EQ(to_ref->GetReadBarrierPointer(), ReadBarrier::GrayPtr());
+      Scan(to_ref);
+      // Publish the updated fields before turning the object white, after which the mutators
+      // read them without the read barrier.
+      bool success = to_ref->AtomicSetReadBarrierPointer(ReadBarrier::GrayPtr(),
+                                                         ReadBarrier::WhitePtr());
+      CHECK(success) << "Failed to whiten " << to_ref;
+    }
+  } while (DrainSharedMarkStack(self) != 0);
+}
+
+class ConcurrentCopyingRefFieldsVisitor {
+ public:
+  explicit ConcurrentCopyingRefFieldsVisitor(ConcurrentCopying* collector)
+      : collector_(collector) {}
+
+  void operator()(mirror::Object* obj, MemberOffset offset, bool /* is_static */) const
+      ALWAYS_INLINE SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    collector_->Process(obj, offset);
+  }
+
+  void operator()(mirror::Class* klass, mirror::Reference* ref) const
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) ALWAYS_INLINE {
+    CHECK(klass->IsTypeOfReferenceClass());
+    collector_->DelayReferenceReferent(klass, ref);
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+};
+
+// Visit all of the references of an object and update them to the to-space.
+void ConcurrentCopying::Scan(mirror::Object* to_ref) {
+  DCHECK(!IsInFromSpace(to_ref)) << "Scanning object " << to_ref << " in from space";
+  ConcurrentCopyingRefFieldsVisitor visitor(this);
+  to_ref->VisitReferences<true, kVerifyNone>(visitor, visitor);
+}
+
+inline void ConcurrentCopying::Process(mirror::Object* obj, MemberOffset offset) {
+  mirror::Object* ref =
+      obj->GetFieldObject<mirror::Object, kVerifyNone, kWithoutReadBarrier>(offset);
+  mirror::Object* to_ref = Mark(ref);
+  if (to_ref == ref) {
+    return;
+  }
+  // The mutators may write to the field of a gray object concurrently. If the field changed, the
+  // mutator stored a to-space reference and there is nothing left to do.
+  do {
+    if (ref != obj->GetFieldObject<mirror::Object, kVerifyNone, kWithoutReadBarrier>(offset)) {
+      return;
+    }
+  } while (!obj->CasFieldWeakSequentiallyConsistentObject<false, false, kVerifyNone>(
+      offset, ref, to_ref));
+}
+
+// Process the "referent" field in a java.lang.ref.Reference. If the referent has not yet been
+// marked, put it on the appropriate list in the heap for later processing.
+void ConcurrentCopying::DelayReferenceReferent(mirror::Class* klass,
+                                               mirror::Reference* reference) {
+  heap_->GetReferenceProcessor()->DelayReferenceReferent(klass, reference,
+                                                         &IsReferentMarkedInPlaceCallback, this);
+}
+
+// Referents which were evacuated are treated as unmarked while scanning so that their references
+// get queued; the referent field is then updated in the final pause where it does not race with
+// the mutators clearing it.
+bool ConcurrentCopying::IsReferentMarkedInPlaceCallback(
+    mirror::HeapReference<mirror::Object>* referent, void* arg) {
+  mirror::Object* ref = referent->AsMirrorPtr();
+  return reinterpret_cast<ConcurrentCopying*>(arg)->IsMarked(ref) == ref;
+}
+
+void ConcurrentCopying::MarkRootCallback(mirror::Object** root, void* arg,
+                                         uint32_t /*thread_id*/, RootType /*root_type*/) {
+  mirror::Object* ref = *root;
+  mirror::Object* to_ref = reinterpret_cast<ConcurrentCopying*>(arg)->Mark(ref);
+  if (to_ref != ref) {
+    *root = to_ref;
+  }
+}
+
+mirror::Object* ConcurrentCopying::MarkObjectCallback(mirror::Object* obj, void* arg) {
+  return reinterpret_cast<ConcurrentCopying*>(arg)->Mark(obj);
+}
+
+void ConcurrentCopying::MarkHeapReferenceCallback(mirror::HeapReference<mirror::Object>* obj_ptr,
+                                                  void* arg) {
+  mirror::Object* ref = obj_ptr->AsMirrorPtr();
+  mirror::Object* to_ref = reinterpret_cast<ConcurrentCopying*>(arg)->Mark(ref);
+  if (to_ref != ref) {
+    // Only called with the mutators suspended.
+    obj_ptr->Assign(to_ref);
+  }
+}
+
+void ConcurrentCopying::ProcessMarkStackCallback(void* arg) {
+  reinterpret_cast<ConcurrentCopying*>(arg)->ProcessMarkStack();
+}
+
+bool ConcurrentCopying::HeapReferenceMarkedCallback(mirror::HeapReference<mirror::Object>* object,
+                                                    void* arg) {
+  mirror::Object* ref = object->AsMirrorPtr();
+  mirror::Object* to_ref = reinterpret_cast<ConcurrentCopying*>(arg)->IsMarked(ref);
+  if (to_ref == nullptr) {
+    return false;
+  }
+  if (to_ref != ref) {
+    // Write barrier is not necessary since it still points to the same object, just at a different
+    // address.
+    object->Assign(to_ref);
+  }
+  return true;
+}
+
+mirror::Object* ConcurrentCopying::MarkedForwardingAddressCallback(mirror::Object* object,
+                                                                   void* arg) {
+  return reinterpret_cast<ConcurrentCopying*>(arg)->IsMarked(object);
+}
+
+// Used to verify that there are no references to the from-space left once marking is done.
+class ConcurrentCopyingVerifyNoFromSpaceRefsVisitor {
+ public:
+  explicit ConcurrentCopyingVerifyNoFromSpaceRefsVisitor(ConcurrentCopying* collector)
+      : collector_(collector) {}
+
+  void operator()(mirror::Object* obj, MemberOffset offset, bool /* is_static */) const
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) ALWAYS_INLINE {
+    mirror::Object* ref =
+        obj->GetFieldObject<mirror::Object, kVerifyNone, kWithoutReadBarrier>(offset);
+    if (ref != nullptr && collector_->IsInFromSpace(ref)) {
+      Runtime::Current()->GetHeap()->DumpObject(LOG(INFO), obj);
+      LOG(FATAL) << ref << " found in from space at offset " << offset.Uint32Value();
+    }
+  }
+
+  void operator()(mirror::Class* klass, mirror::Reference* ref) const
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) ALWAYS_INLINE {
+    CHECK(klass->IsTypeOfReferenceClass());
+    this->operator()(ref, mirror::Reference::ReferentOffset(), false);
+  }
+
+  static void Callback(mirror::Object* obj, void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    CHECK_EQ(obj->GetReadBarrierPointer(), ReadBarrier::WhitePtr())
+        << "Object " << obj << " is still gray";
+    ConcurrentCopyingVerifyNoFromSpaceRefsVisitor visitor(
+        reinterpret_cast<ConcurrentCopying*>(arg));
+    obj->VisitReferences<true, kVerifyNone>(visitor, visitor);
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+};
+
+void ConcurrentCopying::VerifyNoFromSpaceReferences() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  region_space_->WalkExcludingFromSpace(&ConcurrentCopyingVerifyNoFromSpaceRefsVisitor::Callback,
+                                        this);
+  ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
+  fallback_space_->GetMarkBitmap()->Walk(&ConcurrentCopyingVerifyNoFromSpaceRefsVisitor::Callback,
+                                         this);
+  los_mark_bitmap_->Walk(&ConcurrentCopyingVerifyNoFromSpaceRefsVisitor::Callback, this);
+}
+
 }  // namespace collector
 }  // namespace gc
 }  // namespace art
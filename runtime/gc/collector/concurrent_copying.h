@@ -17,32 +17,214 @@
 #ifndef ART_RUNTIME_GC_COLLECTOR_CONCURRENT_COPYING_H_
 #define ART_RUNTIME_GC_COLLECTOR_CONCURRENT_COPYING_H_
 
+#include <memory>
+
+#include "atomic.h"
+#include "base/macros.h"
+#include "base/mutex.h"
 #include "garbage_collector.h"
+#include "gc/accounting/space_bitmap.h"
+#include "immune_region.h"
+#include "mirror/object_reference.h"
+#include "object_callbacks.h"
+#include "offsets.h"
 
 namespace art {
+
+class Thread;
+
+namespace mirror {
+  class Class;
+  class Object;
+  class Reference;
+}  // namespace mirror
+
 namespace gc {
+
+class Heap;
+
+namespace accounting {
+  template <typename T> class AtomicStack;
+  typedef AtomicStack<mirror::Object*> ObjectStack;
+  class HeapBitmap;
+}  // namespace accounting
+
+namespace space {
+  class ContinuousSpace;
+  class MallocSpace;
+  class RegionSpace;
+}  // namespace space
+
 namespace collector {
 
+// A Baker style concurrent copying collector. The mutators are paused once to flip the roots to
+// the to-space (the "flip"), after which objects are evacuated from the from-space concurrently,
+// either by the GC thread or by a mutator which loads a reference out of an object that has not
+// been scanned yet (a gray object) through the read barrier. Objects outside of the from-space
+// are marked in place. A second short pause drains the remaining work, processes references and
+// sweeps the system weaks.
+//
+// The moving part of the heap is a region space. At the flip only the regions which were sparse
+// at the end of the last collection, and the regions allocated since, become the from-space.
+// Dense regions are marked in place with the region space bitmap and are freed afterwards only
+// if nothing in them survived.
+//
+// Read barrier states: an object is white when it has not been reached or has already been
+// scanned, and gray when it has been reached but its fields may still refer to the from-space.
+// Only references loaded from gray objects need to go through Mark().
 class ConcurrentCopying : public GarbageCollector {
  public:
+  // If true, verify that no from-space references remain once marking is finished.
+  static constexpr bool kEnableNoFromSpaceRefsVerification = kIsDebugBuild;
   explicit ConcurrentCopying(Heap* heap, bool generational = false,
-                             const std::string& name_prefix = "")
-      : GarbageCollector(heap,
-                         name_prefix + (name_prefix.empty() ? "" : " ") +
-                         "concurrent copying + mark sweep") {}
+                             const std::string& name_prefix = "");
+  ~ConcurrentCopying();
 
-  ~ConcurrentCopying() {}
+  virtual void RunPhases() OVERRIDE NO_THREAD_SAFETY_ANALYSIS;
+  void InitializePhase() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void MarkingPhase() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_)
+      LOCKS_EXCLUDED(Locks::heap_bitmap_lock_);
+  void ReclaimPhase() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_)
+      LOCKS_EXCLUDED(Locks::heap_bitmap_lock_);
+  void FinishPhase() LOCKS_EXCLUDED(Locks::heap_bitmap_lock_);
 
-  virtual void RunPhases() OVERRIDE {}
   virtual GcType GetGcType() const OVERRIDE {
     return kGcTypePartial;
   }
   virtual CollectorType GetCollectorType() const OVERRIDE {
     return kCollectorTypeCC;
   }
-  virtual void RevokeAllThreadLocalBuffers() OVERRIDE {}
+  virtual void RevokeAllThreadLocalBuffers() OVERRIDE;
+
+  void SetRegionSpace(space::RegionSpace* region_space) {
+    DCHECK(region_space != nullptr);
+    region_space_ = region_space;
+  }
+  // If set, evacuate every region regardless of how many of its objects survived last time.
+  void SetForceEvacuateAll(bool force_evacuate_all) {
+    force_evacuate_all_ = force_evacuate_all;
+  }
+
+  // True between the flip and the end of the final pause. While marking, the roots and any
+  // reference loaded from a gray object must be passed through Mark().
+  bool IsMarking() const {
+    return is_marking_.LoadRelaxed() != 0;
+  }
+
+  // Returns the to-space address of ref, evacuating or graying it if this is the first time it is
+  // reached. Safe to call concurrently from the GC thread and from the mutators.
+  mirror::Object* Mark(mirror::Object* ref) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Returns true if obj lives in a region being evacuated.
+  bool IsInFromSpace(mirror::Object* obj) const;
+  // Returns true if obj lives in a region objects are evacuated or allocated to.
+  bool IsInToSpace(mirror::Object* obj) const;
+
+  void Scan(mirror::Object* obj) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void Process(mirror::Object* obj, MemberOffset offset)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void DelayReferenceReferent(mirror::Class* klass, mirror::Reference* reference)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
  private:
+  // Bind the live bits to the mark bits of bitmaps for spaces that are never collected, ie
+  // the image and the zygote. Mark that portion of the heap as immune.
+  void BindBitmaps() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_)
+      LOCKS_EXCLUDED(Locks::heap_bitmap_lock_);
+  // The first pause: pick the regions to evacuate and update the roots to the to-space.
+  void FlipThreadRoots() EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_);
+  // The second pause: finish marking, process references and sweep the system weaks.
+  void FinalPause() EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void MarkRoots() EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_);
+  // Mark the objects referenced from the immune spaces through their mod-union tables.
+  void UpdateAndMarkModUnion() EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_);
+  // Mark the objects which were allocated into non-moving spaces while we were marking.
+  void MarkAllocStack() EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void ProcessReferences(Thread* self) EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void SweepSystemWeaks() EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void Sweep(bool swap_bitmaps) EXCLUSIVE_LOCKS_REQUIRED(Locks::heap_bitmap_lock_)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void SweepLargeObjects(bool swap_bitmaps) EXCLUSIVE_LOCKS_REQUIRED(Locks::heap_bitmap_lock_)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void VerifyNoFromSpaceReferences() EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Evacuate a from-space object, returns the to-space copy.
+  mirror::Object* Copy(mirror::Object* from_ref) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  // Allocate room for a copy, from the calling thread's TLAB, a new region or the non-moving
+  // space.
+  mirror::Object* AllocateCopy(Thread* self, size_t num_bytes, bool* in_tlab)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  // Gray an object which is marked in place, returns true if this thread won the race to do so.
+  template <size_t kAlignment>
+  bool MarkInPlace(mirror::Object* ref, accounting::SpaceBitmap<kAlignment>* bitmap)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  // Returns the forwarding address of a from-space object, or null if it was not evacuated.
+  mirror::Object* GetFwdPtr(mirror::Object* from_ref) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  // Returns the new address of a marked object, or null if the object is not marked.
+  mirror::Object* IsMarked(mirror::Object* ref) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  void PushOntoMarkStack(mirror::Object* obj) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  // Scan the gray objects until both the GC and the shared mark stacks are empty.
+  void ProcessMarkStack() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  // Move the objects pushed by the mutators over to the GC mark stack, returns how many.
+  size_t DrainSharedMarkStack(Thread* self) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  static void MarkRootCallback(mirror::Object** root, void* arg, uint32_t /*tid*/,
+                               RootType /*root_type*/)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  static mirror::Object* MarkObjectCallback(mirror::Object* obj, void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  static void MarkHeapReferenceCallback(mirror::HeapReference<mirror::Object>* obj_ptr, void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  static void ProcessMarkStackCallback(void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  static bool HeapReferenceMarkedCallback(mirror::HeapReference<mirror::Object>* object, void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  static mirror::Object* MarkedForwardingAddressCallback(mirror::Object* object, void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  static bool IsReferentMarkedInPlaceCallback(mirror::HeapReference<mirror::Object>* referent,
+                                              void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // The space objects are evacuated from and to, region by region.
+  space::RegionSpace* region_space_;
+  // Mark bitmap for the objects in the regions which are not evacuated.
+  accounting::ContinuousSpaceBitmap* region_space_bitmap_;
+  bool force_evacuate_all_;
+  // Fallback for evacuated objects which do not fit into the to-space.
+  space::MallocSpace* fallback_space_;
+
+  // Immune region, every object inside the immune region is assumed to be marked.
+  ImmuneRegion immune_region_;
+
+  // Cached mark bitmaps for the spaces whose objects are marked in place.
+  accounting::HeapBitmap* mark_bitmap_;
+  accounting::LargeObjectBitmap* los_mark_bitmap_;
+
+  // Mark stack only ever accessed by the thread running the GC.
+  accounting::ObjectStack* gc_mark_stack_;
+  // Mark stack the mutators push onto when they gray an object through the read barrier.
+  Mutex mark_stack_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::unique_ptr<accounting::ObjectStack> shared_mark_stack_ GUARDED_BY(mark_stack_lock_);
+
+  Thread* thread_running_gc_;
+  AtomicInteger is_marking_;
+
+  // Statistics, updated by both the GC thread and the mutators.
+  Atomic<size_t> objects_moved_;
+  Atomic<size_t> bytes_moved_;
+  // Bytes taken from the region space and the fallback space for copying, which the heap does not
+  // account for as allocations.
+  Atomic<size_t> bytes_reserved_for_copies_;
+  // Copies which lost the race to another thread and had to be thrown away.
+  Atomic<size_t> objects_lost_;
+
+  // Number of objects and bytes in the evacuated regions at the flip.
+  size_t from_space_objects_;
+  int64_t from_space_bytes_;
+
+  friend class ConcurrentCopyingRefFieldsVisitor;
+  friend class ConcurrentCopyingVerifyNoFromSpaceRefsVisitor;
   DISALLOW_COPY_AND_ASSIGN(ConcurrentCopying);
 };
 
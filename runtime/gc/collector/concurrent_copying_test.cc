@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "concurrent_copying.h"
+
+#include "common_runtime_test.h"
+#include "gc/heap.h"
+#include "gc/space/region_space.h"
+#include "handle_scope-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/string.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+namespace gc {
+namespace collector {
+
+class ConcurrentCopyingTest : public CommonRuntimeTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) OVERRIDE {
+    // The runtime refuses concurrent copying unless the read barriers are compiled in and no
+    // compiled code runs.
+    if (kUseBakerReadBarrier) {
+      options->push_back(std::make_pair("-Xgc:CC", nullptr));
+      options->push_back(std::make_pair("-Xint", nullptr));
+    }
+  }
+
+  // Returns true if the heap is running the concurrent copying collector. Otherwise the tests
+  // below have nothing to check.
+  bool UsesConcurrentCopying() {
+    return Runtime::Current()->GetHeap()->GetRegionSpace() != nullptr;
+  }
+
+  mirror::ObjectArray<mirror::Object>* AllocObjectArray(Thread* self, size_t length)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    mirror::Class* array_class = class_linker_->FindSystemClass(self, "[Ljava/lang/Object;");
+    return mirror::ObjectArray<mirror::Object>::Alloc(self, array_class, length);
+  }
+};
+
+TEST_F(ConcurrentCopyingTest, CopyCycle) {
+  if (!UsesConcurrentCopying()) {
+    return;
+  }
+  Heap* heap = Runtime::Current()->GetHeap();
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ObjectArray<mirror::Object>> a(hs.NewHandle(AllocObjectArray(soa.Self(), 2)));
+  ASSERT_TRUE(a.Get() != nullptr);
+  mirror::ObjectArray<mirror::Object>* b = AllocObjectArray(soa.Self(), 1);
+  ASSERT_TRUE(b != nullptr);
+  // a -> b -> a, and a -> a.
+  a->Set<false>(0, b);
+  a->Set<false>(1, a.Get());
+  b->Set<false>(0, a.Get());
+  mirror::Object* old_a = a.Get();
+  mirror::Object* old_b = b;
+  ASSERT_TRUE(heap->GetRegionSpace()->Contains(old_a));
+  ASSERT_TRUE(heap->GetRegionSpace()->Contains(old_b));
+
+  // Explicit collections evacuate every region, so both objects move.
+  heap->CollectGarbage(false);
+
+  mirror::ObjectArray<mirror::Object>* new_a = a.Get();
+  EXPECT_NE(old_a, new_a);
+  EXPECT_TRUE(heap->GetRegionSpace()->Contains(new_a));
+  mirror::ObjectArray<mirror::Object>* new_b = new_a->Get(0)->AsObjectArray<mirror::Object>();
+  EXPECT_NE(old_b, new_b);
+  EXPECT_TRUE(heap->GetRegionSpace()->Contains(new_b));
+  // The cycle is closed through the forwarding addresses, no field still refers to a stale copy.
+  EXPECT_EQ(new_a, new_a->Get(1));
+  EXPECT_EQ(new_a, new_b->Get(0));
+}
+
+TEST_F(ConcurrentCopyingTest, SharedReferenceIsCopiedOnce) {
+  if (!UsesConcurrentCopying()) {
+    return;
+  }
+  Heap* heap = Runtime::Current()->GetHeap();
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::ObjectArray<mirror::Object>> a(hs.NewHandle(AllocObjectArray(soa.Self(), 1)));
+  Handle<mirror::ObjectArray<mirror::Object>> b(hs.NewHandle(AllocObjectArray(soa.Self(), 1)));
+  ASSERT_TRUE(a.Get() != nullptr);
+  ASSERT_TRUE(b.Get() != nullptr);
+  mirror::String* shared = mirror::String::AllocFromModifiedUtf8(soa.Self(), "shared");
+  ASSERT_TRUE(shared != nullptr);
+  a->Set<false>(0, shared);
+  b->Set<false>(0, shared);
+  // The identity hash code lives in the lock word, which the forwarding address replaces in the
+  // from-space copy.
+  const int32_t hash_code = shared->IdentityHashCode();
+
+  heap->CollectGarbage(false);
+
+  mirror::Object* from_a = a->Get(0);
+  mirror::Object* from_b = b->Get(0);
+  EXPECT_NE(static_cast<mirror::Object*>(shared), from_a);
+  EXPECT_EQ(from_a, from_b);
+  EXPECT_EQ(hash_code, from_a->IdentityHashCode());
+  EXPECT_TRUE(from_a->AsString()->Equals("shared"));
+
+  // A second collection forwards the copy again and keeps the references consistent.
+  heap->CollectGarbage(false);
+  EXPECT_NE(from_a, a->Get(0));
+  EXPECT_EQ(a->Get(0), b->Get(0));
+  EXPECT_EQ(hash_code, a->Get(0)->IdentityHashCode());
+}
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
@@ -16,6 +16,8 @@
 
 #include "mark_sweep.h"
 
+#include <sched.h>
+
 #include <functional>
 #include <numeric>
 #include <climits>
@@ -1170,23 +1172,152 @@ void MarkSweep::ProcessMarkStackCallback(void* arg) {
   reinterpret_cast<MarkSweep*>(arg)->ProcessMarkStack(false);
 }
 
+// A parallel mark stack worker. Each worker scans objects from the bottom of its own deque and
+// pushes newly marked objects back onto it, once it runs out of work it steals from the top of the
+// other workers' deques. Marking terminates once every worker is idle, at which point all of the
+// deques are empty since only non idle workers push.
+class ParallelMarkTask : public Task {
+ public:
+  ParallelMarkTask(MarkSweep* mark_sweep, size_t index, size_t worker_count)
+      : mark_sweep_(mark_sweep),
+        deque_(mark_sweep->mark_deques_[index].get()),
+        index_(index),
+        worker_count_(worker_count),
+        random_state_(index + 1) {
+  }
+
+ private:
+  class MarkObjectParallelVisitor {
+   public:
+    explicit MarkObjectParallelVisitor(ParallelMarkTask* task) ALWAYS_INLINE : task_(task) {}
+
+    void operator()(Object* obj, MemberOffset offset, bool /* static */) const ALWAYS_INLINE
+        SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+      mirror::Object* ref = obj->GetFieldObject<mirror::Object>(offset);
+      if (ref != nullptr && task_->mark_sweep_->MarkObjectParallel(ref)) {
+        task_->deque_->PushBottom(ref);
+      }
+    }
+
+   private:
+    ParallelMarkTask* const task_;
+  };
+
+  // Scans the objects in our deque until it is empty.
+  void ProcessDeque() NO_THREAD_SAFETY_ANALYSIS {
+    MarkObjectParallelVisitor mark_visitor(this);
+    DelayReferenceReferentVisitor ref_visitor(mark_sweep_);
+    // TODO: Tune this.
+    static const size_t kFifoSize = 4;
+    BoundedFifoPowerOfTwo<Object*, kFifoSize> prefetch_fifo;
+    for (;;) {
+      Object* obj = nullptr;
+      if (kUseMarkStackPrefetch) {
+        while (prefetch_fifo.size() < kFifoSize && deque_->PopBottom(&obj)) {
+          DCHECK(obj != nullptr);
+          __builtin_prefetch(obj);
+          prefetch_fifo.push_back(obj);
+        }
+        if (UNLIKELY(prefetch_fifo.empty())) {
+          break;
+        }
+        obj = prefetch_fifo.front();
+        prefetch_fifo.pop_front();
+      } else if (UNLIKELY(!deque_->PopBottom(&obj))) {
+        break;
+      }
+      DCHECK(obj != nullptr);
+      mark_sweep_->ScanObjectVisit(obj, mark_visitor, ref_visitor);
+    }
+  }
+
+  // Tries to steal an object from the other workers, starting at a random victim.
+  bool TrySteal(Object** obj) {
+    random_state_ = random_state_ * 1103515245 + 12345;
+    const size_t start = (random_state_ >> 16) % worker_count_;
+    for (size_t i = 0; i < worker_count_; ++i) {
+      const size_t victim = (start + i) % worker_count_;
+      if (victim != index_ && mark_sweep_->mark_deques_[victim]->Steal(obj)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool AllDequesEmpty() const {
+    for (size_t i = 0; i < worker_count_; ++i) {
+      if (!mark_sweep_->mark_deques_[i]->IsEmpty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  virtual void Run(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
+    AtomicInteger* idle_workers = &mark_sweep_->idle_mark_workers_;
+    for (;;) {
+      ProcessDeque();
+      Object* obj = nullptr;
+      if (TrySteal(&obj)) {
+        deque_->PushBottom(obj);
+        continue;
+      }
+      // Out of work, wait until either everyone is idle or there is something left to steal.
+      idle_workers->FetchAndAddSequentiallyConsistent(1);
+      for (;;) {
+        if (static_cast<size_t>(idle_workers->LoadSequentiallyConsistent()) == worker_count_) {
+          return;
+        }
+        if (!AllDequesEmpty()) {
+          idle_workers->FetchAndSubSequentiallyConsistent(1);
+          break;
+        }
+        sched_yield();
+      }
+    }
+  }
+
+  virtual void Finalize() {
+    delete this;
+  }
+
+  MarkSweep* const mark_sweep_;
+  accounting::WorkStealingDeque<Object*>* const deque_;
+  const size_t index_;
+  const size_t worker_count_;
+  uint32_t random_state_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelMarkTask);
+};
+
 void MarkSweep::ProcessMarkStackParallel(size_t thread_count) {
   Thread* self = Thread::Current();
   ThreadPool* thread_pool = GetHeap()->GetThreadPool();
-  const size_t chunk_size = std::min(mark_stack_->Size() / thread_count + 1,
-                                     static_cast<size_t>(MarkStackTask<false>::kMaxSize));
-  CHECK_GT(chunk_size, 0U);
-  // Split the current mark stack up into work tasks.
-  for (mirror::Object **it = mark_stack_->Begin(), **end = mark_stack_->End(); it < end; ) {
-    const size_t delta = std::min(static_cast<size_t>(end - it), chunk_size);
-    thread_pool->AddTask(self, new MarkStackTask<false>(thread_pool, this, delta, it));
-    it += delta;
+  while (mark_deques_.size() < thread_count) {
+    mark_deques_.emplace_back(new accounting::WorkStealingDeque<Object*>);
+  }
+  // Deal the current mark stack out to the worker deques. The workers have not started yet so we
+  // may push on their behalf.
+  size_t index = 0;
+  for (mirror::Object **it = mark_stack_->Begin(), **end = mark_stack_->End(); it < end; ++it) {
+    mark_deques_[index]->PushBottom(*it);
+    index = (index + 1) % thread_count;
+  }
+  mark_stack_->Reset();
+  idle_mark_workers_.StoreRelaxed(0);
+  // One task per thread, the calling thread runs one of them from Wait. Every worker must be
+  // running for termination to be detected.
+  for (size_t i = 0; i < thread_count; ++i) {
+    thread_pool->AddTask(self, new ParallelMarkTask(this, i, thread_count));
   }
   thread_pool->SetMaxActiveWorkers(thread_count - 1);
   thread_pool->StartWorkers(self);
   thread_pool->Wait(self, true, true);
   thread_pool->StopWorkers(self);
-  mark_stack_->Reset();
+  for (size_t i = 0; i < thread_count; ++i) {
+    CHECK(mark_deques_[i]->IsEmpty());
+    mark_deques_[i]->Reset();
+  }
   CHECK_EQ(work_chunks_created_.LoadSequentiallyConsistent(),
            work_chunks_deleted_.LoadSequentiallyConsistent())
       << " some of the work chunks were leaked";
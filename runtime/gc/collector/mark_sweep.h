@@ -18,6 +18,7 @@
 #define ART_RUNTIME_GC_COLLECTOR_MARK_SWEEP_H_
 
 #include <memory>
+#include <vector>
 
 #include "atomic.h"
 #include "barrier.h"
@@ -25,6 +26,7 @@
 #include "base/mutex.h"
 #include "garbage_collector.h"
 #include "gc/accounting/heap_bitmap.h"
+#include "gc/accounting/work_stealing_deque.h"
 #include "immune_region.h"
 #include "object_callbacks.h"
 #include "offsets.h"
@@ -266,6 +268,7 @@ class MarkSweep : public GarbageCollector {
       EXCLUSIVE_LOCKS_REQUIRED(Locks::heap_bitmap_lock_)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
+  // Processes the mark stack with thread_count workers which each own a work stealing deque.
   void ProcessMarkStackParallel(size_t thread_count)
       EXCLUSIVE_LOCKS_REQUIRED(Locks::heap_bitmap_lock_)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
@@ -288,6 +291,11 @@ class MarkSweep : public GarbageCollector {
 
   accounting::ObjectStack* mark_stack_;
 
+  // Per worker deques used by ProcessMarkStackParallel, kept around between GCs.
+  std::vector<std::unique_ptr<accounting::WorkStealingDeque<mirror::Object*>>> mark_deques_;
+  // Number of parallel mark workers which ran out of work, used for termination detection.
+  AtomicInteger idle_mark_workers_;
+
   // Immune region, every object inside the immune range is assumed to be marked.
   ImmuneRegion immune_region_;
 
@@ -335,6 +343,7 @@ class MarkSweep : public GarbageCollector {
   friend class ModUnionTableReferenceCache;
   friend class ModUnionScanImageRootVisitor;
   template<bool kUseFinger> friend class MarkStackTask;
+  friend class ParallelMarkTask;
   friend class FifoMarkStackChunk;
   friend class MarkSweepMarkObjectSlowPath;
 
@@ -24,6 +24,7 @@
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/mutex-inl.h"
+#include "base/stringprintf.h"
 #include "base/timing_logger.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/accounting/mod_union_table.h"
@@ -57,6 +58,8 @@ static constexpr bool kProtectFromSpace = true;
 static constexpr bool kStoreStackTraces = false;
 static constexpr size_t kBytesPromotedThreshold = 4 * MB;
 static constexpr size_t kLargeObjectBytesAllocatedThreshold = 16 * MB;
+COMPILE_ASSERT(Heap::kMaxPromotionAge < (1U << SemiSpace::kAgeBits),
+               promotion_age_must_fit_in_the_age_bits);
 
 void SemiSpace::BindBitmaps() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
@@ -85,19 +88,29 @@ void SemiSpace::BindBitmaps() {
   }
 }
 
-SemiSpace::SemiSpace(Heap* heap, bool generational, const std::string& name_prefix)
+SemiSpace::SemiSpace(Heap* heap, bool generational, const std::string& name_prefix,
+                     size_t promotion_age)
     : GarbageCollector(heap,
                        name_prefix + (name_prefix.empty() ? "" : " ") + "marksweep + semispace"),
       to_space_(nullptr),
       from_space_(nullptr),
       generational_(generational),
       last_gc_to_space_end_(nullptr),
+      promotion_age_(promotion_age),
+      from_space_age_bitmaps_(nullptr),
+      to_space_age_bitmaps_(nullptr),
       bytes_promoted_(0),
       bytes_promoted_since_last_whole_heap_collection_(0),
       large_object_bytes_allocated_at_last_whole_heap_collection_(0),
       collect_from_space_only_(generational),
       collector_name_(name_),
       swap_semi_spaces_(true) {
+  // Objects which are not promoted are recorded with an age of at most promotion_age_.
+  CHECK_GE(promotion_age_, 1U);
+  CHECK_LT(promotion_age_, 1U << kAgeBits);
+  for (AgeBitmaps& age_bitmaps : age_bitmaps_) {
+    age_bitmaps.space = nullptr;
+  }
 }
 
 void SemiSpace::RunPhases() {
@@ -151,6 +164,52 @@ void SemiSpace::InitializePhase() {
     promo_dest_space_ = GetHeap()->GetPrimaryFreeListSpace();
   }
   fallback_space_ = GetHeap()->GetNonMovingSpace();
+  if (generational_ && promotion_age_ > 1) {
+    from_space_age_bitmaps_ = GetAgeBitmaps(from_space_);
+    to_space_age_bitmaps_ = GetAgeBitmaps(to_space_);
+  }
+}
+
+SemiSpace::AgeBitmaps* SemiSpace::GetAgeBitmaps(space::ContinuousMemMapAllocSpace* space) {
+  AgeBitmaps* unused = nullptr;
+  for (AgeBitmaps& age_bitmaps : age_bitmaps_) {
+    if (age_bitmaps.space == space &&
+        age_bitmaps.bits[0]->HeapBegin() == reinterpret_cast<uintptr_t>(space->Begin()) &&
+        age_bitmaps.bits[0]->HeapLimit() >= reinterpret_cast<uintptr_t>(space->Limit())) {
+      return &age_bitmaps;
+    }
+    if (age_bitmaps.space != from_space_ && age_bitmaps.space != to_space_) {
+      unused = &age_bitmaps;
+    }
+  }
+  CHECK(unused != nullptr);
+  unused->space = space;
+  for (size_t i = 0; i < kAgeBits; ++i) {
+    unused->bits[i].reset(accounting::ContinuousSpaceBitmap::Create(
+        StringPrintf("%s age bitmap %zu", space->GetName(), i), space->Begin(),
+        space->Capacity()));
+    CHECK(unused->bits[i].get() != nullptr);
+  }
+  return unused;
+}
+
+inline size_t SemiSpace::GetAge(const AgeBitmaps* age_bitmaps, const mirror::Object* obj) const {
+  size_t age = 0;
+  for (size_t i = 0; i < kAgeBits; ++i) {
+    if (age_bitmaps->bits[i]->Test(obj)) {
+      age |= 1U << i;
+    }
+  }
+  return age;
+}
+
+inline void SemiSpace::SetAge(AgeBitmaps* age_bitmaps, const mirror::Object* obj, size_t age) {
+  DCHECK_LT(age, 1U << kAgeBits);
+  for (size_t i = 0; i < kAgeBits; ++i) {
+    if ((age & (1U << i)) != 0) {
+      age_bitmaps->bits[i]->Set(obj);
+    }
+  }
 }
 
 void SemiSpace::ProcessReferences(Thread* self) {
@@ -252,6 +311,13 @@ void SemiSpace::MarkingPhase() {
   RecordFree(ObjectBytePair(from_objects - to_objects, from_bytes - to_bytes));
   // Clear and protect the from space.
   from_space_->Clear();
+  if (from_space_age_bitmaps_ != nullptr) {
+    // The from space becomes the to-space of the next collection, it must start out with every
+    // object at age 0.
+    for (size_t i = 0; i < kAgeBits; ++i) {
+      from_space_age_bitmaps_->bits[i]->Clear();
+    }
+  }
   VLOG(heap) << "Protecting from_space_: " << *from_space_;
   from_space_->GetMemMap()->Protect(kProtectFromSpace ? PROT_NONE : PROT_READ);
   heap_->PreSweepingGcVerification(this);
@@ -481,10 +547,17 @@ mirror::Object* SemiSpace::MarkNonForwardedObject(mirror::Object* obj) {
   const size_t object_size = obj->SizeOf();
   size_t bytes_allocated;
   mirror::Object* forward_address = nullptr;
+  // The number of collections obj survived so far. Objects allocated
+  // since the last GC are at age 0, every older object survived at
+  // least one collection.
+  size_t age = 0;
   if (generational_ && reinterpret_cast<byte*>(obj) < last_gc_to_space_end_) {
-    // If it's allocated before the last GC (older), move
-    // (pseudo-promote) it to the main free list space (as sort
-    // of an old generation.)
+    age = from_space_age_bitmaps_ != nullptr ?
+        std::max<size_t>(GetAge(from_space_age_bitmaps_, obj), 1U) : 1U;
+  }
+  if (generational_ && age >= promotion_age_) {
+    // If it's old enough, move (pseudo-promote) it to the main free
+    // list space (as sort of an old generation.)
     forward_address = promo_dest_space_->AllocThreadUnsafe(self_, object_size, &bytes_allocated,
                                                            nullptr);
     if (UNLIKELY(forward_address == nullptr)) {
@@ -492,6 +565,9 @@ mirror::Object* SemiSpace::MarkNonForwardedObject(mirror::Object* obj) {
       forward_address = to_space_->AllocThreadUnsafe(self_, object_size, &bytes_allocated, nullptr);
       // No logic for marking the bitmap, so it must be null.
       DCHECK(to_space_live_bitmap_ == nullptr);
+      if (forward_address != nullptr && to_space_age_bitmaps_ != nullptr) {
+        SetAge(to_space_age_bitmaps_, forward_address, promotion_age_);
+      }
     } else {
       bytes_promoted_ += bytes_allocated;
       // Dirty the card at the destionation as it may contain
@@ -533,11 +609,15 @@ mirror::Object* SemiSpace::MarkNonForwardedObject(mirror::Object* obj) {
       }
     }
   } else {
-    // If it's allocated after the last GC (younger), copy it to the to-space.
+    // If it's too young, copy it to the to-space.
     forward_address = to_space_->AllocThreadUnsafe(self_, object_size, &bytes_allocated, nullptr);
     if (forward_address != nullptr && to_space_live_bitmap_ != nullptr) {
       to_space_live_bitmap_->Set(forward_address);
     }
+    if (forward_address != nullptr && to_space_age_bitmaps_ != nullptr) {
+      // It survived one more collection.
+      SetAge(to_space_age_bitmaps_, forward_address, age + 1);
+    }
   }
   // If it's still null, attempt to use the fallback space.
   if (UNLIKELY(forward_address == nullptr)) {
@@ -749,6 +829,8 @@ void SemiSpace::FinishPhase() {
   // further action is done by the heap.
   to_space_ = nullptr;
   from_space_ = nullptr;
+  from_space_age_bitmaps_ = nullptr;
+  to_space_age_bitmaps_ = nullptr;
   CHECK(mark_stack_->IsEmpty());
   mark_stack_->Reset();
   if (generational_) {
@@ -58,8 +58,13 @@ class SemiSpace : public GarbageCollector {
  public:
   // If true, use remembered sets in the generational mode.
   static constexpr bool kUseRememberedSet = true;
+  // Number of bits used to record the age of the objects in the bump pointer spaces.
+  static constexpr size_t kAgeBits = 2;
 
-  explicit SemiSpace(Heap* heap, bool generational = false, const std::string& name_prefix = "");
+  // In the generational mode, objects are promoted once they have survived promotion_age
+  // collections.
+  explicit SemiSpace(Heap* heap, bool generational = false, const std::string& name_prefix = "",
+                     size_t promotion_age = 1);
 
   ~SemiSpace() {}
 
@@ -157,6 +162,20 @@ class SemiSpace : public GarbageCollector {
       SHARED_LOCKS_REQUIRED(Locks::heap_bitmap_lock_, Locks::mutator_lock_);
 
  protected:
+  // Used for the generational mode if promotion_age_ > 1. Records
+  // how many collections the objects in a bump pointer space have
+  // survived, bit i of the age is set in bits[i]. Objects allocated
+  // since the last collection have no bits set.
+  struct AgeBitmaps {
+    space::ContinuousSpace* space;
+    std::unique_ptr<accounting::ContinuousSpaceBitmap> bits[kAgeBits];
+  };
+
+  // Returns the age bitmaps covering the given bump pointer space, creating them if needed.
+  AgeBitmaps* GetAgeBitmaps(space::ContinuousMemMapAllocSpace* space);
+  size_t GetAge(const AgeBitmaps* age_bitmaps, const mirror::Object* obj) const;
+  void SetAge(AgeBitmaps* age_bitmaps, const mirror::Object* obj, size_t age);
+
   // Returns null if the object is not marked, otherwise returns the forwarding address (same as
   // object for non movable things).
   mirror::Object* GetMarkedForwardAddress(mirror::Object* object) const
@@ -230,6 +249,16 @@ class SemiSpace : public GarbageCollector {
   // pointer space at the end of the last collection.
   byte* last_gc_to_space_end_;
 
+  // Used for the generational mode. How many collections an object
+  // in the bump pointer space has to survive before it gets
+  // promoted.
+  const size_t promotion_age_;
+
+  // One for each of the two bump pointer spaces.
+  AgeBitmaps age_bitmaps_[2];
+  AgeBitmaps* from_space_age_bitmaps_;
+  AgeBitmaps* to_space_age_bitmaps_;
+
   // Used for the generational mode. During a collection, keeps track
   // of how many bytes of objects have been copied so far from the
   // bump pointer space to the non-moving space.
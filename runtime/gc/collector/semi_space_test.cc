@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "semi_space.h"
+
+#include "base/stringprintf.h"
+#include "common_runtime_test.h"
+#include "gc/heap.h"
+#include "gc/space/space.h"
+#include "handle_scope-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/string.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+namespace gc {
+namespace collector {
+
+template <size_t kPromotionAge>
+class GenerationalSemiSpaceTest : public CommonRuntimeTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) OVERRIDE {
+    options->push_back(std::make_pair("-Xgc:GSS", nullptr));
+    options->push_back(std::make_pair("-XX:BackgroundGC=GSS", nullptr));
+    promotion_age_option_ = StringPrintf("-XX:PromotionAge=%zu", kPromotionAge);
+    options->push_back(std::make_pair(promotion_age_option_.c_str(), nullptr));
+  }
+
+  bool IsInBumpPointerSpace(mirror::Object* obj) {
+    space::ContinuousSpace* space =
+        Runtime::Current()->GetHeap()->FindContinuousSpaceFromObject(obj, true);
+    return space != nullptr && space->IsBumpPointerSpace();
+  }
+
+  // Allocates a string in the nursery and checks that it moves between the bump pointer spaces
+  // until it has the promotion age, then moves to the main space once.
+  void CheckPromotion() {
+    Heap* heap = Runtime::Current()->GetHeap();
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::String> young(
+        hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "young")));
+    ASSERT_TRUE(young.Get() != nullptr);
+    ASSERT_TRUE(IsInBumpPointerSpace(young.Get()));
+
+    // An object allocated since the last collection survives kPromotionAge collections in the
+    // bump pointer spaces and gets promoted by the next one.
+    for (size_t i = 0; i != kPromotionAge; ++i) {
+      mirror::Object* old_address = young.Get();
+      heap->CollectGarbage(false);
+      EXPECT_NE(old_address, young.Get()) << "collection " << i;
+      EXPECT_TRUE(IsInBumpPointerSpace(young.Get())) << "collection " << i;
+      EXPECT_TRUE(young->Equals("young"));
+    }
+    heap->CollectGarbage(false);
+    EXPECT_FALSE(IsInBumpPointerSpace(young.Get()));
+    EXPECT_TRUE(heap->GetPrimaryFreeListSpace()->Contains(young.Get()));
+    EXPECT_TRUE(young->Equals("young"));
+
+    // Promoted objects stay where they are.
+    mirror::Object* promoted_address = young.Get();
+    heap->CollectGarbage(false);
+    EXPECT_EQ(promoted_address, young.Get());
+  }
+
+  std::string promotion_age_option_;
+};
+
+typedef GenerationalSemiSpaceTest<1> PromotionAge1Test;
+typedef GenerationalSemiSpaceTest<2> PromotionAge2Test;
+typedef GenerationalSemiSpaceTest<Heap::kMaxPromotionAge> MaxPromotionAgeTest;
+
+TEST_F(PromotionAge1Test, Promotion) {
+  CheckPromotion();
+}
+
+TEST_F(PromotionAge2Test, Promotion) {
+  CheckPromotion();
+}
+
+TEST_F(MaxPromotionAgeTest, Promotion) {
+  CheckPromotion();
+}
+
+}  // namespace collector
+}  // namespace gc
+}  // namespace art
@@ -46,6 +46,7 @@
 #include "gc/space/dlmalloc_space-inl.h"
 #include "gc/space/image_space.h"
 #include "gc/space/large_object_space.h"
+#include "gc/space/region_space.h"
 #include "gc/space/rosalloc_space-inl.h"
 #include "gc/space/space-inl.h"
 #include "gc/space/zygote_space.h"
@@ -108,7 +109,8 @@ Heap::Heap(size_t initial_size, size_t growth_limit, size_t min_free, size_t max
            bool verify_pre_gc_heap, bool verify_pre_sweeping_heap, bool verify_post_gc_heap,
            bool verify_pre_gc_rosalloc, bool verify_pre_sweeping_rosalloc,
            bool verify_post_gc_rosalloc, bool use_homogeneous_space_compaction_for_oom,
-           uint64_t min_interval_homogeneous_space_compaction_by_oom)
+           uint64_t min_interval_homogeneous_space_compaction_by_oom,
+           size_t promotion_age)
     : non_moving_space_(nullptr),
       rosalloc_space_(nullptr),
       dlmalloc_space_(nullptr),
@@ -169,6 +171,7 @@ Heap::Heap(size_t initial_size, size_t growth_limit, size_t min_free, size_t max
       current_non_moving_allocator_(kAllocatorTypeNonMoving),
       bump_pointer_space_(nullptr),
       temp_space_(nullptr),
+      region_space_(nullptr),
       min_free_(min_free),
       max_free_(max_free),
       target_utilization_(target_utilization),
@@ -187,6 +190,25 @@ Heap::Heap(size_t initial_size, size_t growth_limit, size_t min_free, size_t max
   if (VLOG_IS_ON(heap) || VLOG_IS_ON(startup)) {
     LOG(INFO) << "Heap() entering";
   }
+  if (!kUseBakerReadBarrier || !Runtime::Current()->GetInstrumentation()->InterpretOnly()) {
+    // The concurrent copying collector relies on every reference load going through the read
+    // barrier. Compiled code does not emit read barriers, so fall back to the semi-space collector
+    // unless the barriers are compiled in and everything runs in the interpreter.
+    if (foreground_collector_type_ == kCollectorTypeCC) {
+      LOG(WARNING) << "Concurrent copying requires Baker read barriers and -Xint, "
+                   << "using semi-space instead";
+      foreground_collector_type_ = kCollectorTypeSS;
+      desired_collector_type_ = foreground_collector_type_;
+    }
+    if (background_collector_type_ == kCollectorTypeCC) {
+      background_collector_type_ = kCollectorTypeSS;
+    }
+  }
+  if (foreground_collector_type_ == kCollectorTypeCC) {
+    // The region space can't be transitioned to and from the other spaces yet, so stay with the
+    // concurrent copying collector in the background.
+    background_collector_type_ = foreground_collector_type_;
+  }
   // If we aren't the zygote, switch to the default non zygote allocator. This may update the
   // entrypoints.
   if (!Runtime::Current()->IsZygote()) {
@@ -254,8 +276,13 @@ Heap::Heap(size_t initial_size, size_t growth_limit, size_t min_free, size_t max
                              kNonMovingSpaceCapacity, PROT_READ | PROT_WRITE, true, &error_str));
     CHECK(non_moving_space_mem_map != nullptr) << error_str;
   }
-  // Attempt to create 2 mem maps at or after the requested begin.
-  main_mem_map_1.reset(MapAnonymousPreferredAddress(kMemMapSpaceName[0], request_begin, capacity_,
+  // Attempt to create 2 mem maps at or after the requested begin. The region space used by the
+  // concurrent copying collector needs room for both the from-space and the to-space regions in
+  // a single mem map.
+  const size_t main_mem_map_1_capacity =
+      foreground_collector_type_ == kCollectorTypeCC ? capacity_ * 2 : capacity_;
+  main_mem_map_1.reset(MapAnonymousPreferredAddress(kMemMapSpaceName[0], request_begin,
+                                                    main_mem_map_1_capacity,
                                                     PROT_READ | PROT_WRITE, &error_str));
   CHECK(main_mem_map_1.get() != nullptr) << error_str;
   if (support_homogeneous_space_compaction ||
@@ -280,7 +307,13 @@ Heap::Heap(size_t initial_size, size_t growth_limit, size_t min_free, size_t max
     AddSpace(non_moving_space_);
   }
   // Create other spaces based on whether or not we have a moving GC.
-  if (IsMovingGc(foreground_collector_type_) && foreground_collector_type_ != kCollectorTypeGSS) {
+  if (foreground_collector_type_ == kCollectorTypeCC) {
+    region_space_ = space::RegionSpace::CreateFromMemMap("Region space", main_mem_map_1.release());
+    CHECK(region_space_ != nullptr) << "Failed to create region space";
+    AddSpace(region_space_);
+    CHECK(separate_non_moving_space);
+  } else if (IsMovingGc(foreground_collector_type_) &&
+             foreground_collector_type_ != kCollectorTypeGSS) {
     // Create bump pointer spaces.
     // We only to create the bump pointer if the foreground collector is a compacting GC.
     // TODO: Place bump-pointer spaces somewhere to minimize size of card table.
@@ -391,7 +424,8 @@ Heap::Heap(size_t initial_size, size_t growth_limit, size_t min_free, size_t max
     // TODO: Clean this up.
     const bool generational = foreground_collector_type_ == kCollectorTypeGSS;
     semi_space_collector_ = new collector::SemiSpace(this, generational,
-                                                     generational ? "generational" : "");
+                                                     generational ? "generational" : "",
+                                                     promotion_age);
     garbage_collectors_.push_back(semi_space_collector_);
     concurrent_copying_collector_ = new collector::ConcurrentCopying(this);
     garbage_collectors_.push_back(concurrent_copying_collector_);
@@ -653,6 +687,9 @@ void Heap::VisitObjects(ObjectCallback callback, void* arg) {
     // Visit objects in bump pointer space.
     bump_pointer_space_->Walk(callback, arg);
   }
+  if (region_space_ != nullptr) {
+    region_space_->Walk(callback, arg);
+  }
   // TODO: Switch to standard begin and end to use ranged a based loop.
   for (mirror::Object** it = allocation_stack_->Begin(), **end = allocation_stack_->End();
       it < end; ++it) {
@@ -895,6 +932,9 @@ void Heap::ThrowOutOfMemoryError(Thread* self, size_t byte_count, AllocatorType
     } else if (allocator_type == kAllocatorTypeBumpPointer ||
                allocator_type == kAllocatorTypeTLAB) {
       space = bump_pointer_space_;
+    } else if (allocator_type == kAllocatorTypeRegion ||
+               allocator_type == kAllocatorTypeRegionTLAB) {
+      space = region_space_;
     }
     if (space != nullptr) {
       space->LogFragmentationAllocFailure(oss, byte_count);
@@ -989,6 +1029,9 @@ void Heap::Trim() {
   if (bump_pointer_space_ != nullptr) {
     total_alloc_space_allocated -= bump_pointer_space_->Size();
   }
+  if (region_space_ != nullptr) {
+    total_alloc_space_allocated -= region_space_->GetBytesAllocated();
+  }
   const float managed_utilization = static_cast<float>(total_alloc_space_allocated) /
       static_cast<float>(total_alloc_space_size);
   uint64_t gc_heap_end_ns = NanoTime();
@@ -1057,6 +1100,16 @@ bool Heap::IsLiveObjectLocked(mirror::Object* obj, bool search_allocation_stack,
     // a GC). When a GC isn't running End() - Begin() is 0 which means no objects are contained.
     return temp_space_->Contains(obj);
   }
+  if (region_space_ != nullptr && region_space_->HasAddress(obj)) {
+    if (!region_space_->Contains(obj)) {
+      return false;
+    }
+    mirror::Class* klass = obj->GetClass<kVerifyNone>();
+    if (obj == klass) {
+      return true;
+    }
+    return VerifyClassClass(klass) && IsLiveObjectLocked(klass);
+  }
   space::ContinuousSpace* c_space = FindContinuousSpaceFromObject(obj, true);
   space::DiscontinuousSpace* d_space = nullptr;
   if (c_space != nullptr) {
@@ -1681,7 +1734,9 @@ void Heap::ChangeCollector(CollectorType collector_type) {
       case kCollectorTypeSS:  // Fall-through.
       case kCollectorTypeGSS: {
         gc_plan_.push_back(collector::kGcTypeFull);
-        if (use_tlab_) {
+        if (collector_type_ == kCollectorTypeCC) {
+          ChangeAllocator(use_tlab_ ? kAllocatorTypeRegionTLAB : kAllocatorTypeRegion);
+        } else if (use_tlab_) {
           ChangeAllocator(kAllocatorTypeTLAB);
         } else {
           ChangeAllocator(kAllocatorTypeBumpPointer);
@@ -1853,7 +1908,12 @@ void Heap::PreZygoteFork() {
                                          non_moving_space_->Limit());
     // Compact the bump pointer space to a new zygote bump pointer space.
     bool reset_main_space = false;
-    if (IsMovingGc(collector_type_)) {
+    space::ContinuousMemMapAllocSpace* from_space = nullptr;
+    if (region_space_ != nullptr) {
+      from_space = region_space_;
+      zygote_collector.SetFromSpace(region_space_);
+    } else if (IsMovingGc(collector_type_)) {
+      from_space = bump_pointer_space_;
       zygote_collector.SetFromSpace(bump_pointer_space_);
     } else {
       CHECK(main_space_ != nullptr);
@@ -1874,7 +1934,7 @@ void Heap::PreZygoteFork() {
       delete old_main_space;
       AddSpace(main_space_);
     } else {
-      bump_pointer_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
+      from_space->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
     }
     if (temp_space_ != nullptr) {
       CHECK(temp_space_->IsEmpty());
@@ -2045,7 +2105,9 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type, GcCaus
   // TODO: Clean this up.
   if (compacting_gc) {
     DCHECK(current_allocator_ == kAllocatorTypeBumpPointer ||
-           current_allocator_ == kAllocatorTypeTLAB);
+           current_allocator_ == kAllocatorTypeTLAB ||
+           current_allocator_ == kAllocatorTypeRegion ||
+           current_allocator_ == kAllocatorTypeRegionTLAB);
     switch (collector_type_) {
       case kCollectorTypeSS:
         // Fall-through.
@@ -2056,6 +2118,10 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type, GcCaus
         collector = semi_space_collector_;
         break;
       case kCollectorTypeCC:
+        concurrent_copying_collector_->SetRegionSpace(region_space_);
+        // Explicit and transition GCs evacuate every region to compact the heap fully.
+        concurrent_copying_collector_->SetForceEvacuateAll(
+            gc_cause == kGcCauseExplicit || gc_cause == kGcCauseCollectorTransition);
         collector = concurrent_copying_collector_;
         break;
       case kCollectorTypeMC:
@@ -2065,7 +2131,7 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type, GcCaus
       default:
         LOG(FATAL) << "Invalid collector type " << static_cast<size_t>(collector_type_);
     }
-    if (collector != mark_compact_collector_) {
+    if (collector == semi_space_collector_) {
       temp_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
       CHECK(temp_space_->IsEmpty());
     }
@@ -2531,6 +2597,9 @@ void Heap::AssertAllBumpPointerSpaceThreadLocalBuffersAreRevoked() {
     if (bump_pointer_space_ != nullptr) {
       bump_pointer_space_->AssertAllThreadLocalBuffersAreRevoked();
     }
+    if (region_space_ != nullptr) {
+      region_space_->AssertAllThreadLocalBuffersAreRevoked();
+    }
   }
 }
 
@@ -2987,6 +3056,9 @@ void Heap::RevokeThreadLocalBuffers(Thread* thread) {
   if (bump_pointer_space_ != nullptr) {
     bump_pointer_space_->RevokeThreadLocalBuffers(thread);
   }
+  if (region_space_ != nullptr) {
+    region_space_->RevokeThreadLocalBuffers(thread);
+  }
 }
 
 void Heap::RevokeRosAllocThreadLocalBuffers(Thread* thread) {
@@ -3002,6 +3074,9 @@ void Heap::RevokeAllThreadLocalBuffers() {
   if (bump_pointer_space_ != nullptr) {
     bump_pointer_space_->RevokeAllThreadLocalBuffers();
   }
+  if (region_space_ != nullptr) {
+    region_space_->RevokeAllThreadLocalBuffers();
+  }
 }
 
 bool Heap::IsGCRequestPending() const {
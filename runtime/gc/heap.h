@@ -84,6 +84,7 @@ namespace space {
   class ImageSpace;
   class LargeObjectSpace;
   class MallocSpace;
+  class RegionSpace;
   class RosAllocSpace;
   class Space;
   class SpaceTest;
@@ -141,6 +142,11 @@ class Heap {
   static constexpr size_t kDefaultTLABSize = 256 * KB;
   static constexpr double kDefaultTargetUtilization = 0.5;
   static constexpr double kDefaultHeapGrowthMultiplier = 2.0;
+  // Number of collections an object has to survive in the bump pointer space of the generational
+  // semi-space collector before it gets promoted. The default promotes on the first collection an
+  // object survives, as before ages were tracked, and needs no age bitmaps.
+  static constexpr size_t kDefaultPromotionAge = 1;
+  static constexpr size_t kMaxPromotionAge = 3;
 
   // Used so that we don't overflow the allocation time atomic integer.
   static constexpr size_t kTimeAdjust = 1024;
@@ -165,7 +171,8 @@ class Heap {
                 bool verify_pre_gc_heap, bool verify_pre_sweeping_heap, bool verify_post_gc_heap,
                 bool verify_pre_gc_rosalloc, bool verify_pre_sweeping_rosalloc,
                 bool verify_post_gc_rosalloc, bool use_homogeneous_space_compaction,
-                uint64_t min_interval_homogeneous_space_compaction_by_oom);
+                uint64_t min_interval_homogeneous_space_compaction_by_oom,
+                size_t promotion_age);
 
   ~Heap();
 
@@ -523,6 +530,15 @@ class Heap {
     return large_object_space_;
   }
 
+  space::RegionSpace* GetRegionSpace() const {
+    return region_space_;
+  }
+
+  // Used by the read barrier to find out whether the concurrent copying collector is running.
+  collector::ConcurrentCopying* ConcurrentCopyingCollector() const {
+    return concurrent_copying_collector_;
+  }
+
   // Returns the free list space that may contain movable objects (the
   // one that's not the non-moving space), either rosalloc_space_ or
   // dlmalloc_space_.
@@ -607,10 +623,16 @@ class Heap {
   static ALWAYS_INLINE bool AllocatorHasAllocationStack(AllocatorType allocator_type) {
     return
         allocator_type != kAllocatorTypeBumpPointer &&
-        allocator_type != kAllocatorTypeTLAB;
+        allocator_type != kAllocatorTypeTLAB &&
+        allocator_type != kAllocatorTypeRegion &&
+        allocator_type != kAllocatorTypeRegionTLAB;
   }
   static ALWAYS_INLINE bool AllocatorMayHaveConcurrentGC(AllocatorType allocator_type) {
-    return AllocatorHasAllocationStack(allocator_type);
+    // The concurrent copying collector allocates from the region space, which is only possible if
+    // Baker read barriers are compiled in.
+    return AllocatorHasAllocationStack(allocator_type) ||
+        (kUseBakerReadBarrier && (allocator_type == kAllocatorTypeRegion ||
+                                  allocator_type == kAllocatorTypeRegionTLAB));
   }
   static bool IsMovingGc(CollectorType collector_type) {
     return collector_type == kCollectorTypeSS || collector_type == kCollectorTypeGSS ||
@@ -978,6 +1000,9 @@ class Heap {
   // Temp space is the space which the semispace collector copies to.
   space::BumpPointerSpace* temp_space_;
 
+  // Region space, used by the concurrent copying collector.
+  space::RegionSpace* region_space_;
+
   // Minimum free guarantees that you always have at least min_free_ free bytes after growing for
   // utilization, regardless of target utilization ratio.
   size_t min_free_;
@@ -1036,6 +1061,7 @@ class Heap {
   // Whether or not we use homogeneous space compaction to avoid OOM errors.
   bool use_homogeneous_space_compaction_for_oom_;
 
+  friend class collector::ConcurrentCopying;
   friend class collector::GarbageCollector;
   friend class collector::MarkCompact;
   friend class collector::MarkSweep;
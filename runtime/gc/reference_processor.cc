@@ -19,6 +19,7 @@
 #include "mirror/object-inl.h"
 #include "mirror/reference.h"
 #include "mirror/reference-inl.h"
+#include "read_barrier-inl.h"
 #include "reference_processor-inl.h"
 #include "reflection.h"
 #include "ScopedLocalRef.h"
@@ -44,7 +45,13 @@ void ReferenceProcessor::DisableSlowPath(Thread* self) {
 }
 
 mirror::Object* ReferenceProcessor::GetReferent(Thread* self, mirror::Reference* reference) {
-  mirror::Object* const referent = reference->GetReferent();
+  mirror::Object* referent = reference->GetReferent();
+  if (kUseBakerReadBarrier && referent != nullptr && ReadBarrier::IsMarking()) {
+    // The concurrent copying collector updates the referent fields of scanned references only
+    // during reference processing, the field may still point to the from-space until then. Handing
+    // the referent to the mutator makes it reachable, so mark it.
+    referent = ReadBarrier::Mark(referent);
+  }
   // If the referent is null then it is already cleared, we can just return null since there is no
   // scenario where it becomes non-null during the reference processing phase.
   if (UNLIKELY(!SlowPathEnabled()) || referent == nullptr) {
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_SPACE_REGION_SPACE_INL_H_
+#define ART_RUNTIME_GC_SPACE_REGION_SPACE_INL_H_
+
+#include "region_space.h"
+
+#include "base/mutex-inl.h"
+#include "thread-inl.h"
+
+namespace art {
+namespace gc {
+namespace space {
+
+inline mirror::Object* RegionSpace::Alloc(Thread*, size_t num_bytes, size_t* bytes_allocated,
+                                          size_t* usable_size) {
+  num_bytes = RoundUp(num_bytes, kAlignment);
+  return AllocNonvirtual(num_bytes, bytes_allocated, usable_size);
+}
+
+inline mirror::Object* RegionSpace::AllocThreadUnsafe(Thread* self, size_t num_bytes,
+                                                      size_t* bytes_allocated,
+                                                      size_t* usable_size) {
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  return Alloc(self, num_bytes, bytes_allocated, usable_size);
+}
+
+inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes, size_t* bytes_allocated,
+                                                    size_t* usable_size) {
+  DCHECK(IsAligned<kAlignment>(num_bytes));
+  if (UNLIKELY(num_bytes > kRegionSize)) {
+    return AllocLarge(num_bytes, bytes_allocated, usable_size);
+  }
+  mirror::Object* obj = current_region_->Alloc(num_bytes, bytes_allocated, usable_size);
+  if (LIKELY(obj != nullptr)) {
+    return obj;
+  }
+  MutexLock mu(Thread::Current(), region_lock_);
+  // Retry with the current region since another thread may have replaced it.
+  obj = current_region_->Alloc(num_bytes, bytes_allocated, usable_size);
+  if (obj != nullptr) {
+    return obj;
+  }
+  Region* r = AllocateRegion(false);
+  if (r == nullptr) {
+    return nullptr;
+  }
+  obj = r->Alloc(num_bytes, bytes_allocated, usable_size);
+  CHECK(obj != nullptr);
+  current_region_ = r;
+  return obj;
+}
+
+inline mirror::Object* RegionSpace::Region::Alloc(size_t num_bytes, size_t* bytes_allocated,
+                                                  size_t* usable_size) {
+  DCHECK(IsInToSpace());
+  byte* old_top;
+  byte* new_top;
+  do {
+    old_top = top_.LoadRelaxed();
+    new_top = old_top + num_bytes;
+    // If there is no more room in the region, the caller picks another one.
+    if (UNLIKELY(new_top > end_)) {
+      return nullptr;
+    }
+  } while (!top_.CompareExchangeWeakSequentiallyConsistent(old_top, new_top));
+  objects_allocated_.FetchAndAddSequentiallyConsistent(1);
+  *bytes_allocated = num_bytes;
+  if (usable_size != nullptr) {
+    *usable_size = num_bytes;
+  }
+  return reinterpret_cast<mirror::Object*>(old_top);
+}
+
+}  // namespace space
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_SPACE_REGION_SPACE_INL_H_
@@ -0,0 +1,460 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "region_space.h"
+#include "region_space-inl.h"
+
+#include "gc/accounting/space_bitmap-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "thread_list.h"
+
+namespace art {
+namespace gc {
+namespace space {
+
+RegionSpace* RegionSpace::Create(const std::string& name, size_t capacity,
+                                 byte* requested_begin) {
+  capacity = RoundUp(capacity, kRegionSize);
+  std::string error_msg;
+  std::unique_ptr<MemMap> mem_map(MemMap::MapAnonymous(name.c_str(), requested_begin, capacity,
+                                                       PROT_READ | PROT_WRITE, true, &error_msg));
+  if (mem_map.get() == nullptr) {
+    LOG(ERROR) << "Failed to allocate pages for alloc space (" << name << ") of size "
+        << PrettySize(capacity) << " with message " << error_msg;
+    return nullptr;
+  }
+  return new RegionSpace(name, mem_map.release());
+}
+
+RegionSpace* RegionSpace::CreateFromMemMap(const std::string& name, MemMap* mem_map) {
+  return new RegionSpace(name, mem_map);
+}
+
+RegionSpace::RegionSpace(const std::string& name, MemMap* mem_map)
+    : ContinuousMemMapAllocSpace(name, mem_map, mem_map->Begin(), mem_map->End(), mem_map->End(),
+                                 kGcRetentionPolicyAlwaysCollect),
+      region_lock_("Region lock", kRegionSpaceRegionLock),
+      num_regions_(mem_map->Size() / kRegionSize),
+      num_non_free_regions_(0),
+      regions_(new Region[num_regions_]),
+      current_region_(&full_region_) {
+  CHECK_ALIGNED(mem_map->Size(), kRegionSize);
+  CHECK_GT(num_regions_, 0U);
+  for (size_t i = 0; i < num_regions_; ++i) {
+    byte* region_begin = Begin() + i * kRegionSize;
+    regions_[i].Init(i, region_begin, region_begin + kRegionSize);
+  }
+  region_bitmap_.reset(accounting::ContinuousSpaceBitmap::Create(
+      StringPrintf("region space bitmap %p", Begin()), Begin(), Capacity()));
+  CHECK(region_bitmap_.get() != nullptr) << "Failed to create the region space bitmap";
+}
+
+mirror::Object* RegionSpace::AllocLarge(size_t num_bytes, size_t* bytes_allocated,
+                                        size_t* usable_size) {
+  DCHECK(IsAligned<kAlignment>(num_bytes));
+  DCHECK_GT(num_bytes, kRegionSize);
+  const size_t num_regs = RoundUp(num_bytes, kRegionSize) / kRegionSize;
+  MutexLock mu(Thread::Current(), region_lock_);
+  // Leave half of the regions for evacuation, see AllocateRegion().
+  if ((num_non_free_regions_ + num_regs) * 2 > num_regions_) {
+    return nullptr;
+  }
+  // Find a run of num_regs free regions.
+  size_t left = 0;
+  while (left + num_regs <= num_regions_) {
+    size_t right = left;
+    while (right < left + num_regs && regions_[right].IsFree()) {
+      ++right;
+    }
+    if (right == left + num_regs) {
+      Region* first = &regions_[left];
+      first->UnfreeLarge(first->Begin() + num_regs * kRegionSize);
+      for (size_t p = left + 1; p < right; ++p) {
+        regions_[p].UnfreeLargeTail();
+      }
+      num_non_free_regions_ += num_regs;
+      *bytes_allocated = num_regs * kRegionSize;
+      if (usable_size != nullptr) {
+        *usable_size = num_regs * kRegionSize;
+      }
+      return reinterpret_cast<mirror::Object*>(first->Begin());
+    }
+    // regions_[right] is not free, no run containing it can be used.
+    left = right + 1;
+  }
+  return nullptr;
+}
+
+size_t RegionSpace::AllocationSizeNonvirtual(mirror::Object* obj, size_t* usable_size) {
+  size_t num_bytes = obj->SizeOf();
+  if (usable_size != nullptr) {
+    if (LIKELY(num_bytes <= kRegionSize)) {
+      *usable_size = RoundUp(num_bytes, kAlignment);
+    } else {
+      *usable_size = RoundUp(num_bytes, kRegionSize);
+    }
+  }
+  return num_bytes;
+}
+
+RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
+  if (!for_evac && (num_non_free_regions_ + 1) * 2 > num_regions_) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (r->IsFree()) {
+      r->Unfree(!for_evac);
+      ++num_non_free_regions_;
+      return r;
+    }
+  }
+  return nullptr;
+}
+
+void RegionSpace::Region::Clear() {
+  top_.StoreRelaxed(begin_);
+  state_ = kRegionStateFree;
+  type_ = kRegionTypeNone;
+  objects_allocated_.StoreRelaxed(0);
+  live_bytes_.StoreRelaxed(kLiveBytesUnknown);
+  is_newly_allocated_ = false;
+  walk_with_bitmap_ = false;
+  thread_ = nullptr;
+  // Release the pages back to the operating system.
+  if (!kMadviseZeroes) {
+    memset(begin_, 0, end_ - begin_);
+  }
+  CHECK_NE(madvise(begin_, end_ - begin_, MADV_DONTNEED), -1) << "madvise failed";
+}
+
+bool RegionSpace::Region::ShouldBeEvacuated() const {
+  DCHECK(state_ == kRegionStateAllocated && IsInToSpace());
+  // Objects allocated since the last collection are likely to be dead by now.
+  if (is_newly_allocated_) {
+    return true;
+  }
+  const size_t live_bytes = LiveBytes();
+  if (live_bytes == kLiveBytesUnknown) {
+    // Evacuated objects were copied here by the last collection, the region is dense.
+    return false;
+  }
+  return live_bytes * 100U < kEvacuateLivePercentThreshold * BytesAllocated();
+}
+
+void RegionSpace::Clear() {
+  MutexLock mu(Thread::Current(), region_lock_);
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (!r->IsFree()) {
+      r->Clear();
+    }
+  }
+  num_non_free_regions_ = 0;
+  current_region_ = &full_region_;
+  region_bitmap_->Clear();
+}
+
+void RegionSpace::SetFromSpace(bool force_evacuate_all) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  size_t num_evacuated = 0;
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (r->IsFree()) {
+      continue;
+    }
+    DCHECK(!r->IsTlab()) << "TLABs must be revoked before a collection";
+    // Large objects are never moved.
+    if (!r->IsLarge() && !r->IsLargeTail() &&
+        (force_evacuate_all || r->ShouldBeEvacuated())) {
+      r->SetAsFromSpace();
+      ++num_evacuated;
+    } else {
+      r->SetAsUnevacFromSpace();
+      // Marking recomputes which of the objects are live.
+      region_bitmap_->ClearRange(reinterpret_cast<mirror::Object*>(r->Begin()),
+                                 reinterpret_cast<mirror::Object*>(r->End()));
+    }
+  }
+  // Allocations resume in fresh regions.
+  current_region_ = &full_region_;
+  VLOG(heap) << "Evacuating " << num_evacuated << " out of " << num_non_free_regions_
+             << " regions";
+}
+
+void RegionSpace::ClearFromSpace(uint64_t* cleared_bytes, uint64_t* cleared_objects) {
+  *cleared_bytes = 0;
+  *cleared_objects = 0;
+  MutexLock mu(Thread::Current(), region_lock_);
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (r->IsInFromSpace()) {
+      // The collector accounts for these through GetBytesAllocatedInFromSpace().
+      region_bitmap_->ClearRange(reinterpret_cast<mirror::Object*>(r->Begin()),
+                                 reinterpret_cast<mirror::Object*>(r->End()));
+      r->Clear();
+      --num_non_free_regions_;
+    } else if (r->IsInUnevacFromSpace() && !r->IsLargeTail()) {
+      // Large object tails are handled along with the region the object starts in.
+      size_t num_regs = 1;
+      if (r->IsLarge()) {
+        while (i + num_regs < num_regions_ && regions_[i + num_regs].IsLargeTail()) {
+          ++num_regs;
+        }
+      }
+      if (r->LiveBytes() == 0) {
+        *cleared_bytes += r->BytesAllocated();
+        *cleared_objects += r->ObjectsAllocated();
+        for (size_t j = i; j < i + num_regs; ++j) {
+          region_bitmap_->ClearRange(reinterpret_cast<mirror::Object*>(regions_[j].Begin()),
+                                     reinterpret_cast<mirror::Object*>(regions_[j].End()));
+          regions_[j].Clear();
+        }
+        num_non_free_regions_ -= num_regs;
+      } else {
+        for (size_t j = i; j < i + num_regs; ++j) {
+          regions_[j].SetUnevacFromSpaceAsToSpace();
+        }
+      }
+      i += num_regs - 1;
+    }
+  }
+}
+
+uint64_t RegionSpace::GetBytesAllocatedInternal(RegionType type) {
+  uint64_t bytes = 0;
+  MutexLock mu(Thread::Current(), region_lock_);
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (!r->IsFree() && (type == kRegionTypeNone || r->Type() == type)) {
+      bytes += r->BytesAllocated();
+    }
+  }
+  return bytes;
+}
+
+uint64_t RegionSpace::GetObjectsAllocatedInternal(RegionType type) {
+  uint64_t objects = 0;
+  MutexLock mu(Thread::Current(), region_lock_);
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (!r->IsFree() && (type == kRegionTypeNone || r->Type() == type)) {
+      objects += r->ObjectsAllocated();
+    }
+  }
+  return objects;
+}
+
+size_t RegionSpace::GetNumFreeRegions() {
+  MutexLock mu(Thread::Current(), region_lock_);
+  return num_regions_ - num_non_free_regions_;
+}
+
+bool RegionSpace::AllocNewTlab(Thread* self, bool for_evac) {
+  MutexLock mu(self, region_lock_);
+  RevokeThreadLocalBuffersLocked(self);
+  Region* r = AllocateRegion(for_evac);
+  if (r == nullptr) {
+    return false;
+  }
+  r->SetTlab(self);
+  self->SetTlab(r->Begin(), r->End());
+  return true;
+}
+
+void RegionSpace::RevokeThreadLocalBuffers(Thread* thread) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  RevokeThreadLocalBuffersLocked(thread);
+}
+
+void RegionSpace::RevokeThreadLocalBuffersLocked(Thread* thread) {
+  byte* tlab_start = thread->GetTlabStart();
+  if (tlab_start != nullptr) {
+    Region* r = RefToRegion(reinterpret_cast<mirror::Object*>(tlab_start));
+    DCHECK_EQ(r->Begin(), tlab_start);
+    r->RevokeTlab(thread->GetThreadLocalObjectsAllocated());
+  }
+  thread->SetTlab(nullptr, nullptr);
+}
+
+void RegionSpace::RevokeAllThreadLocalBuffers() {
+  Thread* self = Thread::Current();
+  MutexLock mu(self, *Locks::runtime_shutdown_lock_);
+  MutexLock mu2(self, *Locks::thread_list_lock_);
+  std::list<Thread*> thread_list = Runtime::Current()->GetThreadList()->GetList();
+  for (Thread* thread : thread_list) {
+    RevokeThreadLocalBuffers(thread);
+  }
+}
+
+void RegionSpace::AssertThreadLocalBuffersAreRevoked(Thread* thread) {
+  if (kIsDebugBuild) {
+    DCHECK(!thread->HasTlab());
+  }
+}
+
+void RegionSpace::AssertAllThreadLocalBuffersAreRevoked() {
+  if (kIsDebugBuild) {
+    Thread* self = Thread::Current();
+    MutexLock mu(self, *Locks::runtime_shutdown_lock_);
+    MutexLock mu2(self, *Locks::thread_list_lock_);
+    std::list<Thread*> thread_list = Runtime::Current()->GetThreadList()->GetList();
+    for (Thread* thread : thread_list) {
+      AssertThreadLocalBuffersAreRevoked(thread);
+    }
+  }
+}
+
+void RegionSpace::Walk(ObjectCallback* callback, void* arg) {
+  WalkInternal<false>(callback, arg);
+}
+
+void RegionSpace::WalkExcludingFromSpace(ObjectCallback* callback, void* arg) {
+  WalkInternal<true>(callback, arg);
+}
+
+template <bool kExcludeFromSpace>
+void RegionSpace::WalkInternal(ObjectCallback* callback, void* arg) {
+  // No lock is taken since the region types only change while the mutators are suspended. The
+  // TLABs need to be revoked for all of the objects in them to be visited.
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (r->IsFree() || r->IsLargeTail() || (kExcludeFromSpace && r->IsInFromSpace())) {
+      continue;
+    }
+    // The dead objects in regions collected in place may refer to classes which no longer exist,
+    // only visit the objects which were marked.
+    const bool use_bitmap = r->IsInUnevacFromSpace() || r->WalkWithBitmap();
+    if (r->IsLarge()) {
+      mirror::Object* obj = reinterpret_cast<mirror::Object*>(r->Begin());
+      if (!use_bitmap || region_bitmap_->Test(obj)) {
+        callback(obj, arg);
+      }
+    } else if (use_bitmap) {
+      region_bitmap_->VisitMarkedRange(reinterpret_cast<uintptr_t>(r->Begin()),
+                                       reinterpret_cast<uintptr_t>(r->Top()),
+                                       [callback, arg](mirror::Object* obj) {
+        callback(obj, arg);
+      });
+    } else {
+      byte* pos = r->Begin();
+      byte* top = r->Top();
+      while (pos < top) {
+        mirror::Object* obj = reinterpret_cast<mirror::Object*>(pos);
+        if (obj->GetClass<kVerifyNone, kWithoutReadBarrier>() == nullptr) {
+          // The unused end of a TLAB, or an object whose class is not written yet.
+          break;
+        }
+        callback(obj, arg);
+        pos += RoundUp(obj->SizeOf<kVerifyNone>(), kAlignment);
+      }
+    }
+  }
+}
+
+void RegionSpace::LogFragmentationAllocFailure(std::ostream& os,
+                                               size_t /* failed_alloc_bytes */) {
+  size_t max_contiguous_allocation = 0;
+  MutexLock mu(Thread::Current(), region_lock_);
+  if (current_region_->End() - current_region_->Top() > 0) {
+    max_contiguous_allocation = current_region_->End() - current_region_->Top();
+  }
+  if (num_non_free_regions_ * 2 < num_regions_) {
+    // Half of the regions are reserved for evacuation, large allocations only succeed below that.
+    size_t num_contiguous_free_regions = 0;
+    for (size_t i = 0; i < num_regions_; ++i) {
+      if (regions_[i].IsFree()) {
+        ++num_contiguous_free_regions;
+        max_contiguous_allocation = std::max(max_contiguous_allocation,
+                                             num_contiguous_free_regions * kRegionSize);
+      } else {
+        num_contiguous_free_regions = 0;
+      }
+    }
+  }
+  os << "; failed due to fragmentation (largest possible contiguous allocation "
+     << max_contiguous_allocation << " bytes)";
+  // Caller's job to print failed_alloc_bytes.
+}
+
+void RegionSpace::Dump(std::ostream& os) const {
+  os << GetName() << " "
+      << reinterpret_cast<void*>(Begin()) << "-" << reinterpret_cast<void*>(Limit());
+}
+
+void RegionSpace::DumpRegions(std::ostream& os) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  for (size_t i = 0; i < num_regions_; ++i) {
+    regions_[i].Dump(os);
+  }
+}
+
+void RegionSpace::Region::Dump(std::ostream& os) const {
+  os << "Region[" << idx_ << "]=" << reinterpret_cast<void*>(begin_) << "-"
+     << reinterpret_cast<void*>(Top()) << "-" << reinterpret_cast<void*>(end_)
+     << " state=" << state_ << " type=" << type_
+     << " objects_allocated=" << ObjectsAllocated()
+     << " live_bytes=" << LiveBytes()
+     << " is_newly_allocated=" << is_newly_allocated_
+     << " is_a_tlab=" << IsTlab() << "\n";
+}
+
+std::ostream& operator<<(std::ostream& os, const RegionSpace::RegionType& value) {
+  switch (value) {
+    case RegionSpace::kRegionTypeNone:
+      os << "None";
+      break;
+    case RegionSpace::kRegionTypeToSpace:
+      os << "ToSpace";
+      break;
+    case RegionSpace::kRegionTypeFromSpace:
+      os << "FromSpace";
+      break;
+    case RegionSpace::kRegionTypeUnevacFromSpace:
+      os << "UnevacFromSpace";
+      break;
+    default:
+      os << "RegionType[" << static_cast<int>(value) << "]";
+      break;
+  }
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const RegionSpace::RegionState& value) {
+  switch (value) {
+    case RegionSpace::kRegionStateFree:
+      os << "Free";
+      break;
+    case RegionSpace::kRegionStateAllocated:
+      os << "Allocated";
+      break;
+    case RegionSpace::kRegionStateLarge:
+      os << "Large";
+      break;
+    case RegionSpace::kRegionStateLargeTail:
+      os << "LargeTail";
+      break;
+    default:
+      os << "RegionState[" << static_cast<int>(value) << "]";
+      break;
+  }
+  return os;
+}
+
+}  // namespace space
+}  // namespace gc
+}  // namespace art
@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_SPACE_REGION_SPACE_H_
+#define ART_RUNTIME_GC_SPACE_REGION_SPACE_H_
+
+#include <memory>
+
+#include "atomic.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "gc/accounting/space_bitmap.h"
+#include "object_callbacks.h"
+#include "space.h"
+
+namespace art {
+namespace gc {
+namespace space {
+
+// A space that consists of equal-sized regions. Objects are bump pointer allocated inside of a
+// region, thread-local buffers are whole regions and objects larger than a region get a run of
+// contiguous regions of their own. The concurrent copying collector evacuates the regions with
+// few live bytes and marks the objects in the other regions in place, so that a collection only
+// needs as much free memory as there is live data in the evacuated regions.
+class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
+ public:
+  enum RegionType {
+    kRegionTypeNone,              // Free region.
+    kRegionTypeToSpace,           // Regular region which is not being collected.
+    kRegionTypeFromSpace,         // Region being evacuated.
+    kRegionTypeUnevacFromSpace,   // Region being collected whose objects are marked in place.
+  };
+
+  enum RegionState {
+    kRegionStateFree,             // Free region.
+    kRegionStateAllocated,        // Region which objects are bump pointer allocated in.
+    kRegionStateLarge,            // First region of a large object.
+    kRegionStateLargeTail,        // Any following region of a large object.
+  };
+
+  // Object alignment within the space.
+  static constexpr size_t kAlignment = kObjectAlignment;
+  // The region size, also the size of the thread-local buffers.
+  static constexpr size_t kRegionSize = 1 * MB;
+  // Regions which were not allocated into since the last collection are only evacuated if fewer
+  // than this percentage of their bytes were live at the last collection.
+  static constexpr size_t kEvacuateLivePercentThreshold = 75U;
+
+  SpaceType GetType() const OVERRIDE {
+    return kSpaceTypeRegionSpace;
+  }
+
+  // Create a region space with the requested sizes. The requested base address is not
+  // guaranteed to be granted, if it is required, the caller should call Begin on the returned
+  // space to confirm the request was granted.
+  static RegionSpace* Create(const std::string& name, size_t capacity, byte* requested_begin);
+  static RegionSpace* CreateFromMemMap(const std::string& name, MemMap* mem_map);
+
+  // Allocate num_bytes, returns nullptr if the space is full.
+  mirror::Object* Alloc(Thread* self, size_t num_bytes, size_t* bytes_allocated,
+                        size_t* usable_size) OVERRIDE LOCKS_EXCLUDED(region_lock_);
+  // Thread-unsafe allocation for when mutators are suspended, used by the semispace collector.
+  mirror::Object* AllocThreadUnsafe(Thread* self, size_t num_bytes, size_t* bytes_allocated,
+                                    size_t* usable_size)
+      OVERRIDE EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_) LOCKS_EXCLUDED(region_lock_);
+  // The main allocation routine, num_bytes must be kAlignment aligned.
+  mirror::Object* AllocNonvirtual(size_t num_bytes, size_t* bytes_allocated, size_t* usable_size)
+      ALWAYS_INLINE LOCKS_EXCLUDED(region_lock_);
+  // Allocate an object which is larger than a region into a run of free regions.
+  mirror::Object* AllocLarge(size_t num_bytes, size_t* bytes_allocated, size_t* usable_size)
+      LOCKS_EXCLUDED(region_lock_);
+
+  // Return the storage space required by obj.
+  size_t AllocationSize(mirror::Object* obj, size_t* usable_size) OVERRIDE
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    return AllocationSizeNonvirtual(obj, usable_size);
+  }
+  size_t AllocationSizeNonvirtual(mirror::Object* obj, size_t* usable_size)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Objects are only ever reclaimed a region at a time by the collector.
+  size_t Free(Thread*, mirror::Object*) OVERRIDE {
+    UNIMPLEMENTED(FATAL);
+    return 0;
+  }
+  size_t FreeList(Thread*, size_t, mirror::Object**) OVERRIDE {
+    UNIMPLEMENTED(FATAL);
+    return 0;
+  }
+
+  accounting::ContinuousSpaceBitmap* GetLiveBitmap() const OVERRIDE {
+    return nullptr;
+  }
+  accounting::ContinuousSpaceBitmap* GetMarkBitmap() const OVERRIDE {
+    return nullptr;
+  }
+  // Bitmap used by the collector to mark the objects in the regions which are not evacuated. The
+  // bits of the regions which survived a collection in place also tell which of their objects are
+  // live, since the dead ones may refer to classes which no longer exist.
+  accounting::ContinuousSpaceBitmap* GetRegionBitmap() const {
+    return region_bitmap_.get();
+  }
+
+  // Free all of the regions.
+  void Clear() OVERRIDE LOCKS_EXCLUDED(region_lock_);
+
+  void Dump(std::ostream& os) const;
+  void DumpRegions(std::ostream& os) LOCKS_EXCLUDED(region_lock_);
+
+  void RevokeThreadLocalBuffers(Thread* thread) LOCKS_EXCLUDED(region_lock_);
+  void RevokeAllThreadLocalBuffers() LOCKS_EXCLUDED(Locks::runtime_shutdown_lock_,
+                                                    Locks::thread_list_lock_);
+  void AssertThreadLocalBuffersAreRevoked(Thread* thread) LOCKS_EXCLUDED(region_lock_);
+  void AssertAllThreadLocalBuffersAreRevoked() LOCKS_EXCLUDED(Locks::runtime_shutdown_lock_,
+                                                              Locks::thread_list_lock_);
+
+  uint64_t GetBytesAllocated() OVERRIDE LOCKS_EXCLUDED(region_lock_) {
+    return GetBytesAllocatedInternal(kRegionTypeNone);
+  }
+  uint64_t GetObjectsAllocated() OVERRIDE LOCKS_EXCLUDED(region_lock_) {
+    return GetObjectsAllocatedInternal(kRegionTypeNone);
+  }
+  uint64_t GetBytesAllocatedInFromSpace() LOCKS_EXCLUDED(region_lock_) {
+    return GetBytesAllocatedInternal(kRegionTypeFromSpace);
+  }
+  uint64_t GetObjectsAllocatedInFromSpace() LOCKS_EXCLUDED(region_lock_) {
+    return GetObjectsAllocatedInternal(kRegionTypeFromSpace);
+  }
+
+  bool CanMoveObjects() const OVERRIDE {
+    return true;
+  }
+
+  RegionSpace* AsRegionSpace() OVERRIDE {
+    return this;
+  }
+
+  // Returns true if obj lies in a region which is not free.
+  bool Contains(const mirror::Object* obj) const {
+    return HasAddress(obj) && !RefToRegion(obj)->IsFree();
+  }
+
+  // Allocate a whole region as the TLAB of self, returns false if there is no free region left.
+  // TLABs for evacuated objects are not considered newly allocated.
+  bool AllocNewTlab(Thread* self, bool for_evac) LOCKS_EXCLUDED(region_lock_);
+
+  // Go through all of the regions and visit the objects.
+  void Walk(ObjectCallback* callback, void* arg) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  // Same as Walk() but skips the regions being evacuated.
+  void WalkExcludingFromSpace(ObjectCallback* callback, void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  accounting::ContinuousSpaceBitmap::SweepCallback* GetSweepCallback() OVERRIDE {
+    return nullptr;
+  }
+
+  void LogFragmentationAllocFailure(std::ostream& os, size_t failed_alloc_bytes) OVERRIDE
+      LOCKS_EXCLUDED(region_lock_);
+
+  // Region type queries, used by the concurrent copying collector. The region types only change
+  // while the mutators are suspended.
+  bool IsInFromSpace(const mirror::Object* ref) const {
+    return GetRegionType(ref) == kRegionTypeFromSpace;
+  }
+  bool IsInUnevacFromSpace(const mirror::Object* ref) const {
+    return GetRegionType(ref) == kRegionTypeUnevacFromSpace;
+  }
+  bool IsInToSpace(const mirror::Object* ref) const {
+    return GetRegionType(ref) == kRegionTypeToSpace;
+  }
+  RegionType GetRegionType(const mirror::Object* ref) const {
+    if (HasAddress(ref)) {
+      return RefToRegion(ref)->Type();
+    }
+    return kRegionTypeNone;
+  }
+
+  // Pick the regions to evacuate at the start of a collection, all of the other allocated regions
+  // are collected in place. Requires all of the thread-local buffers to be revoked.
+  void SetFromSpace(bool force_evacuate_all) LOCKS_EXCLUDED(region_lock_);
+  // Free the evacuated regions and the regions collected in place which have no live objects
+  // left, returns the bytes and objects freed from the latter.
+  void ClearFromSpace(uint64_t* cleared_bytes, uint64_t* cleared_objects)
+      LOCKS_EXCLUDED(region_lock_);
+
+  // Record that a marked object in a region collected in place is live.
+  void AddLiveBytes(const mirror::Object* ref, size_t num_bytes) {
+    RefToRegion(ref)->AddLiveBytes(num_bytes);
+  }
+
+  size_t GetNumRegions() const {
+    return num_regions_;
+  }
+  size_t GetNumFreeRegions() LOCKS_EXCLUDED(region_lock_);
+
+ private:
+  // Unknown liveness, eg. for a region evacuated objects were copied into.
+  static constexpr size_t kLiveBytesUnknown = static_cast<size_t>(-1);
+
+  class Region {
+   public:
+    Region()
+        : idx_(static_cast<size_t>(-1)), begin_(nullptr), top_(nullptr), end_(nullptr),
+          state_(kRegionStateAllocated), type_(kRegionTypeToSpace), objects_allocated_(0),
+          live_bytes_(kLiveBytesUnknown), is_newly_allocated_(false),
+          walk_with_bitmap_(false), thread_(nullptr) {
+    }
+
+    void Init(size_t idx, byte* begin, byte* end) {
+      idx_ = idx;
+      begin_ = begin;
+      top_.StoreRelaxed(begin);
+      end_ = end;
+      state_ = kRegionStateFree;
+      type_ = kRegionTypeNone;
+    }
+
+    // Bump pointer allocate num_bytes, thread safe.
+    mirror::Object* Alloc(size_t num_bytes, size_t* bytes_allocated, size_t* usable_size)
+        ALWAYS_INLINE;
+
+    // Return the region to the free state and release its pages.
+    void Clear();
+
+    void Unfree(bool is_newly_allocated) {
+      DCHECK(IsFree());
+      state_ = kRegionStateAllocated;
+      type_ = kRegionTypeToSpace;
+      is_newly_allocated_ = is_newly_allocated;
+      live_bytes_.StoreRelaxed(kLiveBytesUnknown);
+    }
+    void UnfreeLarge(byte* top) {
+      DCHECK(IsFree());
+      state_ = kRegionStateLarge;
+      type_ = kRegionTypeToSpace;
+      is_newly_allocated_ = true;
+      top_.StoreRelaxed(top);
+      objects_allocated_.StoreRelaxed(1);
+      live_bytes_.StoreRelaxed(kLiveBytesUnknown);
+    }
+    void UnfreeLargeTail() {
+      DCHECK(IsFree());
+      state_ = kRegionStateLargeTail;
+      type_ = kRegionTypeToSpace;
+    }
+
+    void SetAsFromSpace() {
+      DCHECK(!IsFree() && IsInToSpace());
+      type_ = kRegionTypeFromSpace;
+    }
+    void SetAsUnevacFromSpace() {
+      DCHECK(!IsFree() && IsInToSpace());
+      type_ = kRegionTypeUnevacFromSpace;
+      is_newly_allocated_ = false;
+      live_bytes_.StoreRelaxed(0);
+    }
+    void SetUnevacFromSpaceAsToSpace() {
+      DCHECK(!IsFree() && IsInUnevacFromSpace());
+      type_ = kRegionTypeToSpace;
+      walk_with_bitmap_ = true;
+    }
+
+    // Whether the region is worth evacuating, based on the liveness seen by the last collection.
+    bool ShouldBeEvacuated() const;
+
+    // Take over the allocations a thread made in its TLAB.
+    void RevokeTlab(size_t num_objects) {
+      DCHECK(thread_ != nullptr);
+      objects_allocated_.FetchAndAddSequentiallyConsistent(num_objects);
+      thread_ = nullptr;
+    }
+    void SetTlab(Thread* thread) {
+      DCHECK(thread_ == nullptr);
+      // The whole region is accounted for as allocated, like the TLABs of the bump pointer space.
+      top_.StoreRelaxed(end_);
+      thread_ = thread;
+    }
+
+    void AddLiveBytes(size_t num_bytes) {
+      DCHECK(IsInUnevacFromSpace());
+      live_bytes_.FetchAndAddSequentiallyConsistent(num_bytes);
+    }
+
+    size_t Idx() const {
+      return idx_;
+    }
+    byte* Begin() const {
+      return begin_;
+    }
+    byte* Top() const {
+      return top_.LoadRelaxed();
+    }
+    byte* End() const {
+      return end_;
+    }
+    RegionState State() const {
+      return state_;
+    }
+    RegionType Type() const {
+      return type_;
+    }
+    bool IsFree() const {
+      return state_ == kRegionStateFree;
+    }
+    bool IsLarge() const {
+      return state_ == kRegionStateLarge;
+    }
+    bool IsLargeTail() const {
+      return state_ == kRegionStateLargeTail;
+    }
+    bool IsInFromSpace() const {
+      return type_ == kRegionTypeFromSpace;
+    }
+    bool IsInUnevacFromSpace() const {
+      return type_ == kRegionTypeUnevacFromSpace;
+    }
+    bool IsInToSpace() const {
+      return type_ == kRegionTypeToSpace;
+    }
+    bool IsTlab() const {
+      return thread_ != nullptr;
+    }
+    bool WalkWithBitmap() const {
+      return walk_with_bitmap_;
+    }
+    size_t LiveBytes() const {
+      return live_bytes_.LoadRelaxed();
+    }
+    size_t BytesAllocated() const {
+      return IsLargeTail() ? 0 : Top() - Begin();
+    }
+    size_t ObjectsAllocated() const {
+      return IsLargeTail() ? 0 : objects_allocated_.LoadRelaxed();
+    }
+
+    void Dump(std::ostream& os) const;
+
+   private:
+    size_t idx_;
+    byte* begin_;
+    // The allocation pointer. For a large object, the end of the object's regions.
+    Atomic<byte*> top_;
+    byte* end_;
+    RegionState state_;
+    RegionType type_;
+    Atomic<size_t> objects_allocated_;
+    // Bytes found live by the last collection which marked this region in place.
+    Atomic<size_t> live_bytes_;
+    // Allocated into by the mutators since the last collection.
+    bool is_newly_allocated_;
+    // The region survived a collection in place and may contain dead objects.
+    bool walk_with_bitmap_;
+    // The thread which uses the region as its TLAB, if any.
+    Thread* thread_;
+
+    DISALLOW_COPY_AND_ASSIGN(Region);
+  };
+
+  RegionSpace(const std::string& name, MemMap* mem_map);
+
+  Region* RefToRegion(const mirror::Object* ref) const {
+    DCHECK(HasAddress(ref));
+    const size_t offset = reinterpret_cast<const byte*>(ref) - Begin();
+    return &regions_[offset / kRegionSize];
+  }
+
+  // Take a free region, returns nullptr if there are none left. The mutators may use up to half
+  // of the regions so that there is always room to evacuate into.
+  Region* AllocateRegion(bool for_evac) EXCLUSIVE_LOCKS_REQUIRED(region_lock_);
+  void RevokeThreadLocalBuffersLocked(Thread* thread) EXCLUSIVE_LOCKS_REQUIRED(region_lock_);
+
+  uint64_t GetBytesAllocatedInternal(RegionType type) LOCKS_EXCLUDED(region_lock_);
+  uint64_t GetObjectsAllocatedInternal(RegionType type) LOCKS_EXCLUDED(region_lock_);
+
+  template <bool kExcludeFromSpace>
+  void WalkInternal(ObjectCallback* callback, void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  Mutex region_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  const size_t num_regions_;
+  size_t num_non_free_regions_ GUARDED_BY(region_lock_);
+  std::unique_ptr<Region[]> regions_;
+  // The region shared allocations are bump pointer allocated in. Read without holding the lock on
+  // the fast path, only replaced while holding it.
+  Region* current_region_;
+  // Sentinel region which is always full, used as the current region when there is none.
+  Region full_region_;
+  std::unique_ptr<accounting::ContinuousSpaceBitmap> region_bitmap_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegionSpace);
+};
+
+std::ostream& operator<<(std::ostream& os, const RegionSpace::RegionType& value);
+std::ostream& operator<<(std::ostream& os, const RegionSpace::RegionState& value);
+
+}  // namespace space
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_SPACE_REGION_SPACE_H_
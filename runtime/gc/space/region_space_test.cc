@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "region_space.h"
+#include "region_space-inl.h"
+
+#include <memory>
+
+#include "common_runtime_test.h"
+
+namespace art {
+namespace gc {
+namespace space {
+
+class RegionSpaceTest : public CommonRuntimeTest {
+ protected:
+  static constexpr size_t kNumRegions = 16;
+
+  RegionSpace* CreateSpace() {
+    return RegionSpace::Create("test region space", kNumRegions * RegionSpace::kRegionSize,
+                               nullptr);
+  }
+
+  mirror::Object* Alloc(RegionSpace* space, size_t num_bytes) {
+    size_t bytes_allocated = 0;
+    mirror::Object* obj = space->Alloc(Thread::Current(), num_bytes, &bytes_allocated, nullptr);
+    if (obj != nullptr) {
+      EXPECT_GE(bytes_allocated, num_bytes);
+    }
+    return obj;
+  }
+};
+
+TEST_F(RegionSpaceTest, Alloc) {
+  std::unique_ptr<RegionSpace> space(CreateSpace());
+  ASSERT_TRUE(space.get() != nullptr);
+  EXPECT_EQ(kNumRegions, space->GetNumRegions());
+  EXPECT_EQ(kNumRegions, space->GetNumFreeRegions());
+  mirror::Object* obj1 = Alloc(space.get(), 16);
+  mirror::Object* obj2 = Alloc(space.get(), 20);
+  ASSERT_TRUE(obj1 != nullptr);
+  ASSERT_TRUE(obj2 != nullptr);
+  // Allocations are bump pointer allocated inside of the same region.
+  EXPECT_EQ(reinterpret_cast<byte*>(obj1) + 16, reinterpret_cast<byte*>(obj2));
+  EXPECT_TRUE(space->Contains(obj1));
+  EXPECT_TRUE(space->IsInToSpace(obj1));
+  EXPECT_EQ(kNumRegions - 1, space->GetNumFreeRegions());
+  EXPECT_EQ(2U, space->GetObjectsAllocated());
+  EXPECT_EQ(16U + 24U, space->GetBytesAllocated());
+  // An allocation which does not fit into the current region goes into a new one.
+  mirror::Object* obj3 = Alloc(space.get(), RegionSpace::kRegionSize);
+  ASSERT_TRUE(obj3 != nullptr);
+  EXPECT_EQ(kNumRegions - 2, space->GetNumFreeRegions());
+  space->Clear();
+  EXPECT_EQ(kNumRegions, space->GetNumFreeRegions());
+  EXPECT_FALSE(space->Contains(obj1));
+}
+
+TEST_F(RegionSpaceTest, AllocLarge) {
+  std::unique_ptr<RegionSpace> space(CreateSpace());
+  ASSERT_TRUE(space.get() != nullptr);
+  size_t bytes_allocated = 0;
+  size_t usable_size = 0;
+  mirror::Object* obj = space->AllocNonvirtual(RegionSpace::kRegionSize * 2 + 8,
+                                               &bytes_allocated, &usable_size);
+  ASSERT_TRUE(obj != nullptr);
+  EXPECT_EQ(RegionSpace::kRegionSize * 3, bytes_allocated);
+  EXPECT_EQ(RegionSpace::kRegionSize * 3, usable_size);
+  EXPECT_EQ(kNumRegions - 3, space->GetNumFreeRegions());
+  EXPECT_EQ(1U, space->GetObjectsAllocated());
+  // The mutators may only use half of the regions.
+  EXPECT_TRUE(space->AllocNonvirtual(RegionSpace::kRegionSize * 5 + 8, &bytes_allocated,
+                                     &usable_size) == nullptr);
+}
+
+TEST_F(RegionSpaceTest, Tlab) {
+  std::unique_ptr<RegionSpace> space(CreateSpace());
+  ASSERT_TRUE(space.get() != nullptr);
+  Thread* self = Thread::Current();
+  ASSERT_TRUE(space->AllocNewTlab(self, false));
+  EXPECT_EQ(RegionSpace::kRegionSize, self->TlabSize());
+  mirror::Object* obj = self->AllocTlab(32);
+  EXPECT_TRUE(space->Contains(obj));
+  space->RevokeThreadLocalBuffers(self);
+  EXPECT_FALSE(self->HasTlab());
+  EXPECT_EQ(1U, space->GetObjectsAllocated());
+  // The whole TLAB is accounted for as allocated.
+  EXPECT_EQ(RegionSpace::kRegionSize, space->GetBytesAllocated());
+}
+
+TEST_F(RegionSpaceTest, EvacuateNewlyAllocatedRegions) {
+  std::unique_ptr<RegionSpace> space(CreateSpace());
+  ASSERT_TRUE(space.get() != nullptr);
+  const size_t half_region = RegionSpace::kRegionSize / 2;
+  mirror::Object* obj1 = Alloc(space.get(), half_region);
+  mirror::Object* obj2 = Alloc(space.get(), RegionSpace::kRegionSize);
+  ASSERT_TRUE(obj1 != nullptr);
+  ASSERT_TRUE(obj2 != nullptr);
+  // Newly allocated regions are always evacuated.
+  space->SetFromSpace(false);
+  EXPECT_TRUE(space->IsInFromSpace(obj1));
+  EXPECT_TRUE(space->IsInFromSpace(obj2));
+  EXPECT_EQ(2U, space->GetObjectsAllocatedInFromSpace());
+  uint64_t cleared_bytes;
+  uint64_t cleared_objects;
+  space->ClearFromSpace(&cleared_bytes, &cleared_objects);
+  EXPECT_EQ(0U, cleared_bytes);
+  EXPECT_EQ(kNumRegions, space->GetNumFreeRegions());
+}
+
+TEST_F(RegionSpaceTest, UnevacuatedRegions) {
+  std::unique_ptr<RegionSpace> space(CreateSpace());
+  ASSERT_TRUE(space.get() != nullptr);
+  Thread* self = Thread::Current();
+  // Objects copied by the collector go into regions which are not newly allocated.
+  ASSERT_TRUE(space->AllocNewTlab(self, true));
+  mirror::Object* live = self->AllocTlab(RegionSpace::kRegionSize / 2);
+  ASSERT_TRUE(space->AllocNewTlab(self, true));
+  mirror::Object* dead = self->AllocTlab(64);
+  space->RevokeThreadLocalBuffers(self);
+  // Regions copied into are dense, they get marked in place.
+  space->SetFromSpace(false);
+  EXPECT_TRUE(space->IsInUnevacFromSpace(live));
+  EXPECT_TRUE(space->IsInUnevacFromSpace(dead));
+  space->AddLiveBytes(live, RegionSpace::kRegionSize / 2);
+  uint64_t cleared_bytes;
+  uint64_t cleared_objects;
+  space->ClearFromSpace(&cleared_bytes, &cleared_objects);
+  // The region without live objects is freed.
+  EXPECT_EQ(RegionSpace::kRegionSize, cleared_bytes);
+  EXPECT_EQ(1U, cleared_objects);
+  EXPECT_TRUE(space->IsInToSpace(live));
+  EXPECT_FALSE(space->Contains(dead));
+  EXPECT_EQ(kNumRegions - 1, space->GetNumFreeRegions());
+  // Half of the survivor's bytes are live, below the threshold, so it is evacuated next time.
+  space->SetFromSpace(false);
+  EXPECT_TRUE(space->IsInFromSpace(live));
+  space->ClearFromSpace(&cleared_bytes, &cleared_objects);
+  EXPECT_EQ(kNumRegions, space->GetNumFreeRegions());
+}
+
+}  // namespace space
+}  // namespace gc
+}  // namespace art
@@ -58,6 +58,11 @@ BumpPointerSpace* Space::AsBumpPointerSpace() {
   return nullptr;
 }
 
+RegionSpace* Space::AsRegionSpace() {
+  LOG(FATAL) << "Unreachable";
+  return nullptr;
+}
+
 AllocSpace* Space::AsAllocSpace() {
   LOG(FATAL) << "Unimplemented";
   return nullptr;
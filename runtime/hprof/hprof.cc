@@ -15,27 +15,27 @@
  */
 
 /*
- * Preparation and completion of hprof data generation.  The output is
- * written into two files and then combined.  This is necessary because
- * we generate some of the data (strings and classes) while we dump the
- * heap, and some analysis tools require that the class and string data
- * appear first.
+ * Preparation and completion of hprof data generation.  Some analysis
+ * tools require that the string and class data appear before the heap
+ * records that refer to them, but we only discover those strings and
+ * classes while walking the heap.  The heap is therefore walked twice:
+ * the first pass only collects the strings and classes, the second pass
+ * streams the heap records to the output after the tables have been
+ * written, so the dump never has to be held in memory.
  */
 
 #include "hprof.h"
 
-#include <cutils/open_memstream.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/time.h>
-#include <sys/uio.h>
-#include <time.h>
 #include <time.h>
 #include <unistd.h>
 
 #include <set>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/stringprintf.h"
@@ -56,6 +56,7 @@
 #include "safe_map.h"
 #include "scoped_thread_state_change.h"
 #include "thread_list.h"
+#include "zlib.h"
 
 namespace art {
 
@@ -170,6 +171,195 @@ enum HprofBasicType {
 typedef uint32_t HprofStringId;
 typedef uint32_t HprofClassObjectId;
 
+// Destination of the serialized hprof data. Errors are sticky: once a write has failed, later
+// output is dropped and Ok() returns false.
+class HprofSink {
+ public:
+  HprofSink() : bytes_written_(0), ok_(true) {}
+  virtual ~HprofSink() {}
+
+  bool Write(const void* data, size_t length) {
+    if (ok_) {
+      ok_ = WriteData(reinterpret_cast<const uint8_t*>(data), length);
+      if (ok_) {
+        bytes_written_ += length;
+      }
+    }
+    return ok_;
+  }
+
+  // Writes out any buffered data.
+  virtual bool Finish() {
+    return ok_;
+  }
+
+  // Called once the header and the body of a record of "length" bytes have been written.
+  virtual void RecordWritten(uint32_t length) {
+    UNUSED(length);
+  }
+
+  bool Ok() const {
+    return ok_;
+  }
+
+  // Number of bytes of hprof data written, before any compression.
+  size_t BytesWritten() const {
+    return bytes_written_;
+  }
+
+ protected:
+  virtual bool WriteData(const uint8_t* data, size_t length) = 0;
+
+  size_t bytes_written_;
+  bool ok_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HprofSink);
+};
+
+// Drops the data. Used by the pass that collects the strings and classes, which can also
+// record the lengths of the records it would have written.
+class NullSink FINAL : public HprofSink {
+ public:
+  explicit NullSink(std::vector<uint32_t>* record_lengths) : record_lengths_(record_lengths) {}
+
+  void RecordWritten(uint32_t length) OVERRIDE {
+    if (record_lengths_ != nullptr) {
+      record_lengths_->push_back(length);
+    }
+  }
+
+ protected:
+  bool WriteData(const uint8_t* data, size_t length) OVERRIDE {
+    UNUSED(data);
+    UNUSED(length);
+    return true;
+  }
+
+ private:
+  std::vector<uint32_t>* const record_lengths_;
+
+  DISALLOW_COPY_AND_ASSIGN(NullSink);
+};
+
+// Keeps the data in memory, for sending it to DDMS in a single chunk.
+class VectorSink FINAL : public HprofSink {
+ public:
+  VectorSink() {}
+
+  const std::vector<uint8_t>& GetData() const {
+    return data_;
+  }
+
+ protected:
+  bool WriteData(const uint8_t* data, size_t length) OVERRIDE {
+    data_.insert(data_.end(), data, data + length);
+    return true;
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+
+  DISALLOW_COPY_AND_ASSIGN(VectorSink);
+};
+
+// Streams the data to a file through a fixed size buffer, optionally gzip compressed.
+class FileSink FINAL : public HprofSink {
+ public:
+  static constexpr size_t kBufferSize = 64 * KB;
+
+  FileSink(File* file, bool compress)
+      : file_(file),
+        compress_(compress),
+        buffer_(new uint8_t[kBufferSize]),
+        buffer_used_(0),
+        file_bytes_(0) {
+    if (compress_) {
+      compressed_buffer_.reset(new uint8_t[kBufferSize]);
+      memset(&zstream_, 0, sizeof(zstream_));
+      // Favor speed, the process is suspended while we dump. The window bits select a gzip
+      // wrapper so that standard tools can decompress the file.
+      static constexpr int kGzipWindowBits = 15 + 16;
+      ok_ = (deflateInit2(&zstream_, Z_BEST_SPEED, Z_DEFLATED, kGzipWindowBits, 8,
+                          Z_DEFAULT_STRATEGY) == Z_OK);
+    }
+  }
+
+  ~FileSink() {
+    if (compress_) {
+      deflateEnd(&zstream_);
+    }
+  }
+
+  bool Finish() OVERRIDE {
+    if (ok_) {
+      ok_ = FlushBuffer(true);
+    }
+    return ok_;
+  }
+
+  // Number of bytes written to the file, after any compression.
+  size_t FileBytes() const {
+    return file_bytes_;
+  }
+
+ protected:
+  bool WriteData(const uint8_t* data, size_t length) OVERRIDE {
+    while (length != 0) {
+      size_t chunk = std::min(length, kBufferSize - buffer_used_);
+      memcpy(buffer_.get() + buffer_used_, data, chunk);
+      buffer_used_ += chunk;
+      data += chunk;
+      length -= chunk;
+      if (buffer_used_ == kBufferSize && !FlushBuffer(false)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  bool FlushBuffer(bool finish) {
+    if (!compress_) {
+      if (!file_->WriteFully(buffer_.get(), buffer_used_)) {
+        return false;
+      }
+      file_bytes_ += buffer_used_;
+      buffer_used_ = 0;
+      return true;
+    }
+    zstream_.next_in = buffer_.get();
+    zstream_.avail_in = buffer_used_;
+    do {
+      zstream_.next_out = compressed_buffer_.get();
+      zstream_.avail_out = kBufferSize;
+      if (deflate(&zstream_, finish ? Z_FINISH : Z_NO_FLUSH) == Z_STREAM_ERROR) {
+        return false;
+      }
+      size_t produced = kBufferSize - zstream_.avail_out;
+      if (!file_->WriteFully(compressed_buffer_.get(), produced)) {
+        return false;
+      }
+      file_bytes_ += produced;
+    } while (zstream_.avail_out == 0);
+    DCHECK_EQ(zstream_.avail_in, 0u);
+    buffer_used_ = 0;
+    return true;
+  }
+
+  File* const file_;
+  const bool compress_;
+  std::unique_ptr<uint8_t[]> buffer_;
+  size_t buffer_used_;
+  std::unique_ptr<uint8_t[]> compressed_buffer_;
+  z_stream zstream_;
+  size_t file_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileSink);
+};
+
+constexpr size_t FileSink::kBufferSize;
+
 // Represents a top-level hprof record, whose serialized format is:
 // U1  TAG: denoting the type of the record
 // U4  TIME: number of microseconds since the time stamp in the header
@@ -177,7 +367,9 @@ typedef uint32_t HprofClassObjectId;
 // U1* BODY: as many bytes as specified in the above uint32_t field
 class HprofRecord {
  public:
-  HprofRecord() : alloc_length_(128), fp_(nullptr), tag_(0), time_(0), length_(0), dirty_(false) {
+  HprofRecord()
+      : alloc_length_(kInitialLength), sink_(nullptr), tag_(0), time_(0), length_(0),
+        dirty_(false) {
     body_ = reinterpret_cast<unsigned char*>(malloc(alloc_length_));
   }
 
@@ -185,13 +377,13 @@ class HprofRecord {
     free(body_);
   }
 
-  int StartNewRecord(FILE* fp, uint8_t tag, uint32_t time) {
+  int StartNewRecord(HprofSink* sink, uint8_t tag, uint32_t time) {
     int rc = Flush();
     if (rc != 0) {
       return rc;
     }
 
-    fp_ = fp;
+    sink_ = sink;
     tag_ = tag;
     time_ = time;
     length_ = 0;
@@ -207,18 +399,20 @@ class HprofRecord {
       U4_TO_BUF_BE(headBuf, 1, time_);
       U4_TO_BUF_BE(headBuf, 5, length_);
 
-      int nb = fwrite(headBuf, 1, sizeof(headBuf), fp_);
-      if (nb != sizeof(headBuf)) {
+      dirty_ = false;
+      if (!sink_->Write(headBuf, sizeof(headBuf)) || !sink_->Write(body_, length_)) {
         return UNIQUE_ERROR;
       }
-      nb = fwrite(body_, 1, length_, fp_);
-      if (nb != static_cast<int>(length_)) {
-        return UNIQUE_ERROR;
+      sink_->RecordWritten(length_);
+    }
+    // Don't hold on to the buffer of an unusually large record, e.g. a big primitive array.
+    if (alloc_length_ > kMaxRetainedLength) {
+      unsigned char* newBody = (unsigned char*)realloc(body_, kInitialLength);
+      if (newBody != NULL) {
+        body_ = newBody;
+        alloc_length_ = kInitialLength;
       }
-
-      dirty_ = false;
     }
-    // TODO if we used less than half (or whatever) of allocLen, shrink the buffer.
     return 0;
   }
 
@@ -347,6 +541,9 @@ class HprofRecord {
   }
 
  private:
+  static constexpr size_t kInitialLength = 128;
+  static constexpr size_t kMaxRetainedLength = 64 * KB;
+
   int GuaranteeRecordAppend(size_t nmore) {
     size_t minSize = length_ + nmore;
     if (minSize > alloc_length_) {
@@ -371,7 +568,7 @@ class HprofRecord {
   size_t alloc_length_;
   unsigned char* body_;
 
-  FILE* fp_;
+  HprofSink* sink_;
   uint8_t tag_;
   uint32_t time_;
   size_t length_;
@@ -382,81 +579,45 @@ class HprofRecord {
 
 class Hprof {
  public:
-  Hprof(const char* output_filename, int fd, bool direct_to_ddms)
+  Hprof(const char* output_filename, int fd, bool direct_to_ddms, bool compress)
       : filename_(output_filename),
         fd_(fd),
         direct_to_ddms_(direct_to_ddms),
+        compress_(compress),
         start_ns_(NanoTime()),
         current_record_(),
         gc_thread_serial_number_(0),
         gc_scan_state_(0),
         current_heap_(HPROF_HEAP_DEFAULT),
         objects_in_segment_(0),
-        header_fp_(NULL),
-        header_data_ptr_(NULL),
-        header_data_size_(0),
-        body_fp_(NULL),
-        body_data_ptr_(NULL),
-        body_data_size_(0),
+        body_sink_(nullptr),
+        heap_record_lengths_(nullptr),
         next_string_id_(0x400000) {
     LOG(INFO) << "hprof: heap dump \"" << filename_ << "\" starting...";
-
-    header_fp_ = open_memstream(&header_data_ptr_, &header_data_size_);
-    if (header_fp_ == NULL) {
-      PLOG(FATAL) << "header open_memstream failed";
-    }
-
-    body_fp_ = open_memstream(&body_data_ptr_, &body_data_size_);
-    if (body_fp_ == NULL) {
-      PLOG(FATAL) << "body open_memstream failed";
-    }
   }
 
-  ~Hprof() {
-    if (header_fp_ != NULL) {
-      fclose(header_fp_);
-    }
-    if (body_fp_ != NULL) {
-      fclose(body_fp_);
-    }
-    free(header_data_ptr_);
-    free(body_data_ptr_);
+  // Makes the first pass record the lengths of the heap dump records in "lengths".
+  void SetHeapRecordLengths(std::vector<uint32_t>* lengths) {
+    heap_record_lengths_ = lengths;
   }
 
   void Dump()
       EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_)
       LOCKS_EXCLUDED(Locks::heap_bitmap_lock_) {
-    // Walk the roots and the heap.
-    current_record_.StartNewRecord(body_fp_, HPROF_TAG_HEAP_DUMP_SEGMENT, HPROF_TIME);
-    Runtime::Current()->VisitRoots(RootVisitor, this);
-    Thread* self = Thread::Current();
+    // First pass: discover the strings and classes that the heap records refer to.
     {
-      ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
-      Runtime::Current()->GetHeap()->VisitObjects(VisitObjectCallback, this);
+      NullSink null_sink(heap_record_lengths_);
+      ProcessHeap(&null_sink);
     }
-    current_record_.StartNewRecord(body_fp_, HPROF_TAG_HEAP_DUMP_END, HPROF_TIME);
-    current_record_.Flush();
-    fflush(body_fp_);
-
-    // Write the header.
-    WriteFixedHeader();
-    // Write the string and class tables, and any stack traces, to the header.
-    // (jhat requires that these appear before any of the data in the body that refers to them.)
-    WriteStringTable();
-    WriteClassTable();
-    WriteStackTraces();
-    current_record_.Flush();
-    fflush(header_fp_);
 
     bool okay = true;
+    size_t size = 0;
     if (direct_to_ddms_) {
-      // Send the data off to DDMS.
-      iovec iov[2];
-      iov[0].iov_base = header_data_ptr_;
-      iov[0].iov_len = header_data_size_;
-      iov[1].iov_base = body_data_ptr_;
-      iov[1].iov_len = body_data_size_;
-      Dbg::DdmSendChunkV(CHUNK_TYPE("HPDS"), iov, 2);
+      // DDMS takes the dump as a single chunk, so it has to be assembled in memory.
+      VectorSink sink;
+      ProcessHeaderAndHeap(&sink);
+      Dbg::DdmSendChunk(CHUNK_TYPE("HPDS"), sink.GetData());
+      size = sink.BytesWritten();
     } else {
       // Where exactly are we writing to?
       int out_fd;
@@ -476,8 +637,10 @@ class Hprof {
       }
 
       std::unique_ptr<File> file(new File(out_fd, filename_));
-      okay = file->WriteFully(header_data_ptr_, header_data_size_) &&
-          file->WriteFully(body_data_ptr_, body_data_size_);
+      FileSink sink(file.get(), compress_);
+      ProcessHeaderAndHeap(&sink);
+      okay = sink.Finish();
+      size = sink.FileBytes();
       if (!okay) {
         std::string msg(StringPrintf("Couldn't dump heap; writing \"%s\" failed: %s",
                                      filename_.c_str(), strerror(errno)));
@@ -490,7 +653,7 @@ class Hprof {
     if (okay) {
       uint64_t duration = NanoTime() - start_ns_;
       LOG(INFO) << "hprof: heap dump completed ("
-          << PrettySize(header_data_size_ + body_data_size_ + 1023)
+          << PrettySize(size + 1023)
           << ") in " << PrettyDuration(duration);
     }
   }
@@ -516,17 +679,55 @@ class Hprof {
 
   int DumpHeapObject(mirror::Object* obj) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
-  void Finish() {
+  // Walks the roots and the heap, writing the heap dump records to "sink".
+  void ProcessHeap(HprofSink* sink)
+      EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_)
+      LOCKS_EXCLUDED(Locks::heap_bitmap_lock_) {
+    body_sink_ = sink;
+    current_heap_ = HPROF_HEAP_DEFAULT;
+    objects_in_segment_ = 0;
+    current_record_.StartNewRecord(sink, HPROF_TAG_HEAP_DUMP_SEGMENT, HPROF_TIME);
+    Runtime::Current()->VisitRoots(RootVisitor, this);
+    Thread* self = Thread::Current();
+    {
+      ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
+      Runtime::Current()->GetHeap()->VisitObjects(VisitObjectCallback, this);
+    }
+    current_record_.StartNewRecord(sink, HPROF_TAG_HEAP_DUMP_END, HPROF_TIME);
+    current_record_.Flush();
+    body_sink_ = nullptr;
   }
 
-  int WriteClassTable() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+  // Writes the complete dump, the heap having been walked once already to collect the
+  // strings and classes.
+  void ProcessHeaderAndHeap(HprofSink* sink)
+      EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_)
+      LOCKS_EXCLUDED(Locks::heap_bitmap_lock_) {
+    // Write the header.
+    WriteFixedHeader(sink);
+    // Write the string and class tables, and any stack traces, to the header.
+    // (jhat requires that these appear before any of the data in the body that refers to them.)
+    WriteStringTable(sink);
+    WriteClassTable(sink);
+    WriteStackTraces(sink);
+    current_record_.Flush();
+
+    size_t num_strings = strings_.size();
+    size_t num_classes = classes_.size();
+    ProcessHeap(sink);
+    // The world is stopped, so the second walk cannot discover anything new.
+    DCHECK_EQ(num_strings, strings_.size());
+    DCHECK_EQ(num_classes, classes_.size());
+  }
+
+  int WriteClassTable(HprofSink* sink) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
     HprofRecord* rec = &current_record_;
     uint32_t nextSerialNumber = 1;
 
     for (mirror::Class* c : classes_) {
       CHECK(c != nullptr);
 
-      int err = current_record_.StartNewRecord(header_fp_, HPROF_TAG_LOAD_CLASS, HPROF_TIME);
+      int err = current_record_.StartNewRecord(sink, HPROF_TAG_LOAD_CLASS, HPROF_TIME);
       if (UNLIKELY(err != 0)) {
         return err;
       }
@@ -545,14 +746,14 @@ class Hprof {
     return 0;
   }
 
-  int WriteStringTable() {
+  int WriteStringTable(HprofSink* sink) {
     HprofRecord* rec = &current_record_;
 
     for (std::pair<std::string, HprofStringId> p : strings_) {
       const std::string& string = p.first;
       size_t id = p.second;
 
-      int err = current_record_.StartNewRecord(header_fp_, HPROF_TAG_STRING, HPROF_TIME);
+      int err = current_record_.StartNewRecord(sink, HPROF_TAG_STRING, HPROF_TIME);
       if (err != 0) {
         return err;
       }
@@ -576,7 +777,7 @@ class Hprof {
 
   void StartNewHeapDumpSegment() {
     // This flushes the old segment and starts a new one.
-    current_record_.StartNewRecord(body_fp_, HPROF_TAG_HEAP_DUMP_SEGMENT, HPROF_TIME);
+    current_record_.StartNewRecord(body_sink_, HPROF_TAG_HEAP_DUMP_SEGMENT, HPROF_TIME);
     objects_in_segment_ = 0;
 
     // Starting a new HEAP_DUMP resets the heap to default.
@@ -626,13 +827,13 @@ class Hprof {
     return LookupStringId(PrettyDescriptor(c));
   }
 
-  void WriteFixedHeader() {
+  void WriteFixedHeader(HprofSink* sink) {
     char magic[] = "JAVA PROFILE 1.0.3";
     unsigned char buf[4];
 
     // Write the file header.
     // U1: NUL-terminated magic string.
-    fwrite(magic, 1, sizeof(magic), header_fp_);
+    sink->Write(magic, sizeof(magic));
 
     // U4: size of identifiers.  We're using addresses as IDs and our heap references are stored
     // as uint32_t.
@@ -640,7 +841,7 @@ class Hprof {
     COMPILE_ASSERT(sizeof(mirror::HeapReference<mirror::Object>) == sizeof(uint32_t),
       UnexpectedHeapReferenceSize);
     U4_TO_BUF_BE(buf, 0, sizeof(uint32_t));
-    fwrite(buf, 1, sizeof(uint32_t), header_fp_);
+    sink->Write(buf, sizeof(uint32_t));
 
     // The current time, in milliseconds since 0:00 GMT, 1/1/70.
     timeval now;
@@ -653,16 +854,16 @@ class Hprof {
 
     // U4: high word of the 64-bit time.
     U4_TO_BUF_BE(buf, 0, (uint32_t)(nowMs >> 32));
-    fwrite(buf, 1, sizeof(uint32_t), header_fp_);
+    sink->Write(buf, sizeof(uint32_t));
 
     // U4: low word of the 64-bit time.
     U4_TO_BUF_BE(buf, 0, (uint32_t)(nowMs & 0xffffffffULL));
-    fwrite(buf, 1, sizeof(uint32_t), header_fp_);  // xxx fix the time
+    sink->Write(buf, sizeof(uint32_t));  // xxx fix the time
   }
 
-  void WriteStackTraces() {
+  void WriteStackTraces(HprofSink* sink) {
     // Write a dummy stack trace record so the analysis tools don't freak out.
-    current_record_.StartNewRecord(header_fp_, HPROF_TAG_STACK_TRACE, HPROF_TIME);
+    current_record_.StartNewRecord(sink, HPROF_TAG_STACK_TRACE, HPROF_TIME);
     current_record_.AddU4(HPROF_NULL_STACK_TRACE);
     current_record_.AddU4(HPROF_NULL_THREAD);
     current_record_.AddU4(0);    // no frames
@@ -674,6 +875,8 @@ class Hprof {
   std::string filename_;
   int fd_;
   bool direct_to_ddms_;
+  // Whether the file output is gzip compressed.
+  bool compress_;
 
   uint64_t start_ns_;
 
@@ -684,13 +887,10 @@ class Hprof {
   HprofHeapId current_heap_;  // Which heap we're currently dumping.
   size_t objects_in_segment_;
 
-  FILE* header_fp_;
-  char* header_data_ptr_;
-  size_t header_data_size_;
-
-  FILE* body_fp_;
-  char* body_data_ptr_;
-  size_t body_data_size_;
+  // Where the heap records of the current pass go.
+  HprofSink* body_sink_;
+  // If not null, receives the lengths of the heap records measured by the first pass.
+  std::vector<uint32_t>* heap_record_lengths_;
 
   std::set<mirror::Class*> classes_;
   HprofStringId next_string_id_;
@@ -1089,11 +1289,25 @@ void Hprof::VisitRoot(const mirror::Object* obj, uint32_t thread_id, RootType ty
 // sent directly to DDMS.
 // If "fd" is >= 0, the output will be written to that file descriptor.
 // Otherwise, "filename" is used to create an output file.
-void DumpHeap(const char* filename, int fd, bool direct_to_ddms) {
+// If "compress" is true, the output written to the file is gzip compressed.
+void DumpHeap(const char* filename, int fd, bool direct_to_ddms, bool compress) {
+  CHECK(filename != NULL);
+  CHECK(!direct_to_ddms || !compress);
+
+  Runtime::Current()->GetThreadList()->SuspendAll();
+  Hprof hprof(filename, fd, direct_to_ddms, compress);
+  hprof.Dump();
+  Runtime::Current()->GetThreadList()->ResumeAll();
+}
+
+void DumpHeapForTesting(const char* filename, bool compress,
+                        std::vector<uint32_t>* heap_record_lengths) {
   CHECK(filename != NULL);
+  CHECK(heap_record_lengths != nullptr);
 
   Runtime::Current()->GetThreadList()->SuspendAll();
-  Hprof hprof(filename, fd, direct_to_ddms);
+  Hprof hprof(filename, -1, false, compress);
+  hprof.SetHeapRecordLengths(heap_record_lengths);
   hprof.Dump();
   Runtime::Current()->GetThreadList()->ResumeAll();
 }
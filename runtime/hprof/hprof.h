@@ -17,11 +17,20 @@
 #ifndef ART_RUNTIME_HPROF_HPROF_H_
 #define ART_RUNTIME_HPROF_HPROF_H_
 
+#include <stdint.h>
+
+#include <vector>
+
 namespace art {
 
 namespace hprof {
 
-void DumpHeap(const char* filename, int fd, bool direct_to_ddms);
+void DumpHeap(const char* filename, int fd, bool direct_to_ddms, bool compress);
+
+// Dumps the heap to "filename" like DumpHeap. The lengths of the heap dump records, as measured
+// by the first pass over the heap, are appended to "heap_record_lengths".
+void DumpHeapForTesting(const char* filename, bool compress,
+                        std::vector<uint32_t>* heap_record_lengths);
 
 }  // namespace hprof
 
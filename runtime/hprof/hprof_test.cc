@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hprof.h"
+
+#include <string>
+#include <vector>
+
+#include "common_runtime_test.h"
+#include "utils.h"
+#include "zlib.h"
+
+namespace art {
+namespace hprof {
+
+class HprofTest : public CommonRuntimeTest {
+ protected:
+  static constexpr uint8_t kTagHeapDumpSegment = 0x1C;
+  static constexpr uint8_t kTagHeapDumpEnd = 0x2C;
+  // The NUL terminated magic, the identifier size and the time stamp.
+  static constexpr size_t kHeaderSize = sizeof("JAVA PROFILE 1.0.3") + 4 + 8;
+  // The tag, the time and the length of a record.
+  static constexpr size_t kRecordHeaderSize = 1 + 4 + 4;
+
+  static uint32_t ReadU4(const std::string& data, size_t offset) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data()) + offset;
+    return (static_cast<uint32_t>(bytes[0]) << 24) | (bytes[1] << 16) | (bytes[2] << 8) |
+        bytes[3];
+  }
+
+  // Walks the records of the dump in "data", checking that they exactly cover it, and returns
+  // the lengths of the heap dump records.
+  static void GetHeapRecordLengths(const std::string& data, std::vector<uint32_t>* lengths) {
+    ASSERT_GE(data.size(), kHeaderSize);
+    ASSERT_EQ(0, data.compare(0, sizeof("JAVA PROFILE 1.0.3"),
+                              "JAVA PROFILE 1.0.3", sizeof("JAVA PROFILE 1.0.3")));
+    size_t offset = kHeaderSize;
+    while (offset != data.size()) {
+      ASSERT_LE(offset + kRecordHeaderSize, data.size());
+      uint8_t tag = data[offset];
+      uint32_t length = ReadU4(data, offset + 5);
+      offset += kRecordHeaderSize;
+      ASSERT_LE(offset + length, data.size());
+      offset += length;
+      if (tag == kTagHeapDumpSegment || tag == kTagHeapDumpEnd) {
+        lengths->push_back(length);
+      }
+    }
+  }
+
+  static bool Gunzip(const std::string& filename, std::string* result) {
+    gzFile file = gzopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+      return false;
+    }
+    char buf[8 * KB];
+    int n;
+    while ((n = gzread(file, buf, sizeof(buf))) > 0) {
+      result->append(buf, n);
+    }
+    return gzclose(file) == Z_OK && n == 0;
+  }
+};
+
+constexpr size_t HprofTest::kHeaderSize;
+
+TEST_F(HprofTest, DumpHeap) {
+  ScratchFile plain_file;
+  std::vector<uint32_t> plain_pass1_lengths;
+  DumpHeapForTesting(plain_file.GetFilename().c_str(), false, &plain_pass1_lengths);
+  std::string plain;
+  ASSERT_TRUE(ReadFileToString(plain_file.GetFilename(), &plain));
+  std::vector<uint32_t> plain_lengths;
+  ASSERT_NO_FATAL_FAILURE(GetHeapRecordLengths(plain, &plain_lengths));
+  // At least one segment and the end record.
+  ASSERT_GE(plain_lengths.size(), 2U);
+  EXPECT_EQ(0U, plain_lengths.back());
+  EXPECT_EQ(plain_pass1_lengths, plain_lengths);
+
+  ScratchFile gzip_file;
+  std::vector<uint32_t> gzip_pass1_lengths;
+  DumpHeapForTesting(gzip_file.GetFilename().c_str(), true, &gzip_pass1_lengths);
+  std::string compressed;
+  ASSERT_TRUE(ReadFileToString(gzip_file.GetFilename(), &compressed));
+  // gzread() also reads uncompressed files, so check for the gzip magic.
+  ASSERT_GE(compressed.size(), 2U);
+  EXPECT_EQ(0x1f, static_cast<uint8_t>(compressed[0]));
+  EXPECT_EQ(0x8b, static_cast<uint8_t>(compressed[1]));
+  std::string gzip;
+  ASSERT_TRUE(Gunzip(gzip_file.GetFilename(), &gzip));
+  std::vector<uint32_t> gzip_lengths;
+  ASSERT_NO_FATAL_FAILURE(GetHeapRecordLengths(gzip, &gzip_lengths));
+  EXPECT_EQ(gzip_pass1_lengths, gzip_lengths);
+}
+
+}  // namespace hprof
+}  // namespace art
@@ -111,6 +111,7 @@ class PACKED(4) ImageHeader {
     kRefsAndArgsSaveMethod,
     kDexCaches,
     kClassRoots,
+    kInternTable,
     kImageRootsMax,
   };
 
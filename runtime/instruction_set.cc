@@ -126,6 +126,12 @@ std::string InstructionSetFeatures::GetFeatureString() const {
   if ((mask_ & kHwDiv) != 0) {
     result += "div";
   }
+  if ((mask_ & kHwSse4_1) != 0) {
+    if (!result.empty()) {
+      result += ",";
+    }
+    result += "sse4.1";
+  }
   if (result.size() == 0) {
     result = "none";
   }
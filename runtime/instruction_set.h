@@ -174,6 +174,7 @@ size_t GetStackOverflowReservedBytes(InstructionSet isa);
 enum InstructionFeatures {
   kHwDiv  = 0x1,              // Supports hardware divide.
   kHwLpae = 0x2,              // Supports Large Physical Address Extension.
+  kHwSse4_1 = 0x4,            // Supports SSE4.1 (x86 and x86-64).
 };
 
 // This is a bitmask of supported features per architecture.
@@ -200,6 +201,14 @@ class PACKED(4) InstructionSetFeatures {
     mask_ = (mask_ & ~kHwLpae) | (v ? kHwLpae : 0);
   }
 
+  bool HasSse4_1() const {
+    return (mask_ & kHwSse4_1) != 0;
+  }
+
+  void SetHasSse4_1(bool v) {
+    mask_ = (mask_ & ~kHwSse4_1) | (v ? kHwSse4_1 : 0);
+  }
+
   std::string GetFeatureString() const;
 
   // Other features in here.
@@ -16,51 +16,150 @@
 
 #include "intern_table.h"
 
+#include <algorithm>
 #include <memory>
 
-#include "gc/space/image_space.h"
-#include "mirror/dex_cache.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/string.h"
+#include "root_hash_table-inl.h"
 #include "thread.h"
 #include "utf.h"
+#include "utils.h"
 
 namespace art {
 
+// Matches the interned string equal to s.
+class StringEquals {
+ public:
+  explicit StringEquals(mirror::String* s) : s_(s) {}
+
+  bool operator()(mirror::String* existing) const SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    return existing->Equals(s_);
+  }
+
+ private:
+  mirror::String* const s_;
+};
+
+// Matches the string s itself.
+class SameString {
+ public:
+  explicit SameString(mirror::String* s) : s_(s) {}
+
+  bool operator()(mirror::String* existing) const {
+    return existing == s_;
+  }
+
+ private:
+  mirror::String* const s_;
+};
+
+// The probe sequences start at the unsigned hash code, its top bits select the shard.
+static size_t ShardHash(int32_t hash_code) {
+  return static_cast<uint32_t>(hash_code);
+}
+
+InternTable::Table::Table(bool lock_free_reads) {
+  for (std::unique_ptr<Shard>& shard : shards_) {
+    shard.reset(new Shard(kMinShardCapacity, lock_free_reads));
+  }
+}
+
+mirror::String* InternTable::Table::Find(mirror::String* s, int32_t hash_code) {
+  return GetShard(hash_code)->Find(ShardHash(hash_code), StringEquals(s));
+}
+
+void InternTable::Table::Insert(mirror::String* s, int32_t hash_code) {
+  GetShard(hash_code)->Insert(s, ShardHash(hash_code));
+}
+
+void InternTable::Table::Remove(mirror::String* s, int32_t hash_code) {
+  GetShard(hash_code)->Remove(ShardHash(hash_code), SameString(s));
+}
+
+void InternTable::Table::UpdateMovedRoot(int32_t hash_code, mirror::String* old_ref,
+                                         mirror::String* new_ref) {
+  GetShard(hash_code)->UpdateMovedRoot(ShardHash(hash_code), old_ref, new_ref);
+}
+
+void InternTable::Table::VisitRoots(RootCallback* callback, void* arg) {
+  for (std::unique_ptr<Shard>& shard : shards_) {
+    shard->VisitRoots(callback, arg, kRootInternedString);
+  }
+}
+
+void InternTable::Table::SweepWeaks(IsMarkedCallback* callback, void* arg) {
+  for (std::unique_ptr<Shard>& shard : shards_) {
+    shard->SweepWeaks(callback, arg);
+  }
+}
+
+void InternTable::Table::FreeRetiredArrays(Thread* self) {
+  for (std::unique_ptr<Shard>& shard : shards_) {
+    shard->FreeRetiredArrays(self);
+  }
+}
+
+static bool AddString(mirror::String* s, void* arg) {
+  reinterpret_cast<std::vector<mirror::String*>*>(arg)->push_back(s);
+  return true;
+}
+
+void InternTable::Table::GetStrings(std::vector<mirror::String*>* strings) {
+  for (std::unique_ptr<Shard>& shard : shards_) {
+    shard->Visit(AddString, strings);
+  }
+}
+
+size_t InternTable::Table::Size() const {
+  size_t size = 0;
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    size += shard->Size();
+  }
+  return size;
+}
+
 InternTable::InternTable()
     : log_new_roots_(false), allow_new_interns_(true),
-      new_intern_condition_("New intern condition", *Locks::intern_table_lock_) {
+      new_intern_condition_("New intern condition", *Locks::intern_table_lock_),
+      image_strings_(nullptr), strong_interns_(true), weak_interns_(false) {
 }
 
 size_t InternTable::Size() const {
   MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return strong_interns_.size() + weak_interns_.size();
+  return strong_interns_.Size() + weak_interns_.Size();
 }
 
 size_t InternTable::StrongSize() const {
   MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return strong_interns_.size();
+  return strong_interns_.Size();
 }
 
 size_t InternTable::WeakSize() const {
   MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return weak_interns_.size();
+  return weak_interns_.Size();
 }
 
 void InternTable::DumpForSigQuit(std::ostream& os) const {
   MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  os << "Intern table: " << strong_interns_.size() << " strong; "
-     << weak_interns_.size() << " weak\n";
+  os << "Intern table: " << strong_interns_.Size() << " strong; "
+     << weak_interns_.Size() << " weak";
+  if (image_strings_ != nullptr) {
+    os << "; " << image_strings_->GetLength() << " image slots";
+  }
+  os << "\n";
 }
 
 void InternTable::VisitRoots(RootCallback* callback, void* arg, VisitRootFlags flags) {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
+  Thread* self = Thread::Current();
+  MutexLock mu(self, *Locks::intern_table_lock_);
+  if (Locks::mutator_lock_->IsExclusiveHeld(self)) {
+    // Lock free lookups cannot run during a pause.
+    strong_interns_.FreeRetiredArrays(self);
+  }
   if ((flags & kVisitRootFlagAllRoots) != 0) {
-    for (auto& strong_intern : strong_interns_) {
-      strong_intern.second.VisitRoot(callback, arg, 0, kRootInternedString);
-      DCHECK(!strong_intern.second.IsNull());
-    }
+    strong_interns_.VisitRoots(callback, arg);
   } else if ((flags & kVisitRootFlagNewRoots) != 0) {
     for (auto& pair : new_strong_intern_roots_) {
       mirror::String* old_ref = pair.second.Read<kWithoutReadBarrier>();
@@ -70,13 +169,7 @@ void InternTable::VisitRoots(RootCallback* callback, void* arg, VisitRootFlags f
         // Uh ohes, GC moved a root in the log. Need to search the strong interns and update the
         // corresponding object. This is slow, but luckily for us, this may only happen with a
         // concurrent moving GC.
-        for (auto it = strong_interns_.lower_bound(pair.first), end = strong_interns_.end();
-             it != end && it->first == pair.first; ++it) {
-          // If the class stored matches the old class, update it to the new value.
-          if (old_ref == it->second.Read<kWithoutReadBarrier>()) {
-            it->second = GcRoot<mirror::String>(new_ref);
-          }
-        }
+        strong_interns_.UpdateMovedRoot(pair.first, old_ref, new_ref);
       }
     }
   }
@@ -93,24 +186,40 @@ void InternTable::VisitRoots(RootCallback* callback, void* arg, VisitRootFlags f
 }
 
 mirror::String* InternTable::LookupStrong(mirror::String* s, int32_t hash_code) {
-  return Lookup(&strong_interns_, s, hash_code);
+  Locks::intern_table_lock_->AssertHeld(Thread::Current());
+  return strong_interns_.Find(s, hash_code);
 }
 
 mirror::String* InternTable::LookupWeak(mirror::String* s, int32_t hash_code) {
+  Locks::intern_table_lock_->AssertHeld(Thread::Current());
   // Weak interns need a read barrier because they are weak roots.
-  return Lookup(&weak_interns_, s, hash_code);
+  return weak_interns_.Find(s, hash_code);
 }
 
-mirror::String* InternTable::Lookup(Table* table, mirror::String* s, int32_t hash_code) {
-  Locks::intern_table_lock_->AssertHeld(Thread::Current());
-  for (auto it = table->lower_bound(hash_code), end = table->end();
-       it != end && it->first == hash_code; ++it) {
-    mirror::String* existing_string = it->second.Read();
-    if (existing_string->Equals(s)) {
-      return existing_string;
+mirror::String* InternTable::LookupImage(mirror::String* s, int32_t hash_code) {
+  mirror::ObjectArray<mirror::String>* image_strings = image_strings_;
+  if (image_strings == nullptr) {
+    return nullptr;
+  }
+  // Same layout as BuildImageTable, the image table is never full.
+  const size_t mask = image_strings->GetLength() - 1;
+  for (size_t i = hash_code; ; ++i) {
+    mirror::String* image_string = image_strings->GetWithoutChecks(i & mask);
+    if (image_string == nullptr) {
+      return nullptr;
+    }
+    if (image_string->GetHashCode() == hash_code && image_string->Equals(s)) {
+      return image_string;
     }
   }
-  return NULL;
+}
+
+mirror::String* InternTable::LookupStrongLockFree(mirror::String* s, int32_t hash_code) {
+  mirror::String* image_string = LookupImage(s, hash_code);
+  if (image_string != nullptr) {
+    return image_string;
+  }
+  return strong_interns_.Find(s, hash_code);
 }
 
 mirror::String* InternTable::InsertStrong(mirror::String* s, int32_t hash_code) {
@@ -121,7 +230,7 @@ mirror::String* InternTable::InsertStrong(mirror::String* s, int32_t hash_code)
   if (log_new_roots_) {
     new_strong_intern_roots_.push_back(std::make_pair(hash_code, GcRoot<mirror::String>(s)));
   }
-  strong_interns_.insert(std::make_pair(hash_code, GcRoot<mirror::String>(s)));
+  strong_interns_.Insert(s, hash_code);
   return s;
 }
 
@@ -130,12 +239,12 @@ mirror::String* InternTable::InsertWeak(mirror::String* s, int32_t hash_code) {
   if (runtime->IsActiveTransaction()) {
     runtime->RecordWeakStringInsertion(s, hash_code);
   }
-  weak_interns_.insert(std::make_pair(hash_code, GcRoot<mirror::String>(s)));
+  weak_interns_.Insert(s, hash_code);
   return s;
 }
 
 void InternTable::RemoveStrong(mirror::String* s, int32_t hash_code) {
-  Remove(&strong_interns_, s, hash_code);
+  strong_interns_.Remove(s, hash_code);
 }
 
 void InternTable::RemoveWeak(mirror::String* s, int32_t hash_code) {
@@ -143,18 +252,7 @@ void InternTable::RemoveWeak(mirror::String* s, int32_t hash_code) {
   if (runtime->IsActiveTransaction()) {
     runtime->RecordWeakStringRemoval(s, hash_code);
   }
-  Remove(&weak_interns_, s, hash_code);
-}
-
-void InternTable::Remove(Table* table, mirror::String* s, int32_t hash_code) {
-  for (auto it = table->lower_bound(hash_code), end = table->end();
-       it != end && it->first == hash_code; ++it) {
-    mirror::String* existing_string = it->second.Read();
-    if (existing_string == s) {
-      table->erase(it);
-      return;
-    }
-  }
+  weak_interns_.Remove(s, hash_code);
 }
 
 // Insert/remove methods used to undo changes made during an aborted transaction.
@@ -175,29 +273,34 @@ void InternTable::RemoveWeakFromTransaction(mirror::String* s, int32_t hash_code
   RemoveWeak(s, hash_code);
 }
 
-static mirror::String* LookupStringFromImage(mirror::String* s)
-    SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
-  gc::space::ImageSpace* image = Runtime::Current()->GetHeap()->GetImageSpace();
-  if (image == NULL) {
-    return NULL;  // No image present.
-  }
-  mirror::Object* root = image->GetImageHeader().GetImageRoot(ImageHeader::kDexCaches);
-  mirror::ObjectArray<mirror::DexCache>* dex_caches = root->AsObjectArray<mirror::DexCache>();
-  const std::string utf8 = s->ToModifiedUtf8();
-  for (int32_t i = 0; i < dex_caches->GetLength(); ++i) {
-    mirror::DexCache* dex_cache = dex_caches->Get(i);
-    const DexFile* dex_file = dex_cache->GetDexFile();
-    // Binary search the dex file for the string index.
-    const DexFile::StringId* string_id = dex_file->FindStringId(utf8.c_str());
-    if (string_id != NULL) {
-      uint32_t string_idx = dex_file->GetIndexForStringId(*string_id);
-      mirror::String* image = dex_cache->GetResolvedString(string_idx);
-      if (image != NULL) {
-        return image;
+size_t InternTable::ImageTableCapacity(size_t num_strings) {
+  // Keep the load factor at or below one half so that probe sequences stay short.
+  return RoundUpToPowerOfTwo(std::max<uint32_t>(num_strings * 2, 1));
+}
+
+void InternTable::BuildImageTable(const std::vector<mirror::String*>& strings,
+                                  mirror::ObjectArray<mirror::String>* image_strings) {
+  const size_t capacity = image_strings->GetLength();
+  CHECK(IsPowerOfTwo(capacity)) << capacity;
+  CHECK_LT(strings.size(), capacity);
+  for (mirror::String* s : strings) {
+    for (size_t i = s->GetHashCode(); ; ++i) {
+      if (image_strings->GetWithoutChecks(i & (capacity - 1)) == nullptr) {
+        image_strings->SetWithoutChecks<false>(i & (capacity - 1), s);
+        break;
       }
     }
   }
-  return NULL;
+}
+
+void InternTable::SetImageStrings(mirror::ObjectArray<mirror::String>* image_strings) {
+  CHECK(image_strings == nullptr || IsPowerOfTwo(image_strings->GetLength()));
+  image_strings_ = image_strings;
+}
+
+void InternTable::GetStrongInterns(std::vector<mirror::String*>* strings) {
+  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
+  strong_interns_.GetStrings(strings);
 }
 
 void InternTable::AllowNewInterns() {
@@ -214,29 +317,31 @@ void InternTable::DisallowNewInterns() {
 }
 
 mirror::String* InternTable::Insert(mirror::String* s, bool is_strong) {
-  Thread* self = Thread::Current();
-  MutexLock mu(self, *Locks::intern_table_lock_);
-
   DCHECK(s != NULL);
   uint32_t hash_code = s->GetHashCode();
 
+  // Fast path for strings which are already strongly interned, this doesn't need the lock since
+  // strong interns are never swept.
+  mirror::String* strong = LookupStrongLockFree(s, hash_code);
+  if (strong != NULL) {
+    return strong;
+  }
+
+  Thread* self = Thread::Current();
+  MutexLock mu(self, *Locks::intern_table_lock_);
+
   while (UNLIKELY(!allow_new_interns_)) {
     new_intern_condition_.WaitHoldingLocks(self);
   }
 
-  if (is_strong) {
-    // Check the strong table for a match.
-    mirror::String* strong = LookupStrong(s, hash_code);
-    if (strong != NULL) {
-      return strong;
-    }
-
-    // Check the image for a match.
-    mirror::String* image = LookupStringFromImage(s);
-    if (image != NULL) {
-      return InsertStrong(image, hash_code);
-    }
+  // Check the strong table again, the string may have been interned since we checked. The image
+  // table is read only so there is no need to check it again.
+  strong = LookupStrong(s, hash_code);
+  if (strong != NULL) {
+    return strong;
+  }
 
+  if (is_strong) {
     // There is no match in the strong table, check the weak table.
     mirror::String* weak = LookupWeak(s, hash_code);
     if (weak != NULL) {
@@ -250,16 +355,6 @@ mirror::String* InternTable::Insert(mirror::String* s, bool is_strong) {
     return InsertStrong(s, hash_code);
   }
 
-  // Check the strong table for a match.
-  mirror::String* strong = LookupStrong(s, hash_code);
-  if (strong != NULL) {
-    return strong;
-  }
-  // Check the image for a match.
-  mirror::String* image = LookupStringFromImage(s);
-  if (image != NULL) {
-    return InsertWeak(image, hash_code);
-  }
   // Check the weak table for a match.
   mirror::String* weak = LookupWeak(s, hash_code);
   if (weak != NULL) {
@@ -302,18 +397,7 @@ bool InternTable::ContainsWeak(mirror::String* s) {
 
 void InternTable::SweepInternTableWeaks(IsMarkedCallback* callback, void* arg) {
   MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  for (auto it = weak_interns_.begin(), end = weak_interns_.end(); it != end;) {
-    // This does not need a read barrier because this is called by GC.
-    mirror::Object* object = it->second.Read<kWithoutReadBarrier>();
-    mirror::Object* new_object = callback(object, arg);
-    if (new_object == nullptr) {
-      // TODO: use it = weak_interns_.erase(it) when we get a c++11 stl.
-      weak_interns_.erase(it++);
-    } else {
-      it->second = GcRoot<mirror::String>(down_cast<mirror::String*>(new_object));
-      ++it;
-    }
-  }
+  weak_interns_.SweepWeaks(callback, arg);
 }
 
 }  // namespace art
@@ -17,17 +17,20 @@
 #ifndef ART_RUNTIME_INTERN_TABLE_H_
 #define ART_RUNTIME_INTERN_TABLE_H_
 
-#include <map>
+#include <memory>
+#include <vector>
 
 #include "base/mutex.h"
 #include "gc_root.h"
 #include "object_callbacks.h"
+#include "root_hash_table.h"
 
 namespace art {
 
 enum VisitRootFlags : uint8_t;
 
 namespace mirror {
+template<class T> class ObjectArray;
 class String;
 }  // namespace mirror
 class Transaction;
@@ -41,6 +44,11 @@ class Transaction;
  * String.intern. Some code (XML parsers being a prime example) relies on being able to intern
  * arbitrarily many strings for the duration of a parse without permanently increasing the memory
  * footprint.
+ *
+ * Both tables are sharded open addressing hash sets keyed by String::GetHashCode. Strings which
+ * are already strongly interned are found without taking the intern_table_lock_, interning a new
+ * string or anything involving the weak table still serializes on the lock. The boot image ships
+ * a read only table of its interned strings which is used directly from the mapped image space.
  */
 class InternTable {
  public:
@@ -77,8 +85,66 @@ class InternTable {
   void DisallowNewInterns() EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_);
   void AllowNewInterns() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
+  // Use the pre-built table of the boot image interned strings, see BuildImageTable.
+  void SetImageStrings(mirror::ObjectArray<mirror::String>* image_strings)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Lays out strings as an open addressing table of image_strings->GetLength() slots, which must
+  // be a power of two. Used by the ImageWriter to build the table shipped in the boot image.
+  static void BuildImageTable(const std::vector<mirror::String*>& strings,
+                              mirror::ObjectArray<mirror::String>* image_strings)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Number of slots of the image table for num_strings strings.
+  static size_t ImageTableCapacity(size_t num_strings);
+
+  // Returns all of the strongly interned strings.
+  void GetStrongInterns(std::vector<mirror::String*>* strings)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
  private:
-  typedef std::multimap<int32_t, GcRoot<mirror::String>> Table;
+  // Hash set of strings split into shards by the top bits of the hash code, each shard is a
+  // RootHashTable probed with the low bits. All modifications require the intern_table_lock_. If
+  // lock_free_reads is set, Find may also be called without the lock.
+  class Table {
+   public:
+    explicit Table(bool lock_free_reads);
+
+    mirror::String* Find(mirror::String* s, int32_t hash_code)
+        SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+    void Insert(mirror::String* s, int32_t hash_code)
+        EXCLUSIVE_LOCKS_REQUIRED(Locks::intern_table_lock_)
+        SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+    void Remove(mirror::String* s, int32_t hash_code)
+        EXCLUSIVE_LOCKS_REQUIRED(Locks::intern_table_lock_)
+        SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+    void UpdateMovedRoot(int32_t hash_code, mirror::String* old_ref, mirror::String* new_ref)
+        EXCLUSIVE_LOCKS_REQUIRED(Locks::intern_table_lock_);
+    void VisitRoots(RootCallback* callback, void* arg)
+        EXCLUSIVE_LOCKS_REQUIRED(Locks::intern_table_lock_);
+    void SweepWeaks(IsMarkedCallback* callback, void* arg)
+        EXCLUSIVE_LOCKS_REQUIRED(Locks::intern_table_lock_);
+    void FreeRetiredArrays(Thread* self) EXCLUSIVE_LOCKS_REQUIRED(Locks::intern_table_lock_);
+    void GetStrings(std::vector<mirror::String*>* strings)
+        EXCLUSIVE_LOCKS_REQUIRED(Locks::intern_table_lock_)
+        SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+    size_t Size() const EXCLUSIVE_LOCKS_REQUIRED(Locks::intern_table_lock_);
+
+   private:
+    static constexpr size_t kNumShardBits = 4;
+    static constexpr size_t kNumShards = 1 << kNumShardBits;
+    static constexpr size_t kMinShardCapacity = 256;
+
+    typedef RootHashTable<mirror::String> Shard;
+
+    Shard* GetShard(int32_t hash_code) {
+      return shards_[static_cast<uint32_t>(hash_code) >> (32 - kNumShardBits)].get();
+    }
+
+    std::unique_ptr<Shard> shards_[kNumShards];
+
+    DISALLOW_COPY_AND_ASSIGN(Table);
+  };
 
   mirror::String* Insert(mirror::String* s, bool is_strong)
       LOCKS_EXCLUDED(Locks::intern_table_lock_)
@@ -88,7 +154,10 @@ class InternTable {
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
   mirror::String* LookupWeak(mirror::String* s, int32_t hash_code)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
-  mirror::String* Lookup(Table* table, mirror::String* s, int32_t hash_code)
+  // Lock free lookup of s in the image table and the strong table.
+  mirror::String* LookupStrongLockFree(mirror::String* s, int32_t hash_code)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  mirror::String* LookupImage(mirror::String* s, int32_t hash_code)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
   mirror::String* InsertStrong(mirror::String* s, int32_t hash_code)
       EXCLUSIVE_LOCKS_REQUIRED(Locks::intern_table_lock_);
@@ -100,9 +169,6 @@ class InternTable {
   void RemoveWeak(mirror::String* s, int32_t hash_code)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_)
       EXCLUSIVE_LOCKS_REQUIRED(Locks::intern_table_lock_);
-  void Remove(Table* table, mirror::String* s, int32_t hash_code)
-      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_)
-      EXCLUSIVE_LOCKS_REQUIRED(Locks::intern_table_lock_);
 
   // Transaction rollback access.
   mirror::String* InsertStrongFromTransaction(mirror::String* s, int32_t hash_code)
@@ -120,11 +186,13 @@ class InternTable {
   bool log_new_roots_ GUARDED_BY(Locks::intern_table_lock_);
   bool allow_new_interns_ GUARDED_BY(Locks::intern_table_lock_);
   ConditionVariable new_intern_condition_ GUARDED_BY(Locks::intern_table_lock_);
+  // Read only table of the boot image interned strings, null if there is no image.
+  mirror::ObjectArray<mirror::String>* image_strings_;
   // Since this contains (strong) roots, they need a read barrier to
   // enable concurrent intern table (strong) root scan. Do not
   // directly access the strings in it. Use functions that contain
   // read barriers.
-  Table strong_interns_ GUARDED_BY(Locks::intern_table_lock_);
+  Table strong_interns_;
   std::vector<std::pair<int32_t, GcRoot<mirror::String>>> new_strong_intern_roots_
       GUARDED_BY(Locks::intern_table_lock_);
   // Since this contains (weak) roots, they need a read barrier. Do
@@ -16,9 +16,14 @@
 
 #include "intern_table.h"
 
+#include <vector>
+
+#include "base/stringprintf.h"
+#include "class_linker.h"
 #include "common_runtime_test.h"
 #include "mirror/object.h"
 #include "handle_scope-inl.h"
+#include "mirror/object_array-inl.h"
 #include "mirror/string.h"
 #include "scoped_thread_state_change.h"
 
@@ -182,4 +187,54 @@ TEST_F(InternTableTest, ContainsWeak) {
   }
 }
 
+TEST_F(InternTableTest, ManyStrings) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable t;
+  // Enough strings for every shard to be rebuilt a couple of times.
+  static constexpr size_t kNumStrings = 5000;
+  std::vector<mirror::String*> interned;
+  for (size_t i = 0; i < kNumStrings; ++i) {
+    interned.push_back(t.InternStrong(StringPrintf("string%zu", i).c_str()));
+  }
+  EXPECT_EQ(kNumStrings, t.StrongSize());
+  for (size_t i = 0; i < kNumStrings; ++i) {
+    std::string utf8(StringPrintf("string%zu", i));
+    mirror::String* s = mirror::String::AllocFromModifiedUtf8(soa.Self(), utf8.c_str());
+    ASSERT_TRUE(s != nullptr);
+    EXPECT_EQ(interned[i], t.InternStrong(s)) << utf8;
+  }
+  EXPECT_EQ(kNumStrings, t.StrongSize());
+}
+
+TEST_F(InternTableTest, ImageTable) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<3> hs(soa.Self());
+  Handle<mirror::String> foo(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "foo")));
+  Handle<mirror::String> bar(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "bar")));
+  const size_t capacity = InternTable::ImageTableCapacity(2);
+  EXPECT_GT(capacity, 2U);
+  Handle<mirror::ObjectArray<mirror::String>> image_strings(hs.NewHandle(
+      mirror::ObjectArray<mirror::String>::Alloc(
+          soa.Self(), class_linker_->FindSystemClass(soa.Self(), "[Ljava/lang/String;"),
+          capacity)));
+  ASSERT_TRUE(image_strings.Get() != nullptr);
+  std::vector<mirror::String*> strings;
+  strings.push_back(foo.Get());
+  strings.push_back(bar.Get());
+  InternTable::BuildImageTable(strings, image_strings.Get());
+
+  InternTable t;
+  t.SetImageStrings(image_strings.Get());
+  // Strings in the image table are returned without being added to the runtime tables.
+  EXPECT_EQ(foo.Get(), t.InternStrong(3, "foo"));
+  EXPECT_EQ(bar.Get(), t.InternWeak(mirror::String::AllocFromModifiedUtf8(soa.Self(), "bar")));
+  EXPECT_EQ(0U, t.Size());
+  mirror::String* baz = t.InternStrong(3, "baz");
+  EXPECT_TRUE(baz->Equals("baz"));
+  EXPECT_EQ(1U, t.StrongSize());
+  EXPECT_EQ(baz, t.InternStrong(3, "baz"));
+}
+
 }  // namespace art
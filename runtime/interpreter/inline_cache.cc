@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "inline_cache.h"
+
+#include <algorithm>
+#include <ostream>
+
+#include "binary_profile.h"
+#include "dex_file-inl.h"
+#include "dex_instruction.h"
+#include "mirror/art_method-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "thread.h"
+#include "utils.h"
+
+namespace art {
+namespace interpreter {
+
+constexpr size_t InlineCache::kIndividualCacheSize;
+constexpr size_t InlineCacheTable::kDefaultInitialCapacity;
+
+mirror::ArtMethod* InlineCache::Lookup(mirror::Class* klass) const {
+  for (size_t i = 0; i < kIndividualCacheSize; ++i) {
+    mirror::Class* cached = classes_[i].LoadRelaxed();
+    if (cached == klass) {
+      // Null until the thread that claimed the slot has published the target.
+      return targets_[i].LoadSequentiallyConsistent();
+    }
+    if (cached == nullptr) {
+      break;
+    }
+  }
+  return nullptr;
+}
+
+void InlineCache::Update(mirror::Class* klass, mirror::ArtMethod* target) {
+  DCHECK(klass != nullptr);
+  DCHECK(target != nullptr);
+  if (IsMegamorphic()) {
+    return;
+  }
+  for (size_t i = 0; i < kIndividualCacheSize; ++i) {
+    mirror::Class* cached = classes_[i].LoadRelaxed();
+    if (cached == klass) {
+      return;
+    }
+    if (cached == nullptr) {
+      if (classes_[i].CompareExchangeStrongSequentiallyConsistent(nullptr, klass)) {
+        // The dispatch of a class at a given call site never changes, so racing threads that
+        // saw the same class would publish the same target.
+        targets_[i].StoreRelease(target);
+        return;
+      }
+      // Lost the race for this slot, it may have been claimed for klass.
+      if (classes_[i].LoadRelaxed() == klass) {
+        return;
+      }
+    }
+  }
+  is_megamorphic_.StoreRelaxed(true);
+}
+
+void InlineCache::GetReceiverClasses(std::vector<mirror::Class*>* classes) const {
+  for (size_t i = 0; i < kIndividualCacheSize; ++i) {
+    mirror::Class* cached = classes_[i].LoadRelaxed();
+    if (cached == nullptr) {
+      break;
+    }
+    classes->push_back(cached);
+  }
+}
+
+void InlineCache::VisitRoots(RootCallback* callback, void* arg) {
+  for (size_t i = 0; i < kIndividualCacheSize; ++i) {
+    mirror::Class* cached = classes_[i].LoadRelaxed();
+    if (cached == nullptr) {
+      break;
+    }
+    mirror::Object* root = cached;
+    callback(&root, arg, 0, kRootVMInternal);
+    if (root != cached) {
+      classes_[i].StoreRelaxed(down_cast<mirror::Class*>(root));
+    }
+  }
+}
+
+MethodInlineCaches::MethodInlineCaches(mirror::ArtMethod* method,
+                                       const std::vector<uint32_t>& dex_pcs)
+    : method_(method), num_caches_(dex_pcs.size()), caches_(new InlineCache[dex_pcs.size()]) {
+  for (size_t i = 0; i < num_caches_; ++i) {
+    caches_[i].dex_pc_ = dex_pcs[i];
+  }
+}
+
+MethodInlineCaches* MethodInlineCaches::Create(mirror::ArtMethod* method) {
+  std::vector<uint32_t> dex_pcs;
+  const DexFile::CodeItem* code_item = method->GetCodeItem();
+  if (code_item != nullptr) {
+    const uint16_t* insns = code_item->insns_;
+    for (uint32_t dex_pc = 0; dex_pc < code_item->insns_size_in_code_units_; ) {
+      const Instruction* inst = Instruction::At(insns + dex_pc);
+      switch (inst->Opcode()) {
+        case Instruction::INVOKE_VIRTUAL:
+        case Instruction::INVOKE_VIRTUAL_RANGE:
+        case Instruction::INVOKE_INTERFACE:
+        case Instruction::INVOKE_INTERFACE_RANGE:
+        case Instruction::INVOKE_VIRTUAL_QUICK:
+        case Instruction::INVOKE_VIRTUAL_RANGE_QUICK:
+          dex_pcs.push_back(dex_pc);
+          break;
+        default:
+          break;
+      }
+      dex_pc += inst->SizeInCodeUnits();
+    }
+  }
+  return new MethodInlineCaches(method, dex_pcs);
+}
+
+InlineCache* MethodInlineCaches::Find(uint32_t dex_pc) {
+  InlineCache* begin = caches_.get();
+  InlineCache* end = begin + num_caches_;
+  InlineCache* it = std::lower_bound(begin, end, dex_pc,
+                                     [](const InlineCache& cache, uint32_t pc) {
+                                       return cache.GetDexPc() < pc;
+                                     });
+  return (it != end && it->GetDexPc() == dex_pc) ? it : nullptr;
+}
+
+void MethodInlineCaches::VisitRoots(RootCallback* callback, void* arg) {
+  for (size_t i = 0; i < num_caches_; ++i) {
+    caches_[i].VisitRoots(callback, arg);
+  }
+}
+
+InlineCacheTable::EntryArray::EntryArray(size_t capacity)
+    : mask_(capacity - 1), entries_(new Atomic<MethodInlineCaches*>[capacity]) {
+  for (size_t i = 0; i < capacity; ++i) {
+    entries_[i].StoreRelaxed(nullptr);
+  }
+}
+
+InlineCacheTable::InlineCacheTable(size_t initial_capacity)
+    : entries_(nullptr),
+      num_methods_(0),
+      lock_("Inline cache table lock") {
+  arrays_.emplace_back(new EntryArray(RoundUpToPowerOfTwo(initial_capacity)));
+  entries_.StoreRelaxed(arrays_.back().get());
+}
+
+InlineCacheTable::~InlineCacheTable() {
+  // Every caches object is in the current array, the retired arrays only hold copies.
+  EntryArray* entries = entries_.LoadRelaxed();
+  for (size_t i = 0; i < entries->Capacity(); ++i) {
+    delete entries->Get(i)->LoadRelaxed();
+  }
+}
+
+size_t InlineCacheTable::Hash(mirror::ArtMethod* method) {
+  // ArtMethods are at least 8 byte aligned, drop the low bits before hashing.
+  uintptr_t key = reinterpret_cast<uintptr_t>(method) >> 3;
+  return key * 0x9E3779B1u;
+}
+
+MethodInlineCaches* InlineCacheTable::Get(mirror::ArtMethod* method) const {
+  EntryArray* entries = entries_.LoadSequentiallyConsistent();
+  for (size_t i = Hash(method), probes = 0; probes < entries->Capacity(); ++i, ++probes) {
+    MethodInlineCaches* entry = entries->Get(i)->LoadSequentiallyConsistent();
+    if (entry == nullptr || entry->GetMethod() == method) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+void InlineCacheTable::InsertInto(EntryArray* entries, MethodInlineCaches* caches) {
+  for (size_t i = Hash(caches->GetMethod()); ; ++i) {
+    Atomic<MethodInlineCaches*>* entry = entries->Get(i);
+    if (entry->LoadRelaxed() == nullptr) {
+      // Publish the fully constructed caches to lock free readers.
+      entry->StoreSequentiallyConsistent(caches);
+      return;
+    }
+  }
+}
+
+void InlineCacheTable::Grow() {
+  EntryArray* old_entries = entries_.LoadRelaxed();
+  EntryArray* new_entries = new EntryArray(old_entries->Capacity() * 2);
+  for (size_t i = 0; i < old_entries->Capacity(); ++i) {
+    MethodInlineCaches* caches = old_entries->Get(i)->LoadRelaxed();
+    if (caches != nullptr) {
+      InsertInto(new_entries, caches);
+    }
+  }
+  arrays_.emplace_back(new_entries);
+  entries_.StoreSequentiallyConsistent(new_entries);
+}
+
+MethodInlineCaches* InlineCacheTable::GetOrCreate(Thread* self, mirror::ArtMethod* method) {
+  MutexLock mu(self, lock_);
+  EntryArray* entries = entries_.LoadRelaxed();
+  for (size_t i = Hash(method); ; ++i) {
+    MethodInlineCaches* entry = entries->Get(i)->LoadRelaxed();
+    if (entry == nullptr) {
+      break;
+    }
+    if (entry->GetMethod() == method) {
+      return entry;
+    }
+  }
+  // Keep the table at most three quarters full so that probe sequences stay short.
+  const size_t num_methods = num_methods_.LoadRelaxed() + 1;
+  if (num_methods * 4 > entries->Capacity() * 3) {
+    Grow();
+  }
+  MethodInlineCaches* caches = MethodInlineCaches::Create(method);
+  InsertInto(entries_.LoadRelaxed(), caches);
+  num_methods_.StoreRelaxed(num_methods);
+  return caches;
+}
+
+void InlineCacheTable::VisitRoots(RootCallback* callback, void* arg) {
+  EntryArray* entries = entries_.LoadRelaxed();
+  for (size_t i = 0; i < entries->Capacity(); ++i) {
+    MethodInlineCaches* entry = entries->Get(i)->LoadRelaxed();
+    if (entry != nullptr) {
+      entry->VisitRoots(callback, arg);
+    }
+  }
+}
+
+void InlineCacheTable::ExportReceiverTypes(BinaryProfile* profile) const {
+  EntryArray* entries = entries_.LoadSequentiallyConsistent();
+  std::vector<mirror::Class*> classes;
+  std::vector<std::string> descriptors;
+  for (size_t i = 0; i < entries->Capacity(); ++i) {
+    MethodInlineCaches* entry = entries->Get(i)->LoadSequentiallyConsistent();
+    if (entry == nullptr) {
+      continue;
+    }
+    mirror::ArtMethod* method = entry->GetMethod();
+    const DexFile* dex_file = method->GetDexFile();
+    for (size_t j = 0; j < entry->NumCaches(); ++j) {
+      const InlineCache& cache = entry->GetCache(j);
+      if (cache.IsUninitialized() || cache.IsMegamorphic()) {
+        continue;
+      }
+      classes.clear();
+      cache.GetReceiverClasses(&classes);
+      descriptors.clear();
+      for (mirror::Class* klass : classes) {
+        descriptors.push_back(klass->GetDescriptor());
+      }
+      profile->AddReceiverTypes(dex_file->GetLocation(), dex_file->GetLocationChecksum(),
+                                method->GetDexMethodIndex(), cache.GetDexPc(), descriptors);
+    }
+  }
+}
+
+void InlineCacheTable::DumpForSigQuit(std::ostream& os) const {
+  size_t monomorphic = 0;
+  size_t polymorphic = 0;
+  size_t megamorphic = 0;
+  EntryArray* entries = entries_.LoadRelaxed();
+  for (size_t i = 0; i < entries->Capacity(); ++i) {
+    MethodInlineCaches* entry = entries->Get(i)->LoadRelaxed();
+    if (entry == nullptr) {
+      continue;
+    }
+    for (size_t j = 0; j < entry->NumCaches(); ++j) {
+      const InlineCache& cache = entry->GetCache(j);
+      monomorphic += cache.IsMonomorphic() ? 1 : 0;
+      polymorphic += cache.IsPolymorphic() ? 1 : 0;
+      megamorphic += cache.IsMegamorphic() ? 1 : 0;
+    }
+  }
+  os << "Interpreter inline caches: methods=" << NumMethods()
+     << " monomorphic=" << monomorphic
+     << " polymorphic=" << polymorphic
+     << " megamorphic=" << megamorphic << "\n";
+}
+
+}  // namespace interpreter
+}  // namespace art
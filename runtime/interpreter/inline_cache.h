@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ART_RUNTIME_INTERPRETER_INLINE_CACHE_H_
+#define ART_RUNTIME_INTERPRETER_INLINE_CACHE_H_
+
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+#include "atomic.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "object_callbacks.h"
+
+namespace art {
+
+class BinaryProfile;
+
+namespace mirror {
+  class ArtMethod;
+  class Class;
+}  // namespace mirror
+
+class Thread;
+
+namespace interpreter {
+
+// Receiver classes observed at one virtual or interface invoke of an interpreted method, with
+// the method each of them dispatched to. Lookups and updates are lock free: a slot is claimed by
+// installing its class and becomes visible to lookups once its target is published.
+class InlineCache {
+ public:
+  static constexpr size_t kIndividualCacheSize = 4;
+
+  uint32_t GetDexPc() const {
+    return dex_pc_;
+  }
+
+  // Returns the method the receiver class dispatched to, or nullptr if it is not cached.
+  mirror::ArtMethod* Lookup(mirror::Class* klass) const
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Records that klass dispatched to target. Once all slots are taken by other classes the
+  // call site becomes megamorphic and stops recording.
+  void Update(mirror::Class* klass, mirror::ArtMethod* target)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  bool IsUninitialized() const {
+    return !IsMegamorphic() && classes_[0].LoadRelaxed() == nullptr;
+  }
+
+  bool IsMonomorphic() const {
+    return !IsMegamorphic() && classes_[0].LoadRelaxed() != nullptr &&
+        classes_[1].LoadRelaxed() == nullptr;
+  }
+
+  bool IsPolymorphic() const {
+    return !IsMegamorphic() && classes_[1].LoadRelaxed() != nullptr;
+  }
+
+  bool IsMegamorphic() const {
+    return is_megamorphic_.LoadRelaxed();
+  }
+
+  // Appends the receiver classes seen so far, in the order they were first seen. A megamorphic
+  // call site keeps the classes it saw before it ran out of slots.
+  void GetReceiverClasses(std::vector<mirror::Class*>* classes) const
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+ private:
+  InlineCache() : dex_pc_(0), is_megamorphic_(false) {}
+
+  void VisitRoots(RootCallback* callback, void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  uint32_t dex_pc_;
+  Atomic<bool> is_megamorphic_;
+  Atomic<mirror::Class*> classes_[kIndividualCacheSize];
+  Atomic<mirror::ArtMethod*> targets_[kIndividualCacheSize];
+
+  friend class MethodInlineCaches;
+  DISALLOW_COPY_AND_ASSIGN(InlineCache);
+};
+
+// The inline caches of all virtual and interface invokes of one method, sorted by dex pc.
+class MethodInlineCaches {
+ public:
+  // Allocates an inline cache for each invoke-virtual, invoke-interface and
+  // invoke-virtual-quick of the method.
+  static MethodInlineCaches* Create(mirror::ArtMethod* method)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  mirror::ArtMethod* GetMethod() const {
+    return method_;
+  }
+
+  size_t NumCaches() const {
+    return num_caches_;
+  }
+
+  const InlineCache& GetCache(size_t i) const {
+    return caches_[i];
+  }
+
+  // Returns the inline cache of the invoke at dex_pc, or nullptr if there is none.
+  InlineCache* Find(uint32_t dex_pc);
+
+  void VisitRoots(RootCallback* callback, void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+ private:
+  MethodInlineCaches(mirror::ArtMethod* method, const std::vector<uint32_t>& dex_pcs);
+
+  mirror::ArtMethod* const method_;
+  const size_t num_caches_;
+  std::unique_ptr<InlineCache[]> caches_;
+
+  DISALLOW_COPY_AND_ASSIGN(MethodInlineCaches);
+};
+
+// Maps interpreted methods to their inline caches. Entries are never removed, which lets the
+// interpreter look them up without taking a lock; only insertion is serialized. The table grows
+// by publishing a copy twice the size, a lookup that raced with it and missed falls back to
+// GetOrCreate. ArtMethods are not moved by the GC, so they can be used as keys.
+class InlineCacheTable {
+ public:
+  static constexpr size_t kDefaultInitialCapacity = 1024;
+
+  explicit InlineCacheTable(size_t initial_capacity = kDefaultInitialCapacity);
+  ~InlineCacheTable();
+
+  // Returns the inline caches of method, or nullptr if there are none yet.
+  MethodInlineCaches* Get(mirror::ArtMethod* method) const;
+
+  // Returns the inline caches of method, creating them on first use.
+  MethodInlineCaches* GetOrCreate(Thread* self, mirror::ArtMethod* method)
+      LOCKS_EXCLUDED(lock_)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Returns the inline cache of the invoke at dex_pc of method, creating the caches of the
+  // method on first use.
+  InlineCache* GetInlineCache(Thread* self, mirror::ArtMethod* method, uint32_t dex_pc)
+      LOCKS_EXCLUDED(lock_)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    MethodInlineCaches* caches = Get(method);
+    if (UNLIKELY(caches == nullptr)) {
+      caches = GetOrCreate(self, method);
+    }
+    return caches->Find(dex_pc);
+  }
+
+  size_t NumMethods() const {
+    return num_methods_.LoadRelaxed();
+  }
+
+  size_t Capacity() const {
+    return entries_.LoadRelaxed()->Capacity();
+  }
+
+  void VisitRoots(RootCallback* callback, void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Adds the receiver classes of every call site which is neither uninitialized nor
+  // megamorphic to the profile, which the profiler passes on to the compiler.
+  void ExportReceiverTypes(BinaryProfile* profile) const
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  void DumpForSigQuit(std::ostream& os) const
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+ private:
+  // Open addressing hash table using linear probing, the capacity is a power of two.
+  class EntryArray {
+   public:
+    explicit EntryArray(size_t capacity);
+
+    size_t Capacity() const {
+      return mask_ + 1;
+    }
+
+    Atomic<MethodInlineCaches*>* Get(size_t index) {
+      return &entries_[index & mask_];
+    }
+
+   private:
+    const size_t mask_;
+    std::unique_ptr<Atomic<MethodInlineCaches*>[]> entries_;
+
+    DISALLOW_COPY_AND_ASSIGN(EntryArray);
+  };
+
+  static size_t Hash(mirror::ArtMethod* method);
+
+  // Stores caches into the first empty entry of its probe sequence.
+  static void InsertInto(EntryArray* entries, MethodInlineCaches* caches);
+
+  void Grow() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // The array probed by lock free readers.
+  Atomic<EntryArray*> entries_;
+  // The current array followed by the ones it replaced, lookups may still be probing those.
+  std::vector<std::unique_ptr<EntryArray>> arrays_ GUARDED_BY(lock_);
+  Atomic<size_t> num_methods_;
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+
+  DISALLOW_COPY_AND_ASSIGN(InlineCacheTable);
+};
+
+}  // namespace interpreter
+}  // namespace art
+
+#endif  // ART_RUNTIME_INTERPRETER_INLINE_CACHE_H_
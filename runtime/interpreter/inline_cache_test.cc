@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "inline_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "binary_profile.h"
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "mirror/art_method-inl.h"
+#include "mirror/class-inl.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+namespace interpreter {
+
+class InlineCacheTest : public CommonRuntimeTest {
+ protected:
+  static void VisitRootsCallback(mirror::Object** root, void* arg, uint32_t /*thread_id*/,
+                                 RootType /*root_type*/) {
+    *reinterpret_cast<size_t*>(arg) += 1;
+    EXPECT_TRUE(*root != nullptr);
+  }
+};
+
+TEST_F(InlineCacheTest, TestTransitions) {
+  ScopedObjectAccess soa(Thread::Current());
+  Thread* self = soa.Self();
+  mirror::Class* string_class = class_linker_->FindSystemClass(self, "Ljava/lang/String;");
+  ASSERT_TRUE(string_class != nullptr);
+  // String.valueOf(Object) calls toString() on its argument through an invoke-virtual.
+  mirror::ArtMethod* value_of =
+      string_class->FindDirectMethod("valueOf", "(Ljava/lang/Object;)Ljava/lang/String;");
+  ASSERT_TRUE(value_of != nullptr);
+  mirror::ArtMethod* to_string = string_class->FindVirtualMethod("toString",
+                                                                 "()Ljava/lang/String;");
+  ASSERT_TRUE(to_string != nullptr);
+
+  InlineCacheTable table(16);
+  EXPECT_EQ(table.NumMethods(), 0U);
+  MethodInlineCaches* caches = table.GetOrCreate(self, value_of);
+  ASSERT_TRUE(caches != nullptr);
+  EXPECT_EQ(table.GetOrCreate(self, value_of), caches);
+  EXPECT_EQ(table.Get(value_of), caches);
+  EXPECT_EQ(table.NumMethods(), 1U);
+  EXPECT_EQ(caches->GetMethod(), value_of);
+  ASSERT_GE(caches->NumCaches(), 1U);
+
+  const uint32_t dex_pc = caches->GetCache(0).GetDexPc();
+  InlineCache* cache = table.GetInlineCache(self, value_of, dex_pc);
+  ASSERT_TRUE(cache != nullptr);
+  EXPECT_TRUE(caches->Find(dex_pc + 1) == nullptr);
+  EXPECT_TRUE(cache->IsUninitialized());
+
+  const char* descriptors[] = {
+    "Ljava/lang/Object;", "Ljava/lang/String;", "Ljava/lang/Integer;", "Ljava/lang/Long;",
+    "Ljava/lang/Float;"
+  };
+  std::vector<mirror::Class*> classes;
+  for (const char* descriptor : descriptors) {
+    mirror::Class* klass = class_linker_->FindSystemClass(self, descriptor);
+    ASSERT_TRUE(klass != nullptr) << descriptor;
+    classes.push_back(klass);
+  }
+
+  EXPECT_TRUE(cache->Lookup(classes[0]) == nullptr);
+  cache->Update(classes[0], to_string);
+  cache->Update(classes[0], to_string);
+  EXPECT_TRUE(cache->IsMonomorphic());
+  EXPECT_EQ(cache->Lookup(classes[0]), to_string);
+  EXPECT_TRUE(cache->Lookup(classes[1]) == nullptr);
+  std::vector<mirror::Class*> receivers;
+  cache->GetReceiverClasses(&receivers);
+  ASSERT_EQ(receivers.size(), 1U);
+  EXPECT_EQ(receivers[0], classes[0]);
+
+  for (size_t i = 1; i < InlineCache::kIndividualCacheSize; ++i) {
+    cache->Update(classes[i], to_string);
+    EXPECT_TRUE(cache->IsPolymorphic());
+    EXPECT_EQ(cache->Lookup(classes[i]), to_string);
+  }
+  size_t visited = 0;
+  table.VisitRoots(VisitRootsCallback, &visited);
+  EXPECT_EQ(visited, InlineCache::kIndividualCacheSize);
+  receivers.clear();
+  cache->GetReceiverClasses(&receivers);
+  EXPECT_EQ(receivers, std::vector<mirror::Class*>(
+      classes.begin(), classes.begin() + InlineCache::kIndividualCacheSize));
+
+  // The polymorphic call site is exported to the profile, in descriptor order.
+  const DexFile* dex_file = value_of->GetDexFile();
+  BinaryProfile profile;
+  table.ExportReceiverTypes(&profile);
+  EXPECT_EQ(profile.NumCallSites(), 1U);
+  std::vector<std::string> exported;
+  ASSERT_TRUE(profile.GetReceiverTypes(dex_file->GetLocationChecksum(),
+                                       value_of->GetDexMethodIndex(), dex_pc, &exported));
+  std::vector<std::string> expected(descriptors,
+                                    descriptors + InlineCache::kIndividualCacheSize);
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(exported, expected);
+
+  cache->Update(classes[InlineCache::kIndividualCacheSize], to_string);
+  EXPECT_TRUE(cache->IsMegamorphic());
+  EXPECT_FALSE(cache->IsPolymorphic());
+  // Megamorphic call sites carry no useful receiver types for the compiler.
+  BinaryProfile megamorphic_profile;
+  table.ExportReceiverTypes(&megamorphic_profile);
+  EXPECT_EQ(megamorphic_profile.NumCallSites(), 0U);
+  // Classes seen before the site went megamorphic are still usable for dispatch.
+  EXPECT_EQ(cache->Lookup(classes[0]), to_string);
+  EXPECT_TRUE(cache->Lookup(classes[InlineCache::kIndividualCacheSize]) == nullptr);
+}
+
+TEST_F(InlineCacheTest, TestGrow) {
+  ScopedObjectAccess soa(Thread::Current());
+  Thread* self = soa.Self();
+  mirror::Class* string_class = class_linker_->FindSystemClass(self, "Ljava/lang/String;");
+  ASSERT_TRUE(string_class != nullptr);
+  InlineCacheTable table(4);
+  const size_t initial_capacity = table.Capacity();
+  std::vector<mirror::ArtMethod*> methods;
+  for (size_t i = 0; i < string_class->NumVirtualMethods(); ++i) {
+    mirror::ArtMethod* method = string_class->GetVirtualMethod(i);
+    methods.push_back(method);
+    ASSERT_TRUE(table.GetOrCreate(self, method) != nullptr);
+  }
+  ASSERT_GT(methods.size(), initial_capacity);
+  EXPECT_EQ(table.NumMethods(), methods.size());
+  EXPECT_GT(table.Capacity(), initial_capacity);
+  // Every method keeps its caches across the rebuilds.
+  for (mirror::ArtMethod* method : methods) {
+    MethodInlineCaches* caches = table.Get(method);
+    ASSERT_TRUE(caches != nullptr);
+    EXPECT_EQ(caches->GetMethod(), method);
+    EXPECT_EQ(table.GetOrCreate(self, method), caches);
+  }
+  EXPECT_EQ(table.NumMethods(), methods.size());
+}
+
+}  // namespace interpreter
+}  // namespace art
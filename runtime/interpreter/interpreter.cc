@@ -18,6 +18,7 @@
 
 #include <limits>
 
+#include "jit/jit.h"
 #include "mirror/string-inl.h"
 
 namespace art {
@@ -346,6 +347,36 @@ JValue ExecuteGotoImpl<false, true>(Thread* self, MethodHelper& mh,
                                      ShadowFrame& shadow_frame, JValue result_register);
 #endif
 
+#if (defined(__x86_64__) || defined(__arm__)) && !defined(ART_USE_PORTABLE_COMPILER)
+// Hand-written fast path for the common instructions, see arch/*/interpreter_*.S. Returns true
+// when the method returned, false when the C++ interpreter must continue from the shadow frame's
+// dex pc.
+static constexpr bool kUseAsmInterpreter = true;
+extern "C" bool artInterpreterAsmExecute(Thread* self, const uint16_t* insns,
+                                         ShadowFrame* shadow_frame, JValue* result,
+                                         JValue* result_register)
+    SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+#else
+static constexpr bool kUseAsmInterpreter = false;
+static bool artInterpreterAsmExecute(Thread* self, const uint16_t* insns,
+                                     ShadowFrame* shadow_frame, JValue* result,
+                                     JValue* result_register) {
+  LOG(FATAL) << "UNREACHABLE";
+  return false;
+}
+#endif
+
+// Cleared by tests comparing the assembly interpreter with the C++ interpreter.
+static bool asm_interpreter_enabled = kUseAsmInterpreter;
+
+void SetAsmInterpreterEnabled(bool enabled) {
+  asm_interpreter_enabled = kUseAsmInterpreter && enabled;
+}
+
+bool IsAsmInterpreterEnabled() {
+  return asm_interpreter_enabled;
+}
+
 static JValue Execute(Thread* self, MethodHelper& mh, const DexFile::CodeItem* code_item,
                       ShadowFrame& shadow_frame, JValue result_register)
     SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
@@ -358,8 +389,25 @@ static inline JValue Execute(Thread* self, MethodHelper& mh, const DexFile::Code
   DCHECK(!shadow_frame.GetMethod()->IsNative());
   shadow_frame.GetMethod()->GetDeclaringClass()->AssertInitializedOrInitializingInThread(self);
 
-  bool transaction_active = Runtime::Current()->IsActiveTransaction();
+  Runtime* const runtime = Runtime::Current();
+  jit::Jit* jit = runtime->GetJit();
+  if (UNLIKELY(jit != nullptr) && shadow_frame.GetDexPC() == 0) {
+    // Count method entries, not resumptions after deoptimization.
+    jit->AddSamples(self, shadow_frame.GetMethod(), 1);
+  }
+
+  bool transaction_active = runtime->IsActiveTransaction();
   if (LIKELY(shadow_frame.GetMethod()->IsPreverified())) {
+    // The assembly interpreter neither records transactions nor reports instrumentation events.
+    if (asm_interpreter_enabled && !transaction_active &&
+        !runtime->GetInstrumentation()->IsActive()) {
+      JValue result;
+      if (artInterpreterAsmExecute(self, code_item->insns_, &shadow_frame, &result,
+                                   &result_register)) {
+        return result;
+      }
+      // Continue from the instruction the assembly interpreter stopped at.
+    }
     // Enter the "without access check" interpreter.
     if (kInterpreterImplKind == kSwitchImpl) {
       if (transaction_active) {
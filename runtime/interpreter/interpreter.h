@@ -52,6 +52,12 @@ extern "C" void artInterpreterToInterpreterBridge(Thread* self, MethodHelper& mh
                                                   ShadowFrame* shadow_frame, JValue* result)
     SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
+// Enables or disables the hand-written assembly fast path where one exists for the target, for
+// tests comparing it with the C++ interpreter. Not thread-safe, only call before starting other
+// threads.
+void SetAsmInterpreterEnabled(bool enabled);
+bool IsAsmInterpreterEnabled();
+
 }  // namespace interpreter
 
 extern "C" void artInterpreterToCompiledCodeBridge(Thread* self, MethodHelper& mh,
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "interpreter_common.h"
+
+#include "asm_support.h"
+
+// Runtime support for the hand-written assembly interpreters (arch/*/interpreter_*.S).
+//
+// The assembly interpreters execute simple instructions inline and call into the helpers below
+// for instructions that need the runtime (invokes and field accesses). Each helper returns one
+// of the ASM_INTERP_* codes telling the assembly code how to proceed.
+
+namespace art {
+namespace interpreter {
+
+// Returns ASM_INTERP_FALLBACK when instrumentation has been enabled while the assembly
+// interpreter was running, so that the C++ interpreter continues with the alternative handlers.
+static inline int32_t AsmInterpAction(bool success) {
+  if (UNLIKELY(!success)) {
+    return ASM_INTERP_EXCEPTION;
+  }
+  if (UNLIKELY(Runtime::Current()->GetInstrumentation()->IsActive())) {
+    return ASM_INTERP_FALLBACK;
+  }
+  return ASM_INTERP_CONTINUE;
+}
+
+extern "C" int32_t artAsmInterpInvoke(Thread* self, ShadowFrame* shadow_frame,
+                                      const uint16_t* dex_pc_ptr, JValue* result_register)
+    SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+  const Instruction* inst = Instruction::At(dex_pc_ptr);
+  const uint16_t inst_data = inst->Fetch16(0);
+  bool success;
+  switch (inst->Opcode(inst_data)) {
+#define ASM_INTERP_INVOKE(opcode, type, is_range)                                             \
+    case Instruction::opcode:                                                                 \
+      success = DoInvoke<type, is_range, false>(self, *shadow_frame, inst, inst_data,         \
+                                                result_register);                             \
+      break;
+    ASM_INTERP_INVOKE(INVOKE_VIRTUAL, kVirtual, false)
+    ASM_INTERP_INVOKE(INVOKE_VIRTUAL_RANGE, kVirtual, true)
+    ASM_INTERP_INVOKE(INVOKE_SUPER, kSuper, false)
+    ASM_INTERP_INVOKE(INVOKE_SUPER_RANGE, kSuper, true)
+    ASM_INTERP_INVOKE(INVOKE_DIRECT, kDirect, false)
+    ASM_INTERP_INVOKE(INVOKE_DIRECT_RANGE, kDirect, true)
+    ASM_INTERP_INVOKE(INVOKE_STATIC, kStatic, false)
+    ASM_INTERP_INVOKE(INVOKE_STATIC_RANGE, kStatic, true)
+    ASM_INTERP_INVOKE(INVOKE_INTERFACE, kInterface, false)
+    ASM_INTERP_INVOKE(INVOKE_INTERFACE_RANGE, kInterface, true)
+#undef ASM_INTERP_INVOKE
+    case Instruction::INVOKE_VIRTUAL_QUICK:
+      success = DoInvokeVirtualQuick<false>(self, *shadow_frame, inst, inst_data,
+                                            result_register);
+      break;
+    case Instruction::INVOKE_VIRTUAL_RANGE_QUICK:
+      success = DoInvokeVirtualQuick<true>(self, *shadow_frame, inst, inst_data,
+                                           result_register);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected invoke in assembly interpreter: " << inst->DumpString(nullptr);
+      return ASM_INTERP_FALLBACK;
+  }
+  return AsmInterpAction(success);
+}
+
+extern "C" int32_t artAsmInterpFieldAccess(Thread* self, ShadowFrame* shadow_frame,
+                                           const uint16_t* dex_pc_ptr)
+    SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+  const Instruction* inst = Instruction::At(dex_pc_ptr);
+  const uint16_t inst_data = inst->Fetch16(0);
+  bool success;
+  switch (inst->Opcode(inst_data)) {
+#define ASM_INTERP_FIELD_GET(opcode, find_type, field_type)                                   \
+    case Instruction::opcode:                                                                 \
+      success = DoFieldGet<find_type, field_type, false>(self, *shadow_frame, inst, inst_data); \
+      break;
+#define ASM_INTERP_FIELD_PUT(opcode, find_type, field_type)                                   \
+    case Instruction::opcode:                                                                 \
+      success = DoFieldPut<find_type, field_type, false, false>(self, *shadow_frame, inst,    \
+                                                                inst_data);                   \
+      break;
+    ASM_INTERP_FIELD_GET(IGET, InstancePrimitiveRead, Primitive::kPrimInt)
+    ASM_INTERP_FIELD_GET(IGET_WIDE, InstancePrimitiveRead, Primitive::kPrimLong)
+    ASM_INTERP_FIELD_GET(IGET_OBJECT, InstanceObjectRead, Primitive::kPrimNot)
+    ASM_INTERP_FIELD_GET(IGET_BOOLEAN, InstancePrimitiveRead, Primitive::kPrimBoolean)
+    ASM_INTERP_FIELD_GET(IGET_BYTE, InstancePrimitiveRead, Primitive::kPrimByte)
+    ASM_INTERP_FIELD_GET(IGET_CHAR, InstancePrimitiveRead, Primitive::kPrimChar)
+    ASM_INTERP_FIELD_GET(IGET_SHORT, InstancePrimitiveRead, Primitive::kPrimShort)
+    ASM_INTERP_FIELD_PUT(IPUT, InstancePrimitiveWrite, Primitive::kPrimInt)
+    ASM_INTERP_FIELD_PUT(IPUT_WIDE, InstancePrimitiveWrite, Primitive::kPrimLong)
+    ASM_INTERP_FIELD_PUT(IPUT_OBJECT, InstanceObjectWrite, Primitive::kPrimNot)
+    ASM_INTERP_FIELD_PUT(IPUT_BOOLEAN, InstancePrimitiveWrite, Primitive::kPrimBoolean)
+    ASM_INTERP_FIELD_PUT(IPUT_BYTE, InstancePrimitiveWrite, Primitive::kPrimByte)
+    ASM_INTERP_FIELD_PUT(IPUT_CHAR, InstancePrimitiveWrite, Primitive::kPrimChar)
+    ASM_INTERP_FIELD_PUT(IPUT_SHORT, InstancePrimitiveWrite, Primitive::kPrimShort)
+    ASM_INTERP_FIELD_GET(SGET, StaticPrimitiveRead, Primitive::kPrimInt)
+    ASM_INTERP_FIELD_GET(SGET_WIDE, StaticPrimitiveRead, Primitive::kPrimLong)
+    ASM_INTERP_FIELD_GET(SGET_OBJECT, StaticObjectRead, Primitive::kPrimNot)
+    ASM_INTERP_FIELD_GET(SGET_BOOLEAN, StaticPrimitiveRead, Primitive::kPrimBoolean)
+    ASM_INTERP_FIELD_GET(SGET_BYTE, StaticPrimitiveRead, Primitive::kPrimByte)
+    ASM_INTERP_FIELD_GET(SGET_CHAR, StaticPrimitiveRead, Primitive::kPrimChar)
+    ASM_INTERP_FIELD_GET(SGET_SHORT, StaticPrimitiveRead, Primitive::kPrimShort)
+    ASM_INTERP_FIELD_PUT(SPUT, StaticPrimitiveWrite, Primitive::kPrimInt)
+    ASM_INTERP_FIELD_PUT(SPUT_WIDE, StaticPrimitiveWrite, Primitive::kPrimLong)
+    ASM_INTERP_FIELD_PUT(SPUT_OBJECT, StaticObjectWrite, Primitive::kPrimNot)
+    ASM_INTERP_FIELD_PUT(SPUT_BOOLEAN, StaticPrimitiveWrite, Primitive::kPrimBoolean)
+    ASM_INTERP_FIELD_PUT(SPUT_BYTE, StaticPrimitiveWrite, Primitive::kPrimByte)
+    ASM_INTERP_FIELD_PUT(SPUT_CHAR, StaticPrimitiveWrite, Primitive::kPrimChar)
+    ASM_INTERP_FIELD_PUT(SPUT_SHORT, StaticPrimitiveWrite, Primitive::kPrimShort)
+#undef ASM_INTERP_FIELD_GET
+#undef ASM_INTERP_FIELD_PUT
+    case Instruction::IGET_QUICK:
+      success = DoIGetQuick<Primitive::kPrimInt>(*shadow_frame, inst, inst_data);
+      break;
+    case Instruction::IGET_WIDE_QUICK:
+      success = DoIGetQuick<Primitive::kPrimLong>(*shadow_frame, inst, inst_data);
+      break;
+    case Instruction::IGET_OBJECT_QUICK:
+      success = DoIGetQuick<Primitive::kPrimNot>(*shadow_frame, inst, inst_data);
+      break;
+    case Instruction::IPUT_QUICK:
+      success = DoIPutQuick<Primitive::kPrimInt, false>(*shadow_frame, inst, inst_data);
+      break;
+    case Instruction::IPUT_WIDE_QUICK:
+      success = DoIPutQuick<Primitive::kPrimLong, false>(*shadow_frame, inst, inst_data);
+      break;
+    case Instruction::IPUT_OBJECT_QUICK:
+      success = DoIPutQuick<Primitive::kPrimNot, false>(*shadow_frame, inst, inst_data);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected field access in assembly interpreter: "
+                 << inst->DumpString(nullptr);
+      return ASM_INTERP_FALLBACK;
+  }
+  return AsmInterpAction(success);
+}
+
+// Looks for a catch handler for the pending exception at the shadow frame's dex pc. Returns the
+// dex pc of the handler, or DexFile::kDexNoIndex when the exception leaves the method.
+extern "C" uint32_t artAsmInterpHandleException(Thread* self, ShadowFrame* shadow_frame)
+    SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+  DCHECK(self->IsExceptionPending());
+  if (UNLIKELY(self->TestAllFlags())) {
+    CheckSuspend(self);
+  }
+  return FindNextInstructionFollowingException(self, *shadow_frame, shadow_frame->GetDexPC(),
+                                               Runtime::Current()->GetInstrumentation());
+}
+
+}  // namespace interpreter
+}  // namespace art
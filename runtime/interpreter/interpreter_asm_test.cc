@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interpreter.h"
+
+#include <limits.h>
+
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "gc/heap.h"
+#include "handle_scope-inl.h"
+#include "jvalue.h"
+#include "mirror/array-inl.h"
+#include "mirror/art_method-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/string.h"
+#include "scoped_thread_state_change.h"
+#include "stack.h"
+#include "throw_location.h"
+
+namespace art {
+namespace interpreter {
+
+// Runs the methods of test/AsmInterpreter with the assembly fast path disabled and enabled and
+// checks that both interpreters return the same value, or throw the same exception from the same
+// dex pc. On targets without an assembly interpreter both runs use the C++ interpreter.
+class InterpreterAsmTest : public CommonRuntimeTest {
+ protected:
+  struct Outcome {
+    JValue result;
+    // Type of the exception thrown, empty if the method returned normally.
+    std::string exception;
+    // Method and dex pc the exception was thrown from.
+    std::string throw_method;
+    uint32_t throw_dex_pc;
+  };
+
+  void SetUpRuntimeOptions(RuntimeOptions* options) OVERRIDE {
+    // With read barriers compiled in, run with the concurrent copying collector so that
+    // aget-object is exercised while the barriers are live.
+    if (kUseBakerReadBarrier) {
+      options->push_back(std::make_pair("-Xgc:CC", nullptr));
+      options->push_back(std::make_pair("-Xint", nullptr));
+    }
+  }
+
+  void SetUp() OVERRIDE {
+    CommonRuntimeTest::SetUp();
+    ScopedObjectAccess soa(Thread::Current());
+    class_loader_ = LoadDex("AsmInterpreter");
+  }
+
+  void TearDown() OVERRIDE {
+    SetAsmInterpreterEnabled(true);
+    CommonRuntimeTest::TearDown();
+  }
+
+  mirror::Class* GetTestClass(Thread* self) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    StackHandleScope<2> hs(self);
+    Handle<mirror::ClassLoader> loader(
+        hs.NewHandle(ScopedObjectAccessUnchecked(self).Decode<mirror::ClassLoader*>(
+            class_loader_)));
+    Handle<mirror::Class> klass(
+        hs.NewHandle(class_linker_->FindClass(self, "LAsmInterpreter;", loader)));
+    CHECK(klass.Get() != nullptr);
+    // The assembly interpreter only runs preverified methods.
+    CHECK(class_linker_->EnsureInitialized(klass, true, true));
+    return klass.Get();
+  }
+
+  mirror::ArtMethod* FindMethod(Thread* self, const char* name, const char* signature)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    mirror::Class* klass = GetTestClass(self);
+    mirror::ArtMethod* method = klass->FindDirectMethod(name, signature);
+    if (method == nullptr) {
+      method = klass->FindVirtualMethod(name, signature);
+    }
+    CHECK(method != nullptr) << name << signature;
+    CHECK(method->IsPreverified()) << PrettyMethod(method);
+    return method;
+  }
+
+  Outcome Run(Thread* self, bool use_asm, mirror::ArtMethod* method, mirror::Object* receiver,
+              std::vector<uint32_t> args) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    SetAsmInterpreterEnabled(use_asm);
+    Outcome outcome;
+    outcome.throw_dex_pc = DexFile::kDexNoIndex;
+    EnterInterpreterFromInvoke(self, method, receiver, args.empty() ? nullptr : &args[0],
+                               &outcome.result);
+    if (self->IsExceptionPending()) {
+      ThrowLocation throw_location;
+      mirror::Throwable* exception = self->GetException(&throw_location);
+      outcome.exception = PrettyTypeOf(exception);
+      outcome.throw_method = PrettyMethod(throw_location.GetMethod());
+      outcome.throw_dex_pc = throw_location.GetDexPc();
+      self->ClearException();
+    }
+    SetAsmInterpreterEnabled(true);
+    return outcome;
+  }
+
+  // Runs the method in both interpreters and checks that the outcomes match. Returns the outcome
+  // of the assembly interpreter.
+  Outcome Compare(const char* name, const char* signature, mirror::Object* receiver,
+                  std::vector<uint32_t> args) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    Thread* self = Thread::Current();
+    mirror::ArtMethod* method = FindMethod(self, name, signature);
+    Outcome expected = Run(self, false, method, receiver, args);
+    Outcome actual = Run(self, true, method, receiver, args);
+    EXPECT_EQ(expected.result.GetJ(), actual.result.GetJ()) << name << signature;
+    EXPECT_EQ(expected.exception, actual.exception) << name << signature;
+    EXPECT_EQ(expected.throw_method, actual.throw_method) << name << signature;
+    EXPECT_EQ(expected.throw_dex_pc, actual.throw_dex_pc) << name << signature;
+    return actual;
+  }
+
+  int32_t CompareInt(const char* name, const char* signature, int32_t a, int32_t b)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    std::vector<uint32_t> args;
+    args.push_back(static_cast<uint32_t>(a));
+    args.push_back(static_cast<uint32_t>(b));
+    return Compare(name, signature, nullptr, args).result.GetI();
+  }
+
+  int64_t CompareLong(const char* name, const char* signature, int64_t a, int64_t b)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    std::vector<uint32_t> args;
+    PushWide(&args, a);
+    PushWide(&args, b);
+    return Compare(name, signature, nullptr, args).result.GetJ();
+  }
+
+  int64_t CompareLongShift(const char* name, int64_t a, int32_t distance)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    std::vector<uint32_t> args;
+    PushWide(&args, a);
+    args.push_back(static_cast<uint32_t>(distance));
+    return Compare(name, "(JI)J", nullptr, args).result.GetJ();
+  }
+
+  static void PushWide(std::vector<uint32_t>* args, int64_t value) {
+    args->push_back(static_cast<uint32_t>(value));
+    args->push_back(static_cast<uint32_t>(static_cast<uint64_t>(value) >> 32));
+  }
+
+  static uint32_t Ref(mirror::Object* obj) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    return StackReference<mirror::Object>::FromMirrorPtr(obj).AsVRegValue();
+  }
+
+  jobject class_loader_;
+};
+
+TEST_F(InterpreterAsmTest, DivRem) {
+  ScopedObjectAccess soa(Thread::Current());
+  EXPECT_EQ(-3, CompareInt("divInt", "(II)I", 7, -2));
+  EXPECT_EQ(1, CompareInt("remInt", "(II)I", 7, -2));
+  EXPECT_EQ(-1, CompareInt("remInt", "(II)I", -7, 2));
+  // INT_MIN / -1 overflows back to INT_MIN and leaves no remainder instead of trapping.
+  EXPECT_EQ(INT_MIN, CompareInt("divInt", "(II)I", INT_MIN, -1));
+  EXPECT_EQ(0, CompareInt("remInt", "(II)I", INT_MIN, -1));
+  EXPECT_EQ(INT64_C(-3), CompareLong("divLong", "(JJ)J", 7, -2));
+  EXPECT_EQ(INT64_C(1), CompareLong("remLong", "(JJ)J", 7, -2));
+  EXPECT_EQ(INT64_MIN, CompareLong("divLong", "(JJ)J", INT64_MIN, -1));
+  EXPECT_EQ(0, CompareLong("remLong", "(JJ)J", INT64_MIN, -1));
+
+  std::vector<uint32_t> args;
+  args.push_back(static_cast<uint32_t>(INT_MIN));
+  EXPECT_EQ(INT_MIN, Compare("divIntLit8", "(I)I", nullptr, args).result.GetI());
+  args[0] = static_cast<uint32_t>(-123456);
+  EXPECT_EQ(-456, Compare("remIntLit16", "(I)I", nullptr, args).result.GetI());
+}
+
+TEST_F(InterpreterAsmTest, DivByZero) {
+  ScopedObjectAccess soa(Thread::Current());
+  Outcome outcome = Compare("divInt", "(II)I", nullptr, std::vector<uint32_t>{1, 0});
+  EXPECT_EQ("java.lang.ArithmeticException", outcome.exception);
+  EXPECT_EQ(0U, outcome.throw_dex_pc);
+  outcome = Compare("remInt", "(II)I", nullptr, std::vector<uint32_t>{1, 0});
+  EXPECT_EQ("java.lang.ArithmeticException", outcome.exception);
+  outcome = Compare("divLong", "(JJ)J", nullptr, std::vector<uint32_t>{1, 0, 0, 0});
+  EXPECT_EQ("java.lang.ArithmeticException", outcome.exception);
+  outcome = Compare("remLong", "(JJ)J", nullptr, std::vector<uint32_t>{1, 0, 0, 0});
+  EXPECT_EQ("java.lang.ArithmeticException", outcome.exception);
+  // The high word alone is not zero.
+  EXPECT_EQ(0, CompareLong("divLong", "(JJ)J", 1, INT64_C(1) << 32));
+}
+
+TEST_F(InterpreterAsmTest, ShiftDistanceIsMasked) {
+  ScopedObjectAccess soa(Thread::Current());
+  // Int shifts only use the low five bits of the distance, long shifts the low six.
+  EXPECT_EQ(2, CompareInt("shlInt", "(II)I", 1, 33));
+  EXPECT_EQ(INT_MIN, CompareInt("shlInt", "(II)I", 1, -1));
+  EXPECT_EQ(-1, CompareInt("shrInt", "(II)I", INT_MIN, 63));
+  EXPECT_EQ(1, CompareInt("ushrInt", "(II)I", INT_MIN, 31));
+  EXPECT_EQ(INT_MIN, CompareInt("ushrInt", "(II)I", INT_MIN, 32));
+  EXPECT_EQ(INT64_C(2), CompareLongShift("shlLong", 1, 65));
+  EXPECT_EQ(INT64_MIN, CompareLongShift("shlLong", 1, -1));
+  EXPECT_EQ(INT64_C(-1), CompareLongShift("shrLong", INT64_MIN, 127));
+  EXPECT_EQ(INT64_C(1), CompareLongShift("ushrLong", INT64_MIN, 63));
+  EXPECT_EQ(INT64_MIN, CompareLongShift("ushrLong", INT64_MIN, 64));
+}
+
+TEST_F(InterpreterAsmTest, Loop) {
+  ScopedObjectAccess soa(Thread::Current());
+  std::vector<uint32_t> args;
+  args.push_back(0);
+  EXPECT_EQ(0, Compare("loop", "(I)I", nullptr, args).result.GetI());
+  args[0] = 10000;
+  Compare("loop", "(I)I", nullptr, args);
+}
+
+TEST_F(InterpreterAsmTest, ExceptionHandoff) {
+  ScopedObjectAccess soa(Thread::Current());
+  // Caught in the same method.
+  EXPECT_EQ(-1, CompareInt("catchDivByZero", "(II)I", 5, 0));
+  EXPECT_EQ(2, CompareInt("catchDivByZero", "(II)I", 5, 2));
+
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::IntArray> array(hs.NewHandle(mirror::IntArray::Alloc(soa.Self(), 3)));
+  ASSERT_TRUE(array.Get() != nullptr);
+  array->Set(2, 17);
+  std::vector<uint32_t> args;
+  args.push_back(Ref(array.Get()));
+  args.push_back(2);
+  EXPECT_EQ(17, Compare("arrayGet", "([II)I", nullptr, args).result.GetI());
+  args[1] = 3;
+  Outcome outcome = Compare("arrayGet", "([II)I", nullptr, args);
+  EXPECT_EQ("java.lang.ArrayIndexOutOfBoundsException", outcome.exception);
+  args[1] = static_cast<uint32_t>(-1);
+  outcome = Compare("arrayGet", "([II)I", nullptr, args);
+  EXPECT_EQ("java.lang.ArrayIndexOutOfBoundsException", outcome.exception);
+  EXPECT_EQ(-2, Compare("catchArrayGet", "([II)I", nullptr, args).result.GetI());
+  args[0] = 0;
+  outcome = Compare("arrayGet", "([II)I", nullptr, args);
+  EXPECT_EQ("java.lang.NullPointerException", outcome.exception);
+  EXPECT_EQ(-3, Compare("catchArrayGet", "([II)I", nullptr, args).result.GetI());
+}
+
+TEST_F(InterpreterAsmTest, AgetObject) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::Class> array_class(
+      hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "[Ljava/lang/Object;")));
+  Handle<mirror::ObjectArray<mirror::Object>> array(
+      hs.NewHandle(mirror::ObjectArray<mirror::Object>::Alloc(soa.Self(), array_class.Get(), 4)));
+  ASSERT_TRUE(array.Get() != nullptr);
+  int32_t expected_length = 0;
+  for (int32_t i = 0; i < 4; ++i) {
+    std::string value(i + 1, 'x');
+    mirror::String* string = mirror::String::AllocFromModifiedUtf8(soa.Self(), value.c_str());
+    ASSERT_TRUE(string != nullptr);
+    array->Set<false>(i, string);
+    expected_length += i + 1;
+  }
+  // With read barriers the assembly interpreter hands aget-object over to the C++ interpreter,
+  // without them it loads the reference inline. Collections between the runs move the elements
+  // with a moving collector, the loads must always see the current copies.
+  for (size_t gc = 0; gc < 3; ++gc) {
+    std::vector<uint32_t> args;
+    args.push_back(Ref(array.Get()));
+    args.push_back(2);
+    Outcome outcome = Compare("agetObject", "([Ljava/lang/Object;I)Ljava/lang/Object;", nullptr,
+                              args);
+    EXPECT_EQ(array->Get(2), outcome.result.GetL());
+    args.pop_back();
+    EXPECT_EQ(expected_length,
+              Compare("agetObjectLength", "([Ljava/lang/Object;)I", nullptr, args).result.GetI());
+    args.push_back(4);
+    EXPECT_EQ("java.lang.ArrayIndexOutOfBoundsException",
+              Compare("agetObject", "([Ljava/lang/Object;I)Ljava/lang/Object;", nullptr,
+                      args).exception);
+    Runtime::Current()->GetHeap()->CollectGarbage(false);
+  }
+}
+
+TEST_F(InterpreterAsmTest, Invokes) {
+  ScopedObjectAccess soa(Thread::Current());
+  EXPECT_EQ(10, CompareInt("invokeStatic", "(II)I", 2, 3));
+  EXPECT_EQ(INT64_C(7) + 1, CompareLong("invokeWide", "(JJ)J", 22, 3));
+
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::Class> klass(hs.NewHandle(GetTestClass(soa.Self())));
+  Handle<mirror::Object> receiver(hs.NewHandle(klass->AllocObject(soa.Self())));
+  ASSERT_TRUE(receiver.Get() != nullptr);
+  std::vector<uint32_t> args;
+  args.push_back(21);
+  EXPECT_EQ(42, Compare("invokeVirtual", "(I)I", receiver.Get(), args).result.GetI());
+
+  mirror::String* string = mirror::String::AllocFromModifiedUtf8(soa.Self(), "hello");
+  ASSERT_TRUE(string != nullptr);
+  args[0] = Ref(string);
+  EXPECT_EQ(5, Compare("invokeInterface", "(Ljava/lang/CharSequence;)I", nullptr,
+                       args).result.GetI());
+  args[0] = 0;
+  Outcome outcome = Compare("invokeInterface", "(Ljava/lang/CharSequence;)I", nullptr, args);
+  EXPECT_EQ("java.lang.NullPointerException", outcome.exception);
+
+  // An exception thrown by the callee unwinds through the caller, or is caught there.
+  args[0] = 1;
+  outcome = Compare("invokeThrows", "(I)I", nullptr, args);
+  EXPECT_EQ("java.lang.ArithmeticException", outcome.exception);
+  EXPECT_EQ("int AsmInterpreter.divInt(int, int)", outcome.throw_method);
+  EXPECT_EQ(42, Compare("invokeCatches", "(I)I", nullptr, args).result.GetI());
+}
+
+}  // namespace interpreter
+}  // namespace art
@@ -30,6 +30,7 @@
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "gc/accounting/card_table-inl.h"
 #include "handle_scope-inl.h"
+#include "interpreter/inline_cache.h"
 #include "method_helper-inl.h"
 #include "nth_caller_visitor.h"
 #include "mirror/art_field-inl.h"
@@ -109,6 +110,21 @@ static inline bool DoInvoke(Thread* self, ShadowFrame& shadow_frame, const Instr
   const uint32_t vregC = (is_range) ? inst->VRegC_3rc() : inst->VRegC_35c();
   Object* receiver = (type == kStatic) ? nullptr : shadow_frame.GetVRegReference(vregC);
   mirror::ArtMethod* sf_method = shadow_frame.GetMethod();
+  // Virtual and interface dispatch only depends on the receiver class once access checks are
+  // done, so a previous resolution for the same class can be reused.
+  InlineCache* inline_cache = nullptr;
+  InlineCacheTable* const inline_cache_table = Runtime::Current()->GetInlineCacheTable();
+  if ((type == kVirtual || type == kInterface) && !do_access_check && receiver != nullptr &&
+      inline_cache_table != nullptr) {
+    inline_cache = inline_cache_table->GetInlineCache(self, sf_method, shadow_frame.GetDexPC());
+    if (inline_cache != nullptr) {
+      ArtMethod* const cached_method = inline_cache->Lookup(receiver->GetClass());
+      if (cached_method != nullptr) {
+        return DoCall<is_range, do_access_check>(cached_method, self, shadow_frame, inst,
+                                                 inst_data, result);
+      }
+    }
+  }
   ArtMethod* const method = FindMethodFromCode<type, do_access_check>(
       method_idx, &receiver, &sf_method, self);
   // The shadow frame should already be pushed, so we don't need to update it.
@@ -121,6 +137,9 @@ static inline bool DoInvoke(Thread* self, ShadowFrame& shadow_frame, const Instr
     result->SetJ(0);
     return false;
   } else {
+    if (inline_cache != nullptr) {
+      inline_cache->Update(receiver->GetClass(), method);
+    }
     return DoCall<is_range, do_access_check>(method, self, shadow_frame, inst, inst_data, result);
   }
 }
@@ -151,6 +170,15 @@ static inline bool DoInvokeVirtualQuick(Thread* self, ShadowFrame& shadow_frame,
     result->SetJ(0);
     return false;
   } else {
+    // The vtable lookup is already cheap, only record the receiver class for the compiler.
+    InlineCacheTable* const inline_cache_table = Runtime::Current()->GetInlineCacheTable();
+    if (inline_cache_table != nullptr) {
+      InlineCache* inline_cache = inline_cache_table->GetInlineCache(
+          self, shadow_frame.GetMethod(), shadow_frame.GetDexPC());
+      if (inline_cache != nullptr) {
+        inline_cache->Update(receiver->GetClass(), method);
+      }
+    }
     // No need to check since we've been quickened.
     return DoCall<is_range, false>(method, self, shadow_frame, inst, inst_data, result);
   }
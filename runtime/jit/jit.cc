@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jit.h"
+
+#include <dlfcn.h>
+
+#include "base/stringprintf.h"
+#include "jit_code_cache.h"
+#include "mirror/art_method-inl.h"
+#include "mirror/class-inl.h"
+#include "scoped_thread_state_change.h"
+#include "thread-inl.h"
+#include "thread_pool.h"
+#include "utils.h"
+
+namespace art {
+namespace jit {
+
+constexpr size_t Jit::kDefaultCompileThreshold;
+constexpr size_t JitSampleTable::kDefaultCapacity;
+
+JitSampleTable::JitSampleTable(size_t compile_threshold, size_t capacity)
+    : compile_threshold_(static_cast<uint32_t>(compile_threshold)),
+      mask_(capacity - 1), slots_(new Slot[capacity]) {
+  CHECK_GT(compile_threshold, 0U);
+  CHECK_EQ(compile_threshold_, compile_threshold);
+  CHECK(IsPowerOfTwo(capacity)) << capacity;
+}
+
+JitSampleTable::Slot* JitSampleTable::FindSlot(mirror::ArtMethod* method, bool create) const {
+  DCHECK(method != nullptr);
+  // Drop the low bits, which are always zero for an aligned object.
+  size_t index = (reinterpret_cast<uintptr_t>(method) / kObjectAlignment) & mask_;
+  for (size_t probes = 0; probes <= mask_; ++probes) {
+    Slot* slot = &slots_[index];
+    mirror::ArtMethod* key = slot->method.LoadRelaxed();
+    if (key == method) {
+      return slot;
+    }
+    if (key == nullptr) {
+      if (!create) {
+        return nullptr;  // Keys are never removed, so the method is not in the table.
+      }
+      if (slot->method.CompareExchangeStrongSequentiallyConsistent(nullptr, method)) {
+        return slot;
+      }
+      // Lost the race for the slot, possibly to another thread adding the same method.
+      if (slot->method.LoadRelaxed() == method) {
+        return slot;
+      }
+    }
+    index = (index + 1) & mask_;
+  }
+  return nullptr;
+}
+
+bool JitSampleTable::AddSamples(mirror::ArtMethod* method, size_t count, bool can_compile) {
+  Slot* slot = FindSlot(method, true);
+  if (slot == nullptr) {
+    return false;
+  }
+  const uint32_t limit = can_compile ? compile_threshold_ : compile_threshold_ - 1;
+  while (true) {
+    const uint32_t samples = slot->samples.LoadRelaxed();
+    if (samples >= limit) {
+      return false;  // Already queued, or hot but waiting for its class to be initialized.
+    }
+    const uint32_t new_samples = (count >= limit - samples) ? limit : samples + count;
+    if (slot->samples.CompareExchangeWeakRelaxed(samples, new_samples)) {
+      return new_samples == compile_threshold_;
+    }
+  }
+}
+
+size_t JitSampleTable::GetSamples(mirror::ArtMethod* method) const {
+  Slot* slot = FindSlot(method, false);
+  return (slot != nullptr) ? slot->samples.LoadRelaxed() : 0u;
+}
+
+class JitCompileTask : public Task {
+ public:
+  explicit JitCompileTask(mirror::ArtMethod* method) : method_(method) {}
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedObjectAccess soa(self);
+    Runtime::Current()->GetJit()->CompileMethod(method_, self);
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  mirror::ArtMethod* const method_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitCompileTask);
+};
+
+Jit* Jit::Create(size_t code_cache_capacity, size_t compile_threshold, std::string* error_msg) {
+  std::unique_ptr<Jit> jit(new Jit(compile_threshold));
+  if (!jit->LoadCompiler(error_msg)) {
+    return nullptr;
+  }
+  jit->code_cache_.reset(JitCodeCache::Create(code_cache_capacity, error_msg));
+  if (jit->GetCodeCache() == nullptr) {
+    return nullptr;
+  }
+  VLOG(jit) << "JIT created with code_cache_capacity=" << PrettySize(code_cache_capacity)
+            << " compile_threshold=" << compile_threshold;
+  return jit.release();
+}
+
+Jit::Jit(size_t compile_threshold)
+    : jit_library_handle_(nullptr), jit_compiler_handle_(nullptr), jit_load_(nullptr),
+      jit_unload_(nullptr), jit_compile_method_(nullptr), compile_threshold_(compile_threshold),
+      samples_(compile_threshold), lock_("Jit samples lock", kJitSamplesLock),
+      methods_compiled_(0), methods_failed_(0) {
+}
+
+Jit::~Jit() {
+  DeleteThreadPool();
+  if (jit_compiler_handle_ != nullptr) {
+    jit_unload_(jit_compiler_handle_);
+  }
+  if (jit_library_handle_ != nullptr) {
+    dlclose(jit_library_handle_);
+  }
+}
+
+bool Jit::LoadCompiler(std::string* error_msg) {
+  const char* compiler_library = kIsDebugBuild ? "libartd-compiler.so" : "libart-compiler.so";
+  jit_library_handle_ = dlopen(compiler_library, RTLD_NOW);
+  if (jit_library_handle_ == nullptr) {
+    *error_msg = StringPrintf("JIT could not load %s: %s", compiler_library, dlerror());
+    return false;
+  }
+  jit_load_ = reinterpret_cast<void* (*)()>(dlsym(jit_library_handle_, "jit_load"));
+  jit_unload_ = reinterpret_cast<void (*)(void*)>(dlsym(jit_library_handle_, "jit_unload"));
+  jit_compile_method_ = reinterpret_cast<bool (*)(void*, mirror::ArtMethod*, Thread*)>(
+      dlsym(jit_library_handle_, "jit_compile_method"));
+  if (jit_load_ == nullptr || jit_unload_ == nullptr || jit_compile_method_ == nullptr) {
+    *error_msg = StringPrintf("JIT couldn't find the entrypoints of %s: %s", compiler_library,
+                              dlerror());
+    dlclose(jit_library_handle_);
+    jit_library_handle_ = nullptr;
+    return false;
+  }
+  jit_compiler_handle_ = jit_load_();
+  if (jit_compiler_handle_ == nullptr) {
+    *error_msg = "JIT couldn't load the compiler";
+    return false;
+  }
+  return true;
+}
+
+void Jit::AddSamples(Thread* self, mirror::ArtMethod* method, size_t count) {
+  // Compiled code skips the class initialization checks the interpreter performs on entry, so a
+  // method of an uninitialized class is left hot but unqueued until the class is initialized.
+  if (!samples_.AddSamples(method, count, method->GetDeclaringClass()->IsInitialized())) {
+    return;
+  }
+  MutexLock mu(self, lock_);
+  if (thread_pool_.get() == nullptr) {
+    return;  // Shutting down.
+  }
+  VLOG(jit) << "JIT queueing " << PrettyMethod(method);
+  thread_pool_->AddTask(self, new JitCompileTask(method));
+}
+
+bool Jit::CompileMethod(mirror::ArtMethod* method, Thread* self) {
+  DCHECK(!method->IsRuntimeMethod());
+  if (method->IsNative() || method->IsAbstract() || method->IsProxyMethod()) {
+    return false;
+  }
+  if (code_cache_->ContainsMethod(method)) {
+    return true;
+  }
+  const uint64_t start_ns = NanoTime();
+  const bool success = jit_compile_method_(jit_compiler_handle_, method, self);
+  VLOG(jit) << "JIT " << (success ? "compiled " : "failed to compile ") << PrettyMethod(method)
+            << " in " << PrettyDuration(NanoTime() - start_ns);
+  MutexLock mu(self, lock_);
+  if (success) {
+    ++methods_compiled_;
+  } else {
+    ++methods_failed_;
+  }
+  return success;
+}
+
+void Jit::CreateThreadPool() {
+  Thread* self = Thread::Current();
+  MutexLock mu(self, lock_);
+  CHECK(thread_pool_.get() == nullptr);
+  thread_pool_.reset(new ThreadPool("Jit thread pool", 1));
+  thread_pool_->StartWorkers(self);
+}
+
+void Jit::DeleteThreadPool() {
+  std::unique_ptr<ThreadPool> thread_pool;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    thread_pool.swap(thread_pool_);
+  }
+  // Joins the compilation thread outside of lock_, which a running task may need.
+  thread_pool.reset();
+}
+
+void Jit::DumpForSigQuit(std::ostream& os) {
+  Thread* self = Thread::Current();
+  MutexLock mu(self, lock_);
+  os << "JIT: compiled " << methods_compiled_ << " methods, " << methods_failed_ << " failed, "
+     << code_cache_->NumFullCacheFailures(self) << " of them for a full code cache, "
+     << PrettySize(code_cache_->CodeCacheSize()) << " code and "
+     << PrettySize(code_cache_->DataCacheSize()) << " data in the code cache\n";
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ART_RUNTIME_JIT_JIT_H_
+#define ART_RUNTIME_JIT_JIT_H_
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include "atomic.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "globals.h"
+
+namespace art {
+
+namespace mirror {
+  class ArtMethod;
+}  // namespace mirror
+
+class Thread;
+class ThreadPool;
+
+namespace jit {
+
+class JitCodeCache;
+
+// Hotness counters of interpreted methods. They are kept on the side rather than in
+// mirror::ArtMethod, whose layout must match java.lang.reflect.ArtMethod. ArtMethods are
+// allocated in the non-moving space so the raw pointers are stable keys.
+//
+// The interpreter bumps a counter on every method entry, so the table is lock free: a fixed size
+// open-addressing array whose keys are claimed with a CAS and never removed. Once the table is
+// full, methods without a slot are simply not sampled.
+class JitSampleTable {
+ public:
+  static constexpr size_t kDefaultCapacity = 16 * 1024;
+
+  // "capacity" must be a power of two.
+  JitSampleTable(size_t compile_threshold, size_t capacity = kDefaultCapacity);
+
+  // Add "count" samples to a method. Returns true for the single call that brings the method to
+  // the compile threshold, the caller is then responsible for queueing it. While "can_compile"
+  // is false the counter stops just below the threshold.
+  bool AddSamples(mirror::ArtMethod* method, size_t count, bool can_compile);
+
+  size_t GetSamples(mirror::ArtMethod* method) const;
+
+ private:
+  struct Slot {
+    Slot() : method(nullptr), samples(0) {}
+
+    Atomic<mirror::ArtMethod*> method;
+    Atomic<uint32_t> samples;
+  };
+
+  // Returns the slot of a method, claiming a free one if "create" is true. Returns null if the
+  // method has no slot and none can be claimed.
+  Slot* FindSlot(mirror::ArtMethod* method, bool create) const;
+
+  const uint32_t compile_threshold_;
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitSampleTable);
+};
+
+// In-process JIT. Interpreted methods are sampled on entry and, once hot, compiled by the Quick
+// backend of the dynamically loaded compiler library on a background thread. The code is placed
+// in the JitCodeCache and published by updating the method's entrypoints.
+class Jit {
+ public:
+  static constexpr size_t kDefaultCompileThreshold = 1000;
+
+  static Jit* Create(size_t code_cache_capacity, size_t compile_threshold,
+                     std::string* error_msg);
+  ~Jit();
+
+  // Record "count" invocations of an interpreted method and queue it for compilation when it
+  // crosses the compile threshold. A method is queued at most once. Lock free unless the method
+  // crosses the threshold.
+  void AddSamples(Thread* self, mirror::ArtMethod* method, size_t count)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) LOCKS_EXCLUDED(lock_);
+
+  // Compile a method and install the code into the code cache. Returns false if the method was
+  // not compiled.
+  bool CompileMethod(mirror::ArtMethod* method, Thread* self)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Start and stop the background compilation thread.
+  void CreateThreadPool() LOCKS_EXCLUDED(lock_);
+  void DeleteThreadPool() LOCKS_EXCLUDED(lock_);
+
+  size_t GetCompileThreshold() const {
+    return compile_threshold_;
+  }
+
+  JitCodeCache* GetCodeCache() {
+    return code_cache_.get();
+  }
+
+  void DumpForSigQuit(std::ostream& os) LOCKS_EXCLUDED(lock_);
+
+ private:
+  explicit Jit(size_t compile_threshold);
+  bool LoadCompiler(std::string* error_msg);
+
+  // JIT compiler library and its entrypoints.
+  void* jit_library_handle_;
+  void* jit_compiler_handle_;
+  void* (*jit_load_)();
+  void (*jit_unload_)(void*);
+  bool (*jit_compile_method_)(void*, mirror::ArtMethod*, Thread*);
+
+  std::unique_ptr<JitCodeCache> code_cache_;
+  const size_t compile_threshold_;
+
+  JitSampleTable samples_;
+
+  // Guards the compilation thread pool and the statistics. Only taken when a method becomes hot,
+  // not for every sample. Ranked above the default level so that tasks can be queued while it is
+  // held.
+  Mutex lock_;
+  std::unique_ptr<ThreadPool> thread_pool_ GUARDED_BY(lock_);
+  size_t methods_compiled_ GUARDED_BY(lock_);
+  size_t methods_failed_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(Jit);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_H_
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jit_code_cache.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "mirror/art_method-inl.h"
+#include "oat.h"
+#include "utils.h"
+
+namespace art {
+namespace jit {
+
+constexpr size_t JitCodeCache::kMaxCapacity;
+constexpr size_t JitCodeCache::kDefaultCapacity;
+
+JitCodeCache* JitCodeCache::Create(size_t capacity, std::string* error_msg) {
+  CHECK_GT(capacity, 0U);
+  CHECK_LE(capacity, kMaxCapacity);
+  std::string error_str;
+  MemMap* data_mem_map =
+      MemMap::MapAnonymous("jit-data-cache", nullptr, RoundUp(capacity, 2 * kPageSize),
+                           PROT_READ | PROT_WRITE, false, &error_str);
+  if (data_mem_map == nullptr) {
+    std::ostringstream oss;
+    oss << "Failed to create the jit code cache: " << error_str << " size=" << capacity;
+    *error_msg = oss.str();
+    return nullptr;
+  }
+  // The data region is the first quarter of the map, the rest is remapped executable for code.
+  const size_t data_size = std::max(RoundUp(data_mem_map->Size() / 4, kPageSize),
+                                    static_cast<size_t>(kPageSize));
+  MemMap* code_mem_map = data_mem_map->RemapAtEnd(data_mem_map->Begin() + data_size,
+                                                  "jit-code-cache",
+                                                  PROT_READ | PROT_WRITE | PROT_EXEC,
+                                                  &error_str);
+  if (code_mem_map == nullptr) {
+    delete data_mem_map;
+    std::ostringstream oss;
+    oss << "Failed to split the jit code cache: " << error_str << " size=" << capacity;
+    *error_msg = oss.str();
+    return nullptr;
+  }
+  return new JitCodeCache(data_mem_map, code_mem_map);
+}
+
+JitCodeCache::JitCodeCache(MemMap* data_mem_map, MemMap* code_mem_map)
+    : lock_("Jit code cache lock", kJitCodeCacheLock),
+      data_mem_map_(data_mem_map), code_mem_map_(code_mem_map), num_methods_(0),
+      num_full_cache_failures_(0) {
+  data_cache_begin_ = data_mem_map_->Begin();
+  data_cache_end_ = data_mem_map_->End();
+  data_cache_ptr_ = data_cache_begin_;
+  code_cache_begin_ = code_mem_map_->Begin();
+  code_cache_end_ = code_mem_map_->End();
+  code_cache_ptr_ = code_cache_begin_;
+  DCHECK_LT(data_cache_end_, code_cache_end_);
+}
+
+bool JitCodeCache::ContainsMethod(mirror::ArtMethod* method) const {
+  return ContainsCodePtr(method->GetEntryPointFromQuickCompiledCode());
+}
+
+bool JitCodeCache::ContainsCodePtr(const void* ptr) const {
+  return ptr >= code_cache_begin_ && ptr < code_cache_end_;
+}
+
+uint8_t* JitCodeCache::AddDataArray(Thread* self, const uint8_t* begin, const uint8_t* end) {
+  MutexLock mu(self, lock_);
+  const size_t size = RoundUp(end - begin, sizeof(uint32_t));
+  if (size > DataCacheRemain()) {
+    ++num_full_cache_failures_;
+    VLOG(jit) << "JIT data cache full, cannot add " << size << " bytes, "
+              << DataCacheRemain() << " remaining";
+    return nullptr;
+  }
+  std::copy(begin, end, data_cache_ptr_);
+  uint8_t* result = data_cache_ptr_;
+  data_cache_ptr_ += size;
+  return result;
+}
+
+uint8_t* JitCodeCache::CommitCode(Thread* self, const uint8_t* mapping_table,
+                                  const uint8_t* vmap_table, size_t frame_size_in_bytes,
+                                  uint32_t core_spill_mask, uint32_t fp_spill_mask,
+                                  const uint8_t* code, size_t code_size, size_t alignment) {
+  DCHECK(IsPowerOfTwo(alignment));
+  MutexLock mu(self, lock_);
+  // The header immediately precedes the code, which needs the instruction set alignment.
+  uintptr_t code_start = RoundUp(reinterpret_cast<uintptr_t>(code_cache_ptr_) +
+                                 sizeof(OatQuickMethodHeader), alignment);
+  uint8_t* const code_ptr = reinterpret_cast<uint8_t*>(code_start);
+  if (code_ptr + code_size > code_cache_end_) {
+    ++num_full_cache_failures_;
+    VLOG(jit) << "JIT code cache full, cannot add " << code_size << " bytes of code, "
+              << CodeCacheRemain() << " remaining";
+    return nullptr;
+  }
+  // Tables are stored below the code, so the offsets fit the 32-bit header fields.
+  DCHECK(mapping_table == nullptr || mapping_table < code_ptr);
+  DCHECK(vmap_table == nullptr || vmap_table < code_ptr);
+  uint32_t mapping_table_offset =
+      (mapping_table == nullptr) ? 0u : static_cast<uint32_t>(code_ptr - mapping_table);
+  uint32_t vmap_table_offset =
+      (vmap_table == nullptr) ? 0u : static_cast<uint32_t>(code_ptr - vmap_table);
+  new (code_ptr - sizeof(OatQuickMethodHeader)) OatQuickMethodHeader(
+      mapping_table_offset, vmap_table_offset, frame_size_in_bytes, core_spill_mask,
+      fp_spill_mask, code_size);
+  std::copy(code, code + code_size, code_ptr);
+  __builtin___clear_cache(reinterpret_cast<char*>(code_ptr - sizeof(OatQuickMethodHeader)),
+                          reinterpret_cast<char*>(code_ptr + code_size));
+  code_cache_ptr_ = code_ptr + code_size;
+  ++num_methods_;
+  return code_ptr;
+}
+
+size_t JitCodeCache::NumFullCacheFailures(Thread* self) {
+  MutexLock mu(self, lock_);
+  return num_full_cache_failures_;
+}
+
+const void* JitCodeCache::GetCodeFor(mirror::ArtMethod* method) {
+  const void* code = method->GetEntryPointFromQuickCompiledCode();
+  if (ContainsCodePtr(code)) {
+    return code;
+  }
+  MutexLock mu(Thread::Current(), lock_);
+  auto it = method_code_map_.find(method);
+  if (it != method_code_map_.end()) {
+    return it->second;
+  }
+  return nullptr;
+}
+
+void JitCodeCache::SaveCompiledCode(mirror::ArtMethod* method, const void* entry_point) {
+  DCHECK(ContainsCodePtr(entry_point));
+  MutexLock mu(Thread::Current(), lock_);
+  method_code_map_.Overwrite(method, entry_point);
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
+#define ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "globals.h"
+#include "mem_map.h"
+#include "safe_map.h"
+
+namespace art {
+
+namespace mirror {
+  class ArtMethod;
+}  // namespace mirror
+
+class Thread;
+
+namespace jit {
+
+// Executable memory holding the code of JIT compiled methods. The cache is split into a data
+// region holding the mapping, vmap and GC maps, followed by a code region holding an
+// OatQuickMethodHeader and the code of each method. The data region is placed first so that the
+// header offsets, which are subtracted from the code pointer, are always positive.
+class JitCodeCache {
+ public:
+  static constexpr size_t kMaxCapacity = 1 * GB;
+  static constexpr size_t kDefaultCapacity = 2 * MB;
+
+  // Create the code cache with a code + data capacity equal to "capacity", error message is
+  // passed in the out arg error_msg.
+  static JitCodeCache* Create(size_t capacity, std::string* error_msg);
+
+  const uint8_t* CodeCachePtr() const {
+    return code_cache_ptr_;
+  }
+
+  size_t CodeCacheSize() const {
+    return code_cache_ptr_ - code_cache_begin_;
+  }
+
+  size_t CodeCacheRemain() const {
+    return code_cache_end_ - code_cache_ptr_;
+  }
+
+  size_t DataCacheSize() const {
+    return data_cache_ptr_ - data_cache_begin_;
+  }
+
+  size_t DataCacheRemain() const {
+    return data_cache_end_ - data_cache_ptr_;
+  }
+
+  size_t NumMethods() const {
+    return num_methods_;
+  }
+
+  // Number of methods that could not be added because the data or code region was full.
+  size_t NumFullCacheFailures(Thread* self) LOCKS_EXCLUDED(lock_);
+
+  // Return true if the code cache contains the code pointer which is the entrypoint of the
+  // method.
+  bool ContainsMethod(mirror::ArtMethod* method) const
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Return true if the code cache contains a code ptr.
+  bool ContainsCodePtr(const void* ptr) const;
+
+  // Copy a data array such as a mapping table into the data region. Returns nullptr if the data
+  // region is full.
+  uint8_t* AddDataArray(Thread* self, const uint8_t* begin, const uint8_t* end)
+      LOCKS_EXCLUDED(lock_);
+
+  // Write an OatQuickMethodHeader followed by the code into the code region and flush the
+  // instruction cache. The tables must live in the data region, a nullptr table is encoded as a
+  // zero offset. Returns the (unadjusted) code pointer, or nullptr if the code region is full.
+  uint8_t* CommitCode(Thread* self, const uint8_t* mapping_table, const uint8_t* vmap_table,
+                      size_t frame_size_in_bytes, uint32_t core_spill_mask,
+                      uint32_t fp_spill_mask, const uint8_t* code, size_t code_size,
+                      size_t alignment)
+      LOCKS_EXCLUDED(lock_);
+
+  // Get code for a method, returns null if it is not in the jit cache.
+  const void* GetCodeFor(mirror::ArtMethod* method)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) LOCKS_EXCLUDED(lock_);
+
+  // Record the entrypoint of a method compiled into the cache.
+  void SaveCompiledCode(mirror::ArtMethod* method, const void* entry_point)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) LOCKS_EXCLUDED(lock_);
+
+ private:
+  // Takes ownership of the memory maps.
+  JitCodeCache(MemMap* data_mem_map, MemMap* code_mem_map);
+
+  // Lock which guards the bump pointers and the method map. Ranked below the Jit's lock, which
+  // is held while the cache is queried for SIGQUIT.
+  mutable Mutex lock_;
+  // Mem map which holds the mapping, vmap and GC maps.
+  std::unique_ptr<MemMap> data_mem_map_;
+  // Mem map which holds method headers and code.
+  std::unique_ptr<MemMap> code_mem_map_;
+  // Bump pointers and limits of the two regions. The pointers only move forward under lock_, the
+  // size accessors read them without locking.
+  uint8_t* data_cache_begin_;
+  uint8_t* data_cache_end_;
+  uint8_t* data_cache_ptr_;
+  uint8_t* code_cache_begin_;
+  uint8_t* code_cache_end_;
+  uint8_t* code_cache_ptr_;
+  // Number of compiled methods.
+  size_t num_methods_;
+  size_t num_full_cache_failures_ GUARDED_BY(lock_);
+  // Entrypoints of the compiled methods. ArtMethods are allocated in the non-moving space so the
+  // raw pointers are stable keys.
+  SafeMap<mirror::ArtMethod*, const void*> method_code_map_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(JitCodeCache);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_CODE_CACHE_H_
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jit_code_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "mirror/art_method-inl.h"
+#include "mirror/class-inl.h"
+#include "oat.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+namespace jit {
+
+class JitCodeCacheTest : public CommonRuntimeTest {
+ public:
+  static const OatQuickMethodHeader* GetHeader(const uint8_t* code_ptr) {
+    return reinterpret_cast<const OatQuickMethodHeader*>(code_ptr) - 1;
+  }
+};
+
+TEST_F(JitCodeCacheTest, TestCoverage) {
+  std::string error_msg;
+  constexpr size_t kSize = 1 * MB;
+  std::unique_ptr<JitCodeCache> code_cache(JitCodeCache::Create(kSize, &error_msg));
+  ASSERT_TRUE(code_cache.get() != nullptr) << error_msg;
+  Thread* self = Thread::Current();
+  EXPECT_EQ(code_cache->NumMethods(), 0U);
+  EXPECT_EQ(code_cache->CodeCacheSize(), 0U);
+  EXPECT_EQ(code_cache->DataCacheSize(), 0U);
+  EXPECT_GT(code_cache->CodeCacheRemain(), code_cache->DataCacheRemain());
+
+  const std::vector<uint8_t> mapping_table = { 1, 2, 3 };
+  const std::vector<uint8_t> vmap_table = { 4, 5, 6, 7, 8 };
+  uint8_t* mapping_table_ptr = code_cache->AddDataArray(
+      self, mapping_table.data(), mapping_table.data() + mapping_table.size());
+  uint8_t* vmap_table_ptr = code_cache->AddDataArray(
+      self, vmap_table.data(), vmap_table.data() + vmap_table.size());
+  ASSERT_TRUE(mapping_table_ptr != nullptr);
+  ASSERT_TRUE(vmap_table_ptr != nullptr);
+  EXPECT_FALSE(code_cache->ContainsCodePtr(mapping_table_ptr));
+  EXPECT_TRUE(std::equal(mapping_table.begin(), mapping_table.end(), mapping_table_ptr));
+  EXPECT_TRUE(std::equal(vmap_table.begin(), vmap_table.end(), vmap_table_ptr));
+  // Data arrays are kept 4-byte aligned.
+  EXPECT_EQ(code_cache->DataCacheSize(), 4U + 8U);
+
+  const std::vector<uint8_t> code = { 0xc3, 0x90, 0x90 };
+  const size_t alignment = 16;
+  uint8_t* code_ptr = code_cache->CommitCode(self, mapping_table_ptr, vmap_table_ptr, 64u,
+                                             0x3u, 0x0u, code.data(), code.size(), alignment);
+  ASSERT_TRUE(code_ptr != nullptr);
+  EXPECT_TRUE(code_cache->ContainsCodePtr(code_ptr));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(code_ptr) % alignment, 0U);
+  EXPECT_TRUE(std::equal(code.begin(), code.end(), code_ptr));
+  EXPECT_EQ(code_cache->NumMethods(), 1U);
+
+  // The header decodes back to the tables in the data region.
+  const OatQuickMethodHeader* header = GetHeader(code_ptr);
+  EXPECT_EQ(code_ptr - header->mapping_table_offset_, mapping_table_ptr);
+  EXPECT_EQ(code_ptr - header->vmap_table_offset_, vmap_table_ptr);
+  EXPECT_EQ(header->frame_info_.FrameSizeInBytes(), 64U);
+  EXPECT_EQ(header->frame_info_.CoreSpillMask(), 0x3U);
+  EXPECT_EQ(header->code_size_, code.size());
+
+  // Missing tables are encoded as zero offsets.
+  uint8_t* code_ptr2 = code_cache->CommitCode(self, nullptr, nullptr, 16u, 0u, 0u, code.data(),
+                                              code.size(), alignment);
+  ASSERT_TRUE(code_ptr2 != nullptr);
+  EXPECT_GT(code_ptr2, code_ptr);
+  EXPECT_EQ(GetHeader(code_ptr2)->mapping_table_offset_, 0U);
+  EXPECT_EQ(GetHeader(code_ptr2)->vmap_table_offset_, 0U);
+  EXPECT_EQ(code_cache->NumMethods(), 2U);
+}
+
+TEST_F(JitCodeCacheTest, TestOverflow) {
+  std::string error_msg;
+  constexpr size_t kSize = 1 * MB;
+  std::unique_ptr<JitCodeCache> code_cache(JitCodeCache::Create(kSize, &error_msg));
+  ASSERT_TRUE(code_cache.get() != nullptr) << error_msg;
+  Thread* self = Thread::Current();
+  std::vector<uint8_t> data(code_cache->DataCacheRemain() + 1);
+  EXPECT_TRUE(code_cache->AddDataArray(self, data.data(), data.data() + data.size()) == nullptr);
+  EXPECT_EQ(code_cache->DataCacheSize(), 0U);
+  std::vector<uint8_t> code(code_cache->CodeCacheRemain());
+  EXPECT_TRUE(code_cache->CommitCode(self, nullptr, nullptr, 16u, 0u, 0u, code.data(),
+                                     code.size(), 16u) == nullptr);
+  EXPECT_EQ(code_cache->CodeCacheSize(), 0U);
+  EXPECT_EQ(code_cache->NumMethods(), 0U);
+}
+
+TEST_F(JitCodeCacheTest, TestSaveCompiledCode) {
+  std::string error_msg;
+  std::unique_ptr<JitCodeCache> code_cache(
+      JitCodeCache::Create(JitCodeCache::kDefaultCapacity, &error_msg));
+  ASSERT_TRUE(code_cache.get() != nullptr) << error_msg;
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::Class* klass = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  ASSERT_TRUE(klass != nullptr);
+  mirror::ArtMethod* method = klass->GetVirtualMethod(0);
+  EXPECT_FALSE(code_cache->ContainsMethod(method));
+  EXPECT_TRUE(code_cache->GetCodeFor(method) == nullptr);
+  const std::vector<uint8_t> code = { 0xc3 };
+  uint8_t* code_ptr = code_cache->CommitCode(soa.Self(), nullptr, nullptr, 16u, 0u, 0u,
+                                             code.data(), code.size(), 16u);
+  ASSERT_TRUE(code_ptr != nullptr);
+  code_cache->SaveCompiledCode(method, code_ptr);
+  EXPECT_EQ(code_cache->GetCodeFor(method), code_ptr);
+  // The entrypoint itself was not touched.
+  EXPECT_FALSE(code_cache->ContainsMethod(method));
+}
+
+}  // namespace jit
+}  // namespace art
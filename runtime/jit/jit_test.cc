@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit.h"
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "gtest/gtest.h"
+
+namespace art {
+namespace jit {
+
+// The table never dereferences its keys, so fake aligned addresses stand in for methods.
+static mirror::ArtMethod* FakeMethod(uintptr_t i) {
+  return reinterpret_cast<mirror::ArtMethod*>((i + 1) * kObjectAlignment);
+}
+
+TEST(JitSampleTable, CrossingTheThresholdQueuesOnce) {
+  JitSampleTable table(10, 16);
+  mirror::ArtMethod* method = FakeMethod(0);
+  EXPECT_EQ(0U, table.GetSamples(method));
+  for (size_t i = 0; i < 9; ++i) {
+    EXPECT_FALSE(table.AddSamples(method, 1, true));
+  }
+  EXPECT_EQ(9U, table.GetSamples(method));
+  EXPECT_TRUE(table.AddSamples(method, 1, true));
+  EXPECT_EQ(10U, table.GetSamples(method));
+  // Once queued, the method is never reported again.
+  EXPECT_FALSE(table.AddSamples(method, 1, true));
+  EXPECT_FALSE(table.AddSamples(method, 100, true));
+  EXPECT_EQ(10U, table.GetSamples(method));
+  // Other methods are counted separately.
+  EXPECT_EQ(0U, table.GetSamples(FakeMethod(1)));
+}
+
+TEST(JitSampleTable, LargeCountsSaturate) {
+  JitSampleTable table(10, 16);
+  mirror::ArtMethod* method = FakeMethod(0);
+  EXPECT_FALSE(table.AddSamples(method, 5, true));
+  EXPECT_TRUE(table.AddSamples(method, std::numeric_limits<size_t>::max(), true));
+  EXPECT_EQ(10U, table.GetSamples(method));
+}
+
+TEST(JitSampleTable, WaitsForClassInitialization) {
+  JitSampleTable table(10, 16);
+  mirror::ArtMethod* method = FakeMethod(0);
+  for (size_t i = 0; i < 20; ++i) {
+    EXPECT_FALSE(table.AddSamples(method, 1, false));
+  }
+  // Hot, but held just below the threshold until it may be compiled.
+  EXPECT_EQ(9U, table.GetSamples(method));
+  EXPECT_TRUE(table.AddSamples(method, 1, true));
+  EXPECT_FALSE(table.AddSamples(method, 1, true));
+}
+
+TEST(JitSampleTable, Full) {
+  JitSampleTable table(2, 4);
+  for (uintptr_t i = 0; i < 4; ++i) {
+    EXPECT_FALSE(table.AddSamples(FakeMethod(i), 1, true));
+  }
+  // No slot is left, the method is not sampled.
+  mirror::ArtMethod* method = FakeMethod(4);
+  EXPECT_FALSE(table.AddSamples(method, 2, true));
+  EXPECT_EQ(0U, table.GetSamples(method));
+  // Methods that already have a slot still reach the threshold.
+  for (uintptr_t i = 0; i < 4; ++i) {
+    EXPECT_TRUE(table.AddSamples(FakeMethod(i), 1, true));
+  }
+}
+
+static constexpr size_t kNumThreads = 4;
+static constexpr size_t kNumMethods = 64;
+static constexpr size_t kThreshold = 1000;
+
+struct SampleArgs {
+  JitSampleTable* table;
+  size_t queued[kNumMethods];
+};
+
+static void* SampleLoop(void* arg) {
+  SampleArgs* args = reinterpret_cast<SampleArgs*>(arg);
+  for (size_t round = 0; round < kThreshold; ++round) {
+    for (size_t i = 0; i < kNumMethods; ++i) {
+      if (args->table->AddSamples(FakeMethod(i), 1, true)) {
+        ++args->queued[i];
+      }
+    }
+  }
+  return nullptr;
+}
+
+// Threads racing to claim slots and bump counters must queue every method exactly once.
+TEST(JitSampleTable, Concurrent) {
+  JitSampleTable table(kThreshold, 128);
+  SampleArgs args[kNumThreads];
+  pthread_t threads[kNumThreads];
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    args[i].table = &table;
+    std::fill_n(args[i].queued, kNumMethods, 0u);
+    ASSERT_EQ(0, pthread_create(&threads[i], nullptr, SampleLoop, &args[i]));
+  }
+  size_t queued[kNumMethods] = {};
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    ASSERT_EQ(0, pthread_join(threads[i], nullptr));
+    for (size_t j = 0; j < kNumMethods; ++j) {
+      queued[j] += args[i].queued[j];
+    }
+  }
+  for (size_t j = 0; j < kNumMethods; ++j) {
+    EXPECT_EQ(1U, queued[j]) << j;
+    EXPECT_EQ(kThreshold, table.GetSamples(FakeMethod(j)));
+  }
+}
+
+}  // namespace jit
+}  // namespace art
@@ -124,6 +124,25 @@ static void ReportInvalidJNINativeMethod(const ScopedObjectAccess& soa, mirror::
                                  "%s is null at index %d", kind, idx);
 }
 
+// Whether m may be registered as a critical native. The method must be static, unsynchronized
+// and take and return only primitives, and it must be reached through a compiled JNI stub since
+// only those check kAccCriticalNative.
+static bool CanBeCriticalNative(mirror::ArtMethod* m)
+    SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+  if (!m->IsStatic() || m->IsSynchronized() || m->IsPortableCompiled()) {
+    return false;
+  }
+  if (strchr(m->GetShorty(), 'L') != nullptr) {
+    return false;
+  }
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  const void* code = m->GetEntryPointFromQuickCompiledCode();
+  if (code == class_linker->GetQuickResolutionTrampoline()) {
+    code = class_linker->GetQuickOatCodeFor(m);
+  }
+  return code != class_linker->GetQuickGenericJniTrampoline();
+}
+
 static mirror::Class* EnsureInitialized(Thread* self, mirror::Class* klass)
     SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
   if (LIKELY(klass->IsInitialized())) {
@@ -2412,9 +2431,13 @@ class JNI {
         return JNI_ERR;
       }
       bool is_fast = false;
+      bool is_critical = false;
       if (*sig == '!') {
         is_fast = true;
         ++sig;
+      } else if (*sig == '#') {
+        is_critical = true;
+        ++sig;
       }
 
       mirror::ArtMethod* m = c->FindDirectMethod(name, sig);
@@ -2434,11 +2457,17 @@ class JNI {
             << " as native";
         ThrowNoSuchMethodError(soa, c, name, sig, "native");
         return JNI_ERR;
+      } else if (is_critical && !CanBeCriticalNative(m)) {
+        LOG(return_errors ? ERROR : FATAL) << "Failed to register native method "
+            << PrettyDescriptor(c) << "." << name << sig
+            << " as critical native";
+        ThrowNoSuchMethodError(soa, c, name, sig, "critical native");
+        return JNI_ERR;
       }
 
       VLOG(jni) << "[Registering JNI native method " << PrettyMethod(m) << "]";
 
-      m->RegisterNative(soa.Self(), fnPtr, is_fast);
+      m->RegisterNative(soa.Self(), fnPtr, is_fast, is_critical);
     }
     return JNI_OK;
   }
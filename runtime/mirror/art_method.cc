@@ -354,21 +354,29 @@ void ArtMethod::Invoke(Thread* self, uint32_t* args, uint32_t args_size, JValue*
   self->PopManagedStackFragment(fragment);
 }
 
-void ArtMethod::RegisterNative(Thread* self, const void* native_method, bool is_fast) {
+void ArtMethod::RegisterNative(Thread* self, const void* native_method, bool is_fast,
+                               bool is_critical) {
   DCHECK(Thread::Current() == self);
   CHECK(IsNative()) << PrettyMethod(this);
   CHECK(!IsFastNative()) << PrettyMethod(this);
   CHECK(native_method != NULL) << PrettyMethod(this);
+  CHECK(!(is_fast && is_critical)) << PrettyMethod(this);
   if (is_fast) {
     SetAccessFlags(GetAccessFlags() | kAccFastNative);
   }
+  // The compiled JNI stub picks the calling convention from this flag on every call.
+  if (is_critical) {
+    SetAccessFlags(GetAccessFlags() | kAccCriticalNative);
+  } else {
+    SetAccessFlags(GetAccessFlags() & ~kAccCriticalNative);
+  }
   SetNativeMethod(native_method);
 }
 
 void ArtMethod::UnregisterNative(Thread* self) {
   CHECK(IsNative() && !IsFastNative()) << PrettyMethod(this);
   // restore stub to lookup native pointer via dlsym
-  RegisterNative(self, GetJniDlsymLookupStub(), false);
+  RegisterNative(self, GetJniDlsymLookupStub(), false, false);
 }
 
 }  // namespace mirror
@@ -64,6 +64,10 @@ class MANAGED ArtMethod FINAL : public Object {
     return MemberOffset(OFFSETOF_MEMBER(ArtMethod, declaring_class_));
   }
 
+  static MemberOffset AccessFlagsOffset() {
+    return OFFSET_OF_OBJECT_MEMBER(ArtMethod, access_flags_);
+  }
+
   uint32_t GetAccessFlags() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
   void SetAccessFlags(uint32_t new_access_flags) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
@@ -131,6 +135,14 @@ class MANAGED ArtMethod FINAL : public Object {
     return (GetAccessFlags() & mask) == mask;
   }
 
+  // A critical native is called by its compiled JNI stub without a JNIEnv*, a jclass or a
+  // thread state transition. Only static, unsynchronized methods with primitive arguments and
+  // return type may be registered as such.
+  bool IsCriticalNative() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    uint32_t mask = kAccCriticalNative | kAccNative;
+    return (GetAccessFlags() & mask) == mask;
+  }
+
   bool IsAbstract() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
     return (GetAccessFlags() & kAccAbstract) != 0;
   }
@@ -362,7 +374,7 @@ class MANAGED ArtMethod FINAL : public Object {
     return kPointerSize;
   }
 
-  void RegisterNative(Thread* self, const void* native_method, bool is_fast)
+  void RegisterNative(Thread* self, const void* native_method, bool is_fast, bool is_critical)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
   void UnregisterNative(Thread* self) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
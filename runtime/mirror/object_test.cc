@@ -82,6 +82,11 @@ TEST_F(ObjectTest, AsmConstants) {
 
   EXPECT_EQ(ARRAY_LENGTH_OFFSET, Array::LengthOffset().Int32Value());
   EXPECT_EQ(OBJECT_ARRAY_DATA_OFFSET, Array::DataOffset(sizeof(HeapReference<Object>)).Int32Value());
+  // Arrays of booleans, bytes, chars, shorts and ints share the same data offset.
+  EXPECT_EQ(INT_ARRAY_DATA_OFFSET, Array::DataOffset(sizeof(uint8_t)).Int32Value());
+  EXPECT_EQ(INT_ARRAY_DATA_OFFSET, Array::DataOffset(sizeof(uint16_t)).Int32Value());
+  EXPECT_EQ(INT_ARRAY_DATA_OFFSET, Array::DataOffset(sizeof(int32_t)).Int32Value());
+  EXPECT_EQ(LONG_ARRAY_DATA_OFFSET, Array::DataOffset(sizeof(int64_t)).Int32Value());
 
   EXPECT_EQ(STRING_VALUE_OFFSET, String::ValueOffset().Int32Value());
   EXPECT_EQ(STRING_COUNT_OFFSET, String::CountOffset().Int32Value());
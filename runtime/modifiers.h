@@ -56,6 +56,7 @@ static const uint32_t kAccClassIsReference          = 0x08000000;  // class is a
 static const uint32_t kAccClassIsWeakReference      = 0x04000000;  // class is a weak reference
 static const uint32_t kAccClassIsFinalizerReference = 0x02000000;  // class is a finalizer reference
 static const uint32_t kAccClassIsPhantomReference   = 0x01000000;  // class is a phantom reference
+static const uint32_t kAccCriticalNative            = 0x00200000;  // method is a critical native
 
 static const uint32_t kAccReferenceFlagsMask = (kAccClassIsReference
                                                 | kAccClassIsWeakReference
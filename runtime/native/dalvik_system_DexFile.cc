@@ -391,7 +391,10 @@ static jboolean IsDexOptNeededInternal(JNIEnv* env, const char* filename,
         std::set<std::string> new_top_k, old_top_k;
         new_profile.GetTopKSamples(new_top_k, top_k_threshold);
         old_profile.GetTopKSamples(old_top_k, top_k_threshold);
-        if (new_top_k.empty()) {
+        std::set<std::pair<uint32_t, uint32_t>> new_binary_top_k, old_binary_top_k;
+        new_profile.GetTopKSamples(&new_binary_top_k, top_k_threshold);
+        old_profile.GetTopKSamples(&old_binary_top_k, top_k_threshold);
+        if (new_top_k.empty() && new_binary_top_k.empty()) {
           if (kVerboseLogging) {
             LOG(INFO) << "DexFile_isDexOptNeeded empty profile: " << profile_file;
           }
@@ -400,8 +403,13 @@ static jboolean IsDexOptNeededInternal(JNIEnv* env, const char* filename,
           std::set<std::string> diff;
           std::set_difference(new_top_k.begin(), new_top_k.end(), old_top_k.begin(), old_top_k.end(),
             std::inserter(diff, diff.end()));
+          std::set<std::pair<uint32_t, uint32_t>> binary_diff;
+          std::set_difference(new_binary_top_k.begin(), new_binary_top_k.end(),
+                              old_binary_top_k.begin(), old_binary_top_k.end(),
+                              std::inserter(binary_diff, binary_diff.end()));
           // TODO: consider using the usedPercentage instead of the plain diff count.
-          change_percent = 100.0 * static_cast<double>(diff.size()) / static_cast<double>(new_top_k.size());
+          change_percent = 100.0 * static_cast<double>(diff.size() + binary_diff.size()) /
+              static_cast<double>(new_top_k.size() + new_binary_top_k.size());
           if (kVerboseLogging) {
             std::set<std::string>::iterator end = diff.end();
             for (std::set<std::string>::iterator it = diff.begin(); it != end; it++) {
@@ -187,8 +187,9 @@ static jlong VMDebug_threadCpuTimeNanos(JNIEnv*, jclass) {
 /*
  * static void dumpHprofData(String fileName, FileDescriptor fd)
  *
- * Cause "hprof" data to be dumped.  We can throw an IOException if an
- * error occurs during file handling.
+ * Cause "hprof" data to be dumped, gzip compressed if the runtime was started
+ * with -XX:CompressHeapDumps.  We can throw an IOException if an error occurs
+ * during file handling.
  */
 static void VMDebug_dumpHprofData(JNIEnv* env, jclass, jstring javaFilename, jobject javaFd) {
   // Only one of these may be NULL.
@@ -219,11 +220,11 @@ static void VMDebug_dumpHprofData(JNIEnv* env, jclass, jstring javaFilename, job
     }
   }
 
-  hprof::DumpHeap(filename.c_str(), fd, false);
+  hprof::DumpHeap(filename.c_str(), fd, false, Runtime::Current()->CompressHeapDumps());
 }
 
 static void VMDebug_dumpHprofDataDdms(JNIEnv*, jclass) {
-  hprof::DumpHeap("[DDMS]", -1, true);
+  hprof::DumpHeap("[DDMS]", -1, true, false);
 }
 
 static void VMDebug_dumpReferenceTables(JNIEnv* env, jclass) {
@@ -23,6 +23,8 @@
 #include "base/stringpiece.h"
 #include "debugger.h"
 #include "gc/heap.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
 #include "monitor.h"
 #include "runtime.h"
 #include "trace.h"
@@ -111,7 +113,7 @@ static gc::CollectorType ParseCollectorType(const std::string& option) {
     return gc::kCollectorTypeCMS;
   } else if (option == "SS") {
     return gc::kCollectorTypeSS;
-  } else if (option == "GSS") {
+  } else if (option == "GSS" || option == "generational") {
     return gc::kCollectorTypeGSS;
   } else if (option == "CC") {
     return gc::kCollectorTypeCC;
@@ -189,6 +191,7 @@ bool ParsedOptions::Parse(const RuntimeOptions& options, bool ignore_unrecognize
   parallel_gc_threads_ = sysconf(_SC_NPROCESSORS_CONF) - 1;
   // Only the main GC thread, no workers.
   conc_gc_threads_ = 0;
+  promotion_age_ = gc::Heap::kDefaultPromotionAge;
   // The default GC type is set in makefiles.
 #if ART_DEFAULT_GC_TYPE_IS_CMS
   collector_type_ = gc::kCollectorTypeCMS;
@@ -234,6 +237,7 @@ bool ParsedOptions::Parse(const RuntimeOptions& options, bool ignore_unrecognize
   long_pause_log_threshold_ = gc::Heap::kDefaultLongPauseLogThreshold;
   long_gc_log_threshold_ = gc::Heap::kDefaultLongGCLogThreshold;
   dump_gc_performance_on_shutdown_ = false;
+  compress_heap_dumps_ = false;
   ignore_max_footprint_ = false;
 
   lock_profiling_threshold_ = 0;
@@ -248,6 +252,7 @@ bool ParsedOptions::Parse(const RuntimeOptions& options, bool ignore_unrecognize
 //  gLogVerbosity.gc = true;  // TODO: don't check this in!
 //  gLogVerbosity.heap = true;  // TODO: don't check this in!
 //  gLogVerbosity.jdwp = true;  // TODO: don't check this in!
+//  gLogVerbosity.jit = true;  // TODO: don't check this in!
 //  gLogVerbosity.jni = true;  // TODO: don't check this in!
 //  gLogVerbosity.monitor = true;  // TODO: don't check this in!
 //  gLogVerbosity.profiler = true;  // TODO: don't check this in!
@@ -263,6 +268,10 @@ bool ParsedOptions::Parse(const RuntimeOptions& options, bool ignore_unrecognize
 
   profile_clock_source_ = kDefaultTraceClockSource;
 
+  use_jit_ = false;
+  jit_code_cache_capacity_ = jit::JitCodeCache::kDefaultCapacity;
+  jit_compile_threshold_ = jit::Jit::kDefaultCompileThreshold;
+
   verify_ = true;
   image_isa_ = kRuntimeISA;
 
@@ -362,6 +371,14 @@ bool ParsedOptions::Parse(const RuntimeOptions& options, bool ignore_unrecognize
       if (!ParseUnsignedInteger(option, '=', &conc_gc_threads_)) {
         return false;
       }
+    } else if (StartsWith(option, "-XX:PromotionAge=")) {
+      if (!ParseUnsignedInteger(option, '=', &promotion_age_)) {
+        return false;
+      }
+      if (promotion_age_ < 1 || promotion_age_ > gc::Heap::kMaxPromotionAge) {
+        Usage("-XX:PromotionAge must be between 1 and %zu\n", gc::Heap::kMaxPromotionAge);
+        return false;
+      }
     } else if (StartsWith(option, "-Xss")) {
       size_t size = ParseMemoryOption(option.substr(strlen("-Xss")).c_str(), 1);
       if (size == 0) {
@@ -387,6 +404,8 @@ bool ParsedOptions::Parse(const RuntimeOptions& options, bool ignore_unrecognize
       long_gc_log_threshold_ = MsToNs(value);
     } else if (option == "-XX:DumpGCPerformanceOnShutdown") {
       dump_gc_performance_on_shutdown_ = true;
+    } else if (option == "-XX:CompressHeapDumps") {
+      compress_heap_dumps_ = true;
     } else if (option == "-XX:IgnoreMaxFootprint") {
       ignore_max_footprint_ = true;
     } else if (option == "-XX:LowMemoryMode") {
@@ -457,6 +476,8 @@ bool ParsedOptions::Parse(const RuntimeOptions& options, bool ignore_unrecognize
           gLogVerbosity.heap = true;
         } else if (verbose_options[i] == "jdwp") {
           gLogVerbosity.jdwp = true;
+        } else if (verbose_options[i] == "jit") {
+          gLogVerbosity.jit = true;
         } else if (verbose_options[i] == "jni") {
           gLogVerbosity.jni = true;
         } else if (verbose_options[i] == "monitor") {
@@ -528,6 +549,25 @@ bool ParsedOptions::Parse(const RuntimeOptions& options, bool ignore_unrecognize
       Trace::SetDefaultClockSource(kTraceClockSourceWall);
     } else if (option == "-Xprofile:dualclock") {
       Trace::SetDefaultClockSource(kTraceClockSourceDual);
+    } else if (option == "-Xusejit:true") {
+      use_jit_ = true;
+    } else if (option == "-Xusejit:false") {
+      use_jit_ = false;
+    } else if (StartsWith(option, "-Xjitcodecachesize:")) {
+      size_t size = ParseMemoryOption(option.substr(strlen("-Xjitcodecachesize:")).c_str(), 1024);
+      if (size == 0 || size > jit::JitCodeCache::kMaxCapacity) {
+        Usage("Failed to parse memory option %s\n", option.c_str());
+        return false;
+      }
+      jit_code_cache_capacity_ = size;
+    } else if (StartsWith(option, "-Xjitthreshold:")) {
+      if (!ParseUnsignedInteger(option, ':', &jit_compile_threshold_)) {
+        return false;
+      }
+      if (jit_compile_threshold_ == 0) {
+        Usage("-Xjitthreshold must be greater than zero\n");
+        return false;
+      }
     } else if (option == "-Xenable-profiler") {
       profiler_options_.enabled_ = true;
     } else if (StartsWith(option, "-Xprofile-filename:")) {
@@ -564,6 +604,8 @@ bool ParsedOptions::Parse(const RuntimeOptions& options, bool ignore_unrecognize
       profiler_options_.profile_type_ = kProfilerMethod;
     } else if (option == "-Xprofile-type:stack") {
       profiler_options_.profile_type_ = kProfilerBoundedStack;
+    } else if (option == "-Xprofile-type:binary") {
+      profiler_options_.profile_type_ = kProfilerBinaryMethod;
     } else if (StartsWith(option, "-Xprofile-max-stack-depth:")) {
       if (!ParseUnsignedInteger(option, ':', &profiler_options_.max_stack_depth_)) {
         return false;
@@ -669,6 +711,19 @@ bool ParsedOptions::Parse(const RuntimeOptions& options, bool ignore_unrecognize
   if (background_collector_type_ == gc::kCollectorTypeNone) {
     background_collector_type_ = collector_type_;
   }
+  if (collector_type_ == gc::kCollectorTypeCC ||
+      background_collector_type_ == gc::kCollectorTypeCC) {
+    // The concurrent copying collector needs every reference load to go through the read barrier.
+    // Neither the compilers nor the JIT emit read barriers, so only the interpreter is safe.
+    if (!kUseBakerReadBarrier) {
+      Usage("Concurrent copying GC requires a runtime built with USE_BAKER_READ_BARRIER\n");
+      return false;
+    }
+    if (!interpreter_only_) {
+      Usage("Concurrent copying GC requires -Xint, compiled code does not emit read barriers\n");
+      return false;
+    }
+  }
   return true;
 }  // NOLINT(readability/fn_size)
 
@@ -748,16 +803,21 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -Ximage:filename\n");
   UsageMessage(stream, "  -XX:ParallelGCThreads=integervalue\n");
   UsageMessage(stream, "  -XX:ConcGCThreads=integervalue\n");
+  UsageMessage(stream, "  -XX:PromotionAge=integervalue\n");
   UsageMessage(stream, "  -XX:MaxSpinsBeforeThinLockInflation=integervalue\n");
   UsageMessage(stream, "  -XX:LongPauseLogThreshold=integervalue\n");
   UsageMessage(stream, "  -XX:LongGCLogThreshold=integervalue\n");
   UsageMessage(stream, "  -XX:DumpGCPerformanceOnShutdown\n");
+  UsageMessage(stream, "  -XX:CompressHeapDumps\n");
   UsageMessage(stream, "  -XX:IgnoreMaxFootprint\n");
   UsageMessage(stream, "  -XX:UseTLAB\n");
   UsageMessage(stream, "  -XX:BackgroundGC=none\n");
   UsageMessage(stream, "  -Xmethod-trace\n");
   UsageMessage(stream, "  -Xmethod-trace-file:filename");
   UsageMessage(stream, "  -Xmethod-trace-file-size:integervalue\n");
+  UsageMessage(stream, "  -Xusejit:booleanvalue\n");
+  UsageMessage(stream, "  -Xjitcodecachesize:N\n");
+  UsageMessage(stream, "  -Xjitthreshold:integervalue\n");
   UsageMessage(stream, "  -Xenable-profiler\n");
   UsageMessage(stream, "  -Xprofile-filename:filename\n");
   UsageMessage(stream, "  -Xprofile-period:integervalue\n");
@@ -767,7 +827,7 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -Xprofile-start-immediately\n");
   UsageMessage(stream, "  -Xprofile-top-k-threshold:doublevalue\n");
   UsageMessage(stream, "  -Xprofile-top-k-change-threshold:doublevalue\n");
-  UsageMessage(stream, "  -Xprofile-type:{method,stack}\n");
+  UsageMessage(stream, "  -Xprofile-type:{method,stack,binary}\n");
   UsageMessage(stream, "  -Xprofile-max-stack-depth:integervalue\n");
   UsageMessage(stream, "  -Xcompiler:filename\n");
   UsageMessage(stream, "  -Xcompiler-option dex2oat-option\n");
@@ -64,6 +64,7 @@ class ParsedOptions {
   unsigned int long_pause_log_threshold_;
   unsigned int long_gc_log_threshold_;
   bool dump_gc_performance_on_shutdown_;
+  bool compress_heap_dumps_;
   bool ignore_max_footprint_;
   size_t heap_initial_size_;
   size_t heap_maximum_size_;
@@ -74,6 +75,7 @@ class ParsedOptions {
   double foreground_heap_growth_multiplier_;
   unsigned int parallel_gc_threads_;
   unsigned int conc_gc_threads_;
+  unsigned int promotion_age_;
   gc::CollectorType collector_type_;
   gc::CollectorType background_collector_type_;
   size_t stack_size_;
@@ -92,6 +94,9 @@ class ParsedOptions {
   std::string compiler_executable_;
   std::vector<std::string> compiler_options_;
   std::vector<std::string> image_compiler_options_;
+  bool use_jit_;
+  size_t jit_code_cache_capacity_;
+  unsigned int jit_compile_threshold_;
   ProfilerOptions profiler_options_;
   std::string profile_output_filename_;
   TraceClockSource profile_clock_source_;
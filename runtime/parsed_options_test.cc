@@ -48,6 +48,8 @@ TEST_F(ParsedOptionsTest, ParsedOptions) {
   options.push_back(std::make_pair("-Xmx4k", null));
   options.push_back(std::make_pair("-Xss1m", null));
   options.push_back(std::make_pair("-XX:HeapTargetUtilization=0.75", null));
+  options.push_back(std::make_pair("-XX:PromotionAge=3", null));
+  options.push_back(std::make_pair("-Xgc:generational", null));
   options.push_back(std::make_pair("-Dfoo=bar", null));
   options.push_back(std::make_pair("-Dbaz=qux", null));
   options.push_back(std::make_pair("-verbose:gc,class,jni", null));
@@ -65,6 +67,8 @@ TEST_F(ParsedOptionsTest, ParsedOptions) {
   EXPECT_EQ(4 * KB, parsed->heap_maximum_size_);
   EXPECT_EQ(1 * MB, parsed->stack_size_);
   EXPECT_EQ(0.75, parsed->heap_target_utilization_);
+  EXPECT_EQ(3U, parsed->promotion_age_);
+  EXPECT_EQ(gc::kCollectorTypeGSS, parsed->collector_type_);
   EXPECT_TRUE(test_vfprintf == parsed->hook_vfprintf_);
   EXPECT_TRUE(test_exit == parsed->hook_exit_);
   EXPECT_TRUE(test_abort == parsed->hook_abort_);
@@ -83,4 +87,34 @@ TEST_F(ParsedOptionsTest, ParsedOptions) {
   EXPECT_EQ("baz=qux", parsed->properties_[1]);
 }
 
+TEST_F(ParsedOptionsTest, ConcurrentCopyingRequiresInterpreter) {
+  void* null = reinterpret_cast<void*>(NULL);
+  {
+    // Compiled code does not emit read barriers, so concurrent copying is refused without -Xint.
+    RuntimeOptions options;
+    options.push_back(std::make_pair("-Xgc:CC", null));
+    std::unique_ptr<ParsedOptions> parsed(ParsedOptions::Create(options, false));
+    EXPECT_TRUE(parsed.get() == NULL);
+  }
+  {
+    RuntimeOptions options;
+    options.push_back(std::make_pair("-XX:BackgroundGC=CC", null));
+    std::unique_ptr<ParsedOptions> parsed(ParsedOptions::Create(options, false));
+    EXPECT_TRUE(parsed.get() == NULL);
+  }
+  {
+    RuntimeOptions options;
+    options.push_back(std::make_pair("-Xgc:CC", null));
+    options.push_back(std::make_pair("-Xint", null));
+    std::unique_ptr<ParsedOptions> parsed(ParsedOptions::Create(options, false));
+    if (kUseBakerReadBarrier) {
+      ASSERT_TRUE(parsed.get() != NULL);
+      EXPECT_EQ(gc::kCollectorTypeCC, parsed->collector_type_);
+      EXPECT_TRUE(parsed->interpreter_only_);
+    } else {
+      EXPECT_TRUE(parsed.get() == NULL);
+    }
+  }
+}
+
 }  // namespace art
@@ -16,7 +16,10 @@
 
 #include "profiler.h"
 
+#include <algorithm>
 #include <fstream>
+#include <limits>
+#include <tuple>
 #include <sys/uio.h>
 #include <sys/file.h>
 
@@ -27,6 +30,7 @@
 #include "debugger.h"
 #include "dex_file-inl.h"
 #include "instrumentation.h"
+#include "interpreter/inline_cache.h"
 #include "mirror/art_method-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/dex_cache.h"
@@ -93,7 +97,8 @@ static void GetSample(Thread* thread, void* arg) SHARED_LOCKS_REQUIRED(Locks::mu
       reinterpret_cast<BackgroundMethodSamplingProfiler*>(arg);
   const ProfilerOptions profile_options = profiler->GetProfilerOptions();
   switch (profile_options.GetProfileType()) {
-    case kProfilerMethod: {
+    case kProfilerMethod:
+    case kProfilerBinaryMethod: {
       mirror::ArtMethod* method = thread->GetCurrentMethod(nullptr);
       if (false && method == nullptr) {
         LOG(INFO) << "No current method available";
@@ -574,9 +579,38 @@ uint32_t ProfileSampleResults::Write(std::ostream& os, ProfileDataType type) {
 
   VLOG(profiler) << "Profile: "
                  << num_samples_ << "/" << num_null_methods_ << "/" << num_boot_methods_;
-  os << num_samples_ << "/" << num_null_methods_ << "/" << num_boot_methods_ << "\n";
   uint32_t num_methods = 0;
-  if (type == kProfilerMethod) {
+  if (type != kProfilerBinaryMethod) {
+    // The binary format carries the summary itself and must start with its magic.
+    os << num_samples_ << "/" << num_null_methods_ << "/" << num_boot_methods_ << "\n";
+  }
+  if (type == kProfilerBinaryMethod) {
+    BinaryProfile profile;
+    profile.AddSummary(num_samples_, num_null_methods_, num_boot_methods_);
+    for (int i = 0 ; i < kHashSize; i++) {
+      Map *map = table[i];
+      if (map != nullptr) {
+        for (const auto &meth_iter : *map) {
+          mirror::ArtMethod *method = meth_iter.first;
+          const DexFile* dex_file = method->GetDexFile();
+          profile.AddMethodSamples(dex_file->GetLocation(), dex_file->GetLocationChecksum(),
+                                   method->GetDexMethodIndex(), meth_iter.second);
+        }
+      }
+    }
+    interpreter::InlineCacheTable* inline_caches = Runtime::Current()->GetInlineCacheTable();
+    if (inline_caches != nullptr) {
+      inline_caches->ExportReceiverTypes(&profile);
+    }
+    if (previous_binary_.get() != nullptr) {
+      profile.MergeWith(*previous_binary_);
+      previous_binary_.reset();
+    }
+    std::vector<uint8_t> data;
+    profile.Serialize(&data);
+    os.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return profile.NumMethods();
+  } else if (type == kProfilerMethod) {
     for (int i = 0 ; i < kHashSize; i++) {
       Map *map = table[i];
       if (map != nullptr) {
@@ -739,6 +773,18 @@ void ProfileSampleResults::ReadPrevious(int fd, ProfileDataType type) {
   // Reset counters.
   previous_num_samples_ = previous_num_null_methods_ = previous_num_boot_methods_ = 0;
 
+  if (type == kProfilerBinaryMethod) {
+    // The summary is merged along with the methods, so the previous counters stay at 0.
+    previous_binary_.reset(new BinaryProfile);
+    std::string error_msg;
+    if (!previous_binary_->Load(fd, &error_msg)) {
+      // An empty file is expected for the first profile.
+      VLOG(profiler) << "Ignoring previous profile: " << error_msg;
+      previous_binary_.reset();
+    }
+    return;
+  }
+
   std::string line;
 
   // The first line contains summary information.
@@ -807,6 +853,15 @@ bool ProfileFile::LoadFile(const std::string& fileName) {
   if (st.st_size == 0) {
     return false;  // Empty profiles are invalid.
   }
+  std::unique_ptr<File> file(OS::OpenFileForReading(fileName.c_str()));
+  if (file.get() != nullptr) {
+    uint8_t magic[sizeof(BinaryProfile::kMagic)];
+    if (file->Read(reinterpret_cast<char*>(magic), sizeof(magic), 0) ==
+            static_cast<int64_t>(sizeof(magic)) &&
+        BinaryProfile::HasMagic(magic, sizeof(magic))) {
+      return LoadBinaryFile(file->Fd(), fileName);
+    }
+  }
   std::ifstream in(fileName.c_str());
   if (!in) {
     LOG(VERBOSE) << "profile file " << fileName << " exists but can't be opened";
@@ -873,8 +928,84 @@ bool ProfileFile::LoadFile(const std::string& fileName) {
   return true;
 }
 
-bool ProfileFile::GetProfileData(ProfileFile::ProfileData* data, const std::string& method_name) {
-  ProfileMap::iterator i = profile_map_.find(method_name);
+bool ProfileFile::LoadBinaryFile(int fd, const std::string& filename) {
+  BinaryProfile profile;
+  std::string error_msg;
+  if (!profile.Load(fd, &error_msg)) {
+    LOG(VERBOSE) << "failed to read binary profile " << filename << ": " << error_msg;
+    return false;
+  }
+  uint32_t total_count = profile.GetNumSamples();
+  if (total_count == 0u) {
+    return false;
+  }
+
+  // Visit the methods in descending order of their sample count, as for the text format.
+  typedef std::tuple<uint32_t, uint32_t, uint32_t> Entry;  // Negated count, checksum, index.
+  std::vector<Entry> entries;
+  entries.reserve(profile.NumMethods());
+  profile.VisitMethods([&entries](const std::string& /* dex_location */,
+                                  uint32_t dex_location_checksum, uint32_t method_idx,
+                                  uint32_t count) {
+    entries.push_back(Entry(std::numeric_limits<uint32_t>::max() - count,
+                            dex_location_checksum, method_idx));
+  });
+  std::sort(entries.begin(), entries.end());
+
+  uint32_t cur_total_count = 0u;
+  const ProfileData* prev_data = nullptr;
+  for (const Entry& entry : entries) {
+    uint32_t count = std::numeric_limits<uint32_t>::max() - std::get<0>(entry);
+    double used_percent = (count * 100.0) / total_count;
+    cur_total_count += count;
+    // Methods with the same count should be part of the same top K percentage bucket.
+    double top_k_percentage = (prev_data != nullptr) && (prev_data->GetCount() == count)
+        ? prev_data->GetTopKUsedPercentage()
+        : 100 * static_cast<double>(cur_total_count) / static_cast<double>(total_count);
+    auto it = binary_profile_map_.lower_bound(std::make_pair(std::get<1>(entry),
+                                                             std::get<2>(entry)));
+    it = binary_profile_map_.emplace_hint(
+        it, std::make_pair(std::get<1>(entry), std::get<2>(entry)),
+        ProfileData(std::string(), count, 0u, used_percent, top_k_percentage));
+    prev_data = &it->second;
+  }
+  profile.VisitCallSites([this](const std::string& /* dex_location */,
+                                uint32_t dex_location_checksum, uint32_t method_idx,
+                                uint32_t dex_pc, const std::set<std::string>& descriptors) {
+    std::vector<std::string>* receiver_types =
+        &receiver_types_[std::make_tuple(dex_location_checksum, method_idx, dex_pc)];
+    receiver_types->assign(descriptors.begin(), descriptors.end());
+  });
+  return true;
+}
+
+bool ProfileFile::GetReceiverTypes(const DexFile& dex_file, uint32_t method_idx, uint32_t dex_pc,
+                                   std::vector<std::string>* descriptors) const {
+  auto it = receiver_types_.find(std::make_tuple(dex_file.GetLocationChecksum(), method_idx,
+                                                 dex_pc));
+  if (it == receiver_types_.end()) {
+    return false;
+  }
+  *descriptors = it->second;
+  return true;
+}
+
+bool ProfileFile::GetProfileData(ProfileFile::ProfileData* data, const DexFile& dex_file,
+                                 uint32_t method_idx) const {
+  if (binary_profile_map_.empty()) {
+    return GetProfileData(data, PrettyMethod(method_idx, dex_file));
+  }
+  auto it = binary_profile_map_.find(std::make_pair(dex_file.GetLocationChecksum(), method_idx));
+  if (it == binary_profile_map_.end()) {
+    return false;
+  }
+  *data = it->second;
+  return true;
+}
+
+bool ProfileFile::GetProfileData(ProfileFile::ProfileData* data,
+                                 const std::string& method_name) const {
+  ProfileMap::const_iterator i = profile_map_.find(method_name);
   if (i == profile_map_.end()) {
     return false;
   }
@@ -892,6 +1023,16 @@ bool ProfileFile::GetTopKSamples(std::set<std::string>& topKSamples, double topK
   return true;
 }
 
+bool ProfileFile::GetTopKSamples(std::set<std::pair<uint32_t, uint32_t>>* top_k_methods,
+                                 double top_k_percentage) const {
+  for (const auto& entry : binary_profile_map_) {
+    if (entry.second.GetTopKUsedPercentage() < top_k_percentage) {
+      top_k_methods->insert(entry.first);
+    }
+  }
+  return true;
+}
+
 StackTrieNode* StackTrieNode::FindChild(MethodReference method, uint32_t dex_pc) {
   if (children_.size() == 0) {
     return nullptr;
@@ -17,15 +17,18 @@
 #ifndef ART_RUNTIME_PROFILER_H_
 #define ART_RUNTIME_PROFILER_H_
 
+#include <map>
 #include <memory>
 #include <ostream>
 #include <set>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "barrier.h"
 #include "base/macros.h"
 #include "base/mutex.h"
+#include "binary_profile.h"
 #include "globals.h"
 #include "instrumentation.h"
 #include "profiler_options.h"
@@ -143,6 +146,8 @@ class ProfileSampleResults {
 
   typedef std::map<std::string, PreviousValue> PreviousProfile;
   PreviousProfile previous_;
+  // The previous profile when using the binary format.
+  std::unique_ptr<BinaryProfile> previous_binary_;
   uint32_t previous_num_samples_;
   uint32_t previous_num_null_methods_;     // Number of samples where can don't know the method.
   uint32_t previous_num_boot_methods_;     // Number of samples in the boot path.
@@ -269,14 +274,38 @@ class ProfileFile {
   // Computes the group that comprise top_k_percentage of the total used methods.
   bool GetTopKSamples(std::set<std::string>& top_k_methods, double top_k_percentage);
 
+  // As above for binary profiles, which identify methods by dex location checksum and method
+  // index rather than by name.
+  bool GetTopKSamples(std::set<std::pair<uint32_t, uint32_t>>* top_k_methods,
+                      double top_k_percentage) const;
+
   // If the given method has an entry in the profile table it updates the data
   // and returns true. Otherwise returns false and leaves the data unchanged.
-  bool GetProfileData(ProfileData* data, const std::string& method_name);
+  bool GetProfileData(ProfileData* data, const std::string& method_name) const;
+
+  // As above, but looks binary profiles up by dex file checksum and method index and
+  // only needs the method name for text profiles.
+  bool GetProfileData(ProfileData* data, const DexFile& dex_file, uint32_t method_idx) const;
+
+  // Returns the descriptors of the receiver classes the interpreter observed at the invoke at
+  // dex_pc of the method. Only binary profiles record them.
+  bool GetReceiverTypes(const DexFile& dex_file, uint32_t method_idx, uint32_t dex_pc,
+                        std::vector<std::string>* descriptors) const;
 
  private:
+  bool LoadBinaryFile(int fd, const std::string& filename);
+
   // Profile data is stored in a map, indexed by the full method name.
   typedef std::map<std::string, ProfileData> ProfileMap;
   ProfileMap profile_map_;
+
+  // Binary profile data is indexed by dex location checksum and method index instead.
+  typedef std::map<std::pair<uint32_t, uint32_t>, ProfileData> BinaryProfileMap;
+  BinaryProfileMap binary_profile_map_;
+
+  // Receiver class descriptors keyed by dex location checksum, method index and dex pc.
+  typedef std::tuple<uint32_t, uint32_t, uint32_t> CallSite;
+  std::map<CallSite, std::vector<std::string>> receiver_types_;
 };
 
 }  // namespace art
@@ -25,6 +25,7 @@ namespace art {
 enum ProfileDataType {
   kProfilerMethod,          // Method only
   kProfilerBoundedStack,    // Methods with Dex PC on top of the stack
+  kProfilerBinaryMethod,    // Method only, in the compact format of BinaryProfile
 };
 
 class ProfilerOptions {
@@ -19,21 +19,30 @@
 
 #include "read_barrier.h"
 
+#include "gc/collector/concurrent_copying.h"
+#include "gc/heap.h"
+#include "mirror/object.h"
 #include "mirror/object_reference.h"
+#include "runtime.h"
 
 namespace art {
 
 template <typename MirrorType, ReadBarrierOption kReadBarrierOption>
 inline MirrorType* ReadBarrier::Barrier(
     mirror::Object* obj, MemberOffset offset, mirror::HeapReference<MirrorType>* ref_addr) {
-  // Unused for now.
-  UNUSED(obj);
   UNUSED(offset);
-  UNUSED(ref_addr);
   const bool with_read_barrier = kReadBarrierOption == kWithReadBarrier;
   if (with_read_barrier && kUseBakerReadBarrier) {
-    // To be implemented.
-    return ref_addr->AsMirrorPtr();
+    // Only the fields of gray objects may still refer to the from-space. The read barrier pointer
+    // must be loaded before the field so that a holder observed as white (scanned) guarantees the
+    // field was already updated.
+    const bool is_gray = obj->GetReadBarrierPointer() == GrayPtr();
+    QuasiAtomic::ThreadFenceAcquire();
+    MirrorType* ref = ref_addr->AsMirrorPtr();
+    if (UNLIKELY(is_gray)) {
+      ref = reinterpret_cast<MirrorType*>(Mark(ref));
+    }
+    return ref;
   } else if (with_read_barrier && kUseBrooksReadBarrier) {
     // To be implemented.
     return ref_addr->AsMirrorPtr();
@@ -48,7 +57,11 @@ inline MirrorType* ReadBarrier::BarrierForRoot(MirrorType** root) {
   MirrorType* ref = *root;
   const bool with_read_barrier = kReadBarrierOption == kWithReadBarrier;
   if (with_read_barrier && kUseBakerReadBarrier) {
-    // To be implemented.
+    // Most roots are updated during the flip, but the system weaks and roots added to runtime
+    // data structures afterwards are not, so mark on every read while the collector is marking.
+    if (UNLIKELY(IsMarking())) {
+      ref = reinterpret_cast<MirrorType*>(Mark(ref));
+    }
     return ref;
   } else if (with_read_barrier && kUseBrooksReadBarrier) {
     // To be implemented.
@@ -58,6 +71,23 @@ inline MirrorType* ReadBarrier::BarrierForRoot(MirrorType** root) {
   }
 }
 
+inline bool ReadBarrier::IsMarking() {
+  Runtime* const runtime = Runtime::Current();
+  if (UNLIKELY(runtime == nullptr || runtime->GetHeap() == nullptr)) {
+    // Roots may be read while the runtime is being created, before any collection can happen.
+    return false;
+  }
+  gc::collector::ConcurrentCopying* collector = runtime->GetHeap()->ConcurrentCopyingCollector();
+  return collector != nullptr && collector->IsMarking();
+}
+
+inline mirror::Object* ReadBarrier::Mark(mirror::Object* obj) {
+  if (obj == nullptr) {
+    return nullptr;
+  }
+  return Runtime::Current()->GetHeap()->ConcurrentCopyingCollector()->Mark(obj);
+}
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_READ_BARRIER_INL_H_
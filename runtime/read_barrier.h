@@ -45,6 +45,26 @@ class ReadBarrier {
   template <typename MirrorType, ReadBarrierOption kReadBarrierOption = kWithReadBarrier>
   ALWAYS_INLINE static MirrorType* BarrierForRoot(MirrorType** root)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Returns true while the concurrent copying collector is marking, which is when the roots and
+  // the references loaded from gray objects must be passed through Mark().
+  ALWAYS_INLINE static bool IsMarking() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Returns the to-space address of obj, evacuating it if necessary.
+  ALWAYS_INLINE static mirror::Object* Mark(mirror::Object* obj)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Baker read barrier states, stored in the read barrier pointer of an object.
+  static mirror::Object* WhitePtr() {
+    return reinterpret_cast<mirror::Object*>(kWhiteState);
+  }
+  static mirror::Object* GrayPtr() {
+    return reinterpret_cast<mirror::Object*>(kGrayState);
+  }
+
+ private:
+  static constexpr uintptr_t kWhiteState = 0x0;  // Not reached yet, or already scanned.
+  static constexpr uintptr_t kGrayState = 0x1;   // Reached but not scanned yet.
 };
 
 }  // namespace art
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_ROOT_HASH_TABLE_INL_H_
+#define ART_RUNTIME_ROOT_HASH_TABLE_INL_H_
+
+#include "root_hash_table.h"
+
+#include "base/mutex-inl.h"
+#include "gc_root-inl.h"
+
+namespace art {
+
+template <typename MirrorType>
+RootHashTable<MirrorType>::RootHashTable(size_t min_capacity, bool lock_free_reads)
+    : lock_free_reads_(lock_free_reads), slots_(nullptr), num_objects_(0), num_used_slots_(0) {
+  DCHECK(IsPowerOfTwo(min_capacity));
+  arrays_.emplace_back(new SlotArray(min_capacity));
+  slots_.StoreRelaxed(arrays_.back().get());
+}
+
+template <typename MirrorType>
+template <typename Predicate>
+typename RootHashTable<MirrorType>::Slot* RootHashTable<MirrorType>::FindSlot(
+    SlotArray* slots, size_t hash, const Predicate& predicate) {
+  const size_t tagged_hash = TagHash(hash);
+  for (size_t i = hash, probes = 0; probes < slots->Capacity(); ++i, ++probes) {
+    Slot* slot = slots->Get(i);
+    const size_t slot_hash = slot->tagged_hash.LoadSequentiallyConsistent();
+    if (slot_hash == 0) {
+      break;  // End of the probe sequence.
+    }
+    if (slot_hash == tagged_hash && !slot->root.IsNull()) {
+      MirrorType* obj = slot->root.Read();
+      if (obj != nullptr && predicate(obj)) {
+        return slot;
+      }
+    }
+  }
+  return nullptr;
+}
+
+template <typename MirrorType>
+template <typename Predicate>
+MirrorType* RootHashTable<MirrorType>::Find(size_t hash, const Predicate& predicate) {
+  Slot* slot = FindSlot(slots_.LoadSequentiallyConsistent(), hash, predicate);
+  return slot != nullptr ? slot->root.Read() : nullptr;
+}
+
+template <typename MirrorType>
+template <typename Predicate>
+void RootHashTable<MirrorType>::FindAll(size_t hash, const Predicate& predicate,
+                                        std::vector<MirrorType*>* result) {
+  SlotArray* slots = slots_.LoadSequentiallyConsistent();
+  const size_t tagged_hash = TagHash(hash);
+  for (size_t i = hash, probes = 0; probes < slots->Capacity(); ++i, ++probes) {
+    Slot* slot = slots->Get(i);
+    const size_t slot_hash = slot->tagged_hash.LoadSequentiallyConsistent();
+    if (slot_hash == 0) {
+      break;
+    }
+    if (slot_hash == tagged_hash && !slot->root.IsNull()) {
+      MirrorType* obj = slot->root.Read();
+      if (obj != nullptr && predicate(obj)) {
+        result->push_back(obj);
+      }
+    }
+  }
+}
+
+template <typename MirrorType>
+void RootHashTable<MirrorType>::InsertInto(SlotArray* slots, MirrorType* obj, size_t hash) {
+  for (size_t i = hash; ; ++i) {
+    Slot* slot = slots->Get(i);
+    if (slot->tagged_hash.LoadRelaxed() == 0) {
+      // Readers check the hash first, so the object has to be visible before it.
+      slot->root = GcRoot<MirrorType>(obj);
+      slot->tagged_hash.StoreSequentiallyConsistent(TagHash(hash));
+      return;
+    }
+  }
+}
+
+template <typename MirrorType>
+void RootHashTable<MirrorType>::Insert(MirrorType* obj, size_t hash) {
+  if ((num_used_slots_ + 1) * 100 > Capacity() * kMaxLoadPercent) {
+    Rebuild();
+  }
+  InsertInto(slots_.LoadRelaxed(), obj, hash);
+  ++num_objects_;
+  ++num_used_slots_;
+}
+
+template <typename MirrorType>
+bool RootHashTable<MirrorType>::Replace(MirrorType* existing, MirrorType* obj, size_t hash) {
+  SlotArray* slots = slots_.LoadRelaxed();
+  const size_t tagged_hash = TagHash(hash);
+  for (size_t i = hash, probes = 0; probes < slots->Capacity(); ++i, ++probes) {
+    Slot* slot = slots->Get(i);
+    const size_t slot_hash = slot->tagged_hash.LoadRelaxed();
+    if (slot_hash == 0) {
+      break;
+    }
+    if (slot_hash == tagged_hash && slot->root.Read() == existing) {
+      // Single word store, readers see either the old or the new object.
+      slot->root = GcRoot<MirrorType>(obj);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename MirrorType>
+template <typename Predicate>
+bool RootHashTable<MirrorType>::Remove(size_t hash, const Predicate& predicate) {
+  Slot* slot = FindSlot(slots_.LoadRelaxed(), hash, predicate);
+  if (slot == nullptr) {
+    return false;
+  }
+  // Keep the hash, the slot stays in use until the next time the table is rebuilt.
+  slot->root = GcRoot<MirrorType>(nullptr);
+  --num_objects_;
+  return true;
+}
+
+template <typename MirrorType>
+void RootHashTable<MirrorType>::UpdateMovedRoot(size_t hash, MirrorType* old_ref,
+                                                MirrorType* new_ref) {
+  SlotArray* slots = slots_.LoadRelaxed();
+  const size_t tagged_hash = TagHash(hash);
+  for (size_t i = hash, probes = 0; probes < slots->Capacity(); ++i, ++probes) {
+    Slot* slot = slots->Get(i);
+    const size_t slot_hash = slot->tagged_hash.LoadRelaxed();
+    if (slot_hash == 0) {
+      break;
+    }
+    // If the object stored matches the old object, update it to the new value.
+    if (slot_hash == tagged_hash && slot->root.template Read<kWithoutReadBarrier>() == old_ref) {
+      *slot->root.AddressWithoutBarrier() = new_ref;
+    }
+  }
+}
+
+template <typename MirrorType>
+void RootHashTable<MirrorType>::VisitRoots(RootCallback* callback, void* arg,
+                                           RootType root_type) {
+  SlotArray* slots = slots_.LoadRelaxed();
+  for (size_t i = 0; i < slots->Capacity(); ++i) {
+    Slot* slot = slots->Get(i);
+    if (!slot->root.IsNull()) {
+      slot->root.VisitRoot(callback, arg, 0, root_type);
+    }
+  }
+}
+
+template <typename MirrorType>
+void RootHashTable<MirrorType>::SweepWeaks(IsMarkedCallback* callback, void* arg) {
+  SlotArray* slots = slots_.LoadRelaxed();
+  for (size_t i = 0; i < slots->Capacity(); ++i) {
+    Slot* slot = slots->Get(i);
+    if (slot->root.IsNull()) {
+      continue;
+    }
+    // This does not need a read barrier because this is called by GC.
+    mirror::Object* object = slot->root.template Read<kWithoutReadBarrier>();
+    mirror::Object* new_object = callback(object, arg);
+    if (new_object == nullptr) {
+      *slot->root.AddressWithoutBarrier() = nullptr;
+      --num_objects_;
+    } else {
+      *slot->root.AddressWithoutBarrier() = down_cast<MirrorType*>(new_object);
+    }
+  }
+}
+
+template <typename MirrorType>
+bool RootHashTable<MirrorType>::Visit(bool (*visitor)(MirrorType* obj, void* arg), void* arg) {
+  SlotArray* slots = slots_.LoadRelaxed();
+  for (size_t i = 0; i < slots->Capacity(); ++i) {
+    Slot* slot = slots->Get(i);
+    if (!slot->root.IsNull() && !visitor(slot->root.Read(), arg)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename MirrorType>
+void RootHashTable<MirrorType>::FreeRetiredArrays(Thread* self) {
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  arrays_.erase(arrays_.begin(), arrays_.end() - 1);
+}
+
+template <typename MirrorType>
+void RootHashTable<MirrorType>::Rebuild() {
+  SlotArray* old_slots = slots_.LoadRelaxed();
+  size_t new_capacity = old_slots->Capacity();
+  while ((num_objects_ + 1) * 100 * 2 > new_capacity * kMaxLoadPercent) {
+    new_capacity *= 2;
+  }
+  SlotArray* new_slots = new SlotArray(new_capacity);
+  for (size_t i = 0; i < old_slots->Capacity(); ++i) {
+    Slot* slot = old_slots->Get(i);
+    if (!slot->root.IsNull()) {
+      InsertInto(new_slots, slot->root.Read(), slot->tagged_hash.LoadRelaxed() >> 1);
+    }
+  }
+  if (!lock_free_reads_) {
+    // Nobody can be probing the old array without holding the lock.
+    arrays_.clear();
+  }
+  arrays_.emplace_back(new_slots);
+  num_used_slots_ = num_objects_;
+  // Publish the fully populated array to the readers.
+  slots_.StoreSequentiallyConsistent(new_slots);
+}
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_ROOT_HASH_TABLE_INL_H_
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_ROOT_HASH_TABLE_H_
+#define ART_RUNTIME_ROOT_HASH_TABLE_H_
+
+#include <memory>
+#include <vector>
+
+#include "atomic.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "gc_root.h"
+#include "object_callbacks.h"
+
+namespace art {
+
+class Thread;
+
+// Open addressing hash table of GC roots using linear probing, keyed by a hash supplied by the
+// caller. Lookups match entries with a predicate on the object. Modifications must be serialized
+// by a lock of the owner.
+//
+// If lock_free_reads is set, Find may also run concurrently with modifications. A slot's root is
+// stored before its hash, which publishes the entry to readers. Removed entries keep their hash
+// so that probe sequences running through them stay intact until the table is rebuilt. When the
+// table is rebuilt, the old slot arrays are retired rather than freed since readers may still be
+// probing them. Readers hold the mutator lock, so the owner frees the retired arrays with
+// FreeRetiredArrays while the mutator lock is held exclusively, e.g. during a GC pause.
+template <typename MirrorType>
+class RootHashTable {
+ public:
+  RootHashTable(size_t min_capacity, bool lock_free_reads);
+
+  // Returns the first object with the hash that satisfies predicate, or null.
+  template <typename Predicate>
+  MirrorType* Find(size_t hash, const Predicate& predicate)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Appends every object with the hash that satisfies predicate.
+  template <typename Predicate>
+  void FindAll(size_t hash, const Predicate& predicate, std::vector<MirrorType*>* result)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // The object must not already be in the table.
+  void Insert(MirrorType* obj, size_t hash) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Replaces existing with obj in place, returns false if existing was not found.
+  bool Replace(MirrorType* existing, MirrorType* obj, size_t hash)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Removes the first object with the hash that satisfies predicate. Returns false if there is
+  // none.
+  template <typename Predicate>
+  bool Remove(size_t hash, const Predicate& predicate)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Updates the entry for an object which was moved by the GC while its root was only visited
+  // through a log of new roots.
+  void UpdateMovedRoot(size_t hash, MirrorType* old_ref, MirrorType* new_ref);
+
+  void VisitRoots(RootCallback* callback, void* arg, RootType root_type);
+
+  // Clears the entries of the objects that callback reports as unmarked, updates the others.
+  void SweepWeaks(IsMarkedCallback* callback, void* arg);
+
+  // Stops and returns false as soon as the visitor returns false.
+  bool Visit(bool (*visitor)(MirrorType* obj, void* arg), void* arg)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Must be called with the mutator lock held exclusively, no reader can be probing a retired
+  // array then.
+  void FreeRetiredArrays(Thread* self);
+
+  size_t Size() const {
+    return num_objects_;
+  }
+
+  size_t Capacity() const {
+    return slots_.LoadRelaxed()->Capacity();
+  }
+
+  // Number of slots allocated, including the ones of the retired arrays.
+  size_t RetainedCapacity() const {
+    size_t capacity = 0;
+    for (const std::unique_ptr<SlotArray>& slots : arrays_) {
+      capacity += slots->Capacity();
+    }
+    return capacity;
+  }
+
+ private:
+  // Maximum fraction of used slots, including removed ones, before the table is rebuilt.
+  static constexpr size_t kMaxLoadPercent = 70;
+
+  // A stored hash of zero means the slot is unused, used slots have their low bit set. The top
+  // bit of the hash is lost, which only matters to tables with more than 2^31 slots.
+  static size_t TagHash(size_t hash) {
+    return (hash << 1) | 1;
+  }
+
+  struct Slot {
+    Atomic<size_t> tagged_hash;
+    GcRoot<MirrorType> root;
+  };
+
+  class SlotArray {
+   public:
+    explicit SlotArray(size_t capacity) : mask_(capacity - 1), slots_(new Slot[capacity]) {}
+
+    size_t Capacity() const {
+      return mask_ + 1;
+    }
+
+    Slot* Get(size_t index) {
+      return &slots_[index & mask_];
+    }
+
+   private:
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    DISALLOW_COPY_AND_ASSIGN(SlotArray);
+  };
+
+  template <typename Predicate>
+  Slot* FindSlot(SlotArray* slots, size_t hash, const Predicate& predicate)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Stores obj into the first unused slot of its probe sequence.
+  static void InsertInto(SlotArray* slots, MirrorType* obj, size_t hash)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Drops the removed entries and grows the table if the live objects need the space.
+  void Rebuild() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  const bool lock_free_reads_;
+  // The array probed by readers.
+  Atomic<SlotArray*> slots_;
+  // The retired arrays, if lock_free_reads_ is set, followed by the current one.
+  std::vector<std::unique_ptr<SlotArray>> arrays_;
+  // Number of objects in the table.
+  size_t num_objects_;
+  // Number of slots which are in use, including ones whose object was removed.
+  size_t num_used_slots_;
+
+  DISALLOW_COPY_AND_ASSIGN(RootHashTable);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_ROOT_HASH_TABLE_H_
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "root_hash_table-inl.h"
+
+#include "base/stringprintf.h"
+#include "common_runtime_test.h"
+#include "handle_scope-inl.h"
+#include "mirror/object-inl.h"
+#include "mirror/string-inl.h"
+#include "scoped_thread_state_change.h"
+#include "thread_list.h"
+
+namespace art {
+
+class RootHashTableTest : public CommonRuntimeTest {
+ protected:
+  class SameString {
+   public:
+    explicit SameString(mirror::String* s) : s_(s) {}
+
+    bool operator()(mirror::String* existing) const {
+      return existing == s_;
+    }
+
+   private:
+    mirror::String* const s_;
+  };
+
+  static size_t HashOf(mirror::String* s) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    return static_cast<uint32_t>(s->GetHashCode());
+  }
+};
+
+TEST_F(RootHashTableTest, InsertFindRemove) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::String> foo(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "foo")));
+  Handle<mirror::String> bar(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "bar")));
+  RootHashTable<mirror::String> table(16, true);
+  table.Insert(foo.Get(), HashOf(foo.Get()));
+  table.Insert(bar.Get(), HashOf(bar.Get()));
+  EXPECT_EQ(2U, table.Size());
+  EXPECT_EQ(foo.Get(), table.Find(HashOf(foo.Get()), SameString(foo.Get())));
+  EXPECT_EQ(bar.Get(), table.Find(HashOf(bar.Get()), SameString(bar.Get())));
+  EXPECT_TRUE(table.Remove(HashOf(foo.Get()), SameString(foo.Get())));
+  EXPECT_FALSE(table.Remove(HashOf(foo.Get()), SameString(foo.Get())));
+  EXPECT_TRUE(table.Find(HashOf(foo.Get()), SameString(foo.Get())) == nullptr);
+  EXPECT_EQ(bar.Get(), table.Find(HashOf(bar.Get()), SameString(bar.Get())));
+  EXPECT_EQ(1U, table.Size());
+}
+
+// Removed entries keep their slot until the table is rebuilt, so churn rebuilds the table at the
+// same capacity over and over. The retired arrays must not pile up across GC pauses.
+TEST_F(RootHashTableTest, ChurnRetainsBoundedMemory) {
+  static constexpr size_t kCapacity = 16;
+  static constexpr size_t kNumStrings = 4;
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<kNumStrings> hs(self);
+  Handle<mirror::String> strings[kNumStrings];
+  for (size_t i = 0; i < kNumStrings; ++i) {
+    std::string s = StringPrintf("string %zd", i);
+    strings[i] = hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, s.c_str()));
+    ASSERT_TRUE(strings[i].Get() != nullptr);
+  }
+  RootHashTable<mirror::String> table(kCapacity, true);
+  for (size_t round = 0; round < 10; ++round) {
+    for (size_t i = 0; i < 100; ++i) {
+      for (Handle<mirror::String>& s : strings) {
+        table.Insert(s.Get(), HashOf(s.Get()));
+      }
+      for (Handle<mirror::String>& s : strings) {
+        ASSERT_TRUE(table.Remove(HashOf(s.Get()), SameString(s.Get())));
+      }
+    }
+    EXPECT_EQ(0U, table.Size());
+    EXPECT_EQ(kCapacity, table.Capacity());
+    EXPECT_GT(table.RetainedCapacity(), table.Capacity());
+    {
+      // Lock free readers hold the mutator lock, they are all gone in a pause.
+      ScopedThreadStateChange tsc(self, kSuspended);
+      ThreadList* thread_list = Runtime::Current()->GetThreadList();
+      thread_list->SuspendAll();
+      table.FreeRetiredArrays(self);
+      thread_list->ResumeAll();
+    }
+    EXPECT_EQ(table.Capacity(), table.RetainedCapacity());
+  }
+  // The table still works after its retired arrays were freed.
+  table.Insert(strings[0].Get(), HashOf(strings[0].Get()));
+  mirror::String* s = strings[0].Get();
+  EXPECT_EQ(s, table.Find(HashOf(s), SameString(s)));
+}
+
+}  // namespace art
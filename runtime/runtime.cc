@@ -54,6 +54,8 @@
 #include "image.h"
 #include "instrumentation.h"
 #include "intern_table.h"
+#include "interpreter/inline_cache.h"
+#include "jit/jit.h"
 #include "jni_internal.h"
 #include "mirror/art_field-inl.h"
 #include "mirror/art_method-inl.h"
@@ -129,11 +131,15 @@ Runtime::Runtime()
       method_trace_(false),
       method_trace_file_size_(0),
       instrumentation_(),
+      use_jit_(false),
+      jit_code_cache_capacity_(0),
+      jit_compile_threshold_(0),
       use_compile_time_class_path_(false),
       main_thread_group_(nullptr),
       system_thread_group_(nullptr),
       system_class_loader_(nullptr),
       dump_gc_performance_on_shutdown_(false),
+      compress_heap_dumps_(false),
       preinitialization_transaction_(nullptr),
       null_pointer_handler_(nullptr),
       suspend_handler_(nullptr),
@@ -172,6 +178,9 @@ Runtime::~Runtime() {
   // Make sure to let the GC complete if it is running.
   heap_->WaitForGcToComplete(gc::kGcCauseBackground, self);
   heap_->DeleteThreadPool();
+  if (jit_.get() != nullptr) {
+    jit_->DeleteThreadPool();
+  }
 
   // Make sure our internal threads are dead before we start tearing down things they're using.
   Dbg::StopJdwp();
@@ -179,6 +188,8 @@ Runtime::~Runtime() {
 
   // Make sure all other non-daemon threads have terminated, and all daemon threads are suspended.
   delete thread_list_;
+  // Daemon threads may still be in JIT compiled code until they are suspended.
+  jit_.reset();
   delete monitor_list_;
   delete monitor_pool_;
   delete class_linker_;
@@ -498,6 +509,10 @@ void Runtime::DidForkFromZygote() {
   // Create the thread pool.
   heap_->CreateThreadPool();
 
+  if (use_jit_) {
+    CreateJit();
+  }
+
   StartSignalCatcher();
 
   // Start the JDWP thread. If the command-line debugger flags specified "suspend=y",
@@ -505,6 +520,17 @@ void Runtime::DidForkFromZygote() {
   Dbg::StartJdwp();
 }
 
+void Runtime::CreateJit() {
+  CHECK(jit_.get() == nullptr);
+  std::string error_msg;
+  jit_.reset(jit::Jit::Create(jit_code_cache_capacity_, jit_compile_threshold_, &error_msg));
+  if (jit_.get() == nullptr) {
+    LOG(WARNING) << "Failed to create JIT " << error_msg;
+    return;
+  }
+  jit_->CreateThreadPool();
+}
+
 void Runtime::StartSignalCatcher() {
   if (!is_zygote_) {
     signal_catcher_ = new SignalCatcher(stack_trace_file_);
@@ -576,6 +602,10 @@ bool Runtime::Init(const RuntimeOptions& raw_options, bool ignore_unrecognized)
   monitor_pool_ = MonitorPool::Create();
   thread_list_ = new ThreadList;
   intern_table_ = new InternTable;
+  if (!IsCompiler()) {
+    // dex2oat only interprets class initializers, their receiver classes are of no use.
+    inline_cache_table_.reset(new interpreter::InlineCacheTable);
+  }
 
   verify_ = options->verify_;
 
@@ -608,9 +638,11 @@ bool Runtime::Init(const RuntimeOptions& raw_options, bool ignore_unrecognized)
                        options->verify_pre_sweeping_rosalloc_,
                        options->verify_post_gc_rosalloc_,
                        options->use_homogeneous_space_compaction_for_oom_,
-                       options->min_interval_homogeneous_space_compaction_by_oom_);
+                       options->min_interval_homogeneous_space_compaction_by_oom_,
+                       options->promotion_age_);
 
   dump_gc_performance_on_shutdown_ = options->dump_gc_performance_on_shutdown_;
+  compress_heap_dumps_ = options->compress_heap_dumps_;
 
   BlockSignals();
   InitPlatformSignalHandlers();
@@ -689,6 +721,11 @@ bool Runtime::Init(const RuntimeOptions& raw_options, bool ignore_unrecognized)
   profile_output_filename_ = options->profile_output_filename_;
   profiler_options_ = options->profiler_options_;
 
+  // The JIT is pointless when compiling ahead of time or when only interpreting.
+  use_jit_ = options->use_jit_ && !IsCompiler() && !options->interpreter_only_;
+  jit_code_cache_capacity_ = options->jit_code_cache_capacity_;
+  jit_compile_threshold_ = options->jit_compile_threshold_;
+
   // TODO: move this to just be an Trace::Start argument
   Trace::SetDefaultClockSource(options->profile_clock_source_);
 
@@ -814,6 +851,12 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   GetInternTable()->DumpForSigQuit(os);
   GetJavaVM()->DumpForSigQuit(os);
   GetHeap()->DumpForSigQuit(os);
+  if (jit_.get() != nullptr) {
+    jit_->DumpForSigQuit(os);
+  }
+  if (inline_cache_table_.get() != nullptr) {
+    inline_cache_table_->DumpForSigQuit(os);
+  }
   os << "\n";
 
   thread_list_->DumpForSigQuit(os);
@@ -983,6 +1026,9 @@ void Runtime::VisitNonThreadRoots(RootCallback* callback, void* arg) {
     preinitialization_transaction_->VisitRoots(callback, arg);
   }
   instrumentation_.VisitRoots(callback, arg);
+  if (inline_cache_table_.get() != nullptr) {
+    inline_cache_table_->VisitRoots(callback, arg);
+  }
 }
 
 void Runtime::VisitNonConcurrentRoots(RootCallback* callback, void* arg) {
@@ -43,6 +43,12 @@ namespace art {
 namespace gc {
   class Heap;
 }  // namespace gc
+namespace interpreter {
+  class InlineCacheTable;
+}  // namespace interpreter
+namespace jit {
+  class Jit;
+}  // namespace jit
 namespace mirror {
   class ArtMethod;
   class ClassLoader;
@@ -117,6 +123,10 @@ class Runtime {
     return is_explicit_gc_disabled_;
   }
 
+  bool CompressHeapDumps() const {
+    return compress_heap_dumps_;
+  }
+
   std::string GetCompilerExecutable() const;
   std::string GetPatchoatExecutable() const;
 
@@ -386,6 +396,19 @@ class Runtime {
     return &instrumentation_;
   }
 
+  // Returns the JIT, or nullptr if it is disabled.
+  jit::Jit* GetJit() {
+    return jit_.get();
+  }
+
+  // Create the JIT and start its compilation thread, if -Xusejit:true was given.
+  void CreateJit();
+
+  // Null in the compiler, which does not record receiver classes.
+  interpreter::InlineCacheTable* GetInlineCacheTable() {
+    return inline_cache_table_.get();
+  }
+
   bool UseCompileTimeClassPath() const {
     return use_compile_time_class_path_;
   }
@@ -581,6 +604,14 @@ class Runtime {
   size_t method_trace_file_size_;
   instrumentation::Instrumentation instrumentation_;
 
+  bool use_jit_;
+  size_t jit_code_cache_capacity_;
+  size_t jit_compile_threshold_;
+  std::unique_ptr<jit::Jit> jit_;
+
+  // Receiver classes seen at the virtual and interface invokes of interpreted methods.
+  std::unique_ptr<interpreter::InlineCacheTable> inline_cache_table_;
+
   typedef SafeMap<jobject, std::vector<const DexFile*>, JobjectComparator> CompileTimeClassPaths;
   CompileTimeClassPaths compile_time_class_paths_;
   bool use_compile_time_class_path_;
@@ -594,6 +625,9 @@ class Runtime {
   // If true, then we dump the GC cumulative timings on shutdown.
   bool dump_gc_performance_on_shutdown_;
 
+  // If true, heap dumps written to a file are gzip compressed.
+  bool compress_heap_dumps_;
+
   // Transaction used for pre-initializing classes at compilation time.
   Transaction* preinitialization_transaction_;
   NullPointerHandler* null_pointer_handler_;
@@ -174,6 +174,13 @@ inline mirror::Object* Thread::AllocTlab(size_t bytes) {
   return ret;
 }
 
+inline void Thread::RevertLastTlabAllocation(mirror::Object* obj, size_t bytes) {
+  DCHECK_EQ(reinterpret_cast<byte*>(obj) + bytes, tlsPtr_.thread_local_pos);
+  DCHECK_GT(tlsPtr_.thread_local_objects, 0U);
+  --tlsPtr_.thread_local_objects;
+  tlsPtr_.thread_local_pos = reinterpret_cast<byte*>(obj);
+}
+
 inline bool Thread::PushOnThreadLocalAllocationStack(mirror::Object* obj) {
   DCHECK_LE(tlsPtr_.thread_local_alloc_stack_top, tlsPtr_.thread_local_alloc_stack_end);
   if (tlsPtr_.thread_local_alloc_stack_top < tlsPtr_.thread_local_alloc_stack_end) {
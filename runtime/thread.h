@@ -764,8 +764,13 @@ class Thread {
   size_t TlabSize() const;
   // Doesn't check that there is room.
   mirror::Object* AllocTlab(size_t bytes);
+  // Undo the last AllocTlab, obj must be the most recent allocation and be bytes long.
+  void RevertLastTlabAllocation(mirror::Object* obj, size_t bytes);
   void SetTlab(byte* start, byte* end);
   bool HasTlab() const;
+  byte* GetTlabStart() const {
+    return tlsPtr_.thread_local_start;
+  }
 
   // Remove the suspend trigger for this thread by making the suspend_trigger_ TLS value
   // equal to a valid pointer.
@@ -365,6 +365,8 @@ std::string PrettyMethod(mirror::ArtMethod* m, bool with_signature) {
   result += m->GetName();
   if (UNLIKELY(m->IsFastNative())) {
     result += "!";
+  } else if (UNLIKELY(m->IsCriticalNative())) {
+    result += "#";
   }
   if (with_signature) {
     const Signature signature = m->GetSignature();
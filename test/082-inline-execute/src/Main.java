@@ -64,6 +64,22 @@ public class Main {
     test_Memory_pokeShort();
     test_Memory_pokeInt();
     test_Memory_pokeLong();
+    initSupportMethodsForReference();
+    test_Integer_bitCount();
+    test_Long_bitCount();
+    test_Integer_numberOfLeadingZeros();
+    test_Long_numberOfLeadingZeros();
+    test_Integer_numberOfTrailingZeros();
+    test_Long_numberOfTrailingZeros();
+    test_Integer_rotate();
+    test_Long_rotate();
+    test_Math_ceil_floor_rint();
+    test_Math_round_D();
+    test_Math_round_F();
+    test_String_equals();
+    test_System_arraycopy();
+    test_Arrays_fill();
+    test_Arrays_equals();
   }
 
   /**
@@ -700,4 +716,393 @@ public class Main {
     poke_long.invoke(null, address + 1, (long)0x2122232425262728L, false);
     Assert.assertTrue(Arrays.equals(ru, b));
   }
+
+  // The intrinsics below are only applied at call sites in compiled code. Calling the same methods
+  // through reflection runs their library implementations, which the intrinsic results are
+  // compared against.
+  static Method ref_integer_bit_count;
+  static Method ref_long_bit_count;
+  static Method ref_integer_nlz;
+  static Method ref_long_nlz;
+  static Method ref_integer_ntz;
+  static Method ref_long_ntz;
+  static Method ref_integer_rotate_left;
+  static Method ref_integer_rotate_right;
+  static Method ref_long_rotate_left;
+  static Method ref_long_rotate_right;
+  static Method ref_math_ceil;
+  static Method ref_math_floor;
+  static Method ref_math_rint;
+  static Method ref_math_round_d;
+  static Method ref_math_round_f;
+  static Method ref_string_equals;
+
+  static final double[] ROUNDING_INPUTS = {
+    0.0, -0.0, 0.5, -0.5, 1.5, -1.5, 2.5, -2.5, 0.49999999999999994, -0.49999999999999994,
+    0.1, -0.1, 0.9, -0.9, 1e15 + 0.5, -1e15 - 0.5, 4503599627370496.0, -4503599627370497.0,
+    9.223372036854776E18, -9.223372036854776E18, 1e300, -1e300, Double.MIN_VALUE,
+    -Double.MIN_VALUE, Double.MAX_VALUE, -Double.MAX_VALUE, Double.POSITIVE_INFINITY,
+    Double.NEGATIVE_INFINITY, Double.NaN
+  };
+
+  static final float[] ROUNDING_INPUTS_F = {
+    0.0f, -0.0f, 0.5f, -0.5f, 1.5f, -1.5f, 2.5f, -2.5f, 0.49999997f, -0.49999997f, 0.1f, -0.1f,
+    8388608.5f, 16777216.0f, -16777217.0f, 2.1474836E9f, -2.1474836E9f, 1e30f, -1e30f,
+    Float.MIN_VALUE, -Float.MIN_VALUE, Float.MAX_VALUE, -Float.MAX_VALUE,
+    Float.POSITIVE_INFINITY, Float.NEGATIVE_INFINITY, Float.NaN
+  };
+
+  static final int[] INT_INPUTS = {
+    0, 1, -1, 2, 0x80000000, 0x7fffffff, 0x00010000, 0x0000ffff, 0x12345678, 0x87654321
+  };
+
+  static final long[] LONG_INPUTS = {
+    0L, 1L, -1L, 2L, 0x8000000000000000L, 0x7fffffffffffffffL, 0x0000000100000000L,
+    0x00000000ffffffffL, 0x123456789abcdef0L, 0x8765432100000000L
+  };
+
+  static final int[] DISTANCES = { 0, 1, 7, 31, 32, 33, 63, 64, 65, -1, -33 };
+
+  public static void initSupportMethodsForReference() throws Exception {
+    ref_integer_bit_count = Integer.class.getDeclaredMethod("bitCount", Integer.TYPE);
+    ref_long_bit_count = Long.class.getDeclaredMethod("bitCount", Long.TYPE);
+    ref_integer_nlz = Integer.class.getDeclaredMethod("numberOfLeadingZeros", Integer.TYPE);
+    ref_long_nlz = Long.class.getDeclaredMethod("numberOfLeadingZeros", Long.TYPE);
+    ref_integer_ntz = Integer.class.getDeclaredMethod("numberOfTrailingZeros", Integer.TYPE);
+    ref_long_ntz = Long.class.getDeclaredMethod("numberOfTrailingZeros", Long.TYPE);
+    ref_integer_rotate_left =
+        Integer.class.getDeclaredMethod("rotateLeft", Integer.TYPE, Integer.TYPE);
+    ref_integer_rotate_right =
+        Integer.class.getDeclaredMethod("rotateRight", Integer.TYPE, Integer.TYPE);
+    ref_long_rotate_left = Long.class.getDeclaredMethod("rotateLeft", Long.TYPE, Integer.TYPE);
+    ref_long_rotate_right = Long.class.getDeclaredMethod("rotateRight", Long.TYPE, Integer.TYPE);
+    ref_math_ceil = Math.class.getDeclaredMethod("ceil", Double.TYPE);
+    ref_math_floor = Math.class.getDeclaredMethod("floor", Double.TYPE);
+    ref_math_rint = Math.class.getDeclaredMethod("rint", Double.TYPE);
+    ref_math_round_d = Math.class.getDeclaredMethod("round", Double.TYPE);
+    ref_math_round_f = Math.class.getDeclaredMethod("round", Float.TYPE);
+    ref_string_equals = String.class.getDeclaredMethod("equals", Object.class);
+  }
+
+  // Compares doubles by their bits so that -0.0 and 0.0 differ and NaN equals NaN.
+  static void assertSameBits(double expected, double actual) {
+    Assert.assertEquals(Double.doubleToLongBits(expected), Double.doubleToLongBits(actual));
+  }
+
+  public static void test_Integer_bitCount() throws Exception {
+    Assert.assertEquals(Integer.bitCount(0), 0);
+    Assert.assertEquals(Integer.bitCount(-1), 32);
+    Assert.assertEquals(Integer.bitCount(0x80000000), 1);
+    for (int i : INT_INPUTS) {
+      Assert.assertEquals(Integer.bitCount(i), (int) ref_integer_bit_count.invoke(null, i));
+    }
+  }
+
+  public static void test_Long_bitCount() throws Exception {
+    Assert.assertEquals(Long.bitCount(0L), 0);
+    Assert.assertEquals(Long.bitCount(-1L), 64);
+    Assert.assertEquals(Long.bitCount(0x8000000000000001L), 2);
+    for (long l : LONG_INPUTS) {
+      Assert.assertEquals(Long.bitCount(l), (int) ref_long_bit_count.invoke(null, l));
+    }
+  }
+
+  public static void test_Integer_numberOfLeadingZeros() throws Exception {
+    Assert.assertEquals(Integer.numberOfLeadingZeros(0), 32);
+    Assert.assertEquals(Integer.numberOfLeadingZeros(1), 31);
+    Assert.assertEquals(Integer.numberOfLeadingZeros(-1), 0);
+    for (int i : INT_INPUTS) {
+      Assert.assertEquals(Integer.numberOfLeadingZeros(i), (int) ref_integer_nlz.invoke(null, i));
+    }
+  }
+
+  public static void test_Long_numberOfLeadingZeros() throws Exception {
+    Assert.assertEquals(Long.numberOfLeadingZeros(0L), 64);
+    Assert.assertEquals(Long.numberOfLeadingZeros(1L), 63);
+    Assert.assertEquals(Long.numberOfLeadingZeros(0x0000000100000000L), 31);
+    for (long l : LONG_INPUTS) {
+      Assert.assertEquals(Long.numberOfLeadingZeros(l), (int) ref_long_nlz.invoke(null, l));
+    }
+  }
+
+  public static void test_Integer_numberOfTrailingZeros() throws Exception {
+    Assert.assertEquals(Integer.numberOfTrailingZeros(0), 32);
+    Assert.assertEquals(Integer.numberOfTrailingZeros(0x80000000), 31);
+    for (int i : INT_INPUTS) {
+      Assert.assertEquals(Integer.numberOfTrailingZeros(i), (int) ref_integer_ntz.invoke(null, i));
+    }
+  }
+
+  public static void test_Long_numberOfTrailingZeros() throws Exception {
+    Assert.assertEquals(Long.numberOfTrailingZeros(0L), 64);
+    Assert.assertEquals(Long.numberOfTrailingZeros(0x0000000100000000L), 32);
+    for (long l : LONG_INPUTS) {
+      Assert.assertEquals(Long.numberOfTrailingZeros(l), (int) ref_long_ntz.invoke(null, l));
+    }
+  }
+
+  public static void test_Integer_rotate() throws Exception {
+    // Constant distances.
+    Assert.assertEquals(Integer.rotateLeft(0x80000001, 1), 0x00000003);
+    Assert.assertEquals(Integer.rotateRight(0x80000001, 1), 0xc0000000);
+    Assert.assertEquals(Integer.rotateLeft(0x12345678, 32), 0x12345678);
+    Assert.assertEquals(Integer.rotateRight(0x12345678, -4), 0x23456781);
+    // Variable distances, taken modulo 32.
+    for (int i : INT_INPUTS) {
+      for (int d : DISTANCES) {
+        Assert.assertEquals(Integer.rotateLeft(i, d),
+                            (int) ref_integer_rotate_left.invoke(null, i, d));
+        Assert.assertEquals(Integer.rotateRight(i, d),
+                            (int) ref_integer_rotate_right.invoke(null, i, d));
+      }
+    }
+  }
+
+  public static void test_Long_rotate() throws Exception {
+    Assert.assertEquals(Long.rotateLeft(0x8000000000000001L, 1), 0x0000000000000003L);
+    Assert.assertEquals(Long.rotateRight(0x8000000000000001L, 1), 0xc000000000000000L);
+    Assert.assertEquals(Long.rotateLeft(0x123456789abcdef0L, 64), 0x123456789abcdef0L);
+    Assert.assertEquals(Long.rotateRight(0x123456789abcdef0L, 32), 0x9abcdef012345678L);
+    for (long l : LONG_INPUTS) {
+      for (int d : DISTANCES) {
+        Assert.assertEquals(Long.rotateLeft(l, d), (long) ref_long_rotate_left.invoke(null, l, d));
+        Assert.assertEquals(Long.rotateRight(l, d),
+                            (long) ref_long_rotate_right.invoke(null, l, d));
+      }
+    }
+  }
+
+  public static void test_Math_ceil_floor_rint() throws Exception {
+    // The sign of a zero result must survive.
+    assertSameBits(Math.ceil(-0.5), -0.0);
+    assertSameBits(Math.ceil(-0.0), -0.0);
+    assertSameBits(Math.floor(-0.0), -0.0);
+    assertSameBits(Math.floor(0.5), 0.0);
+    assertSameBits(Math.rint(-0.5), -0.0);
+    assertSameBits(Math.rint(0.5), 0.0);
+    assertSameBits(Math.rint(2.5), 2.0);
+    assertSameBits(Math.rint(-1.5), -2.0);
+    assertSameBits(StrictMath.ceil(-0.5), -0.0);
+    assertSameBits(StrictMath.floor(-1.5), -2.0);
+    assertSameBits(StrictMath.rint(3.5), 4.0);
+    Assert.assertTrue(Double.isNaN(Math.ceil(Double.NaN)));
+    Assert.assertTrue(Double.isNaN(Math.floor(Double.NaN)));
+    Assert.assertTrue(Double.isNaN(Math.rint(Double.NaN)));
+    for (double d : ROUNDING_INPUTS) {
+      assertSameBits(Math.ceil(d), (double) ref_math_ceil.invoke(null, d));
+      assertSameBits(Math.floor(d), (double) ref_math_floor.invoke(null, d));
+      assertSameBits(Math.rint(d), (double) ref_math_rint.invoke(null, d));
+      assertSameBits(StrictMath.ceil(d), (double) ref_math_ceil.invoke(null, d));
+      assertSameBits(StrictMath.floor(d), (double) ref_math_floor.invoke(null, d));
+      assertSameBits(StrictMath.rint(d), (double) ref_math_rint.invoke(null, d));
+    }
+  }
+
+  public static void test_Math_round_D() throws Exception {
+    Assert.assertEquals(Math.round(0.5), 1L);
+    Assert.assertEquals(Math.round(-0.5), 0L);
+    Assert.assertEquals(Math.round(-2.5), -2L);
+    Assert.assertEquals(Math.round(-0.0), 0L);
+    Assert.assertEquals(Math.round(Double.NaN), 0L);
+    Assert.assertEquals(Math.round(Double.POSITIVE_INFINITY), Long.MAX_VALUE);
+    Assert.assertEquals(Math.round(Double.NEGATIVE_INFINITY), Long.MIN_VALUE);
+    Assert.assertEquals(StrictMath.round(1e300), Long.MAX_VALUE);
+    for (double d : ROUNDING_INPUTS) {
+      Assert.assertEquals(Math.round(d), (long) ref_math_round_d.invoke(null, d));
+      Assert.assertEquals(StrictMath.round(d), (long) ref_math_round_d.invoke(null, d));
+    }
+  }
+
+  public static void test_Math_round_F() throws Exception {
+    Assert.assertEquals(Math.round(0.5f), 1);
+    Assert.assertEquals(Math.round(-0.5f), 0);
+    Assert.assertEquals(Math.round(-2.5f), -2);
+    Assert.assertEquals(Math.round(-0.0f), 0);
+    Assert.assertEquals(Math.round(Float.NaN), 0);
+    Assert.assertEquals(Math.round(Float.POSITIVE_INFINITY), Integer.MAX_VALUE);
+    Assert.assertEquals(Math.round(Float.NEGATIVE_INFINITY), Integer.MIN_VALUE);
+    Assert.assertEquals(StrictMath.round(1e30f), Integer.MAX_VALUE);
+    for (float f : ROUNDING_INPUTS_F) {
+      Assert.assertEquals(Math.round(f), (int) ref_math_round_f.invoke(null, f));
+      Assert.assertEquals(StrictMath.round(f), (int) ref_math_round_f.invoke(null, f));
+    }
+  }
+
+  public static void test_String_equals() throws Exception {
+    String hello = "hello";
+    // Same contents in a different object, and as a substring sharing a larger char array.
+    String copy = new String(new char[] { 'h', 'e', 'l', 'l', 'o' });
+    String substring = "xhellox".substring(1, 6);
+    Object[] others = {
+      hello, copy, substring, "hellO", "hell", "hello!", "", null, new Object(),
+      new StringBuilder(hello)
+    };
+    Assert.assertTrue(hello.equals(hello));
+    Assert.assertTrue(hello.equals(copy));
+    Assert.assertTrue(substring.equals(hello));
+    Assert.assertFalse(hello.equals(null));
+    Assert.assertFalse(hello.equals(new StringBuilder(hello)));
+    Assert.assertFalse("".equals(null));
+    Assert.assertTrue("".equals(""));
+    for (Object a : others) {
+      if (!(a instanceof String)) {
+        continue;
+      }
+      String s = (String) a;
+      for (Object b : others) {
+        Assert.assertEquals(s.equals(b), (boolean) ref_string_equals.invoke(s, b));
+      }
+    }
+
+    String strNull = null;
+    try {
+      strNull.equals(hello);
+      Assert.fail();
+    } catch (NullPointerException expected) {
+    }
+  }
+
+  public static void test_System_arraycopy() {
+    int[] src = new int[200];
+    for (int i = 0; i < src.length; ++i) {
+      src[i] = i;
+    }
+    int[] dst = new int[200];
+    System.arraycopy(src, 3, dst, 1, 5);
+    Assert.assertEquals(dst[0], 0);
+    Assert.assertEquals(dst[1], 3);
+    Assert.assertEquals(dst[5], 7);
+    Assert.assertEquals(dst[6], 0);
+    // Zero-length copies check nothing but the arrays and the positions.
+    System.arraycopy(src, 200, dst, 0, 0);
+    // Longer copies are left to the runtime.
+    System.arraycopy(src, 0, dst, 0, 200);
+    Assert.assertEquals(dst[199], 199);
+    System.arraycopy(src, 50, dst, 0, 129);
+    Assert.assertEquals(dst[0], 50);
+    Assert.assertEquals(dst[128], 178);
+    Assert.assertEquals(dst[129], 129);
+    // Overlapping copies within one array, forwards and backwards.
+    System.arraycopy(src, 0, src, 1, 4);
+    Assert.assertEquals(src[0], 0);
+    Assert.assertEquals(src[1], 0);
+    Assert.assertEquals(src[4], 3);
+    Assert.assertEquals(src[5], 5);
+    System.arraycopy(src, 2, src, 0, 4);
+    Assert.assertEquals(src[0], 1);
+    Assert.assertEquals(src[3], 5);
+    Assert.assertEquals(src[4], 3);
+
+    long[] longs = { 1L, -1L, 0x123456789abcdef0L };
+    long[] longsCopy = new long[3];
+    System.arraycopy(longs, 0, longsCopy, 0, 3);
+    Assert.assertTrue(Arrays.equals(longs, longsCopy));
+    char[] chars = "hello".toCharArray();
+    char[] charsCopy = new char[2];
+    System.arraycopy(chars, 3, charsCopy, 0, 2);
+    Assert.assertEquals(charsCopy[0], 'l');
+    Assert.assertEquals(charsCopy[1], 'o');
+    byte[] bytes = { 1, 2, 3 };
+    byte[] bytesCopy = new byte[3];
+    System.arraycopy(bytes, 1, bytesCopy, 2, 1);
+    Assert.assertEquals(bytesCopy[2], (byte) 2);
+    double[] doubles = { -0.0, Double.NaN };
+    double[] doublesCopy = new double[2];
+    System.arraycopy(doubles, 0, doublesCopy, 0, 2);
+    assertSameBits(doublesCopy[0], -0.0);
+    Assert.assertTrue(Double.isNaN(doublesCopy[1]));
+
+    int[][] badArgs = {
+      { -1, 0, 1 }, { 0, -1, 1 }, { 0, 0, -1 }, { 198, 0, 3 }, { 0, 198, 3 }, { 201, 0, 0 }
+    };
+    for (int[] args : badArgs) {
+      try {
+        System.arraycopy(src, args[0], dst, args[1], args[2]);
+        Assert.fail();
+      } catch (ArrayIndexOutOfBoundsException expected) {
+      }
+    }
+    int[] intsNull = null;
+    try {
+      System.arraycopy(intsNull, 0, dst, 0, 0);
+      Assert.fail();
+    } catch (NullPointerException expected) {
+    }
+    try {
+      System.arraycopy(src, 0, intsNull, 0, 0);
+      Assert.fail();
+    } catch (NullPointerException expected) {
+    }
+  }
+
+  public static void test_Arrays_fill() {
+    int[] ints = new int[7];
+    Arrays.fill(ints, 42);
+    for (int i : ints) {
+      Assert.assertEquals(i, 42);
+    }
+    long[] longs = new long[5];
+    Arrays.fill(longs, 0x123456789abcdef0L);
+    for (long l : longs) {
+      Assert.assertEquals(l, 0x123456789abcdef0L);
+    }
+    char[] chars = new char[3];
+    Arrays.fill(chars, '\uffff');
+    Assert.assertEquals(chars[2], '\uffff');
+    byte[] bytes = new byte[9];
+    Arrays.fill(bytes, (byte) -1);
+    Assert.assertEquals(bytes[8], (byte) -1);
+    // Floating point values are stored by their bits.
+    double[] doubles = new double[2];
+    Arrays.fill(doubles, -0.0);
+    assertSameBits(doubles[1], -0.0);
+    float[] floats = new float[0];
+    Arrays.fill(floats, Float.NaN);
+    // Longer arrays are left to the runtime.
+    int[] longInts = new int[129];
+    Arrays.fill(longInts, -7);
+    Assert.assertEquals(longInts[0], -7);
+    Assert.assertEquals(longInts[128], -7);
+    long[] longLongs = new long[1000];
+    Arrays.fill(longLongs, -1L);
+    Assert.assertEquals(longLongs[999], -1L);
+    int[] intsNull = null;
+    try {
+      Arrays.fill(intsNull, 1);
+      Assert.fail();
+    } catch (NullPointerException expected) {
+    }
+  }
+
+  public static void test_Arrays_equals() {
+    int[] a = { 1, 2, 3 };
+    int[] b = { 1, 2, 3 };
+    int[] c = { 1, 2, 4 };
+    int[] shorter = { 1, 2 };
+    Assert.assertTrue(Arrays.equals(a, a));
+    Assert.assertTrue(Arrays.equals(a, b));
+    Assert.assertFalse(Arrays.equals(a, c));
+    Assert.assertFalse(Arrays.equals(a, shorter));
+    Assert.assertFalse(Arrays.equals(a, null));
+    Assert.assertFalse(Arrays.equals(null, a));
+    Assert.assertTrue(Arrays.equals((int[]) null, (int[]) null));
+    Assert.assertTrue(Arrays.equals(new int[0], new int[0]));
+    Assert.assertTrue(Arrays.equals(new long[] { -1L, 1L }, new long[] { -1L, 1L }));
+    Assert.assertFalse(Arrays.equals(new long[] { -1L, 1L }, new long[] { -1L, 2L }));
+    Assert.assertTrue(Arrays.equals("abc".toCharArray(), "abc".toCharArray()));
+    Assert.assertFalse(Arrays.equals("abc".toCharArray(), "abd".toCharArray()));
+    Assert.assertFalse(Arrays.equals(new byte[] { 1 }, new byte[] { -1 }));
+    Assert.assertFalse(Arrays.equals(new boolean[] { true }, new boolean[] { false }));
+    // Longer arrays are left to the runtime.
+    int[] longA = new int[129];
+    int[] longB = new int[129];
+    Assert.assertTrue(Arrays.equals(longA, longB));
+    longB[128] = 1;
+    Assert.assertFalse(Arrays.equals(longA, longB));
+    Assert.assertFalse(Arrays.equals(longA, new int[128]));
+    Assert.assertTrue(Arrays.equals(new long[1000], new long[1000]));
+    // Not inlined, compares by the canonical bits so NaN equals NaN and -0.0 differs from 0.0.
+    Assert.assertTrue(Arrays.equals(new double[] { Double.NaN }, new double[] { Double.NaN }));
+    Assert.assertFalse(Arrays.equals(new double[] { -0.0 }, new double[] { 0.0 }));
+  }
 }
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * The loops below have the shape the Quick loop vectorizer recognizes. Each runs for trip counts
+ * of 0, W - 1, W, W + 1 and 2 * W + 1 for every lane width W, so that both the vector loop and
+ * the scalar post-loop run alone and together. The expected values are computed one element at a
+ * time by methods whose loops are not vectorized.
+ */
+public class Main {
+    static final int[] LENGTHS = { 0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 33 };
+
+    public static void main(String args[]) {
+        testMulAdd();
+        testAddInvariant();
+        testSum();
+        testFromOne();
+        testShlShort();
+        testAddChar();
+        testXorByte();
+    }
+
+    // Values that cover negative numbers and overflow of the narrow types.
+    static int value(int i) {
+        return i * 0x01234567 - 1000;
+    }
+
+    static void mulAdd(int[] a) {
+        for (int i = 0; i < a.length; i++) {
+            a[i] = a[i] * 3 + 5;
+        }
+    }
+
+    static void addInvariant(int[] a, int k) {
+        for (int i = 0; i < a.length; i++) {
+            a[i] += k;
+        }
+    }
+
+    static int sum(int[] a) {
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    static void fromOne(int[] a) {
+        for (int i = 1; i < a.length; i++) {
+            a[i] = a[i] & 0xff0f;
+        }
+    }
+
+    static void shlShort(short[] a) {
+        for (int i = 0; i < a.length; i++) {
+            a[i] = (short) (a[i] << 3);
+        }
+    }
+
+    static void addChar(char[] a) {
+        for (int i = 0; i < a.length; i++) {
+            a[i] = (char) (a[i] + 1000);
+        }
+    }
+
+    static void xorByte(byte[] a) {
+        for (int i = 0; i < a.length; i++) {
+            a[i] = (byte) (a[i] ^ 0x5a);
+        }
+    }
+
+    static int[] intArray(int length) {
+        int[] a = new int[length];
+        for (int i = 0; i < length; i++) {
+            a[i] = value(i);
+        }
+        return a;
+    }
+
+    static void check(String name, int length, int index, int expected, int actual) {
+        if (expected != actual) {
+            System.out.println(name + " length " + length + " index " + index + ": expected " +
+                               expected + ", got " + actual);
+        }
+    }
+
+    static void testMulAdd() {
+        for (int length : LENGTHS) {
+            int[] a = intArray(length);
+            mulAdd(a);
+            for (int i = 0; i < length; i++) {
+                check("mulAdd", length, i, value(i) * 3 + 5, a[i]);
+            }
+        }
+        System.out.println("mulAdd passed");
+    }
+
+    static void testAddInvariant() {
+        for (int length : LENGTHS) {
+            int[] a = intArray(length);
+            addInvariant(a, length - 7);
+            for (int i = 0; i < length; i++) {
+                check("addInvariant", length, i, value(i) + length - 7, a[i]);
+            }
+        }
+        System.out.println("addInvariant passed");
+    }
+
+    static void testSum() {
+        for (int length : LENGTHS) {
+            int[] a = intArray(length);
+            int expected = 0;
+            for (int i = 0; i < length; i++) {
+                expected += value(i);
+            }
+            check("sum", length, -1, expected, sum(a));
+        }
+        System.out.println("sum passed");
+    }
+
+    static void testFromOne() {
+        for (int length : LENGTHS) {
+            int[] a = intArray(length);
+            fromOne(a);
+            for (int i = 0; i < length; i++) {
+                check("fromOne", length, i, (i == 0) ? value(i) : value(i) & 0xff0f, a[i]);
+            }
+        }
+        System.out.println("fromOne passed");
+    }
+
+    static void testShlShort() {
+        for (int length : LENGTHS) {
+            short[] a = new short[length];
+            for (int i = 0; i < length; i++) {
+                a[i] = (short) value(i);
+            }
+            shlShort(a);
+            for (int i = 0; i < length; i++) {
+                check("shlShort", length, i, (short) ((short) value(i) << 3), a[i]);
+            }
+        }
+        System.out.println("shlShort passed");
+    }
+
+    static void testAddChar() {
+        for (int length : LENGTHS) {
+            char[] a = new char[length];
+            for (int i = 0; i < length; i++) {
+                a[i] = (char) value(i);
+            }
+            addChar(a);
+            for (int i = 0; i < length; i++) {
+                check("addChar", length, i, (char) ((char) value(i) + 1000), a[i]);
+            }
+        }
+        System.out.println("addChar passed");
+    }
+
+    static void testXorByte() {
+        for (int length : LENGTHS) {
+            byte[] a = new byte[length];
+            for (int i = 0; i < length; i++) {
+                a[i] = (byte) value(i);
+            }
+            xorByte(a);
+            for (int i = 0; i < length; i++) {
+                check("xorByte", length, i, (byte) ((byte) value(i) ^ 0x5a), a[i]);
+            }
+        }
+        System.out.println("xorByte passed");
+    }
+}
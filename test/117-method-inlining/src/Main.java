@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+    private int value;
+    private long wide;
+
+    Main(int value) {
+        this.value = value;
+        this.wide = (long) value << 32;
+    }
+
+    static int add(int a, int b) {
+        return a + b;
+    }
+
+    static long addWide(long a, long b) {
+        return a + b;
+    }
+
+    static int max(int a, int b) {
+        return (a > b) ? a : b;
+    }
+
+    static int divByLiteral(int a) {
+        return a / 7;
+    }
+
+    private int getValue() {
+        return value;
+    }
+
+    private void setValue(int v) {
+        value = v;
+    }
+
+    private long getWide() {
+        return wide;
+    }
+
+    final int getValuePlus(int x) {
+        return value + x;
+    }
+
+    // Not a candidate: divides by a register.
+    static int div(int a, int b) {
+        return a / b;
+    }
+
+    // Not a candidate: synchronized.
+    private synchronized int getValueSynchronized() {
+        return value;
+    }
+
+    // Not a candidate: has a try block.
+    static int parseOrDefault(String s, int def) {
+        try {
+            return Integer.parseInt(s);
+        } catch (NumberFormatException e) {
+            return def;
+        }
+    }
+
+    static int callGetValue(Main m) {
+        return m.getValue();
+    }
+
+    static void callSetValue(Main m, int v) {
+        m.setValue(v);
+    }
+
+    static long callGetWide(Main m) {
+        return m.getWide();
+    }
+
+    static int callGetValuePlus(Main m, int x) {
+        return m.getValuePlus(x);
+    }
+
+    static int callDiv(int a, int b) {
+        return div(a, b);
+    }
+
+    static int callGetValueSynchronized(Main m) {
+        return m.getValueSynchronized();
+    }
+
+    static void expectEquals(long expected, long actual) {
+        if (expected != actual) {
+            throw new Error("Expected " + expected + ", got " + actual);
+        }
+    }
+
+    static void expectFrames(Throwable t, String... methods) {
+        StackTraceElement[] trace = t.getStackTrace();
+        for (int i = 0; i < methods.length; ++i) {
+            if (!trace[i].getMethodName().equals(methods[i])) {
+                throw new Error("Expected " + methods[i] + " at depth " + i + ", got " + trace[i]);
+            }
+        }
+    }
+
+    static void testResults() {
+        Main m = new Main(42);
+        expectEquals(5, add(2, 3));
+        expectEquals(0x100000001L, addWide(1L, 0x100000000L));
+        expectEquals(9, max(9, -1));
+        expectEquals(-1, max(-5, -1));
+        expectEquals(6, divByLiteral(45));
+        expectEquals(42, callGetValue(m));
+        callSetValue(m, 17);
+        expectEquals(17, callGetValue(m));
+        expectEquals(42L << 32, callGetWide(m));
+        expectEquals(20, callGetValuePlus(m, 3));
+        expectEquals(17, callGetValueSynchronized(m));
+        expectEquals(4, callDiv(9, 2));
+        expectEquals(12, parseOrDefault("12", -1));
+        expectEquals(-1, parseOrDefault("twelve", -1));
+        System.out.println("results ok");
+    }
+
+    static void testNullReceivers() {
+        // The NPE for the null receiver is thrown by the call site, not by the callee.
+        try {
+            callGetValue(null);
+            throw new Error("Expected NullPointerException");
+        } catch (NullPointerException e) {
+            expectFrames(e, "callGetValue", "testNullReceivers", "main");
+        }
+        try {
+            callSetValue(null, 1);
+            throw new Error("Expected NullPointerException");
+        } catch (NullPointerException e) {
+            expectFrames(e, "callSetValue", "testNullReceivers", "main");
+        }
+        try {
+            callGetWide(null);
+            throw new Error("Expected NullPointerException");
+        } catch (NullPointerException e) {
+            expectFrames(e, "callGetWide", "testNullReceivers", "main");
+        }
+        try {
+            callGetValuePlus(null, 1);
+            throw new Error("Expected NullPointerException");
+        } catch (NullPointerException e) {
+            expectFrames(e, "callGetValuePlus", "testNullReceivers", "main");
+        }
+        System.out.println("null receivers ok");
+    }
+
+    static void testStackTraces() {
+        // Callees that can throw must keep their own frame.
+        try {
+            callDiv(1, 0);
+            throw new Error("Expected ArithmeticException");
+        } catch (ArithmeticException e) {
+            expectFrames(e, "div", "callDiv", "testStackTraces", "main");
+        }
+        System.out.println("stack traces ok");
+    }
+
+    public static void main(String[] args) {
+        testResults();
+        testNullReceivers();
+        testStackTraces();
+    }
+}
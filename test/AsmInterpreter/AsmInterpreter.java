@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class AsmInterpreter {
+    int field;
+
+    static int divInt(int a, int b) {
+        return a / b;
+    }
+    static int remInt(int a, int b) {
+        return a % b;
+    }
+    static int divIntLit8(int a) {
+        return a / -1;
+    }
+    static int remIntLit16(int a) {
+        return a % 1000;
+    }
+    static long divLong(long a, long b) {
+        return a / b;
+    }
+    static long remLong(long a, long b) {
+        return a % b;
+    }
+    static int shlInt(int a, int b) {
+        return a << b;
+    }
+    static int shrInt(int a, int b) {
+        return a >> b;
+    }
+    static int ushrInt(int a, int b) {
+        return a >>> b;
+    }
+    static long shlLong(long a, int b) {
+        return a << b;
+    }
+    static long shrLong(long a, int b) {
+        return a >> b;
+    }
+    static long ushrLong(long a, int b) {
+        return a >>> b;
+    }
+    static int loop(int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += (i * 3) ^ i;
+        }
+        return sum;
+    }
+
+    static int catchDivByZero(int a, int b) {
+        try {
+            return a / b;
+        } catch (ArithmeticException e) {
+            return -1;
+        }
+    }
+    static int arrayGet(int[] array, int index) {
+        return array[index];
+    }
+    static int catchArrayGet(int[] array, int index) {
+        try {
+            return array[index];
+        } catch (ArrayIndexOutOfBoundsException e) {
+            return -2;
+        } catch (NullPointerException e) {
+            return -3;
+        }
+    }
+    static Object agetObject(Object[] array, int index) {
+        return array[index];
+    }
+    static int agetObjectLength(Object[] array) {
+        int length = 0;
+        for (int i = 0; i < array.length; i++) {
+            length += ((String) array[i]).length();
+        }
+        return length;
+    }
+
+    private static int add(int a, int b) {
+        return a + b;
+    }
+    static int invokeStatic(int a, int b) {
+        return add(a, b) * 2;
+    }
+    int getField() {
+        return field;
+    }
+    int invokeVirtual(int a) {
+        field = a;
+        return getField() + a;
+    }
+    static int invokeInterface(CharSequence s) {
+        return s.length();
+    }
+    static long invokeWide(long a, long b) {
+        return divLong(a, b) + remLong(a, b);
+    }
+    static int invokeThrows(int a) {
+        return divInt(a, 0);
+    }
+    static int invokeCatches(int a) {
+        try {
+            return divInt(a, 0);
+        } catch (ArithmeticException e) {
+            return 42;
+        }
+    }
+}
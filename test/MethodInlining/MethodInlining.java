@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class MethodInlining {
+    static int caller(int a, int b) {
+        return add(a, b) + div(a, b) + syncAdd(a, b) + large(a, b);
+    }
+
+    static int add(int a, int b) {
+        return a + b;
+    }
+
+    static int div(int a, int b) {
+        return a / b;
+    }
+
+    static synchronized int syncAdd(int a, int b) {
+        return a + b;
+    }
+
+    static int large(int a, int b) {
+        a = a * b + 1;
+        a = a * b + 2;
+        a = a * b + 3;
+        a = a * b + 4;
+        a = a * b + 5;
+        a = a * b + 6;
+        a = a * b + 7;
+        a = a * b + 8;
+        a = a * b + 9;
+        a = a * b + 10;
+        a = a * b + 11;
+        a = a * b + 12;
+        a = a * b + 13;
+        a = a * b + 14;
+        a = a * b + 15;
+        a = a * b + 16;
+        return a;
+    }
+}
@@ -29,6 +29,8 @@ class MyClassNatives {
     static native Object fooSIOO(int x, Object y, Object z);
     static native int fooSII(int x, int y);
     static native double fooSDD(double x, double y);
+    static native int criticalSII(int x, int y);
+    static native long criticalSJJ(long x, long y);
     static synchronized native Object fooSSIOO(int x, Object y, Object z);
     static native void arraycopy(Object src, int src_pos, Object dst, int dst_pos, int length);
     native boolean compareAndSwapInt(Object obj, long offset, int expected, int newval);